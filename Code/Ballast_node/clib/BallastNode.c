@@ -10,6 +10,7 @@
 #include "CanMessages.h"
 #include "Types.h"
 #include "DataStore.h"
+#include "Parameters.h"
 
 // Declare some constants for use with the message scheduler
 // (don't use PGN or message ID as it must be a uint8)
@@ -36,6 +37,12 @@ enum {
 // Instantiate a struct to store calibration data.
 struct BallastCalibrationData ballastCalData = {};
 
+// The reciprocal of the potentiometer range between the ballast limits. Converting the potentiometer
+// reading needs it every tick, so it's only recomputed when the limits change.
+static float potInverseRange = INFINITY;
+
+static float PotToRadsScaled(uint16_t input, uint16_t lowSide, float inverseRange);
+
 // Instantiate a struct to store ballast input data.
 struct BallastSensorData ballastSensorData = {};
 
@@ -103,8 +110,9 @@ void BallastCalibrate(void)
 		ballastCalData.Calibrated = false;
 		ballastCalData.Calibrating = true;
 		ballastCalData.CommandedRun = true;
-		ballastCalData.PortLimitValue = 0;
-		ballastCalData.StarLimitValue = 0;
+		const uint16_t noLimit = 0;
+		ParameterSetValueByName("Limit_Port", &noLimit);
+		ParameterSetValueByName("Limit_SB", &noLimit);
 		if (ballastSensorData.StarLimit) {
 			ballastCalData.CalibrationState = BALLAST_CAL_STATE_FIRST_TO_PORT;
 			ballastCalData.CommandedDirection = TO_PORT;
@@ -114,28 +122,28 @@ void BallastCalibrate(void)
 		}
 	} else if (ballastCalData.CalibrationState == BALLAST_CAL_STATE_FIRST_TO_PORT) {
 		if (ballastSensorData.PortLimit) {
-			ballastCalData.PortLimitValue = ballastSensorData.PotValue;
+			ParameterSetValueByName("Limit_Port", &ballastSensorData.PotValue);
 			ballastCalData.CalibrationState = BALLAST_CAL_STATE_SECOND_TO_STARBOARD;
 			ballastCalData.CommandedDirection = TO_STARBOARD;
 		}
 	} else if (ballastCalData.CalibrationState == BALLAST_CAL_STATE_FIRST_TO_STARBOARD) {
 		if (ballastSensorData.StarLimit) {
-			ballastCalData.StarLimitValue = ballastSensorData.PotValue;
+			ParameterSetValueByName("Limit_SB", &ballastSensorData.PotValue);
 			ballastCalData.CalibrationState = BALLAST_CAL_STATE_SECOND_TO_PORT;
 			ballastCalData.CommandedDirection = TO_PORT;
 		}
 	} else if (ballastCalData.CalibrationState == BALLAST_CAL_STATE_SECOND_TO_PORT) {
 		if (ballastSensorData.PortLimit) {
-			ballastCalData.PortLimitValue = ballastSensorData.PotValue;
-			DataStoreSaveParameters();
+			ParameterSetValueByName("Limit_Port", &ballastSensorData.PotValue);
+			DataStoreFlush();
 			ballastCalData.CalibrationState = BALLAST_CAL_STATE_RECENTER;
 			ballastCalData.CommandedDirection = TO_STARBOARD;
 			ballastCalData.Calibrated = true;
 		}
 	} else if (ballastCalData.CalibrationState == BALLAST_CAL_STATE_SECOND_TO_STARBOARD) {
 		if (ballastSensorData.StarLimit) {
-			ballastCalData.StarLimitValue = ballastSensorData.PotValue;
-			DataStoreSaveParameters();
+			ParameterSetValueByName("Limit_SB", &ballastSensorData.PotValue);
+			DataStoreFlush();
 			ballastCalData.CalibrationState = BALLAST_CAL_STATE_RECENTER;
 			ballastCalData.CommandedDirection = TO_PORT;
 			ballastCalData.Calibrated = true;
@@ -271,10 +279,13 @@ void UpdateMessageRate(const uint8_t angleRate, const uint8_t statusRate)
 
 void CalculateBallastAngle(void)
 {
-    ballastSensorData.BallastPositionAngle = PotToRads(ballastSensorData.PotValue, ballastCalData.StarLimitValue, ballastCalData.PortLimitValue);
+    ballastSensorData.BallastPositionAngle = PotToRadsScaled(ballastSensorData.PotValue, ballastCalData.PortLimitValue, potInverseRange);
 }
 
-float PotToRads(uint16_t input, uint16_t highSide, uint16_t lowSide)
+/**
+ * Converts a potentiometer reading to radians, given the reciprocal of the range between the limits.
+ */
+static float PotToRadsScaled(uint16_t input, uint16_t lowSide, float inverseRange)
 {
     // This function converts the potentiometer reading from the boat's ballast sensors
     // to a value in degrees. It relies on each limit being hit to set the bounds on
@@ -285,11 +296,10 @@ float PotToRads(uint16_t input, uint16_t highSide, uint16_t lowSide)
     // Prepare our input. Here we subtract the baseline 'lowSide' value off of
     // the input so we start with a range from [0..highSide-lowSide] and map it
     // into the output range of 45 degrees.
-    int32_t in_max = highSide - lowSide;
     float val = (float)((int32_t)input - (int32_t)lowSide);
 
     // Do the actual conversion reversing the range and mapping it into [.7854:-0.7854]
-    float rads = (0.5 - val/((float)in_max))*2*0.7854;
+    float rads = (0.5 - val*inverseRange)*2*0.7854;
 
     // Finally cap the value to +- our range to prevent odd errors later.
     if (rads > 0.7854) {
@@ -299,3 +309,16 @@ float PotToRads(uint16_t input, uint16_t highSide, uint16_t lowSide)
     }
 	return rads;
 }
+
+float PotToRads(uint16_t input, uint16_t highSide, uint16_t lowSide)
+{
+    int32_t in_max = highSide - lowSide;
+    return PotToRadsScaled(input, lowSide, 1.0f / (float)in_max);
+}
+
+void BallastLimitsChanged(uint16_t id)
+{
+    (void)id;
+    int32_t in_max = ballastCalData.StarLimitValue - ballastCalData.PortLimitValue;
+    potInverseRange = 1.0f / (float)in_max;
+}
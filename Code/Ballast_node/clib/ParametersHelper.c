@@ -4,8 +4,8 @@
 #include <stddef.h>
 
 static const Parameter params[] = {
-    {"Limit_Port", &ballastCalData.PortLimitValue, NULL, NULL, PARAMETERS_DATATYPE_UINT16},
-    {"Limit_SB", &ballastCalData.StarLimitValue, NULL, NULL, PARAMETERS_DATATYPE_UINT16}
+    {"Limit_Port", &ballastCalData.PortLimitValue, NULL, NULL, PARAMETERS_DATATYPE_UINT16, BallastLimitsChanged},
+    {"Limit_SB", &ballastCalData.StarLimitValue, NULL, NULL, PARAMETERS_DATATYPE_UINT16, BallastLimitsChanged}
 };
 
 // Expose both the list of parameters and the total to the Parameters library.
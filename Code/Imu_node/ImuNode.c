@@ -171,14 +171,19 @@ void ImuNodeInit(uint32_t f_osc)
 void RunContinuousTasks(void)
 {
 
-	uint8_t c;
-	while (Uart1ReadByte(&c)) {
-		// If we've successfully decoded a message...
-		if (TokimecParse((char)c, &tokimecData) > 0) {
-			// Log that the IMU is connected.
-			sensorAvailability.imu.enabled_counter = 0;
-			sensorAvailability.imu.active_counter = 0;
+	const uint8_t *span;
+	uint16_t length;
+	while ((length = Uart1ReadSpan(&span))) {
+		uint16_t i;
+		for (i = 0; i < length; ++i) {
+			// If we've successfully decoded a message...
+			if (TokimecParse((char)span[i], &tokimecData) > 0) {
+				// Log that the IMU is connected.
+				sensorAvailability.imu.enabled_counter = 0;
+				sensorAvailability.imu.active_counter = 0;
+			}
 		}
+		Uart1ReleaseSpan(length);
 	}
 }
 
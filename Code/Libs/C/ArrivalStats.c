@@ -0,0 +1,205 @@
+#include "ArrivalStats.h"
+
+// The largest interval that fits into the averages with their 4 fractional bits.
+#define ARRIVAL_STATS_MAX_INTERVAL (UINT32_MAX >> 4)
+
+void ArrivalStatsInit(ArrivalStats *s)
+{
+    s->last = 0;
+    s->arrivals = 0;
+    s->mean = 0;
+    s->jitter = 0;
+    s->max = 0;
+    s->dropouts = 0;
+    s->averaged = 0;
+    s->missed = 0;
+}
+
+/**
+ * Moves an average towards a new value, which averages all values until ARRIVAL_STATS_WEIGHT have
+ * been averaged and decays after that.
+ * @param average The average, with 4 fractional bits.
+ * @param value The new value.
+ * @param weight The number of values in the average, including the new one.
+ */
+static uint32_t Average(uint32_t average, uint32_t value, uint8_t weight)
+{
+    const uint32_t target = value << 4;
+    if (target >= average) {
+        return average + (target - average) / weight;
+    }
+    return average - (average - target) / weight;
+}
+
+void ArrivalStatsAdd(ArrivalStats *s, uint32_t time)
+{
+    if (s->arrivals < UINT32_MAX) {
+        ++s->arrivals;
+    }
+    if (s->arrivals == 1) {
+        s->last = time;
+        return;
+    }
+
+    const uint32_t interval = time - s->last;
+    s->last = time;
+    if (interval > s->max) {
+        s->max = interval;
+    }
+
+    // Count the dropouts, without them affecting the averages. But if they keep coming the rate
+    // has changed, so the averages start over from this interval.
+    uint32_t mean = s->mean >> 4;
+    if (s->averaged >= ARRIVAL_STATS_WARMUP && interval / ARRIVAL_STATS_DROPOUT > mean) {
+        if (s->dropouts < UINT16_MAX) {
+            ++s->dropouts;
+        }
+        if (++s->missed < ARRIVAL_STATS_REBASELINE) {
+            return;
+        }
+        s->averaged = 0;
+        s->jitter = 0;
+        mean = 0;
+    }
+    s->missed = 0;
+
+    // The jitter is relative to the mean before this interval, as in RFC 3550.
+    const uint32_t value = (interval < ARRIVAL_STATS_MAX_INTERVAL) ? interval : ARRIVAL_STATS_MAX_INTERVAL;
+    if (s->averaged < ARRIVAL_STATS_WEIGHT) {
+        ++s->averaged;
+    }
+    if (s->averaged > 1) {
+        const uint32_t deviation = (value > mean) ? (value - mean) : (mean - value);
+        s->jitter = Average(s->jitter, deviation, s->averaged - 1);
+    }
+    s->mean = Average(s->mean, value, s->averaged);
+}
+
+uint32_t ArrivalStatsMean(const ArrivalStats *s)
+{
+    return s->mean >> 4;
+}
+
+uint32_t ArrivalStatsJitter(const ArrivalStats *s)
+{
+    return s->jitter >> 4;
+}
+
+uint32_t ArrivalStatsSinceLast(const ArrivalStats *s, uint32_t now)
+{
+    return s->arrivals ? (now - s->last) : UINT32_MAX;
+}
+
+#ifdef UNIT_TEST_ARRIVAL_STATS
+
+#include <stdio.h>
+#include <assert.h>
+
+int main()
+{
+    printf("Running unit tests.\n");
+
+    ArrivalStats s;
+    ArrivalStatsInit(&s);
+    assert(ArrivalStatsMean(&s) == 0 && ArrivalStatsJitter(&s) == 0);
+    assert(ArrivalStatsSinceLast(&s, 1000) == UINT32_MAX);
+
+    // The first arrival has no interval.
+    ArrivalStatsAdd(&s, 1000);
+    assert(s.arrivals == 1 && ArrivalStatsMean(&s) == 0 && s.max == 0);
+    assert(ArrivalStatsSinceLast(&s, 1500) == 500);
+
+    // A steady rate has no jitter.
+    uint32_t t = 1000;
+    int i;
+    for (i = 0; i < 20; ++i) {
+        t += 6250;
+        ArrivalStatsAdd(&s, t);
+    }
+    assert(ArrivalStatsMean(&s) == 6250);
+    assert(ArrivalStatsJitter(&s) == 0);
+    assert(s.max == 6250 && s.dropouts == 0 && s.arrivals == 21);
+
+    // Alternating intervals average out, with their deviation as the jitter.
+    for (i = 0; i < 200; ++i) {
+        t += (i & 1) ? 5250 : 7250;
+        ArrivalStatsAdd(&s, t);
+    }
+    assert(ArrivalStatsMean(&s) >= 6150 && ArrivalStatsMean(&s) <= 6350);
+    assert(ArrivalStatsJitter(&s) >= 900 && ArrivalStatsJitter(&s) <= 1100);
+    assert(s.max == 7250 && s.dropouts == 0);
+
+    // Missing samples are dropouts, which don't change the averages.
+    const uint32_t mean = ArrivalStatsMean(&s);
+    const uint32_t jitter = ArrivalStatsJitter(&s);
+    t += 3 * 6250;
+    ArrivalStatsAdd(&s, t);
+    t += 10 * 6250;
+    ArrivalStatsAdd(&s, t);
+    assert(s.dropouts == 2);
+    assert(s.max == 10 * 6250);
+    assert(ArrivalStatsMean(&s) == mean && ArrivalStatsJitter(&s) == jitter);
+    assert(ArrivalStatsSinceLast(&s, t + 100) == 100);
+
+    // The mean follows a change in rate, and the clock can wrap around.
+    ArrivalStatsInit(&s);
+    t = UINT32_MAX - 100000;
+    for (i = 0; i < 40; ++i) {
+        t += 40000;
+        ArrivalStatsAdd(&s, t);
+    }
+    assert(ArrivalStatsMean(&s) == 40000);
+    for (i = 0; i < 200; ++i) {
+        t += 30000;
+        ArrivalStatsAdd(&s, t);
+    }
+    assert(ArrivalStatsMean(&s) >= 29995 && ArrivalStatsMean(&s) <= 30005);
+    assert(s.dropouts == 0 && s.max == 40000);
+
+    // A permanent drop in rate is only counted as dropouts until the averages start over at the
+    // new rate, after warming up again.
+    ArrivalStatsInit(&s);
+    t = 0;
+    for (i = 0; i < 40; ++i) {
+        t += 6250;
+        ArrivalStatsAdd(&s, t);
+    }
+    for (i = 0; i < ARRIVAL_STATS_REBASELINE - 1; ++i) {
+        t += 25000;
+        ArrivalStatsAdd(&s, t);
+    }
+    assert(s.dropouts == ARRIVAL_STATS_REBASELINE - 1 && ArrivalStatsMean(&s) == 6250);
+    t += 25000;
+    ArrivalStatsAdd(&s, t);
+    assert(s.dropouts == ARRIVAL_STATS_REBASELINE);
+    assert(ArrivalStatsMean(&s) == 25000 && ArrivalStatsJitter(&s) == 0);
+    for (i = 0; i < 100; ++i) {
+        t += (i & 1) ? 24000 : 26000;
+        ArrivalStatsAdd(&s, t);
+    }
+    assert(s.dropouts == ARRIVAL_STATS_REBASELINE);
+    assert(ArrivalStatsMean(&s) >= 24900 && ArrivalStatsMean(&s) <= 25100);
+    assert(ArrivalStatsJitter(&s) >= 900 && ArrivalStatsJitter(&s) <= 1100);
+
+    // Dropouts that aren't in a row don't start the averages over.
+    for (i = 0; i < 2 * ARRIVAL_STATS_REBASELINE; ++i) {
+        t += (i & 1) ? 25000 : 100000;
+        ArrivalStatsAdd(&s, t);
+    }
+    assert(s.dropouts == 2 * ARRIVAL_STATS_REBASELINE);
+    assert(ArrivalStatsMean(&s) >= 24900 && ArrivalStatsMean(&s) <= 25100);
+
+    // No dropouts are detected before warming up, and huge gaps are clamped in the averages.
+    ArrivalStatsInit(&s);
+    ArrivalStatsAdd(&s, 0);
+    ArrivalStatsAdd(&s, 100);
+    ArrivalStatsAdd(&s, 100 + 0x20000000);
+    assert(s.dropouts == 0 && s.max == 0x20000000);
+    assert(ArrivalStatsMean(&s) == (100 + (UINT32_MAX >> 4)) / 2);
+
+    printf("All tests passed.\n");
+
+    return 0;
+}
+
+#endif // UNIT_TEST_ARRIVAL_STATS
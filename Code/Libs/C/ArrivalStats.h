@@ -0,0 +1,99 @@
+#ifndef ARRIVAL_STATS_H
+#define ARRIVAL_STATS_H
+
+/**
+ * @file
+ * @brief Running statistics of the time between arrivals of a periodic message.
+ *
+ * # Dependencies
+ * This library has no prerequisites outside of the C standard library. All timestamps are passed
+ * in by the caller from a free-running, wrapping clock, like the one for the Latency library, and
+ * all intervals are in the units of that clock, which are referred to as ticks below.
+ *
+ * # Usage
+ * Call ArrivalStatsAdd() with the time every message from a source, like a sensor, arrived. Each
+ * call is O(1) and keeps:
+ *  * The mean interval between arrivals, averaged over about the last ARRIVAL_STATS_WEIGHT
+ *    intervals, so it follows changes in rate.
+ *  * The jitter, the mean absolute difference between each interval and the mean, averaged the
+ *    same way. This is the interarrival jitter of RTP (RFC 3550), relative to the mean rate.
+ *  * The longest interval.
+ *  * The number of dropouts, intervals over ARRIVAL_STATS_DROPOUT times the mean, where at least
+ *    one message must have been missed. These are left out of the mean and the jitter, so a few
+ *    dropouts don't hide the next ones. Dropouts are only detected once ARRIVAL_STATS_WARMUP
+ *    intervals have been averaged. After ARRIVAL_STATS_REBASELINE dropouts in a row the source is
+ *    taken to have slowed down for good, so the averages start over from the last of them and
+ *    warm up again. Otherwise a permanent drop in rate would freeze the mean and the jitter.
+ * ArrivalStatsSinceLast() gives the time since the last arrival, which keeps growing once a
+ * source goes silent, well before anything times out.
+ *
+ * The averages are kept in fixed point with 4 fractional bits, so intervals can be up to 2^28
+ * ticks long before they're clamped in the averages.
+ *
+ * Unit testing has been completed on x86 by compiling with the UNIT_TEST_ARRIVAL_STATS macro.
+ * With gcc: `gcc ArrivalStats.c -DUNIT_TEST_ARRIVAL_STATS -Wall -g`
+ */
+
+#include <stdint.h>
+
+/**
+ * The number of intervals the mean and the jitter are averaged over.
+ */
+#define ARRIVAL_STATS_WEIGHT 16
+
+/**
+ * How many times longer than the mean an interval must be to count as a dropout.
+ */
+#define ARRIVAL_STATS_DROPOUT 2
+
+/**
+ * The number of intervals averaged before dropouts are detected.
+ */
+#define ARRIVAL_STATS_WARMUP 4
+
+/**
+ * The number of dropouts in a row after which the averages start over at the new rate.
+ */
+#define ARRIVAL_STATS_REBASELINE 4
+
+typedef struct {
+    uint32_t last;     // The time of the last arrival.
+    uint32_t arrivals; // The number of arrivals.
+    uint32_t mean;     // The mean interval, with 4 fractional bits.
+    uint32_t jitter;   // The jitter, with 4 fractional bits.
+    uint32_t max;      // The longest interval.
+    uint16_t dropouts; // The number of dropouts, saturating.
+    uint8_t averaged;  // The number of intervals in the averages, up to ARRIVAL_STATS_WEIGHT.
+    uint8_t missed;    // The number of dropouts in a row.
+} ArrivalStats;
+
+/**
+ * Clears the statistics.
+ */
+void ArrivalStatsInit(ArrivalStats *s);
+
+/**
+ * Records an arrival.
+ * @param s The statistics.
+ * @param time The time of the arrival, which must not be before the last one.
+ */
+void ArrivalStatsAdd(ArrivalStats *s, uint32_t time);
+
+/**
+ * Returns the mean interval between arrivals in ticks, or 0 if there's no interval yet.
+ */
+uint32_t ArrivalStatsMean(const ArrivalStats *s);
+
+/**
+ * Returns the jitter of the intervals in ticks.
+ */
+uint32_t ArrivalStatsJitter(const ArrivalStats *s);
+
+/**
+ * Returns the time since the last arrival in ticks, or UINT32_MAX if there's been none.
+ * @param s The statistics.
+ * @param now The current time.
+ */
+uint32_t ArrivalStatsSinceLast(const ArrivalStats *s, uint32_t now);
+
+#endif // ARRIVAL_STATS_H
@@ -213,11 +213,24 @@ int CB_PeekMany (const CircularBuffer *b, void *outData, uint16_t size)
 	return false;
 }
 
+uint16_t CB_PeekSpan(const CircularBuffer *b, const uint8_t **span)
+{
+	if (b && b->dataSize) {
+		*span = &b->data[b->readIndex];
+		// The data is contiguous up to the end of the buffer, where it wraps around.
+		if (b->dataSize > b->staticSize - b->readIndex) {
+			return b->staticSize - b->readIndex;
+		}
+		return b->dataSize;
+	}
+	return 0;
+}
+
 int CB_Remove(CircularBuffer *b, uint16_t size){
 	// If there are more elements in the buffer.
 	if (b->dataSize > size) {
 		// Checks to see if the buffer will wrap around.
-		if ((b->staticSize - b->readIndex) < size) {
+		if ((b->staticSize - b->readIndex) <= size) {
 			b-> readIndex = size - (b->staticSize - b->readIndex);
 		} else {
 			// If the buffer will not wrap around size is added to read index.
@@ -551,6 +564,39 @@ int main()
 		assert(b.dataSize == 4);
 		CB_Remove(&b, 10);
 		assert(b.dataSize == 0); //The buffer is now empty
+
+		//Test removing items right up to the end of the buffer
+		CB_WriteMany(&b, "abcdefg", 7, true);
+		assert(b.readIndex == 9);
+		assert(CB_Remove(&b, 1));
+		assert(b.readIndex == 0);
+		CB_ReadByte(&b, &d);
+		assert(d == 'b');
+	}
+
+	/* This tests reading the buffer in contiguous spans with CB_PeekSpan().
+	*/
+	{
+		CircularBuffer b;
+		uint8_t buf[10];
+		const uint8_t *span;
+		CB_Init(&b, buf, 10);
+		assert(CB_PeekSpan(&b, &span) == 0);
+
+		// Without wrapping around all the data is one span.
+		CB_WriteMany(&b, "0123456", 7, true);
+		assert(CB_PeekSpan(&b, &span) == 7);
+		assert(span == buf && !memcmp(span, "0123456", 7));
+		assert(b.dataSize == 7);
+
+		// Otherwise the first span ends at the end of the buffer and the second one starts at 0.
+		CB_Remove(&b, 5);
+		CB_WriteMany(&b, "789ab", 5, true);
+		assert(CB_PeekSpan(&b, &span) == 5);
+		assert(span == &buf[5] && !memcmp(span, "56789", 5));
+		CB_Remove(&b, 5);
+		assert(CB_PeekSpan(&b, &span) == 2);
+		assert(span == buf && !memcmp(span, "ab", 2));
 	}
 
 	/* This tests using the CB_ReadMany function to read a buffer.
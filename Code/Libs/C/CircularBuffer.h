@@ -190,6 +190,20 @@ int CB_Peek(const CircularBuffer *b, uint8_t *outData);
  */
 int CB_PeekMany(const CircularBuffer *b, void *outData, uint16_t size);
 
+/**
+ * @brief CB_PeekSpan() points to the contiguous data at the front of the buffer.
+ *
+ * This allows handing the data directly to something like a DMA channel without copying it. The
+ * span ends either with the data or at the end of the buffer's memory, where it wraps around, so
+ * once the span has been consumed and CB_Remove()d the rest can be peeked at again. Like with
+ * CB_Peek() the data isn't removed, so it can't be overwritten while it's being used.
+ *
+ * @param b A pointer to the CircularBuffer struct.
+ * @param span Where to store a pointer to the first byte of data.
+ * @return The number of contiguous bytes, or 0 if the buffer is empty.
+ */
+uint16_t CB_PeekSpan(const CircularBuffer *b, const uint8_t **span);
+
 /**
  * @brief CB_Remove Removes data from the buffer.
  *
@@ -64,7 +64,9 @@
 * Priyabrata Sinha  2012/4/19   Version 2.2.0 - removed absolute path
 ************************************************************************/
 
-#if defined (__dsPIC33F__)
+#if defined (DEE_HOST)
+    #include "DEEHost.h"
+#elif defined (__dsPIC33F__)
     #include <p33Fxxxx.h>
 #elif defined (__PIC24H__)
     #include <p24Hxxxx.h>
@@ -100,10 +102,65 @@
 
 DATA_EE_FLAGS dataEEFlags;
 
+#if DATA_EE_RAM_INDEX
+//RAM index of the active page of each bank, so that reads and writes don't have to search it
+//  deeIndexValid: Whether the index of the bank is up to date, otherwise it's rebuilt on use
+//  deeIndexPage: Active page
+//  deeIndexNext: Page offset of the next available location, 0 if the page is full
+//  deeIndex: Page offset of the most recent location of each address, 0 if not written
+static unsigned char deeIndexValid[DATA_EE_BANKS];
+static unsigned char deeIndexPage[DATA_EE_BANKS];
+static unsigned int deeIndexNext[DATA_EE_BANKS];
+static unsigned int deeIndex[DATA_EE_BANKS][DATA_EE_SIZE];
+#endif
+
+//Pack in progress, advanced one flash operation at a time by PackStep
+//  state: PACK_IDLE, PACK_ERASE, PACK_ROW or PACK_STATUS
+//  bank: Bank being packed
+//  currentPage: Active page being packed
+//  packedPage: Page being packed into
+//  latchAddr: Next address to copy into the packed page
+//  rowOffset: Page offset of the next row of the packed page to program
+//  failed: Bit per bank set when its last pack failed
+#define PACK_IDLE       0
+#define PACK_ERASE      1
+#define PACK_ROW        2
+#define PACK_STATUS     3
+#define PACK_BUSY       -1
+#define PACK_BLOCKED    -2
+static struct
+{
+    unsigned char state;
+    unsigned char bank;
+    unsigned char currentPage;
+    unsigned char packedPage;
+    unsigned char latchAddr;
+    unsigned int rowOffset;
+    unsigned char failed;
+} pack;
+
+//Queue of asynchronous writes, oldest first
+static struct
+{
+    unsigned int data;
+    unsigned int addr;
+    DataEECallback callback;
+} writeQueue[DATA_EE_QUEUE_SIZE];
+static unsigned char writeQueueHead;
+static unsigned char writeQueueCount;
+
 //Data EE info stored in PM in following format
 //  Status in first two locations of PM page,
 //  8-bit DEE Address (odd address, low byte) 16-bit DEE data (even address)
-#ifdef __AUXFLASH
+#if defined (DEE_HOST)
+
+#define DEE_BANK_SIZE (NUMBER_OF_INSTRUCTIONS_IN_PAGE * 2 * NUM_DATA_EE_PAGES)
+#define DEE_PAGE_SIZE (NUMBER_OF_INSTRUCTIONS_IN_PAGE * 2)
+
+#define DEE_PAGE_TBL(bank, page) ((DEE_HOST_BASE + (DEE_BANK_SIZE * (bank)) + (DEE_PAGE_SIZE * (page))) >> 16)
+#define DEE_PAGE_OFFSET(bank, page) ((DEE_HOST_BASE + (DEE_BANK_SIZE * (bank)) + (DEE_PAGE_SIZE * (page))) & 0xFFFF)
+
+#elif defined (__AUXFLASH)
 
 #define DEE_BANK_SIZE (NUMBER_OF_INSTRUCTIONS_IN_PAGE * 2 * NUM_DATA_EE_PAGES)
 #define DEE_PAGE_SIZE (NUMBER_OF_INSTRUCTIONS_IN_PAGE * 2)
@@ -205,6 +262,126 @@ int GetPageStatus(unsigned char bank, unsigned char page, unsigned char field)
     return(status);
 }
 
+/************************************************************************
+FindRetiredPage
+
+This routine finds a page that's been packed but not erased yet. As the
+status of the packed page is programmed last, it's the page before it
+when two pages are active.
+
+Parameters:		Bank
+Return:			Retired page, or NUM_DATA_EE_PAGES if there's none
+Side Effects:	None
+************************************************************************/
+static unsigned char FindRetiredPage(unsigned char bank)
+{
+    unsigned char page;
+
+    for (page = 0; page < NUM_DATA_EE_PAGES; page++)
+    {
+        if ((GetPageStatus(bank, page, STATUS_CURRENT) == PAGE_CURRENT) &&
+            (GetPageStatus(bank, (page + 1) % NUM_DATA_EE_PAGES, STATUS_CURRENT) == PAGE_CURRENT))
+        {
+            break;
+        }
+    }
+
+    return(page);
+}
+
+/************************************************************************
+FindActivePage
+
+This routine finds the active page. If a packed page hasn't been erased
+yet, it's the page it was packed into.
+
+Parameters:		Bank
+Return:			Active page, or NUM_DATA_EE_PAGES if there's none
+Side Effects:	None
+************************************************************************/
+static unsigned char FindActivePage(unsigned char bank)
+{
+    unsigned char currentPage;
+
+    currentPage = FindRetiredPage(bank);
+    if (currentPage != NUM_DATA_EE_PAGES)
+    {
+        return((currentPage + 1) % NUM_DATA_EE_PAGES);
+    }
+
+    for (currentPage = 0;
+         (currentPage < NUM_DATA_EE_PAGES) &&
+         (GetPageStatus(bank, currentPage, STATUS_CURRENT) == PAGE_NOT_CURRENT);
+         currentPage++) {}
+
+    return(currentPage);
+}
+
+#if DATA_EE_RAM_INDEX
+/************************************************************************
+BuildIndex
+
+This routine finds the active page of the selected bank and records the
+location of the most recent value of every address in it, along with
+the first available location, in the RAM index.
+
+Parameters:		Bank
+Return:			1 if the index was built, 0 if there's no active page
+Side Effects:	None
+************************************************************************/
+static int BuildIndex(unsigned char bank)
+{
+    unsigned int currentPage;
+    unsigned int pmOffset;
+    unsigned int i;
+    unsigned char latchAddr;
+    int savedTBLPAG;
+
+    deeIndexValid[bank] = 0;
+
+    // Find the active page.
+    currentPage = FindActivePage(bank);
+
+    if (currentPage == NUM_DATA_EE_PAGES)
+    {
+        return(0);
+    }
+
+    savedTBLPAG = TBLPAG;
+
+    TBLPAG = DEE_PAGE_TBL(bank, currentPage);
+    pmOffset = DEE_PAGE_OFFSET(bank, currentPage);
+
+    for (i = 0; i < DATA_EE_SIZE; i++)
+    {
+        deeIndex[bank][i] = 0;
+    }
+    deeIndexNext[bank] = 0;
+
+    // Later locations hold more recent values. Like GetNextAvailCount, only fully erased
+    // locations are available.
+    for (i = 2; i < NUMBER_OF_INSTRUCTIONS_IN_PAGE * 2; i += 2)
+    {
+        latchAddr = (ReadPMHigh(pmOffset + i) & 0xFF);
+        if (latchAddr < DATA_EE_SIZE)
+        {
+            deeIndex[bank][latchAddr] = i;
+        }
+        else if ((deeIndexNext[bank] == 0) && ((unsigned int)ReadPMLow(pmOffset + i) == 0xFFFF))
+        {
+            deeIndexNext[bank] = i;
+        }
+    }
+
+    TBLPAG = savedTBLPAG;
+
+    deeIndexPage[bank] = currentPage;
+    deeIndexValid[bank] = 1;
+
+    return(1);
+}
+#endif
+
 /************************************************************************
 ErasePage
 
@@ -221,6 +398,13 @@ void ErasePage(unsigned char bank, unsigned char page)
 
     savedTBLPAG = TBLPAG;
 
+#if DATA_EE_RAM_INDEX
+    if (page == deeIndexPage[bank])
+    {
+        deeIndexValid[bank] = 0;
+    }
+#endif
+
     // Point to proper TBLPAG and offset
     TBLPAG = DEE_PAGE_TBL(bank, page);
 
@@ -237,6 +421,43 @@ void ErasePage(unsigned char bank, unsigned char page)
     return;
 }
 
+/************************************************************************
+IsPageErased
+
+This routine checks whether every location of the selected page is
+erased. A reset while packing or erasing can leave a page that isn't
+active partially programmed.
+
+Parameters:		Bank and page number
+Return:			1 if the page is erased, 0 otherwise
+Side Effects:	None
+************************************************************************/
+static int IsPageErased(unsigned char bank, unsigned char page)
+{
+    unsigned int pmOffset;
+    unsigned int i;
+    int erased = 1;
+    int savedTBLPAG;
+
+    savedTBLPAG = TBLPAG;
+
+    TBLPAG = DEE_PAGE_TBL(bank, page);
+    pmOffset = DEE_PAGE_OFFSET(bank, page);
+
+    for (i = 0; (i < NUMBER_OF_INSTRUCTIONS_IN_PAGE) && erased; i++, pmOffset += 2)
+    {
+        if (((ReadPMHigh(pmOffset) & 0xFF) != 0xFF) ||
+            ((unsigned int)ReadPMLow(pmOffset) != 0xFFFF))
+        {
+            erased = 0;
+        }
+    }
+
+    TBLPAG = savedTBLPAG;
+
+    return(erased);
+}
+
 /************************************************************************
 GetNextAvailCount
 
@@ -260,17 +481,23 @@ unsigned int GetNextAvailCount(unsigned char bank)
     unsigned int pmOffset;           //Current array (page) offset of selected element (PM 16-bit word)
     int savedTBLPAG;        //Context save of TBLPAG value. Current and packed page are on same page.
 
+#if DATA_EE_RAM_INDEX
+    if (deeIndexValid[bank] || BuildIndex(bank))
+    {
+        return(deeIndexNext[bank]);
+    }
+#endif
+
     savedTBLPAG = TBLPAG;
 
     // Find the active page.
-    for (currentPage = 0;
-         (currentPage < NUM_DATA_EE_PAGES) &&
-         (GetPageStatus(bank, currentPage, STATUS_CURRENT) == PAGE_NOT_CURRENT);
-         currentPage++) {}
+    currentPage = FindActivePage(bank);
 
     TBLPAG = DEE_PAGE_TBL(bank, currentPage);
     pmOffset = DEE_PAGE_OFFSET(bank, currentPage);
 
+    // A location is only available if it's fully erased, as a reset while programming it can
+    // leave the data programmed without the address.
     do
     {
         i+=2;
@@ -278,7 +505,8 @@ unsigned int GetNextAvailCount(unsigned char bank)
 
         dataEEval = (ReadPMHigh(pmOffset) & 0xFF);
     }
-    while ((i<NUMBER_OF_INSTRUCTIONS_IN_PAGE * 2) && (dataEEval != 0xFF));
+    while ((i<NUMBER_OF_INSTRUCTIONS_IN_PAGE * 2) &&
+           ((dataEEval != 0xFF) || ((unsigned int)ReadPMLow(pmOffset) != 0xFFFF)));
 
     if(i == NUMBER_OF_INSTRUCTIONS_IN_PAGE * 2)
     {
@@ -291,46 +519,25 @@ unsigned int GetNextAvailCount(unsigned char bank)
 }
 
 /************************************************************************
-PackEE
+PackStart
 
-This routine finds the active page and an unexpired packed page. The most
-recent data EEPROM values are located for each address using ReadEE
-function and written into write latches. Page status is read from active
-page and erase/write count is incremented if page 0 is packed. After all
-information is programmed and verified, the current page is erased. The
-packed page becomes the active page. This function can be called at any-
-time by the user to schedule the CPU stall.
+This routine finds the active page and an unexpired packed page, and
+starts packing the selected bank. PackStep then packs it.
 
-Parameters:		None
+Parameters:		Bank
 Return:			Status value (0 for pass)
-Side Effects:	Generates CPU stall during program/erase operations and
-                overwrites program memory write latches. Data EE flags
-                may be updated
+Side Effects:	Data EE flags may be updated
 ************************************************************************/
-int PackEE(unsigned char bank)
+static int PackStart(unsigned char bank)
 {
     int currentPage;        //Array row (PM page) of active DEE page
     int packedPage;         //Array row (PM page) of packed page
-    int savedTBLPAG;        //Context save of TBLPAG value. Current and packed page are on same page.
-    int currentOffset;      //Current page offset
-    int packedOffset;       //Packed page offset
-    int i;
-    unsigned char latchAddr;
-    unsigned int latchData;
-    unsigned char dataEEFlags_sh;
-
-    savedTBLPAG = TBLPAG;
 
     // Find the active page.
-    for (currentPage = 0;
-         (currentPage < NUM_DATA_EE_PAGES) &&
-         (GetPageStatus(bank, currentPage, STATUS_CURRENT) == PAGE_NOT_CURRENT);
-         currentPage++) {}
-
+    currentPage = FindActivePage(bank);
 
     if (currentPage == NUM_DATA_EE_PAGES)
     {
-        TBLPAG = savedTBLPAG;
         SetPagePackBeforeInit(1);
         return(3);      // Error - no active page
     }
@@ -351,39 +558,114 @@ int PackEE(unsigned char bank)
             }
             if(packedPage == currentPage)
             {
-                TBLPAG = savedTBLPAG;
                 SetPageExpiredPage(1);
                 return(1);      // Error - all pages expired
             }
         }
     }
 
-    // Point to first location in packed page
-    TBLPAG = DEE_PAGE_TBL(bank, packedPage);
-    packedOffset = DEE_PAGE_OFFSET(bank, packedPage);
-
     if(GetNextAvailCount(bank))
     {
         SetPagePackBeforePageFull(1);           // Pack called before the page was full
     }
 
-    dataEEFlags_sh = dataEEFlags.val;
-    SetaddrNotFound(0);                 // Initialize flag
-    i = 0;
-    NVMCON = PROGRAM_ROW;
+    pack.state = PACK_ERASE;
+    pack.bank = bank;
+    pack.currentPage = currentPage;
+    pack.packedPage = packedPage;
+    pack.latchAddr = 0;
+    pack.rowOffset = 0;
 
-    WritePMLow(0xFFFF, packedOffset);
-    WritePMHigh(0xFF, packedOffset);
-    packedOffset += 2;
+    return(0);
+}
 
-    latchAddr = 0;
-    i++;
+/************************************************************************
+PackStep
+
+This routine performs the next flash operation of the pack started by
+PackStart. First a page that was packed but not erased yet is erased,
+as only two pages can be active, and then the packed page if it isn't
+blank. The most recent data EEPROM values are located for each address
+using ReadEE function and written into write latches, one row at a time.
+Page status is read from active page and erase/write count is
+incremented if page 0 is packed. After all information is programmed and
+verified, the status is programmed and the packed page becomes the active
+page. The page that was active is left to be erased.
+
+Parameters:		Whether pages may be erased
+Return:			PACK_BUSY if there are more steps, PACK_BLOCKED if the next
+                step is an erase that isn't allowed, otherwise the
+                status value of the finished pack (0 for pass)
+Side Effects:	Generates CPU stall during program/erase operations and
+                overwrites program memory write latches. Data EE flags
+                may be updated
+************************************************************************/
+static int PackStep(unsigned char allowErase)
+{
+    int savedTBLPAG;        //Context save of TBLPAG value. Current and packed page are on same page.
+    int currentOffset;      //Current page offset
+    int packedOffset;       //Packed page offset
+    int i;
+    unsigned char latchAddr;
+    unsigned int latchData;
+    unsigned char dataEEFlags_sh;
+    unsigned char retiredPage;
 
-    do
+    if (pack.state == PACK_ERASE)
+    {
+        // An earlier pack may have left its page to be erased, and an interrupted pack or
+        // erase can leave the packed page partially programmed
+        retiredPage = FindRetiredPage(pack.bank);
+        if (retiredPage == NUM_DATA_EE_PAGES)
+        {
+            if (IsPageErased(pack.bank, pack.packedPage))
+            {
+                pack.state = PACK_ROW;
+            }
+            else
+            {
+                retiredPage = pack.packedPage;
+            }
+        }
+
+        if (pack.state == PACK_ERASE)
+        {
+            if (!allowErase)
+            {
+                return(PACK_BLOCKED);
+            }
+            ErasePage(pack.bank, retiredPage);
+            return(PACK_BUSY);
+        }
+    }
+
+    savedTBLPAG = TBLPAG;
+
+    if (pack.state == PACK_ROW)
     {
+        // Point to the next row in packed page
+        TBLPAG = DEE_PAGE_TBL(pack.bank, pack.packedPage);
+        packedOffset = DEE_PAGE_OFFSET(pack.bank, pack.packedPage) + pack.rowOffset;
+
+        dataEEFlags_sh = dataEEFlags.val;
+        SetaddrNotFound(0);                 // Initialize flag
+        i = 0;
+        NVMCON = PROGRAM_ROW;
+
+        // The status is programmed last
+        if (pack.rowOffset == 0)
+        {
+            WritePMLow(0xFFFF, packedOffset);
+            WritePMHigh(0xFF, packedOffset);
+            packedOffset += 2;
+            i++;
+        }
+
+        latchAddr = pack.latchAddr;
+
         while((latchAddr != DATA_EE_SIZE) && (i < NUMBER_OF_INSTRUCTIONS_IN_ROW))
         {
-            latchData = DataEERead((255 * bank) + latchAddr);
+            latchData = DataEERead((255 * pack.bank) + latchAddr);
             if(GetaddrNotFound())       //if address is unwritten, skip to next address
             {
                 SetaddrNotFound(0);
@@ -405,24 +687,34 @@ int PackEE(unsigned char bank)
             }
         }
         UnlockWrite();
-        i = 0;
+
+        dataEEFlags.val = dataEEFlags_sh;   //Restore status flags
+
+        pack.latchAddr = latchAddr;
+        pack.rowOffset += NUMBER_OF_INSTRUCTIONS_IN_ROW * 2;
+        if (latchAddr == DATA_EE_SIZE)
+        {
+            pack.state = PACK_STATUS;
+        }
+
+        TBLPAG = savedTBLPAG;
+        return(PACK_BUSY);
     }
-    while(latchAddr != DATA_EE_SIZE);
 
-    dataEEFlags.val = dataEEFlags_sh;   //Restore status flags
+    pack.state = PACK_IDLE;
 
     //Verify data was written correctly into packed page
 
     // Point to first location after status
-    TBLPAG = DEE_PAGE_TBL(bank, packedPage);
-    packedOffset = DEE_PAGE_OFFSET(bank, packedPage) + 2;
+    TBLPAG = DEE_PAGE_TBL(pack.bank, pack.packedPage);
+    packedOffset = DEE_PAGE_OFFSET(pack.bank, pack.packedPage) + 2;
 
     latchAddr = ReadPMHigh(packedOffset++);
     latchData = ReadPMLow(packedOffset++);
 
     while(latchAddr != 0xFF)
     {
-        if(DataEERead((255 * bank) + latchAddr) != latchData)
+        if(DataEERead((255 * pack.bank) + latchAddr) != latchData)
         {
             TBLPAG = savedTBLPAG;
             SetPageWriteError(1);
@@ -434,14 +726,14 @@ int PackEE(unsigned char bank)
 
 
     //Program page status
-    currentOffset = DEE_PAGE_OFFSET(bank, currentPage);
-    packedOffset = DEE_PAGE_OFFSET(bank, packedPage);
+    currentOffset = DEE_PAGE_OFFSET(pack.bank, pack.currentPage);
+    packedOffset = DEE_PAGE_OFFSET(pack.bank, pack.packedPage);
 
     // Point to proper TBLPAG
-    TBLPAG = DEE_PAGE_TBL(bank, currentPage);
+    TBLPAG = DEE_PAGE_TBL(pack.bank, pack.currentPage);
     latchData = ReadPMLow(currentOffset);
     latchAddr = ReadPMHigh(currentOffset);
-    if(packedPage == 0)
+    if(pack.packedPage == 0)
     {
         latchData++;        //Increment E/W counter
     }
@@ -452,8 +744,13 @@ int PackEE(unsigned char bank)
         latchAddr &= 0b11101111;
     }
 
+#if DATA_EE_RAM_INDEX
+    // The packed page becomes the active page
+    deeIndexValid[pack.bank] = 0;
+#endif
+
     // Point to proper TBLPAG
-    TBLPAG = DEE_PAGE_TBL(bank, packedPage);
+    TBLPAG = DEE_PAGE_TBL(pack.bank, pack.packedPage);
     WritePMHigh(latchAddr, packedOffset);
     WritePMLow(latchData, packedOffset);
 
@@ -468,13 +765,56 @@ int PackEE(unsigned char bank)
         return(7);
     }
 
-    //Erase active page
-    ErasePage(bank, currentPage);
-
     TBLPAG = savedTBLPAG;
     return(GetPageExpiredPage());
 }
 
+/************************************************************************
+PackEE
+
+This routine packs the selected bank into the next page, and then erases
+the page that was active. A pack started by DataEETask is finished first.
+This function can be called at any time by the user to schedule the CPU
+stall.
+
+Parameters:		Bank
+Return:			Status value (0 for pass)
+Side Effects:	Generates CPU stall during program/erase operations and
+                overwrites program memory write latches. Data EE flags
+                may be updated
+************************************************************************/
+int PackEE(unsigned char bank)
+{
+    int status;
+
+    while (pack.state != PACK_IDLE)
+    {
+        PackStep(1);
+    }
+
+    status = PackStart(bank);
+    if (status)
+    {
+        return(status);
+    }
+
+    do
+    {
+        status = PackStep(1);
+    }
+    while (status == PACK_BUSY);
+
+    if (status == 7)
+    {
+        return(status);
+    }
+
+    //Erase active page
+    ErasePage(bank, pack.currentPage);
+
+    return(status);
+}
+
 /************************************************************************
 DataEEInit
 
@@ -482,10 +822,12 @@ This routine finds an unexpired page to become an active page. It then
 counts the number of active pages. If no active pages are found, the
 first unexpired page is initialized for emulation. If one active page is
 found, it is assumes a reset occurred and the function does nothing. If
-two active pages are found, it is assumes a reset occurred during a pack.
-The second page is erased and a pack is called. If three, an error code
-is returned as the allocated memory is assumed to be corrupted. This
-function must be called prior to any other operation.
+two active pages are found, it is assumes a reset occurred after a pack
+programmed the status of the packed page, so the page it was packed from
+is erased. If three, an error code is returned as the allocated memory is
+assumed to be corrupted. Asynchronous writes that are still queued and a
+pack in progress are discarded. This function must be called prior to
+any other operation.
 
 Parameters:		None
 Return:			Status value (0 for pass)
@@ -503,6 +845,18 @@ unsigned char DataEEInit(void)
 
     savedTBLPAG = TBLPAG;
 
+    pack.state = PACK_IDLE;
+    pack.failed = 0;
+    writeQueueCount = 0;
+
+#if DATA_EE_RAM_INDEX
+    // The pages may have changed since the index was built.
+    for(bank = 0; bank < DATA_EE_BANKS; bank++)
+    {
+        deeIndexValid[bank] = 0;
+    }
+#endif
+
     // Point the table page pointer to the emulation pages
     TBLPAG = DEE_PAGE_TBL(0, 0);
 
@@ -552,34 +906,25 @@ unsigned char DataEEInit(void)
             TBLPAG = savedTBLPAG;
             continue;
         }
-        //If one active page, do nothing
+        //If one active page, do nothing unless a reset interrupted packing it
         else if(pageCnt == 1)
         {
+            if(!GetNextAvailCount(bank))
+            {
+                PackEE(bank);
+            }
             TBLPAG = savedTBLPAG;
             continue;
         }
-        //If two active pages, erase second and repack first
+        //If two active pages, a reset occurred before the packed page was erased
         else if(pageCnt == 2)
         {
-            if((GetPageStatus(bank, NUM_DATA_EE_PAGES - 1, STATUS_CURRENT) == PAGE_CURRENT) &&
-                (GetPageStatus(bank, 0, STATUS_CURRENT) == PAGE_CURRENT))
-            {
-                currentPage = NUM_DATA_EE_PAGES - 1;
-                erasePage = 0;
-            }
-            else
+            erasePage = FindRetiredPage(bank);
+            if (erasePage == NUM_DATA_EE_PAGES)
             {
-                currentPage = 0;
-                while((GetPageStatus(bank, currentPage, STATUS_CURRENT) == PAGE_NOT_CURRENT) &&
-                    (currentPage < NUM_DATA_EE_PAGES))
-                {
-                    currentPage++;
-                }
-                erasePage = currentPage + 1;
-                if (erasePage == NUM_DATA_EE_PAGES)
-                {
-                    erasePage = 0;
-                }
+                TBLPAG = savedTBLPAG;
+                SetPageCorruptStatus(1);
+                return(6);
             }
             ErasePage(bank, erasePage);
 
@@ -597,6 +942,18 @@ unsigned char DataEEInit(void)
             return(6);
         }
     }
+
+#if DATA_EE_RAM_INDEX
+    // Build the index once now rather than on the first access.
+    for(bank = 0; bank < DATA_EE_BANKS; bank++)
+    {
+        if (!deeIndexValid[bank])
+        {
+            BuildIndex(bank);
+        }
+    }
+#endif
+
     return(0);
 }
 
@@ -634,11 +991,30 @@ unsigned int DataEERead(unsigned int addr)
 
     savedTBLPAG = TBLPAG;
 
+#if DATA_EE_RAM_INDEX
+    // Look the location up in the index instead of searching the page.
+    if (!deeIndexValid[bank] && !BuildIndex(bank))
+    {
+        SetPageCorruptStatus(1);
+        return(0xFFFF);     // Error - no active page
+    }
+
+    i = deeIndex[bank][addr % DATA_EE_SIZE];
+    if (!i)
+    {
+        SetaddrNotFound(1);
+        return(0xFFFF);
+    }
+
+    TBLPAG = DEE_PAGE_TBL(bank, deeIndexPage[bank]);
+    latch = ReadPMLow(DEE_PAGE_OFFSET(bank, deeIndexPage[bank]) + i);
+
+    TBLPAG = savedTBLPAG;
+    return(latch);
+#endif
+
     // Find the active page.
-    for (currentPage = 0;
-         (currentPage < NUM_DATA_EE_PAGES) &&
-         (GetPageStatus(bank, currentPage, STATUS_CURRENT) == PAGE_NOT_CURRENT);
-         currentPage++) {}
+    currentPage = FindActivePage(bank);
 
     if (currentPage == NUM_DATA_EE_PAGES)
     {
@@ -677,7 +1053,7 @@ unsigned int DataEERead(unsigned int addr)
 }
 
 /************************************************************************
-DataEEWrite
+WriteEE
 
 This routine verifies the address is valid. If not, the Illegal Address
 flag is set and an error code is returned. It then finds the active page.
@@ -686,16 +1062,15 @@ and an error code is returned. A read is performed, if the data was not
 changed, the function exits. If the last location is programmed, the Pack
 Skipped error flag is set (one location should always be available). The
 data EE information (MSB = address, LSW = data) is programmed and
-verified. If the verify fails, the Write Error flag is set. If the write
-went into the last location of the page, pack is called. This function
-can be called by the user.
+verified. If the verify fails, the Write Error flag is set.
 
-Parameters:		Data EE address and data
+Parameters:		Data EE address and data, and where to flag that the
+                write went into the last location of the page
 Return:			Pass or fail status (0 = Pass)
 Side Effects:	Data EE flags may be updated. CPU stall occurs for flash
-                programming. Pack may be generated.
+                programming.
 ************************************************************************/
-unsigned char DataEEWrite(unsigned int data, unsigned int addr)
+static unsigned char WriteEE(unsigned int data, unsigned int addr, unsigned char *pageFull)
 {
     int savedTBLPAG;        //Context save of TBLPAG value. Current and packed page are on same page.
     int currentPage;
@@ -717,10 +1092,11 @@ unsigned char DataEEWrite(unsigned int data, unsigned int addr)
     NVMCON = PROGRAM_WORD;
 
     // Find the active page.
-    for (currentPage = 0;
-         (currentPage < NUM_DATA_EE_PAGES) &&
-         (GetPageStatus(bank, currentPage, STATUS_CURRENT) == PAGE_NOT_CURRENT);
-         currentPage++) {}
+#if DATA_EE_RAM_INDEX
+    currentPage = (deeIndexValid[bank] || BuildIndex(bank)) ? deeIndexPage[bank] : NUM_DATA_EE_PAGES;
+#else
+    currentPage = FindActivePage(bank);
+#endif
 
     if (currentPage == NUM_DATA_EE_PAGES)
     {
@@ -758,6 +1134,11 @@ unsigned char DataEEWrite(unsigned int data, unsigned int addr)
 
     pmOffset = pmOffset + nextLoc;
 
+#if DATA_EE_RAM_INDEX
+    // Rebuild the index if the write fails, as the location may be partially programmed.
+    deeIndexValid[bank] = 0;
+#endif
+
     WritePMLow(data, pmOffset);
     WritePMHigh((addr % DATA_EE_SIZE), pmOffset);
 
@@ -794,13 +1175,212 @@ unsigned char DataEEWrite(unsigned int data, unsigned int addr)
         return(7);  //Error - RAM does not match PM
     }
 
+#if DATA_EE_RAM_INDEX
+    deeIndex[bank][addr % DATA_EE_SIZE] = nextLoc;
+    deeIndexNext[bank] = ((nextLoc + 2) < (NUMBER_OF_INSTRUCTIONS_IN_PAGE * 2)) ? (nextLoc + 2) : 0;
+    deeIndexValid[bank] = 1;
+#endif
+
+    *pageFull = ((nextLoc + 2) == ((NUMBER_OF_INSTRUCTIONS_IN_PAGE) * 2));
+
+    TBLPAG = savedTBLPAG;
+
+    return(0);
+}
+
+/************************************************************************
+DataEEWrite
+
+This routine writes the data EE address with WriteEE. If the write went
+into the last location of the page, pack is called. This function can be
+called by the user, but not while asynchronous writes are queued as they
+would be overtaken.
+
+Parameters:		Data EE address and data
+Return:			Pass or fail status (0 = Pass)
+Side Effects:	Data EE flags may be updated. CPU stall occurs for flash
+                programming. Pack may be generated.
+************************************************************************/
+unsigned char DataEEWrite(unsigned int data, unsigned int addr)
+{
+    unsigned char status;
+    unsigned char pageFull = 0;
+
+    status = WriteEE(data, addr, &pageFull);
+
     //Pack if page is full
-    if ((nextLoc + 2) == ((NUMBER_OF_INSTRUCTIONS_IN_PAGE) * 2))
+    if (pageFull)
     {
-        PackEE(bank);
+        PackEE(addr / DATA_EE_SIZE);
     }
 
-    TBLPAG = savedTBLPAG;
+    return(status);
+}
+
+/************************************************************************
+DataEEWriteAsync
+
+This routine verifies the address is valid. If not, the Illegal Address
+flag is set and an error code is returned. If the data is unchanged and
+no earlier write to the address is queued, the write completes right
+away. Otherwise it's queued for DataEETask, unless the queue is full.
+Once the write completes, the callback is called with its status. This
+function can be called by the user.
+
+Parameters:		Data EE address and data, and the function to call once
+                the write completes or NULL
+Return:			Pass or fail status (0 = Pass, DATA_EE_QUEUE_FULL = Queue full)
+Side Effects:	Data EE flags may be updated. The callback may be called.
+************************************************************************/
+unsigned char DataEEWriteAsync(unsigned int data, unsigned int addr, DataEECallback callback)
+{
+    unsigned char i;
+    unsigned char queued = 0;
+    unsigned char dataEEFlags_sh;
+
+    if(addr >= DATA_EE_TOTAL_SIZE)
+    {
+        SetPageIllegalAddress(1);
+        return(5);
+    }
+
+    for (i = 0; i < writeQueueCount; i++)
+    {
+        if (writeQueue[(writeQueueHead + i) % DATA_EE_QUEUE_SIZE].addr == addr)
+        {
+            queued = 1;
+        }
+    }
+
+    //Do not queue data if it did not change
+    if (!queued)
+    {
+        dataEEFlags_sh = dataEEFlags.val;
+        if((DataEERead(addr) == data) && (GetaddrNotFound() == 0))
+        {
+            dataEEFlags.val = dataEEFlags_sh;
+            if (callback)
+            {
+                callback(addr, 0);
+            }
+            return(0);
+        }
+        dataEEFlags.val = dataEEFlags_sh;       //Restore status flags
+    }
+
+    if (writeQueueCount == DATA_EE_QUEUE_SIZE)
+    {
+        return(DATA_EE_QUEUE_FULL);  //Error - Queue full
+    }
+
+    i = (writeQueueHead + writeQueueCount) % DATA_EE_QUEUE_SIZE;
+    writeQueue[i].data = data;
+    writeQueue[i].addr = addr;
+    writeQueue[i].callback = callback;
+    writeQueueCount++;
 
     return(0);
 }
+
+/************************************************************************
+DataEETask
+
+This routine performs at most one flash operation towards the queued
+writes: it advances a pack in progress, or erases a page that was packed
+but not erased, or programs the oldest queued write. When that write's
+page is full a pack is started instead, and if the last pack of the bank
+failed the write fails with the Pack Skipped flag set. Packs program a row
+at a time and never erase the page they packed, so unless erases are
+allowed no call stalls the CPU for longer than a row program. Erasing
+has to be allowed before the next pack of the same bank can finish.
+
+Parameters:		Whether pages may be erased
+Return:			DATA_EE_IDLE if there's nothing left to do,
+                DATA_EE_ERASE_PENDING if only erases are left to do,
+                or DATA_EE_BUSY
+Side Effects:	Generates CPU stall during program/erase operations.
+                Data EE flags may be updated. Callbacks may be called.
+************************************************************************/
+unsigned char DataEETask(unsigned char allowErase)
+{
+    int status;
+    unsigned char bank;
+    unsigned char page;
+    unsigned char pageFull;
+    unsigned int data;
+    unsigned int addr;
+    DataEECallback callback;
+
+    //Finish a pack before anything else
+    if (pack.state != PACK_IDLE)
+    {
+        status = PackStep(allowErase);
+        if (status == PACK_BLOCKED)
+        {
+            return(DATA_EE_ERASE_PENDING);
+        }
+        if (status > 1)
+        {
+            pack.failed |= (1 << pack.bank);
+        }
+        return(DATA_EE_BUSY);
+    }
+
+    //Erase packed pages
+    for (bank = 0; bank < DATA_EE_BANKS; bank++)
+    {
+        page = FindRetiredPage(bank);
+        if (page != NUM_DATA_EE_PAGES)
+        {
+            if (!allowErase)
+            {
+                break;
+            }
+            ErasePage(bank, page);
+            return(DATA_EE_BUSY);
+        }
+    }
+
+    if (!writeQueueCount)
+    {
+        return((bank == DATA_EE_BANKS) ? DATA_EE_IDLE : DATA_EE_ERASE_PENDING);
+    }
+
+    data = writeQueue[writeQueueHead].data;
+    addr = writeQueue[writeQueueHead].addr;
+    callback = writeQueue[writeQueueHead].callback;
+    bank = addr / DATA_EE_SIZE;
+
+    //Pack if page is full, but only retry a failed pack for the next write
+    if (!GetNextAvailCount(bank))
+    {
+        if (pack.failed & (1 << bank))
+        {
+            pack.failed &= ~(1 << bank);
+            SetPagePackSkipped(1);
+            status = 4;
+        }
+        else
+        {
+            status = PackStart(bank);
+            if (!status)
+            {
+                return(DATA_EE_BUSY);
+            }
+        }
+    }
+    else
+    {
+        status = WriteEE(data, addr, &pageFull);
+    }
+
+    writeQueueHead = (writeQueueHead + 1) % DATA_EE_QUEUE_SIZE;
+    writeQueueCount--;
+
+    if (callback)
+    {
+        callback(addr, status);
+    }
+
+    return(DATA_EE_BUSY);
+}
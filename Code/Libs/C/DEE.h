@@ -41,11 +41,27 @@
 * Priyabrata Sinha  2011/01/20  Version 2.0.0 - Added dsPIC33E/PIC24E support
 * Priyabrata Sinha  2012/04/19  Version 2.2.0 - Removed absolute path
 ************************************************************************/
+#ifndef DEE_H
+#define DEE_H
+
 // User defined constants
 #define DATA_EE_BANKS       2
 #define DATA_EE_SIZE        255
 #define DATA_EE_TOTAL_SIZE  (DATA_EE_BANKS * DATA_EE_SIZE)
 #define NUM_DATA_EE_PAGES   3
+// Define as 1 to keep an index of the active pages in RAM instead of searching them on every read
+// and write. A page offset doesn't fit into a byte, so this takes 2 bytes per address plus 4 per
+// bank, 1028 bytes with 2 banks of 255. That's too much for the small-RAM nodes, so only enable it
+// on nodes with RAM to spare, like the primary node.
+#ifndef DATA_EE_RAM_INDEX
+#define DATA_EE_RAM_INDEX   0
+#endif
+// The number of writes DataEEWriteAsync() can queue. Without the RAM index, reading the values for
+// a row of a pack in DataEETask() searches the pages for every one, which takes up to ~9ms of a
+// 10ms tick in DEEHost.c's timing model instead of ~2ms.
+#ifndef DATA_EE_QUEUE_SIZE
+#define DATA_EE_QUEUE_SIZE  16
+#endif
 #if defined(__dsPIC33E__) || defined(__PIC24E__)
 #define ERASE               0x4003
 #define PROGRAM_ROW         0x4002
@@ -77,6 +93,10 @@
 #define STATUS_AVAILABLE                18
 #define STATUS_CURRENT                  19
 #define STATUS_EXPIRED                  20
+#define DATA_EE_IDLE                    0
+#define DATA_EE_BUSY                    1
+#define DATA_EE_ERASE_PENDING           2
+#define DATA_EE_QUEUE_FULL              8 // Returned by DataEEWriteAsync()
 
 #define GetaddrNotFound() dataEEFlags.addrNotFound
 #define SetaddrNotFound(x) dataEEFlags.addrNotFound = x
@@ -120,6 +140,9 @@ typedef union
 
 extern DATA_EE_FLAGS dataEEFlags;
 
+// Called once an asynchronous write completes, with its status (0 for pass).
+typedef void (*DataEECallback)(unsigned int addr, unsigned char status);
+
 extern int  ReadPMHigh(int);
 extern int  ReadPMLow(int);
 extern void UnlockPM(void);
@@ -137,4 +160,7 @@ int             PackEE              (unsigned char bank);
 unsigned char   DataEEInit          (void);
 unsigned int    DataEERead          (unsigned int addr);
 unsigned char   DataEEWrite         (unsigned int data, unsigned int addr);
+unsigned char   DataEEWriteAsync    (unsigned int data, unsigned int addr, DataEECallback callback);
+unsigned char   DataEETask          (unsigned char allowErase);
 
+#endif // DEE_H
@@ -0,0 +1,742 @@
+/**
+ * @file
+ * @brief Implements the emulated dsPIC33F flash for the DEE library declared in DEEHost.h.
+ */
+#include "DEEHost.h"
+
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define INSTRUCTIONS (DEE_HOST_PAGES * NUMBER_OF_INSTRUCTIONS_IN_PAGE)
+
+// An erased instruction word.
+#define ERASED 0x00FFFFFFUL
+
+// The contents of the flash file.
+typedef struct {
+    uint32_t flash[INSTRUCTIONS];
+    uint32_t pageErases[DEE_HOST_PAGES];
+} DeeHostContents;
+
+static DeeHostContents *contents = NULL;
+static int contentsFile = -1;
+
+unsigned int TBLPAG;
+unsigned int NVMCON;
+
+DeeHostStats deeHostStats;
+
+// The write latches for a row, and the instruction the last table write was to.
+static uint32_t latches[NUMBER_OF_INSTRUCTIONS_IN_ROW];
+static int32_t lastWrite = -1;
+
+// Power loss emulation.
+static int32_t operationsUntilFailure = -1;
+static DeeHostTear tearMode = DEE_HOST_TEAR_NONE;
+static bool powerLost = false;
+
+static void ResetLatches(void)
+{
+    uint8_t i;
+    for (i = 0; i < NUMBER_OF_INSTRUCTIONS_IN_ROW; ++i) {
+        latches[i] = ERASED;
+    }
+    lastWrite = -1;
+}
+
+/**
+ * Converts the current TBLPAG and an offset into an index into the emulated flash.
+ * @return The index, or -1 if the address isn't in the emulated pages.
+ */
+static int32_t Instruction(int offset)
+{
+    // The lowest bit selects a byte, which word accesses ignore.
+    const uint32_t address = (((uint32_t)TBLPAG << 16) | ((uint16_t)offset)) & ~1UL;
+    if (!contents || address < DEE_HOST_BASE || address >= DEE_HOST_BASE + 2UL * INSTRUCTIONS) {
+        ++deeHostStats.badAccesses;
+        return -1;
+    }
+    return (address - DEE_HOST_BASE) / 2;
+}
+
+int ReadPMHigh(int offset)
+{
+    ++deeHostStats.tableReads;
+    const int32_t i = Instruction(offset);
+    return (i < 0) ? 0xFF : (int)((contents->flash[i] >> 16) & 0xFF);
+}
+
+int ReadPMLow(int offset)
+{
+    ++deeHostStats.tableReads;
+    const int32_t i = Instruction(offset);
+    return (i < 0) ? 0xFFFF : (int)(contents->flash[i] & 0xFFFF);
+}
+
+int WritePMHigh(int data, int offset)
+{
+    const int32_t i = Instruction(offset);
+    if (i >= 0 && !powerLost) {
+        uint32_t *latch = &latches[i % NUMBER_OF_INSTRUCTIONS_IN_ROW];
+        *latch = (*latch & 0xFFFF) | ((uint32_t)(data & 0xFF) << 16);
+        lastWrite = i;
+    }
+    return 0;
+}
+
+int WritePMHighB(int data, int offset)
+{
+    return WritePMHigh(data, offset);
+}
+
+int WritePMLow(int data, int offset)
+{
+    const int32_t i = Instruction(offset);
+    if (i >= 0 && !powerLost) {
+        uint32_t *latch = &latches[i % NUMBER_OF_INSTRUCTIONS_IN_ROW];
+        *latch = (*latch & 0xFF0000) | (uint16_t)data;
+        lastWrite = i;
+    }
+    return 0;
+}
+
+int WritePMLowB(int data, int offset)
+{
+    return WritePMLow(data, offset);
+}
+
+/**
+ * Programs an instruction word, which can only clear bits.
+ */
+static void Program(int32_t i, uint32_t value)
+{
+    if ((contents->flash[i] & value) != value) {
+        ++deeHostStats.overprograms;
+    }
+    contents->flash[i] &= value;
+}
+
+void UnlockPM(void)
+{
+    if (powerLost || lastWrite < 0) {
+        return;
+    }
+
+    // Check whether the power fails during this operation.
+    bool torn = false;
+    if (operationsUntilFailure == 0) {
+        powerLost = true;
+        if (tearMode == DEE_HOST_TEAR_NONE) {
+            return;
+        }
+        torn = true;
+    } else if (operationsUntilFailure > 0) {
+        --operationsUntilFailure;
+    }
+
+    switch (NVMCON) {
+        case PROGRAM_WORD:
+            // A torn program doesn't reach the upper byte.
+            Program(lastWrite, latches[lastWrite % NUMBER_OF_INSTRUCTIONS_IN_ROW] | (torn ? 0xFF0000 : 0));
+            ++deeHostStats.wordPrograms;
+            deeHostStats.stallUs += DEE_HOST_WORD_PROGRAM_US;
+            break;
+        case PROGRAM_ROW: {
+            const int32_t row = lastWrite - lastWrite % NUMBER_OF_INSTRUCTIONS_IN_ROW;
+            const uint8_t count = torn ? NUMBER_OF_INSTRUCTIONS_IN_ROW / 2 : NUMBER_OF_INSTRUCTIONS_IN_ROW;
+            uint8_t i;
+            for (i = 0; i < count; ++i) {
+                Program(row + i, latches[i]);
+            }
+            ++deeHostStats.rowPrograms;
+            deeHostStats.stallUs += DEE_HOST_ROW_PROGRAM_US;
+        } break;
+        case ERASE: {
+            const int32_t page = lastWrite / NUMBER_OF_INSTRUCTIONS_IN_PAGE;
+            const uint16_t count = torn ? NUMBER_OF_INSTRUCTIONS_IN_PAGE / 2 : NUMBER_OF_INSTRUCTIONS_IN_PAGE;
+            uint16_t i;
+            for (i = 0; i < count; ++i) {
+                contents->flash[page * NUMBER_OF_INSTRUCTIONS_IN_PAGE + i] = ERASED;
+            }
+            ++contents->pageErases[page];
+            ++deeHostStats.pageErases;
+            deeHostStats.stallUs += DEE_HOST_PAGE_ERASE_US;
+        } break;
+        default:
+            ++deeHostStats.badAccesses;
+            break;
+    }
+
+    ResetLatches();
+}
+
+bool DeeHostOpen(const char *path)
+{
+    DeeHostClose();
+
+    bool fresh = true;
+    if (path) {
+        contentsFile = open(path, O_RDWR | O_CREAT, 0644);
+        if (contentsFile < 0) {
+            return false;
+        }
+        struct stat info;
+        if (fstat(contentsFile, &info) == 0 && info.st_size == sizeof(DeeHostContents)) {
+            fresh = false;
+        } else if (ftruncate(contentsFile, sizeof(DeeHostContents)) != 0) {
+            close(contentsFile);
+            contentsFile = -1;
+            return false;
+        }
+        contents = mmap(NULL, sizeof(DeeHostContents), PROT_READ | PROT_WRITE, MAP_SHARED, contentsFile, 0);
+    } else {
+        contents = mmap(NULL, sizeof(DeeHostContents), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    }
+    if (contents == MAP_FAILED) {
+        contents = NULL;
+        DeeHostClose();
+        return false;
+    }
+
+    if (fresh) {
+        DeeHostEraseAll();
+    }
+    DeeHostPowerOn();
+    DeeHostFailAfter(-1, DEE_HOST_TEAR_NONE);
+    DeeHostResetStats();
+    return true;
+}
+
+void DeeHostClose(void)
+{
+    if (contents) {
+        if (contentsFile >= 0) {
+            msync(contents, sizeof(DeeHostContents), MS_SYNC);
+        }
+        munmap(contents, sizeof(DeeHostContents));
+        contents = NULL;
+    }
+    if (contentsFile >= 0) {
+        close(contentsFile);
+        contentsFile = -1;
+    }
+}
+
+void DeeHostEraseAll(void)
+{
+    if (contents) {
+        uint32_t i;
+        for (i = 0; i < INSTRUCTIONS; ++i) {
+            contents->flash[i] = ERASED;
+        }
+        memset(contents->pageErases, 0, sizeof(contents->pageErases));
+    }
+}
+
+void *DeeHostImage(size_t *size)
+{
+    *size = sizeof(DeeHostContents);
+    return contents;
+}
+
+uint32_t DeeHostPageErases(uint8_t page)
+{
+    return (contents && page < DEE_HOST_PAGES) ? contents->pageErases[page] : 0;
+}
+
+void DeeHostFailAfter(int32_t operations, DeeHostTear tear)
+{
+    operationsUntilFailure = operations;
+    tearMode = tear;
+}
+
+bool DeeHostPowerLost(void)
+{
+    return powerLost;
+}
+
+void DeeHostPowerOn(void)
+{
+    powerLost = false;
+    ResetLatches();
+    TBLPAG = 0;
+    NVMCON = 0;
+}
+
+void DeeHostResetStats(void)
+{
+    memset(&deeHostStats, 0, sizeof(deeHostStats));
+}
+
+#ifdef UNIT_TEST_DEE_HOST
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+// The number of flash operations counted so far.
+static uint32_t Operations(void)
+{
+    return deeHostStats.wordPrograms + deeHostStats.rowPrograms + deeHostStats.pageErases;
+}
+
+// Reboots, making sure DEE recovers.
+static void Reboot(void)
+{
+    DeeHostPowerOn();
+    dataEEFlags.val = 0;
+    assert(DataEEInit() == 0);
+}
+
+// The modelled time in microseconds spent in flash operations and table reads so far.
+static double CostUs(void)
+{
+    return deeHostStats.stallUs + deeHostStats.tableReads * (DEE_HOST_TABLE_READ_NS / 1000.0);
+}
+
+static uint32_t completions;
+static unsigned char completedStatus;
+
+static void Completed(unsigned int addr, unsigned char status)
+{
+    (void)addr;
+    ++completions;
+    completedStatus = status;
+}
+
+// Writes a value directly, or queues it and runs the queue until it's written, never erasing.
+static unsigned char Write(bool async, unsigned int data, unsigned int addr)
+{
+    if (!async) {
+        return DataEEWrite(data, addr);
+    }
+    const uint32_t before = completions;
+    assert(DataEEWriteAsync(data, addr, Completed) == 0);
+    while (DataEETask(0) == DATA_EE_BUSY) {}
+    assert(completions == before + 1);
+    return completedStatus;
+}
+
+#define SWEEP_ADDRESSES 20
+#define SWEEP_WRITES 40
+
+// A control loop running at 100Hz, where everything else takes up to CONTROL_US of every tick.
+#define TICK_US 10000
+#define CONTROL_US 6000
+
+int main()
+{
+    printf("Testing DEEHost.c. All errors will be reported as failed assertions.\n");
+
+    // A fresh chip has nothing stored.
+    assert(DeeHostOpen(NULL));
+    assert(DataEEInit() == 0);
+    assert(deeHostStats.pageErases == DATA_EE_BANKS);
+    assert(DataEERead(3) == 0xFFFF && GetaddrNotFound());
+    dataEEFlags.val = 0;
+
+    // Values in both banks read back, and rewriting an unchanged value doesn't program anything.
+    assert(DataEEWrite(0x1234, 3) == 0);
+    assert(DataEEWrite(0xBEEF, DATA_EE_SIZE + 7) == 0);
+    assert(DataEERead(3) == 0x1234 && DataEERead(DATA_EE_SIZE + 7) == 0xBEEF);
+    const uint32_t programs = deeHostStats.wordPrograms;
+    assert(programs == DATA_EE_BANKS + 2);
+    assert(DataEEWrite(0x1234, 3) == 0);
+    assert(deeHostStats.wordPrograms == programs);
+    assert(DataEEWrite(0x5678, DATA_EE_TOTAL_SIZE) == 5);
+    dataEEFlags.val = 0;
+
+    // Fill the first bank's page several times over, which packs it into the next page each time.
+    DeeHostResetStats();
+    uint16_t i;
+    for (i = 0; i < 3 * NUMBER_OF_INSTRUCTIONS_IN_PAGE; ++i) {
+        assert(DataEEWrite(i, i % 50) == 0);
+    }
+    for (i = 3 * NUMBER_OF_INSTRUCTIONS_IN_PAGE - 50; i < 3 * NUMBER_OF_INSTRUCTIONS_IN_PAGE; ++i) {
+        assert(DataEERead(i % 50) == i);
+    }
+    assert(DataEERead(DATA_EE_SIZE + 7) == 0xBEEF);
+    const uint32_t packs = deeHostStats.pageErases;
+    assert(packs >= 3);
+    // Packing only programs the rows needed for the live values, which is a single one here.
+    assert(deeHostStats.rowPrograms == packs);
+    assert(deeHostStats.overprograms == 0 && deeHostStats.badAccesses == 0);
+    assert(DeeHostPageErases(0) + DeeHostPageErases(1) + DeeHostPageErases(2) == packs + 1);
+    printf("%u writes took %u packs, stalling for %.1fms and %u table reads.\n",
+           3 * NUMBER_OF_INSTRUCTIONS_IN_PAGE, (unsigned)packs, deeHostStats.stallUs / 1000.0,
+           (unsigned)deeHostStats.tableReads);
+
+    // The contents and erase counts persist in a file.
+    char path[] = "/tmp/DeeHostXXXXXX";
+    const int fd = mkstemp(path);
+    assert(fd >= 0);
+    close(fd);
+    assert(DeeHostOpen(path));
+    assert(DataEEInit() == 0);
+    assert(DataEEWrite(0xCAFE, 10) == 0);
+    const uint32_t erases = DeeHostPageErases(0);
+    DeeHostClose();
+    assert(DeeHostOpen(path));
+    assert(DataEEInit() == 0);
+    assert(DataEERead(10) == 0xCAFE);
+    assert(DeeHostPageErases(0) == erases && erases == 1);
+    DeeHostClose();
+    unlink(path);
+
+    // Lose power at every flash operation of a run of writes that packs the page, both written
+    // directly and through the queue, which leaves the page it packed to be erased later. After
+    // rebooting every address has to hold the last value completely written to it, except that the
+    // one being written when the power was lost may hold either its old or its new value.
+    assert(DeeHostOpen(NULL));
+    assert(DataEEInit() == 0);
+    for (i = 0; i < NUMBER_OF_INSTRUCTIONS_IN_PAGE - SWEEP_WRITES / 2; ++i) {
+        assert(DataEEWrite(i, i % SWEEP_ADDRESSES) == 0);
+    }
+    size_t size;
+    void *image = DeeHostImage(&size);
+    void *snapshot = malloc(size);
+    memcpy(snapshot, image, size);
+    uint16_t before[SWEEP_ADDRESSES];
+    for (i = 0; i < SWEEP_ADDRESSES; ++i) {
+        before[i] = DataEERead(i);
+    }
+
+    int pass;
+    for (pass = 0; pass < 2; ++pass) {
+        const bool async = pass;
+        memcpy(image, snapshot, size);
+        Reboot();
+        DeeHostResetStats();
+        for (i = 0; i < SWEEP_WRITES; ++i) {
+            assert(Write(async, 1000 + i, i % SWEEP_ADDRESSES) == 0);
+        }
+        const uint32_t operations = Operations();
+        assert(deeHostStats.pageErases == (async ? 0 : 1));
+
+        DeeHostTear tear;
+        uint32_t failures = 0, recovered = 0;
+        for (tear = DEE_HOST_TEAR_NONE; tear <= DEE_HOST_TEAR_HALF; ++tear) {
+            uint32_t failAt;
+            for (failAt = 0; failAt < operations; ++failAt) {
+                memcpy(image, snapshot, size);
+                Reboot();
+                DeeHostFailAfter(failAt, tear);
+
+                uint16_t expected[SWEEP_ADDRESSES];
+                memcpy(expected, before, sizeof(expected));
+                int16_t inFlight = -1;
+                for (i = 0; i < SWEEP_WRITES && !DeeHostPowerLost(); ++i) {
+                    Write(async, 1000 + i, i % SWEEP_ADDRESSES);
+                    if (DeeHostPowerLost()) {
+                        inFlight = i;
+                    } else {
+                        expected[i % SWEEP_ADDRESSES] = 1000 + i;
+                    }
+                }
+                assert(inFlight >= 0);
+                ++failures;
+
+                DeeHostFailAfter(-1, DEE_HOST_TEAR_NONE);
+                Reboot();
+                uint16_t a;
+                for (a = 0; a < SWEEP_ADDRESSES; ++a) {
+                    const uint16_t value = DataEERead(a);
+                    if (a == inFlight % SWEEP_ADDRESSES) {
+                        assert(value == expected[a] || value == 1000 + inFlight);
+                    } else {
+                        assert(value == expected[a]);
+                    }
+                }
+
+                // And writing carries on normally.
+                for (a = 0; a < SWEEP_ADDRESSES; ++a) {
+                    assert(Write(async, 2000 + a, a) == 0);
+                }
+                for (a = 0; a < SWEEP_ADDRESSES; ++a) {
+                    assert(DataEERead(a) == 2000 + a);
+                }
+                ++recovered;
+            }
+        }
+        printf("Recovered from power loss at all %u flash operations of %s writes.\n",
+               (unsigned)recovered / 2, async ? "queued" : "direct");
+        assert(recovered == failures && failures == 2 * operations);
+    }
+    free(snapshot);
+
+    // Queued writes never stall for longer than a row program, so a 100Hz loop keeps its deadline
+    // while filling a page with every address written, which is the largest pack there is, as long
+    // as erasing waits for later.
+    DeeHostEraseAll();
+    Reboot();
+    uint16_t a;
+    for (a = 0; a < DATA_EE_SIZE; ++a) {
+        assert(DataEEWrite(a, a) == 0);
+    }
+    DeeHostResetStats();
+    completions = 0;
+    const uint16_t queued = NUMBER_OF_INSTRUCTIONS_IN_PAGE;
+    uint16_t next = 0;
+    uint32_t ticks = 0;
+    double worstUs = 0;
+    for (ticks = 0; completions < queued; ++ticks) {
+        // New values arrive faster than they can be written, so the queue stays full.
+        while (next < queued && DataEEWriteAsync(5000 + next, next % DATA_EE_SIZE, Completed) == 0) {
+            ++next;
+        }
+        const double start = CostUs();
+        assert(DataEETask(0) != DATA_EE_IDLE);
+        const double passUs = CostUs() - start;
+        if (passUs > worstUs) {
+            worstUs = passUs;
+        }
+#if DATA_EE_RAM_INDEX
+        // Without the index, the reads for a row take most of a tick themselves.
+        assert(CONTROL_US + passUs <= TICK_US);
+#endif
+        assert(completedStatus == 0);
+    }
+    assert(deeHostStats.pageErases == 0);
+    assert(deeHostStats.rowPrograms == (DATA_EE_SIZE + NUMBER_OF_INSTRUCTIONS_IN_ROW) /
+                                       NUMBER_OF_INSTRUCTIONS_IN_ROW);
+    printf("%u queued writes and a pack of %u values took %u ticks at 100Hz, taking at most %.0fus of one.\n",
+           queued, DATA_EE_SIZE, (unsigned)ticks, worstUs);
+    for (a = 0; a < DATA_EE_SIZE; ++a) {
+        const uint16_t last = a + DATA_EE_SIZE * ((queued - 1 - a) / DATA_EE_SIZE);
+        assert(DataEERead(a) == 5000 + last);
+    }
+
+    // Until the packed page is erased, which is the only thing left to do.
+    assert(DataEETask(0) == DATA_EE_ERASE_PENDING);
+    const double start = CostUs();
+    assert(DataEETask(1) == DATA_EE_BUSY);
+    assert(deeHostStats.pageErases == 1 && CostUs() - start >= DEE_HOST_PAGE_ERASE_US);
+    assert(DataEETask(0) == DATA_EE_IDLE);
+
+    // Unchanged values complete right away, unless a change to the same address is still queued.
+    completions = 0;
+    const uint16_t value = DataEERead(0);
+    assert(DataEEWriteAsync(value, 0, Completed) == 0 && completions == 1);
+    assert(DataEEWriteAsync(value + 1, 0, Completed) == 0 && completions == 1);
+    assert(DataEEWriteAsync(value, 0, Completed) == 0 && completions == 1);
+    assert(DataEEWriteAsync(DataEERead(1), 1, Completed) == 0 && completions == 2);
+    while (DataEETask(1) != DATA_EE_IDLE) {}
+    assert(completions == 4 && DataEERead(0) == value);
+    assert(DataEEWriteAsync(0, DATA_EE_TOTAL_SIZE, Completed) == 5);
+    dataEEFlags.val = 0;
+
+    printf("All tests passed.\n");
+
+    return 0;
+}
+
+#endif // UNIT_TEST_DEE_HOST
+
+#ifdef DEE_HOST_BENCHMARK
+
+#include <stdio.h>
+
+#include "DataStore.h"
+#include "Parameters.h"
+
+// Parameters shaped like the primary node's, plus the rudder calibration limits.
+static uint8_t autoMode, gcsCompact, ctrlAlgo, offsetFix;
+static int32_t slewLimit;
+static float reals[9];
+static uint16_t rudderLimits[2];
+
+// And 100 more gains named Extra0 to Extra99, for a parameter set the size it's expected to grow to.
+static float extras[100];
+#define EXTRA(n) {"Extra" #n, &extras[n], NULL, NULL, PARAMETERS_DATATYPE_REAL32}
+#define EXTRA10(tens) EXTRA(tens##0), EXTRA(tens##1), EXTRA(tens##2), EXTRA(tens##3), \
+                      EXTRA(tens##4), EXTRA(tens##5), EXTRA(tens##6), EXTRA(tens##7), \
+                      EXTRA(tens##8), EXTRA(tens##9)
+
+static const Parameter params[] = {
+    {"ModeAuto", &autoMode, NULL, NULL, PARAMETERS_DATATYPE_UINT8},
+    {"GcsCompact", &gcsCompact, NULL, NULL, PARAMETERS_DATATYPE_UINT8},
+    {"Wheelbase", &reals[0], NULL, NULL, PARAMETERS_DATATYPE_REAL32},
+    {"Gps_SlewLimit", &slewLimit, NULL, NULL, PARAMETERS_DATATYPE_INT32},
+    {"ControlAlgo", &ctrlAlgo, NULL, NULL, PARAMETERS_DATATYPE_UINT8},
+    {"PD_Kpsi", &reals[1], NULL, NULL, PARAMETERS_DATATYPE_REAL32},
+    {"PD_Ky", &reals[2], NULL, NULL, PARAMETERS_DATATYPE_REAL32},
+    {"PD_KPsiDot", &reals[3], NULL, NULL, PARAMETERS_DATATYPE_REAL32},
+    {"L2+_T*", &reals[4], NULL, NULL, PARAMETERS_DATATYPE_REAL32},
+    {"L2+_MaxDownPath*", &reals[5], NULL, NULL, PARAMETERS_DATATYPE_REAL32},
+    {"L2+_TanInter", &reals[6], NULL, NULL, PARAMETERS_DATATYPE_REAL32},
+    {"L2+_SwitchDist", &reals[7], NULL, NULL, PARAMETERS_DATATYPE_REAL32},
+    {"L2+_KPsiDot", &reals[8], NULL, NULL, PARAMETERS_DATATYPE_REAL32},
+    {"L2+_OffsetFix", &offsetFix, NULL, NULL, PARAMETERS_DATATYPE_UINT8},
+    {"RudderPortLimit", &rudderLimits[0], NULL, NULL, PARAMETERS_DATATYPE_UINT16},
+    {"RudderSbLimit", &rudderLimits[1], NULL, NULL, PARAMETERS_DATATYPE_UINT16},
+    EXTRA10(), EXTRA10(1), EXTRA10(2), EXTRA10(3), EXTRA10(4),
+    EXTRA10(5), EXTRA10(6), EXTRA10(7), EXTRA10(8), EXTRA10(9)
+};
+const Parameter *onboardParameters = params;
+const uint16_t PARAMETERS_TOTAL = sizeof(params)/sizeof(Parameter);
+
+typedef enum {
+    WORKLOAD_TUNE_FLUSH,      // A gain changed and flushed, like tuning from the groundstation.
+    WORKLOAD_TUNE_SAVE_ALL,   // The same but saving every parameter.
+    WORKLOAD_CALIBRATE_BOOT,  // A reboot followed by a new rudder calibration.
+    WORKLOAD_CHANGE_ALL       // Every parameter changed and flushed.
+} Workload;
+
+static const char *const workloadNames[] = {
+    "Tune one gain, DataStoreFlush()",
+    "Tune one gain, DataStoreSaveParameters()",
+    "Reboot and recalibrate the rudder",
+    "Change every parameter, DataStoreFlush()"
+};
+
+// The modelled time in microseconds spent in flash operations and table reads so far.
+static double CostUs(void)
+{
+    return deeHostStats.stallUs + deeHostStats.tableReads * (DEE_HOST_TABLE_READ_NS / 1000.0);
+}
+
+// Changes the value of every parameter.
+static void ChangeAll(uint32_t seed)
+{
+    uint16_t p;
+    for (p = 0; p < PARAMETERS_TOTAL; ++p) {
+        uint8_t value[8] = {0};
+        value[0] = (uint8_t)(seed + p);
+        value[1] = (uint8_t)(seed >> 8);
+        ParameterSetValueById(p, value);
+    }
+}
+
+static void Run(Workload workload, uint32_t saves)
+{
+    DeeHostOpen(NULL);
+    dataEEFlags.val = 0;
+    DataStoreInit();
+    DeeHostResetStats();
+
+    double maxCost = 0, maxCostWithoutPack = 0;
+    uint32_t firstExpired = 0, firstFailure = 0;
+    uint32_t i;
+    for (i = 1; i <= saves; ++i) {
+        const double before = CostUs();
+        const uint32_t erases = deeHostStats.pageErases;
+        bool ok;
+        switch (workload) {
+            case WORKLOAD_TUNE_FLUSH: {
+                const float gain = 0.5f + (i % 100) / 100.0f;
+                ParameterSetValueByName("PD_Kpsi", &gain);
+                ok = DataStoreFlush();
+            } break;
+            case WORKLOAD_TUNE_SAVE_ALL: {
+                const float gain = 0.5f + (i % 100) / 100.0f;
+                ParameterSetValueByName("PD_Kpsi", &gain);
+                ok = DataStoreSaveParameters();
+            } break;
+            case WORKLOAD_CALIBRATE_BOOT: {
+                DeeHostPowerOn();
+                dataEEFlags.val = 0;
+                ok = (DataStoreInit() != DATASTORE_INIT_FAIL);
+                const uint16_t port = 100 + i % 7, starboard = 900 - i % 5;
+                ParameterSetValueByName("RudderPortLimit", &port);
+                ParameterSetValueByName("RudderSbLimit", &starboard);
+                ok = ok && DataStoreFlush();
+            } break;
+            case WORKLOAD_CHANGE_ALL:
+            default: {
+                ChangeAll(i);
+                ok = DataStoreFlush();
+            } break;
+        }
+
+        const double cost = CostUs() - before;
+        if (cost > maxCost) {
+            maxCost = cost;
+        }
+        if (deeHostStats.pageErases == erases && cost > maxCostWithoutPack) {
+            maxCostWithoutPack = cost;
+        }
+        if (!firstExpired && GetPageExpiredPage()) {
+            firstExpired = i;
+        }
+        if (!firstFailure && !ok) {
+            firstFailure = i;
+        }
+    }
+
+    uint32_t mostErases = 0;
+    uint8_t page;
+    for (page = 0; page < DEE_HOST_PAGES; ++page) {
+        if (DeeHostPageErases(page) > mostErases) {
+            mostErases = DeeHostPageErases(page);
+        }
+    }
+
+    printf("%s, %u saves:\n", workloadNames[workload], (unsigned)saves);
+    printf("  PackEE: %u packs, one every %.1f saves\n", (unsigned)deeHostStats.pageErases,
+           deeHostStats.pageErases ? (double)saves / deeHostStats.pageErases : 0.0);
+    printf("  Flash: %u word programs, %u row programs, %u table reads\n",
+           (unsigned)deeHostStats.wordPrograms, (unsigned)deeHostStats.rowPrograms,
+           (unsigned)deeHostStats.tableReads);
+    printf("  Cost per save: %.0fus mean, %.0fus max without a pack, %.0fus max with a pack\n",
+           CostUs() / saves, maxCostWithoutPack, maxCost);
+    if (mostErases) {
+        printf("  Saves until the rated %u erases of the most-used page: %.0f\n",
+               DEE_HOST_ENDURANCE, (double)saves * DEE_HOST_ENDURANCE / mostErases);
+    }
+    if (firstExpired) {
+        printf("  DEE marked its pages expired at save %u (ERASE_WRITE_CYCLE_MAX is %u)\n",
+               (unsigned)firstExpired, ERASE_WRITE_CYCLE_MAX);
+    }
+    if (firstFailure) {
+        printf("  Saving first failed at save %u\n", (unsigned)firstFailure);
+    }
+
+    DeeHostClose();
+}
+
+// Times loading every parameter when booting and saving every parameter, which both visit every
+// DEE address once.
+static void Boot(void)
+{
+    DeeHostOpen(NULL);
+    dataEEFlags.val = 0;
+    DataStoreInit();
+    ChangeAll(1);
+    DataStoreSaveParameters();
+
+    DeeHostPowerOn();
+    dataEEFlags.val = 0;
+    DeeHostResetStats();
+    const bool loaded = (DataStoreInit() == DATASTORE_INIT_SUCCESS);
+    const double loadUs = CostUs();
+    const uint32_t loadReads = deeHostStats.tableReads;
+
+    ChangeAll(2);
+    DeeHostResetStats();
+    const bool saved = DataStoreSaveParameters();
+    const double saveUs = CostUs();
+
+    printf("Boot with %u parameters (DATA_EE_RAM_INDEX %d):\n", PARAMETERS_TOTAL, DATA_EE_RAM_INDEX);
+    printf("  DataStoreInit(): %.0fus, %u table reads%s\n", loadUs, (unsigned)loadReads,
+           loaded ? "" : ", FAILED");
+    printf("  DataStoreSaveParameters(): %.0fus, %u table reads, %u packs%s\n", saveUs,
+           (unsigned)deeHostStats.tableReads, (unsigned)deeHostStats.pageErases,
+           saved ? "" : ", FAILED");
+
+    DeeHostClose();
+}
+
+int main()
+{
+    Boot();
+    Run(WORKLOAD_TUNE_FLUSH, 5000);
+    Run(WORKLOAD_TUNE_SAVE_ALL, 5000);
+    Run(WORKLOAD_CALIBRATE_BOOT, 2000);
+    Run(WORKLOAD_CHANGE_ALL, 1000);
+    return 0;
+}
+
+#endif // DEE_HOST_BENCHMARK
@@ -0,0 +1,160 @@
+#ifndef DEE_HOST_H
+#define DEE_HOST_H
+
+/**
+ * @file
+ * @brief A backend for Microchip's DEE library emulating dsPIC33F program flash on a PC.
+ *
+ * # Dependencies
+ *  * DEE.c, compiled with the DEE_HOST macro defined so that it includes this file instead of the
+ *    processor headers.
+ *  * POSIX mmap() for backing the emulated flash with a file.
+ *
+ * # Usage
+ * This implements the flash primitives from DEES_33F_24F.s (ReadPMHigh(), WritePMLow(),
+ * UnlockPM(), etc.) against an emulated program memory, so that the unmodified DEE library, and
+ * everything built on it like the DataStore library, runs and can be profiled on a PC. Like the
+ * real flash, every instruction word is 24-bits, table writes only fill the write latches,
+ * programming (a single word or a row of NUMBER_OF_INSTRUCTIONS_IN_ROW words) can only clear
+ * bits, and erasing sets every bit of a whole page.
+ *
+ * Call DeeHostOpen() before DataEEInit(). Given a path, the flash contents are kept in that file
+ * along with the number of times every page has been erased, so both carry over between runs like
+ * a real chip that's rebooted. Every flash operation is counted in `deeHostStats`, which also
+ * accumulates how long the CPU would have been stalled using nominal dsPIC33F timings.
+ *
+ * Power loss is emulated with DeeHostFailAfter(): the chosen flash operation is torn according to
+ * a DEE_HOST_TEAR mode and every later one is skipped, as if the chip had lost power, until
+ * DeeHostPowerOn() "reboots" it. DataEEInit() should then be called again to recover.
+ *
+ * Only the dsPIC33F/PIC24F/PIC24H flash is emulated. The dsPIC33E's double-word programming would
+ * need the DEES_33E_24E.s primitives modelled as well.
+ *
+ * Unit testing has been completed on x86 by compiling with the UNIT_TEST_DEE_HOST macro.
+ * With gcc: `gcc DEEHost.c DEE.c -DDEE_HOST -DUNIT_TEST_DEE_HOST -Wall -g`
+ *
+ * A benchmark of boot-time parameter loading and saving with over 100 parameters, and of PackEE()
+ * frequency and cost under parameter-saving workloads, is built with the DEE_HOST_BENCHMARK macro.
+ * Compare it built with -DDATA_EE_RAM_INDEX=1 to see what the RAM index saves.
+ * With gcc: `gcc DEEHost.c DEE.c DataStore.c Parameters.c -DDEE_HOST -DDEE_HOST_BENCHMARK -DPARAMETERS_MAX=128 -O2`
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "DEE.h"
+
+/**
+ * The program memory address the emulation pages start at, which must be page-aligned.
+ */
+#define DEE_HOST_BASE 0x10000UL
+
+/**
+ * The number of emulated flash pages.
+ */
+#define DEE_HOST_PAGES (DATA_EE_BANKS * NUM_DATA_EE_PAGES)
+
+/**
+ * The nominal time in microseconds the CPU stalls for each flash operation, and in nanoseconds for
+ * every table read including the call overhead.
+ */
+#define DEE_HOST_WORD_PROGRAM_US 50
+#define DEE_HOST_ROW_PROGRAM_US  1600
+#define DEE_HOST_PAGE_ERASE_US   20000
+#define DEE_HOST_TABLE_READ_NS   250
+
+/**
+ * The minimum number of erase/program cycles each flash page is rated for.
+ */
+#define DEE_HOST_ENDURANCE 10000
+
+// The special function registers used by DEE.c.
+extern unsigned int TBLPAG;
+extern unsigned int NVMCON;
+
+// No interrupts to disable on a PC.
+#define SET_AND_SAVE_CPU_IPL(save_to, ipl) ((save_to) = 0)
+#define RESTORE_CPU_IPL(saved_to) ((void)(saved_to))
+#define Nop()
+
+/**
+ * How a flash operation is torn when the power is lost during it.
+ */
+typedef enum {
+    DEE_HOST_TEAR_NONE = 0, // The operation never started.
+    DEE_HOST_TEAR_HALF      // Only the first half of the words (or only the low 16-bits of a single
+                            // word) were programmed or erased.
+} DeeHostTear;
+
+/**
+ * Counts of all flash accesses, since DeeHostOpen() or DeeHostResetStats().
+ */
+typedef struct {
+    uint32_t tableReads;
+    uint32_t wordPrograms;
+    uint32_t rowPrograms;
+    uint32_t pageErases;
+    uint32_t overprograms; // Programs that needed bits set that weren't erased first.
+    uint32_t badAccesses;  // Accesses outside the emulated pages or unknown NVMCON operations.
+    uint64_t stallUs;      // The modelled time the CPU was stalled.
+} DeeHostStats;
+
+extern DeeHostStats deeHostStats;
+
+/**
+ * Opens the emulated flash. The contents of an existing file are used, otherwise the flash starts
+ * erased. Any previously open flash is closed first.
+ * @param path The file to back the flash with, or NULL to keep it in memory only.
+ * @return true if it could be opened.
+ */
+bool DeeHostOpen(const char *path);
+
+/**
+ * Closes the emulated flash, writing everything back to its file.
+ */
+void DeeHostClose(void);
+
+/**
+ * Erases the whole emulated flash, like a freshly-programmed chip, and resets the erase counters.
+ */
+void DeeHostEraseAll(void);
+
+/**
+ * Provides direct access to the flash contents for taking and restoring snapshots. The contents are
+ * one 32-bit word per instruction, with the erase counters of every page after them. Like swapping
+ * the chip, restoring a snapshot must be followed by DataEEInit() to rebuild the DEE's RAM index.
+ * @param size Where to store the size of the contents in bytes.
+ */
+void *DeeHostImage(size_t *size);
+
+/**
+ * The number of times a page has been erased since the flash was created.
+ */
+uint32_t DeeHostPageErases(uint8_t page);
+
+/**
+ * Emulates losing power during a flash operation.
+ * @param operations The number of flash operations to complete before the one that's torn.
+ *                   Negative to never lose power.
+ * @param tear How the failing operation is torn.
+ */
+void DeeHostFailAfter(int32_t operations, DeeHostTear tear);
+
+/**
+ * Checks whether the power has been lost.
+ */
+bool DeeHostPowerLost(void);
+
+/**
+ * Restores the power after DeeHostFailAfter() triggered, clearing the write latches and registers.
+ * The flash contents are kept.
+ */
+void DeeHostPowerOn(void);
+
+/**
+ * Resets `deeHostStats`.
+ */
+void DeeHostResetStats(void);
+
+#endif // DEE_HOST_H
@@ -1,17 +1,356 @@
 #include "DataStore.h"
 #include "Parameters.h"
 #include "DEE.h"
-#include "Packing.h"
 
 #include <stdbool.h>
+#include <string.h>
 
-// This indicates the index location, in terms of words, into the EEPROM of the word that tracks
-// whether there is good data or not in the EEPROM. All the parameters will be stored in the
-// words following this one.
+/*
+ * The layout of the parameters in the EEPROM, in 16-bit words:
+ *  * HAS_BEEN_WRITTEN_LOCATION: GOOD_DATA once a complete set of parameters has been written.
+ *  * SCHEMA_HASH_LOCATION: The 32-bit schema hash of the parameters when they were written.
+ *  * ENTRY_COUNT_LOCATION: The number of parameters written.
+ *  * FIRST_ENTRY_LOCATION: The parameters, in order, each as two tag words followed by its value.
+ * The tag identifies the parameter by its name and datatype, so that parameters can still be found
+ * after the set of parameters has changed.
+ *
+ * The set of parameters can also be stored at the top of the EEPROM instead, which is marked with
+ * GOOD_DATA_HIGH. Then the header is at HIGH_HEADER_LOCATION: the address of the first parameter,
+ * followed by the schema hash and the number of parameters. The parameters run from that address
+ * up to the header. When the parameters change, the new layout is written to whichever end doesn't
+ * overlap the old one, and HAS_BEEN_WRITTEN_LOCATION is switched over last. So a reset part way
+ * through leaves the old store intact.
+ *
+ * Stores from before the schema hash was added are marked with LEGACY_DATA instead. They hold only
+ * the values of the parameters, in order from HAS_BEEN_WRITTEN_LOCATION + 1, and are loaded by
+ * position.
+ */
 #define HAS_BEEN_WRITTEN_LOCATION 0
+#define SCHEMA_HASH_LOCATION      1
+#define ENTRY_COUNT_LOCATION      3
+#define FIRST_ENTRY_LOCATION      4
+#define HIGH_HEADER_LOCATION      (DATA_EE_TOTAL_SIZE - 4)
 
 // This is the value of the data at HAS_BEEN_WRITTEN_LOCATION if there is good data stored there.
-#define GOOD_DATA 1
+#define GOOD_DATA 2
+
+// And the value if the good data is stored at the top of the EEPROM.
+#define GOOD_DATA_HIGH 3
+
+// And the value marking a store from before the schema hash was added.
+#define LEGACY_DATA 1
+
+// The number of words in the tag of every stored parameter.
+#define TAG_WORDS 2
+
+// The most words a single parameter's value takes up.
+#define MAX_PARAMETER_WORDS 4
+
+// Whether the EEPROM holds the current set of parameters in their current order, so that each of
+// them can be written in place.
+static bool layoutCurrent = false;
+
+// Where the first stored parameter is.
+static uint16_t entryBase = FIRST_ENTRY_LOCATION;
+
+// The words used by the stored parameters and their header, not counting
+// HAS_BEEN_WRITTEN_LOCATION, from storeStart up to storeEnd. Empty if nothing was loaded.
+static uint16_t storeStart = 0;
+static uint16_t storeEnd = 0;
+
+// Whether writes are queued for DataEETask() instead of being programmed right away.
+static bool asyncWrites = false;
+
+/**
+ * Hashes data into a running 32-bit FNV-1a hash.
+ */
+static uint32_t _Fnv1a(uint32_t hash, const uint8_t *data, uint16_t size)
+{
+	uint16_t i;
+	for (i = 0; i < size; ++i) {
+		hash ^= data[i];
+		hash *= 16777619UL;
+	}
+	return hash;
+}
+
+#define FNV1A_INIT 2166136261UL
+
+/**
+ * Returns how many EEPROM words a parameter of the given datatype takes up.
+ * @return The number of words, 0 for unknown datatypes.
+ */
+static uint8_t _ParameterWords(uint8_t dataType)
+{
+	switch (dataType) {
+		case PARAMETERS_DATATYPE_UINT8:
+		case PARAMETERS_DATATYPE_INT8:
+		case PARAMETERS_DATATYPE_UINT16:
+		case PARAMETERS_DATATYPE_INT16:
+			return 1;
+		case PARAMETERS_DATATYPE_UINT32:
+		case PARAMETERS_DATATYPE_INT32:
+		case PARAMETERS_DATATYPE_REAL32:
+			return 2;
+		case PARAMETERS_DATATYPE_UINT64:
+		case PARAMETERS_DATATYPE_INT64:
+			return 4;
+		case PARAMETERS_DATATYPE_REAL64:
+			// The C30/XC16 double is only 32-bits unless compiled otherwise.
+			return sizeof(double) / 2;
+		default:
+			return 0;
+	}
+}
+
+/**
+ * Returns how many EEPROM words a parameter of the given datatype took up in a legacy store, which
+ * only supported these datatypes.
+ * @return The number of words, 0 for datatypes that couldn't be stored.
+ */
+static uint8_t _LegacyParameterWords(uint8_t dataType)
+{
+	switch (dataType) {
+		case PARAMETERS_DATATYPE_UINT8:
+		case PARAMETERS_DATATYPE_UINT16:
+			return 1;
+		case PARAMETERS_DATATYPE_UINT32:
+		case PARAMETERS_DATATYPE_INT32:
+		case PARAMETERS_DATATYPE_REAL32:
+			return 2;
+		default:
+			return 0;
+	}
+}
+
+/**
+ * Returns the tag identifying a parameter in the EEPROM. The upper 28 bits are a hash of its name
+ * and the lower 4 bits its datatype. With that many bits a stored parameter is practically never
+ * mistaken for a different one that was renamed or added.
+ */
+static uint32_t _ParameterTag(uint16_t id)
+{
+	const char *name = onboardParameters[id].name;
+	const uint32_t hash = _Fnv1a(FNV1A_INIT, (const uint8_t *)name, strlen(name));
+	return (hash & ~0x0FUL) | (onboardParameters[id].dataType & 0x0F);
+}
+
+/**
+ * Returns the hash of the names and datatypes of all parameters in order. Changes whenever a
+ * parameter is added, removed, renamed, reordered, or changes its datatype.
+ */
+static uint32_t _SchemaHash(void)
+{
+	uint32_t hash = FNV1A_INIT;
+	uint16_t i;
+	for (i = 0; i < PARAMETERS_TOTAL; ++i) {
+		const char *name = onboardParameters[i].name;
+		const uint8_t dataType = onboardParameters[i].dataType;
+		hash = _Fnv1a(hash, (const uint8_t *)name, strlen(name) + 1);
+		hash = _Fnv1a(hash, &dataType, 1);
+	}
+	return hash;
+}
+
+/**
+ * Retrieves a parameter's value as little-endian words.
+ * @param id The ID of the parameter.
+ * @param words Where to store the value, MAX_PARAMETER_WORDS of them.
+ * @return The number of words stored, 0 if the datatype isn't supported.
+ */
+static uint8_t _ParameterToWords(uint16_t id, uint16_t words[MAX_PARAMETER_WORDS])
+{
+	union {
+		uint8_t u8;
+		int8_t i8;
+		uint16_t u16;
+		int16_t i16;
+		uint32_t u32;
+		int32_t i32;
+		uint64_t u64;
+		int64_t i64;
+		float r32;
+		double r64;
+	} value;
+	uint64_t bits;
+
+	ParameterGetValueById(id, &value);
+	switch (onboardParameters[id].dataType) {
+		case PARAMETERS_DATATYPE_UINT8:  bits = value.u8; break;
+		case PARAMETERS_DATATYPE_INT8:   bits = (uint8_t)value.i8; break;
+		case PARAMETERS_DATATYPE_UINT16: bits = value.u16; break;
+		case PARAMETERS_DATATYPE_INT16:  bits = (uint16_t)value.i16; break;
+		case PARAMETERS_DATATYPE_UINT32: bits = value.u32; break;
+		case PARAMETERS_DATATYPE_INT32:  bits = (uint32_t)value.i32; break;
+		case PARAMETERS_DATATYPE_UINT64: bits = value.u64; break;
+		case PARAMETERS_DATATYPE_INT64:  bits = (uint64_t)value.i64; break;
+		case PARAMETERS_DATATYPE_REAL32: {
+			uint32_t tmp;
+			memcpy(&tmp, &value.r32, sizeof(tmp));
+			bits = tmp;
+		} break;
+		case PARAMETERS_DATATYPE_REAL64:
+			if (sizeof(double) == sizeof(uint64_t)) {
+				memcpy(&bits, &value.r64, sizeof(bits));
+			} else {
+				uint32_t tmp;
+				memcpy(&tmp, &value.r64, sizeof(tmp));
+				bits = tmp;
+			}
+			break;
+		default:
+			return 0;
+	}
+
+	const uint8_t count = _ParameterWords(onboardParameters[id].dataType);
+	uint8_t i;
+	for (i = 0; i < count; ++i) {
+		words[i] = (uint16_t)(bits >> (16 * i));
+	}
+	return count;
+}
+
+/**
+ * Sets a parameter's value from little-endian words, the reverse of _ParameterToWords().
+ * @param id The ID of the parameter.
+ * @param words The value, as many words as _ParameterWords() says.
+ */
+static void _ParameterFromWords(uint16_t id, const uint16_t words[MAX_PARAMETER_WORDS])
+{
+	union {
+		uint8_t u8;
+		int8_t i8;
+		uint16_t u16;
+		int16_t i16;
+		uint32_t u32;
+		int32_t i32;
+		uint64_t u64;
+		int64_t i64;
+		float r32;
+		double r64;
+	} value;
+	uint64_t bits = 0;
+
+	const uint8_t count = _ParameterWords(onboardParameters[id].dataType);
+	uint8_t i;
+	for (i = 0; i < count; ++i) {
+		bits |= (uint64_t)words[i] << (16 * i);
+	}
+
+	switch (onboardParameters[id].dataType) {
+		case PARAMETERS_DATATYPE_UINT8:  value.u8 = (uint8_t)bits; break;
+		case PARAMETERS_DATATYPE_INT8:   value.i8 = (int8_t)bits; break;
+		case PARAMETERS_DATATYPE_UINT16: value.u16 = (uint16_t)bits; break;
+		case PARAMETERS_DATATYPE_INT16:  value.i16 = (int16_t)bits; break;
+		case PARAMETERS_DATATYPE_UINT32: value.u32 = (uint32_t)bits; break;
+		case PARAMETERS_DATATYPE_INT32:  value.i32 = (int32_t)bits; break;
+		case PARAMETERS_DATATYPE_UINT64: value.u64 = bits; break;
+		case PARAMETERS_DATATYPE_INT64:  value.i64 = (int64_t)bits; break;
+		case PARAMETERS_DATATYPE_REAL32: {
+			uint32_t tmp = (uint32_t)bits;
+			memcpy(&value.r32, &tmp, sizeof(tmp));
+		} break;
+		case PARAMETERS_DATATYPE_REAL64:
+			if (sizeof(double) == sizeof(uint64_t)) {
+				memcpy(&value.r64, &bits, sizeof(bits));
+			} else {
+				uint32_t tmp = (uint32_t)bits;
+				memcpy(&value.r64, &tmp, sizeof(tmp));
+			}
+			break;
+		default:
+			return;
+	}
+
+	ParameterSetValueById(id, &value);
+}
+
+/**
+ * Called once a queued write completes. As the parameter can't be told from the address alone, a
+ * failed write has everything written again by the next flush.
+ */
+static void _WriteCompleted(unsigned int addr, unsigned char status)
+{
+	(void)addr;
+	if (status) {
+		layoutCurrent = false;
+		ParameterMarkAllDirty();
+	}
+}
+
+/**
+ * Writes consecutive words into the EEPROM, or queues them when writing asynchronously. If the
+ * queue is full, queued writes are programmed right away to make room. That never erases, as the
+ * caller may not be able to afford a 20ms stall, so if DataEETask() can't make room without
+ * erasing a page the write fails and is left to be retried after the node's own DataEETask() call.
+ * @return true if they were all written or queued (DataEEWrite is 0 on success).
+ */
+static bool _WriteWords(const uint16_t *words, uint8_t count, uint16_t addr)
+{
+	if (addr + count > DATA_EE_TOTAL_SIZE) {
+		return false;
+	}
+	uint8_t i;
+	for (i = 0; i < count; ++i) {
+		if (asyncWrites) {
+			unsigned char status;
+			while ((status = DataEEWriteAsync(words[i], addr + i, _WriteCompleted)) == DATA_EE_QUEUE_FULL) {
+				if (DataEETask(0) == DATA_EE_ERASE_PENDING) {
+					return false;
+				}
+			}
+			if (status) {
+				return false;
+			}
+		} else if (DataEEWrite(words[i], addr + i)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Reads consecutive words from the EEPROM.
+ * @return true if they were all read. As 0xFFFF is a valid value, the DEE flags tell errors apart.
+ */
+static bool _ReadWords(uint16_t *words, uint8_t count, uint16_t addr)
+{
+	if (addr + count > DATA_EE_TOTAL_SIZE) {
+		return false;
+	}
+	dataEEFlags.val = 0;
+	uint8_t i;
+	for (i = 0; i < count; ++i) {
+		words[i] = DataEERead(addr + i);
+	}
+	return dataEEFlags.val == 0;
+}
+
+/**
+ * Writes a single parameter, tag and value, into the EEPROM and marks it as no longer dirty.
+ * @param id The ID of the parameter.
+ * @param addr The word address to write it to. Advanced past the parameter.
+ * @return true if it was written, false if it couldn't be.
+ */
+static bool _SaveParameter(uint16_t id, uint16_t *addr)
+{
+	uint16_t words[TAG_WORDS + MAX_PARAMETER_WORDS];
+	const uint8_t count = _ParameterToWords(id, &words[TAG_WORDS]);
+	if (!count) {
+		return false;
+	}
+	const uint32_t tag = _ParameterTag(id);
+	words[0] = (uint16_t)tag;
+	words[1] = (uint16_t)(tag >> 16);
+	if (!_WriteWords(words, TAG_WORDS + count, *addr)) {
+		return false;
+	}
+	*addr += TAG_WORDS + count;
+
+	// The stored value now matches the parameter.
+	ParameterClearDirty(id);
+	return true;
+}
 
 enum DATASTORE_INIT DataStoreInit(void)
 {
@@ -20,11 +359,6 @@ enum DATASTORE_INIT DataStoreInit(void)
 		return DATASTORE_INIT_FAIL;
 	}
 
-	// Then attempt to load the onboard parameters. This can fail if:
-	//  a) There was a problem with the EEPROM OR
-	//  b) There are no saved onboard parameters.
-    // In that case we save the current values and load them again and make sure everything worked.
-
 	// And load all stored parameters in the EEPROM. If this errors out, assume its because the
 	// EEPROM is currently empty (like if the PIC was just flashed). So write the current parameters
 	// and try reading them again and only error out if either of those fail.
@@ -40,242 +374,686 @@ enum DATASTORE_INIT DataStoreInit(void)
 		}
 	}
 
+	// If the parameters were found by name because they changed since they were stored, store
+	// them again in the current layout.
+	if (!layoutCurrent) {
+		if (!DataStoreSaveParameters()) {
+			return DATASTORE_INIT_FAIL;
+		}
+		return DATASTORE_INIT_MIGRATED;
+	}
+
 	return DATASTORE_INIT_SUCCESS;
 }
 
-bool _Write4BytesIntoMemory(const uint8_t data[4], uint8_t *addr)
+/**
+ * Writes every parameter in order, starting at the given address.
+ * @return true if they were all written.
+ */
+static bool _SaveAllParameters(uint16_t addr)
 {
-	// And pack those into uint16s.
-	uint16_t word1, word2;
-	LEUnpackUint16(&word1, &data[0]);
-	LEUnpackUint16(&word2, &data[2]);
-
-	// And write into memory (DataEEWrite is 0 on success).
-	if (DataEEWrite(word1, *addr)) {
-		return false;
-	}
-	*addr += 1;
-	if (DataEEWrite(word2, *addr)) {
-		return false;
+	uint16_t i;
+	for (i = 0; i < PARAMETERS_TOTAL; ++i) {
+		if (!_SaveParameter(i, &addr)) {
+			return false;
+		}
 	}
-	*addr += 1;
-
-	// Return success.
 	return true;
 }
 
-bool _Read4BytesFromMemory(uint8_t data[4], uint8_t *addr)
+/**
+ * Returns whether the words from start up to end overlap the current store.
+ */
+static bool _OverlapsStore(uint16_t start, uint16_t end)
 {
-	// Retrieve the 1st word from the memory.
-	uint16_t word1 = DataEERead(*addr);
-	if (word1 == 0xFFFF) {
-		if (dataEEFlags.val) {
+	return start < storeEnd && storeStart < end;
+}
+
+bool DataStoreSaveParameters(void)
+{
+	// The layout is the same, so every parameter is written in place.
+	if (layoutCurrent) {
+		return _SaveAllParameters(entryBase);
+	}
+
+	// Otherwise write the new layout to whichever end of the EEPROM doesn't overlap the current
+	// store, which stays valid until HAS_BEEN_WRITTEN_LOCATION is switched over.
+	uint16_t size = 0;
+	uint16_t i;
+	for (i = 0; i < PARAMETERS_TOTAL; ++i) {
+		size += TAG_WORDS + _ParameterWords(onboardParameters[i].dataType);
+	}
+	if (size > HIGH_HEADER_LOCATION - FIRST_ENTRY_LOCATION) {
+		return false;
+	}
+	const uint16_t highBase = HIGH_HEADER_LOCATION - size;
+	const bool high = _OverlapsStore(SCHEMA_HASH_LOCATION, FIRST_ENTRY_LOCATION + size) &&
+	                  !_OverlapsStore(highBase, DATA_EE_TOTAL_SIZE);
+
+	// If both ends overlap it, the store is over half of the EEPROM and has to be replaced in place.
+	// Mark the EEPROM as empty first so that a reset part way through doesn't leave the old header
+	// describing a mix of both. Then a reset loses the stored values.
+	if (!high && _OverlapsStore(SCHEMA_HASH_LOCATION, FIRST_ENTRY_LOCATION + size)) {
+		const uint16_t empty = 0;
+		if (!_WriteWords(&empty, 1, HAS_BEEN_WRITTEN_LOCATION)) {
 			return false;
 		}
+		storeStart = storeEnd = 0;
 	}
-	*addr += 1;
 
-	// And the 2nd word.
-	uint16_t word2 = DataEERead(*addr);
-	if (word2 == 0xFFFF) {
-		if (dataEEFlags.val) {
+	// Write the header describing these parameters, and then every parameter.
+	const uint32_t hash = _SchemaHash();
+	const uint16_t base = high ? highBase : FIRST_ENTRY_LOCATION;
+	if (high) {
+		const uint16_t header[4] = {base, (uint16_t)hash, (uint16_t)(hash >> 16), PARAMETERS_TOTAL};
+		if (!_WriteWords(header, 4, HIGH_HEADER_LOCATION)) {
+			return false;
+		}
+	} else {
+		const uint16_t header[3] = {(uint16_t)hash, (uint16_t)(hash >> 16), PARAMETERS_TOTAL};
+		if (!_WriteWords(header, 3, SCHEMA_HASH_LOCATION)) {
 			return false;
 		}
 	}
-	*addr += 1;
-
-	// And store them into the provided byte array as little-endian.
-	LEPackUint16(&data[0], word1);
-	LEPackUint16(&data[2], word2);
+	if (!_SaveAllParameters(base)) {
+		return false;
+	}
 
-	// Return success.
+	// Now switch over to the new store and fail out if that can't be done.
+	const uint16_t good = high ? GOOD_DATA_HIGH : GOOD_DATA;
+	if (!_WriteWords(&good, 1, HAS_BEEN_WRITTEN_LOCATION)) {
+		return false;
+	}
+	layoutCurrent = true;
+	entryBase = base;
+	storeStart = high ? base : SCHEMA_HASH_LOCATION;
+	storeEnd = high ? DATA_EE_TOTAL_SIZE : FIRST_ENTRY_LOCATION + size;
 	return true;
 }
 
-bool DataStoreSaveParameters(void)
+bool DataStoreFlush(void)
 {
-	// The address to use for this parameter. Stored as some data types are larger than a single
-	// word.
-	uint8_t offset = HAS_BEEN_WRITTEN_LOCATION + 1;
+	// Without the current set of parameters stored the clean ones aren't where they should be, so
+	// everything has to be written.
+	if (!layoutCurrent) {
+		return DataStoreSaveParameters();
+	}
 
-	int i;
+	// Every parameter lives at a fixed address determined by the sizes of the ones before it, so
+	// only the changed ones need to be touched.
+	uint16_t addr = entryBase;
+	uint16_t i;
 	for (i = 0; i < PARAMETERS_TOTAL; ++i) {
-		switch (onboardParameters[i].dataType) {
-			case PARAMETERS_DATATYPE_UINT8: {
-				// First grab the parameter data.
-				uint8_t param;
-				ParameterGetValueById(i, &param);
-
-				// And write it into EEPROM (non-zero values mean failure).
-				if (DataEEWrite(param, offset)) {
-					return false;
-				}
-
-				// And increment the memory location for the next parameter.
-				++offset;
-			} break;
-			case PARAMETERS_DATATYPE_UINT16: {
-				// First grab the parameter data.
-				uint16_t param;
-				ParameterGetValueById(i, &param);
+		if (ParameterIsDirty(i)) {
+			if (!_SaveParameter(i, &addr)) {
+				return false;
+			}
+		} else {
+			addr += TAG_WORDS + _ParameterWords(onboardParameters[i].dataType);
+		}
+	}
 
-				// And write it into EEPROM (non-zero values mean failure).
-				if (DataEEWrite(param, offset)) {
-					return false;
-				}
+	return true;
+}
 
-				// And increment the memory location for the next parameter.
-				++offset;
-			} break;
-			case PARAMETERS_DATATYPE_UINT32: {
-				// First grab the parameter data.
-				uint32_t param;
-				ParameterGetValueById(i, &param);
+/**
+ * Finds the parameter with the given tag.
+ * @return Its ID, or UINT16_MAX if no parameter or more than one has that tag.
+ */
+static uint16_t _FindParameterByTag(uint32_t tag)
+{
+	uint16_t found = UINT16_MAX;
+	uint16_t i;
+	for (i = 0; i < PARAMETERS_TOTAL; ++i) {
+		if (_ParameterTag(i) == tag) {
+			if (found != UINT16_MAX) {
+				return UINT16_MAX;
+			}
+			found = i;
+		}
+	}
+	return found;
+}
 
-				// Now split it up into bytes.
-				uint8_t tmp[4];
-				LEPackUint32(tmp, param);
+void DataStoreSetAsync(bool async)
+{
+	asyncWrites = async;
+}
 
-				// And write it into EEPROM.
-				if (!_Write4BytesIntoMemory(tmp, &offset)) {
-					return false;
-				}
-			} break;
-			case PARAMETERS_DATATYPE_INT32: {
-				// First grab the parameter data.
-				int32_t param;
-				ParameterGetValueById(i, &param);
-
-				// Now split it up into bytes.
-				uint8_t tmp[4];
-				LEPackInt32(tmp, param);
-
-				// And write it into EEPROM.
-				if (!_Write4BytesIntoMemory(tmp, &offset)) {
-					return false;
-				}
-			} break;
-			case PARAMETERS_DATATYPE_REAL32: {
-				// First grab the parameter data.
-				float param;
-				ParameterGetValueById(i, &param);
-
-				// Now split it up into bytes.
-				uint8_t tmp[4];
-				LEPackReal32(tmp, param);
-
-				// And write it into EEPROM.
-				if (!_Write4BytesIntoMemory(tmp, &offset)) {
-					return false;
-				}
-			} break;
-			default:
-				return false;
+/**
+ * Loads a legacy store, where the values of the parameters were stored in order without any tags.
+ * The parameters are assumed to be the same as when it was written, only with new ones added at
+ * the end, so loading stops at the first one that couldn't have been stored or wasn't found.
+ * Those keep their values and stay dirty.
+ * @return true if the store could be read.
+ */
+static bool _LoadLegacyParameters(void)
+{
+	uint16_t addr = HAS_BEEN_WRITTEN_LOCATION + 1;
+	uint16_t i;
+	for (i = 0; i < PARAMETERS_TOTAL; ++i) {
+		uint16_t words[MAX_PARAMETER_WORDS];
+		const uint8_t count = _LegacyParameterWords(onboardParameters[i].dataType);
+		if (!count || !_ReadWords(words, count, addr)) {
+			break;
 		}
-	}
+		addr += count;
 
-	// Now try to update the metadata and fail out if that can't be updated.
-	if (DataEEWrite(GOOD_DATA, HAS_BEEN_WRITTEN_LOCATION) == 0) {
-		return true;
-	} else {
-		return false;
+		// These datatypes are stored as the same little-endian words as in the current layout.
+		_ParameterFromWords(i, words);
+		ParameterClearDirty(i);
 	}
+
+	// It still has to be stored again in the current layout, without overwriting what was loaded.
+	layoutCurrent = false;
+	storeStart = HAS_BEEN_WRITTEN_LOCATION + 1;
+	storeEnd = addr;
+	return true;
 }
 
 bool DataStoreLoadParameters(void)
 {
-	// First check the first memory location. If this value is 1 (instead of the 0xFFFFFFFF the
+	// First check the first memory location. If this value is GOOD_DATA (instead of the 0xFFFF the
 	// EEPROM on the PICs defaults to), then there is good data stored here. Otherwise, we just
 	// fail out as there's no data to load.
-	if (DataEERead(HAS_BEEN_WRITTEN_LOCATION) != GOOD_DATA) {
+	layoutCurrent = false;
+	storeStart = storeEnd = 0;
+	uint16_t marker;
+	if (!_ReadWords(&marker, 1, HAS_BEEN_WRITTEN_LOCATION)) {
 		return false;
 	}
+	if (marker == LEGACY_DATA) {
+		return _LoadLegacyParameters();
+	}
 
-	// The address to use for this parameter. Stored as some data types are larger than a single
-	// word.
-	uint8_t offset = HAS_BEEN_WRITTEN_LOCATION + 1;
+	// Find the header, at the bottom or the top of the EEPROM.
+	uint16_t header[4];
+	uint16_t base, limit;
+	if (marker == GOOD_DATA) {
+		if (!_ReadWords(&header[1], 3, SCHEMA_HASH_LOCATION)) {
+			return false;
+		}
+		base = FIRST_ENTRY_LOCATION;
+		limit = DATA_EE_TOTAL_SIZE;
+	} else if (marker == GOOD_DATA_HIGH) {
+		if (!_ReadWords(header, 4, HIGH_HEADER_LOCATION)) {
+			return false;
+		}
+		base = header[0];
+		limit = HIGH_HEADER_LOCATION;
+		if (base <= HAS_BEEN_WRITTEN_LOCATION || base > limit) {
+			return false;
+		}
+	} else {
+		return false;
+	}
+	const uint32_t hash = (uint32_t)header[1] | ((uint32_t)header[2] << 16);
+	const uint16_t entries = header[3];
+	const bool sameSchema = (hash == _SchemaHash() && entries == PARAMETERS_TOTAL);
 
-	int i;
-	for (i = 0; i < PARAMETERS_TOTAL; ++i) {
-		switch (onboardParameters[i].dataType) {
-			case PARAMETERS_DATATYPE_UINT8:	{
-				// Grab the byte from the EEPROM.
-				uint8_t param;
-				if ((param = DataEERead(offset)) == 0xFFFF) {
-					// Error out if an error actually occured. 0xFFFF can be a valid stored value.
-					if (dataEEFlags.val) {
-						return false;
-					}
-				}
+	// Walk through the stored parameters. With the same schema they're the current parameters in
+	// order, otherwise each is matched to a current parameter by its tag. Current parameters that
+	// aren't found keep their values and stay dirty.
+	uint16_t addr = base;
+	uint16_t i;
+	for (i = 0; i < entries; ++i) {
+		uint16_t words[TAG_WORDS + MAX_PARAMETER_WORDS];
+		if (addr + TAG_WORDS > limit || !_ReadWords(words, TAG_WORDS, addr)) {
+			return false;
+		}
+		const uint8_t count = _ParameterWords(words[0] & 0x0F);
+		if (!count || addr + TAG_WORDS + count > limit ||
+		    !_ReadWords(&words[TAG_WORDS], count, addr + TAG_WORDS)) {
+			return false;
+		}
+		addr += TAG_WORDS + count;
 
-				// And finally handle writing it into the parameter.
-				ParameterSetValueById(i, &param);
-
-				// And increment the memory location for the next parameter.
-				++offset;
-			} break;
-			case PARAMETERS_DATATYPE_UINT16:	{
-				// Grab the byte from the EEPROM.
-				uint16_t param;
-				if ((param = DataEERead(offset)) == 0xFFFFFFFF) {
-					// Error out if an error actually occured. 0xFFFF can be a valid stored value.
-					if (dataEEFlags.val) {
-						return false;
-					}
-				}
+		const uint32_t tag = (uint32_t)words[0] | ((uint32_t)words[1] << 16);
+		const uint16_t id = sameSchema ? i : _FindParameterByTag(tag);
+		if (id != UINT16_MAX) {
+			_ParameterFromWords(id, &words[TAG_WORDS]);
 
-				// And finally handle writing it into the parameter.
-				ParameterSetValueById(i, &param);
+			// The parameter now matches what's stored.
+			ParameterClearDirty(id);
+		}
+	}
 
-				// And increment the memory location for the next parameter.
-				++offset;
-			} break;
-			case PARAMETERS_DATATYPE_UINT32:	{
-				// Grab the 4 bytes that make up this parameter from the EEPROM.
-				uint8_t tmp[4];
-				if (!_Read4BytesFromMemory(tmp, &offset)) {
-					return false;
-				}
+	layoutCurrent = sameSchema;
+	entryBase = base;
+	storeStart = (marker == GOOD_DATA) ? SCHEMA_HASH_LOCATION : base;
+	storeEnd = (marker == GOOD_DATA) ? addr : DATA_EE_TOTAL_SIZE;
+	return true;
+}
 
-				// And restore it into its proper datatype.
-				uint32_t param;
-				LEUnpackUint32(&param, tmp);
-
-				// And finally handle writing it into the parameter.
-				ParameterSetValueById(i, &param);
-			} break;
-			case PARAMETERS_DATATYPE_INT32:	{
-				// Grab the 4 bytes that make up this parameter from the EEPROM.
-				uint8_t tmp[4];
-				if (!_Read4BytesFromMemory(tmp, &offset)) {
-					return false;
-				}
 
-				// And restore it into its proper datatype.
-				int32_t param;
-				LEUnpackInt32(&param, tmp);
-
-				// And finally handle writing it into the parameter.
-				ParameterSetValueById(i, &param);
-			} break;
-			case PARAMETERS_DATATYPE_REAL32:	{
-				// Grab the 4 bytes that make up this parameter from the EEPROM.
-				uint8_t tmp[4];
-				if (!_Read4BytesFromMemory(tmp, &offset)) {
-					return false;
-				}
+#ifdef UNIT_TEST_DATA_STORE
 
-				// And restore it into its proper datatype.
-				float param;
-				LEUnpackReal32(&param, tmp);
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <math.h>
 
-				// And finally handle writing it into the parameter.
-				ParameterSetValueById(i, &param);
-			} break;
-			default:
-				return false;
-		}
+#include "DEEHost.h"
+
+// Erases the EEPROM, like a freshly-programmed chip.
+static void EraseEeprom(void)
+{
+	DeeHostEraseAll();
+	dataEEFlags.val = 0;
+	assert(DataEEInit() == 0);
+}
+
+// The modelled time in microseconds the CPU was stalled in DEE so far.
+static double CostUs(void)
+{
+	return deeHostStats.stallUs + deeHostStats.tableReads * (DEE_HOST_TABLE_READ_NS / 1000.0);
+}
+
+// Runs DataEETask() until everything queued is written, erasing when needed.
+static void DrainQueue(void)
+{
+	while (DataEETask(1) != DATA_EE_IDLE) {}
+}
+
+// Parameter variables covering every datatype, accessed both directly and through setters.
+static uint8_t u8;
+static int8_t i8;
+static uint16_t u16;
+static int16_t i16;
+static uint32_t u32;
+static int32_t i32;
+static uint64_t u64;
+static int64_t i64;
+static float r32;
+static double r64;
+static float rudderLimits[2];
+static float newGain;
+
+static void SetRudderMin(float x) { rudderLimits[0] = x; }
+static float GetRudderMin(void) { return rudderLimits[0]; }
+
+// Counts the changes to RudderMax.
+static uint16_t rudderMaxChanges;
+static void RudderMaxChanged(uint16_t id) { assert(id == 11); ++rudderMaxChanges; }
+
+// The parameters of three firmware versions. The second inserts "NewGain" and drops "u64". The
+// third swaps the rudder limits, renames "i8", and changes the datatype of "u16".
+static const Parameter paramsV1[] = {
+	{"u8", &u8, NULL, NULL, PARAMETERS_DATATYPE_UINT8},
+	{"i8", &i8, NULL, NULL, PARAMETERS_DATATYPE_INT8},
+	{"u16", &u16, NULL, NULL, PARAMETERS_DATATYPE_UINT16},
+	{"i16", &i16, NULL, NULL, PARAMETERS_DATATYPE_INT16},
+	{"u32", &u32, NULL, NULL, PARAMETERS_DATATYPE_UINT32},
+	{"i32", &i32, NULL, NULL, PARAMETERS_DATATYPE_INT32},
+	{"u64", &u64, NULL, NULL, PARAMETERS_DATATYPE_UINT64},
+	{"i64", &i64, NULL, NULL, PARAMETERS_DATATYPE_INT64},
+	{"r32", &r32, NULL, NULL, PARAMETERS_DATATYPE_REAL32},
+	{"r64", &r64, NULL, NULL, PARAMETERS_DATATYPE_REAL64},
+	{"RudderMin", NULL, (void(*)())SetRudderMin, (void(*)())GetRudderMin, PARAMETERS_DATATYPE_REAL32},
+	{"RudderMax", &rudderLimits[1], NULL, NULL, PARAMETERS_DATATYPE_REAL32, RudderMaxChanged}
+};
+static const Parameter paramsV2[] = {
+	{"u8", &u8, NULL, NULL, PARAMETERS_DATATYPE_UINT8},
+	{"i8", &i8, NULL, NULL, PARAMETERS_DATATYPE_INT8},
+	{"NewGain", &newGain, NULL, NULL, PARAMETERS_DATATYPE_REAL32},
+	{"u16", &u16, NULL, NULL, PARAMETERS_DATATYPE_UINT16},
+	{"i16", &i16, NULL, NULL, PARAMETERS_DATATYPE_INT16},
+	{"u32", &u32, NULL, NULL, PARAMETERS_DATATYPE_UINT32},
+	{"i32", &i32, NULL, NULL, PARAMETERS_DATATYPE_INT32},
+	{"i64", &i64, NULL, NULL, PARAMETERS_DATATYPE_INT64},
+	{"r32", &r32, NULL, NULL, PARAMETERS_DATATYPE_REAL32},
+	{"r64", &r64, NULL, NULL, PARAMETERS_DATATYPE_REAL64},
+	{"RudderMin", NULL, (void(*)())SetRudderMin, (void(*)())GetRudderMin, PARAMETERS_DATATYPE_REAL32},
+	{"RudderMax", &rudderLimits[1], NULL, NULL, PARAMETERS_DATATYPE_REAL32}
+};
+static const Parameter paramsV3[] = {
+	{"u8", &u8, NULL, NULL, PARAMETERS_DATATYPE_UINT8},
+	{"i8b", &i8, NULL, NULL, PARAMETERS_DATATYPE_INT8},
+	{"NewGain", &newGain, NULL, NULL, PARAMETERS_DATATYPE_REAL32},
+	{"u16", &u32, NULL, NULL, PARAMETERS_DATATYPE_UINT32},
+	{"i16", &i16, NULL, NULL, PARAMETERS_DATATYPE_INT16},
+	{"u32", &u32, NULL, NULL, PARAMETERS_DATATYPE_UINT32},
+	{"i32", &i32, NULL, NULL, PARAMETERS_DATATYPE_INT32},
+	{"i64", &i64, NULL, NULL, PARAMETERS_DATATYPE_INT64},
+	{"r32", &r32, NULL, NULL, PARAMETERS_DATATYPE_REAL32},
+	{"r64", &r64, NULL, NULL, PARAMETERS_DATATYPE_REAL64},
+	{"RudderMax", &rudderLimits[1], NULL, NULL, PARAMETERS_DATATYPE_REAL32},
+	{"RudderMin", NULL, (void(*)())SetRudderMin, (void(*)())GetRudderMin, PARAMETERS_DATATYPE_REAL32}
+};
+// The parameters when a legacy store was written, which only supported some datatypes, followed
+// by ones added since.
+static const Parameter paramsLegacy[] = {
+	{"u8", &u8, NULL, NULL, PARAMETERS_DATATYPE_UINT8},
+	{"u16", &u16, NULL, NULL, PARAMETERS_DATATYPE_UINT16},
+	{"u32", &u32, NULL, NULL, PARAMETERS_DATATYPE_UINT32},
+	{"i32", &i32, NULL, NULL, PARAMETERS_DATATYPE_INT32},
+	{"r32", &r32, NULL, NULL, PARAMETERS_DATATYPE_REAL32},
+	{"RudderMin", NULL, (void(*)())SetRudderMin, (void(*)())GetRudderMin, PARAMETERS_DATATYPE_REAL32},
+	{"RudderMax", &rudderLimits[1], NULL, NULL, PARAMETERS_DATATYPE_REAL32},
+	{"NewGain", &newGain, NULL, NULL, PARAMETERS_DATATYPE_REAL32},
+	{"i8", &i8, NULL, NULL, PARAMETERS_DATATYPE_INT8},
+	{"i16", &i16, NULL, NULL, PARAMETERS_DATATYPE_INT16},
+	{"u64", &u64, NULL, NULL, PARAMETERS_DATATYPE_UINT64},
+	{"i64", &i64, NULL, NULL, PARAMETERS_DATATYPE_INT64}
+};
+// Two sets where "r32" is renamed to one of two names whose hashes match in their lowest bits.
+#define PARAMS_RENAMED_R32(name) { \
+	{"u8", &u8, NULL, NULL, PARAMETERS_DATATYPE_UINT8}, \
+	{"i8", &i8, NULL, NULL, PARAMETERS_DATATYPE_INT8}, \
+	{"u16", &u16, NULL, NULL, PARAMETERS_DATATYPE_UINT16}, \
+	{"i16", &i16, NULL, NULL, PARAMETERS_DATATYPE_INT16}, \
+	{"u32", &u32, NULL, NULL, PARAMETERS_DATATYPE_UINT32}, \
+	{"i32", &i32, NULL, NULL, PARAMETERS_DATATYPE_INT32}, \
+	{"u64", &u64, NULL, NULL, PARAMETERS_DATATYPE_UINT64}, \
+	{"i64", &i64, NULL, NULL, PARAMETERS_DATATYPE_INT64}, \
+	{name, &r32, NULL, NULL, PARAMETERS_DATATYPE_REAL32}, \
+	{"r64", &r64, NULL, NULL, PARAMETERS_DATATYPE_REAL64}, \
+	{"RudderMin", NULL, (void(*)())SetRudderMin, (void(*)())GetRudderMin, PARAMETERS_DATATYPE_REAL32}, \
+	{"RudderMax", &rudderLimits[1], NULL, NULL, PARAMETERS_DATATYPE_REAL32} \
+}
+static const Parameter paramsGain71[] = PARAMS_RENAMED_R32("Gain71");
+static const Parameter paramsGain95[] = PARAMS_RENAMED_R32("Gain95");
+const Parameter *onboardParameters = paramsV1;
+const uint16_t PARAMETERS_TOTAL = sizeof(paramsV1)/sizeof(Parameter);
+
+// Zeroes every parameter variable, like RAM after a reboot.
+static void ClearRam(void)
+{
+	u8 = 0; i8 = 0; u16 = 0; i16 = 0; u32 = 0; i32 = 0; u64 = 0; i64 = 0; r32 = 0; r64 = 0;
+	rudderLimits[0] = rudderLimits[1] = 0;
+	newGain = 0;
+	ParameterMarkAllDirty();
+}
+
+int main()
+{
+	printf("Testing DataStore.c. All errors will be reported as failed assertions.\n");
+
+	// The first boot preloads the EEPROM with the current values, leaving nothing dirty.
+	assert(DeeHostOpen(NULL));
+	assert(DataStoreInit() == DATASTORE_INIT_PRELOADED);
+	assert(!ParameterAnyDirty());
+
+	// Round-trip the extremes and some bit patterns of every datatype.
+	static const uint64_t patterns[] = {
+		0, UINT64_MAX, 1, 0x8000000000000000ULL, 0x7FFFFFFFFFFFFFFFULL, 0x0123456789ABCDEFULL,
+		0xFFFF0000FFFF0000ULL, 0x00FF00FF00FF00FFULL
+	};
+	static const double reals[] = {0.0, -0.0, 1.5, -3.25e-7, 6.02e23, INFINITY, -INFINITY, 1e-300};
+	uint8_t k;
+	for (k = 0; k < sizeof(patterns) / sizeof(patterns[0]); ++k) {
+		const uint64_t p = patterns[k];
+		u8 = (uint8_t)p; i8 = (int8_t)p; u16 = (uint16_t)p; i16 = (int16_t)p;
+		u32 = (uint32_t)p; i32 = (int32_t)p; u64 = p; i64 = (int64_t)p;
+		r32 = (float)reals[k]; r64 = reals[k];
+		rudderLimits[0] = -(float)reals[k]; rudderLimits[1] = (float)k;
+		ParameterMarkAllDirty();
+		assert(DataStoreFlush());
+
+		ClearRam();
+		assert(DataStoreLoadParameters());
+		assert(!ParameterAnyDirty());
+		assert(u8 == (uint8_t)p && i8 == (int8_t)p && u16 == (uint16_t)p && i16 == (int16_t)p);
+		assert(u32 == (uint32_t)p && i32 == (int32_t)p && u64 == p && i64 == (int64_t)p);
+		assert(memcmp(&r32, &(float){(float)reals[k]}, sizeof(r32)) == 0);
+		assert(memcmp(&r64, &reals[k], sizeof(r64)) == 0);
+		assert(rudderLimits[0] == -(float)reals[k] && rudderLimits[1] == k);
 	}
 
-	return true;
-}
\ No newline at end of file
+	// NaNs round-trip bit for bit too.
+	r32 = NAN; r64 = -NAN;
+	ParameterMarkDirty(8);
+	ParameterMarkDirty(9);
+	assert(DataStoreFlush());
+	ClearRam();
+	assert(DataStoreLoadParameters());
+	assert(isnan(r32) && isnan(r64) && signbit(r64));
+
+	// Flushing without any changes doesn't touch the EEPROM at all.
+	DeeHostResetStats();
+	assert(DataStoreFlush());
+	assert(deeHostStats.tableReads == 0 && deeHostStats.wordPrograms == 0);
+
+	// Change only a rudder limit. Saving everything still has DEE read back every word to skip the
+	// unchanged ones, even though it ends up only programming the changed ones.
+	const float limit = 0.61f;
+	assert(ParameterSetValueByName("RudderMax", &limit) == 11);
+	assert(ParameterIsDirty(11) && !ParameterIsDirty(10));
+	DeeHostResetStats();
+	assert(DataStoreSaveParameters());
+	const uint32_t fullReads = deeHostStats.tableReads, fullPrograms = deeHostStats.wordPrograms;
+	const double fullUs = CostUs();
+	printf("Full save after one change: %u table reads, %u programmed, %.0fus.\n",
+	       (unsigned)fullReads, (unsigned)fullPrograms, fullUs);
+
+	// The same change again but flushed writes only that parameter's tag and value.
+	const float otherLimit = 0.72f;
+	assert(ParameterSetValueByName("RudderMax", &otherLimit) == 11);
+	DeeHostResetStats();
+	assert(DataStoreFlush());
+	printf("Flush after one change: %u table reads, %u programmed, %.0fus.\n",
+	       (unsigned)deeHostStats.tableReads, (unsigned)deeHostStats.wordPrograms, CostUs());
+	assert(deeHostStats.wordPrograms == fullPrograms);
+	assert(deeHostStats.tableReads < fullReads / 4);
+
+	// A direct change to a variable is only persisted once it's marked dirty.
+	u16 = 250;
+	ParameterMarkDirty(2);
+	assert(DataStoreFlush());
+
+	// Observers are told about every change, whether set through the library, loaded, or signalled
+	// after changing the variable directly.
+	rudderMaxChanges = 0;
+	ParameterSetValueByName("RudderMax", &limit);
+	assert(rudderMaxChanges == 1);
+	assert(DataStoreFlush());
+	ClearRam();
+	assert(DataStoreLoadParameters());
+	assert(rudderMaxChanges == 2 && !ParameterIsDirty(11));
+	rudderLimits[1] = 0.5f;
+	ParameterChanged(11);
+	assert(rudderMaxChanges == 3 && ParameterIsDirty(11));
+	ParameterChanged(PARAMETERS_TOTAL);
+	assert(rudderMaxChanges == 3);
+	assert(DataStoreFlush());
+
+	// Many single-parameter updates, like tuning a gain from the groundstation, fill and pack the
+	// page, and every value survives the packs.
+	DeeHostResetStats();
+	uint16_t i;
+	for (i = 0; i < 1000; ++i) {
+		const float g = i;
+		ParameterSetValueById(8, &g);
+		assert(DataStoreFlush());
+	}
+	printf("1000 flushed updates: %u programmed, %u packs.\n",
+	       (unsigned)deeHostStats.wordPrograms, (unsigned)deeHostStats.pageErases);
+	assert(deeHostStats.pageErases > 0);
+	ClearRam();
+	assert(DataStoreLoadParameters());
+	assert(r32 == 999.0f && rudderLimits[1] == 0.5f && u16 == 250);
+
+	// Set up some distinct values and "reboot" into the same firmware.
+	u8 = 11; i8 = -22; u16 = 3333; i16 = -4444; u32 = 555555; i32 = -666666;
+	u64 = 77777777777ULL; i64 = -88888888888LL; r32 = 9.5f; r64 = -10.25;
+	rudderLimits[0] = -0.4f; rudderLimits[1] = 0.45f;
+	ParameterMarkAllDirty();
+	assert(DataStoreFlush());
+	ClearRam();
+	assert(DataStoreInit() == DATASTORE_INIT_SUCCESS);
+	assert(u8 == 11 && i8 == -22 && u16 == 3333 && i16 == -4444 && u32 == 555555);
+	assert(i32 == -666666 && u64 == 77777777777ULL && i64 == -88888888888LL);
+	assert(r32 == 9.5f && r64 == -10.25 && rudderLimits[0] == -0.4f && rudderLimits[1] == 0.45f);
+
+	// Update to the second firmware. Everything it still has is found by name, the new parameter
+	// keeps its default, and the store is rewritten in the new layout.
+	onboardParameters = paramsV2;
+	ClearRam();
+	newGain = 1.75f;
+	assert(DataStoreInit() == DATASTORE_INIT_MIGRATED);
+	assert(!ParameterAnyDirty());
+	assert(u8 == 11 && i8 == -22 && u16 == 3333 && i16 == -4444 && u32 == 555555);
+	assert(i32 == -666666 && u64 == 0 && i64 == -88888888888LL);
+	assert(r32 == 9.5f && r64 == -10.25 && rudderLimits[0] == -0.4f && rudderLimits[1] == 0.45f);
+	assert(newGain == 1.75f);
+
+	// The next boot finds the new layout, where the new parameter can be flushed in place.
+	ClearRam();
+	assert(DataStoreInit() == DATASTORE_INIT_SUCCESS);
+	assert(u16 == 3333 && newGain == 1.75f && rudderLimits[1] == 0.45f);
+	const float gain = 2.5f;
+	ParameterSetValueByName("NewGain", &gain);
+	DeeHostResetStats();
+	assert(DataStoreFlush());
+	assert(deeHostStats.wordPrograms <= 3);
+
+	// Update to the third firmware. The renamed parameter and the one whose datatype changed keep
+	// their defaults, the reordered ones are still found.
+	onboardParameters = paramsV3;
+	ClearRam();
+	i8 = 5;
+	assert(DataStoreInit() == DATASTORE_INIT_MIGRATED);
+	assert(u8 == 11 && i8 == 5 && i16 == -4444 && u32 == 555555 && newGain == 2.5f);
+	assert(rudderLimits[0] == -0.4f && rudderLimits[1] == 0.45f);
+	ClearRam();
+	assert(DataStoreInit() == DATASTORE_INIT_SUCCESS);
+	assert(u8 == 11 && i8 == 5 && rudderLimits[0] == -0.4f);
+
+	// A store from before the schema hash is loaded by position and stored again in the current
+	// layout. The parameters added since keep their values.
+	static const uint16_t legacy[] = {
+		1,                // Marked as a legacy store.
+		7,                // u8
+		0xFFFF,           // u16
+		0x5678, 0x1234,   // u32 0x12345678
+		0xFFFE, 0xFFFF,   // i32 -2
+		0x0000, 0x3FC0,   // r32 1.5
+		0x0000, 0xBE80,   // RudderMin -0.25
+		0x0000, 0x3E80    // RudderMax 0.25
+	};
+	onboardParameters = paramsLegacy;
+	EraseEeprom();
+	for (i = 0; i < sizeof(legacy) / sizeof(legacy[0]); ++i) {
+		assert(DataEEWrite(legacy[i], i) == 0);
+	}
+	ClearRam();
+	newGain = 3.0f; i8 = -3; u64 = 12;
+	assert(DataStoreInit() == DATASTORE_INIT_MIGRATED);
+	assert(u8 == 7 && u16 == 0xFFFF && u32 == 0x12345678 && i32 == -2 && r32 == 1.5f);
+	assert(rudderLimits[0] == -0.25f && rudderLimits[1] == 0.25f);
+	assert(newGain == 3.0f && i8 == -3 && u64 == 12);
+	ClearRam();
+	assert(DataStoreInit() == DATASTORE_INIT_SUCCESS);
+	assert(u8 == 7 && u32 == 0x12345678 && rudderLimits[1] == 0.25f && newGain == 3.0f && i8 == -3);
+
+	// A renamed parameter isn't mistaken for another whose name hashes to the same lowest bits.
+	onboardParameters = paramsGain71;
+	EraseEeprom();
+	ClearRam();
+	u8 = 21; r32 = 4.5f;
+	assert(DataStoreInit() == DATASTORE_INIT_PRELOADED);
+	onboardParameters = paramsGain95;
+	ClearRam();
+	r32 = 6.5f;
+	assert(DataStoreInit() == DATASTORE_INIT_MIGRATED);
+	assert(u8 == 21 && r32 == 6.5f);
+
+	// Losing power at any point while migrating a store leaves either the old or the new one, never
+	// the defaults. Each update also moves the store to the other end of the EEPROM.
+	int32_t fail;
+	bool powerLost = true;
+	for (fail = 0; powerLost; ++fail) {
+		onboardParameters = paramsV1;
+		EraseEeprom();
+		ClearRam();
+		u16 = 2020; rudderLimits[0] = -0.3f; rudderLimits[1] = 0.35f;
+		assert(DataStoreInit() == DATASTORE_INIT_PRELOADED);
+		onboardParameters = paramsV2;
+		ClearRam();
+		DeeHostFailAfter(fail, DEE_HOST_TEAR_NONE);
+		const enum DATASTORE_INIT result = DataStoreInit();
+		powerLost = DeeHostPowerLost();
+		assert(powerLost || result == DATASTORE_INIT_MIGRATED);
+		DeeHostFailAfter(-1, DEE_HOST_TEAR_NONE);
+		DeeHostPowerOn();
+		dataEEFlags.val = 0;
+		ClearRam();
+		const enum DATASTORE_INIT reboot = DataStoreInit();
+		assert(reboot == DATASTORE_INIT_MIGRATED || reboot == DATASTORE_INIT_SUCCESS);
+		assert(u16 == 2020 && rudderLimits[0] == -0.3f && rudderLimits[1] == 0.35f);
+		onboardParameters = paramsV3;
+		ClearRam();
+		assert(DataStoreInit() == DATASTORE_INIT_MIGRATED);
+		assert(rudderLimits[0] == -0.3f && rudderLimits[1] == 0.35f);
+	}
+	printf("Migration survives losing power at each of its %d flash operations.\n", (int)fail - 1);
+
+	// Start over with the first firmware for the rest of the tests.
+	onboardParameters = paramsV1;
+	EraseEeprom();
+	ClearRam();
+	u8 = 9;
+	assert(DataStoreInit() == DATASTORE_INIT_PRELOADED);
+	assert(u8 == 9);
+
+	// Queued writes are only programmed by DataEETask(). When the queue fills up, saving programs
+	// queued writes to make room, but never erases.
+	DataStoreSetAsync(true);
+	u16 = 1234; u64 = 0x1122334455667788ULL;
+	ParameterMarkDirty(2);
+	ParameterMarkDirty(6);
+	DeeHostResetStats();
+	assert(DataStoreFlush());
+	// The tags didn't change so they're done right away, leaving 5 words to queue.
+	assert(deeHostStats.wordPrograms == 5 - DATA_EE_QUEUE_SIZE && deeHostStats.pageErases == 0);
+	DrainQueue();
+	ClearRam();
+	assert(DataStoreInit() == DATASTORE_INIT_SUCCESS);
+	assert(u16 == 1234 && u64 == 0x1122334455667788ULL);
+
+	// Once DataEETask() needs to erase to make room, saving gives up instead of stalling, leaving
+	// the parameters that weren't queued dirty for the next flush.
+	DataStoreSetAsync(true);
+	DeeHostResetStats();
+	bool flushed = true;
+	for (i = 0; flushed; ++i) {
+		u64 = i;
+		ParameterMarkDirty(6);
+		flushed = DataStoreFlush();
+		while (flushed && DataEETask(0) == DATA_EE_BUSY) {}
+	}
+	assert(deeHostStats.pageErases == 0 && ParameterIsDirty(6));
+	DrainQueue();
+	assert(deeHostStats.pageErases > 0);
+	assert(DataStoreFlush());
+	DrainQueue();
+	ClearRam();
+	assert(DataStoreInit() == DATASTORE_INIT_SUCCESS);
+	assert(u64 == (uint64_t)(i - 1));
+
+	// A queued write that fails has every parameter written again by the next flush.
+	DataStoreSetAsync(true);
+	u16 = 4321;
+	ParameterMarkDirty(2);
+	assert(DataStoreFlush());
+	DeeHostFailAfter(0, DEE_HOST_TEAR_NONE);
+	DrainQueue();
+	DeeHostFailAfter(-1, DEE_HOST_TEAR_NONE);
+	DeeHostPowerOn();
+	assert(ParameterIsDirty(0) && ParameterIsDirty(2));
+	assert(DataStoreFlush());
+	DrainQueue();
+	assert(!ParameterAnyDirty());
+	ClearRam();
+	assert(DataStoreInit() == DATASTORE_INIT_SUCCESS);
+	assert(u16 == 4321);
+	DataStoreSetAsync(false);
+
+	DeeHostClose();
+
+	printf("All tests passed.\n");
+
+	return 0;
+}
+
+#endif // UNIT_TEST_DATA_STORE
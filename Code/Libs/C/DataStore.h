@@ -8,7 +8,6 @@
  * # Dependencies
  *  * DEE library from Microchip (DEE.h, DEE.c, DEE.s)
  *  * Parameter library.
- *  * Packing library.
  *
  * # Usage
  * This DataStore library implements an EEPROM backend for the Parameters library. Any values used
@@ -18,8 +17,42 @@
  * parameter data locations and DataStoreStoreAllParameters() to save the current parameters into
  * the EEPROM. So simple, you won't believe!
  *
- * NOTE: Only the datatypes UINT8, UINT16, UINT32, INT32, and REAL32 have been implemented as of
- * right now!
+ * The stored parameters are prefixed with a hash of the names and datatypes of all parameters, and
+ * each is tagged with a 28-bit hash of its own name and its datatype. When the hash matches the
+ * parameters are loaded in order, otherwise each stored one is matched to a current parameter by
+ * its tag. This way a firmware update that adds, removes, reorders, or renames parameters keeps the
+ * values of all the others, like calibrations, without having to re-save them. Parameters that
+ * aren't found keep their current values. DataStoreInit() then stores everything again in the new
+ * layout. Stores written before the tags were added only hold the values, so they're loaded by
+ * position, which works as long as parameters were only added at the end since.
+ *
+ * The new layout is written to the other end of the EEPROM than the old one and only takes over
+ * once it's complete, so a reset during the migration just has it redone on the next boot. That
+ * needs both to fit side by side. If the parameters take up more than about half of the EEPROM
+ * (DATA_EE_TOTAL_SIZE words), the old store is invalidated and overwritten in place, and a reset
+ * part way through loses every stored value, so the next boot preloads the defaults.
+ *
+ * Every parameter is stored at a fixed offset following from the sizes of the ones before it. The
+ * Parameters library tracks which parameters have changed since they were saved or loaded, so
+ * DataStoreFlush() only writes those, which is much cheaper than DataStoreSaveParameters() when
+ * only a single parameter like a calibration limit changed. As writing stalls the CPU while the
+ * flash is programmed, call DataStoreFlush() at a convenient moment like when the groundstation
+ * asks for the parameters to be stored.
+ *
+ * Nodes that can't afford that stall, like when a calibration finishes while the node is running,
+ * can call DataStoreSetAsync() after DataStoreInit(). Saving then only queues the changed words
+ * with DataEEWriteAsync(), and the node calls DataEETask() every pass of its main loop to program
+ * them one at a time. Allow it to erase flash pages only when a 20ms stall is acceptable. Saving
+ * itself never erases: if the queue is full it programs queued words to make room, and if that
+ * needs an erase it fails, leaving the rest of the changed parameters to the next flush.
+ *
+ * Unit testing has been completed on x86 by compiling with the UNIT_TEST_DATA_STORE macro, which
+ * runs it on the real DEE library against the emulated flash of DEEHost.c. The small write queue
+ * makes the test fill it up.
+ * With gcc: `gcc DataStore.c Parameters.c DEEHost.c DEE.c -DDEE_HOST -DUNIT_TEST_DATA_STORE -DDATA_EE_QUEUE_SIZE=4 -Wall -g -lm`
+ *
+ * All datatypes are supported, though the EEPROM only has room for DATA_EE_TOTAL_SIZE words
+ * including a 4 word header and two tag words for every parameter.
  */
 
 #include <stdbool.h>
@@ -31,7 +64,8 @@
 enum DATASTORE_INIT {
 	DATASTORE_INIT_FAIL = 0, // Failed.
 	DATASTORE_INIT_SUCCESS,  // Succeeded with no qualifiers.
-	DATASTORE_INIT_PRELOADED // Succeeded, but the EEPROM was empty and was preloaded with current parameter data.
+	DATASTORE_INIT_PRELOADED, // Succeeded, but the EEPROM was empty and was preloaded with current parameter data.
+	DATASTORE_INIT_MIGRATED   // Succeeded, but the parameters changed since they were stored so they were matched by name and stored again.
 };
 
 /**
@@ -61,4 +95,21 @@ bool DataStoreSaveParameters(void);
  */
 bool DataStoreLoadParameters(void);
 
+/**
+ * Writes only the parameters that changed since they were last saved or loaded into the EEPROM. If
+ * the EEPROM doesn't hold a complete set of parameters yet, all of them are written.
+ * @return true if all changed parameters were written, false if there was a problem with the EEPROM.
+ */
+bool DataStoreFlush(void);
+
+/**
+ * Selects whether saving queues writes for DataEETask() or programs them right away. While writes
+ * are queued, the EEPROM still holds the previous values so don't load parameters until
+ * DataEETask() is idle. A queued write that fails has everything written again by the next flush.
+ * While writes are queued, DataStoreFlush() and DataStoreSaveParameters() return false if the queue
+ * is full and can't be emptied without erasing, so call them again after DataEETask() has erased.
+ * @param async true to queue writes.
+ */
+void DataStoreSetAsync(bool async);
+
 #endif // DATA_STORE_H
\ No newline at end of file
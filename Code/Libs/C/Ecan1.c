@@ -19,10 +19,15 @@
  */
 
 // Specify the number of 8-byte CAN messages buffer supports.
-// This can be overridden by user code.
+// This can be overridden by user code. Timestamped messages are 4 bytes larger, so the buffers grow
+// by 48 bytes each to still hold 12 of them.
 #ifndef ECAN1_BUFFERSIZE
+#ifdef ECAN1_TIMESTAMPS
+#define ECAN1_BUFFERSIZE 8 * 30
+#else
 #define ECAN1_BUFFERSIZE 8 * 24
 #endif
+#endif
 
 // Declare space for our message buffer in DMA
 // NOTE: This DMA space is aligned along 64-byte boundaries to make sure there's enough room for
@@ -49,6 +54,11 @@ static uint8_t receivedMessagesPending = 0;
 static bool txBufferOverflow = false;
 static bool rxBufferOverflow = false;
 
+#ifdef ECAN1_TIMESTAMPS
+// The clock used to timestamp received messages, if any.
+static uint32_t (*timestampSource)(void) = NULL;
+#endif
+
 void Ecan1Init(uint32_t f_osc, uint32_t f_baud)
 {
     // Initialize our circular buffers. If this fails, we crash and burn.
@@ -277,6 +287,13 @@ void Ecan1GetErrorCounts(uint8_t *txErrors, uint8_t *rxErrors)
     *rxErrors = C1ECbits.RERRCNT;
 }
 
+#ifdef ECAN1_TIMESTAMPS
+void Ecan1SetTimestampSource(uint32_t (*source)(void))
+{
+    timestampSource = source;
+}
+#endif
+
 /**
  * This is an interrupt handler for the ECAN1 peripheral.
  * It clears interrupt bits and pushes received message into
@@ -379,6 +396,11 @@ void _ISR _C1Interrupt(void)
             message.payload[7] = (uint8_t)((ecan_msg_buf_ptr[6] & 0xFF00) >> 8);
         }
 
+#ifdef ECAN1_TIMESTAMPS
+        // Timestamp the message as close to its reception as possible.
+        message.timestamp = timestampSource ? timestampSource() : 0;
+#endif
+
         // Store the message in the buffer and update our messages-in-queue value.
         if (CB_WriteMany(&ecan1RxCBuffer, &message, sizeof (CanMessage), true)) {
             ++receivedMessagesPending;
@@ -72,6 +72,17 @@ EcanStatus Ecan1GetErrorStatus(void);
  */
 void Ecan1GetErrorCounts(uint8_t *txErrors, uint8_t *rxErrors);
 
+#ifdef ECAN1_TIMESTAMPS
+/**
+ * Sets the clock used to fill in the timestamp of every received message. It's called from within
+ * the ECAN1 interrupt, so it needs to be short and interrupt-safe. Without one, all timestamps are 0.
+ * Only available when built with ECAN1_TIMESTAMPS, which costs 96 bytes of RAM for the larger
+ * message buffers.
+ * @param source A function returning the current time, or NULL to disable timestamping.
+ */
+void Ecan1SetTimestampSource(uint32_t (*source)(void));
+#endif
+
 /**
  * This function provides a general way to initialize the DMA peripheral.
  *
@@ -25,6 +25,9 @@ typedef struct {
 	uint8_t  frame_type;   // The frame type. See can_frame_type.
 	uint8_t  payload[8];   // The message payload. Stores between 0 and 8 bytes of data.
 	uint8_t  validBytes;   // Indicates how many bytes are valid within payload.
+#ifdef ECAN1_TIMESTAMPS
+	uint32_t timestamp;    // When this message was received. See Ecan1SetTimestampSource().
+#endif
 } CanMessage;
 
 typedef union {
@@ -0,0 +1,892 @@
+/**
+ * @file
+ * @brief Implements the rolling flash log declared in FlashLog.h.
+ *
+ * Every sector starts with a header:
+ *  * word 0: FLASH_LOG_MAGIC
+ *  * word 1: The ID of the log this sector belongs to.
+ *  * word 2: A sequence number incremented for every sector written, used to order the ring.
+ *  * word 3: Reserved.
+ * This is followed by records, each of which is a length word followed by the data, padded to a
+ * full word. An erased length word (0xFFFF) marks the end of the data in a sector. The length word
+ * of a record is programmed last, so an interrupted write leaves behind garbage after the end
+ * marker, which is detected on initialization.
+ *
+ * As a log can reuse its own sectors, the ring isn't kept in physical order. Instead the sectors
+ * are ordered by their sequence numbers in RAM.
+ */
+#include "FlashLog.h"
+
+#include <stddef.h>
+
+#define FLASH_LOG_MAGIC 0x4C47 // "GL" in little-endian
+
+#define HEADER_MAGIC_OFFSET 0
+#define HEADER_LOG_ID_OFFSET 2
+#define HEADER_SEQUENCE_OFFSET 4
+#define HEADER_SIZE 8
+
+#define ERASED_WORD 0xFFFF
+
+// The size a record takes up in flash given its data size.
+#define RECORD_FLASH_SIZE(size) (2 + (((size) + 1) & ~1))
+
+/**
+ * The RAM copy of what's stored in each sector.
+ */
+typedef struct {
+    bool valid;            // Whether the sector contains a valid header.
+    uint16_t logId;
+    uint16_t sequence;
+    uint16_t writeOffset;  // Where the next record should go. FLASH_LOG_SECTOR_SIZE if the sector is full.
+    uint16_t dataSize;     // The total size of all record data in this sector.
+} SectorInfo;
+
+static SectorInfo sectors[FLASH_LOG_SECTORS];
+
+// The sectors in the order they were started, oldest first. Sectors without a valid header come
+// first, as they're the first to be reused.
+static uint8_t ringOrder[FLASH_LOG_SECTORS];
+
+// The most recently-started sector, which is where the ring ends. -1 if the flash is empty.
+static int8_t newestSector;
+
+// The sector being written to by the current log. -1 if nothing has been written yet.
+static int8_t currentSector;
+
+// The ID of the log started during this boot.
+static uint16_t currentLogId;
+
+// The ID of the log of the previous boot, if there is one. Its newest sectors are kept.
+static bool hasPreviousLog;
+static uint16_t previousLogId;
+
+// The sequence number to use for the next sector.
+static uint16_t nextSequence;
+
+// Incremented every time the ring layout changes, which invalidates the read cursor.
+static uint16_t ringGeneration;
+
+// The sectors that FlashLogEraseAll() dropped but FlashLogTask() hasn't erased yet, one bit each.
+static uint16_t pendingErases;
+
+// The sectors known to be fully erased, one bit each. These can be started without an erase.
+static uint16_t erasedSectors;
+
+static bool paused;
+static uint16_t dropped;
+
+/**
+ * The records waiting for FlashLogTask(), each stored as its size in 2 bytes followed by its data.
+ * Records wrap around the end of the buffer.
+ */
+static struct {
+    uint8_t data[FLASH_LOG_QUEUE_SIZE];
+    uint16_t head;        // The start of the oldest record.
+    uint16_t length;      // The number of bytes used.
+    bool programming;     // Whether the oldest record is partly programmed.
+    uint16_t recordPos;   // How many bytes of the oldest record's data have been programmed.
+} queue;
+
+/**
+ * Caches where the last FlashLogRead() stopped so that reading sequentially doesn't require
+ * re-scanning the log from the start every call.
+ */
+static struct {
+    bool valid;
+    uint16_t generation;
+    uint16_t logId;
+    uint32_t logOffset;     // The offset into the log this position corresponds to.
+    uint8_t ringIndex;      // The sector as an index into the ring, with 0 being the oldest.
+    uint16_t recordOffset;  // The offset of the current record's length word.
+    uint16_t recordPos;     // How far into the current record's data.
+} readCursor;
+
+/**
+ * Converts an index into the ring, where 0 is the oldest sector, into a sector number.
+ */
+static uint8_t RingToSector(uint8_t ringIndex)
+{
+    return ringOrder[ringIndex];
+}
+
+/**
+ * Moves a sector to the newest end of the ring.
+ */
+static void MoveToNewest(uint8_t sector)
+{
+    uint8_t i;
+    for (i = 0; ringOrder[i] != sector; ++i);
+    for (; i < FLASH_LOG_SECTORS - 1; ++i) {
+        ringOrder[i] = ringOrder[i + 1];
+    }
+    ringOrder[FLASH_LOG_SECTORS - 1] = sector;
+}
+
+/**
+ * Reads an arbitrary range of bytes out of a sector.
+ */
+static void ReadBytes(uint8_t sector, uint16_t offset, uint8_t *data, uint16_t size)
+{
+    // Handle an unaligned start.
+    if (size && (offset & 1)) {
+        *data++ = (uint8_t)(FlashLogBackendRead(sector, offset - 1) >> 8);
+        ++offset;
+        --size;
+    }
+    while (size >= 2) {
+        const uint16_t word = FlashLogBackendRead(sector, offset);
+        *data++ = (uint8_t)word;
+        *data++ = (uint8_t)(word >> 8);
+        offset += 2;
+        size -= 2;
+    }
+    if (size) {
+        *data = (uint8_t)FlashLogBackendRead(sector, offset);
+    }
+}
+
+/**
+ * Rebuilds the RAM information for a single sector by scanning its contents.
+ */
+static void ScanSector(uint8_t sector)
+{
+    SectorInfo *s = &sectors[sector];
+
+    s->valid = (FlashLogBackendRead(sector, HEADER_MAGIC_OFFSET) == FLASH_LOG_MAGIC);
+    if (!s->valid) {
+        // Remember whether the sector is blank, so it can be used without erasing it first.
+        uint16_t offset;
+        for (offset = 0; offset < FLASH_LOG_SECTOR_SIZE; offset += 2) {
+            if (FlashLogBackendRead(sector, offset) != ERASED_WORD) {
+                return;
+            }
+        }
+        erasedSectors |= 1u << sector;
+        return;
+    }
+    s->logId = FlashLogBackendRead(sector, HEADER_LOG_ID_OFFSET);
+    s->sequence = FlashLogBackendRead(sector, HEADER_SEQUENCE_OFFSET);
+    s->dataSize = 0;
+
+    // Walk the records until the end marker is found.
+    uint16_t offset = HEADER_SIZE;
+    while (offset < FLASH_LOG_SECTOR_SIZE) {
+        const uint16_t size = FlashLogBackendRead(sector, offset);
+        if (size == ERASED_WORD) {
+            break;
+        }
+        // A corrupt length means we can't trust anything after it, so just close the sector.
+        if (size == 0 || size > FLASH_LOG_MAX_RECORD ||
+            offset + RECORD_FLASH_SIZE(size) > FLASH_LOG_SECTOR_SIZE) {
+            s->writeOffset = FLASH_LOG_SECTOR_SIZE;
+            return;
+        }
+        s->dataSize += size;
+        offset += RECORD_FLASH_SIZE(size);
+    }
+    s->writeOffset = offset;
+
+    // Make sure the rest of the sector is still erased. If it isn't a write was interrupted and
+    // it's not safe to program anything else here.
+    for (; offset < FLASH_LOG_SECTOR_SIZE; offset += 2) {
+        if (FlashLogBackendRead(sector, offset) != ERASED_WORD) {
+            s->writeOffset = FLASH_LOG_SECTOR_SIZE;
+            return;
+        }
+    }
+}
+
+/**
+ * Picks the sector for the next part of the current log: an erased one if there is one. Otherwise the
+ * oldest one, unless that would eat into the log of the previous boot after the current log already
+ * has half of the ring. Then the current log reuses its own oldest sector.
+ */
+static uint8_t NextSector(void)
+{
+    uint8_t i;
+    for (i = 0; i < FLASH_LOG_SECTORS && erasedSectors; ++i) {
+        if (erasedSectors & (1u << ringOrder[i])) {
+            return ringOrder[i];
+        }
+    }
+
+    const SectorInfo *oldest = &sectors[ringOrder[0]];
+    if (hasPreviousLog && oldest->valid && oldest->logId == previousLogId) {
+        uint8_t ownSectors = 0;
+        uint8_t ownOldest = FLASH_LOG_SECTORS;
+        for (i = 0; i < FLASH_LOG_SECTORS; ++i) {
+            const SectorInfo *s = &sectors[ringOrder[i]];
+            if (s->valid && s->logId == currentLogId) {
+                if (ownOldest == FLASH_LOG_SECTORS) {
+                    ownOldest = ringOrder[i];
+                }
+                ++ownSectors;
+            }
+        }
+        if (ownSectors >= FLASH_LOG_SECTORS / 2) {
+            return ownOldest;
+        }
+    }
+    return ringOrder[0];
+}
+
+/**
+ * Erases a sector and drops whatever it held, leaving it ready for StartNewSector().
+ */
+static void EraseSector(uint8_t sector)
+{
+    FlashLogBackendErase(sector);
+    pendingErases &= ~(1u << sector);
+    erasedSectors |= 1u << sector;
+    if (sectors[sector].valid) {
+        sectors[sector].valid = false;
+        ++ringGeneration;
+    }
+}
+
+/**
+ * Starts using the next sector for the current log, erasing it first unless it's already erased.
+ * @return False if the header couldn't be written.
+ */
+static bool StartNewSector(void)
+{
+    const uint8_t sector = NextSector();
+    SectorInfo *s = &sectors[sector];
+
+    if (!(erasedSectors & (1u << sector))) {
+        EraseSector(sector);
+    }
+    erasedSectors &= ~(1u << sector);
+    s->valid = false;
+    MoveToNewest(sector);
+    newestSector = sector;
+    currentSector = sector;
+    ++ringGeneration;
+
+    // Program the magic number last so that a partially-written header is never considered valid.
+    if (!FlashLogBackendProgram(sector, HEADER_LOG_ID_OFFSET, currentLogId) ||
+        !FlashLogBackendProgram(sector, HEADER_SEQUENCE_OFFSET, nextSequence) ||
+        !FlashLogBackendProgram(sector, HEADER_MAGIC_OFFSET, FLASH_LOG_MAGIC)) {
+        return false;
+    }
+
+    s->valid = true;
+    s->logId = currentLogId;
+    s->sequence = nextSequence++;
+    s->writeOffset = HEADER_SIZE;
+    s->dataSize = 0;
+    return true;
+}
+
+void FlashLogInit(void)
+{
+    FlashLogBackendInit();
+
+    newestSector = -1;
+    currentSector = -1;
+    readCursor.valid = false;
+    pendingErases = 0;
+    erasedSectors = 0;
+    paused = false;
+    dropped = 0;
+    queue.head = 0;
+    queue.length = 0;
+    queue.programming = false;
+
+    uint8_t i;
+    for (i = 0; i < FLASH_LOG_SECTORS; ++i) {
+        ScanSector(i);
+        if (sectors[i].valid) {
+            // Use serial number arithmetic so that the sequence number can wrap.
+            if (newestSector < 0 ||
+                (int16_t)(sectors[i].sequence - sectors[newestSector].sequence) > 0) {
+                newestSector = i;
+            }
+        }
+    }
+
+    // Order the ring by how long ago each sector was started, with invalid sectors first.
+    uint8_t count = 0;
+    for (i = 0; i < FLASH_LOG_SECTORS; ++i) {
+        if (!sectors[i].valid) {
+            ringOrder[count++] = i;
+        }
+    }
+    const uint8_t invalidCount = count;
+    for (i = 0; i < FLASH_LOG_SECTORS; ++i) {
+        if (!sectors[i].valid) {
+            continue;
+        }
+        const uint16_t age = sectors[newestSector].sequence - sectors[i].sequence;
+        uint8_t j = count++;
+        while (j > invalidCount &&
+               (uint16_t)(sectors[newestSector].sequence - sectors[ringOrder[j - 1]].sequence) < age) {
+            ringOrder[j] = ringOrder[j - 1];
+            --j;
+        }
+        ringOrder[j] = i;
+    }
+
+    // Start a new log after the newest one.
+    if (newestSector >= 0) {
+        hasPreviousLog = true;
+        previousLogId = sectors[newestSector].logId;
+        currentLogId = previousLogId + 1;
+        nextSequence = sectors[newestSector].sequence + 1;
+    } else {
+        hasPreviousLog = false;
+        currentLogId = 1;
+        nextSequence = 0;
+    }
+    ++ringGeneration;
+}
+
+/**
+ * Copies bytes out of the queue, starting at the given offset from its head.
+ */
+static void QueuePeek(uint16_t offset, uint8_t *data, uint16_t size)
+{
+    uint16_t index = (queue.head + offset) % FLASH_LOG_QUEUE_SIZE;
+    while (size--) {
+        *data++ = queue.data[index];
+        if (++index == FLASH_LOG_QUEUE_SIZE) {
+            index = 0;
+        }
+    }
+}
+
+/**
+ * Removes the oldest record from the queue.
+ */
+static void QueuePop(uint16_t size)
+{
+    queue.head = (queue.head + 2 + size) % FLASH_LOG_QUEUE_SIZE;
+    queue.length -= 2 + size;
+    queue.programming = false;
+}
+
+bool FlashLogWrite(const uint8_t *data, uint16_t size)
+{
+    if (!data || size == 0 || size > FLASH_LOG_MAX_RECORD) {
+        return false;
+    }
+    if (paused || queue.length + 2 + size > FLASH_LOG_QUEUE_SIZE) {
+        if (dropped < UINT16_MAX) {
+            ++dropped;
+        }
+        return false;
+    }
+
+    uint16_t index = (queue.head + queue.length) % FLASH_LOG_QUEUE_SIZE;
+    uint16_t i;
+    for (i = 0; i < 2 + size; ++i) {
+        queue.data[index] = (i == 0) ? (uint8_t)size : (i == 1) ? (uint8_t)(size >> 8) : data[i - 2];
+        if (++index == FLASH_LOG_QUEUE_SIZE) {
+            index = 0;
+        }
+    }
+    queue.length += 2 + size;
+    return true;
+}
+
+bool FlashLogTask(bool allowErase)
+{
+    allowErase = allowErase && !paused;
+
+    // Erase what FlashLogEraseAll() dropped first, one sector per call as each one stalls.
+    if (pendingErases) {
+        if (allowErase) {
+            uint8_t sector;
+            for (sector = 0; !(pendingErases & (1u << sector)); ++sector);
+            EraseSector(sector);
+        }
+        return true;
+    }
+
+    if (queue.length == 0) {
+        // Use idle time to erase the sector the log moves onto next, so that it can keep logging
+        // through a stretch where erasing isn't allowed.
+        if (allowErase && currentSector >= 0 && !erasedSectors) {
+            const uint8_t sector = NextSector();
+            if (sector != currentSector) {
+                EraseSector(sector);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    uint8_t sizeBytes[2];
+    QueuePeek(0, sizeBytes, 2);
+    const uint16_t size = sizeBytes[0] | ((uint16_t)sizeBytes[1] << 8);
+
+    // Move onto a new sector if this is the first write of this log or the record doesn't fit. If
+    // there's no erased sector and erasing isn't allowed the records wait in the queue, and once
+    // that's full logging stops until a call allows the erase. Either way programming waits for the
+    // next call.
+    if (!queue.programming) {
+        if (currentSector < 0 ||
+            sectors[currentSector].writeOffset + RECORD_FLASH_SIZE(size) > FLASH_LOG_SECTOR_SIZE) {
+            if (!allowErase && !(erasedSectors & (1u << NextSector()))) {
+                return true;
+            }
+            if (!StartNewSector()) {
+                QueuePop(size);
+            }
+            return true;
+        }
+        queue.programming = true;
+        queue.recordPos = 0;
+    }
+
+    // Program the data first and then the length.
+    SectorInfo *s = &sectors[currentSector];
+    const uint16_t recordOffset = s->writeOffset;
+    uint8_t words;
+    for (words = 0; words < FLASH_LOG_TASK_WORDS && queue.recordPos < size; ++words) {
+        uint8_t bytes[2] = {0xFF, 0xFF};
+        QueuePeek(2 + queue.recordPos, bytes, (queue.recordPos + 1 < size) ? 2 : 1);
+        const uint16_t word = bytes[0] | ((uint16_t)bytes[1] << 8);
+        if (!FlashLogBackendProgram(currentSector, recordOffset + 2 + queue.recordPos, word)) {
+            s->writeOffset = FLASH_LOG_SECTOR_SIZE;
+            QueuePop(size);
+            return queue.length > 0;
+        }
+        queue.recordPos += 2;
+    }
+    if (queue.recordPos < size) {
+        return true;
+    }
+    if (!FlashLogBackendProgram(currentSector, recordOffset, size)) {
+        s->writeOffset = FLASH_LOG_SECTOR_SIZE;
+    } else {
+        s->writeOffset += RECORD_FLASH_SIZE(size);
+        s->dataSize += size;
+    }
+    QueuePop(size);
+    return queue.length > 0;
+}
+
+void FlashLogSetPaused(bool pause)
+{
+    paused = pause;
+}
+
+uint16_t FlashLogGetDropped(void)
+{
+    return dropped;
+}
+
+uint8_t FlashLogGetLogCount(void)
+{
+    uint8_t count = 0;
+    int32_t lastId = -1;
+    uint8_t i;
+    for (i = 0; i < FLASH_LOG_SECTORS && newestSector >= 0; ++i) {
+        const SectorInfo *s = &sectors[RingToSector(i)];
+        if (s->valid && s->logId != lastId) {
+            lastId = s->logId;
+            ++count;
+        }
+    }
+    return count;
+}
+
+bool FlashLogGetLogInfo(uint8_t index, uint16_t *id, uint32_t *size)
+{
+    int16_t logIndex = -1;
+    int32_t lastId = -1;
+    uint32_t logSize = 0;
+    uint8_t i;
+    for (i = 0; i < FLASH_LOG_SECTORS && newestSector >= 0; ++i) {
+        const SectorInfo *s = &sectors[RingToSector(i)];
+        if (!s->valid) {
+            continue;
+        }
+        if (s->logId != lastId) {
+            // We've finished the requested log.
+            if (logIndex == index) {
+                break;
+            }
+            lastId = s->logId;
+            logSize = 0;
+            ++logIndex;
+        }
+        logSize += s->dataSize;
+    }
+
+    if (logIndex != index) {
+        return false;
+    }
+    if (id) {
+        *id = (uint16_t)lastId;
+    }
+    if (size) {
+        *size = logSize;
+    }
+    return true;
+}
+
+/**
+ * Positions the read cursor at the given offset into the given log.
+ * @return False if the offset is past the end of the log.
+ */
+static bool SeekReadCursor(uint16_t id, uint32_t offset)
+{
+    // Reuse the current position if we can.
+    if (readCursor.valid && readCursor.generation == ringGeneration &&
+        readCursor.logId == id && readCursor.logOffset == offset) {
+        return true;
+    }
+
+    readCursor.valid = false;
+    if (newestSector < 0) {
+        return false;
+    }
+
+    // First skip whole sectors.
+    uint32_t remaining = offset;
+    uint8_t i;
+    for (i = 0; i < FLASH_LOG_SECTORS; ++i) {
+        const SectorInfo *s = &sectors[RingToSector(i)];
+        if (!s->valid || s->logId != id) {
+            continue;
+        }
+        if (remaining < s->dataSize) {
+            break;
+        }
+        remaining -= s->dataSize;
+    }
+    if (i == FLASH_LOG_SECTORS) {
+        return false;
+    }
+
+    // Then skip whole records within the sector.
+    const uint8_t sector = RingToSector(i);
+    uint16_t recordOffset = HEADER_SIZE;
+    for (;;) {
+        const uint16_t size = FlashLogBackendRead(sector, recordOffset);
+        if (remaining < size) {
+            break;
+        }
+        remaining -= size;
+        recordOffset += RECORD_FLASH_SIZE(size);
+    }
+
+    readCursor.valid = true;
+    readCursor.generation = ringGeneration;
+    readCursor.logId = id;
+    readCursor.logOffset = offset;
+    readCursor.ringIndex = i;
+    readCursor.recordOffset = recordOffset;
+    readCursor.recordPos = (uint16_t)remaining;
+    return true;
+}
+
+uint16_t FlashLogRead(uint16_t id, uint32_t offset, uint8_t *data, uint16_t size)
+{
+    if (!data || !SeekReadCursor(id, offset)) {
+        return 0;
+    }
+
+    uint16_t read = 0;
+    while (read < size) {
+        const uint8_t sector = RingToSector(readCursor.ringIndex);
+        const SectorInfo *s = &sectors[sector];
+
+        // At the end of the data in this sector, move onto the next sector in this log.
+        if (readCursor.recordOffset >= s->writeOffset ||
+            FlashLogBackendRead(sector, readCursor.recordOffset) == ERASED_WORD) {
+            uint8_t i;
+            for (i = readCursor.ringIndex + 1; i < FLASH_LOG_SECTORS; ++i) {
+                const SectorInfo *next = &sectors[RingToSector(i)];
+                if (next->valid && next->logId == id) {
+                    break;
+                }
+            }
+            if (i == FLASH_LOG_SECTORS) {
+                break;
+            }
+            readCursor.ringIndex = i;
+            readCursor.recordOffset = HEADER_SIZE;
+            readCursor.recordPos = 0;
+            continue;
+        }
+
+        // Copy as much of this record as we can.
+        const uint16_t recordSize = FlashLogBackendRead(sector, readCursor.recordOffset);
+        uint16_t n = recordSize - readCursor.recordPos;
+        if (n > size - read) {
+            n = size - read;
+        }
+        ReadBytes(sector, readCursor.recordOffset + 2 + readCursor.recordPos, &data[read], n);
+        read += n;
+        readCursor.recordPos += n;
+        if (readCursor.recordPos == recordSize) {
+            readCursor.recordOffset += RECORD_FLASH_SIZE(recordSize);
+            readCursor.recordPos = 0;
+        }
+    }
+
+    readCursor.logOffset += read;
+    return read;
+}
+
+void FlashLogEraseAll(void)
+{
+    uint8_t i;
+    for (i = 0; i < FLASH_LOG_SECTORS; ++i) {
+        if (sectors[i].valid) {
+            pendingErases |= 1u << i;
+        }
+        sectors[i].valid = false;
+    }
+    newestSector = -1;
+    currentSector = -1;
+    hasPreviousLog = false;
+    readCursor.valid = false;
+    ++ringGeneration;
+
+    // A partly-programmed record can't be finished in an erased sector, so start it again.
+    queue.programming = false;
+}
+
+#ifdef UNIT_TEST_FLASH_LOG
+
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+
+// Declared in FlashLogHost.c
+extern uint32_t flashLogHostEraseCount;
+extern bool flashLogHostFailAfter(int32_t programs);
+
+/**
+ * Runs FlashLogTask() until everything queued has been programmed.
+ */
+static void Drain(void)
+{
+    while (FlashLogTask(true));
+}
+
+/**
+ * Queues a record and programs it.
+ */
+static bool WriteNow(const uint8_t *data, uint16_t size)
+{
+    const bool queued = FlashLogWrite(data, size);
+    Drain();
+    return queued;
+}
+
+int main()
+{
+    printf("Testing FlashLog.c. All errors will be reported as failed assertions.\n");
+
+    uint8_t record[FLASH_LOG_MAX_RECORD];
+    uint8_t out[600];
+    uint16_t id;
+    uint32_t size;
+    uint16_t i;
+    for (i = 0; i < sizeof(record); ++i) {
+        record[i] = (uint8_t)i;
+    }
+
+    // Start with blank flash.
+    FlashLogInit();
+    FlashLogEraseAll();
+    Drain();
+    assert(FlashLogGetLogCount() == 0);
+    assert(!FlashLogGetLogInfo(0, &id, &size));
+
+    // Invalid records are rejected.
+    assert(!FlashLogWrite(record, 0));
+    assert(!FlashLogWrite(record, FLASH_LOG_MAX_RECORD + 1));
+
+    // Records are only programmed by the task. Erased sectors are used without erasing them again,
+    // so this works even without allowing erases.
+    assert(FlashLogWrite(record, 5));
+    assert(FlashLogWrite(&record[5], 10));
+    assert(FlashLogGetLogCount() == 0);
+    uint32_t erases = flashLogHostEraseCount;
+    while (FlashLogTask(false));
+    assert(flashLogHostEraseCount == erases);
+
+    // Odd- and even-sized records read back.
+    assert(FlashLogGetLogCount() == 1);
+    assert(FlashLogGetLogInfo(0, &id, &size));
+    assert(size == 15);
+    assert(FlashLogRead(id, 0, out, sizeof(out)) == 15);
+    assert(memcmp(out, record, 15) == 0);
+    assert(FlashLogRead(id, 3, out, 4) == 4);
+    assert(memcmp(out, &record[3], 4) == 0);
+    assert(FlashLogRead(id, 15, out, 4) == 0);
+    assert(FlashLogRead(id + 1, 0, out, 4) == 0);
+
+    // Records that don't fit into the queue are dropped.
+    assert(FlashLogGetDropped() == 0);
+    for (i = 0; FlashLogWrite(record, 200); ++i);
+    assert(i == FLASH_LOG_QUEUE_SIZE / 202);
+    assert(FlashLogGetDropped() == 1);
+    Drain();
+    assert(FlashLogGetLogInfo(0, &id, &size));
+    assert(size == 15 + i * 200);
+
+    // "Reboot" and check that the index is rebuilt and a new log is started.
+    const uint16_t firstId = id;
+    FlashLogInit();
+    assert(FlashLogGetLogCount() == 1);
+    assert(WriteNow(record, 100));
+    assert(FlashLogGetLogCount() == 2);
+    assert(FlashLogGetLogInfo(1, &id, &size));
+    assert(id == firstId + 1);
+    assert(size == 100);
+
+    // Fill enough data to span multiple sectors and read it back sequentially in odd-sized chunks.
+    uint32_t written = 100;
+    while (written < 3 * FLASH_LOG_SECTOR_SIZE) {
+        assert(WriteNow(record, 200));
+        written += 200;
+    }
+    assert(FlashLogGetLogInfo(1, &id, &size));
+    assert(size == written);
+    uint32_t offset = 0;
+    uint16_t n;
+    while ((n = FlashLogRead(id, offset, out, 90)) > 0) {
+        for (i = 0; i < n; ++i) {
+            const uint32_t pos = offset + i;
+            const uint8_t expected = (pos < 100) ? (uint8_t)pos : (uint8_t)((pos - 100) % 200);
+            assert(out[i] == expected);
+        }
+        offset += n;
+    }
+    assert(offset == written);
+
+    // Random access in the middle of the log should work too.
+    assert(FlashLogRead(id, 1100, out, 10) == 10);
+    assert(out[0] == (uint8_t)((1100 - 100) % 200));
+
+    // Overfill the ring. The first log is the previous boot's, so the current one wraps around onto
+    // itself once it has half of the ring, and both remain.
+    for (i = 0; i < FLASH_LOG_SECTORS * FLASH_LOG_SECTOR_SIZE / 200; ++i) {
+        assert(WriteNow(record, 200));
+    }
+    assert(FlashLogGetLogCount() == 2);
+    assert(FlashLogGetLogInfo(0, &id, &size));
+    assert(id == firstId);
+    assert(FlashLogGetLogInfo(1, &id, &size));
+    assert(id == firstId + 1);
+    assert(size > (FLASH_LOG_SECTORS - 2) * (FLASH_LOG_SECTOR_SIZE - 200));
+
+    // After a reboot, the older logs are overwritten first. Then the next log only takes half of
+    // the ring and wraps around onto itself, so the end of the previous log is kept.
+    const uint16_t previousId = id;
+    FlashLogInit();
+    for (i = 0; i < 2 * FLASH_LOG_SECTORS * FLASH_LOG_SECTOR_SIZE / 200; ++i) {
+        record[0] = (uint8_t)i;
+        assert(WriteNow(record, 200));
+    }
+    assert(FlashLogGetLogCount() == 2);
+    assert(FlashLogGetLogInfo(0, &id, &size));
+    assert(id == previousId);
+    assert(size > (FLASH_LOG_SECTORS / 2) * (FLASH_LOG_SECTOR_SIZE - 200) - 200);
+    assert(FlashLogRead(id, size - 200, out, 200) == 200);
+    assert(memcmp(&out[1], &record[1], 199) == 0);
+    assert(FlashLogGetLogInfo(1, &id, &size));
+    assert(id == previousId + 1);
+    assert(size > (FLASH_LOG_SECTORS / 2 - 1) * (FLASH_LOG_SECTOR_SIZE - 200));
+    assert(FlashLogRead(id, size - 200, out, 200) == 200);
+    assert(out[0] == record[0]);
+    record[0] = 0;
+
+    // A reader can't be pulled out from under while paused: writes are dropped and nothing is
+    // erased, but what was already queued is still programmed into the current sector.
+    FlashLogInit();
+    assert(FlashLogWrite(record, 20));
+    FlashLogSetPaused(true);
+    const uint16_t droppedBefore = FlashLogGetDropped();
+    assert(!FlashLogWrite(record, 20));
+    assert(FlashLogGetDropped() == droppedBefore + 1);
+    erases = flashLogHostEraseCount;
+    for (i = 0; i < 10; ++i) {
+        FlashLogTask(true);
+    }
+    assert(flashLogHostEraseCount == erases);
+    FlashLogSetPaused(false);
+    Drain();
+    assert(flashLogHostEraseCount == erases + 1);
+    assert(FlashLogGetLogCount() == 3);
+
+    // Simulate a reset in the middle of a record. That record should be dropped, but the log
+    // should otherwise be intact and logging should continue in a new log.
+    assert(FlashLogGetLogInfo(2, &id, &size));
+    const uint32_t sizeBeforeFailure = size;
+    flashLogHostFailAfter(3);
+    assert(WriteNow(record, 50));
+    flashLogHostFailAfter(-1);
+    FlashLogInit();
+    assert(FlashLogGetLogInfo(2, &id, &size));
+    assert(size == sizeBeforeFailure);
+    assert(WriteNow(record, 50));
+    assert(FlashLogGetLogCount() == 4);
+
+    // Once no sector is erased, moving onto a new sector waits for a call that allows erasing and
+    // logging stops when the queue is full. Nothing is lost from what was queued.
+    assert(FlashLogGetLogInfo(FlashLogGetLogCount() - 1, &id, &size));
+    const uint32_t sizeBeforeStop = size;
+    erases = flashLogHostEraseCount;
+    uint16_t queued;
+    for (queued = 0; queued < FLASH_LOG_SECTOR_SIZE / 200 + FLASH_LOG_QUEUE_SIZE / 202; ++queued) {
+        if (!FlashLogWrite(record, 200)) {
+            break;
+        }
+        for (i = 0; i < 100; ++i) {
+            FlashLogTask(false);
+        }
+    }
+    assert(queued < FLASH_LOG_SECTOR_SIZE / 200 + FLASH_LOG_QUEUE_SIZE / 202);
+    assert(flashLogHostEraseCount == erases);
+    assert(FlashLogTask(false));
+    Drain();
+    assert(flashLogHostEraseCount > erases);
+    assert(FlashLogGetLogInfo(FlashLogGetLogCount() - 1, &id, &size));
+    assert(size == sizeBeforeStop + (uint32_t)queued * 200);
+
+    // The idle calls that allow erasing erase the next sector ahead of time, so after those the log
+    // moves onto it without erasing.
+    erases = flashLogHostEraseCount;
+    Drain();
+    assert(flashLogHostEraseCount == erases + 1);
+    assert(!FlashLogTask(true));
+    erases = flashLogHostEraseCount;
+    for (i = 0; i < FLASH_LOG_SECTOR_SIZE / 200; ++i) {
+        assert(FlashLogWrite(record, 200));
+        uint16_t j;
+        for (j = 0; j < 100; ++j) {
+            FlashLogTask(false);
+        }
+    }
+    assert(!FlashLogTask(false));
+    assert(flashLogHostEraseCount == erases);
+    assert(FlashLogGetLogInfo(FlashLogGetLogCount() - 1, &id, &size));
+    assert(size == sizeBeforeStop + (uint32_t)(queued + i) * 200);
+
+    // Erasing everything should leave no logs right away, with the sectors erased later.
+    erases = flashLogHostEraseCount;
+    FlashLogEraseAll();
+    assert(FlashLogGetLogCount() == 0);
+    assert(flashLogHostEraseCount == erases);
+    assert(FlashLogTask(false));
+    assert(flashLogHostEraseCount == erases);
+    Drain();
+    assert(flashLogHostEraseCount > erases);
+    FlashLogInit();
+    assert(FlashLogGetLogCount() == 0);
+
+    printf("All tests passed.\n");
+
+    return 0;
+}
+
+#endif // UNIT_TEST_FLASH_LOG
@@ -0,0 +1,173 @@
+#ifndef FLASH_LOG_H
+#define FLASH_LOG_H
+
+/**
+ * @file
+ * @brief A rolling binary log stored in flash memory.
+ *
+ * # Dependencies
+ *  * A flash backend implementing the FlashLogBackend*() functions below. FlashLogPic.c uses spare
+ *    program flash on the dsPIC (and relies on the DEE library for the flash primitives), while
+ *    FlashLogHost.c emulates NOR flash in RAM for testing on a PC.
+ *
+ * # Usage
+ * The flash is split into FLASH_LOG_SECTORS sectors that are used as a ring. Each boot of the
+ * system starts a new log, and every log occupies one or more sectors. Once the ring is full the
+ * oldest sector is erased and reused, so the oldest log is slowly eaten away while the newest is
+ * always complete. The log of the previous boot, which is the one usually wanted after a run, is
+ * only eaten away until the current log has half of the ring. After that the current log reuses
+ * its own oldest sectors, so the end of the previous run is kept for the whole boot.
+ *
+ * Call FlashLogInit() once at startup, which scans the flash to rebuild the log index in RAM. Then
+ * call FlashLogWrite() with every record that should be logged, like a summary of the MAVLink
+ * messages sent to the datalogger. The log contents are the concatenation of every record, so
+ * downloading a log of MAVLink messages results in a normal MAVLink stream.
+ *
+ * Programming the internal flash stalls the CPU, for ~50us per word on the dsPIC and ~20ms for a
+ * sector erase. So FlashLogWrite() only queues the record in RAM, and FlashLogTask() programs the
+ * queue FLASH_LOG_TASK_WORDS words at a time. Call it every pass of the main loop.
+ *
+ * No interrupt runs during an erase, so its effects go beyond the main loop. From the datasheet
+ * erase time, not measured on hardware:
+ *  * A 100Hz control loop misses two iterations, as the 20ms stall covers two of its periods.
+ *  * Every UART receiving at 115200 baud overruns its 4-byte FIFO, as ~230 bytes arrive during the
+ *    stall. The UART stops receiving until the overrun is cleared, so those bytes are lost.
+ * At ~50B/s into 1-2KB sectors that's every 20-40s, so only allow FlashLogTask() to erase while
+ * the system is idle or those losses don't matter, like in manual mode. When it's allowed while
+ * there's nothing to program it erases the next sector ahead of time, so logging continues into a
+ * stretch where erasing isn't allowed until that sector is full. Then records wait in the queue
+ * and, once that's full, are dropped until erasing is allowed again. The sector erases requested
+ * by FlashLogEraseAll() are deferred to FlashLogTask() the same way. Each erase also wears the
+ * flash, which endures ~10k erases per sector, so keep the logged stream to tens of bytes per
+ * second.
+ *
+ * Logs are listed with FlashLogGetLogCount()/FlashLogGetLogInfo() and read back with
+ * FlashLogRead(). Reading sequentially through a log is O(1) per call. Pause logging with
+ * FlashLogSetPaused() while a log is being read, so no sector is erased under the reader.
+ *
+ * Unit testing has been completed on x86 by compiling with the UNIT_TEST_FLASH_LOG macro.
+ * With gcc: `gcc FlashLog.c FlashLogHost.c -DUNIT_TEST_FLASH_LOG -Wall -g`
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * The size of a single erasable sector in bytes of log data. On the dsPIC only the low 16-bits of
+ * every instruction word are used, so this is 2 bytes per instruction in a page.
+ */
+#if defined(__dsPIC33E__) || defined(__PIC24E__)
+#define FLASH_LOG_SECTOR_SIZE 2048
+#else
+#define FLASH_LOG_SECTOR_SIZE 1024
+#endif
+
+/**
+ * The number of sectors used for the log, up to 16. The dsPIC33E has twice the program flash to
+ * spare, so it keeps twice the sectors.
+ */
+#ifndef FLASH_LOG_SECTORS
+#if defined(__dsPIC33E__) || defined(__PIC24E__)
+#define FLASH_LOG_SECTORS 16
+#else
+#define FLASH_LOG_SECTORS 8
+#endif
+#endif
+
+/**
+ * The size of the RAM queue of records waiting to be programmed, in bytes. Each record also takes
+ * up 2 bytes for its size.
+ */
+#define FLASH_LOG_QUEUE_SIZE 512
+
+/**
+ * The most words FlashLogTask() programs per call, which takes ~200us on the dsPIC.
+ */
+#define FLASH_LOG_TASK_WORDS 4
+
+/**
+ * The largest record that can be written with a single FlashLogWrite() call. This fits any MAVLink
+ * v1.0 message.
+ */
+#define FLASH_LOG_MAX_RECORD 263
+
+/**
+ * Initializes the flash backend and rebuilds the log index from the contents of the flash. A new
+ * log is started, although no flash is used until the first FlashLogWrite().
+ */
+void FlashLogInit(void);
+
+/**
+ * Queues a record to be appended to the current log by FlashLogTask(). Records are stored
+ * atomically, so a reset in the middle of programming will drop that record, but never corrupt the
+ * log.
+ * @param data The data to store.
+ * @param size The number of bytes in `data`. Must be in (0, FLASH_LOG_MAX_RECORD].
+ * @return True if the record was queued. False if it's invalid, the queue is full, or logging is
+ *         paused.
+ */
+bool FlashLogWrite(const uint8_t *data, uint16_t size);
+
+/**
+ * Programs up to FLASH_LOG_TASK_WORDS words of the queued records into flash, or erases a single
+ * sector: one that the log needs next, or with nothing queued, the one it will need next.
+ * @param allowErase Whether a sector may be erased during this call, which stalls for ~20ms.
+ *                   Without it, records needing a new sector when there's no erased one wait for
+ *                   a call that allows it.
+ * @return True if there's still something left to do.
+ */
+bool FlashLogTask(bool allowErase);
+
+/**
+ * Pauses logging, dropping every record written while paused. Records already queued are still
+ * programmed into erased flash, but no sector is erased until logging resumes.
+ * @param paused True to pause logging, false to resume it.
+ */
+void FlashLogSetPaused(bool paused);
+
+/**
+ * @return The number of records dropped because the queue was full or logging was paused.
+ */
+uint16_t FlashLogGetDropped(void);
+
+/**
+ * @return The number of logs stored.
+ */
+uint8_t FlashLogGetLogCount(void);
+
+/**
+ * Retrieves information on a stored log.
+ * @param index The index of the log to query, with 0 being the oldest log.
+ * @param id The ID of the log. IDs increase with every boot.
+ * @param size The size of the log in bytes.
+ * @return True if there was a log at this index.
+ */
+bool FlashLogGetLogInfo(uint8_t index, uint16_t *id, uint32_t *size);
+
+/**
+ * Reads data from a log.
+ * @param id The ID of the log to read from, as returned by FlashLogGetLogInfo().
+ * @param offset The offset in bytes into the log to start reading at.
+ * @param data The buffer to read into.
+ * @param size The maximum number of bytes to read.
+ * @return The number of bytes read. 0 if the log doesn't exist or `offset` is past its end.
+ */
+uint16_t FlashLogRead(uint16_t id, uint32_t offset, uint8_t *data, uint16_t size);
+
+/**
+ * Erases all logs. They're gone right away, but their sectors are only erased by FlashLogTask().
+ * Logging continues afterwards with the same log ID.
+ */
+void FlashLogEraseAll(void);
+
+/**
+ * The backend interface. Offsets are in bytes of log data and all programming is done in aligned
+ * 16-bit words, which is the granularity of the dsPIC's program flash as used here. Like NOR flash
+ * an erase sets every bit in a sector and programming can only clear bits.
+ */
+void FlashLogBackendInit(void);
+void FlashLogBackendErase(uint8_t sector);
+bool FlashLogBackendProgram(uint8_t sector, uint16_t offset, uint16_t word);
+uint16_t FlashLogBackendRead(uint8_t sector, uint16_t offset);
+
+#endif // FLASH_LOG_H
@@ -0,0 +1,85 @@
+/**
+ * @file
+ * @brief A FlashLog backend emulating NOR flash in RAM for testing on a PC.
+ *
+ * Like real flash, erasing sets all bits in a sector and programming can only clear bits. Any
+ * attempt to program a word that isn't erased (and isn't just clearing more bits) fails. A failure
+ * can also be forced after a number of programming operations to emulate a reset in the middle of
+ * a write.
+ *
+ * The flash contents persist across calls to FlashLogBackendInit(), so FlashLogInit() can be
+ * called again to emulate a reboot.
+ */
+#include "FlashLog.h"
+
+#include <string.h>
+
+static uint8_t flash[FLASH_LOG_SECTORS][FLASH_LOG_SECTOR_SIZE];
+static bool flashInitialized = false;
+
+// Track how many erases and programs have been done for endurance/performance testing.
+uint32_t flashLogHostEraseCount = 0;
+uint32_t flashLogHostProgramCount = 0;
+
+// The number of program operations left before all programming fails. Negative to disable.
+static int32_t programsUntilFailure = -1;
+
+/**
+ * Forces programming to start failing after the given number of successful program operations.
+ * @param programs The number of programs to allow. Negative to never fail.
+ * @return True always, for convenience in asserts.
+ */
+bool flashLogHostFailAfter(int32_t programs)
+{
+    programsUntilFailure = programs;
+    return true;
+}
+
+void FlashLogBackendInit(void)
+{
+    // Start with erased flash the first time only, after that the contents are kept.
+    if (!flashInitialized) {
+        memset(flash, 0xFF, sizeof(flash));
+        flashInitialized = true;
+    }
+}
+
+void FlashLogBackendErase(uint8_t sector)
+{
+    if (sector < FLASH_LOG_SECTORS) {
+        memset(flash[sector], 0xFF, FLASH_LOG_SECTOR_SIZE);
+        ++flashLogHostEraseCount;
+    }
+}
+
+bool FlashLogBackendProgram(uint8_t sector, uint16_t offset, uint16_t word)
+{
+    if (sector >= FLASH_LOG_SECTORS || offset >= FLASH_LOG_SECTOR_SIZE || (offset & 1)) {
+        return false;
+    }
+
+    if (programsUntilFailure == 0) {
+        return false;
+    } else if (programsUntilFailure > 0) {
+        --programsUntilFailure;
+    }
+
+    // Programming can only clear bits.
+    const uint16_t current = flash[sector][offset] | ((uint16_t)flash[sector][offset + 1] << 8);
+    if ((current & word) != word) {
+        return false;
+    }
+    flash[sector][offset] = (uint8_t)word;
+    flash[sector][offset + 1] = (uint8_t)(word >> 8);
+    ++flashLogHostProgramCount;
+    return true;
+}
+
+uint16_t FlashLogBackendRead(uint8_t sector, uint16_t offset)
+{
+    if (sector >= FLASH_LOG_SECTORS || offset >= FLASH_LOG_SECTOR_SIZE) {
+        return 0xFFFF;
+    }
+    offset &= ~1;
+    return flash[sector][offset] | ((uint16_t)flash[sector][offset + 1] << 8);
+}
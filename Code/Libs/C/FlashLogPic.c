@@ -0,0 +1,73 @@
+/**
+ * @file
+ * @brief A FlashLog backend using spare program flash on the dsPIC.
+ *
+ * The log is stored in a reserved, page-aligned array in program memory in the same way as the DEE
+ * library stores its emulated EEPROM, and the flash primitives from that library are reused here.
+ * Only the low 16-bits of every instruction word are used for data, so that every write is a
+ * single word program operation.
+ *
+ * Note that programming the flash stalls the CPU, for roughly 50us per 2 bytes written and ~20ms
+ * per page erased, which is why FlashLogTask() limits how much it does per call.
+ */
+#include "FlashLog.h"
+#include "DEE.h"
+
+#include <xc.h>
+
+static unsigned char logPages[FLASH_LOG_SECTORS][NUMBER_OF_INSTRUCTIONS_IN_PAGE * 2]
+    __attribute__ ((space(psv), aligned(NUMBER_OF_INSTRUCTIONS_IN_PAGE * 2), noload));
+
+// The program memory address of a given offset into a sector. Since each instruction word takes
+// up 2 program memory addresses and stores 2 bytes of log data, the offset can be used directly.
+#define LOG_ADDRESS(sector, offset) (__builtin_tbladdress(&logPages) + sizeof(logPages[0]) * (sector) + (offset))
+#define LOG_TBL(sector, offset) (LOG_ADDRESS(sector, offset) >> 16)
+#define LOG_OFFSET(sector, offset) (LOG_ADDRESS(sector, offset) & 0xFFFF)
+
+void FlashLogBackendInit(void)
+{
+    // Nothing to do, program flash is always available.
+}
+
+void FlashLogBackendErase(uint8_t sector)
+{
+    int savedTBLPAG = TBLPAG;
+
+    TBLPAG = LOG_TBL(sector, 0);
+    NVMCON = ERASE;
+    WritePMLow(LOG_OFFSET(sector, 0), LOG_OFFSET(sector, 0));
+    UnlockWrite();
+
+    TBLPAG = savedTBLPAG;
+}
+
+bool FlashLogBackendProgram(uint8_t sector, uint16_t offset, uint16_t word)
+{
+    int savedTBLPAG = TBLPAG;
+    const unsigned int pmOffset = LOG_OFFSET(sector, offset);
+
+    TBLPAG = LOG_TBL(sector, offset);
+    NVMCON = PROGRAM_WORD;
+    WritePMLow(word, pmOffset);
+    WritePMHigh(0xFF, pmOffset);
+    UnlockWrite();
+
+    // Verify the write.
+    const bool success = ((uint16_t)ReadPMLow(pmOffset) == word);
+
+    TBLPAG = savedTBLPAG;
+
+    return success;
+}
+
+uint16_t FlashLogBackendRead(uint8_t sector, uint16_t offset)
+{
+    int savedTBLPAG = TBLPAG;
+
+    TBLPAG = LOG_TBL(sector, offset & ~1);
+    const uint16_t word = (uint16_t)ReadPMLow(LOG_OFFSET(sector, offset & ~1));
+
+    TBLPAG = savedTBLPAG;
+
+    return word;
+}
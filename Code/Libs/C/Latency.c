@@ -0,0 +1,418 @@
+/**
+ * @file
+ * @brief Implements the latency tracking declared in Latency.h.
+ *
+ * Unit testing has been completed on x86 by compiling with the UNIT_TEST_LATENCY macro.
+ * With gcc: `gcc Latency.c -DUNIT_TEST_LATENCY -Wall -g`
+ */
+#include "Latency.h"
+
+#include <string.h>
+
+typedef struct {
+    uint16_t counts[LATENCY_BUCKETS];
+    uint16_t total;     // The sum of counts.
+    uint32_t max;       // The largest sample since the last decay.
+    uint32_t lastMax;   // The largest sample in the window before that.
+    uint32_t samples;   // Every sample ever recorded, unaffected by decay.
+} LatencyHistogram;
+
+static LatencyHistogram histograms[LATENCY_STAGE_COUNT];
+
+/**
+ * Returns the bucket a latency falls into. Below 8 every value has its own bucket, after that
+ * every power of 2 is split into quarters using the 2 bits below the most significant bit.
+ */
+static uint8_t BucketForTicks(uint32_t ticks)
+{
+    if (ticks < 8) {
+        return (uint8_t)ticks;
+    }
+
+    uint8_t msb = 3;
+    while (msb < 31 && (ticks >> (msb + 1))) {
+        ++msb;
+    }
+
+    const uint8_t bucket = 4 * (msb - 1) + (uint8_t)((ticks >> (msb - 2)) & 3);
+    return (bucket < LATENCY_BUCKETS) ? bucket : LATENCY_BUCKETS - 1;
+}
+
+/**
+ * Returns the largest latency that falls into a bucket.
+ */
+static uint32_t BucketUpperBound(uint8_t bucket)
+{
+    if (bucket < 8) {
+        return bucket;
+    }
+
+    const uint8_t msb = bucket / 4 + 1;
+    const uint32_t quarter = (uint32_t)1 << (msb - 2);
+    return ((uint32_t)1 << msb) + (bucket & 3) * quarter + quarter - 1;
+}
+
+void LatencyInit(void)
+{
+    memset(histograms, 0, sizeof(histograms));
+}
+
+void LatencyRecord(LatencyStage stage, uint32_t ticks)
+{
+    if (stage >= LATENCY_STAGE_COUNT) {
+        return;
+    }
+    LatencyHistogram *h = &histograms[stage];
+
+    // Decay the histogram once the window is full. Everything is halved, so the previous window
+    // carries half the weight of the current one, the one before that a quarter, etc.
+    if (h->total >= LATENCY_WINDOW) {
+        uint8_t i;
+        h->total = 0;
+        for (i = 0; i < LATENCY_BUCKETS; ++i) {
+            h->counts[i] >>= 1;
+            h->total += h->counts[i];
+        }
+        h->lastMax = h->max;
+        h->max = 0;
+    }
+
+    ++h->counts[BucketForTicks(ticks)];
+    ++h->total;
+    ++h->samples;
+    if (ticks > h->max) {
+        h->max = ticks;
+    }
+}
+
+void LatencyDecoded(LatencyStamp *stamp, uint32_t received, uint32_t now)
+{
+    if (received) {
+        LatencyRecord(LATENCY_STAGE_CAN_QUEUE, now - received);
+    }
+    stamp->received = received;
+    stamp->processed = now;
+    stamp->consumed = 0;
+}
+
+void LatencyConsumed(LatencyStamp *stamp, uint32_t now)
+{
+    if (stamp->processed && !stamp->consumed) {
+        LatencyRecord(LATENCY_STAGE_CONTROLLER, now - stamp->processed);
+        stamp->consumed = now;
+    }
+}
+
+void LatencySent(const LatencyStamp *stamp, LatencyStage totalStage, uint32_t packed, uint32_t drained)
+{
+    // Nothing to track until the data has arrived at least once.
+    if (!stamp->processed) {
+        return;
+    }
+
+    // Data that's sent directly from the data store skips the controller stage.
+    const uint32_t scheduled = stamp->consumed ? stamp->consumed : stamp->processed;
+    LatencyRecord(LATENCY_STAGE_SCHEDULER, packed - scheduled);
+    LatencyRecord(LATENCY_STAGE_UART, drained - packed);
+    if (stamp->received) {
+        LatencyRecord(totalStage, drained - stamp->received);
+    }
+}
+
+uint32_t LatencyGetPercentile(LatencyStage stage, uint8_t percent)
+{
+    if (stage >= LATENCY_STAGE_COUNT) {
+        return 0;
+    }
+    const LatencyHistogram *h = &histograms[stage];
+    if (!h->total) {
+        return 0;
+    }
+    if (percent > 100) {
+        percent = 100;
+    }
+
+    // Find the bucket holding the sample with this rank, rounding up.
+    uint32_t rank = ((uint32_t)h->total * percent + 99) / 100;
+    if (rank == 0) {
+        rank = 1;
+    }
+    const uint32_t max = (h->max > h->lastMax) ? h->max : h->lastMax;
+    uint32_t seen = 0;
+    uint8_t i;
+    for (i = 0; i < LATENCY_BUCKETS; ++i) {
+        seen += h->counts[i];
+        if (seen >= rank) {
+            const uint32_t bound = BucketUpperBound(i);
+            return (bound < max) ? bound : max;
+        }
+    }
+    return max;
+}
+
+void LatencyGetSummary(LatencyStage stage, LatencySummary *summary)
+{
+    memset(summary, 0, sizeof(*summary));
+    if (stage >= LATENCY_STAGE_COUNT) {
+        return;
+    }
+    const LatencyHistogram *h = &histograms[stage];
+
+    summary->p50 = LatencyGetPercentile(stage, 50);
+    summary->p90 = LatencyGetPercentile(stage, 90);
+    summary->p99 = LatencyGetPercentile(stage, 99);
+    summary->max = (h->max > h->lastMax) ? h->max : h->lastMax;
+    summary->samples = h->samples;
+}
+
+#ifdef UNIT_TEST_LATENCY
+
+#include <stdio.h>
+#include <assert.h>
+
+int main()
+{
+    printf("Testing Latency.c. All errors will be reported as failed assertions.\n");
+
+    // Check that the buckets are contiguous and that every value is within its bucket.
+    uint32_t t;
+    for (t = 0; t <= UINT16_MAX; ++t) {
+        const uint8_t b = BucketForTicks(t);
+        assert(t <= BucketUpperBound(b));
+        assert(b == 0 || t > BucketUpperBound(b - 1));
+    }
+    assert(BucketForTicks(UINT32_MAX) == LATENCY_BUCKETS - 1);
+    assert(BucketUpperBound(LATENCY_BUCKETS - 1) == UINT16_MAX);
+
+    // Empty histograms report 0.
+    LatencyInit();
+    assert(LatencyGetPercentile(LATENCY_STAGE_UART, 50) == 0);
+
+    // Percentiles are the upper bound of their bucket, but never more than the max.
+    LatencySummary s;
+    uint16_t i;
+    for (i = 1; i <= 100; ++i) {
+        LatencyRecord(LATENCY_STAGE_UART, i);
+    }
+    LatencyGetSummary(LATENCY_STAGE_UART, &s);
+    assert(s.samples == 100);
+    assert(s.max == 100);
+    assert(s.p50 >= 50 && s.p50 <= 50 * 5 / 4);
+    assert(s.p90 >= 90 && s.p90 <= 100);
+    assert(s.p99 >= 99 && s.p99 <= 100);
+    assert(LatencyGetPercentile(LATENCY_STAGE_UART, 0) == 1);
+    assert(LatencyGetPercentile(LATENCY_STAGE_UART, 100) == 100);
+
+    // After a few windows, a new latency should dominate and the old max should be forgotten.
+    uint16_t j;
+    for (j = 0; j < 4 * LATENCY_WINDOW; ++j) {
+        LatencyRecord(LATENCY_STAGE_UART, 1000);
+    }
+    LatencyGetSummary(LATENCY_STAGE_UART, &s);
+    assert(s.samples == 100 + 4 * LATENCY_WINDOW);
+    assert(s.p50 == 1000 && s.p99 == 1000 && s.max == 1000);
+    assert(LatencyGetPercentile(LATENCY_STAGE_UART, 0) == 1000);
+
+    // The other stages are untouched.
+    LatencyGetSummary(LATENCY_STAGE_CAN_QUEUE, &s);
+    assert(s.samples == 0 && s.max == 0);
+
+    // Walk a stamp through the whole pipeline, including across the clock wrapping.
+    LatencyInit();
+    LatencyStamp stamp = {};
+    LatencySent(&stamp, LATENCY_STAGE_ATTITUDE_TOTAL, 10, 20);
+    LatencyGetSummary(LATENCY_STAGE_UART, &s);
+    assert(s.samples == 0);
+
+    LatencyDecoded(&stamp, UINT32_MAX - 9, 10);
+    LatencyConsumed(&stamp, 30);
+    LatencyConsumed(&stamp, 40);
+    LatencySent(&stamp, LATENCY_STAGE_POSITION_TOTAL, 100, 300);
+    assert(LatencyGetPercentile(LATENCY_STAGE_CAN_QUEUE, 100) == 20);
+    assert(LatencyGetPercentile(LATENCY_STAGE_CONTROLLER, 100) == 20);
+    assert(LatencyGetPercentile(LATENCY_STAGE_SCHEDULER, 100) == 70);
+    assert(LatencyGetPercentile(LATENCY_STAGE_UART, 100) == 200);
+    assert(LatencyGetPercentile(LATENCY_STAGE_POSITION_TOTAL, 100) == 310);
+    LatencyGetSummary(LATENCY_STAGE_CONTROLLER, &s);
+    assert(s.samples == 1);
+    LatencyGetSummary(LATENCY_STAGE_ATTITUDE_TOTAL, &s);
+    assert(s.samples == 0);
+
+    // Data that skips the controller is scheduled from when it was processed.
+    LatencyInit();
+    LatencyDecoded(&stamp, 1000, 1010);
+    LatencySent(&stamp, LATENCY_STAGE_ATTITUDE_TOTAL, 1050, 1060);
+    assert(LatencyGetPercentile(LATENCY_STAGE_SCHEDULER, 100) == 40);
+    assert(LatencyGetPercentile(LATENCY_STAGE_ATTITUDE_TOTAL, 100) == 60);
+
+    // Frames without a timestamp skip the stages that need one.
+    LatencyInit();
+    LatencyDecoded(&stamp, 0, 1010);
+    LatencySent(&stamp, LATENCY_STAGE_ATTITUDE_TOTAL, 1050, 1060);
+    LatencyGetSummary(LATENCY_STAGE_CAN_QUEUE, &s);
+    assert(s.samples == 0);
+    LatencyGetSummary(LATENCY_STAGE_ATTITUDE_TOTAL, &s);
+    assert(s.samples == 0);
+    assert(LatencyGetPercentile(LATENCY_STAGE_UART, 100) == 10);
+
+    printf("All tests passed.\n");
+
+    return 0;
+}
+
+#endif // UNIT_TEST_LATENCY
+
+#ifdef SIMULATE_LATENCY
+
+#include <stdio.h>
+
+// The simulation runs on the same clock as the primary node: Timer2 at F_OSC / 2 / 256.
+#define SIM_TICKS_PER_SECOND 156250
+#define SIM_TICKS_PER_TIMESTEP (SIM_TICKS_PER_SECOND / 100)
+#define SIM_SECONDS 600
+
+// 10 bits per byte at 115200 baud, in hundredths of a tick.
+#define SIM_UART_CENTITICKS_PER_BYTE 1356
+
+// The rates of the sensors that are tracked, in Hz. The IMU also sends 2 other frames per sample
+// and all other CAN traffic is lumped into a single background rate.
+#define SIM_IMU_HZ 25
+#define SIM_GPS_HZ 5
+#define SIM_BACKGROUND_HZ 300
+
+// How long the main loop takes to decode a single CAN frame.
+#define SIM_DECODE_TICKS 4
+
+// The scheduled rates of ATTITUDE and LOCAL_POSITION_NED and all other groundstation traffic.
+#define SIM_ATTITUDE_PERIOD 25
+#define SIM_POSITION_PERIOD 25
+#define SIM_BACKGROUND_BYTES_PER_TIMESTEP 40
+#define SIM_ATTITUDE_BYTES 36
+#define SIM_POSITION_BYTES 36
+
+static uint32_t randomState = 12345;
+
+/**
+ * A deterministic pseudo-random number in [0, limit).
+ */
+static uint32_t SimRandom(uint32_t limit)
+{
+    randomState = randomState * 1103515245 + 12345;
+    return ((randomState >> 16) & 0x7FFF) % limit;
+}
+
+/**
+ * Returns the next arrival time for a sensor at the given rate, with up to 10% jitter.
+ */
+static uint32_t SimNextArrival(uint32_t last, uint32_t hz)
+{
+    const uint32_t period = SIM_TICKS_PER_SECOND / hz;
+    return last + period - period / 20 + SimRandom(period / 10 + 1);
+}
+
+/**
+ * Queues bytes on the simulated UART, returning when the last of them will have been sent.
+ */
+static uint32_t SimUartWrite(uint32_t *uartIdle, uint32_t now, uint16_t bytes)
+{
+    if ((int32_t)(*uartIdle - now) < 0) {
+        *uartIdle = now;
+    }
+    *uartIdle += ((uint32_t)bytes * SIM_UART_CENTITICKS_PER_BYTE + 99) / 100;
+    return *uartIdle;
+}
+
+int main()
+{
+    static const char *stageNames[LATENCY_STAGE_COUNT] = {
+        "CAN queue", "Controller", "Scheduler", "UART", "ATTITUDE total", "LOCAL_POSITION total"
+    };
+
+    LatencyInit();
+
+    LatencyStamp imu = {}, gps = {}, controllerGps = {};
+
+    // Start the clock close to wrapping, to make sure that's handled everywhere.
+    uint32_t now = UINT32_MAX - SIM_TICKS_PER_SECOND;
+    const uint32_t end = now + SIM_SECONDS * SIM_TICKS_PER_SECOND;
+    uint32_t nextImu = now + SimRandom(SIM_TICKS_PER_SECOND / SIM_IMU_HZ);
+    uint32_t nextGps = now + SimRandom(SIM_TICKS_PER_SECOND / SIM_GPS_HZ);
+    uint32_t nextBackground = now;
+    uint32_t lastTimestep = now;
+    uint32_t uartIdle = now;
+    uint32_t timestep = 0;
+
+    while ((int32_t)(end - now) > 0) {
+        // The ECAN ISR timestamps the newest frame of each sensor. Since these are then all
+        // decoded in order by the main loop, only the newest one of each is kept here.
+        uint32_t imuReceived = 0, gpsReceived = 0;
+        uint16_t frames = 0;
+        while ((int32_t)(now - nextImu) >= 0) {
+            imuReceived = nextImu ? nextImu : 1;
+            nextImu = SimNextArrival(nextImu, SIM_IMU_HZ);
+            frames += 3;
+        }
+        while ((int32_t)(now - nextGps) >= 0) {
+            gpsReceived = nextGps ? nextGps : 1;
+            nextGps = SimNextArrival(nextGps, SIM_GPS_HZ);
+            ++frames;
+        }
+        while ((int32_t)(now - nextBackground) >= 0) {
+            nextBackground = SimNextArrival(nextBackground, SIM_BACKGROUND_HZ);
+            ++frames;
+        }
+
+        // ProcessAllEcanMessages()
+        now += frames * SIM_DECODE_TICKS;
+        if (imuReceived) {
+            LatencyDecoded(&imu, imuReceived, now);
+        }
+        if (gpsReceived) {
+            LatencyDecoded(&gps, gpsReceived, now);
+        }
+
+        // The 100Hz loop, which runs the controller and then the message scheduler.
+        if (now - lastTimestep >= SIM_TICKS_PER_TIMESTEP) {
+            lastTimestep = now;
+
+            // Sensor checks and LEDs, then the controller reads its inputs and runs.
+            now += 20 + SimRandom(20);
+            LatencyConsumed(&imu, now);
+            LatencyConsumed(&gps, now);
+            controllerGps = gps;
+            now += 150 + SimRandom(100);
+
+            // The scheduler spreads everything else out across the timesteps.
+            SimUartWrite(&uartIdle, now, SIM_BACKGROUND_BYTES_PER_TIMESTEP / 2 + SimRandom(SIM_BACKGROUND_BYTES_PER_TIMESTEP));
+            if (timestep % SIM_ATTITUDE_PERIOD == 0) {
+                now += 10;
+                LatencySent(&imu, LATENCY_STAGE_ATTITUDE_TOTAL, now, SimUartWrite(&uartIdle, now, SIM_ATTITUDE_BYTES));
+            }
+            if (timestep % SIM_POSITION_PERIOD == 7) {
+                now += 10;
+                LatencySent(&controllerGps, LATENCY_STAGE_POSITION_TOTAL, now, SimUartWrite(&uartIdle, now, SIM_POSITION_BYTES));
+            }
+            now += 50 + SimRandom(50);
+            ++timestep;
+        }
+
+        // The rest of the main loop.
+        now += 10 + SimRandom(40);
+    }
+
+    printf("Simulated %d s of the primary node. Latencies in us:\n", SIM_SECONDS);
+    printf("%-22s %10s %10s %10s %10s %10s\n", "Stage", "p50", "p90", "p99", "max", "samples");
+    uint8_t i;
+    for (i = 0; i < LATENCY_STAGE_COUNT; ++i) {
+        LatencySummary s;
+        LatencyGetSummary((LatencyStage)i, &s);
+        printf("%-22s %10lu %10lu %10lu %10lu %10lu\n", stageNames[i],
+               (unsigned long)(s.p50 * 32 / 5), (unsigned long)(s.p90 * 32 / 5),
+               (unsigned long)(s.p99 * 32 / 5), (unsigned long)(s.max * 32 / 5),
+               (unsigned long)s.samples);
+    }
+
+    return 0;
+}
+
+#endif // SIMULATE_LATENCY
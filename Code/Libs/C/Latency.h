@@ -0,0 +1,140 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+/**
+ * @file
+ * @brief Tracks the latency of sensor data from CAN reception through to MAVLink telemetry.
+ *
+ * # Dependencies
+ * This library has no prerequisites outside of the C standard library. All timestamps are passed
+ * in by the caller from a free-running, wrapping clock, so it doesn't depend on any hardware. The
+ * units of all latencies are those of this clock, which is referred to as ticks below.
+ *
+ * # Usage
+ * Data moves through a pipeline of stages, see LatencyStage. A LatencyStamp travels alongside the
+ * data through each stage, recording when the data entered it:
+ *  1. The ECAN ISR timestamps every CAN frame when it's received.
+ *  2. LatencyDecoded() is called when a frame's data is copied into its data store.
+ *  3. LatencyConsumed() is called when the controller first reads that data.
+ *  4. LatencySent() is called when a MAVLink message containing that data is written out, along
+ *     with the time the message is expected to have left the UART.
+ *
+ * Each stage has its own rolling histogram which can be queried for percentiles. A timestamp of 0
+ * marks a stamp as unset, so a stage is skipped if the time it started at wasn't recorded.
+ *
+ * # Histograms
+ * Latencies are binned into logarithmic buckets with 4 buckets per power of 2, so percentiles are
+ * accurate to within 25%. Latencies over 2^16 ticks are all binned into the last bucket, though the
+ * maximum is tracked exactly. The histograms roll by halving every bucket once LATENCY_WINDOW
+ * samples have been recorded, so old samples decay away while new ones keep full weight.
+ *
+ * # Simulation
+ * Compiling with the SIMULATE_LATENCY macro builds a host program that runs a model of the primary
+ * node's pipeline (CAN traffic, the main loop, the 100Hz controller, the message scheduler, and the
+ * UART) through this library and prints the resulting percentiles for every stage.
+ * With gcc: `gcc Latency.c -DSIMULATE_LATENCY -Wall -g`
+ *
+ * Unit testing has been completed on x86 by compiling with the UNIT_TEST_LATENCY macro.
+ * With gcc: `gcc Latency.c -DUNIT_TEST_LATENCY -Wall -g`
+ */
+
+#include <stdint.h>
+
+/**
+ * The number of histogram buckets for every stage.
+ */
+#define LATENCY_BUCKETS 60
+
+/**
+ * The number of samples after which a histogram is decayed.
+ */
+#ifndef LATENCY_WINDOW
+#define LATENCY_WINDOW 512
+#endif
+
+/**
+ * Each stage of the pipeline that's tracked.
+ */
+typedef enum {
+    LATENCY_STAGE_CAN_QUEUE,      // From the ECAN ISR until decoded into a data store.
+    LATENCY_STAGE_CONTROLLER,     // From the data store until first read by the controller.
+    LATENCY_STAGE_SCHEDULER,      // From the controller (or data store) until a message is packed.
+    LATENCY_STAGE_UART,           // From packing until the message leaves the UART.
+    LATENCY_STAGE_ATTITUDE_TOTAL, // From the ECAN ISR until the ATTITUDE message leaves the UART.
+    LATENCY_STAGE_POSITION_TOTAL, // From the ECAN ISR until the LOCAL_POSITION_NED message leaves the UART.
+    LATENCY_STAGE_COUNT
+} LatencyStage;
+
+/**
+ * The times at which a piece of sensor data entered each stage of the pipeline. 0 means unset.
+ */
+typedef struct {
+    uint32_t received;  // When its CAN frame was received by the ECAN ISR.
+    uint32_t processed; // When it was decoded into its data store.
+    uint32_t consumed;  // When the controller first read it.
+} LatencyStamp;
+
+/**
+ * A summary of the histogram for a single stage.
+ */
+typedef struct {
+    uint32_t p50;
+    uint32_t p90;
+    uint32_t p99;
+    uint32_t max;     // The largest latency in the last 1-2 windows.
+    uint32_t samples; // The total number of samples ever recorded.
+} LatencySummary;
+
+/**
+ * Clears all histograms.
+ */
+void LatencyInit(void);
+
+/**
+ * Records a single latency sample for a stage.
+ * @param stage The stage the sample is for.
+ * @param ticks The latency.
+ */
+void LatencyRecord(LatencyStage stage, uint32_t ticks);
+
+/**
+ * Records that data from a CAN frame has been decoded into its data store, restarting its stamp.
+ * @param stamp The stamp for the data store.
+ * @param received The timestamp of the CAN frame.
+ * @param now The current time.
+ */
+void LatencyDecoded(LatencyStamp *stamp, uint32_t received, uint32_t now);
+
+/**
+ * Records that the controller has read the data. Only the first read of new data is recorded.
+ * @param stamp The stamp for the data store.
+ * @param now The current time.
+ */
+void LatencyConsumed(LatencyStamp *stamp, uint32_t now);
+
+/**
+ * Records that a message containing the data has been written out.
+ * @param stamp The stamp of the data the message contains.
+ * @param totalStage The stage to record the total latency of this message in.
+ * @param packed The time the message was packed.
+ * @param drained The time the message is expected to have fully left the UART.
+ */
+void LatencySent(const LatencyStamp *stamp, LatencyStage totalStage, uint32_t packed, uint32_t drained);
+
+/**
+ * Returns a percentile of the latency of a stage. This is the upper bound of the bucket the
+ * percentile falls in, limited to the maximum latency seen.
+ * @param stage The stage to query.
+ * @param percent The percentile, [0, 100].
+ * @return The latency or 0 if there are no samples.
+ */
+uint32_t LatencyGetPercentile(LatencyStage stage, uint8_t percent);
+
+/**
+ * Summarizes the latency of a stage.
+ * @param stage The stage to query.
+ * @param summary The summary of this stage.
+ */
+void LatencyGetSummary(LatencyStage stage, LatencySummary *summary);
+
+#endif // LATENCY_H
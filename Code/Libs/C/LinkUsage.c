@@ -0,0 +1,168 @@
+#include "LinkUsage.h"
+
+void LinkUsageInit(LinkUsage *u, uint16_t byteRate, uint16_t ticksPerSecond)
+{
+    u->byteRate = byteRate;
+    u->ticksPerSecond = ticksPerSecond;
+    u->tick = 0;
+    u->started = false;
+    u->queueSum = 0;
+    u->index = 0;
+    u->count = 0;
+}
+
+void LinkUsageTick(LinkUsage *u, uint32_t txBytes, uint32_t rxBytes, uint16_t queued)
+{
+    // The first sample only starts the first second.
+    if (!u->started) {
+        u->lastTx = txBytes;
+        u->lastRx = rxBytes;
+        u->started = true;
+        return;
+    }
+
+    u->queueSum += queued;
+    if (++u->tick < u->ticksPerSecond) {
+        return;
+    }
+
+    // Store this second's measurements, saturating as they'd only overflow on a link faster than
+    // 64KB/s.
+    const uint32_t tx = txBytes - u->lastTx;
+    const uint32_t rx = rxBytes - u->lastRx;
+    const uint32_t queue = u->queueSum / u->ticksPerSecond;
+    u->tx[u->index] = (tx < UINT16_MAX) ? (uint16_t)tx : UINT16_MAX;
+    u->rx[u->index] = (rx < UINT16_MAX) ? (uint16_t)rx : UINT16_MAX;
+    u->queue[u->index] = (uint16_t)queue;
+    u->index = (u->index + 1) % LINK_USAGE_SECONDS;
+    if (u->count < LINK_USAGE_SECONDS) {
+        ++u->count;
+    }
+
+    u->lastTx = txBytes;
+    u->lastRx = rxBytes;
+    u->queueSum = 0;
+    u->tick = 0;
+}
+
+bool LinkUsageValid(const LinkUsage *u)
+{
+    return u->count > 0;
+}
+
+/**
+ * Averages one of the measurements over the window.
+ */
+static uint16_t Average(const LinkUsage *u, const uint16_t values[LINK_USAGE_SECONDS])
+{
+    if (!u->count) {
+        return 0;
+    }
+    uint32_t sum = 0;
+    uint8_t i;
+    for (i = 0; i < u->count; ++i) {
+        sum += values[i];
+    }
+    return (uint16_t)(sum / u->count);
+}
+
+uint16_t LinkUsageTxRate(const LinkUsage *u)
+{
+    return Average(u, u->tx);
+}
+
+uint16_t LinkUsageRxRate(const LinkUsage *u)
+{
+    return Average(u, u->rx);
+}
+
+uint8_t LinkUsageTxIdle(const LinkUsage *u)
+{
+    if (!u->count || !u->byteRate) {
+        return 100;
+    }
+    const uint32_t busy = (uint32_t)LinkUsageTxRate(u) * 100 / u->byteRate;
+    return (busy < 100) ? (uint8_t)(100 - busy) : 0;
+}
+
+uint16_t LinkUsageQueueWait(const LinkUsage *u)
+{
+    const uint32_t queue = Average(u, u->queue);
+    if (!queue) {
+        return 0;
+    }
+
+    // Data that's queued but not moving waits forever.
+    const uint32_t rate = LinkUsageTxRate(u);
+    if (!rate) {
+        return UINT16_MAX;
+    }
+    const uint32_t wait = queue * 1000 / rate;
+    return (wait < UINT16_MAX) ? (uint16_t)wait : UINT16_MAX;
+}
+
+#ifdef UNIT_TEST_LINK_USAGE
+
+#include <stdio.h>
+#include <assert.h>
+
+int main()
+{
+    printf("Running unit tests.\n");
+
+    LinkUsage u;
+    LinkUsageInit(&u, 11520, 100);
+    assert(!LinkUsageValid(&u));
+    assert(LinkUsageTxRate(&u) == 0 && LinkUsageTxIdle(&u) == 100 && LinkUsageQueueWait(&u) == 0);
+
+    // 2880 bytes/s out with 576 bytes always queued, so 25% busy and waiting for 200ms, with the
+    // counters wrapping around.
+    uint32_t tx = UINT32_MAX - 1000;
+    uint32_t rx = 0;
+    int i;
+    LinkUsageTick(&u, tx, rx, 0);
+    for (i = 0; i < 99; ++i) {
+        tx += 28;
+        rx += 1;
+        LinkUsageTick(&u, tx, rx, 576);
+        assert(!LinkUsageValid(&u));
+    }
+    tx += 108;
+    rx += 1;
+    LinkUsageTick(&u, tx, rx, 576);
+    assert(LinkUsageValid(&u));
+    assert(LinkUsageTxRate(&u) == 2880);
+    assert(LinkUsageRxRate(&u) == 100);
+    assert(LinkUsageTxIdle(&u) == 75);
+    assert(LinkUsageQueueWait(&u) == 200);
+
+    // The window rolls over, so after LINK_USAGE_SECONDS of saturation the old second is gone.
+    int s;
+    for (s = 0; s < LINK_USAGE_SECONDS; ++s) {
+        for (i = 0; i < 100; ++i) {
+            tx += (i < 20) ? 116 : 115;
+            LinkUsageTick(&u, tx, rx, 1152);
+        }
+        if (s < LINK_USAGE_SECONDS - 1) {
+            assert(LinkUsageTxRate(&u) < 11520);
+        }
+    }
+    assert(LinkUsageTxRate(&u) == 11520);
+    assert(LinkUsageRxRate(&u) == 0);
+    assert(LinkUsageTxIdle(&u) == 0);
+    assert(LinkUsageQueueWait(&u) == 100);
+
+    // A stuck transmitter waits forever.
+    for (i = 0; i < 100 * LINK_USAGE_SECONDS; ++i) {
+        LinkUsageTick(&u, tx, rx, 10);
+    }
+    assert(LinkUsageTxRate(&u) == 0);
+    assert(LinkUsageTxIdle(&u) == 100);
+    assert(LinkUsageQueueWait(&u) == UINT16_MAX);
+
+    printf("All tests passed.\n");
+
+    return 0;
+}
+
+#endif // UNIT_TEST_LINK_USAGE
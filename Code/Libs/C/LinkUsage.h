@@ -0,0 +1,94 @@
+#ifndef LINK_USAGE_H
+#define LINK_USAGE_H
+
+/**
+ * @file
+ * @brief Measures the throughput and utilization of a UART over a rolling window.
+ *
+ * # Dependencies
+ * This library has no prerequisites outside of the C standard library. The caller passes in the
+ * UART's byte counters and queue length, like from Uart1GetTxBytes(), Uart1GetRxBytes(), and
+ * Uart1GetTxQueueLength().
+ *
+ * # Usage
+ * Call LinkUsageTick() at the fixed rate given to LinkUsageInit(), like from a 100Hz loop. Every
+ * second the bytes transmitted and received and the average queue length are stored, and the
+ * results are averaged over the last LINK_USAGE_SECONDS seconds:
+ *  * The transmit and receive throughput in bytes/s.
+ *  * The percentage of time the transmitter was idle, from the throughput and the UART's rate.
+ *  * The average time data waits in the transmit queue, from the average queue length and the
+ *    throughput by Little's law, so no timestamps need to be kept per write.
+ * Until the first second has passed there's nothing measured, see LinkUsageValid().
+ *
+ * The byte counters may wrap around, only their differences are used.
+ *
+ * Unit testing has been completed on x86 by compiling with the UNIT_TEST_LINK_USAGE macro.
+ * With gcc: `gcc LinkUsage.c -DUNIT_TEST_LINK_USAGE -Wall -g`
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * The number of one-second measurements averaged.
+ */
+#define LINK_USAGE_SECONDS 10
+
+typedef struct {
+    uint16_t byteRate;       // The bytes/s the UART can transmit.
+    uint16_t ticksPerSecond;
+    uint16_t tick;           // Ticks into the current second.
+    bool started;            // Whether the counters below have been sampled yet.
+    uint32_t lastTx;         // The byte counters at the start of the current second.
+    uint32_t lastRx;
+    uint32_t queueSum;       // The sum of the queue lengths sampled in the current second.
+    uint16_t tx[LINK_USAGE_SECONDS];    // The bytes transmitted every second.
+    uint16_t rx[LINK_USAGE_SECONDS];    // The bytes received every second.
+    uint16_t queue[LINK_USAGE_SECONDS]; // The average queue length every second.
+    uint8_t index;           // Where the next second's measurements go.
+    uint8_t count;           // The number of seconds measured, up to LINK_USAGE_SECONDS.
+} LinkUsage;
+
+/**
+ * Resets the measurements.
+ * @param u The measurements.
+ * @param byteRate The bytes/s the UART can transmit, like 11520 at 115200 baud.
+ * @param ticksPerSecond The rate LinkUsageTick() is called at.
+ */
+void LinkUsageInit(LinkUsage *u, uint16_t byteRate, uint16_t ticksPerSecond);
+
+/**
+ * Samples the UART.
+ * @param u The measurements.
+ * @param txBytes The total bytes transmitted.
+ * @param rxBytes The total bytes received.
+ * @param queued The bytes currently waiting to be transmitted.
+ */
+void LinkUsageTick(LinkUsage *u, uint32_t txBytes, uint32_t rxBytes, uint16_t queued);
+
+/**
+ * Checks whether at least one second has been measured.
+ */
+bool LinkUsageValid(const LinkUsage *u);
+
+/**
+ * Returns the average bytes/s transmitted.
+ */
+uint16_t LinkUsageTxRate(const LinkUsage *u);
+
+/**
+ * Returns the average bytes/s received.
+ */
+uint16_t LinkUsageRxRate(const LinkUsage *u);
+
+/**
+ * Returns the percentage of time the transmitter was idle.
+ */
+uint8_t LinkUsageTxIdle(const LinkUsage *u);
+
+/**
+ * Returns the average time in milliseconds that data waited in the transmit queue, saturating.
+ */
+uint16_t LinkUsageQueueWait(const LinkUsage *u);
+
+#endif // LINK_USAGE_H
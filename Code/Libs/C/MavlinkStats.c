@@ -0,0 +1,312 @@
+/**
+ * @file
+ * @brief Implements the MAVLink statistics declared in MavlinkStats.h.
+ *
+ * Unit testing has been completed on x86 by compiling with the UNIT_TEST_MAVLINK_STATS macro.
+ * With gcc: `gcc MavlinkStats.c -DUNIT_TEST_MAVLINK_STATS -Wall -g`
+ */
+#include "MavlinkStats.h"
+
+#include <stddef.h>
+#include <string.h>
+
+// Sequence gaps this large or larger are assumed to not be from lost messages.
+#define MAX_SEQUENCE_GAP 128
+
+// Maps every message ID to its index in the message table plus 1, so that 0 marks an unused ID.
+// This keeps lookups O(1) for every message sent and received.
+static uint8_t messageSlots[256];
+
+static MavlinkMessageStats messages[MAVLINK_STATS_MAX_MESSAGES];
+static uint8_t messageCount;
+
+static MavlinkSystemStats systems[MAVLINK_STATS_MAX_SYSTEMS];
+static uint8_t systemCount;
+
+static uint32_t rxTotal[MAVLINK_STATS_CHANNELS];
+static uint32_t rxErrors[MAVLINK_STATS_CHANNELS];
+static uint32_t untracked;
+
+/**
+ * Finds the message table entry for a message ID, adding it if it doesn't exist.
+ * @return The entry or NULL if the table is full.
+ */
+static MavlinkMessageStats *GetMessageEntry(uint8_t msgid)
+{
+    if (messageSlots[msgid]) {
+        return &messages[messageSlots[msgid] - 1];
+    }
+
+    if (messageCount >= MAVLINK_STATS_MAX_MESSAGES) {
+        ++untracked;
+        return NULL;
+    }
+
+    MavlinkMessageStats *m = &messages[messageCount++];
+    memset(m, 0, sizeof(*m));
+    m->msgid = msgid;
+    messageSlots[msgid] = messageCount;
+    return m;
+}
+
+void MavlinkStatsInit(void)
+{
+    memset(messageSlots, 0, sizeof(messageSlots));
+    messageCount = 0;
+    systemCount = 0;
+    memset(rxTotal, 0, sizeof(rxTotal));
+    memset(rxErrors, 0, sizeof(rxErrors));
+    untracked = 0;
+}
+
+void MavlinkStatsRecordRx(uint8_t channel, uint8_t sysid, uint8_t msgid, uint8_t seq, uint16_t size)
+{
+    if (channel >= MAVLINK_STATS_CHANNELS) {
+        return;
+    }
+
+    ++rxTotal[channel];
+
+    MavlinkMessageStats *m = GetMessageEntry(msgid);
+    if (m) {
+        ++m->rxCount;
+        m->rxBytes += size;
+    }
+
+    // There are only ever a few remote systems, so a linear search is fine.
+    uint8_t i;
+    for (i = 0; i < systemCount; ++i) {
+        MavlinkSystemStats *s = &systems[i];
+        if (s->channel == channel && s->sysid == sysid) {
+            const uint8_t gap = (uint8_t)(seq - s->lastSeq - 1);
+            if (gap < MAX_SEQUENCE_GAP) {
+                s->lost += gap;
+            }
+            s->lastSeq = seq;
+            ++s->received;
+            return;
+        }
+    }
+
+    // Otherwise start tracking this system if there's room.
+    if (systemCount < MAVLINK_STATS_MAX_SYSTEMS) {
+        MavlinkSystemStats *s = &systems[systemCount++];
+        s->channel = channel;
+        s->sysid = sysid;
+        s->lastSeq = seq;
+        s->received = 1;
+        s->lost = 0;
+    }
+}
+
+void MavlinkStatsRecordRxErrors(uint8_t channel, uint8_t count)
+{
+    if (channel < MAVLINK_STATS_CHANNELS) {
+        rxErrors[channel] += count;
+    }
+}
+
+void MavlinkStatsRecordTx(uint8_t channel, uint8_t msgid, uint16_t size)
+{
+    if (channel >= MAVLINK_STATS_CHANNELS) {
+        return;
+    }
+
+    MavlinkMessageStats *m = GetMessageEntry(msgid);
+    if (m) {
+        ++m->txCount[channel];
+        m->txBytes[channel] += size;
+    }
+}
+
+void MavlinkStatsRecordTxDropped(uint8_t channel, uint8_t msgid)
+{
+    if (channel >= MAVLINK_STATS_CHANNELS) {
+        return;
+    }
+
+    MavlinkMessageStats *m = GetMessageEntry(msgid);
+    if (m) {
+        ++m->txDropped[channel];
+    }
+}
+
+uint32_t MavlinkStatsGetRxTotal(uint8_t channel)
+{
+    return channel < MAVLINK_STATS_CHANNELS ? rxTotal[channel] : 0;
+}
+
+uint32_t MavlinkStatsGetRxErrors(uint8_t channel)
+{
+    return channel < MAVLINK_STATS_CHANNELS ? rxErrors[channel] : 0;
+}
+
+uint32_t MavlinkStatsGetUntracked(void)
+{
+    return untracked;
+}
+
+uint8_t MavlinkStatsGetMessageCount(void)
+{
+    return messageCount;
+}
+
+bool MavlinkStatsGetMessage(uint8_t index, MavlinkMessageStats *stats)
+{
+    if (index >= messageCount) {
+        return false;
+    }
+    if (stats) {
+        *stats = messages[index];
+    }
+    return true;
+}
+
+bool MavlinkStatsFindMessage(uint8_t msgid, MavlinkMessageStats *stats)
+{
+    if (!messageSlots[msgid]) {
+        return false;
+    }
+    return MavlinkStatsGetMessage(messageSlots[msgid] - 1, stats);
+}
+
+uint8_t MavlinkStatsGetSystemCount(void)
+{
+    return systemCount;
+}
+
+bool MavlinkStatsGetSystem(uint8_t index, MavlinkSystemStats *stats)
+{
+    if (index >= systemCount) {
+        return false;
+    }
+    if (stats) {
+        *stats = systems[index];
+    }
+    return true;
+}
+
+#ifdef UNIT_TEST_MAVLINK_STATS
+
+#include <stdio.h>
+#include <assert.h>
+
+int main()
+{
+    printf("Testing MavlinkStats.c. All errors will be reported as failed assertions.\n");
+
+    MavlinkStatsInit();
+    assert(MavlinkStatsGetMessageCount() == 0);
+    assert(MavlinkStatsGetSystemCount() == 0);
+    assert(!MavlinkStatsGetMessage(0, NULL));
+
+    MavlinkMessageStats m;
+    MavlinkSystemStats s;
+
+    // Receive a few messages in sequence from one system.
+    MavlinkStatsRecordRx(0, 255, 0, 10, 17);
+    MavlinkStatsRecordRx(0, 255, 0, 11, 17);
+    MavlinkStatsRecordRx(0, 255, 76, 12, 41);
+    assert(MavlinkStatsGetRxTotal(0) == 3 && MavlinkStatsGetRxTotal(1) == 0);
+    assert(MavlinkStatsGetMessageCount() == 2);
+    assert(MavlinkStatsFindMessage(0, &m));
+    assert(m.msgid == 0 && m.rxCount == 2 && m.rxBytes == 34);
+    assert(MavlinkStatsGetMessage(1, &m));
+    assert(m.msgid == 76 && m.rxCount == 1 && m.rxBytes == 41);
+    assert(!MavlinkStatsFindMessage(1, &m));
+    assert(MavlinkStatsGetSystem(0, &s));
+    assert(s.sysid == 255 && s.received == 3 && s.lost == 0);
+
+    // A gap in the sequence numbers should be counted as lost, including across the wrap. The
+    // jump from 15 to 254 is too big to be loss, so it's ignored.
+    MavlinkStatsRecordRx(0, 255, 0, 15, 17);
+    MavlinkStatsRecordRx(0, 255, 0, 254, 17);
+    MavlinkStatsRecordRx(0, 255, 0, 1, 17);
+    assert(MavlinkStatsGetSystem(0, &s));
+    assert(s.received == 6);
+    assert(s.lost == 4);
+
+    // Duplicates or out-of-order messages aren't lost.
+    MavlinkStatsRecordRx(0, 255, 0, 1, 17);
+    MavlinkStatsRecordRx(0, 255, 0, 0, 17);
+    assert(MavlinkStatsGetSystem(0, &s));
+    assert(s.lost == 4);
+
+    // Systems are tracked separately.
+    MavlinkStatsRecordRx(0, '3', 109, 200, 17);
+    MavlinkStatsRecordRx(0, '3', 109, 202, 17);
+    assert(MavlinkStatsGetSystemCount() == 2);
+    assert(MavlinkStatsGetSystem(1, &s));
+    assert(s.sysid == '3' && s.received == 2 && s.lost == 1);
+
+    // And so are the same systems on different channels, so their losses don't mix.
+    MavlinkStatsRecordRx(1, 255, 0, 100, 17);
+    MavlinkStatsRecordRx(1, 255, 0, 101, 17);
+    MavlinkStatsRecordRx(0, 255, 0, 3, 17);
+    assert(MavlinkStatsGetSystemCount() == 3);
+    assert(MavlinkStatsGetSystem(2, &s));
+    assert(s.channel == 1 && s.sysid == 255 && s.received == 2 && s.lost == 0);
+    assert(MavlinkStatsGetSystem(0, &s));
+    assert(s.channel == 0 && s.received == 9 && s.lost == 6);
+    assert(MavlinkStatsGetRxTotal(1) == 2);
+
+    // Transmission is tracked per-channel.
+    MavlinkStatsRecordTx(0, 0, 17);
+    MavlinkStatsRecordTx(1, 0, 17);
+    MavlinkStatsRecordTx(1, 0, 17);
+    MavlinkStatsRecordTx(2, 0, 17);
+    assert(MavlinkStatsFindMessage(0, &m));
+    assert(m.txCount[0] == 1 && m.txBytes[0] == 17);
+    assert(m.txCount[1] == 2 && m.txBytes[1] == 34);
+
+    // Dropped messages are counted separately from the transmitted ones.
+    MavlinkStatsRecordTxDropped(1, 0);
+    MavlinkStatsRecordTxDropped(2, 0);
+    assert(MavlinkStatsFindMessage(0, &m));
+    assert(m.txDropped[0] == 0 && m.txDropped[1] == 1);
+    assert(m.txCount[1] == 2);
+
+    // Parse errors are counted per-channel too.
+    MavlinkStatsRecordRxErrors(0, 0);
+    MavlinkStatsRecordRxErrors(0, 1);
+    MavlinkStatsRecordRxErrors(1, 3);
+    MavlinkStatsRecordRxErrors(2, 5);
+    assert(MavlinkStatsGetRxErrors(0) == 1);
+    assert(MavlinkStatsGetRxErrors(1) == 3);
+    assert(MavlinkStatsGetRxErrors(2) == 0);
+
+    // Fill up the message table and check that the overflow is counted.
+    uint16_t id;
+    for (id = 0; id < 256; ++id) {
+        MavlinkStatsRecordTx(0, (uint8_t)id, 10);
+    }
+    assert(MavlinkStatsGetMessageCount() == MAVLINK_STATS_MAX_MESSAGES);
+    assert(MavlinkStatsGetUntracked() == 256 - MAVLINK_STATS_MAX_MESSAGES);
+    assert(MavlinkStatsFindMessage(76, &m));
+    assert(m.txCount[0] == 1 && m.rxCount == 1);
+
+    // And that the counters don't wrap at 16-bits.
+    uint32_t i;
+    for (i = 0; i < 70000; ++i) {
+        MavlinkStatsRecordTx(0, 76, 41);
+    }
+    assert(MavlinkStatsFindMessage(76, &m));
+    assert(m.txCount[0] == 70001 && m.txBytes[0] == 70000 * 41 + 10);
+
+    // Resetting should clear everything.
+    MavlinkStatsInit();
+    assert(MavlinkStatsGetMessageCount() == 0);
+    assert(MavlinkStatsGetSystemCount() == 0);
+    assert(!MavlinkStatsFindMessage(76, &m));
+    assert(MavlinkStatsGetRxTotal(0) == 0);
+    assert(MavlinkStatsGetRxErrors(1) == 0);
+    MavlinkStatsRecordTx(0, 76, 41);
+    assert(MavlinkStatsFindMessage(76, &m));
+    assert(m.txCount[0] == 1 && m.rxCount == 0);
+
+    printf("All tests passed.\n");
+
+    return 0;
+}
+
+#endif // UNIT_TEST_MAVLINK_STATS
@@ -0,0 +1,167 @@
+#ifndef MAVLINK_STATS_H
+#define MAVLINK_STATS_H
+
+/**
+ * @file
+ * @brief Per-message-ID and per-system statistics for MAVLink links.
+ *
+ * # Dependencies
+ * This library has no prerequisites outside of the C standard library. It doesn't depend on the
+ * MAVLink headers, the caller passes in the relevant header fields of each message.
+ *
+ * # Usage
+ * Call MavlinkStatsRecordRx() for every message successfully parsed, MavlinkStatsRecordRxErrors()
+ * with the parser's drop count, MavlinkStatsRecordTx() for every message queued for a channel, and
+ * MavlinkStatsRecordTxDropped() for every message that didn't fit into the channel's queue. All
+ * counters are 32-bits wide so they don't overflow over any realistic run time.
+ *
+ * Statistics are kept in a table that's filled in the order that message IDs are first seen, and
+ * can be walked by index with MavlinkStatsGetMessage() to report them. Messages that don't fit
+ * into the table are only counted in MavlinkStatsGetUntracked().
+ *
+ * Lost messages are estimated per channel and remote system ID from gaps in the sequence numbers,
+ * as the same system can send over several links, each with its own losses. Since the
+ * sequence number is only 8-bits, runs of more than 127 lost messages in a row are undercounted.
+ * Gaps of 128 or more are assumed to be out-of-order messages or a restart of the remote system
+ * and are not counted as lost.
+ *
+ * Unit testing has been completed on x86 by compiling with the UNIT_TEST_MAVLINK_STATS macro.
+ * With gcc: `gcc MavlinkStats.c -DUNIT_TEST_MAVLINK_STATS -Wall -g`
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * The number of channels that are tracked, indexed from 0.
+ */
+#define MAVLINK_STATS_CHANNELS 2
+
+/**
+ * The number of unique message IDs that can be tracked.
+ */
+#ifndef MAVLINK_STATS_MAX_MESSAGES
+#define MAVLINK_STATS_MAX_MESSAGES 48
+#endif
+
+/**
+ * The number of unique remote system IDs that can be tracked.
+ */
+#ifndef MAVLINK_STATS_MAX_SYSTEMS
+#define MAVLINK_STATS_MAX_SYSTEMS 8
+#endif
+
+/**
+ * Statistics for a single message ID. Byte counts are of the whole message as sent on the wire,
+ * including the header and checksum.
+ */
+typedef struct {
+    uint8_t msgid;
+    uint32_t rxCount;
+    uint32_t rxBytes;
+    uint32_t txCount[MAVLINK_STATS_CHANNELS];
+    uint32_t txBytes[MAVLINK_STATS_CHANNELS];
+    uint32_t txDropped[MAVLINK_STATS_CHANNELS];  // Messages that didn't fit into the queue.
+} MavlinkMessageStats;
+
+/**
+ * Statistics for a single remote system on a single channel.
+ */
+typedef struct {
+    uint8_t channel;
+    uint8_t sysid;
+    uint8_t lastSeq;  // The sequence number of the last message received.
+    uint32_t received;
+    uint32_t lost;    // Estimated from gaps in the sequence numbers.
+} MavlinkSystemStats;
+
+/**
+ * Clears all statistics.
+ */
+void MavlinkStatsInit(void);
+
+/**
+ * Records a successfully-parsed message.
+ * @param channel The channel the message was received on. Must be < MAVLINK_STATS_CHANNELS.
+ * @param sysid The system ID of the sender.
+ * @param msgid The ID of the message.
+ * @param seq The sequence number of the message.
+ * @param size The size of the message in bytes, including the header and checksum.
+ */
+void MavlinkStatsRecordRx(uint8_t channel, uint8_t sysid, uint8_t msgid, uint8_t seq, uint16_t size);
+
+/**
+ * Records messages that failed to parse.
+ * @param channel The channel the messages were received on. Must be < MAVLINK_STATS_CHANNELS.
+ * @param count The number of failures, usually the `packet_rx_drop_count` of the parser status.
+ */
+void MavlinkStatsRecordRxErrors(uint8_t channel, uint8_t count);
+
+/**
+ * Records a message queued for transmission.
+ * @param channel The channel the message was written to. Must be < MAVLINK_STATS_CHANNELS.
+ * @param msgid The ID of the message.
+ * @param size The size of the message in bytes, including the header and checksum.
+ */
+void MavlinkStatsRecordTx(uint8_t channel, uint8_t msgid, uint16_t size);
+
+/**
+ * Records a message that was dropped instead of transmitted because the channel's queue was full.
+ * @param channel The channel the message was written to. Must be < MAVLINK_STATS_CHANNELS.
+ * @param msgid The ID of the message.
+ */
+void MavlinkStatsRecordTxDropped(uint8_t channel, uint8_t msgid);
+
+/**
+ * @param channel The channel to query.
+ * @return The total number of messages received successfully on this channel.
+ */
+uint32_t MavlinkStatsGetRxTotal(uint8_t channel);
+
+/**
+ * @param channel The channel to query.
+ * @return The total number of messages that failed to parse on this channel.
+ */
+uint32_t MavlinkStatsGetRxErrors(uint8_t channel);
+
+/**
+ * @return The number of messages received or transmitted that weren't counted in the message
+ *         table because it was full.
+ */
+uint32_t MavlinkStatsGetUntracked(void);
+
+/**
+ * @return The number of message IDs in the message table.
+ */
+uint8_t MavlinkStatsGetMessageCount(void);
+
+/**
+ * Retrieves the statistics for an entry in the message table.
+ * @param index The index into the message table, [0, MavlinkStatsGetMessageCount()).
+ * @param stats The statistics for this entry.
+ * @return True if there was an entry at this index.
+ */
+bool MavlinkStatsGetMessage(uint8_t index, MavlinkMessageStats *stats);
+
+/**
+ * Retrieves the statistics for a given message ID.
+ * @param msgid The message ID to look up.
+ * @param stats The statistics for this message ID.
+ * @return True if this message ID has been seen.
+ */
+bool MavlinkStatsFindMessage(uint8_t msgid, MavlinkMessageStats *stats);
+
+/**
+ * @return The number of remote systems in the system table.
+ */
+uint8_t MavlinkStatsGetSystemCount(void);
+
+/**
+ * Retrieves the statistics for an entry in the system table.
+ * @param index The index into the system table, [0, MavlinkStatsGetSystemCount()).
+ * @param stats The statistics for this entry.
+ * @return True if there was an entry at this index.
+ */
+bool MavlinkStatsGetSystem(uint8_t index, MavlinkSystemStats *stats);
+
+#endif // MAVLINK_STATS_H
@@ -0,0 +1,317 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses.
+ */
+
+/**
+ * @file
+ * @brief Implements the compact mission store declared in MissionStore.h.
+ *
+ * Unit testing has been completed on x86 by compiling with the UNIT_TEST_MISSION_STORE macro.
+ * With gcc: `gcc MissionStore.c -DUNIT_TEST_MISSION_STORE -Wall -g`
+ */
+#include "MissionStore.h"
+#include "Types.h"
+
+#include <stddef.h>
+
+// Positions are stored in units of decimeters.
+#define POSITION_SCALE 10.0f
+
+// Parameters are stored in units of 0.1.
+#define PARAMETER_SCALE 10.0f
+
+// The int16 value used to store a NaN coordinate or parameter, which QGroundControl uses for
+// "unspecified".
+#define QUANTIZED_NAN INT16_MIN
+
+// The autocontinue flag is stored in the top bit of the flags byte, with the index into the
+// parameter set table stored in the rest.
+#define FLAGS_AUTOCONTINUE 0x80
+#define FLAGS_PARAM_SET_MASK 0x7F
+
+/**
+ * The stored version of a Mission. 8 bytes on both the dsPIC and x86.
+ */
+typedef struct {
+    int16_t ned[3];  // Position in the local North-East-Down frame in decimeters.
+    uint8_t action;  // One of MAV_CMD_*
+    uint8_t flags;   // Autocontinue and the index of this mission's parameters.
+} CompactMission;
+
+/**
+ * A set of quantized mission parameters that can be shared between missions.
+ */
+typedef struct {
+    int16_t values[4];
+} ParamSet;
+
+static CompactMission missions[MISSION_STORE_CAPACITY];
+static uint16_t missionCount;
+
+static ParamSet paramSets[MISSION_STORE_PARAM_SETS];
+static uint8_t paramSetCount;
+
+static void (*ltp2llaFunc)(const float ltp[3], int32_t lla[3]);
+
+/**
+ * Quantizes a float into an int16 in the given units, rounding to the nearest value. NaNs are
+ * stored as QUANTIZED_NAN.
+ * @return False if the value can't be represented.
+ */
+static bool Quantize(float value, float scale, int16_t *out)
+{
+    // NaNs are the only values not equal to themselves. They'd also fail every range check below.
+    if (value != value) {
+        *out = QUANTIZED_NAN;
+        return true;
+    }
+
+    const float scaled = value * scale;
+
+    // Reserve INT16_MIN as the NaN marker, so limit the range to be symmetric.
+    if (scaled >= 32767.5f || scaled <= -32767.5f) {
+        return false;
+    }
+    *out = (int16_t)(scaled >= 0.0f ? scaled + 0.5f : scaled - 0.5f);
+    return true;
+}
+
+/**
+ * Converts a value quantized by Quantize() back into a float.
+ */
+static float Unquantize(int16_t value, float scale)
+{
+    return (value == QUANTIZED_NAN) ? NAN : (float)value / scale;
+}
+
+/**
+ * Finds the given parameters in the parameter set table, adding them if necessary.
+ * @return The index of the parameter set or -1 if the parameters couldn't be stored.
+ */
+static int8_t FindOrAddParamSet(const float parameters[4])
+{
+    ParamSet p;
+    uint8_t i;
+    for (i = 0; i < 4; ++i) {
+        if (!Quantize(parameters[i], PARAMETER_SCALE, &p.values[i])) {
+            return -1;
+        }
+    }
+
+    // Missions usually share parameters with the ones right before them, so search backwards.
+    for (i = paramSetCount; i > 0; --i) {
+        const ParamSet *q = &paramSets[i - 1];
+        if (q->values[0] == p.values[0] && q->values[1] == p.values[1] &&
+            q->values[2] == p.values[2] && q->values[3] == p.values[3]) {
+            return (int8_t)(i - 1);
+        }
+    }
+
+    if (paramSetCount >= MISSION_STORE_PARAM_SETS) {
+        return -1;
+    }
+    paramSets[paramSetCount] = p;
+    return (int8_t)paramSetCount++;
+}
+
+void MissionStoreInit(void (*Ltp2Lla)(const float ltp[3], int32_t lla[3]))
+{
+    ltp2llaFunc = Ltp2Lla;
+    MissionStoreClear();
+}
+
+void MissionStoreClear(void)
+{
+    missionCount = 0;
+    paramSetCount = 0;
+}
+
+bool MissionStoreAppend(const Mission *m)
+{
+    if (!m || missionCount >= MISSION_STORE_CAPACITY) {
+        return false;
+    }
+
+    CompactMission c;
+    uint8_t i;
+    for (i = 0; i < 3; ++i) {
+        if (!Quantize(m->coordinates[i], POSITION_SCALE, &c.ned[i])) {
+            return false;
+        }
+    }
+
+    // Only add the parameter set after we know the rest of the mission is valid, so that failed
+    // appends don't use up entries in the table.
+    const int8_t paramSet = FindOrAddParamSet(m->parameters);
+    if (paramSet < 0) {
+        return false;
+    }
+
+    c.action = m->action;
+    c.flags = (uint8_t)paramSet & FLAGS_PARAM_SET_MASK;
+    if (m->autocontinue) {
+        c.flags |= FLAGS_AUTOCONTINUE;
+    }
+
+    missions[missionCount++] = c;
+    return true;
+}
+
+bool MissionStoreGet(uint16_t index, Mission *m)
+{
+    if (!m || index >= missionCount) {
+        return false;
+    }
+
+    const CompactMission *c = &missions[index];
+    const ParamSet *p = &paramSets[c->flags & FLAGS_PARAM_SET_MASK];
+
+    uint8_t i;
+    for (i = 0; i < 3; ++i) {
+        m->coordinates[i] = Unquantize(c->ned[i], POSITION_SCALE);
+    }
+    for (i = 0; i < 4; ++i) {
+        m->parameters[i] = Unquantize(p->values[i], PARAMETER_SCALE);
+    }
+    m->refFrame = MISSION_STORE_FRAME_LOCAL_NED;
+    m->action = c->action;
+    m->autocontinue = (c->flags & FLAGS_AUTOCONTINUE) ? 1 : 0;
+
+    // Recompute the global coordinates, which are stored as 1e-7 degrees and millimeters. Unspecified
+    // coordinates are converted as 0 and stay unspecified.
+    if (ltp2llaFunc) {
+        float ltp[3];
+        for (i = 0; i < 3; ++i) {
+            ltp[i] = (c->ned[i] == QUANTIZED_NAN) ? 0.0f : m->coordinates[i];
+        }
+        int32_t lla[3];
+        ltp2llaFunc(ltp, lla);
+        m->otherCoordinates[0] = (float)lla[0] / 1e7f;
+        m->otherCoordinates[1] = (float)lla[1] / 1e7f;
+        m->otherCoordinates[2] = (float)lla[2] / 1e3f;
+        for (i = 0; i < 3; ++i) {
+            if (c->ned[i] == QUANTIZED_NAN) {
+                m->otherCoordinates[i] = NAN;
+            }
+        }
+    } else {
+        m->otherCoordinates[0] = 0.0f;
+        m->otherCoordinates[1] = 0.0f;
+        m->otherCoordinates[2] = 0.0f;
+    }
+
+    return true;
+}
+
+uint16_t MissionStoreCount(void)
+{
+    return missionCount;
+}
+
+#ifdef UNIT_TEST_MISSION_STORE
+
+#include <stdio.h>
+#include <assert.h>
+#include <math.h>
+
+// A simple flat-earth conversion around a fixed origin for testing.
+static void TestLtp2Lla(const float ltp[3], int32_t lla[3])
+{
+    lla[0] = (int32_t)(ltp[0] / 0.0111f) + 423000000;
+    lla[1] = (int32_t)(ltp[1] / 0.0082f) - 711000000;
+    lla[2] = (int32_t)(ltp[2] * -1000.0f);
+}
+
+int main()
+{
+    printf("Testing MissionStore.c. All errors will be reported as failed assertions.\n");
+
+    MissionStoreInit(TestLtp2Lla);
+    assert(MissionStoreCount() == 0);
+
+    Mission m = {
+        {12.34f, -567.89f, 0.0f},
+        {0.0f, 0.0f, 0.0f},
+        MISSION_STORE_FRAME_LOCAL_NED,
+        16,
+        {0.0f, 5.0f, 0.0f, NAN},
+        1
+    };
+    Mission out;
+
+    // Check that a mission round-trips within the quantization error.
+    assert(MissionStoreAppend(&m));
+    assert(MissionStoreCount() == 1);
+    assert(MissionStoreGet(0, &out));
+    assert(fabsf(out.coordinates[0] - 12.3f) < 0.01f);
+    assert(fabsf(out.coordinates[1] + 567.9f) < 0.01f);
+    assert(out.coordinates[2] == 0.0f);
+    assert(out.parameters[1] == 5.0f);
+    assert(isnan(out.parameters[3]));
+    assert(out.action == 16);
+    assert(out.autocontinue == 1);
+    assert(out.refFrame == MISSION_STORE_FRAME_LOCAL_NED);
+    assert(fabsf(out.otherCoordinates[0] - 42.30011f) < 0.00001f);
+    assert(!MissionStoreGet(1, &out));
+
+    // Unspecified coordinates stay unspecified, without affecting the others.
+    m.coordinates[2] = NAN;
+    assert(MissionStoreAppend(&m));
+    assert(MissionStoreGet(1, &out));
+    assert(isnan(out.coordinates[2]) && isnan(out.otherCoordinates[2]));
+    assert(fabsf(out.coordinates[0] - 12.3f) < 0.01f);
+    assert(fabsf(out.otherCoordinates[0] - 42.30011f) < 0.00001f);
+    MissionStoreClear();
+    m.coordinates[2] = 0.0f;
+    assert(MissionStoreAppend(&m));
+
+    // Out-of-range coordinates should be rejected without being stored.
+    m.coordinates[0] = 4000.0f;
+    assert(!MissionStoreAppend(&m));
+    assert(MissionStoreCount() == 1);
+    m.coordinates[0] = 0.0f;
+
+    // Missions sharing parameters should all fit until capacity is reached.
+    while (MissionStoreCount() < MISSION_STORE_CAPACITY) {
+        m.coordinates[1] = (float)MissionStoreCount();
+        m.autocontinue = MissionStoreCount() & 1;
+        assert(MissionStoreAppend(&m));
+    }
+    assert(!MissionStoreAppend(&m));
+    assert(MissionStoreGet(MISSION_STORE_CAPACITY - 1, &out));
+    assert(out.coordinates[1] == (float)(MISSION_STORE_CAPACITY - 1));
+    assert(out.autocontinue == 1);
+
+    // The parameter set table should also limit how many unique parameters can be stored.
+    MissionStoreClear();
+    uint8_t i;
+    for (i = 0; i < MISSION_STORE_PARAM_SETS; ++i) {
+        m.parameters[0] = (float)i;
+        assert(MissionStoreAppend(&m));
+    }
+    m.parameters[0] = 100.0f;
+    assert(!MissionStoreAppend(&m));
+    m.parameters[0] = 3.0f;
+    assert(MissionStoreAppend(&m));
+    assert(MissionStoreGet(MISSION_STORE_PARAM_SETS, &out));
+    assert(out.parameters[0] == 3.0f);
+
+    assert(sizeof(CompactMission) == 8);
+
+    printf("All tests passed.\n");
+
+    return 0;
+}
+
+#endif // UNIT_TEST_MISSION_STORE
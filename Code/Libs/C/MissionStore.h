@@ -0,0 +1,106 @@
+#ifndef MISSION_STORE_H
+#define MISSION_STORE_H
+
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses.
+ */
+
+/**
+ * @file
+ * @brief A compact, RAM-efficient storage backend for missions.
+ *
+ * # Dependencies
+ *  * Missions library (Missions.h) for the expanded `Mission` struct.
+ *  * A local-to-global conversion function, like ltp2lla() in MavlinkGlue.c.
+ *
+ * # Usage
+ * The plain `Mission` struct keeps 14 floats per waypoint, including a second copy of the
+ * coordinates in the other reference frame. This library stores missions much more compactly:
+ *  * The position is kept only in the local North-East-Down frame relative to the GPS origin, as
+ *    int16s in units of decimeters. This limits waypoints to +-3276.7m from the origin.
+ *  * The global coordinates are never stored, they're recomputed on demand by the conversion
+ *    function passed to MissionStoreInit().
+ *  * The 4 parameters are quantized to int16s in units of 0.1 and deduplicated into a small table
+ *    of parameter sets. Nearly every waypoint in a survey mission shares the same parameters, so
+ *    each mission only stores an index into this table.
+ *  * NaN coordinates and parameters, which QGroundControl sends for unspecified values, are kept
+ *    as NaN. The global coordinates of NaN local coordinates are NaN.
+ *
+ * Each mission uses 8 bytes plus a share of the parameter set table, compared to the 44+ bytes of
+ * a `Mission`, so MISSION_STORE_CAPACITY missions fit in less RAM than a quarter as many `Mission`s.
+ * Missions are stored in a flat array so all accesses by index are O(1).
+ *
+ * Call MissionStoreInit() first. Then missions can be added with MissionStoreAppend() and expanded
+ * back out into `Mission` structs with MissionStoreGet(). Note that all missions should be
+ * converted to the local NED frame before being appended, and they will always be returned in that
+ * frame with the global coordinates available in `otherCoordinates`.
+ */
+
+#include "Missions.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * The maximum number of missions that can be stored.
+ */
+#define MISSION_STORE_CAPACITY 64
+
+/**
+ * The maximum number of unique parameter sets that can be stored across all missions.
+ */
+#define MISSION_STORE_PARAM_SETS 16
+
+/**
+ * The reference frame all stored missions are in. This matches MAV_FRAME_LOCAL_NED from MAVLink.
+ */
+#define MISSION_STORE_FRAME_LOCAL_NED 1
+
+/**
+ * Initializes the mission store, clearing any existing missions.
+ * @param Ltp2Lla A function that converts North-East-Down coordinates in meters relative to the
+ *                origin into global coordinates as 1e-7 degrees latitude, 1e-7 degrees longitude,
+ *                and millimeters altitude. If NULL, global coordinates are returned as 0.
+ */
+void MissionStoreInit(void (*Ltp2Lla)(const float ltp[3], int32_t lla[3]));
+
+/**
+ * Removes all missions and parameter sets from the store.
+ */
+void MissionStoreClear(void);
+
+/**
+ * Adds a mission onto the end of the mission list. The `coordinates` of the mission must already
+ * be in the local NED frame, `otherCoordinates` and `refFrame` are ignored.
+ * @param m The mission to add.
+ * @return True if the mission was stored. False if the store or the parameter set table is full,
+ *         or if the mission's coordinates or parameters are outside of the representable range.
+ */
+bool MissionStoreAppend(const Mission *m);
+
+/**
+ * Retrieves a mission from the store, expanding it back into a `Mission` struct. The global
+ * coordinates are recomputed and returned in `otherCoordinates` in degrees and meters.
+ * @param index The index of the mission to retrieve.
+ * @param m The mission struct to fill.
+ * @return True if there was a mission at that index, false otherwise.
+ */
+bool MissionStoreGet(uint16_t index, Mission *m);
+
+/**
+ * @return The number of missions currently stored.
+ */
+uint16_t MissionStoreCount(void);
+
+#endif // MISSION_STORE_H
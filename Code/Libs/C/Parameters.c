@@ -3,6 +3,10 @@
 #include <stdint.h>
 #include <string.h>
 
+// A bit for every parameter that's set once it's been persisted and cleared when it's changed. Kept
+// inverted so that all parameters start out dirty, as nothing is known about what's been persisted.
+static uint8_t parameterClean[(PARAMETERS_MAX + 7) / 8];
+
 /**
  * Defines all of the work necessary for updating a parameter based on the onboardParameters array.
  * @param type A valid C datatype.
@@ -65,6 +69,7 @@ void ParameterSetValueById(uint16_t id, const void *value)
 			default:
 				break;
 		}
+		ParameterChanged(id);
 	}
 }
 
@@ -134,4 +139,52 @@ uint16_t ParameterGetValueByName(const char *name, void *value)
 
 	// Otherwise return an error code.
 	return UINT16_MAX;
-}
\ No newline at end of file
+}
+
+void ParameterMarkDirty(uint16_t id)
+{
+	if (id < PARAMETERS_MAX) {
+		parameterClean[id / 8] &= ~(1 << (id % 8));
+	}
+}
+
+void ParameterChanged(uint16_t id)
+{
+	if (id < PARAMETERS_TOTAL) {
+		ParameterMarkDirty(id);
+		if (onboardParameters[id].OnChanged) {
+			onboardParameters[id].OnChanged(id);
+		}
+	}
+}
+
+void ParameterMarkAllDirty(void)
+{
+	memset(parameterClean, 0, sizeof(parameterClean));
+}
+
+void ParameterClearDirty(uint16_t id)
+{
+	if (id < PARAMETERS_MAX) {
+		parameterClean[id / 8] |= 1 << (id % 8);
+	}
+}
+
+bool ParameterIsDirty(uint16_t id)
+{
+	if (id < PARAMETERS_MAX) {
+		return (parameterClean[id / 8] & (1 << (id % 8))) == 0;
+	}
+	return true;
+}
+
+bool ParameterAnyDirty(void)
+{
+	uint16_t i;
+	for (i = 0; i < PARAMETERS_TOTAL; ++i) {
+		if (ParameterIsDirty(i)) {
+			return true;
+		}
+	}
+	return false;
+}
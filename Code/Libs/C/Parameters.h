@@ -13,8 +13,27 @@
  * as well as the onboardParameters array. The onboardParameters array will be an array of Parameter
  * structs. Note that all variables should either have a direct data pointer xor setter/getter
  * functions. For read-only parameters, not defining a Setter function is acceptable.
+ *
+ * Every parameter changed through ParameterSetValueById() or ParameterSetValueByName() is marked
+ * as dirty, so that a storage backend (like the DataStore library) only has to persist the ones that
+ * actually changed. Code that changes a parameter's variable directly should call
+ * ParameterChanged() itself if that change should be persisted.
+ *
+ * A parameter can also have an OnChanged() observer, called every time its value is set through
+ * this library (including when a storage backend loads it) or ParameterChanged() is called for it.
+ * Values derived from parameters, like scale factors, can be recomputed there once per change
+ * instead of every time they're used.
  */
 #include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * The most parameters the dirty tracking supports. PARAMETERS_TOTAL must not be larger than this.
+ * Parameters with higher IDs are always reported as dirty.
+ */
+#ifndef PARAMETERS_MAX
+#define PARAMETERS_MAX 64
+#endif
 
 /**
  * Declare the various datatypes supported by the parameter interface. UINT refers to unsigned
@@ -42,7 +61,8 @@ enum PARAMETERS_DATATYPE {
  * Note that data OR setter/getter should be set for variables' data indicates
  * that the data pointer can be directly accessed. Otherwise the setter/getter
  * functions should be used instead. Setter functions should look like `void F(DATATYPE)` while
- * getter functions should look like `DATATYPE F(void)`.
+ * getter functions should look like `DATATYPE F(void)`. The optional OnChanged function is called
+ * with the parameter's ID after its value changed.
  */
 typedef struct Parameter {
     const char name[17];
@@ -50,6 +70,7 @@ typedef struct Parameter {
     void (*Setter)(void);
     void (*Getter)(void);
     const enum PARAMETERS_DATATYPE dataType;
+    void (*OnChanged)(uint16_t id);
 } Parameter;
 
 // The total number of parameters onboard. This should be set by external code written by the user
@@ -93,4 +114,42 @@ uint16_t ParameterGetValueByName(const char *name, void *value);
  */
 void ParameterGetValueById(uint16_t id, void *value);
 
+/**
+ * Marks a parameter as changed since it was last persisted.
+ * @param id The ID of the parameter.
+ */
+void ParameterMarkDirty(uint16_t id);
+
+/**
+ * Signals that a parameter's value changed, marking it as dirty and calling its OnChanged()
+ * observer. Called by ParameterSetValueById(), and by code that changes a parameter's variable
+ * directly.
+ * @param id The ID of the parameter.
+ */
+void ParameterChanged(uint16_t id);
+
+/**
+ * Marks every parameter as changed since it was last persisted.
+ */
+void ParameterMarkAllDirty(void);
+
+/**
+ * Marks a parameter as persisted. Called by the storage backend once it has saved or loaded it.
+ * @param id The ID of the parameter.
+ */
+void ParameterClearDirty(uint16_t id);
+
+/**
+ * Checks whether a parameter has changed since it was last persisted.
+ * @param id The ID of the parameter.
+ * @return True if it has changed or if it's beyond PARAMETERS_MAX.
+ */
+bool ParameterIsDirty(uint16_t id);
+
+/**
+ * Checks whether any parameter has changed since it was last persisted.
+ * @return True if any ParameterIsDirty() would return true.
+ */
+bool ParameterAnyDirty(void);
+
 #endif // PARAMETERS_H
@@ -0,0 +1,296 @@
+#include "SensorHistory.h"
+
+// Keep the compiler from moving the sample accesses to the other side of the sequence number
+// accesses, see Snapshot.c.
+#define SENSOR_HISTORY_BARRIER() __asm__ volatile("" ::: "memory")
+
+void SensorHistoryInit(SensorHistory *h, uint8_t valueCount, int32_t period, uint8_t wrapping)
+{
+    h->head = 0;
+    h->count = 0;
+    h->valueCount = (valueCount < SENSOR_HISTORY_VALUES) ? valueCount : SENSOR_HISTORY_VALUES;
+    h->period = period;
+    h->wrapping = period ? wrapping : 0;
+    h->sequence = 0;
+}
+
+/**
+ * @return The period value i wraps around at, 0 if it doesn't.
+ */
+static int32_t ValuePeriod(const SensorHistory *h, uint8_t i)
+{
+    return (h->wrapping & (1 << i)) ? h->period : 0;
+}
+
+bool SensorHistoryAdd(SensorHistory *h, uint32_t time, const int32_t *values)
+{
+    // Times are compared by their difference so the clock can wrap around. A sample from before
+    // the newest one is dropped, unless it's from before the whole history. Then it's much more
+    // likely that the sensor was silent for over half the clock's range, so the history restarts.
+    bool restart = false;
+    if (h->count) {
+        const uint8_t newest = (h->head + SENSOR_HISTORY_LENGTH - 1) % SENSOR_HISTORY_LENGTH;
+        const uint8_t oldest = (h->head + SENSOR_HISTORY_LENGTH - h->count) % SENSOR_HISTORY_LENGTH;
+        const uint32_t behind = h->samples[newest].time - time;
+        if ((int32_t)behind > 0) {
+            if (behind <= h->samples[newest].time - h->samples[oldest].time) {
+                return false;
+            }
+            restart = true;
+        }
+    }
+
+    ++h->sequence;
+    SENSOR_HISTORY_BARRIER();
+    if (restart) {
+        h->count = 0;
+    }
+    SensorSample *s = &h->samples[h->head];
+    s->time = time;
+    uint8_t i;
+    for (i = 0; i < h->valueCount; ++i) {
+        // Keep wrapping values within [-period / 2, period / 2).
+        const int32_t period = ValuePeriod(h, i);
+        int32_t value = values[i];
+        if (period) {
+            value %= period;
+            if (value >= period - period / 2) {
+                value -= period;
+            } else if (value < -(period / 2)) {
+                value += period;
+            }
+        }
+        s->values[i] = value;
+    }
+    h->head = (h->head + 1) % SENSOR_HISTORY_LENGTH;
+    if (h->count < SENSOR_HISTORY_LENGTH) {
+        ++h->count;
+    }
+    SENSOR_HISTORY_BARRIER();
+    ++h->sequence;
+    return true;
+}
+
+/**
+ * Interpolates a value of sample a towards sample b.
+ * @param period The period the value wraps around at, 0 if it doesn't.
+ * @param elapsed The time since sample a, which is within the time between the samples.
+ */
+static int32_t Interpolate(int32_t period, int32_t a, int32_t b, uint32_t elapsed, uint32_t span)
+{
+    int64_t diff = (int64_t)b - a;
+    if (period) {
+        // Go the short way around.
+        const int64_t half = period / 2;
+        while (diff >= half) {
+            diff -= period;
+        }
+        while (diff < -half) {
+            diff += period;
+        }
+    }
+
+    int64_t value = a + diff * (int64_t)elapsed / (int64_t)span;
+    if (period) {
+        const int64_t half = period / 2;
+        if (value >= half) {
+            value -= period;
+        } else if (value < -half) {
+            value += period;
+        }
+    }
+    return (int32_t)value;
+}
+
+SensorHistoryResult SensorHistoryAt(const SensorHistory *h, uint32_t time, SensorHistoryMode mode,
+                                    int32_t *values)
+{
+    int32_t found[SENSOR_HISTORY_VALUES];
+    SensorHistoryResult result;
+    uint16_t sequence;
+    uint8_t i;
+    do {
+        // Wait out a sample being added, which only happens if the writer was interrupted.
+        sequence = h->sequence;
+        if (sequence & 1) {
+            continue;
+        }
+        SENSOR_HISTORY_BARRIER();
+
+        // Find the newest sample at or before the time, stepping back from the newest.
+        result = SENSOR_HISTORY_NONE;
+        uint8_t n;
+        uint8_t newer = h->head;
+        for (n = 0; n < h->count; ++n) {
+            const uint8_t index = (h->head + SENSOR_HISTORY_LENGTH - 1 - n) % SENSOR_HISTORY_LENGTH;
+            const SensorSample *s = &h->samples[index];
+            const uint32_t elapsed = time - s->time;
+            if ((int32_t)elapsed < 0) {
+                newer = index;
+                continue;
+            }
+
+            // Hold the sample if asked to, if it's the newest one, or if it's exactly at the time.
+            if (mode == SENSOR_HISTORY_HOLD || n == 0 || elapsed == 0) {
+                for (i = 0; i < h->valueCount; ++i) {
+                    found[i] = s->values[i];
+                }
+                result = SENSOR_HISTORY_HELD;
+            } else {
+                const SensorSample *next = &h->samples[newer];
+                const uint32_t span = next->time - s->time;
+                for (i = 0; i < h->valueCount; ++i) {
+                    found[i] = Interpolate(ValuePeriod(h, i), s->values[i], next->values[i],
+                                           elapsed, span);
+                }
+                result = SENSOR_HISTORY_INTERPOLATED;
+            }
+            break;
+        }
+        SENSOR_HISTORY_BARRIER();
+    } while (sequence != h->sequence || (sequence & 1));
+
+    if (result != SENSOR_HISTORY_NONE) {
+        for (i = 0; i < h->valueCount; ++i) {
+            values[i] = found[i];
+        }
+    }
+    return result;
+}
+
+#ifdef UNIT_TEST_SENSOR_HISTORY
+
+#include <stdio.h>
+#include <assert.h>
+
+int main()
+{
+    printf("Running unit tests.\n");
+
+    SensorHistory h;
+    int32_t v[SENSOR_HISTORY_VALUES];
+    int32_t s[SENSOR_HISTORY_VALUES];
+
+    // Nothing's covered when empty.
+    SensorHistoryInit(&h, 2, 0, 0);
+    assert(SensorHistoryAt(&h, 100, SENSOR_HISTORY_INTERPOLATE, v) == SENSOR_HISTORY_NONE);
+
+    // A single sample is held from its time on.
+    s[0] = 1000;
+    s[1] = -1000;
+    assert(SensorHistoryAdd(&h, 100, s));
+    assert(SensorHistoryAt(&h, 99, SENSOR_HISTORY_INTERPOLATE, v) == SENSOR_HISTORY_NONE);
+    assert(SensorHistoryAt(&h, 100, SENSOR_HISTORY_INTERPOLATE, v) == SENSOR_HISTORY_HELD);
+    assert(v[0] == 1000 && v[1] == -1000);
+    assert(SensorHistoryAt(&h, 500, SENSOR_HISTORY_INTERPOLATE, v) == SENSOR_HISTORY_HELD);
+    assert(v[0] == 1000 && v[1] == -1000);
+
+    // Interpolate between samples, or hold the older one.
+    s[0] = 2000;
+    s[1] = -3000;
+    assert(SensorHistoryAdd(&h, 200, s));
+    assert(SensorHistoryAt(&h, 125, SENSOR_HISTORY_INTERPOLATE, v) == SENSOR_HISTORY_INTERPOLATED);
+    assert(v[0] == 1250 && v[1] == -1500);
+    assert(SensorHistoryAt(&h, 125, SENSOR_HISTORY_HOLD, v) == SENSOR_HISTORY_HELD);
+    assert(v[0] == 1000 && v[1] == -1000);
+    assert(SensorHistoryAt(&h, 200, SENSOR_HISTORY_INTERPOLATE, v) == SENSOR_HISTORY_HELD);
+    assert(v[0] == 2000 && v[1] == -3000);
+    assert(SensorHistoryAt(&h, 300, SENSOR_HISTORY_INTERPOLATE, v) == SENSOR_HISTORY_HELD);
+    assert(v[0] == 2000);
+
+    // Samples from the past are dropped, ones at the same time are kept.
+    assert(!SensorHistoryAdd(&h, 150, s));
+    assert(!SensorHistoryAdd(&h, 100, s));
+    assert(SensorHistoryAdd(&h, 200, s));
+    assert(h.count == 3);
+
+    // But a sample from before the whole history comes after the clock wrapped around during a
+    // long silence, so the history restarts from it.
+    const uint32_t later = 200 + 0x90000000UL;
+    s[0] = 5000;
+    assert(SensorHistoryAdd(&h, later, s));
+    assert(h.count == 1);
+    assert(SensorHistoryAt(&h, later + 50, SENSOR_HISTORY_INTERPOLATE, v) == SENSOR_HISTORY_HELD);
+    assert(v[0] == 5000);
+    assert(SensorHistoryAt(&h, later - 1, SENSOR_HISTORY_INTERPOLATE, v) == SENSOR_HISTORY_NONE);
+    assert(SensorHistoryAdd(&h, later + 100, s));
+    assert(h.count == 2);
+
+    // GPS coordinates in 1e-7 degrees keep their precision.
+    SensorHistoryInit(&h, 2, 0, 0);
+    s[0] = 374123457;
+    s[1] = -1220654321;
+    SensorHistoryAdd(&h, 0, s);
+    s[0] = 374123467;
+    s[1] = -1220654311;
+    SensorHistoryAdd(&h, 31250, s);
+    assert(SensorHistoryAt(&h, 15625, SENSOR_HISTORY_INTERPOLATE, v) == SENSOR_HISTORY_INTERPOLATED);
+    assert(v[0] == 374123462 && v[1] == -1220654316);
+
+    // Old samples roll off once the history is full, and the clock can wrap around.
+    SensorHistoryInit(&h, 1, 0, 0);
+    uint32_t t = UINT32_MAX - 250;
+    int i;
+    for (i = 0; i < SENSOR_HISTORY_LENGTH + 2; ++i) {
+        s[0] = i * 10;
+        assert(SensorHistoryAdd(&h, t + i * 100, s));
+    }
+    assert(h.count == SENSOR_HISTORY_LENGTH);
+    assert(SensorHistoryAt(&h, t + 150, SENSOR_HISTORY_INTERPOLATE, v) == SENSOR_HISTORY_NONE);
+    assert(SensorHistoryAt(&h, t + 200, SENSOR_HISTORY_INTERPOLATE, v) == SENSOR_HISTORY_HELD);
+    assert(v[0] == 20);
+    assert(SensorHistoryAt(&h, t + 250, SENSOR_HISTORY_INTERPOLATE, v) == SENSOR_HISTORY_INTERPOLATED);
+    assert(v[0] == 25);
+    assert(SensorHistoryAt(&h, t + 350, SENSOR_HISTORY_INTERPOLATE, v) == SENSOR_HISTORY_INTERPOLATED);
+    assert(v[0] == 35);
+    assert(SensorHistoryAt(&h, t + 950, SENSOR_HISTORY_INTERPOLATE, v) == SENSOR_HISTORY_HELD);
+    assert(v[0] == 90);
+
+    // Angles go the short way around, in the Tokimec's units of 1/8192 radians.
+    const int32_t period = 51472;
+    SensorHistoryInit(&h, 1, period, 1);
+    s[0] = 25000;
+    SensorHistoryAdd(&h, 0, s);
+    s[0] = -25000;
+    SensorHistoryAdd(&h, 100, s);
+    assert(SensorHistoryAt(&h, 50, SENSOR_HISTORY_INTERPOLATE, v) == SENSOR_HISTORY_INTERPOLATED);
+    assert(v[0] == -25736);
+    assert(SensorHistoryAt(&h, 25, SENSOR_HISTORY_INTERPOLATE, v) == SENSOR_HISTORY_INTERPOLATED);
+    assert(v[0] == 25368);
+    assert(SensorHistoryAt(&h, 75, SENSOR_HISTORY_INTERPOLATE, v) == SENSOR_HISTORY_INTERPOLATED);
+    assert(v[0] == -25368);
+
+    // Angles are normalized as they're added, so the top of the range is the bottom.
+    SensorHistoryInit(&h, 3, period, 1);
+    s[0] = 25736;
+    s[1] = 25736;
+    s[2] = -25737;
+    SensorHistoryAdd(&h, 0, s);
+    s[0] = 3 * 51472 + 10;
+    s[1] = 25000;
+    s[2] = -25000;
+    SensorHistoryAdd(&h, 100, s);
+    assert(SensorHistoryAt(&h, 0, SENSOR_HISTORY_INTERPOLATE, v) == SENSOR_HISTORY_HELD);
+    assert(v[0] == -25736);
+
+    // Only the values in the mask wrap, the others like pitch and roll are kept and interpolated
+    // as they are.
+    assert(v[1] == 25736 && v[2] == -25737);
+    assert(SensorHistoryAt(&h, 50, SENSOR_HISTORY_INTERPOLATE, v) == SENSOR_HISTORY_INTERPOLATED);
+    assert(v[0] == 12873 && v[1] == 25368 && v[2] == -25369);
+
+    // But they interpolate normally away from the wrap.
+    SensorHistoryInit(&h, 1, period, 1);
+    s[0] = -100;
+    SensorHistoryAdd(&h, 0, s);
+    s[0] = 100;
+    SensorHistoryAdd(&h, 100, s);
+    assert(SensorHistoryAt(&h, 75, SENSOR_HISTORY_INTERPOLATE, v) == SENSOR_HISTORY_INTERPOLATED);
+    assert(v[0] == 50);
+
+    printf("All tests passed.\n");
+
+    return 0;
+}
+
+#endif // UNIT_TEST_SENSOR_HISTORY
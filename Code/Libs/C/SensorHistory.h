@@ -0,0 +1,125 @@
+#ifndef SENSOR_HISTORY_H
+#define SENSOR_HISTORY_H
+
+/**
+ * @file
+ * @brief Keeps the recent timestamped samples of a sensor, to look up its value at any time.
+ *
+ * # Dependencies
+ * This library has no prerequisites outside of the C standard library. Timestamps are passed in by
+ * the caller from a free-running, wrapping clock, like the one for the Latency library.
+ *
+ * # Usage
+ * Sensors report at their own rates, like GPS at 5Hz, the IMU at 25Hz, and water speed at 1Hz,
+ * none of them aligned to the 100Hz controller. A SensorHistory is a ring of the last
+ * SENSOR_HISTORY_LENGTH samples of a sensor, each with the time it was taken and up to
+ * SENSOR_HISTORY_VALUES values. Values are fixed-point integers, so a GPS position keeps its full
+ * 1e-7 degree precision.
+ *
+ * Initialize a history with SensorHistoryInit() or SENSOR_HISTORY_INIT() and call
+ * SensorHistoryAdd() for every sample, in order of time. A sample that's older than the newest one
+ * is dropped, unless it's further behind it than the history spans. Then the clock has wrapped
+ * all the way around during a long silence of the sensor, so the history is restarted from it.
+ * SensorHistoryAt() then gives the value at
+ * any time covered by the history:
+ *  * SENSOR_HISTORY_HOLD returns the last sample taken at or before that time.
+ *  * SENSOR_HISTORY_INTERPOLATE interpolates linearly between the samples on either side of that
+ *    time, and holds the newest sample for times after it, as there's nothing to interpolate
+ *    towards. It never extrapolates.
+ * Times before the oldest sample aren't covered. Angles can be given a period, so they're
+ * interpolated the short way around, like from 179 degrees to -179 degrees through 180. Only the
+ * values selected by the `wrapping` mask wrap, so a heading can share a history with pitch and
+ * roll. Wrapping values are normalized into [-period / 2, period / 2) as they're added.
+ *
+ * Samples are usually added where sensor data is decoded and looked up by the controller or an
+ * estimator. Like the Snapshot library, there can only be one writer, which must never be
+ * interrupted by a lookup, and a lookup retries if a sample was added while it ran. So nothing
+ * needs to disable interrupts.
+ *
+ * Unit testing has been completed on x86 by compiling with the UNIT_TEST_SENSOR_HISTORY macro.
+ * With gcc: `gcc SensorHistory.c -DUNIT_TEST_SENSOR_HISTORY -Wall -g`
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * The number of samples kept, which at 25Hz covers 320ms.
+ */
+#define SENSOR_HISTORY_LENGTH 8
+
+/**
+ * The most values per sample.
+ */
+#define SENSOR_HISTORY_VALUES 3
+
+typedef struct {
+    uint32_t time;                          // When the sample was taken.
+    int32_t values[SENSOR_HISTORY_VALUES];
+} SensorSample;
+
+typedef struct {
+    SensorSample samples[SENSOR_HISTORY_LENGTH];
+    uint8_t head;                // Where the next sample goes.
+    uint8_t count;               // The number of samples, up to SENSOR_HISTORY_LENGTH.
+    uint8_t valueCount;          // The number of values used in every sample.
+    int32_t period;              // The period the wrapping values wrap around at.
+    uint8_t wrapping;            // A bit for every value that wraps around, from bit 0 for the first.
+    volatile uint16_t sequence;  // Odd while a sample is being added.
+} SensorHistory;
+
+/**
+ * Initializes a SensorHistory like SensorHistoryInit(), for static histories.
+ */
+#define SENSOR_HISTORY_INIT(valueCount, period, wrapping) {{{0}}, 0, 0, (valueCount), (period), (wrapping), 0}
+
+/**
+ * How SensorHistoryAt() looks up values between samples.
+ */
+typedef enum {
+    SENSOR_HISTORY_HOLD = 0,
+    SENSOR_HISTORY_INTERPOLATE
+} SensorHistoryMode;
+
+/**
+ * What SensorHistoryAt() found.
+ */
+typedef enum {
+    SENSOR_HISTORY_NONE = 0,     // The time isn't covered by the history, so there are no values.
+    SENSOR_HISTORY_HELD,         // The values of a sample at or before the time.
+    SENSOR_HISTORY_INTERPOLATED  // The values interpolated between two samples.
+} SensorHistoryResult;
+
+/**
+ * Clears the history.
+ * @param h The history.
+ * @param valueCount The number of values per sample, up to SENSOR_HISTORY_VALUES.
+ * @param period The period the wrapping values wrap around at, like 360 for degrees in
+ *               [-180, 180).
+ * @param wrapping A mask of the values that wrap around at the period, with bit 0 for the first
+ *                 value, or 0 if none do.
+ */
+void SensorHistoryInit(SensorHistory *h, uint8_t valueCount, int32_t period, uint8_t wrapping);
+
+/**
+ * Adds a sample, replacing the oldest one once the history is full.
+ * @param h The history.
+ * @param time When the sample was taken.
+ * @param values The valueCount values of the sample.
+ * @return false if the sample was dropped for being older than the newest one, but still within
+ *         the span of the history.
+ */
+bool SensorHistoryAdd(SensorHistory *h, uint32_t time, const int32_t *values);
+
+/**
+ * Looks up the values at the given time.
+ * @param h The history.
+ * @param time The time to look up.
+ * @param mode How to look up values between samples.
+ * @param[out] values Filled with the valueCount values, unless nothing was found.
+ * @return What was found.
+ */
+SensorHistoryResult SensorHistoryAt(const SensorHistory *h, uint32_t time, SensorHistoryMode mode,
+                                    int32_t *values);
+
+#endif // SENSOR_HISTORY_H
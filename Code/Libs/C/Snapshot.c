@@ -0,0 +1,127 @@
+#include "Snapshot.h"
+
+#include <string.h>
+
+// Keep the compiler from moving the copies to the other side of the sequence number accesses. The
+// dsPIC executes in order and 16-bit accesses are atomic, so no hardware barrier is needed.
+#define SNAPSHOT_BARRIER() __asm__ volatile("" ::: "memory")
+
+void SnapshotPublish(Snapshot *s, const void *record)
+{
+    // Write the buffer that isn't being read from, and only then flip over to it.
+    const uint16_t next = s->sequence + 1;
+    memcpy(s->buffers[next & 1], record, s->size);
+    SNAPSHOT_BARRIER();
+    s->sequence = next;
+}
+
+uint16_t SnapshotRead(const Snapshot *s, void *record)
+{
+    // If the sequence number changed during the copy the writer may have started to write the
+    // buffer being copied, so copy the new one instead.
+    uint16_t sequence;
+    do {
+        sequence = s->sequence;
+        SNAPSHOT_BARRIER();
+        memcpy(record, s->buffers[sequence & 1], s->size);
+        SNAPSHOT_BARRIER();
+    } while (sequence != s->sequence);
+    return sequence;
+}
+
+uint16_t SnapshotSequence(const Snapshot *s)
+{
+    return s->sequence;
+}
+
+#ifdef UNIT_TEST_SNAPSHOT
+
+#include <stdio.h>
+#include <assert.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+// A record is only consistent if all of its values are the same. It's large so that the writer gets
+// to publish during a read.
+#define RECORD_VALUES 1024
+typedef struct {
+    uint32_t values[RECORD_VALUES];
+} Record;
+
+static Record buffers[2];
+static Snapshot snapshot = SNAPSHOT_INIT(buffers);
+static volatile bool done = false;
+
+static void *Writer(void *arg)
+{
+    Record r;
+    uint32_t i, j;
+    for (i = 1; i <= 200000; ++i) {
+        for (j = 0; j < RECORD_VALUES; ++j) {
+            r.values[j] = i;
+        }
+        SnapshotPublish(&snapshot, &r);
+    }
+    done = true;
+    return NULL;
+}
+
+int main()
+{
+    printf("Running unit tests.\n");
+
+    // The initial record is read before anything's published.
+    Record r;
+    buffers[0].values[0] = 42;
+    assert(SnapshotRead(&snapshot, &r) == 0);
+    assert(r.values[0] == 42);
+    buffers[0].values[0] = 0;
+
+    // Publishing flips the buffers and bumps the sequence number.
+    Record w = {{0}};
+    w.values[0] = 7;
+    SnapshotPublish(&snapshot, &w);
+    assert(SnapshotSequence(&snapshot) == 1);
+    assert(SnapshotRead(&snapshot, &r) == 1);
+    assert(r.values[0] == 7);
+    w.values[0] = 8;
+    SnapshotPublish(&snapshot, &w);
+    assert(SnapshotRead(&snapshot, &r) == 2);
+    assert(r.values[0] == 8);
+    assert(buffers[1].values[0] == 7);
+
+    // The sequence number wraps around.
+    snapshot.sequence = UINT16_MAX;
+    SnapshotPublish(&snapshot, &w);
+    assert(SnapshotSequence(&snapshot) == 0);
+    assert(SnapshotRead(&snapshot, &r) == 0 && r.values[0] == 8);
+
+    // Never see a torn record while a writer's publishing as fast as it can, and never go back in
+    // time.
+    w.values[0] = 0;
+    SnapshotPublish(&snapshot, &w);
+    pthread_t writer;
+    pthread_create(&writer, NULL, Writer, NULL);
+    uint32_t last = 0;
+    uint32_t reads = 0;
+    while (!done) {
+        SnapshotRead(&snapshot, &r);
+        int j;
+        for (j = 1; j < RECORD_VALUES; ++j) {
+            assert(r.values[j] == r.values[0]);
+        }
+        assert(r.values[0] >= last);
+        last = r.values[0];
+        ++reads;
+    }
+    pthread_join(writer, NULL);
+    SnapshotRead(&snapshot, &r);
+    assert(r.values[0] == 200000);
+    printf("%u consistent reads.\n", reads);
+
+    printf("All tests passed.\n");
+
+    return 0;
+}
+
+#endif // UNIT_TEST_SNAPSHOT
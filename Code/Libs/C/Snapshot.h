@@ -0,0 +1,71 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+/**
+ * @file
+ * @brief Double-buffered records that can be read consistently while they're being written.
+ *
+ * # Dependencies
+ * This library has no prerequisites outside of the C standard library.
+ *
+ * # Usage
+ * A Snapshot holds a record, like a GpsData struct, in two buffers along with a sequence number.
+ * Declare the two buffers and initialize the Snapshot with SNAPSHOT_INIT():
+ *     static GpsData gpsBuffers[2];
+ *     Snapshot gpsSnapshot = SNAPSHOT_INIT(gpsBuffers);
+ *
+ * The writer fills in a working copy of the record however it likes, like field by field as CAN
+ * messages arrive, and then publishes the whole record with SnapshotPublish(). That copies it into
+ * the buffer not being read from and then increments the sequence number, which flips the buffers.
+ * Readers take a copy with SnapshotRead(), which retries if the sequence number changed while it
+ * was copying. So a reader always gets a record exactly as it was published, like a GPS fix with
+ * the latitude and longitude from the same message, without either side disabling interrupts.
+ *
+ * There can only be one writer per Snapshot, and a reader must never interrupt the writer, as the
+ * writer doesn't wait for readers. So the writer runs in an ISR or the main loop, and the readers
+ * run in the main loop or in lower-priority ISRs. A reader interrupted by the writer only retries
+ * its copy, which happens at most once unless the writer publishes faster than a record can be
+ * copied.
+ *
+ * The sequence number returned by SnapshotRead() tells readers whether anything was published
+ * since their last read.
+ *
+ * Unit testing has been completed on x86 by compiling with the UNIT_TEST_SNAPSHOT macro, which
+ * hammers a Snapshot from a writer thread while reading it from another.
+ * With gcc: `gcc Snapshot.c -DUNIT_TEST_SNAPSHOT -Wall -g -pthread`
+ */
+
+#include <stdint.h>
+
+typedef struct {
+    volatile uint16_t sequence; // Incremented by every publish. The record is in buffers[sequence & 1].
+    uint16_t size;              // The size of the record.
+    void *buffers[2];
+} Snapshot;
+
+/**
+ * Initializes a Snapshot from an array of two records, which hold the initial record in the first.
+ */
+#define SNAPSHOT_INIT(buffers) {0, sizeof((buffers)[0]), {&(buffers)[0], &(buffers)[1]}}
+
+/**
+ * Publishes a new record. Must only be called by the one writer.
+ * @param s The Snapshot.
+ * @param record The whole record to publish.
+ */
+void SnapshotPublish(Snapshot *s, const void *record);
+
+/**
+ * Copies out the last published record.
+ * @param s The Snapshot.
+ * @param[out] record Where to copy the record to.
+ * @return The sequence number of the record, which only changes when a new one is published.
+ */
+uint16_t SnapshotRead(const Snapshot *s, void *record);
+
+/**
+ * Returns the sequence number of the last published record.
+ */
+uint16_t SnapshotSequence(const Snapshot *s);
+
+#endif // SNAPSHOT_H
@@ -0,0 +1,232 @@
+/**
+ * @file
+ * @brief Implements the clock synchronization declared in TimeSync.h.
+ *
+ * Unit testing has been completed on x86 by compiling with the UNIT_TEST_TIME_SYNC macro.
+ * With gcc: `gcc TimeSync.c -DUNIT_TEST_TIME_SYNC -Wall -g`
+ */
+#include "TimeSync.h"
+
+#include <string.h>
+
+// The smallest the filter gains get once they have settled. The skew changes very slowly, so it
+// is averaged over many more samples than the offset.
+#define ALPHA_MIN 0.05f
+#define SKEW_GAIN_MIN 0.03f
+
+// Round trips that are further above the fastest recent one than the average is are rejected
+// once converged.
+#define RTT_MARGIN(ts) ((ts)->rtt - (ts)->rttMin)
+
+void TimeSyncInit(TimeSyncEstimator *ts)
+{
+    const uint32_t rejected = ts->rejected;
+    memset(ts, 0, sizeof(*ts));
+    ts->rejected = rejected;
+}
+
+bool TimeSyncUpdate(TimeSyncEstimator *ts, int64_t localSent, int64_t remote, int64_t localReceived)
+{
+    const int64_t rtt = localReceived - localSent;
+    if (rtt < 0 || rtt > TIME_SYNC_MAX_RTT) {
+        ++ts->rejected;
+        return false;
+    }
+
+    // Slow round trips are likely to have spent longer in one direction than the other, so only
+    // those close to the fastest recent round trip are used once converged. The round trip times
+    // are still tracked so this adapts to the link slowing down.
+    if (ts->rtt == 0) {
+        ts->rtt = rtt;
+        ts->rttMin = rtt;
+    } else {
+        ts->rtt += (rtt - ts->rtt) / 8;
+        ts->rttMin = (rtt < ts->rttMin) ? rtt : ts->rttMin + (ts->rtt - ts->rttMin) / 256;
+    }
+    if (ts->samples >= TIME_SYNC_CONVERGED_SAMPLES && rtt - ts->rttMin > RTT_MARGIN(ts)) {
+        ++ts->rejected;
+        return false;
+    }
+
+    // The remote time was sampled roughly halfway through the round trip.
+    const int64_t local = localSent + rtt / 2;
+    const int64_t measured = remote - local;
+
+    if (ts->samples == 0) {
+        ts->offset = measured;
+        ts->skew = 0.0f;
+        ts->lastUpdate = local;
+        ts->samples = 1;
+        ts->outliers = 0;
+        return true;
+    }
+
+    const int64_t dt = local - ts->lastUpdate;
+    const int64_t predicted = ts->offset + (int64_t)(ts->skew * (float)dt);
+    const int64_t residual = measured - predicted;
+
+    // A big disagreement is either a bad sample or the remote clock jumping. If it keeps happening
+    // it's the latter, so start over.
+    if (residual > TIME_SYNC_OUTLIER || residual < -TIME_SYNC_OUTLIER) {
+        if (++ts->outliers >= TIME_SYNC_RESET_COUNT) {
+            TimeSyncInit(ts);
+            return TimeSyncUpdate(ts, localSent, remote, localReceived);
+        }
+        return false;
+    }
+    ts->outliers = 0;
+
+    // An alpha-beta filter with gains that start at 1/2 and decay as samples are collected.
+    const float gain = 1.0f / (float)(ts->samples + 1);
+    const float alpha = (gain > ALPHA_MIN) ? gain : ALPHA_MIN;
+    const float skewGain = (gain > SKEW_GAIN_MIN) ? gain : SKEW_GAIN_MIN;
+    const float beta = skewGain * skewGain / (2.0f - skewGain);
+
+    ts->offset = predicted + (int64_t)(alpha * (float)residual);
+    if (dt > 0) {
+        ts->skew += beta * (float)residual / (float)dt;
+        if (ts->skew > TIME_SYNC_MAX_SKEW) {
+            ts->skew = TIME_SYNC_MAX_SKEW;
+        } else if (ts->skew < -TIME_SYNC_MAX_SKEW) {
+            ts->skew = -TIME_SYNC_MAX_SKEW;
+        }
+    }
+    ts->lastUpdate = local;
+    if (ts->samples < UINT16_MAX) {
+        ++ts->samples;
+    }
+    return true;
+}
+
+bool TimeSyncIsValid(const TimeSyncEstimator *ts)
+{
+    return ts->samples >= TIME_SYNC_CONVERGED_SAMPLES;
+}
+
+int64_t TimeSyncToRemote(const TimeSyncEstimator *ts, int64_t local)
+{
+    if (!TimeSyncIsValid(ts)) {
+        return local;
+    }
+    return local + ts->offset + (int64_t)(ts->skew * (float)(local - ts->lastUpdate));
+}
+
+#ifdef UNIT_TEST_TIME_SYNC
+
+#include <stdio.h>
+#include <assert.h>
+
+static uint32_t randomState = 1;
+
+/**
+ * A deterministic pseudo-random number in [0, limit).
+ */
+static int64_t Random(int64_t limit)
+{
+    uint64_t r = 0;
+    int i;
+    for (i = 0; i < 2; ++i) {
+        randomState = randomState * 1103515245 + 12345;
+        r = (r << 24) | (randomState >> 8);
+    }
+    return (int64_t)(r % (uint64_t)limit);
+}
+
+/**
+ * Simulates a link to a remote clock and returns the largest error once converged.
+ * @param ts The estimator to use.
+ * @param offset The initial offset of the remote clock.
+ * @param skewPpm The skew of the remote clock in parts per million.
+ * @param delay The fixed one-way delay of the link.
+ * @param jitter The maximum random delay added in each direction.
+ * @param seconds How long to simulate for, with 1 round trip per second.
+ */
+static int64_t Simulate(TimeSyncEstimator *ts, int64_t offset, double skewPpm, int64_t delay, int64_t jitter, int seconds)
+{
+    // The local clock keeps running across simulations.
+    static int64_t now = 12345;
+
+    int64_t worst = 0;
+    int i;
+    for (i = 0; i < seconds; ++i) {
+        const int64_t sent = now;
+        now += 1000000000LL;
+        const int64_t arrived = sent + delay + Random(jitter);
+        const int64_t remote = arrived + offset + (int64_t)(arrived * skewPpm * 1e-6);
+        const int64_t received = arrived + delay + Random(jitter);
+        TimeSyncUpdate(ts, sent, remote, received);
+
+        if (i >= 30) {
+            const int64_t error = TimeSyncToRemote(ts, received) - (received + offset + (int64_t)(received * skewPpm * 1e-6));
+            const int64_t absError = error < 0 ? -error : error;
+            if (absError > worst) {
+                worst = absError;
+            }
+        }
+    }
+    return worst;
+}
+
+int main()
+{
+    printf("Testing TimeSync.c. All errors will be reported as failed assertions.\n");
+
+    TimeSyncEstimator ts = {};
+    TimeSyncInit(&ts);
+    assert(!TimeSyncIsValid(&ts));
+    assert(TimeSyncToRemote(&ts, 1234) == 1234);
+
+    // Perfect symmetric round trips give the exact offset immediately.
+    assert(TimeSyncUpdate(&ts, 1000, 5001500, 2000));
+    assert(ts.offset == 5000000);
+    assert(ts.rtt == 1000);
+
+    // Round trips that are negative or too long are ignored.
+    assert(!TimeSyncUpdate(&ts, 2000, 5000500, 1000));
+    assert(!TimeSyncUpdate(&ts, 0, 0, TIME_SYNC_MAX_RTT + 1));
+    assert(ts.rejected == 2);
+    assert(ts.samples == 1);
+
+    // It becomes valid after enough samples.
+    int i;
+    for (i = 1; i < TIME_SYNC_CONVERGED_SAMPLES; ++i) {
+        assert(!TimeSyncIsValid(&ts));
+        assert(TimeSyncUpdate(&ts, i * 1000000000LL, i * 1000000000LL + 5000500, i * 1000000000LL + 1000));
+    }
+    assert(TimeSyncIsValid(&ts));
+    assert(TimeSyncToRemote(&ts, 10000000000LL) == 10005000000LL);
+
+    // A serial link with a ~10ms delay each way and 1ms of jitter, a 1s offset, and a 50ppm skew
+    // should be tracked to within a millisecond.
+    TimeSyncInit(&ts);
+    int64_t worst = Simulate(&ts, 1000000000LL, 50.0, 10000000, 1000000, 600);
+    printf("Serial link worst error: %lldns, skew: %.1fppm\n", (long long)worst, ts.skew * 1e6);
+    assert(worst < 1000000);
+    assert(ts.skew > 40e-6 && ts.skew < 60e-6);
+
+    // A radio link with up to 100ms of jitter each way is much worse, but rejecting slow round trips
+    // and averaging the rest keeps it to a fraction of that.
+    TimeSyncInit(&ts);
+    worst = Simulate(&ts, -3600000000000LL, -20.0, 40000000, 100000000, 3600);
+    printf("Radio link worst error: %lldns, skew: %.1fppm, rejected: %lu\n", (long long)worst, ts.skew * 1e6, (unsigned long)ts.rejected);
+    assert(worst < 20000000);
+    assert(ts.rejected > 0);
+
+    // If the remote clock jumps, the estimator resets and follows it.
+    TimeSyncInit(&ts);
+    Simulate(&ts, 1000000000LL, 0.0, 10000000, 1000000, 60);
+    assert(TimeSyncIsValid(&ts));
+    worst = Simulate(&ts, 5000000000LL, 0.0, 10000000, 1000000, 60);
+    assert(worst < 1000000);
+
+    // A single outlier is ignored.
+    const int64_t offset = ts.offset;
+    assert(!TimeSyncUpdate(&ts, 60000000000LL, 60000000000LL + 10000000, 60000000000LL + 20000000));
+    assert(ts.offset == offset);
+
+    printf("All tests passed.\n");
+
+    return 0;
+}
+
+#endif // UNIT_TEST_TIME_SYNC
@@ -0,0 +1,99 @@
+#ifndef TIME_SYNC_H
+#define TIME_SYNC_H
+
+/**
+ * @file
+ * @brief Estimates the offset and skew between the local clock and a remote clock.
+ *
+ * # Dependencies
+ * This library has no prerequisites outside of the C standard library. It doesn't depend on the
+ * MAVLink headers, the caller passes in the timestamps from each round trip.
+ *
+ * # Usage
+ * This is designed around the MAVLink TIMESYNC protocol, where a request carries the local time
+ * it was sent at, and the response adds the remote time it was received at. Once a response is
+ * received, call TimeSyncUpdate() with the local time the request was sent at, the remote time,
+ * and the local time the response was received at. All times are in nanoseconds.
+ *
+ * The remote time is assumed to have been sampled halfway through the round trip. The offset is
+ * tracked with an alpha-beta filter, where the beta term tracks the relative skew of the two
+ * clocks. The filter gains start high and decrease as samples are collected so it converges
+ * quickly and then settles. Round trips that take much longer than usual are likely to be
+ * asymmetric and are rejected. If the remote clock jumps, e.g. due to a restart, the filter is
+ * reset after TIME_SYNC_RESET_COUNT samples in a row disagree with it.
+ *
+ * Once TimeSyncIsValid(), TimeSyncToRemote() converts local times into the remote's time base.
+ *
+ * Unit testing has been completed on x86 by compiling with the UNIT_TEST_TIME_SYNC macro.
+ * With gcc: `gcc TimeSync.c -DUNIT_TEST_TIME_SYNC -Wall -g`
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Round trips longer than this are never used, in nanoseconds.
+ */
+#define TIME_SYNC_MAX_RTT 500000000LL
+
+/**
+ * The largest relative skew between the clocks, any more is assumed to be noise. Crystal
+ * oscillators are accurate to within 100ppm, so two of them can't drift apart faster than this.
+ */
+#define TIME_SYNC_MAX_SKEW 200e-6f
+
+/**
+ * Samples that disagree with the estimate by more than this are outliers, in nanoseconds.
+ */
+#define TIME_SYNC_OUTLIER 100000000LL
+
+/**
+ * The number of outliers in a row after which the estimate is reset.
+ */
+#define TIME_SYNC_RESET_COUNT 3
+
+/**
+ * The number of samples before the filter has converged and TimeSyncIsValid() is true.
+ */
+#define TIME_SYNC_CONVERGED_SAMPLES 5
+
+typedef struct {
+    int64_t offset;        // The remote time minus the local time, in nanoseconds.
+    float skew;            // The rate the offset changes at, in nanoseconds per nanosecond.
+    int64_t lastUpdate;    // The local time the offset was last estimated at.
+    int64_t rtt;           // The smoothed round trip time, in nanoseconds.
+    int64_t rttMin;        // The fastest recent round trip time, in nanoseconds.
+    uint16_t samples;      // The number of samples accepted since the last reset.
+    uint8_t outliers;      // The number of outliers in a row.
+    uint32_t rejected;     // The total number of round trips rejected for being too slow.
+} TimeSyncEstimator;
+
+/**
+ * Resets an estimator.
+ */
+void TimeSyncInit(TimeSyncEstimator *ts);
+
+/**
+ * Adds the results of a round trip to the estimate.
+ * @param ts The estimator.
+ * @param localSent The local time the request was sent at.
+ * @param remote The remote time the request was received at.
+ * @param localReceived The local time the response was received at.
+ * @return True if the round trip was used.
+ */
+bool TimeSyncUpdate(TimeSyncEstimator *ts, int64_t localSent, int64_t remote, int64_t localReceived);
+
+/**
+ * @return True if the estimate has converged.
+ */
+bool TimeSyncIsValid(const TimeSyncEstimator *ts);
+
+/**
+ * Converts a local time into the remote's time base.
+ * @param ts The estimator.
+ * @param local A local time.
+ * @return The estimated remote time at that instant, or the local time if the estimate isn't valid.
+ */
+int64_t TimeSyncToRemote(const TimeSyncEstimator *ts, int64_t local);
+
+#endif // TIME_SYNC_H
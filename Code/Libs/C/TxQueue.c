@@ -0,0 +1,260 @@
+#include "TxQueue.h"
+
+#include <stddef.h>
+
+void TxQueueInit(TxQueue *q, uint8_t *const buffers[UART_LANES], const uint16_t sizes[UART_LANES])
+{
+    uint8_t i;
+    for (i = 0; i < UART_LANES; ++i) {
+        CB_Init(&q->lanes[i].data, buffers[i], sizes[i]);
+        q->lanes[i].firstWrite = 0;
+        q->lanes[i].writeCount = 0;
+        q->lanes[i].drops = 0;
+    }
+    q->lane = 0;
+    q->inWrite = false;
+    q->sent = 0;
+}
+
+UartWriteResult TxQueueWrite(TxQueue *q, UartLane lane, const void *data, uint16_t length, uint16_t *written)
+{
+    TxQueueLane *l = &q->lanes[lane];
+    const uint16_t space = l->data.staticSize - l->data.dataSize;
+
+    // Work out how much to write, counting it as a drop if it's not everything.
+    uint16_t n = length;
+    UartWriteResult result = UART_WRITE_COMPLETE;
+    if (space < length) {
+        if (l->drops < UINT16_MAX) {
+            ++l->drops;
+        }
+        if (!written || space == 0) {
+            if (written) {
+                *written = 0;
+            }
+            return UART_WRITE_FULL;
+        }
+        n = space;
+        result = UART_WRITE_PARTIAL;
+    }
+    if (written) {
+        *written = n;
+    }
+    if (n == 0) {
+        return result;
+    }
+
+    CB_WriteMany(&l->data, data, n, true);
+
+    // Record where the write ends, or extend the last one if there's no room to.
+    if (l->writeCount < TX_QUEUE_WRITES) {
+        l->writes[(l->firstWrite + l->writeCount) % TX_QUEUE_WRITES] = n;
+        ++l->writeCount;
+    } else {
+        l->writes[(l->firstWrite + l->writeCount - 1) % TX_QUEUE_WRITES] += n;
+    }
+
+    return result;
+}
+
+uint16_t TxQueuePeekSpan(TxQueue *q, const uint8_t **span)
+{
+    // Pick the highest-priority lane with data, unless a write is still being transmitted.
+    if (!q->inWrite) {
+        uint8_t i;
+        for (i = 0; i < UART_LANES; ++i) {
+            if (q->lanes[i].writeCount) {
+                q->lane = i;
+                q->inWrite = true;
+                break;
+            }
+        }
+        if (!q->inWrite) {
+            return 0;
+        }
+    }
+
+    const TxQueueLane *l = &q->lanes[q->lane];
+    const uint16_t length = CB_PeekSpan(&l->data, span);
+    const uint16_t writeLeft = l->writes[l->firstWrite];
+    return (length < writeLeft) ? length : writeLeft;
+}
+
+void TxQueueRemove(TxQueue *q, uint16_t length)
+{
+    if (!q->inWrite || length == 0) {
+        return;
+    }
+
+    TxQueueLane *l = &q->lanes[q->lane];
+    CB_Remove(&l->data, length);
+    q->sent += length;
+    if (length < l->writes[l->firstWrite]) {
+        l->writes[l->firstWrite] -= length;
+    } else {
+        // The write is done, so the next span can come from another lane.
+        l->firstWrite = (l->firstWrite + 1) % TX_QUEUE_WRITES;
+        --l->writeCount;
+        q->inWrite = false;
+    }
+}
+
+bool TxQueueReadByte(TxQueue *q, uint8_t *c)
+{
+    const uint8_t *span;
+    if (TxQueuePeekSpan(q, &span)) {
+        *c = *span;
+        TxQueueRemove(q, 1);
+        return true;
+    }
+    return false;
+}
+
+uint16_t TxQueueLength(const TxQueue *q)
+{
+    uint16_t length = 0;
+    uint8_t i;
+    for (i = 0; i < UART_LANES; ++i) {
+        length += q->lanes[i].data.dataSize;
+    }
+    return length;
+}
+
+#ifdef UNIT_TEST_TX_QUEUE
+
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+static TxQueue q;
+static uint8_t control[16];
+static uint8_t bulk[48];
+
+static void Init(void)
+{
+    uint8_t *const buffers[UART_LANES] = {control, bulk};
+    const uint16_t sizes[UART_LANES] = {sizeof(control), sizeof(bulk)};
+    TxQueueInit(&q, buffers, sizes);
+}
+
+/**
+ * Transmits up to `max` bytes a byte at a time, returning them as a string.
+ */
+static const char *Transmit(uint16_t max)
+{
+    static char out[64];
+    uint16_t i = 0;
+    uint8_t c;
+    while (i < max && TxQueueReadByte(&q, &c)) {
+        out[i++] = (char)c;
+    }
+    out[i] = '\0';
+    return out;
+}
+
+int main()
+{
+    printf("Running unit tests.\n");
+
+    // Writes in a single lane come out in order.
+    {
+        Init();
+        assert(TxQueueLength(&q) == 0);
+        assert(TxQueueWrite(&q, UART_LANE_BULK, "abc", 3, NULL) == UART_WRITE_COMPLETE);
+        assert(TxQueueWrite(&q, UART_LANE_BULK, "de", 2, NULL) == UART_WRITE_COMPLETE);
+        assert(TxQueueLength(&q) == 5);
+        assert(!strcmp(Transmit(10), "abcde"));
+        assert(TxQueueLength(&q) == 0);
+        assert(q.sent == 5);
+    }
+
+    // The control lane goes first, but only in between writes.
+    {
+        Init();
+        TxQueueWrite(&q, UART_LANE_BULK, "abcd", 4, NULL);
+        TxQueueWrite(&q, UART_LANE_BULK, "efgh", 4, NULL);
+        assert(!strcmp(Transmit(2), "ab"));
+        TxQueueWrite(&q, UART_LANE_CONTROL, "XY", 2, NULL);
+        TxQueueWrite(&q, UART_LANE_CONTROL, "Z", 1, NULL);
+        assert(!strcmp(Transmit(20), "cdXYZefgh"));
+    }
+
+    // Writes that don't fit are dropped and counted, and only allowed partial writes are partial.
+    {
+        Init();
+        char data[40];
+        memset(data, 'a', sizeof(data));
+        assert(TxQueueWrite(&q, UART_LANE_CONTROL, data, 10, NULL) == UART_WRITE_COMPLETE);
+        assert(TxQueueWrite(&q, UART_LANE_CONTROL, data, 10, NULL) == UART_WRITE_FULL);
+        assert(q.lanes[UART_LANE_CONTROL].drops == 1);
+        assert(TxQueueLength(&q) == 10);
+
+        uint16_t written;
+        assert(TxQueueWrite(&q, UART_LANE_CONTROL, "0123456789", 10, &written) == UART_WRITE_PARTIAL);
+        assert(written == 6);
+        assert(q.lanes[UART_LANE_CONTROL].drops == 2);
+        assert(TxQueueWrite(&q, UART_LANE_CONTROL, "0", 1, &written) == UART_WRITE_FULL);
+        assert(written == 0);
+        assert(q.lanes[UART_LANE_CONTROL].drops == 3);
+
+        // The bulk lane isn't affected.
+        assert(q.lanes[UART_LANE_BULK].drops == 0);
+        assert(TxQueueWrite(&q, UART_LANE_BULK, data, 32, NULL) == UART_WRITE_COMPLETE);
+        assert(!strcmp(Transmit(16), "aaaaaaaaaa012345"));
+    }
+
+    // Spans end at the end of a write and where a lane's buffer wraps around.
+    {
+        Init();
+        const uint8_t *span;
+        assert(TxQueuePeekSpan(&q, &span) == 0);
+
+        char data[41];
+        memset(data, 'a', sizeof(data));
+        TxQueueWrite(&q, UART_LANE_BULK, data, sizeof(data), NULL);
+        TxQueueWrite(&q, UART_LANE_BULK, "!", 1, NULL);
+        assert(TxQueuePeekSpan(&q, &span) == sizeof(data));
+        assert(span == bulk);
+        TxQueueRemove(&q, sizeof(data));
+        assert(TxQueuePeekSpan(&q, &span) == 1);
+        TxQueueRemove(&q, 1);
+        TxQueueWrite(&q, UART_LANE_BULK, "abcdefghij", 10, NULL);
+
+        // The third write wraps around after 6 bytes.
+        assert(TxQueuePeekSpan(&q, &span) == 6);
+        assert(!memcmp(span, "abcdef", 6));
+        TxQueueRemove(&q, 4);
+        assert(TxQueuePeekSpan(&q, &span) == 2);
+        assert(!memcmp(span, "ef", 2));
+        TxQueueRemove(&q, 2);
+        assert(TxQueuePeekSpan(&q, &span) == 4);
+        assert(span == bulk && !memcmp(span, "ghij", 4));
+        TxQueueRemove(&q, 1);
+        assert(TxQueuePeekSpan(&q, &span) == 3);
+        assert(span == &bulk[1] && !memcmp(span, "hij", 3));
+        TxQueueRemove(&q, 3);
+        assert(TxQueuePeekSpan(&q, &span) == 0);
+    }
+
+    // Once there's no room for more write lengths, writes are merged into the last one.
+    {
+        Init();
+        int i;
+        for (i = 0; i < TX_QUEUE_WRITES + 2; ++i) {
+            assert(TxQueueWrite(&q, UART_LANE_BULK, "b", 1, NULL) == UART_WRITE_COMPLETE);
+        }
+        assert(q.lanes[UART_LANE_BULK].writeCount == TX_QUEUE_WRITES);
+        assert(TxQueueLength(&q) == TX_QUEUE_WRITES + 2);
+
+        // So a control write waits for all of the merged writes once they've started.
+        assert(strlen(Transmit(TX_QUEUE_WRITES)) == TX_QUEUE_WRITES);
+        TxQueueWrite(&q, UART_LANE_CONTROL, "C", 1, NULL);
+        assert(!strcmp(Transmit(10), "bbC"));
+    }
+
+    printf("All tests passed.\n");
+
+    return 0;
+}
+
+#endif // UNIT_TEST_TX_QUEUE
@@ -0,0 +1,123 @@
+#ifndef TX_QUEUE_H
+#define TX_QUEUE_H
+
+/**
+ * @file
+ * @brief A transmit queue with priority lanes for the UART libraries.
+ *
+ * # Dependencies
+ *  * CircularBuffer library.
+ *
+ * # Usage
+ * Every lane keeps its data in its own CircularBuffer along with the lengths of the writes queued
+ * in it. The transmitter always takes its data from the highest-priority lane with any queued, but
+ * only switches between lanes in between writes, so writes like whole MAVLink messages are never
+ * interleaved with each other. Control-plane responses written to UART_LANE_CONTROL are therefore
+ * sent right after the write that's currently being transmitted, however much bulk data is queued.
+ *
+ * Writes that don't fit are counted as dropped for their lane. Only a caller that allows partial
+ * writes can have just part of its data written, otherwise writes are all-or-nothing. When a lane
+ * runs out of room to store write lengths, the new write is merged into the last one, which only
+ * makes switching lanes coarser.
+ *
+ * Like with the CircularBuffer library, calls on the same queue aren't safe against each other,
+ * so the UART libraries disable their transmit interrupts around writes.
+ *
+ * Unit testing has been completed on x86 by compiling with the UNIT_TEST_TX_QUEUE macro.
+ * With gcc: `gcc TxQueue.c CircularBuffer.c -DUNIT_TEST_TX_QUEUE -Wall -g`
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "CircularBuffer.h"
+
+/**
+ * The number of write lengths stored per lane.
+ */
+#define TX_QUEUE_WRITES 32
+
+/**
+ * The transmit lanes in priority order.
+ */
+typedef enum {
+    UART_LANE_CONTROL = 0, // Control-plane responses like acknowledgements, always sent first.
+    UART_LANE_BULK,        // Everything else, like telemetry.
+    UART_LANES
+} UartLane;
+
+/**
+ * The result of writing into a lane.
+ */
+typedef enum {
+    UART_WRITE_FULL = 0, // Nothing was written as there wasn't enough room.
+    UART_WRITE_PARTIAL,  // Only the start of the data fit, only when partial writes are allowed.
+    UART_WRITE_COMPLETE  // All of the data was written.
+} UartWriteResult;
+
+typedef struct {
+    CircularBuffer data;
+    uint16_t writes[TX_QUEUE_WRITES]; // The lengths left of the queued writes, oldest first.
+    uint8_t firstWrite;
+    uint8_t writeCount;
+    uint16_t drops; // The number of writes that didn't (completely) fit, saturating.
+} TxQueueLane;
+
+typedef struct {
+    TxQueueLane lanes[UART_LANES];
+    uint8_t lane;   // The lane currently being transmitted from.
+    bool inWrite;   // Whether a write in `lane` has been started but not finished.
+    uint32_t sent;  // The total number of bytes removed from all lanes, wrapping around.
+} TxQueue;
+
+/**
+ * Initializes the queue, emptying all lanes and resetting their drop counters and `sent`.
+ * @param q The queue.
+ * @param buffers The memory for each lane.
+ * @param sizes The size of the memory for each lane.
+ */
+void TxQueueInit(TxQueue *q, uint8_t *const buffers[UART_LANES], const uint16_t sizes[UART_LANES]);
+
+/**
+ * Queues data in a lane.
+ * @param q The queue.
+ * @param lane The lane to queue the data in.
+ * @param data The data.
+ * @param length The length of the data in bytes.
+ * @param written If NULL, the write is all-or-nothing. Otherwise as much data as fits is written,
+ *                and the number of bytes written is stored here.
+ * @return Whether the data was completely, partially, or not written at all.
+ */
+UartWriteResult TxQueueWrite(TxQueue *q, UartLane lane, const void *data, uint16_t length, uint16_t *written);
+
+/**
+ * Points to the next contiguous data to transmit, which continues the current write or starts the
+ * oldest write in the highest-priority lane. The span never extends past the end of a write, so
+ * a higher-priority write can go next.
+ * @param q The queue.
+ * @param span Where to store a pointer to the data.
+ * @return The number of bytes in the span, or 0 if there's nothing to transmit.
+ */
+uint16_t TxQueuePeekSpan(TxQueue *q, const uint8_t **span);
+
+/**
+ * Removes transmitted data, at most the length of the span returned by TxQueuePeekSpan().
+ * @param q The queue.
+ * @param length The number of bytes transmitted.
+ */
+void TxQueueRemove(TxQueue *q, uint16_t length);
+
+/**
+ * Takes the next byte to transmit out of the queue.
+ * @param q The queue.
+ * @param c Where to store the byte.
+ * @return True if there was a byte to transmit.
+ */
+bool TxQueueReadByte(TxQueue *q, uint8_t *c);
+
+/**
+ * Returns the total number of bytes queued in all lanes.
+ */
+uint16_t TxQueueLength(const TxQueue *q);
+
+#endif // TX_QUEUE_H
@@ -9,8 +9,39 @@
 
 static CircularBuffer uart1RxBuffer;
 static uint8_t u1RxBuf[UART1_BUFFER_SIZE];
-static CircularBuffer uart1TxBuffer;
-static uint8_t u1TxBuf[UART1_BUFFER_SIZE];
+
+#if UART1_RX_BATCH
+#define UART1_RX_INT UART_INT_RX_3_4_FUL
+#else
+#define UART1_RX_INT UART_INT_RX_CHAR
+#endif
+
+// The total number of bytes received, wrapping around.
+static uint32_t u1RxBytes = 0;
+
+// The transmit lanes share a single array, the control lane first.
+static TxQueue uart1TxQueue;
+#if UART1_TX_DMA && defined(__dsPIC33F__)
+// The dsPIC33F's DMA channels can only read from DMA RAM.
+static uint8_t u1TxBuf[UART1_CONTROL_BUFFER_SIZE + UART1_BUFFER_SIZE] __attribute__((space(dma)));
+#else
+static uint8_t u1TxBuf[UART1_CONTROL_BUFFER_SIZE + UART1_BUFFER_SIZE];
+#endif
+
+#if UART1_TX_DMA
+// The number of bytes of the current span of uart1TxQueue that DMA4 is transmitting. They're only
+// removed from the queue once the block completes, so they can't be overwritten before that.
+static uint16_t u1TxDmaLength;
+
+// Transmission is controlled by the DMA4 block interrupt instead of the UART1 TX interrupt.
+#define U1TX_INT_ENABLE _DMA4IE
+#else
+#define U1TX_INT_ENABLE IEC0bits.U1TXIE
+#endif
+
+// The time spent in the UART1 interrupts, see Uart1SetTimestampSource().
+static uint32_t (*timestampSource)(void);
+static volatile uint32_t u1InterruptTicks;
 
 /*
  * Private functions.
@@ -29,24 +60,59 @@ void Uart1Init(uint16_t brgRegister)
 {
     // First initialize the necessary circular buffers.
     CB_Init(&uart1RxBuffer, u1RxBuf, sizeof(u1RxBuf));
-    CB_Init(&uart1TxBuffer, u1TxBuf, sizeof(u1TxBuf));
+    uint8_t *const lanes[UART_LANES] = {u1TxBuf, &u1TxBuf[UART1_CONTROL_BUFFER_SIZE]};
+    const uint16_t laneSizes[UART_LANES] = {UART1_CONTROL_BUFFER_SIZE, UART1_BUFFER_SIZE};
+    TxQueueInit(&uart1TxQueue, lanes, laneSizes);
 
     // If the UART was already opened, close it first. This should also clear the transmit/receive
     // buffers so we won't have left-over data around when we re-initialize, if we are.
     CloseUART1();
 
+#if UART1_TX_DMA
+    // Stop any transmission in progress, as its data was just cleared.
+    DMA4CONbits.CHEN = 0;
+    u1TxDmaLength = 0;
+
+    // Configure and open the port. The UART1 TX interrupt requests a DMA transfer every time a
+    // character moves into the shift register, so there's always room in the FIFO for it.
+    OpenUART1(UART_EN & UART_IDLE_CON & UART_IrDA_DISABLE & UART_MODE_FLOW & UART_UEN_00 &
+        UART_EN_WAKE & UART_DIS_LOOPBACK & UART_DIS_ABAUD & UART_NO_PAR_8BIT & UART_UXRX_IDLE_ONE &
+        UART_BRGH_SIXTEEN & UART_1STOPBIT,
+        UART_INT_TX & UART_IrDA_POL_INV_ZERO & UART_SYNC_BREAK_DISABLED & UART_TX_ENABLE &
+        UART1_RX_INT & UART_ADR_DETECT_DIS & UART_RX_OVERRUN_CLEAR,
+        brgRegister
+    );
+
+    // Only the RX interrupt runs on the CPU, at priority level 6 (arbitrary).
+    ConfigIntUART1(UART_RX_INT_EN & UART_RX_INT_PR6 & UART_TX_INT_DIS & UART_TX_INT_PR6);
+
+    // DMA4 moves single bytes from RAM into U1TXREG, stopping after every block. The address and
+    // length of each block are set by Uart1StartTransmission().
+    DMA4CON = 0;
+    DMA4CONbits.SIZE = 1; // Bytes
+    DMA4CONbits.DIR = 1; // From RAM to the peripheral
+    DMA4CONbits.MODE = 1; // One-shot, ping-pong disabled
+    DMA4REQ = 0x0C; // Specify the UART1 TX peripheral for DMA4. See the device-specific manual.
+    DMA4PAD = (uint16_t)&U1TXREG;
+
+    // And interrupt at the end of every block, at the same priority as the RX interrupt.
+    _DMA4IF = 0;
+    _DMA4IP = 6;
+    _DMA4IE = 1;
+#else
     // Configure and open the port.
     OpenUART1(UART_EN & UART_IDLE_CON & UART_IrDA_DISABLE & UART_MODE_FLOW & UART_UEN_00 &
         UART_EN_WAKE & UART_DIS_LOOPBACK & UART_DIS_ABAUD & UART_NO_PAR_8BIT & UART_UXRX_IDLE_ONE &
         UART_BRGH_SIXTEEN & UART_1STOPBIT,
         UART_INT_TX_LAST_CH & UART_IrDA_POL_INV_ZERO & UART_SYNC_BREAK_DISABLED & UART_TX_ENABLE &
-        UART_INT_RX_CHAR & UART_ADR_DETECT_DIS & UART_RX_OVERRUN_CLEAR,
+        UART1_RX_INT & UART_ADR_DETECT_DIS & UART_RX_OVERRUN_CLEAR,
         brgRegister
     );
 
     // Setup interrupts for proper UART communication. Enable both TX and RX interrupts at
     // priority level 6 (arbitrary).
     ConfigIntUART1(UART_RX_INT_EN & UART_RX_INT_PR6 & UART_TX_INT_EN & UART_TX_INT_PR6);
+#endif
 }
 
 void Uart1ChangeBaudRate(uint16_t brgRegister)
@@ -64,6 +130,41 @@ void Uart1ChangeBaudRate(uint16_t brgRegister)
     U1STAbits.UTXEN = utxen;
 }
 
+#if UART1_TX_DMA
+/**
+ * Hands the next contiguous span of the transmission queue to DMA4, unless it's still busy with
+ * the previous one. Must be called with the DMA4 interrupt disabled or from within it.
+ */
+static void Uart1StartDmaBlock(void)
+{
+    const uint8_t *span;
+    if (u1TxDmaLength > 0) {
+        return;
+    }
+    const uint16_t length = TxQueuePeekSpan(&uart1TxQueue, &span);
+    if (length > 0) {
+#ifdef __dsPIC33F__
+        DMA4STA = __builtin_dmaoffset(u1TxBuf) + (uint16_t)(span - u1TxBuf);
+#else
+        DMA4STAL = (uint16_t)span;
+        DMA4STAH = 0;
+#endif
+        DMA4CNT = length - 1;
+        u1TxDmaLength = length;
+        DMA4CONbits.CHEN = 1;
+
+        // The UART only requests a byte after it sent one, so request the first.
+        DMA4REQbits.FORCE = 1;
+    }
+}
+
+void Uart1StartTransmission(void)
+{
+    _DMA4IE = 0;
+    Uart1StartDmaBlock();
+    _DMA4IE = 1;
+}
+#else
 /**
  * This function actually initiates transmission. It
  * attempts to start transmission with the first element
@@ -75,21 +176,58 @@ void Uart1ChangeBaudRate(uint16_t brgRegister)
  */
 void Uart1StartTransmission(void)
 {
-    while (uart1TxBuffer.dataSize > 0 && !U1STAbits.UTXBF) {
+    while (!U1STAbits.UTXBF) {
         // A temporary variable is used here because writing directly into U1TXREG causes some weird issues.
         uint8_t c;
         IEC0bits.U1TXIE = 0;
-        CB_ReadByte(&uart1TxBuffer, &c);
+        const bool more = TxQueueReadByte(&uart1TxQueue, &c);
+
+        // The byte has to be in the FIFO before the interrupt is enabled again, otherwise the
+        // interrupt can send the bytes queued after it first.
+        if (more) {
+            U1TXREG = c;
+        }
         IEC0bits.U1TXIE = 1;
+        if (!more) {
+            break;
+        }
+    }
+}
+#endif
 
-        // We process the char before we try to send it in case writing directly into U1TXREG has
-        // weird side effects.
-        U1TXREG = c;
+/**
+ * With UART1_RX_BATCH the RX interrupt only triggers once the UART's FIFO is 3/4 full, so up to 2
+ * bytes may be left in it at the end of a transmission. Once the line is idle they won't be followed
+ * by any more, so the interrupt is triggered to move them into the receive buffer.
+ */
+static void Uart1FlushIdleReceiver(void)
+{
+#if UART1_RX_BATCH
+    if (U1STAbits.RIDLE && U1STAbits.URXDA) {
+        IFS0bits.U1RXIF = 1;
     }
+#endif
+}
+
+uint16_t Uart1ReadSpan(const uint8_t **span)
+{
+    Uart1FlushIdleReceiver();
+
+    // The interrupt only adds data after the span, so it doesn't need to be disabled here.
+    return CB_PeekSpan(&uart1RxBuffer, span);
+}
+
+void Uart1ReleaseSpan(uint16_t length)
+{
+    IEC0bits.U1RXIE = 0;
+    CB_Remove(&uart1RxBuffer, length);
+    IEC0bits.U1RXIE = 1;
 }
 
 int Uart1ReadByte(uint8_t *datum)
 {
+    Uart1FlushIdleReceiver();
+
     IEC0bits.U1RXIE = 0;
     int rv = CB_ReadByte(&uart1RxBuffer, datum);
     IEC0bits.U1RXIE = 1;
@@ -102,9 +240,9 @@ int Uart1ReadByte(uint8_t *datum)
  */
 void Uart1WriteByte(uint8_t datum)
 {
-    IEC0bits.U1TXIE = 0;
-    CB_WriteByte(&uart1TxBuffer, datum);
-    IEC0bits.U1TXIE = 1;
+    U1TX_INT_ENABLE = 0;
+    TxQueueWrite(&uart1TxQueue, UART_LANE_BULK, &datum, 1, NULL);
+    U1TX_INT_ENABLE = 1;
     Uart1StartTransmission();
 }
 
@@ -114,18 +252,66 @@ void Uart1WriteByte(uint8_t datum)
  */
 int Uart1WriteData(const void *data, size_t length)
 {
-    IEC0bits.U1TXIE = 0;
-    int success = CB_WriteMany(&uart1TxBuffer, data, length, true);
-    IEC0bits.U1TXIE = 1;
-    if (success) {
+    return Uart1WriteLane(UART_LANE_BULK, data, length, NULL) == UART_WRITE_COMPLETE;
+}
+
+UartWriteResult Uart1WriteLane(UartLane lane, const void *data, uint16_t length, uint16_t *written)
+{
+    U1TX_INT_ENABLE = 0;
+    const UartWriteResult result = TxQueueWrite(&uart1TxQueue, lane, data, length, written);
+    U1TX_INT_ENABLE = 1;
+    if (result != UART_WRITE_FULL) {
         Uart1StartTransmission();
     }
 
-    return success;
+    return result;
+}
+
+uint16_t Uart1GetTxDrops(UartLane lane)
+{
+    return uart1TxQueue.lanes[lane].drops;
+}
+
+uint32_t Uart1GetTxBytes(void)
+{
+    U1TX_INT_ENABLE = 0;
+    const uint32_t sent = uart1TxQueue.sent;
+    U1TX_INT_ENABLE = 1;
+    return sent;
+}
+
+uint32_t Uart1GetRxBytes(void)
+{
+    IEC0bits.U1RXIE = 0;
+    const uint32_t received = u1RxBytes;
+    IEC0bits.U1RXIE = 1;
+    return received;
+}
+
+uint16_t Uart1GetTxQueueLength(void)
+{
+    return TxQueueLength(&uart1TxQueue);
+}
+
+void Uart1SetTimestampSource(uint32_t (*source)(void))
+{
+    timestampSource = source;
+}
+
+uint32_t Uart1GetInterruptTicks(void)
+{
+    IEC0bits.U1RXIE = 0;
+    U1TX_INT_ENABLE = 0;
+    const uint32_t ticks = u1InterruptTicks;
+    U1TX_INT_ENABLE = 1;
+    IEC0bits.U1RXIE = 1;
+    return ticks;
 }
 
 void _ISR _U1RXInterrupt(void)
 {
+    const uint32_t start = timestampSource ? timestampSource() : 0;
+
     // Make sure if there's an overflow error, then we clear it. While this destroys 5 bytes of data,
     // it's like the whole message these bytes are a part of is missing more bytes, and irrecoverably
     // corrupt, so we don't worry about it.
@@ -143,13 +329,39 @@ void _ISR _U1RXInterrupt(void)
         } else {
             c = U1RXREG;
             CB_WriteByte(&uart1RxBuffer, (uint8_t)c);
+            ++u1RxBytes;
         }
     }
 
     // Clear the interrupt flag
     IFS0bits.U1RXIF = 0;
+
+    if (timestampSource) {
+        u1InterruptTicks += timestampSource() - start;
+    }
 }
 
+#if UART1_TX_DMA
+/**
+ * This is the interrupt handler for the end of a DMA4 block, after its last byte was moved into
+ * the UART1 FIFO. The block is removed from the transmission queue and the next one started.
+ */
+void _ISR _DMA4Interrupt(void)
+{
+    const uint32_t start = timestampSource ? timestampSource() : 0;
+
+    TxQueueRemove(&uart1TxQueue, u1TxDmaLength);
+    u1TxDmaLength = 0;
+    Uart1StartDmaBlock();
+
+    // Clear the interrupt flag
+    _DMA4IF = 0;
+
+    if (timestampSource) {
+        u1InterruptTicks += timestampSource() - start;
+    }
+}
+#else
 /**
  * This is the interrupt handler for UART1 transmission.
  * It is called after at least one byte is transmitted (
@@ -159,15 +371,15 @@ void _ISR _U1RXInterrupt(void)
  */
 void _ISR _U1TXInterrupt(void)
 {
+    const uint32_t start = timestampSource ? timestampSource() : 0;
+
     // Due to a bug with the dsPIC33E, this interrupt can trigger prematurely. We sit and poll the
     // TRMT bit to stall until the character is properly transmit.
     while (!U1STAbits.TRMT);
 
-    while (uart1TxBuffer.dataSize > 0 && !U1STAbits.UTXBF) {
-        // A temporary variable is used here because writing directly into U1TXREG causes some weird issues.
-        uint8_t c;
-        CB_ReadByte(&uart1TxBuffer, &c);
-
+    // A temporary variable is used here because writing directly into U1TXREG causes some weird issues.
+    uint8_t c;
+    while (!U1STAbits.UTXBF && TxQueueReadByte(&uart1TxQueue, &c)) {
         // We process the char before we try to send it in case writing directly into U1TXREG has
         // weird side effects.
         U1TXREG = c;
@@ -175,4 +387,9 @@ void _ISR _U1TXInterrupt(void)
 
     // Clear the interrupt flag
     IFS0bits.U1TXIF = 0;
+
+    if (timestampSource) {
+        u1InterruptTicks += timestampSource() - start;
+    }
 }
+#endif
@@ -4,12 +4,39 @@
 // USAGE:
 // Add Uart1Init() to an initialization sequence called once on startup.
 // Use Uart1Write*Data() to push appropriately-sized data chunks into the queue and begin transmission.
-// Use Uart1ReadByte() to read bytes out of the buffer
+// Use Uart1WriteLane() to queue control-plane responses, like acknowledgements, ahead of bulk data.
+// Use Uart1ReadByte() to read bytes out of the buffer, or Uart1ReadSpan() and Uart1ReleaseSpan() to
+// read whole chunks of them.
 
 #include <stddef.h>
 #include <stdint.h>
 
+#include "TxQueue.h"
+
+// The sizes of the receive buffer and of the bulk transmit lane, and of the control transmit lane.
 #define UART1_BUFFER_SIZE 1024
+#define UART1_CONTROL_BUFFER_SIZE 256
+
+/**
+ * Define as 1 to only trigger the receive interrupt once the UART's 4-byte FIFO is 3/4 full instead
+ * of on every character, with any bytes below that picked up by the read functions once the line is
+ * idle. At 115200 baud this cuts the time the interrupt has to empty the FIFO before it overruns
+ * from ~3 character times (~260us) to ~2 (~170us). That margin hasn't been measured against the
+ * worst-case interrupt load on any node, so it's off by default.
+ */
+#ifndef UART1_RX_BATCH
+#define UART1_RX_BATCH 0
+#endif
+
+/**
+ * Define as 1 to transmit with DMA channel 4, which moves whole writes from the transmit queue into
+ * the UART and only interrupts once per write, instead of the UART1 TX interrupt moving every few
+ * bytes. It's off by default as the dsPIC33EP256MC502 has no DMA4, and on the dsPIC33F
+ * the transmit buffer then has to fit into the 2KB of DMA RAM next to UART2's.
+ */
+#ifndef UART1_TX_DMA
+#define UART1_TX_DMA 0
+#endif
 
 /**
  * Initializes the UART1 peripheral according to the BRG SFR value passed to it.
@@ -30,6 +57,21 @@ void Uart1ChangeBaudRate(uint16_t brgRegister);
  */
 int Uart1ReadByte(uint8_t *datum);
 
+/**
+ * Points to the received data at the front of the receive buffer, for parsing it as a whole chunk
+ * without copying it out byte by byte. It stays in the buffer until Uart1ReleaseSpan() is called,
+ * and as the buffer wraps around there may be more data after the span even if all of it's used.
+ * @param span Where to store a pointer to the first byte.
+ * @return The number of bytes in the span, 0 if nothing was received.
+ */
+uint16_t Uart1ReadSpan(const uint8_t **span);
+
+/**
+ * Removes the data read with Uart1ReadSpan() from the receive buffer.
+ * @param length The number of bytes used, at most the length of the span.
+ */
+void Uart1ReleaseSpan(uint16_t length);
+
 /**
  * This function starts a transmission sequence after enqueuing a single byte into
  * the buffer.
@@ -38,8 +80,53 @@ void Uart1WriteByte(uint8_t datum);
 
 /**
  * This function augments the Uart1WriteByte() function by providing an interface
- * that enqueues multiple bytes.
+ * that enqueues multiple bytes. They're only queued if all of them fit in the bulk lane.
  */
 int Uart1WriteData(const void *data, size_t length);
 
+/**
+ * Queues data in a transmit lane, see TxQueueWrite(). Data in the control lane is transmitted
+ * before the bulk lane's, though never in the middle of another write.
+ * @param lane The lane to queue the data in.
+ * @param data The data.
+ * @param length The length of the data in bytes.
+ * @param written NULL for all-or-nothing writes, otherwise where to store how much was written.
+ * @return Whether the data was completely, partially, or not written at all.
+ */
+UartWriteResult Uart1WriteLane(UartLane lane, const void *data, uint16_t length, uint16_t *written);
+
+/**
+ * Returns the number of writes to a lane that didn't (completely) fit, since Uart1Init().
+ */
+uint16_t Uart1GetTxDrops(UartLane lane);
+
+/**
+ * Returns the total number of bytes transmitted, wrapping around. Bytes are counted once the
+ * transmitter has taken them out of the queue.
+ */
+uint32_t Uart1GetTxBytes(void);
+
+/**
+ * Returns the total number of bytes received, wrapping around.
+ */
+uint32_t Uart1GetRxBytes(void);
+
+/**
+ * Returns the number of bytes waiting in all lanes of the transmission queue. When transmitting
+ * with DMA this includes the whole span DMA4 is working on.
+ */
+uint16_t Uart1GetTxQueueLength(void);
+
+/**
+ * Sets the clock used to measure the time spent in the UART1 interrupts (including DMA4's when
+ * transmitting with DMA), which is only measured once a source is set.
+ * @param source A function returning the current time in arbitrary ticks.
+ */
+void Uart1SetTimestampSource(uint32_t (*source)(void));
+
+/**
+ * Returns the total time spent in the UART1 interrupts, in ticks of the timestamp source.
+ */
+uint32_t Uart1GetInterruptTicks(void);
+
 #endif // UART1_H
@@ -9,8 +9,39 @@
 
 static CircularBuffer uart2RxBuffer;
 static uint8_t u2RxBuf[UART2_BUFFER_SIZE];
-static CircularBuffer uart2TxBuffer;
-static uint8_t u2TxBuf[UART2_BUFFER_SIZE];
+
+#if UART2_RX_BATCH
+#define UART2_RX_INT UART_INT_RX_3_4_FUL
+#else
+#define UART2_RX_INT UART_INT_RX_CHAR
+#endif
+
+// The total number of bytes received, wrapping around.
+static uint32_t u2RxBytes = 0;
+
+// The transmit lanes share a single array, the control lane first.
+static TxQueue uart2TxQueue;
+#if UART2_TX_DMA && defined(__dsPIC33F__)
+// The dsPIC33F's DMA channels can only read from DMA RAM.
+static uint8_t u2TxBuf[UART2_CONTROL_BUFFER_SIZE + UART2_BUFFER_SIZE] __attribute__((space(dma)));
+#else
+static uint8_t u2TxBuf[UART2_CONTROL_BUFFER_SIZE + UART2_BUFFER_SIZE];
+#endif
+
+#if UART2_TX_DMA
+// The number of bytes of the current span of uart2TxQueue that DMA3 is transmitting. They're only
+// removed from the queue once the block completes, so they can't be overwritten before that.
+static uint16_t u2TxDmaLength;
+
+// Transmission is controlled by the DMA3 block interrupt instead of the UART2 TX interrupt.
+#define U2TX_INT_ENABLE _DMA3IE
+#else
+#define U2TX_INT_ENABLE IEC1bits.U2TXIE
+#endif
+
+// The time spent in the UART2 interrupts, see Uart2SetTimestampSource().
+static uint32_t (*timestampSource)(void);
+static volatile uint32_t u2InterruptTicks;
 
 /*
  * Private functions.
@@ -29,24 +60,59 @@ void Uart2Init(uint16_t brgRegister)
 {
     // First initialize the necessary circular buffers.
     CB_Init(&uart2RxBuffer, u2RxBuf, sizeof(u2RxBuf));
-    CB_Init(&uart2TxBuffer, u2TxBuf, sizeof(u2TxBuf));
+    uint8_t *const lanes[UART_LANES] = {u2TxBuf, &u2TxBuf[UART2_CONTROL_BUFFER_SIZE]};
+    const uint16_t laneSizes[UART_LANES] = {UART2_CONTROL_BUFFER_SIZE, UART2_BUFFER_SIZE};
+    TxQueueInit(&uart2TxQueue, lanes, laneSizes);
 
     // If the UART was already opened, close it first. This should also clear the transmit/receive
     // buffers so we won't have left-over data around when we re-initialize, if we are.
     CloseUART2();
 
+#if UART2_TX_DMA
+    // Stop any transmission in progress, as its data was just cleared.
+    DMA3CONbits.CHEN = 0;
+    u2TxDmaLength = 0;
+
+    // Configure and open the port. The UART2 TX interrupt requests a DMA transfer every time a
+    // character moves into the shift register, so there's always room in the FIFO for it.
+    OpenUART2(UART_EN & UART_IDLE_CON & UART_IrDA_DISABLE & UART_MODE_FLOW & UART_UEN_00 &
+        UART_EN_WAKE & UART_DIS_LOOPBACK & UART_DIS_ABAUD & UART_NO_PAR_8BIT & UART_UXRX_IDLE_ONE &
+        UART_BRGH_SIXTEEN & UART_1STOPBIT,
+        UART_INT_TX & UART_IrDA_POL_INV_ZERO & UART_SYNC_BREAK_DISABLED & UART_TX_ENABLE &
+        UART2_RX_INT & UART_ADR_DETECT_DIS & UART_RX_OVERRUN_CLEAR,
+        brgRegister
+    );
+
+    // Only the RX interrupt runs on the CPU, at priority level 6 (arbitrary).
+    ConfigIntUART2(UART_RX_INT_EN & UART_RX_INT_PR6 & UART_TX_INT_DIS & UART_TX_INT_PR6);
+
+    // DMA3 moves single bytes from RAM into U2TXREG, stopping after every block. The address and
+    // length of each block are set by Uart2StartTransmission().
+    DMA3CON = 0;
+    DMA3CONbits.SIZE = 1; // Bytes
+    DMA3CONbits.DIR = 1; // From RAM to the peripheral
+    DMA3CONbits.MODE = 1; // One-shot, ping-pong disabled
+    DMA3REQ = 0x1F; // Specify the UART2 TX peripheral for DMA3. See the device-specific manual.
+    DMA3PAD = (uint16_t)&U2TXREG;
+
+    // And interrupt at the end of every block, at the same priority as the RX interrupt.
+    _DMA3IF = 0;
+    _DMA3IP = 6;
+    _DMA3IE = 1;
+#else
     // Configure and open the port.
     OpenUART2(UART_EN & UART_IDLE_CON & UART_IrDA_DISABLE & UART_MODE_FLOW & UART_UEN_00 &
         UART_EN_WAKE & UART_DIS_LOOPBACK & UART_DIS_ABAUD & UART_NO_PAR_8BIT & UART_UXRX_IDLE_ONE &
         UART_BRGH_SIXTEEN & UART_1STOPBIT,
         UART_INT_TX_LAST_CH & UART_IrDA_POL_INV_ZERO & UART_SYNC_BREAK_DISABLED & UART_TX_ENABLE &
-        UART_INT_RX_CHAR & UART_ADR_DETECT_DIS & UART_RX_OVERRUN_CLEAR,
+        UART2_RX_INT & UART_ADR_DETECT_DIS & UART_RX_OVERRUN_CLEAR,
         brgRegister
     );
 
     // Setup interrupts for proper UART communication. Enable both TX and RX interrupts at
     // priority level 6 (arbitrary).
     ConfigIntUART2(UART_RX_INT_EN & UART_RX_INT_PR6 & UART_TX_INT_EN & UART_TX_INT_PR6);
+#endif
 }
 
 void Uart2ChangeBaudRate(uint16_t brgRegister)
@@ -64,6 +130,41 @@ void Uart2ChangeBaudRate(uint16_t brgRegister)
     U2STAbits.UTXEN = utxen;
 }
 
+#if UART2_TX_DMA
+/**
+ * Hands the next contiguous span of the transmission queue to DMA3, unless it's still busy with
+ * the previous one. Must be called with the DMA3 interrupt disabled or from within it.
+ */
+static void Uart2StartDmaBlock(void)
+{
+    const uint8_t *span;
+    if (u2TxDmaLength > 0) {
+        return;
+    }
+    const uint16_t length = TxQueuePeekSpan(&uart2TxQueue, &span);
+    if (length > 0) {
+#ifdef __dsPIC33F__
+        DMA3STA = __builtin_dmaoffset(u2TxBuf) + (uint16_t)(span - u2TxBuf);
+#else
+        DMA3STAL = (uint16_t)span;
+        DMA3STAH = 0;
+#endif
+        DMA3CNT = length - 1;
+        u2TxDmaLength = length;
+        DMA3CONbits.CHEN = 1;
+
+        // The UART only requests a byte after it sent one, so request the first.
+        DMA3REQbits.FORCE = 1;
+    }
+}
+
+void Uart2StartTransmission(void)
+{
+    _DMA3IE = 0;
+    Uart2StartDmaBlock();
+    _DMA3IE = 1;
+}
+#else
 /**
  * This function actually initiates transmission. It
  * attempts to start transmission with the first element
@@ -75,21 +176,58 @@ void Uart2ChangeBaudRate(uint16_t brgRegister)
  */
 void Uart2StartTransmission(void)
 {
-    while (uart2TxBuffer.dataSize > 0 && !U2STAbits.UTXBF) {
+    while (!U2STAbits.UTXBF) {
         // A temporary variable is used here because writing directly into U2TXREG causes some weird issues.
         uint8_t c;
         IEC1bits.U2TXIE = 0;
-        CB_ReadByte(&uart2TxBuffer, &c);
+        const bool more = TxQueueReadByte(&uart2TxQueue, &c);
+
+        // The byte has to be in the FIFO before the interrupt is enabled again, otherwise the
+        // interrupt can send the bytes queued after it first.
+        if (more) {
+            U2TXREG = c;
+        }
         IEC1bits.U2TXIE = 1;
+        if (!more) {
+            break;
+        }
+    }
+}
+#endif
 
-        // We process the char before we try to send it in case writing directly into U2TXREG has
-        // weird side effects.
-        U2TXREG = c;
+/**
+ * With UART2_RX_BATCH the RX interrupt only triggers once the UART's FIFO is 3/4 full, so up to 2
+ * bytes may be left in it at the end of a transmission. Once the line is idle they won't be followed
+ * by any more, so the interrupt is triggered to move them into the receive buffer.
+ */
+static void Uart2FlushIdleReceiver(void)
+{
+#if UART2_RX_BATCH
+    if (U2STAbits.RIDLE && U2STAbits.URXDA) {
+        IFS1bits.U2RXIF = 1;
     }
+#endif
+}
+
+uint16_t Uart2ReadSpan(const uint8_t **span)
+{
+    Uart2FlushIdleReceiver();
+
+    // The interrupt only adds data after the span, so it doesn't need to be disabled here.
+    return CB_PeekSpan(&uart2RxBuffer, span);
+}
+
+void Uart2ReleaseSpan(uint16_t length)
+{
+    IEC1bits.U2RXIE = 0;
+    CB_Remove(&uart2RxBuffer, length);
+    IEC1bits.U2RXIE = 1;
 }
 
 int Uart2ReadByte(uint8_t *datum)
 {
+    Uart2FlushIdleReceiver();
+
     IEC1bits.U2RXIE = 0;
     int rv = CB_ReadByte(&uart2RxBuffer, datum);
     IEC1bits.U2RXIE = 1;
@@ -102,9 +240,9 @@ int Uart2ReadByte(uint8_t *datum)
  */
 void Uart2WriteByte(uint8_t datum)
 {
-    IEC1bits.U2TXIE = 0;
-    CB_WriteByte(&uart2TxBuffer, datum);
-    IEC1bits.U2TXIE = 1;
+    U2TX_INT_ENABLE = 0;
+    TxQueueWrite(&uart2TxQueue, UART_LANE_BULK, &datum, 1, NULL);
+    U2TX_INT_ENABLE = 1;
     Uart2StartTransmission();
 }
 
@@ -114,18 +252,66 @@ void Uart2WriteByte(uint8_t datum)
  */
 int Uart2WriteData(const void *data, size_t length)
 {
-    IEC1bits.U2TXIE = 0;
-    int success = CB_WriteMany(&uart2TxBuffer, data, length, true);
-    IEC1bits.U2TXIE = 1;
-    if (success) {
+    return Uart2WriteLane(UART_LANE_BULK, data, length, NULL) == UART_WRITE_COMPLETE;
+}
+
+UartWriteResult Uart2WriteLane(UartLane lane, const void *data, uint16_t length, uint16_t *written)
+{
+    U2TX_INT_ENABLE = 0;
+    const UartWriteResult result = TxQueueWrite(&uart2TxQueue, lane, data, length, written);
+    U2TX_INT_ENABLE = 1;
+    if (result != UART_WRITE_FULL) {
         Uart2StartTransmission();
     }
 
-    return success;
+    return result;
+}
+
+uint16_t Uart2GetTxDrops(UartLane lane)
+{
+    return uart2TxQueue.lanes[lane].drops;
+}
+
+uint32_t Uart2GetTxBytes(void)
+{
+    U2TX_INT_ENABLE = 0;
+    const uint32_t sent = uart2TxQueue.sent;
+    U2TX_INT_ENABLE = 1;
+    return sent;
+}
+
+uint32_t Uart2GetRxBytes(void)
+{
+    IEC1bits.U2RXIE = 0;
+    const uint32_t received = u2RxBytes;
+    IEC1bits.U2RXIE = 1;
+    return received;
+}
+
+uint16_t Uart2GetTxQueueLength(void)
+{
+    return TxQueueLength(&uart2TxQueue);
+}
+
+void Uart2SetTimestampSource(uint32_t (*source)(void))
+{
+    timestampSource = source;
+}
+
+uint32_t Uart2GetInterruptTicks(void)
+{
+    IEC1bits.U2RXIE = 0;
+    U2TX_INT_ENABLE = 0;
+    const uint32_t ticks = u2InterruptTicks;
+    U2TX_INT_ENABLE = 1;
+    IEC1bits.U2RXIE = 1;
+    return ticks;
 }
 
 void _ISR _U2RXInterrupt(void)
 {
+    const uint32_t start = timestampSource ? timestampSource() : 0;
+
     // Make sure if there's an overflow error, then we clear it. While this destroys 5 bytes of data,
     // it's like the whole message these bytes are a part of is missing more bytes, and irrecoverably
     // corrupt, so we don't worry about it.
@@ -143,13 +329,39 @@ void _ISR _U2RXInterrupt(void)
         } else {
             c = U2RXREG;
             CB_WriteByte(&uart2RxBuffer, (uint8_t)c);
+            ++u2RxBytes;
         }
     }
 
     // Clear the interrupt flag
     IFS1bits.U2RXIF = 0;
+
+    if (timestampSource) {
+        u2InterruptTicks += timestampSource() - start;
+    }
 }
 
+#if UART2_TX_DMA
+/**
+ * This is the interrupt handler for the end of a DMA3 block, after its last byte was moved into
+ * the UART2 FIFO. The block is removed from the transmission queue and the next one started.
+ */
+void _ISR _DMA3Interrupt(void)
+{
+    const uint32_t start = timestampSource ? timestampSource() : 0;
+
+    TxQueueRemove(&uart2TxQueue, u2TxDmaLength);
+    u2TxDmaLength = 0;
+    Uart2StartDmaBlock();
+
+    // Clear the interrupt flag
+    _DMA3IF = 0;
+
+    if (timestampSource) {
+        u2InterruptTicks += timestampSource() - start;
+    }
+}
+#else
 /**
  * This is the interrupt handler for UART2 transmission.
  * It is called after at least one byte is transmitted (
@@ -159,15 +371,15 @@ void _ISR _U2RXInterrupt(void)
  */
 void _ISR _U2TXInterrupt(void)
 {
+    const uint32_t start = timestampSource ? timestampSource() : 0;
+
     // Due to a bug with the dsPIC33E, this interrupt can trigger prematurely. We sit and poll the
     // TRMT bit to stall until the character is properly transmit.
     while (!U2STAbits.TRMT);
 
-    while (uart2TxBuffer.dataSize > 0 && !U2STAbits.UTXBF) {
-        // A temporary variable is used here because writing directly into U2TXREG causes some weird issues.
-        uint8_t c;
-        CB_ReadByte(&uart2TxBuffer, &c);
-
+    // A temporary variable is used here because writing directly into U2TXREG causes some weird issues.
+    uint8_t c;
+    while (!U2STAbits.UTXBF && TxQueueReadByte(&uart2TxQueue, &c)) {
         // We process the char before we try to send it in case writing directly into U2TXREG has
         // weird side effects.
         U2TXREG = c;
@@ -175,4 +387,9 @@ void _ISR _U2TXInterrupt(void)
 
     // Clear the interrupt flag
     IFS1bits.U2TXIF = 0;
+
+    if (timestampSource) {
+        u2InterruptTicks += timestampSource() - start;
+    }
 }
+#endif
@@ -4,12 +4,43 @@
 // USAGE:
 // Add Uart2Init() to an initialization sequence called once on startup.
 // Use Uart2Write*Data() to push appropriately-sized data chunks into the queue and begin transmission.
-// Use Uart2ReadByte() to read bytes out of the buffer
+// Use Uart2WriteLane() to queue control-plane responses, like acknowledgements, ahead of bulk data.
+// Use Uart2ReadByte() to read bytes out of the buffer, or Uart2ReadSpan() and Uart2ReleaseSpan() to
+// read whole chunks of them.
 
 #include <stddef.h>
 #include <stdint.h>
 
+#include "TxQueue.h"
+
+// The sizes of the receive buffer and of the bulk transmit lane, and of the control transmit lane.
 #define UART2_BUFFER_SIZE 1024
+#define UART2_CONTROL_BUFFER_SIZE 256
+
+/**
+ * Define as 1 to only trigger the receive interrupt once the UART's 4-byte FIFO is 3/4 full instead
+ * of on every character, with any bytes below that picked up by the read functions once the line is
+ * idle. At 115200 baud this cuts the time the interrupt has to empty the FIFO before it overruns
+ * from ~3 character times (~260us) to ~2 (~170us). That margin hasn't been measured against the
+ * worst-case interrupt load on any node, so it's off by default.
+ */
+#ifndef UART2_RX_BATCH
+#define UART2_RX_BATCH 0
+#endif
+
+/**
+ * Transmits with DMA channel 3, which moves whole writes from the transmit queue into the UART and
+ * only interrupts once per write, instead of the UART2 TX interrupt moving every few bytes.
+ * This is on by default on the dsPIC33s. Define as 0 to use the TX interrupt instead, which frees
+ * DMA3 and, on the dsPIC33F, the DMA RAM the transmit buffer is placed in.
+ */
+#ifndef UART2_TX_DMA
+#if defined(__dsPIC33F__) || defined(__dsPIC33E__)
+#define UART2_TX_DMA 1
+#else
+#define UART2_TX_DMA 0
+#endif
+#endif
 
 /**
  * Initializes the UART2 peripheral according to the BRG SFR value passed to it.
@@ -30,6 +61,21 @@ void Uart2ChangeBaudRate(uint16_t brgRegister);
  */
 int Uart2ReadByte(uint8_t *datum);
 
+/**
+ * Points to the received data at the front of the receive buffer, for parsing it as a whole chunk
+ * without copying it out byte by byte. It stays in the buffer until Uart2ReleaseSpan() is called,
+ * and as the buffer wraps around there may be more data after the span even if all of it's used.
+ * @param span Where to store a pointer to the first byte.
+ * @return The number of bytes in the span, 0 if nothing was received.
+ */
+uint16_t Uart2ReadSpan(const uint8_t **span);
+
+/**
+ * Removes the data read with Uart2ReadSpan() from the receive buffer.
+ * @param length The number of bytes used, at most the length of the span.
+ */
+void Uart2ReleaseSpan(uint16_t length);
+
 /**
  * This function starts a transmission sequence after enqueuing a single byte into
  * the buffer.
@@ -38,8 +84,53 @@ void Uart2WriteByte(uint8_t datum);
 
 /**
  * This function augments the Uart2WriteByte() function by providing an interface
- * that enqueues multiple bytes.
+ * that enqueues multiple bytes. They're only queued if all of them fit in the bulk lane.
  */
 int Uart2WriteData(const void *data, size_t length);
 
+/**
+ * Queues data in a transmit lane, see TxQueueWrite(). Data in the control lane is transmitted
+ * before the bulk lane's, though never in the middle of another write.
+ * @param lane The lane to queue the data in.
+ * @param data The data.
+ * @param length The length of the data in bytes.
+ * @param written NULL for all-or-nothing writes, otherwise where to store how much was written.
+ * @return Whether the data was completely, partially, or not written at all.
+ */
+UartWriteResult Uart2WriteLane(UartLane lane, const void *data, uint16_t length, uint16_t *written);
+
+/**
+ * Returns the number of writes to a lane that didn't (completely) fit, since Uart2Init().
+ */
+uint16_t Uart2GetTxDrops(UartLane lane);
+
+/**
+ * Returns the total number of bytes transmitted, wrapping around. Bytes are counted once the
+ * transmitter has taken them out of the queue.
+ */
+uint32_t Uart2GetTxBytes(void);
+
+/**
+ * Returns the total number of bytes received, wrapping around.
+ */
+uint32_t Uart2GetRxBytes(void);
+
+/**
+ * Returns the number of bytes waiting in all lanes of the transmission queue. When transmitting
+ * with DMA this includes the whole span DMA3 is working on.
+ */
+uint16_t Uart2GetTxQueueLength(void);
+
+/**
+ * Sets the clock used to measure the time spent in the UART2 interrupts (including DMA3's when
+ * transmitting with DMA), which is only measured once a source is set.
+ * @param source A function returning the current time in arbitrary ticks.
+ */
+void Uart2SetTimestampSource(uint32_t (*source)(void));
+
+/**
+ * Returns the total time spent in the UART2 interrupts, in ticks of the timestamp source.
+ */
+uint32_t Uart2GetInterruptTicks(void);
+
 #endif // UART2_H
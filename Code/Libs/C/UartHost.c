@@ -0,0 +1,846 @@
+#define _DEFAULT_SOURCE
+#define _XOPEN_SOURCE 700
+
+#include "UartHost.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#include "CircularBuffer.h"
+#include "TxQueue.h"
+
+// One direction of a link, holding the bytes on their way across it along with when they arrive.
+typedef struct {
+    uint8_t data[UART_HOST_LINE_SIZE];
+    uint64_t due[UART_HOST_LINE_SIZE];
+    uint16_t first;
+    uint16_t count;
+    uint64_t nextFreeNs; // When the link finishes sending the last byte it was given.
+    bool idle;           // Whether the link ran out of bytes to send since then.
+    uint16_t frameLeft;  // The bytes left in the current frame of the radio model.
+    bool frameLost;
+} Line;
+
+typedef struct {
+    int fd;         // The connection, -1 if there's none.
+    int listenFd;   // The TCP server socket, -1 if not listening.
+    int slaveFd;    // Our own handle on the pty's slave side, so it stays usable between clients.
+    char link[256]; // The symlink to the pty, empty if there's none.
+    uint32_t baud;
+    bool pace;
+    UartHostRadio radio;
+    Line tx;        // From the firmware to the endpoint.
+    Line rx;        // From the endpoint to the firmware.
+    TxQueue txQueue;
+    CircularBuffer rxBuffer;
+} Port;
+
+// The lines are large, so keep them out of the initializer and mark the ports closed at first use.
+static Port ports[UART_HOST_PORTS];
+static bool portsInitialized = false;
+
+static uint8_t u1TxBuf[UART1_CONTROL_BUFFER_SIZE + UART1_BUFFER_SIZE];
+static uint8_t u1RxBuf[UART1_BUFFER_SIZE];
+static uint8_t u2TxBuf[UART2_CONTROL_BUFFER_SIZE + UART2_BUFFER_SIZE];
+static uint8_t u2RxBuf[UART2_BUFFER_SIZE];
+
+UartHostStats uartHostStats[UART_HOST_PORTS];
+
+/**
+ * @return The time from a monotonic clock in nanoseconds.
+ */
+static uint64_t NowNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void PortsInit(void)
+{
+    if (!portsInitialized) {
+        uint8_t i;
+        for (i = 0; i < UART_HOST_PORTS; ++i) {
+            ports[i].fd = -1;
+            ports[i].listenFd = -1;
+            ports[i].slaveFd = -1;
+        }
+        portsInitialized = true;
+    }
+}
+
+static void LineReset(Line *l)
+{
+    l->first = 0;
+    l->count = 0;
+    l->nextFreeNs = 0;
+    l->idle = true;
+    l->frameLeft = 0;
+    l->frameLost = false;
+}
+
+/**
+ * Converts a BRG register value into a baud rate, with the same 16x clock that Uart*Init() sets up.
+ */
+static uint32_t BrgToBaud(uint16_t brgRegister)
+{
+    return UART_HOST_FCY / (16UL * ((uint32_t)brgRegister + 1));
+}
+
+/**
+ * The time each byte takes on the link, with 10 bits per byte at the baud rate, or 0 if it isn't
+ * limited.
+ */
+static uint64_t ByteNs(const Port *p)
+{
+    uint32_t rate = 0;
+    if (p->pace && p->baud) {
+        rate = p->baud / 10;
+    }
+    if (p->radio.bandwidth && (!rate || p->radio.bandwidth < rate)) {
+        rate = p->radio.bandwidth;
+    }
+    return rate ? 1000000000ULL / rate : 0;
+}
+
+/**
+ * Works out how many bytes the link could have started sending by now.
+ */
+static uint16_t LineAvailable(const Port *p, Line *l, uint64_t now)
+{
+    const uint16_t room = UART_HOST_LINE_SIZE - l->count;
+    const uint64_t byteNs = ByteNs(p);
+    if (!byteNs) {
+        return room;
+    }
+
+    // A link that was busy catches up on the bytes it would have sent since it was last pumped, but
+    // an idle link starts now.
+    if (l->idle) {
+        if (l->nextFreeNs < now) {
+            l->nextFreeNs = now;
+        }
+        l->idle = false;
+    }
+    if (l->nextFreeNs > now) {
+        return 0;
+    }
+    const uint64_t n = (now - l->nextFreeNs) / byteNs + 1;
+    return (n < room) ? (uint16_t)n : room;
+}
+
+/**
+ * Sends a byte across the link, which is possibly lost on the way.
+ * @param lost Incremented if the byte is lost.
+ */
+static void LineSend(const Port *p, Line *l, uint8_t c, uint64_t now, uint64_t *lost)
+{
+    const uint64_t byteNs = ByteNs(p);
+    uint64_t sent = now;
+    if (byteNs) {
+        l->nextFreeNs += byteNs;
+        sent = l->nextFreeNs;
+    }
+
+    // Decide whether every frame is lost as it starts.
+    if (l->frameLeft == 0) {
+        l->frameLeft = p->radio.frameSize ? p->radio.frameSize : 1;
+        l->frameLost = p->radio.lossChance > 0 && rand() / (RAND_MAX + 1.0) < p->radio.lossChance;
+    }
+    --l->frameLeft;
+    if (l->frameLost) {
+        ++*lost;
+        return;
+    }
+
+    const uint16_t i = (l->first + l->count) % UART_HOST_LINE_SIZE;
+    l->data[i] = c;
+    l->due[i] = sent + (uint64_t)p->radio.latencyUs * 1000;
+    ++l->count;
+}
+
+/**
+ * The number of contiguous bytes at the front of the line that have arrived by now.
+ */
+static uint16_t LineArrived(const Line *l, uint64_t now)
+{
+    uint16_t n = 0;
+    while (n < l->count && l->first + n < UART_HOST_LINE_SIZE && l->due[l->first + n] <= now) {
+        ++n;
+    }
+    return n;
+}
+
+static void LineRemove(Line *l, uint16_t n)
+{
+    l->first = (l->first + n) % UART_HOST_LINE_SIZE;
+    l->count -= n;
+}
+
+static void CloseConnection(Port *p)
+{
+    if (p->fd >= 0 && p->fd != p->listenFd) {
+        close(p->fd);
+    }
+    p->fd = -1;
+}
+
+/**
+ * Moves queued data onto the link, and data that has crossed it to the endpoint.
+ */
+static void PumpTx(Port *p, UartHostStats *s, uint64_t now)
+{
+    uint16_t n = LineAvailable(p, &p->tx, now);
+    uint8_t c;
+    while (n-- > 0 && TxQueueReadByte(&p->txQueue, &c)) {
+        LineSend(p, &p->tx, c, now, &s->txLost);
+    }
+    if (TxQueueLength(&p->txQueue) == 0) {
+        p->tx.idle = true;
+    }
+
+    // Like a UART, the link never waits for the other side, so whatever it can't take is lost.
+    while ((n = LineArrived(&p->tx, now)) > 0) {
+        ssize_t written = -1;
+        if (p->fd >= 0) {
+            written = write(p->fd, &p->tx.data[p->tx.first], n);
+            if (written < 0 && errno != EAGAIN && errno != EWOULDBLOCK && p->listenFd >= 0) {
+                CloseConnection(p);
+            }
+        }
+        if (written > 0) {
+            s->txBytes += (uint64_t)written;
+            n = (uint16_t)written;
+        } else {
+            s->txDiscarded += n;
+        }
+        LineRemove(&p->tx, n);
+    }
+}
+
+/**
+ * Reads data from the endpoint onto the link, and moves data that has crossed it into the receive
+ * buffer.
+ */
+static void PumpRx(Port *p, UartHostStats *s, uint64_t now)
+{
+    uint16_t n = LineAvailable(p, &p->rx, now);
+    while (n > 0) {
+        uint8_t buf[512];
+        const size_t wanted = (n < sizeof(buf)) ? n : sizeof(buf);
+        const ssize_t r = (p->fd >= 0) ? read(p->fd, buf, wanted) : -1;
+        if (r == 0 && p->listenFd >= 0) {
+            CloseConnection(p);
+        }
+        if (r <= 0) {
+            p->rx.idle = true;
+            break;
+        }
+
+        ssize_t i;
+        for (i = 0; i < r; ++i) {
+            LineSend(p, &p->rx, buf[i], now, &s->rxLost);
+        }
+        n -= (uint16_t)r;
+        if ((size_t)r < wanted) {
+            p->rx.idle = true;
+            break;
+        }
+    }
+
+    while ((n = LineArrived(&p->rx, now)) > 0) {
+        uint16_t i;
+        for (i = 0; i < n; ++i) {
+            if (CB_WriteByte(&p->rxBuffer, p->rx.data[p->rx.first + i])) {
+                ++s->rxBytes;
+            } else {
+                ++s->rxOverruns;
+            }
+        }
+        LineRemove(&p->rx, n);
+    }
+}
+
+/**
+ * Takes over from a previous TCP client when a new one connects.
+ */
+static void Accept(Port *p, UartHostPort port)
+{
+    if (p->listenFd < 0) {
+        return;
+    }
+    const int fd = accept(p->listenFd, NULL, NULL);
+    if (fd >= 0) {
+        CloseConnection(p);
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        const int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        p->fd = fd;
+        printf("UART%d: TCP client connected.\n", port + 1);
+    }
+}
+
+/**
+ * Opens a new pty, optionally symlinking it to a path.
+ * @return true if it could be opened.
+ */
+static bool OpenPty(Port *p, UartHostPort port, const char *link)
+{
+    const int fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (fd < 0 || grantpt(fd) != 0 || unlockpt(fd) != 0) {
+        perror("posix_openpt");
+        if (fd >= 0) {
+            close(fd);
+        }
+        return false;
+    }
+    const char *name = ptsname(fd);
+
+    // Make it a raw serial port, which is kept by holding the slave side open.
+    p->slaveFd = open(name, O_RDWR | O_NOCTTY);
+    if (p->slaveFd < 0) {
+        perror(name);
+        close(fd);
+        return false;
+    }
+    struct termios tio;
+    if (tcgetattr(p->slaveFd, &tio) == 0) {
+        cfmakeraw(&tio);
+        tcsetattr(p->slaveFd, TCSANOW, &tio);
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    p->fd = fd;
+
+    if (link) {
+        unlink(link);
+        if (symlink(name, link) != 0) {
+            perror(link);
+        } else {
+            strncpy(p->link, link, sizeof(p->link) - 1);
+            p->link[sizeof(p->link) - 1] = '\0';
+        }
+    }
+    printf("UART%d: %s%s%s\n", port + 1, name, link ? " -> " : "", link ? link : "");
+    return true;
+}
+
+/**
+ * Listens on a TCP port if `host` is NULL, otherwise connects to a TCP server.
+ * @return true if it could be opened.
+ */
+static bool OpenTcp(Port *p, UartHostPort port, const char *host, const char *service)
+{
+    struct addrinfo hints = {0};
+    struct addrinfo *result;
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = host ? 0 : AI_PASSIVE;
+    const int error = getaddrinfo(host, service, &hints, &result);
+    if (error != 0) {
+        fprintf(stderr, "%s: %s\n", service, gai_strerror(error));
+        return false;
+    }
+
+    const int fd = socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+    const int one = 1;
+    bool success = fd >= 0;
+    if (success && !host) {
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        success = bind(fd, result->ai_addr, result->ai_addrlen) == 0 && listen(fd, 1) == 0;
+    } else if (success) {
+        success = connect(fd, result->ai_addr, result->ai_addrlen) == 0;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    freeaddrinfo(result);
+    if (!success) {
+        perror(service);
+        if (fd >= 0) {
+            close(fd);
+        }
+        return false;
+    }
+
+    // Lost connections are handled when reading and writing.
+    signal(SIGPIPE, SIG_IGN);
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    if (host) {
+        p->fd = fd;
+        printf("UART%d: connected to %s:%s\n", port + 1, host, service);
+    } else {
+        p->listenFd = fd;
+        printf("UART%d: listening on TCP port %s\n", port + 1, service);
+    }
+    return true;
+}
+
+bool UartHostOpen(UartHostPort port, const char *endpoint)
+{
+    UartHostClose(port);
+    Port *p = &ports[port];
+    LineReset(&p->tx);
+    LineReset(&p->rx);
+    memset(&uartHostStats[port], 0, sizeof(uartHostStats[port]));
+
+    if (!strcmp(endpoint, "pty")) {
+        return OpenPty(p, port, NULL);
+    } else if (!strncmp(endpoint, "pty:", 4)) {
+        return OpenPty(p, port, endpoint + 4);
+    } else if (!strncmp(endpoint, "tcp:", 4)) {
+        char host[256];
+        strncpy(host, endpoint + 4, sizeof(host) - 1);
+        host[sizeof(host) - 1] = '\0';
+        char *colon = strrchr(host, ':');
+        if (!colon) {
+            return OpenTcp(p, port, NULL, host);
+        }
+        *colon = '\0';
+        return OpenTcp(p, port, host, colon + 1);
+    }
+
+    fprintf(stderr, "Unknown UART endpoint: %s\n", endpoint);
+    return false;
+}
+
+void UartHostClose(UartHostPort port)
+{
+    PortsInit();
+    Port *p = &ports[port];
+    CloseConnection(p);
+    if (p->listenFd >= 0) {
+        close(p->listenFd);
+        p->listenFd = -1;
+    }
+    if (p->slaveFd >= 0) {
+        close(p->slaveFd);
+        p->slaveFd = -1;
+    }
+    if (p->link[0]) {
+        unlink(p->link);
+        p->link[0] = '\0';
+    }
+}
+
+void UartHostSetPacing(UartHostPort port, bool pace)
+{
+    ports[port].pace = pace;
+}
+
+void UartHostSetRadio(UartHostPort port, const UartHostRadio *radio)
+{
+    if (radio) {
+        ports[port].radio = *radio;
+    } else {
+        memset(&ports[port].radio, 0, sizeof(ports[port].radio));
+    }
+}
+
+void UartHostPoll(int timeoutMs)
+{
+    PortsInit();
+
+    // Wait for input, but only as long as there's nothing still moving that needs pumping.
+    if (timeoutMs > 0) {
+        struct pollfd fds[2 * UART_HOST_PORTS];
+        nfds_t nfds = 0;
+        uint8_t i;
+        for (i = 0; i < UART_HOST_PORTS; ++i) {
+            const Port *p = &ports[i];
+            if (p->tx.count || p->rx.count || (p->txQueue.lanes[0].data.data && TxQueueLength(&p->txQueue))) {
+                timeoutMs = 1;
+            }
+            if (p->fd >= 0) {
+                fds[nfds].fd = p->fd;
+                fds[nfds++].events = POLLIN;
+            }
+            if (p->listenFd >= 0) {
+                fds[nfds].fd = p->listenFd;
+                fds[nfds++].events = POLLIN;
+            }
+        }
+        poll(fds, nfds, timeoutMs);
+    }
+
+    const uint64_t now = NowNs();
+    uint8_t i;
+    for (i = 0; i < UART_HOST_PORTS; ++i) {
+        Port *p = &ports[i];
+        Accept(p, (UartHostPort)i);
+        if (p->rxBuffer.data) {
+            PumpRx(p, &uartHostStats[i], now);
+        }
+        if (p->txQueue.lanes[0].data.data) {
+            PumpTx(p, &uartHostStats[i], now);
+        }
+    }
+}
+
+/**
+ * Sets up the buffers of a UART like Uart*Init(), keeping its endpoint.
+ */
+static void PortInit(Port *p, uint16_t brgRegister, uint8_t *txBuf, uint16_t controlSize,
+                     uint16_t bulkSize, uint8_t *rxBuf, uint16_t rxSize)
+{
+    PortsInit();
+    CB_Init(&p->rxBuffer, rxBuf, rxSize);
+    uint8_t *const lanes[UART_LANES] = {txBuf, &txBuf[controlSize]};
+    const uint16_t laneSizes[UART_LANES] = {controlSize, bulkSize};
+    TxQueueInit(&p->txQueue, lanes, laneSizes);
+    LineReset(&p->tx);
+    LineReset(&p->rx);
+    p->baud = BrgToBaud(brgRegister);
+}
+
+static UartWriteResult PortWrite(UartHostPort port, UartLane lane, const void *data, uint16_t length,
+                                 uint16_t *written)
+{
+    Port *p = &ports[port];
+    const UartWriteResult result = TxQueueWrite(&p->txQueue, lane, data, length, written);
+    if (result != UART_WRITE_FULL) {
+        PumpTx(p, &uartHostStats[port], NowNs());
+    }
+    return result;
+}
+
+void Uart1Init(uint16_t brgRegister)
+{
+    PortInit(&ports[UART_HOST_UART1], brgRegister, u1TxBuf, UART1_CONTROL_BUFFER_SIZE,
+             UART1_BUFFER_SIZE, u1RxBuf, sizeof(u1RxBuf));
+}
+
+void Uart1ChangeBaudRate(uint16_t brgRegister)
+{
+    ports[UART_HOST_UART1].baud = BrgToBaud(brgRegister);
+}
+
+int Uart1ReadByte(uint8_t *datum)
+{
+    return CB_ReadByte(&ports[UART_HOST_UART1].rxBuffer, datum);
+}
+
+uint16_t Uart1ReadSpan(const uint8_t **span)
+{
+    return CB_PeekSpan(&ports[UART_HOST_UART1].rxBuffer, span);
+}
+
+void Uart1ReleaseSpan(uint16_t length)
+{
+    CB_Remove(&ports[UART_HOST_UART1].rxBuffer, length);
+}
+
+void Uart1WriteByte(uint8_t datum)
+{
+    PortWrite(UART_HOST_UART1, UART_LANE_BULK, &datum, 1, NULL);
+}
+
+int Uart1WriteData(const void *data, size_t length)
+{
+    return PortWrite(UART_HOST_UART1, UART_LANE_BULK, data, length, NULL) == UART_WRITE_COMPLETE;
+}
+
+UartWriteResult Uart1WriteLane(UartLane lane, const void *data, uint16_t length, uint16_t *written)
+{
+    return PortWrite(UART_HOST_UART1, lane, data, length, written);
+}
+
+uint16_t Uart1GetTxDrops(UartLane lane)
+{
+    return ports[UART_HOST_UART1].txQueue.lanes[lane].drops;
+}
+
+uint32_t Uart1GetTxBytes(void)
+{
+    return ports[UART_HOST_UART1].txQueue.sent;
+}
+
+uint32_t Uart1GetRxBytes(void)
+{
+    return (uint32_t)uartHostStats[UART_HOST_UART1].rxBytes;
+}
+
+uint16_t Uart1GetTxQueueLength(void)
+{
+    return TxQueueLength(&ports[UART_HOST_UART1].txQueue);
+}
+
+void Uart1SetTimestampSource(uint32_t (*source)(void))
+{
+    // There are no interrupts to time.
+    (void)source;
+}
+
+uint32_t Uart1GetInterruptTicks(void)
+{
+    return 0;
+}
+
+void Uart2Init(uint16_t brgRegister)
+{
+    PortInit(&ports[UART_HOST_UART2], brgRegister, u2TxBuf, UART2_CONTROL_BUFFER_SIZE,
+             UART2_BUFFER_SIZE, u2RxBuf, sizeof(u2RxBuf));
+}
+
+void Uart2ChangeBaudRate(uint16_t brgRegister)
+{
+    ports[UART_HOST_UART2].baud = BrgToBaud(brgRegister);
+}
+
+int Uart2ReadByte(uint8_t *datum)
+{
+    return CB_ReadByte(&ports[UART_HOST_UART2].rxBuffer, datum);
+}
+
+uint16_t Uart2ReadSpan(const uint8_t **span)
+{
+    return CB_PeekSpan(&ports[UART_HOST_UART2].rxBuffer, span);
+}
+
+void Uart2ReleaseSpan(uint16_t length)
+{
+    CB_Remove(&ports[UART_HOST_UART2].rxBuffer, length);
+}
+
+void Uart2WriteByte(uint8_t datum)
+{
+    PortWrite(UART_HOST_UART2, UART_LANE_BULK, &datum, 1, NULL);
+}
+
+int Uart2WriteData(const void *data, size_t length)
+{
+    return PortWrite(UART_HOST_UART2, UART_LANE_BULK, data, length, NULL) == UART_WRITE_COMPLETE;
+}
+
+UartWriteResult Uart2WriteLane(UartLane lane, const void *data, uint16_t length, uint16_t *written)
+{
+    return PortWrite(UART_HOST_UART2, lane, data, length, written);
+}
+
+uint16_t Uart2GetTxDrops(UartLane lane)
+{
+    return ports[UART_HOST_UART2].txQueue.lanes[lane].drops;
+}
+
+uint32_t Uart2GetTxBytes(void)
+{
+    return ports[UART_HOST_UART2].txQueue.sent;
+}
+
+uint32_t Uart2GetRxBytes(void)
+{
+    return (uint32_t)uartHostStats[UART_HOST_UART2].rxBytes;
+}
+
+uint16_t Uart2GetTxQueueLength(void)
+{
+    return TxQueueLength(&ports[UART_HOST_UART2].txQueue);
+}
+
+void Uart2SetTimestampSource(uint32_t (*source)(void))
+{
+    (void)source;
+}
+
+uint32_t Uart2GetInterruptTicks(void)
+{
+    return 0;
+}
+
+#ifdef UNIT_TEST_UART_HOST
+
+#include <assert.h>
+
+/**
+ * Reads everything available from a file descriptor within the given time.
+ * @return The number of bytes read.
+ */
+static size_t ReadFor(int fd, uint8_t *buf, size_t size, int ms)
+{
+    size_t total = 0;
+    const uint64_t end = NowNs() + (uint64_t)ms * 1000000;
+    while (total < size && NowNs() < end) {
+        UartHostPoll(1);
+        const ssize_t r = read(fd, &buf[total], size - total);
+        if (r > 0) {
+            total += (size_t)r;
+        }
+    }
+    return total;
+}
+
+/**
+ * Opens the pty linked at a path as a non-blocking serial port.
+ */
+static int OpenLink(const char *path)
+{
+    const int fd = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK);
+    assert(fd >= 0);
+    return fd;
+}
+
+int main()
+{
+    printf("Running unit tests.\n");
+
+    const char *link = "/tmp/uart_host_test";
+    uint8_t buf[2048];
+
+    // Data moves both ways through a pty.
+    {
+        Uart1Init(21);
+        assert(UartHostOpen(UART_HOST_UART1, "pty:/tmp/uart_host_test"));
+        const int fd = OpenLink(link);
+
+        assert(Uart1WriteData("hello", 5));
+        assert(ReadFor(fd, buf, 5, 100) == 5 && !memcmp(buf, "hello", 5));
+        assert(uartHostStats[UART_HOST_UART1].txBytes == 5);
+
+        assert(write(fd, "abc", 3) == 3);
+        uint8_t c = 0;
+        uint16_t i;
+        for (i = 0; i < 100 && !Uart1ReadByte(&c); ++i) {
+            UartHostPoll(1);
+        }
+        assert(c == 'a');
+        const uint8_t *span;
+        assert(Uart1ReadSpan(&span) == 2 && !memcmp(span, "bc", 2));
+        Uart1ReleaseSpan(2);
+        assert(uartHostStats[UART_HOST_UART1].rxBytes == 3);
+
+        // The control lane still goes next, once the write being transmitted is done.
+        UartHostSetPacing(UART_HOST_UART1, true);
+        memset(buf, 'b', 50);
+        Uart1WriteData(buf, 50);
+        Uart1WriteData(buf, 50);
+        Uart1WriteLane(UART_LANE_CONTROL, "C", 1, NULL);
+        assert(ReadFor(fd, buf, 101, 100) == 101);
+        assert(buf[49] == 'b' && buf[50] == 'C' && buf[100] == 'b');
+        UartHostSetPacing(UART_HOST_UART1, false);
+
+        close(fd);
+        UartHostClose(UART_HOST_UART1);
+        assert(access(link, F_OK) != 0);
+    }
+
+    // Pacing at the baud rate: BRG 21 is 113636 baud, so 1000 bytes take 88ms.
+    {
+        Uart1Init(21);
+        assert(UartHostOpen(UART_HOST_UART1, "pty:/tmp/uart_host_test"));
+        UartHostSetPacing(UART_HOST_UART1, true);
+        const int fd = OpenLink(link);
+
+        memset(buf, 'x', 1000);
+        const uint64_t start = NowNs();
+        assert(Uart1WriteData(buf, 1000));
+        assert(ReadFor(fd, buf, 1000, 500) == 1000);
+        const uint64_t ms = (NowNs() - start) / 1000000;
+        assert(ms >= 85 && ms < 200);
+        UartHostSetPacing(UART_HOST_UART1, false);
+
+        close(fd);
+        UartHostClose(UART_HOST_UART1);
+    }
+
+    // The radio model's latency, bandwidth cap, and losses.
+    {
+        Uart2Init(21);
+        assert(UartHostOpen(UART_HOST_UART2, "pty:/tmp/uart_host_test"));
+        const int fd = OpenLink(link);
+
+        UartHostRadio radio = {0};
+        radio.latencyUs = 50000;
+        UartHostSetRadio(UART_HOST_UART2, &radio);
+        uint64_t start = NowNs();
+        assert(Uart2WriteData("late", 4));
+        assert(ReadFor(fd, buf, 4, 200) == 4);
+        uint64_t ms = (NowNs() - start) / 1000000;
+        assert(ms >= 50 && ms < 100);
+
+        radio.latencyUs = 0;
+        radio.bandwidth = 1000;
+        UartHostSetRadio(UART_HOST_UART2, &radio);
+        start = NowNs();
+        memset(buf, 'y', 50);
+        assert(Uart2WriteData(buf, 50));
+        assert(ReadFor(fd, buf, 50, 500) == 50);
+        ms = (NowNs() - start) / 1000000;
+        assert(ms >= 45 && ms < 100);
+
+        radio.bandwidth = 0;
+        radio.lossChance = 1;
+        radio.frameSize = 10;
+        UartHostSetRadio(UART_HOST_UART2, &radio);
+        assert(Uart2WriteData("gone", 4));
+        assert(ReadFor(fd, buf, 4, 50) == 0);
+        assert(uartHostStats[UART_HOST_UART2].txLost == 4);
+
+        // Losses in the other direction, and a whole frame at a time.
+        radio.lossChance = 0.5;
+        UartHostSetRadio(UART_HOST_UART2, &radio);
+        srand(1);
+        memset(buf, 'z', 1000);
+        assert(write(fd, buf, 1000) == 1000);
+        ReadFor(fd, buf, 1, 50);
+        const UartHostStats *s = &uartHostStats[UART_HOST_UART2];
+        assert(s->rxBytes + s->rxLost == 1000);
+        assert(s->rxLost % 10 == 0 && s->rxLost > 300 && s->rxLost < 700);
+
+        close(fd);
+        UartHostClose(UART_HOST_UART2);
+        UartHostSetRadio(UART_HOST_UART2, NULL);
+    }
+
+    // A TCP server that clients can take over, and overruns of the receive buffer.
+    {
+        Uart1Init(21);
+        assert(UartHostOpen(UART_HOST_UART1, "tcp:47123"));
+
+        struct addrinfo hints = {0};
+        struct addrinfo *result;
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        assert(getaddrinfo("127.0.0.1", "47123", &hints, &result) == 0);
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        assert(connect(fd, result->ai_addr, result->ai_addrlen) == 0);
+        fcntl(fd, F_SETFL, O_NONBLOCK);
+        UartHostPoll(10);
+
+        assert(Uart1WriteData("tcp", 3));
+        assert(ReadFor(fd, buf, 3, 100) == 3 && !memcmp(buf, "tcp", 3));
+
+        memset(buf, 'o', sizeof(buf));
+        assert(write(fd, buf, UART1_BUFFER_SIZE + 100) == UART1_BUFFER_SIZE + 100);
+        ReadFor(fd, buf, 1, 50);
+        assert(uartHostStats[UART_HOST_UART1].rxBytes == UART1_BUFFER_SIZE);
+        assert(uartHostStats[UART_HOST_UART1].rxOverruns == 100);
+        close(fd);
+
+        // A new client replaces the old one.
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        assert(connect(fd, result->ai_addr, result->ai_addrlen) == 0);
+        fcntl(fd, F_SETFL, O_NONBLOCK);
+        freeaddrinfo(result);
+        UartHostPoll(10);
+        assert(Uart1WriteData("new", 3));
+        assert(ReadFor(fd, buf, 3, 100) == 3 && !memcmp(buf, "new", 3));
+
+        close(fd);
+        UartHostClose(UART_HOST_UART1);
+    }
+
+    printf("All tests passed.\n");
+
+    return 0;
+}
+
+#endif // UNIT_TEST_UART_HOST
@@ -0,0 +1,126 @@
+#ifndef UART_HOST_H
+#define UART_HOST_H
+
+/**
+ * @file
+ * @brief The Uart1 and Uart2 libraries for running on a PC, over ptys or TCP sockets.
+ *
+ * # Dependencies
+ *  * TxQueue and CircularBuffer libraries.
+ *  * POSIX ptys, sockets, and poll().
+ *
+ * # Usage
+ * Build UartHost.c in place of Uart1.c and Uart2.c, like FlashLogHost.c replaces FlashLogPic.c.
+ * It implements the whole API of both, so firmware like MavlinkGlue.c runs unmodified and can be
+ * connected to QGroundControl, MAVProxy, mavlink_router, or a log recorder on the same machine,
+ * for software-in-the-loop testing of the primary node without any hardware.
+ *
+ * Each UART is attached to an endpoint with UartHostOpen(), either before or after its
+ * Uart*Init(). The endpoints are:
+ *  * `pty` A new pseudo-terminal, whose name is printed. It's opened as a serial port on the other
+ *    side, with any baud rate.
+ *  * `pty:/tmp/boat-gs` The same, but also symlinked to the given path so its name is stable.
+ *  * `tcp:5760` Listens on a TCP port, talking to whoever connected last. QGC can connect to this
+ *    with a TCP link.
+ *  * `tcp:127.0.0.1:5760` Connects to a TCP server.
+ * A UART without an endpoint transmits into the void and never receives anything.
+ *
+ * Nothing happens in the background, as the transmit and receive interrupts would on the dsPIC.
+ * Instead the main loop calls UartHostPoll(), which moves queued data onto the links and received
+ * data into the receive buffers, and can also sleep until there's input. Writes also start moving
+ * data straight away. There's no locking, so all calls must come from one thread.
+ *
+ * By default data moves as fast as the PC allows. Optionally, each direction of a link can be
+ * paced at the baud rate from the BRG register (see UART_HOST_FCY) and run through a model of a
+ * radio link with latency, a bandwidth cap, and lost frames (see UartHostRadio). Both queue up in
+ * the transmit buffers like on the real hardware, so the firmware sees the same back-pressure,
+ * dropped writes, and priority lanes. Received bytes that don't fit into the receive buffer are
+ * lost as overruns.
+ *
+ * Unit testing has been completed on x86 by compiling with the UNIT_TEST_UART_HOST macro.
+ * With gcc: `gcc UartHost.c TxQueue.c CircularBuffer.c -DUNIT_TEST_UART_HOST -Wall -g`
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "Uart1.h"
+#include "Uart2.h"
+
+/**
+ * The instruction clock the BRG registers are computed from, for pacing at the baud rate.
+ */
+#ifndef UART_HOST_FCY
+#define UART_HOST_FCY 40000000UL
+#endif
+
+/**
+ * The number of bytes that can be in flight in each direction of a link, which with latency is
+ * about the bandwidth times the latency. At 115200 baud this allows 1.4s.
+ */
+#define UART_HOST_LINE_SIZE 16384
+
+/**
+ * The UARTs, for indexing the functions and statistics below.
+ */
+typedef enum {
+    UART_HOST_UART1 = 0,
+    UART_HOST_UART2,
+    UART_HOST_PORTS
+} UartHostPort;
+
+/**
+ * A model of a radio link, applied separately to each direction. All zero is a perfect link.
+ */
+typedef struct {
+    uint32_t latencyUs; // The time added to every byte's trip across the link.
+    uint32_t bandwidth; // The throughput cap in bytes/s, on top of any baud rate pacing. 0 for none.
+    float lossChance;   // The chance each frame is lost, between 0 and 1.
+    uint16_t frameSize; // The bytes per frame for losses, like a radio's air packets. 0 for 1.
+} UartHostRadio;
+
+/**
+ * Counts of the traffic on each UART since it was opened.
+ */
+typedef struct {
+    uint64_t txBytes;     // Bytes written to the endpoint.
+    uint64_t txLost;      // Bytes lost by the radio model on the way to the endpoint.
+    uint64_t txDiscarded; // Bytes that the endpoint wasn't connected or ready for.
+    uint64_t rxBytes;     // Bytes moved into the receive buffer.
+    uint64_t rxLost;      // Bytes lost by the radio model on the way from the endpoint.
+    uint64_t rxOverruns;  // Bytes that didn't fit into the receive buffer.
+} UartHostStats;
+
+extern UartHostStats uartHostStats[UART_HOST_PORTS];
+
+/**
+ * Attaches a UART to an endpoint, closing any previous one and resetting its statistics.
+ * @param port The UART.
+ * @param endpoint The endpoint, see above.
+ * @return true if it could be opened.
+ */
+bool UartHostOpen(UartHostPort port, const char *endpoint);
+
+/**
+ * Detaches a UART from its endpoint, removing any symlink to its pty.
+ */
+void UartHostClose(UartHostPort port);
+
+/**
+ * Sets whether the UART moves data at its baud rate, off by default.
+ */
+void UartHostSetPacing(UartHostPort port, bool pace);
+
+/**
+ * Sets the radio model for both directions of the UART's link.
+ * @param radio The model, or NULL for a perfect link.
+ */
+void UartHostSetRadio(UartHostPort port, const UartHostRadio *radio);
+
+/**
+ * Moves data between the UARTs and their endpoints. Call this often, like from the main loop.
+ * @param timeoutMs How long to wait for received data if there's none yet, 0 to never wait.
+ */
+void UartHostPoll(int timeoutMs);
+
+#endif // UART_HOST_H
@@ -0,0 +1,377 @@
+// MESSAGE LATENCY_STATS PACKING
+
+#define MAVLINK_MSG_ID_LATENCY_STATS 185
+
+typedef struct __mavlink_latency_stats_t
+{
+ uint32_t time_boot_ms; ///< Timestamp (milliseconds since system boot)
+ uint32_t p50; ///< Median latency (microseconds).
+ uint32_t p90; ///< 90th percentile latency (microseconds).
+ uint32_t p99; ///< 99th percentile latency (microseconds).
+ uint32_t max; ///< Maximum latency over the last 1-2 windows (microseconds).
+ uint32_t samples; ///< Number of samples recorded since boot or the last reset.
+ uint8_t stage; ///< The stage these statistics are for. 0: CAN queue, 1: controller, 2: scheduler, 3: UART, 4: ATTITUDE total, 5: LOCAL_POSITION_NED total.
+ uint8_t count; ///< Total number of stages.
+} mavlink_latency_stats_t;
+
+#define MAVLINK_MSG_ID_LATENCY_STATS_LEN 26
+#define MAVLINK_MSG_ID_185_LEN 26
+
+#define MAVLINK_MSG_ID_LATENCY_STATS_CRC 183
+#define MAVLINK_MSG_ID_185_CRC 183
+
+
+
+#define MAVLINK_MESSAGE_INFO_LATENCY_STATS { \
+	"LATENCY_STATS", \
+	8, \
+	{  { "time_boot_ms", NULL, MAVLINK_TYPE_UINT32_T, 0, 0, offsetof(mavlink_latency_stats_t, time_boot_ms) }, \
+         { "p50", NULL, MAVLINK_TYPE_UINT32_T, 0, 4, offsetof(mavlink_latency_stats_t, p50) }, \
+         { "p90", NULL, MAVLINK_TYPE_UINT32_T, 0, 8, offsetof(mavlink_latency_stats_t, p90) }, \
+         { "p99", NULL, MAVLINK_TYPE_UINT32_T, 0, 12, offsetof(mavlink_latency_stats_t, p99) }, \
+         { "max", NULL, MAVLINK_TYPE_UINT32_T, 0, 16, offsetof(mavlink_latency_stats_t, max) }, \
+         { "samples", NULL, MAVLINK_TYPE_UINT32_T, 0, 20, offsetof(mavlink_latency_stats_t, samples) }, \
+         { "stage", NULL, MAVLINK_TYPE_UINT8_T, 0, 24, offsetof(mavlink_latency_stats_t, stage) }, \
+         { "count", NULL, MAVLINK_TYPE_UINT8_T, 0, 25, offsetof(mavlink_latency_stats_t, count) }, \
+         } \
+}
+
+
+/**
+ * @brief Pack a latency_stats message
+ * @param system_id ID of this system
+ * @param component_id ID of this component (e.g. 200 for IMU)
+ * @param msg The MAVLink message to compress the data into
+ *
+ * @param time_boot_ms Timestamp (milliseconds since system boot)
+ * @param stage The stage these statistics are for. 0: CAN queue, 1: controller, 2: scheduler, 3: UART, 4: ATTITUDE total, 5: LOCAL_POSITION_NED total.
+ * @param count Total number of stages.
+ * @param p50 Median latency (microseconds).
+ * @param p90 90th percentile latency (microseconds).
+ * @param p99 99th percentile latency (microseconds).
+ * @param max Maximum latency over the last 1-2 windows (microseconds).
+ * @param samples Number of samples recorded since boot or the last reset.
+ * @return length of the message in bytes (excluding serial stream start sign)
+ */
+static inline uint16_t mavlink_msg_latency_stats_pack(uint8_t system_id, uint8_t component_id, mavlink_message_t* msg,
+						       uint32_t time_boot_ms, uint8_t stage, uint8_t count, uint32_t p50, uint32_t p90, uint32_t p99, uint32_t max, uint32_t samples)
+{
+#if MAVLINK_NEED_BYTE_SWAP || !MAVLINK_ALIGNED_FIELDS
+	char buf[MAVLINK_MSG_ID_LATENCY_STATS_LEN];
+	_mav_put_uint32_t(buf, 0, time_boot_ms);
+	_mav_put_uint32_t(buf, 4, p50);
+	_mav_put_uint32_t(buf, 8, p90);
+	_mav_put_uint32_t(buf, 12, p99);
+	_mav_put_uint32_t(buf, 16, max);
+	_mav_put_uint32_t(buf, 20, samples);
+	_mav_put_uint8_t(buf, 24, stage);
+	_mav_put_uint8_t(buf, 25, count);
+
+        memcpy(_MAV_PAYLOAD_NON_CONST(msg), buf, MAVLINK_MSG_ID_LATENCY_STATS_LEN);
+#else
+	mavlink_latency_stats_t packet;
+	packet.time_boot_ms = time_boot_ms;
+	packet.p50 = p50;
+	packet.p90 = p90;
+	packet.p99 = p99;
+	packet.max = max;
+	packet.samples = samples;
+	packet.stage = stage;
+	packet.count = count;
+
+        memcpy(_MAV_PAYLOAD_NON_CONST(msg), &packet, MAVLINK_MSG_ID_LATENCY_STATS_LEN);
+#endif
+
+	msg->msgid = MAVLINK_MSG_ID_LATENCY_STATS;
+#if MAVLINK_CRC_EXTRA
+    return mavlink_finalize_message(msg, system_id, component_id, MAVLINK_MSG_ID_LATENCY_STATS_LEN, MAVLINK_MSG_ID_LATENCY_STATS_CRC);
+#else
+    return mavlink_finalize_message(msg, system_id, component_id, MAVLINK_MSG_ID_LATENCY_STATS_LEN);
+#endif
+}
+
+/**
+ * @brief Pack a latency_stats message on a channel
+ * @param system_id ID of this system
+ * @param component_id ID of this component (e.g. 200 for IMU)
+ * @param chan The MAVLink channel this message will be sent over
+ * @param msg The MAVLink message to compress the data into
+ * @param time_boot_ms Timestamp (milliseconds since system boot)
+ * @param stage The stage these statistics are for. 0: CAN queue, 1: controller, 2: scheduler, 3: UART, 4: ATTITUDE total, 5: LOCAL_POSITION_NED total.
+ * @param count Total number of stages.
+ * @param p50 Median latency (microseconds).
+ * @param p90 90th percentile latency (microseconds).
+ * @param p99 99th percentile latency (microseconds).
+ * @param max Maximum latency over the last 1-2 windows (microseconds).
+ * @param samples Number of samples recorded since boot or the last reset.
+ * @return length of the message in bytes (excluding serial stream start sign)
+ */
+static inline uint16_t mavlink_msg_latency_stats_pack_chan(uint8_t system_id, uint8_t component_id, uint8_t chan,
+							   mavlink_message_t* msg,
+						           uint32_t time_boot_ms,uint8_t stage,uint8_t count,uint32_t p50,uint32_t p90,uint32_t p99,uint32_t max,uint32_t samples)
+{
+#if MAVLINK_NEED_BYTE_SWAP || !MAVLINK_ALIGNED_FIELDS
+	char buf[MAVLINK_MSG_ID_LATENCY_STATS_LEN];
+	_mav_put_uint32_t(buf, 0, time_boot_ms);
+	_mav_put_uint32_t(buf, 4, p50);
+	_mav_put_uint32_t(buf, 8, p90);
+	_mav_put_uint32_t(buf, 12, p99);
+	_mav_put_uint32_t(buf, 16, max);
+	_mav_put_uint32_t(buf, 20, samples);
+	_mav_put_uint8_t(buf, 24, stage);
+	_mav_put_uint8_t(buf, 25, count);
+
+        memcpy(_MAV_PAYLOAD_NON_CONST(msg), buf, MAVLINK_MSG_ID_LATENCY_STATS_LEN);
+#else
+	mavlink_latency_stats_t packet;
+	packet.time_boot_ms = time_boot_ms;
+	packet.p50 = p50;
+	packet.p90 = p90;
+	packet.p99 = p99;
+	packet.max = max;
+	packet.samples = samples;
+	packet.stage = stage;
+	packet.count = count;
+
+        memcpy(_MAV_PAYLOAD_NON_CONST(msg), &packet, MAVLINK_MSG_ID_LATENCY_STATS_LEN);
+#endif
+
+	msg->msgid = MAVLINK_MSG_ID_LATENCY_STATS;
+#if MAVLINK_CRC_EXTRA
+    return mavlink_finalize_message_chan(msg, system_id, component_id, chan, MAVLINK_MSG_ID_LATENCY_STATS_LEN, MAVLINK_MSG_ID_LATENCY_STATS_CRC);
+#else
+    return mavlink_finalize_message_chan(msg, system_id, component_id, chan, MAVLINK_MSG_ID_LATENCY_STATS_LEN);
+#endif
+}
+
+/**
+ * @brief Encode a latency_stats struct
+ *
+ * @param system_id ID of this system
+ * @param component_id ID of this component (e.g. 200 for IMU)
+ * @param msg The MAVLink message to compress the data into
+ * @param latency_stats C-struct to read the message contents from
+ */
+static inline uint16_t mavlink_msg_latency_stats_encode(uint8_t system_id, uint8_t component_id, mavlink_message_t* msg, const mavlink_latency_stats_t* latency_stats)
+{
+	return mavlink_msg_latency_stats_pack(system_id, component_id, msg, latency_stats->time_boot_ms, latency_stats->stage, latency_stats->count, latency_stats->p50, latency_stats->p90, latency_stats->p99, latency_stats->max, latency_stats->samples);
+}
+
+/**
+ * @brief Encode a latency_stats struct on a channel
+ *
+ * @param system_id ID of this system
+ * @param component_id ID of this component (e.g. 200 for IMU)
+ * @param chan The MAVLink channel this message will be sent over
+ * @param msg The MAVLink message to compress the data into
+ * @param latency_stats C-struct to read the message contents from
+ */
+static inline uint16_t mavlink_msg_latency_stats_encode_chan(uint8_t system_id, uint8_t component_id, uint8_t chan, mavlink_message_t* msg, const mavlink_latency_stats_t* latency_stats)
+{
+	return mavlink_msg_latency_stats_pack_chan(system_id, component_id, chan, msg, latency_stats->time_boot_ms, latency_stats->stage, latency_stats->count, latency_stats->p50, latency_stats->p90, latency_stats->p99, latency_stats->max, latency_stats->samples);
+}
+
+/**
+ * @brief Send a latency_stats message
+ * @param chan MAVLink channel to send the message
+ *
+ * @param time_boot_ms Timestamp (milliseconds since system boot)
+ * @param stage The stage these statistics are for. 0: CAN queue, 1: controller, 2: scheduler, 3: UART, 4: ATTITUDE total, 5: LOCAL_POSITION_NED total.
+ * @param count Total number of stages.
+ * @param p50 Median latency (microseconds).
+ * @param p90 90th percentile latency (microseconds).
+ * @param p99 99th percentile latency (microseconds).
+ * @param max Maximum latency over the last 1-2 windows (microseconds).
+ * @param samples Number of samples recorded since boot or the last reset.
+ */
+#ifdef MAVLINK_USE_CONVENIENCE_FUNCTIONS
+
+static inline void mavlink_msg_latency_stats_send(mavlink_channel_t chan, uint32_t time_boot_ms, uint8_t stage, uint8_t count, uint32_t p50, uint32_t p90, uint32_t p99, uint32_t max, uint32_t samples)
+{
+#if MAVLINK_NEED_BYTE_SWAP || !MAVLINK_ALIGNED_FIELDS
+	char buf[MAVLINK_MSG_ID_LATENCY_STATS_LEN];
+	_mav_put_uint32_t(buf, 0, time_boot_ms);
+	_mav_put_uint32_t(buf, 4, p50);
+	_mav_put_uint32_t(buf, 8, p90);
+	_mav_put_uint32_t(buf, 12, p99);
+	_mav_put_uint32_t(buf, 16, max);
+	_mav_put_uint32_t(buf, 20, samples);
+	_mav_put_uint8_t(buf, 24, stage);
+	_mav_put_uint8_t(buf, 25, count);
+
+#if MAVLINK_CRC_EXTRA
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_LATENCY_STATS, buf, MAVLINK_MSG_ID_LATENCY_STATS_LEN, MAVLINK_MSG_ID_LATENCY_STATS_CRC);
+#else
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_LATENCY_STATS, buf, MAVLINK_MSG_ID_LATENCY_STATS_LEN);
+#endif
+#else
+	mavlink_latency_stats_t packet;
+	packet.time_boot_ms = time_boot_ms;
+	packet.p50 = p50;
+	packet.p90 = p90;
+	packet.p99 = p99;
+	packet.max = max;
+	packet.samples = samples;
+	packet.stage = stage;
+	packet.count = count;
+
+#if MAVLINK_CRC_EXTRA
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_LATENCY_STATS, (const char *)&packet, MAVLINK_MSG_ID_LATENCY_STATS_LEN, MAVLINK_MSG_ID_LATENCY_STATS_CRC);
+#else
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_LATENCY_STATS, (const char *)&packet, MAVLINK_MSG_ID_LATENCY_STATS_LEN);
+#endif
+#endif
+}
+
+#if MAVLINK_MSG_ID_LATENCY_STATS_LEN <= MAVLINK_MAX_PAYLOAD_LEN
+/*
+  This varient of _send() can be used to save stack space by re-using
+  memory from the receive buffer.  The caller provides a
+  mavlink_message_t which is the size of a full mavlink message. This
+  is usually the receive buffer for the channel, and allows a reply to an
+  incoming message with minimum stack space usage.
+ */
+static inline void mavlink_msg_latency_stats_send_buf(mavlink_message_t *msgbuf, mavlink_channel_t chan,  uint32_t time_boot_ms, uint8_t stage, uint8_t count, uint32_t p50, uint32_t p90, uint32_t p99, uint32_t max, uint32_t samples)
+{
+#if MAVLINK_NEED_BYTE_SWAP || !MAVLINK_ALIGNED_FIELDS
+	char *buf = (char *)msgbuf;
+	_mav_put_uint32_t(buf, 0, time_boot_ms);
+	_mav_put_uint32_t(buf, 4, p50);
+	_mav_put_uint32_t(buf, 8, p90);
+	_mav_put_uint32_t(buf, 12, p99);
+	_mav_put_uint32_t(buf, 16, max);
+	_mav_put_uint32_t(buf, 20, samples);
+	_mav_put_uint8_t(buf, 24, stage);
+	_mav_put_uint8_t(buf, 25, count);
+
+#if MAVLINK_CRC_EXTRA
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_LATENCY_STATS, buf, MAVLINK_MSG_ID_LATENCY_STATS_LEN, MAVLINK_MSG_ID_LATENCY_STATS_CRC);
+#else
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_LATENCY_STATS, buf, MAVLINK_MSG_ID_LATENCY_STATS_LEN);
+#endif
+#else
+	mavlink_latency_stats_t *packet = (mavlink_latency_stats_t *)msgbuf;
+	packet->time_boot_ms = time_boot_ms;
+	packet->p50 = p50;
+	packet->p90 = p90;
+	packet->p99 = p99;
+	packet->max = max;
+	packet->samples = samples;
+	packet->stage = stage;
+	packet->count = count;
+
+#if MAVLINK_CRC_EXTRA
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_LATENCY_STATS, (const char *)packet, MAVLINK_MSG_ID_LATENCY_STATS_LEN, MAVLINK_MSG_ID_LATENCY_STATS_CRC);
+#else
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_LATENCY_STATS, (const char *)packet, MAVLINK_MSG_ID_LATENCY_STATS_LEN);
+#endif
+#endif
+}
+#endif
+
+#endif
+
+// MESSAGE LATENCY_STATS UNPACKING
+
+
+/**
+ * @brief Get field time_boot_ms from latency_stats message
+ *
+ * @return Timestamp (milliseconds since system boot)
+ */
+static inline uint32_t mavlink_msg_latency_stats_get_time_boot_ms(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint32_t(msg,  0);
+}
+
+/**
+ * @brief Get field stage from latency_stats message
+ *
+ * @return The stage these statistics are for. 0: CAN queue, 1: controller, 2: scheduler, 3: UART, 4: ATTITUDE total, 5: LOCAL_POSITION_NED total.
+ */
+static inline uint8_t mavlink_msg_latency_stats_get_stage(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint8_t(msg,  24);
+}
+
+/**
+ * @brief Get field count from latency_stats message
+ *
+ * @return Total number of stages.
+ */
+static inline uint8_t mavlink_msg_latency_stats_get_count(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint8_t(msg,  25);
+}
+
+/**
+ * @brief Get field p50 from latency_stats message
+ *
+ * @return Median latency (microseconds).
+ */
+static inline uint32_t mavlink_msg_latency_stats_get_p50(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint32_t(msg,  4);
+}
+
+/**
+ * @brief Get field p90 from latency_stats message
+ *
+ * @return 90th percentile latency (microseconds).
+ */
+static inline uint32_t mavlink_msg_latency_stats_get_p90(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint32_t(msg,  8);
+}
+
+/**
+ * @brief Get field p99 from latency_stats message
+ *
+ * @return 99th percentile latency (microseconds).
+ */
+static inline uint32_t mavlink_msg_latency_stats_get_p99(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint32_t(msg,  12);
+}
+
+/**
+ * @brief Get field max from latency_stats message
+ *
+ * @return Maximum latency over the last 1-2 windows (microseconds).
+ */
+static inline uint32_t mavlink_msg_latency_stats_get_max(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint32_t(msg,  16);
+}
+
+/**
+ * @brief Get field samples from latency_stats message
+ *
+ * @return Number of samples recorded since boot or the last reset.
+ */
+static inline uint32_t mavlink_msg_latency_stats_get_samples(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint32_t(msg,  20);
+}
+
+/**
+ * @brief Decode a latency_stats message into a struct
+ *
+ * @param msg The message to decode
+ * @param latency_stats C-struct to decode the message contents into
+ */
+static inline void mavlink_msg_latency_stats_decode(const mavlink_message_t* msg, mavlink_latency_stats_t* latency_stats)
+{
+#if MAVLINK_NEED_BYTE_SWAP
+	latency_stats->time_boot_ms = mavlink_msg_latency_stats_get_time_boot_ms(msg);
+	latency_stats->p50 = mavlink_msg_latency_stats_get_p50(msg);
+	latency_stats->p90 = mavlink_msg_latency_stats_get_p90(msg);
+	latency_stats->p99 = mavlink_msg_latency_stats_get_p99(msg);
+	latency_stats->max = mavlink_msg_latency_stats_get_max(msg);
+	latency_stats->samples = mavlink_msg_latency_stats_get_samples(msg);
+	latency_stats->stage = mavlink_msg_latency_stats_get_stage(msg);
+	latency_stats->count = mavlink_msg_latency_stats_get_count(msg);
+#else
+	memcpy(latency_stats, _MAV_PAYLOAD(msg), MAVLINK_MSG_ID_LATENCY_STATS_LEN);
+#endif
+}
@@ -0,0 +1,401 @@
+// MESSAGE LINK_STATS PACKING
+
+#define MAVLINK_MSG_ID_LINK_STATS 184
+
+typedef struct __mavlink_link_stats_t
+{
+ uint32_t time_boot_ms; ///< Timestamp (milliseconds since system boot)
+ uint32_t received; ///< Number of messages received from this system.
+ uint32_t lost; ///< Number of messages from this system estimated to be lost from gaps in their sequence numbers.
+ uint32_t parse_errors; ///< Total number of messages that failed to parse on this link, from all systems.
+ uint32_t untracked; ///< Total number of messages not counted in MESSAGE_STATS because the statistics table was full.
+ uint8_t channel; ///< The link these statistics are for. 0: groundstation, 1: datalogger.
+ uint8_t sysid; ///< The remote system ID these statistics are for.
+ uint8_t index; ///< Index of this entry in the statistics table.
+ uint8_t count; ///< Total number of entries in the statistics table.
+} mavlink_link_stats_t;
+
+#define MAVLINK_MSG_ID_LINK_STATS_LEN 24
+#define MAVLINK_MSG_ID_184_LEN 24
+
+#define MAVLINK_MSG_ID_LINK_STATS_CRC 195
+#define MAVLINK_MSG_ID_184_CRC 195
+
+
+
+#define MAVLINK_MESSAGE_INFO_LINK_STATS { \
+	"LINK_STATS", \
+	9, \
+	{  { "time_boot_ms", NULL, MAVLINK_TYPE_UINT32_T, 0, 0, offsetof(mavlink_link_stats_t, time_boot_ms) }, \
+         { "received", NULL, MAVLINK_TYPE_UINT32_T, 0, 4, offsetof(mavlink_link_stats_t, received) }, \
+         { "lost", NULL, MAVLINK_TYPE_UINT32_T, 0, 8, offsetof(mavlink_link_stats_t, lost) }, \
+         { "parse_errors", NULL, MAVLINK_TYPE_UINT32_T, 0, 12, offsetof(mavlink_link_stats_t, parse_errors) }, \
+         { "untracked", NULL, MAVLINK_TYPE_UINT32_T, 0, 16, offsetof(mavlink_link_stats_t, untracked) }, \
+         { "channel", NULL, MAVLINK_TYPE_UINT8_T, 0, 20, offsetof(mavlink_link_stats_t, channel) }, \
+         { "sysid", NULL, MAVLINK_TYPE_UINT8_T, 0, 21, offsetof(mavlink_link_stats_t, sysid) }, \
+         { "index", NULL, MAVLINK_TYPE_UINT8_T, 0, 22, offsetof(mavlink_link_stats_t, index) }, \
+         { "count", NULL, MAVLINK_TYPE_UINT8_T, 0, 23, offsetof(mavlink_link_stats_t, count) }, \
+         } \
+}
+
+
+/**
+ * @brief Pack a link_stats message
+ * @param system_id ID of this system
+ * @param component_id ID of this component (e.g. 200 for IMU)
+ * @param msg The MAVLink message to compress the data into
+ *
+ * @param time_boot_ms Timestamp (milliseconds since system boot)
+ * @param channel The link these statistics are for. 0: groundstation, 1: datalogger.
+ * @param sysid The remote system ID these statistics are for.
+ * @param index Index of this entry in the statistics table.
+ * @param count Total number of entries in the statistics table.
+ * @param received Number of messages received from this system.
+ * @param lost Number of messages from this system estimated to be lost from gaps in their sequence numbers.
+ * @param parse_errors Total number of messages that failed to parse on this link, from all systems.
+ * @param untracked Total number of messages not counted in MESSAGE_STATS because the statistics table was full.
+ * @return length of the message in bytes (excluding serial stream start sign)
+ */
+static inline uint16_t mavlink_msg_link_stats_pack(uint8_t system_id, uint8_t component_id, mavlink_message_t* msg,
+						       uint32_t time_boot_ms, uint8_t channel, uint8_t sysid, uint8_t index, uint8_t count, uint32_t received, uint32_t lost, uint32_t parse_errors, uint32_t untracked)
+{
+#if MAVLINK_NEED_BYTE_SWAP || !MAVLINK_ALIGNED_FIELDS
+	char buf[MAVLINK_MSG_ID_LINK_STATS_LEN];
+	_mav_put_uint32_t(buf, 0, time_boot_ms);
+	_mav_put_uint32_t(buf, 4, received);
+	_mav_put_uint32_t(buf, 8, lost);
+	_mav_put_uint32_t(buf, 12, parse_errors);
+	_mav_put_uint32_t(buf, 16, untracked);
+	_mav_put_uint8_t(buf, 20, channel);
+	_mav_put_uint8_t(buf, 21, sysid);
+	_mav_put_uint8_t(buf, 22, index);
+	_mav_put_uint8_t(buf, 23, count);
+
+        memcpy(_MAV_PAYLOAD_NON_CONST(msg), buf, MAVLINK_MSG_ID_LINK_STATS_LEN);
+#else
+	mavlink_link_stats_t packet;
+	packet.time_boot_ms = time_boot_ms;
+	packet.received = received;
+	packet.lost = lost;
+	packet.parse_errors = parse_errors;
+	packet.untracked = untracked;
+	packet.channel = channel;
+	packet.sysid = sysid;
+	packet.index = index;
+	packet.count = count;
+
+        memcpy(_MAV_PAYLOAD_NON_CONST(msg), &packet, MAVLINK_MSG_ID_LINK_STATS_LEN);
+#endif
+
+	msg->msgid = MAVLINK_MSG_ID_LINK_STATS;
+#if MAVLINK_CRC_EXTRA
+    return mavlink_finalize_message(msg, system_id, component_id, MAVLINK_MSG_ID_LINK_STATS_LEN, MAVLINK_MSG_ID_LINK_STATS_CRC);
+#else
+    return mavlink_finalize_message(msg, system_id, component_id, MAVLINK_MSG_ID_LINK_STATS_LEN);
+#endif
+}
+
+/**
+ * @brief Pack a link_stats message on a channel
+ * @param system_id ID of this system
+ * @param component_id ID of this component (e.g. 200 for IMU)
+ * @param chan The MAVLink channel this message will be sent over
+ * @param msg The MAVLink message to compress the data into
+ * @param time_boot_ms Timestamp (milliseconds since system boot)
+ * @param channel The link these statistics are for. 0: groundstation, 1: datalogger.
+ * @param sysid The remote system ID these statistics are for.
+ * @param index Index of this entry in the statistics table.
+ * @param count Total number of entries in the statistics table.
+ * @param received Number of messages received from this system.
+ * @param lost Number of messages from this system estimated to be lost from gaps in their sequence numbers.
+ * @param parse_errors Total number of messages that failed to parse on this link, from all systems.
+ * @param untracked Total number of messages not counted in MESSAGE_STATS because the statistics table was full.
+ * @return length of the message in bytes (excluding serial stream start sign)
+ */
+static inline uint16_t mavlink_msg_link_stats_pack_chan(uint8_t system_id, uint8_t component_id, uint8_t chan,
+							   mavlink_message_t* msg,
+						           uint32_t time_boot_ms,uint8_t channel,uint8_t sysid,uint8_t index,uint8_t count,uint32_t received,uint32_t lost,uint32_t parse_errors,uint32_t untracked)
+{
+#if MAVLINK_NEED_BYTE_SWAP || !MAVLINK_ALIGNED_FIELDS
+	char buf[MAVLINK_MSG_ID_LINK_STATS_LEN];
+	_mav_put_uint32_t(buf, 0, time_boot_ms);
+	_mav_put_uint32_t(buf, 4, received);
+	_mav_put_uint32_t(buf, 8, lost);
+	_mav_put_uint32_t(buf, 12, parse_errors);
+	_mav_put_uint32_t(buf, 16, untracked);
+	_mav_put_uint8_t(buf, 20, channel);
+	_mav_put_uint8_t(buf, 21, sysid);
+	_mav_put_uint8_t(buf, 22, index);
+	_mav_put_uint8_t(buf, 23, count);
+
+        memcpy(_MAV_PAYLOAD_NON_CONST(msg), buf, MAVLINK_MSG_ID_LINK_STATS_LEN);
+#else
+	mavlink_link_stats_t packet;
+	packet.time_boot_ms = time_boot_ms;
+	packet.received = received;
+	packet.lost = lost;
+	packet.parse_errors = parse_errors;
+	packet.untracked = untracked;
+	packet.channel = channel;
+	packet.sysid = sysid;
+	packet.index = index;
+	packet.count = count;
+
+        memcpy(_MAV_PAYLOAD_NON_CONST(msg), &packet, MAVLINK_MSG_ID_LINK_STATS_LEN);
+#endif
+
+	msg->msgid = MAVLINK_MSG_ID_LINK_STATS;
+#if MAVLINK_CRC_EXTRA
+    return mavlink_finalize_message_chan(msg, system_id, component_id, chan, MAVLINK_MSG_ID_LINK_STATS_LEN, MAVLINK_MSG_ID_LINK_STATS_CRC);
+#else
+    return mavlink_finalize_message_chan(msg, system_id, component_id, chan, MAVLINK_MSG_ID_LINK_STATS_LEN);
+#endif
+}
+
+/**
+ * @brief Encode a link_stats struct
+ *
+ * @param system_id ID of this system
+ * @param component_id ID of this component (e.g. 200 for IMU)
+ * @param msg The MAVLink message to compress the data into
+ * @param link_stats C-struct to read the message contents from
+ */
+static inline uint16_t mavlink_msg_link_stats_encode(uint8_t system_id, uint8_t component_id, mavlink_message_t* msg, const mavlink_link_stats_t* link_stats)
+{
+	return mavlink_msg_link_stats_pack(system_id, component_id, msg, link_stats->time_boot_ms, link_stats->channel, link_stats->sysid, link_stats->index, link_stats->count, link_stats->received, link_stats->lost, link_stats->parse_errors, link_stats->untracked);
+}
+
+/**
+ * @brief Encode a link_stats struct on a channel
+ *
+ * @param system_id ID of this system
+ * @param component_id ID of this component (e.g. 200 for IMU)
+ * @param chan The MAVLink channel this message will be sent over
+ * @param msg The MAVLink message to compress the data into
+ * @param link_stats C-struct to read the message contents from
+ */
+static inline uint16_t mavlink_msg_link_stats_encode_chan(uint8_t system_id, uint8_t component_id, uint8_t chan, mavlink_message_t* msg, const mavlink_link_stats_t* link_stats)
+{
+	return mavlink_msg_link_stats_pack_chan(system_id, component_id, chan, msg, link_stats->time_boot_ms, link_stats->channel, link_stats->sysid, link_stats->index, link_stats->count, link_stats->received, link_stats->lost, link_stats->parse_errors, link_stats->untracked);
+}
+
+/**
+ * @brief Send a link_stats message
+ * @param chan MAVLink channel to send the message
+ *
+ * @param time_boot_ms Timestamp (milliseconds since system boot)
+ * @param channel The link these statistics are for. 0: groundstation, 1: datalogger.
+ * @param sysid The remote system ID these statistics are for.
+ * @param index Index of this entry in the statistics table.
+ * @param count Total number of entries in the statistics table.
+ * @param received Number of messages received from this system.
+ * @param lost Number of messages from this system estimated to be lost from gaps in their sequence numbers.
+ * @param parse_errors Total number of messages that failed to parse on this link, from all systems.
+ * @param untracked Total number of messages not counted in MESSAGE_STATS because the statistics table was full.
+ */
+#ifdef MAVLINK_USE_CONVENIENCE_FUNCTIONS
+
+static inline void mavlink_msg_link_stats_send(mavlink_channel_t chan, uint32_t time_boot_ms, uint8_t channel, uint8_t sysid, uint8_t index, uint8_t count, uint32_t received, uint32_t lost, uint32_t parse_errors, uint32_t untracked)
+{
+#if MAVLINK_NEED_BYTE_SWAP || !MAVLINK_ALIGNED_FIELDS
+	char buf[MAVLINK_MSG_ID_LINK_STATS_LEN];
+	_mav_put_uint32_t(buf, 0, time_boot_ms);
+	_mav_put_uint32_t(buf, 4, received);
+	_mav_put_uint32_t(buf, 8, lost);
+	_mav_put_uint32_t(buf, 12, parse_errors);
+	_mav_put_uint32_t(buf, 16, untracked);
+	_mav_put_uint8_t(buf, 20, channel);
+	_mav_put_uint8_t(buf, 21, sysid);
+	_mav_put_uint8_t(buf, 22, index);
+	_mav_put_uint8_t(buf, 23, count);
+
+#if MAVLINK_CRC_EXTRA
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_LINK_STATS, buf, MAVLINK_MSG_ID_LINK_STATS_LEN, MAVLINK_MSG_ID_LINK_STATS_CRC);
+#else
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_LINK_STATS, buf, MAVLINK_MSG_ID_LINK_STATS_LEN);
+#endif
+#else
+	mavlink_link_stats_t packet;
+	packet.time_boot_ms = time_boot_ms;
+	packet.received = received;
+	packet.lost = lost;
+	packet.parse_errors = parse_errors;
+	packet.untracked = untracked;
+	packet.channel = channel;
+	packet.sysid = sysid;
+	packet.index = index;
+	packet.count = count;
+
+#if MAVLINK_CRC_EXTRA
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_LINK_STATS, (const char *)&packet, MAVLINK_MSG_ID_LINK_STATS_LEN, MAVLINK_MSG_ID_LINK_STATS_CRC);
+#else
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_LINK_STATS, (const char *)&packet, MAVLINK_MSG_ID_LINK_STATS_LEN);
+#endif
+#endif
+}
+
+#if MAVLINK_MSG_ID_LINK_STATS_LEN <= MAVLINK_MAX_PAYLOAD_LEN
+/*
+  This varient of _send() can be used to save stack space by re-using
+  memory from the receive buffer.  The caller provides a
+  mavlink_message_t which is the size of a full mavlink message. This
+  is usually the receive buffer for the channel, and allows a reply to an
+  incoming message with minimum stack space usage.
+ */
+static inline void mavlink_msg_link_stats_send_buf(mavlink_message_t *msgbuf, mavlink_channel_t chan,  uint32_t time_boot_ms, uint8_t channel, uint8_t sysid, uint8_t index, uint8_t count, uint32_t received, uint32_t lost, uint32_t parse_errors, uint32_t untracked)
+{
+#if MAVLINK_NEED_BYTE_SWAP || !MAVLINK_ALIGNED_FIELDS
+	char *buf = (char *)msgbuf;
+	_mav_put_uint32_t(buf, 0, time_boot_ms);
+	_mav_put_uint32_t(buf, 4, received);
+	_mav_put_uint32_t(buf, 8, lost);
+	_mav_put_uint32_t(buf, 12, parse_errors);
+	_mav_put_uint32_t(buf, 16, untracked);
+	_mav_put_uint8_t(buf, 20, channel);
+	_mav_put_uint8_t(buf, 21, sysid);
+	_mav_put_uint8_t(buf, 22, index);
+	_mav_put_uint8_t(buf, 23, count);
+
+#if MAVLINK_CRC_EXTRA
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_LINK_STATS, buf, MAVLINK_MSG_ID_LINK_STATS_LEN, MAVLINK_MSG_ID_LINK_STATS_CRC);
+#else
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_LINK_STATS, buf, MAVLINK_MSG_ID_LINK_STATS_LEN);
+#endif
+#else
+	mavlink_link_stats_t *packet = (mavlink_link_stats_t *)msgbuf;
+	packet->time_boot_ms = time_boot_ms;
+	packet->received = received;
+	packet->lost = lost;
+	packet->parse_errors = parse_errors;
+	packet->untracked = untracked;
+	packet->channel = channel;
+	packet->sysid = sysid;
+	packet->index = index;
+	packet->count = count;
+
+#if MAVLINK_CRC_EXTRA
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_LINK_STATS, (const char *)packet, MAVLINK_MSG_ID_LINK_STATS_LEN, MAVLINK_MSG_ID_LINK_STATS_CRC);
+#else
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_LINK_STATS, (const char *)packet, MAVLINK_MSG_ID_LINK_STATS_LEN);
+#endif
+#endif
+}
+#endif
+
+#endif
+
+// MESSAGE LINK_STATS UNPACKING
+
+
+/**
+ * @brief Get field time_boot_ms from link_stats message
+ *
+ * @return Timestamp (milliseconds since system boot)
+ */
+static inline uint32_t mavlink_msg_link_stats_get_time_boot_ms(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint32_t(msg,  0);
+}
+
+/**
+ * @brief Get field channel from link_stats message
+ *
+ * @return The link these statistics are for. 0: groundstation, 1: datalogger.
+ */
+static inline uint8_t mavlink_msg_link_stats_get_channel(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint8_t(msg,  20);
+}
+
+/**
+ * @brief Get field sysid from link_stats message
+ *
+ * @return The remote system ID these statistics are for.
+ */
+static inline uint8_t mavlink_msg_link_stats_get_sysid(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint8_t(msg,  21);
+}
+
+/**
+ * @brief Get field index from link_stats message
+ *
+ * @return Index of this entry in the statistics table.
+ */
+static inline uint8_t mavlink_msg_link_stats_get_index(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint8_t(msg,  22);
+}
+
+/**
+ * @brief Get field count from link_stats message
+ *
+ * @return Total number of entries in the statistics table.
+ */
+static inline uint8_t mavlink_msg_link_stats_get_count(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint8_t(msg,  23);
+}
+
+/**
+ * @brief Get field received from link_stats message
+ *
+ * @return Number of messages received from this system.
+ */
+static inline uint32_t mavlink_msg_link_stats_get_received(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint32_t(msg,  4);
+}
+
+/**
+ * @brief Get field lost from link_stats message
+ *
+ * @return Number of messages from this system estimated to be lost from gaps in their sequence numbers.
+ */
+static inline uint32_t mavlink_msg_link_stats_get_lost(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint32_t(msg,  8);
+}
+
+/**
+ * @brief Get field parse_errors from link_stats message
+ *
+ * @return Total number of messages that failed to parse on this link, from all systems.
+ */
+static inline uint32_t mavlink_msg_link_stats_get_parse_errors(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint32_t(msg,  12);
+}
+
+/**
+ * @brief Get field untracked from link_stats message
+ *
+ * @return Total number of messages not counted in MESSAGE_STATS because the statistics table was full.
+ */
+static inline uint32_t mavlink_msg_link_stats_get_untracked(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint32_t(msg,  16);
+}
+
+/**
+ * @brief Decode a link_stats message into a struct
+ *
+ * @param msg The message to decode
+ * @param link_stats C-struct to decode the message contents into
+ */
+static inline void mavlink_msg_link_stats_decode(const mavlink_message_t* msg, mavlink_link_stats_t* link_stats)
+{
+#if MAVLINK_NEED_BYTE_SWAP
+	link_stats->time_boot_ms = mavlink_msg_link_stats_get_time_boot_ms(msg);
+	link_stats->received = mavlink_msg_link_stats_get_received(msg);
+	link_stats->lost = mavlink_msg_link_stats_get_lost(msg);
+	link_stats->parse_errors = mavlink_msg_link_stats_get_parse_errors(msg);
+	link_stats->untracked = mavlink_msg_link_stats_get_untracked(msg);
+	link_stats->channel = mavlink_msg_link_stats_get_channel(msg);
+	link_stats->sysid = mavlink_msg_link_stats_get_sysid(msg);
+	link_stats->index = mavlink_msg_link_stats_get_index(msg);
+	link_stats->count = mavlink_msg_link_stats_get_count(msg);
+#else
+	memcpy(link_stats, _MAV_PAYLOAD(msg), MAVLINK_MSG_ID_LINK_STATS_LEN);
+#endif
+}
@@ -0,0 +1,473 @@
+// MESSAGE MESSAGE_STATS PACKING
+
+#define MAVLINK_MSG_ID_MESSAGE_STATS 183
+
+typedef struct __mavlink_message_stats_t
+{
+ uint32_t time_boot_ms; ///< Timestamp (milliseconds since system boot)
+ uint32_t rx_count; ///< Number of these messages received.
+ uint32_t rx_bytes; ///< Number of bytes received in these messages, including the header and checksum.
+ uint32_t gs_tx_count; ///< Number of these messages transmitted to the groundstation.
+ uint32_t gs_tx_bytes; ///< Number of bytes transmitted to the groundstation in these messages, including the header and checksum.
+ uint32_t dl_tx_count; ///< Number of these messages transmitted to the datalogger.
+ uint32_t dl_tx_bytes; ///< Number of bytes transmitted to the datalogger in these messages, including the header and checksum.
+ uint32_t gs_tx_dropped; ///< Number of these messages dropped instead of transmitted to the groundstation because its queue was full.
+ uint32_t dl_tx_dropped; ///< Number of these messages dropped instead of transmitted to the datalogger because its queue was full.
+ uint8_t msgid; ///< The message ID these statistics are for.
+ uint8_t index; ///< Index of this entry in the statistics table.
+ uint8_t count; ///< Total number of entries in the statistics table.
+} mavlink_message_stats_t;
+
+#define MAVLINK_MSG_ID_MESSAGE_STATS_LEN 39
+#define MAVLINK_MSG_ID_183_LEN 39
+
+#define MAVLINK_MSG_ID_MESSAGE_STATS_CRC 26
+#define MAVLINK_MSG_ID_183_CRC 26
+
+
+
+#define MAVLINK_MESSAGE_INFO_MESSAGE_STATS { \
+	"MESSAGE_STATS", \
+	12, \
+	{  { "time_boot_ms", NULL, MAVLINK_TYPE_UINT32_T, 0, 0, offsetof(mavlink_message_stats_t, time_boot_ms) }, \
+         { "rx_count", NULL, MAVLINK_TYPE_UINT32_T, 0, 4, offsetof(mavlink_message_stats_t, rx_count) }, \
+         { "rx_bytes", NULL, MAVLINK_TYPE_UINT32_T, 0, 8, offsetof(mavlink_message_stats_t, rx_bytes) }, \
+         { "gs_tx_count", NULL, MAVLINK_TYPE_UINT32_T, 0, 12, offsetof(mavlink_message_stats_t, gs_tx_count) }, \
+         { "gs_tx_bytes", NULL, MAVLINK_TYPE_UINT32_T, 0, 16, offsetof(mavlink_message_stats_t, gs_tx_bytes) }, \
+         { "dl_tx_count", NULL, MAVLINK_TYPE_UINT32_T, 0, 20, offsetof(mavlink_message_stats_t, dl_tx_count) }, \
+         { "dl_tx_bytes", NULL, MAVLINK_TYPE_UINT32_T, 0, 24, offsetof(mavlink_message_stats_t, dl_tx_bytes) }, \
+         { "gs_tx_dropped", NULL, MAVLINK_TYPE_UINT32_T, 0, 28, offsetof(mavlink_message_stats_t, gs_tx_dropped) }, \
+         { "dl_tx_dropped", NULL, MAVLINK_TYPE_UINT32_T, 0, 32, offsetof(mavlink_message_stats_t, dl_tx_dropped) }, \
+         { "msgid", NULL, MAVLINK_TYPE_UINT8_T, 0, 36, offsetof(mavlink_message_stats_t, msgid) }, \
+         { "index", NULL, MAVLINK_TYPE_UINT8_T, 0, 37, offsetof(mavlink_message_stats_t, index) }, \
+         { "count", NULL, MAVLINK_TYPE_UINT8_T, 0, 38, offsetof(mavlink_message_stats_t, count) }, \
+         } \
+}
+
+
+/**
+ * @brief Pack a message_stats message
+ * @param system_id ID of this system
+ * @param component_id ID of this component (e.g. 200 for IMU)
+ * @param msg The MAVLink message to compress the data into
+ *
+ * @param time_boot_ms Timestamp (milliseconds since system boot)
+ * @param msgid The message ID these statistics are for.
+ * @param index Index of this entry in the statistics table.
+ * @param count Total number of entries in the statistics table.
+ * @param rx_count Number of these messages received.
+ * @param rx_bytes Number of bytes received in these messages, including the header and checksum.
+ * @param gs_tx_count Number of these messages transmitted to the groundstation.
+ * @param gs_tx_bytes Number of bytes transmitted to the groundstation in these messages, including the header and checksum.
+ * @param dl_tx_count Number of these messages transmitted to the datalogger.
+ * @param dl_tx_bytes Number of bytes transmitted to the datalogger in these messages, including the header and checksum.
+ * @param gs_tx_dropped Number of these messages dropped instead of transmitted to the groundstation because its queue was full.
+ * @param dl_tx_dropped Number of these messages dropped instead of transmitted to the datalogger because its queue was full.
+ * @return length of the message in bytes (excluding serial stream start sign)
+ */
+static inline uint16_t mavlink_msg_message_stats_pack(uint8_t system_id, uint8_t component_id, mavlink_message_t* msg,
+						       uint32_t time_boot_ms, uint8_t msgid, uint8_t index, uint8_t count, uint32_t rx_count, uint32_t rx_bytes, uint32_t gs_tx_count, uint32_t gs_tx_bytes, uint32_t dl_tx_count, uint32_t dl_tx_bytes, uint32_t gs_tx_dropped, uint32_t dl_tx_dropped)
+{
+#if MAVLINK_NEED_BYTE_SWAP || !MAVLINK_ALIGNED_FIELDS
+	char buf[MAVLINK_MSG_ID_MESSAGE_STATS_LEN];
+	_mav_put_uint32_t(buf, 0, time_boot_ms);
+	_mav_put_uint32_t(buf, 4, rx_count);
+	_mav_put_uint32_t(buf, 8, rx_bytes);
+	_mav_put_uint32_t(buf, 12, gs_tx_count);
+	_mav_put_uint32_t(buf, 16, gs_tx_bytes);
+	_mav_put_uint32_t(buf, 20, dl_tx_count);
+	_mav_put_uint32_t(buf, 24, dl_tx_bytes);
+	_mav_put_uint32_t(buf, 28, gs_tx_dropped);
+	_mav_put_uint32_t(buf, 32, dl_tx_dropped);
+	_mav_put_uint8_t(buf, 36, msgid);
+	_mav_put_uint8_t(buf, 37, index);
+	_mav_put_uint8_t(buf, 38, count);
+
+        memcpy(_MAV_PAYLOAD_NON_CONST(msg), buf, MAVLINK_MSG_ID_MESSAGE_STATS_LEN);
+#else
+	mavlink_message_stats_t packet;
+	packet.time_boot_ms = time_boot_ms;
+	packet.rx_count = rx_count;
+	packet.rx_bytes = rx_bytes;
+	packet.gs_tx_count = gs_tx_count;
+	packet.gs_tx_bytes = gs_tx_bytes;
+	packet.dl_tx_count = dl_tx_count;
+	packet.dl_tx_bytes = dl_tx_bytes;
+	packet.gs_tx_dropped = gs_tx_dropped;
+	packet.dl_tx_dropped = dl_tx_dropped;
+	packet.msgid = msgid;
+	packet.index = index;
+	packet.count = count;
+
+        memcpy(_MAV_PAYLOAD_NON_CONST(msg), &packet, MAVLINK_MSG_ID_MESSAGE_STATS_LEN);
+#endif
+
+	msg->msgid = MAVLINK_MSG_ID_MESSAGE_STATS;
+#if MAVLINK_CRC_EXTRA
+    return mavlink_finalize_message(msg, system_id, component_id, MAVLINK_MSG_ID_MESSAGE_STATS_LEN, MAVLINK_MSG_ID_MESSAGE_STATS_CRC);
+#else
+    return mavlink_finalize_message(msg, system_id, component_id, MAVLINK_MSG_ID_MESSAGE_STATS_LEN);
+#endif
+}
+
+/**
+ * @brief Pack a message_stats message on a channel
+ * @param system_id ID of this system
+ * @param component_id ID of this component (e.g. 200 for IMU)
+ * @param chan The MAVLink channel this message will be sent over
+ * @param msg The MAVLink message to compress the data into
+ * @param time_boot_ms Timestamp (milliseconds since system boot)
+ * @param msgid The message ID these statistics are for.
+ * @param index Index of this entry in the statistics table.
+ * @param count Total number of entries in the statistics table.
+ * @param rx_count Number of these messages received.
+ * @param rx_bytes Number of bytes received in these messages, including the header and checksum.
+ * @param gs_tx_count Number of these messages transmitted to the groundstation.
+ * @param gs_tx_bytes Number of bytes transmitted to the groundstation in these messages, including the header and checksum.
+ * @param dl_tx_count Number of these messages transmitted to the datalogger.
+ * @param dl_tx_bytes Number of bytes transmitted to the datalogger in these messages, including the header and checksum.
+ * @param gs_tx_dropped Number of these messages dropped instead of transmitted to the groundstation because its queue was full.
+ * @param dl_tx_dropped Number of these messages dropped instead of transmitted to the datalogger because its queue was full.
+ * @return length of the message in bytes (excluding serial stream start sign)
+ */
+static inline uint16_t mavlink_msg_message_stats_pack_chan(uint8_t system_id, uint8_t component_id, uint8_t chan,
+							   mavlink_message_t* msg,
+						           uint32_t time_boot_ms,uint8_t msgid,uint8_t index,uint8_t count,uint32_t rx_count,uint32_t rx_bytes,uint32_t gs_tx_count,uint32_t gs_tx_bytes,uint32_t dl_tx_count,uint32_t dl_tx_bytes,uint32_t gs_tx_dropped,uint32_t dl_tx_dropped)
+{
+#if MAVLINK_NEED_BYTE_SWAP || !MAVLINK_ALIGNED_FIELDS
+	char buf[MAVLINK_MSG_ID_MESSAGE_STATS_LEN];
+	_mav_put_uint32_t(buf, 0, time_boot_ms);
+	_mav_put_uint32_t(buf, 4, rx_count);
+	_mav_put_uint32_t(buf, 8, rx_bytes);
+	_mav_put_uint32_t(buf, 12, gs_tx_count);
+	_mav_put_uint32_t(buf, 16, gs_tx_bytes);
+	_mav_put_uint32_t(buf, 20, dl_tx_count);
+	_mav_put_uint32_t(buf, 24, dl_tx_bytes);
+	_mav_put_uint32_t(buf, 28, gs_tx_dropped);
+	_mav_put_uint32_t(buf, 32, dl_tx_dropped);
+	_mav_put_uint8_t(buf, 36, msgid);
+	_mav_put_uint8_t(buf, 37, index);
+	_mav_put_uint8_t(buf, 38, count);
+
+        memcpy(_MAV_PAYLOAD_NON_CONST(msg), buf, MAVLINK_MSG_ID_MESSAGE_STATS_LEN);
+#else
+	mavlink_message_stats_t packet;
+	packet.time_boot_ms = time_boot_ms;
+	packet.rx_count = rx_count;
+	packet.rx_bytes = rx_bytes;
+	packet.gs_tx_count = gs_tx_count;
+	packet.gs_tx_bytes = gs_tx_bytes;
+	packet.dl_tx_count = dl_tx_count;
+	packet.dl_tx_bytes = dl_tx_bytes;
+	packet.gs_tx_dropped = gs_tx_dropped;
+	packet.dl_tx_dropped = dl_tx_dropped;
+	packet.msgid = msgid;
+	packet.index = index;
+	packet.count = count;
+
+        memcpy(_MAV_PAYLOAD_NON_CONST(msg), &packet, MAVLINK_MSG_ID_MESSAGE_STATS_LEN);
+#endif
+
+	msg->msgid = MAVLINK_MSG_ID_MESSAGE_STATS;
+#if MAVLINK_CRC_EXTRA
+    return mavlink_finalize_message_chan(msg, system_id, component_id, chan, MAVLINK_MSG_ID_MESSAGE_STATS_LEN, MAVLINK_MSG_ID_MESSAGE_STATS_CRC);
+#else
+    return mavlink_finalize_message_chan(msg, system_id, component_id, chan, MAVLINK_MSG_ID_MESSAGE_STATS_LEN);
+#endif
+}
+
+/**
+ * @brief Encode a message_stats struct
+ *
+ * @param system_id ID of this system
+ * @param component_id ID of this component (e.g. 200 for IMU)
+ * @param msg The MAVLink message to compress the data into
+ * @param message_stats C-struct to read the message contents from
+ */
+static inline uint16_t mavlink_msg_message_stats_encode(uint8_t system_id, uint8_t component_id, mavlink_message_t* msg, const mavlink_message_stats_t* message_stats)
+{
+	return mavlink_msg_message_stats_pack(system_id, component_id, msg, message_stats->time_boot_ms, message_stats->msgid, message_stats->index, message_stats->count, message_stats->rx_count, message_stats->rx_bytes, message_stats->gs_tx_count, message_stats->gs_tx_bytes, message_stats->dl_tx_count, message_stats->dl_tx_bytes, message_stats->gs_tx_dropped, message_stats->dl_tx_dropped);
+}
+
+/**
+ * @brief Encode a message_stats struct on a channel
+ *
+ * @param system_id ID of this system
+ * @param component_id ID of this component (e.g. 200 for IMU)
+ * @param chan The MAVLink channel this message will be sent over
+ * @param msg The MAVLink message to compress the data into
+ * @param message_stats C-struct to read the message contents from
+ */
+static inline uint16_t mavlink_msg_message_stats_encode_chan(uint8_t system_id, uint8_t component_id, uint8_t chan, mavlink_message_t* msg, const mavlink_message_stats_t* message_stats)
+{
+	return mavlink_msg_message_stats_pack_chan(system_id, component_id, chan, msg, message_stats->time_boot_ms, message_stats->msgid, message_stats->index, message_stats->count, message_stats->rx_count, message_stats->rx_bytes, message_stats->gs_tx_count, message_stats->gs_tx_bytes, message_stats->dl_tx_count, message_stats->dl_tx_bytes, message_stats->gs_tx_dropped, message_stats->dl_tx_dropped);
+}
+
+/**
+ * @brief Send a message_stats message
+ * @param chan MAVLink channel to send the message
+ *
+ * @param time_boot_ms Timestamp (milliseconds since system boot)
+ * @param msgid The message ID these statistics are for.
+ * @param index Index of this entry in the statistics table.
+ * @param count Total number of entries in the statistics table.
+ * @param rx_count Number of these messages received.
+ * @param rx_bytes Number of bytes received in these messages, including the header and checksum.
+ * @param gs_tx_count Number of these messages transmitted to the groundstation.
+ * @param gs_tx_bytes Number of bytes transmitted to the groundstation in these messages, including the header and checksum.
+ * @param dl_tx_count Number of these messages transmitted to the datalogger.
+ * @param dl_tx_bytes Number of bytes transmitted to the datalogger in these messages, including the header and checksum.
+ * @param gs_tx_dropped Number of these messages dropped instead of transmitted to the groundstation because its queue was full.
+ * @param dl_tx_dropped Number of these messages dropped instead of transmitted to the datalogger because its queue was full.
+ */
+#ifdef MAVLINK_USE_CONVENIENCE_FUNCTIONS
+
+static inline void mavlink_msg_message_stats_send(mavlink_channel_t chan, uint32_t time_boot_ms, uint8_t msgid, uint8_t index, uint8_t count, uint32_t rx_count, uint32_t rx_bytes, uint32_t gs_tx_count, uint32_t gs_tx_bytes, uint32_t dl_tx_count, uint32_t dl_tx_bytes, uint32_t gs_tx_dropped, uint32_t dl_tx_dropped)
+{
+#if MAVLINK_NEED_BYTE_SWAP || !MAVLINK_ALIGNED_FIELDS
+	char buf[MAVLINK_MSG_ID_MESSAGE_STATS_LEN];
+	_mav_put_uint32_t(buf, 0, time_boot_ms);
+	_mav_put_uint32_t(buf, 4, rx_count);
+	_mav_put_uint32_t(buf, 8, rx_bytes);
+	_mav_put_uint32_t(buf, 12, gs_tx_count);
+	_mav_put_uint32_t(buf, 16, gs_tx_bytes);
+	_mav_put_uint32_t(buf, 20, dl_tx_count);
+	_mav_put_uint32_t(buf, 24, dl_tx_bytes);
+	_mav_put_uint32_t(buf, 28, gs_tx_dropped);
+	_mav_put_uint32_t(buf, 32, dl_tx_dropped);
+	_mav_put_uint8_t(buf, 36, msgid);
+	_mav_put_uint8_t(buf, 37, index);
+	_mav_put_uint8_t(buf, 38, count);
+
+#if MAVLINK_CRC_EXTRA
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_MESSAGE_STATS, buf, MAVLINK_MSG_ID_MESSAGE_STATS_LEN, MAVLINK_MSG_ID_MESSAGE_STATS_CRC);
+#else
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_MESSAGE_STATS, buf, MAVLINK_MSG_ID_MESSAGE_STATS_LEN);
+#endif
+#else
+	mavlink_message_stats_t packet;
+	packet.time_boot_ms = time_boot_ms;
+	packet.rx_count = rx_count;
+	packet.rx_bytes = rx_bytes;
+	packet.gs_tx_count = gs_tx_count;
+	packet.gs_tx_bytes = gs_tx_bytes;
+	packet.dl_tx_count = dl_tx_count;
+	packet.dl_tx_bytes = dl_tx_bytes;
+	packet.gs_tx_dropped = gs_tx_dropped;
+	packet.dl_tx_dropped = dl_tx_dropped;
+	packet.msgid = msgid;
+	packet.index = index;
+	packet.count = count;
+
+#if MAVLINK_CRC_EXTRA
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_MESSAGE_STATS, (const char *)&packet, MAVLINK_MSG_ID_MESSAGE_STATS_LEN, MAVLINK_MSG_ID_MESSAGE_STATS_CRC);
+#else
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_MESSAGE_STATS, (const char *)&packet, MAVLINK_MSG_ID_MESSAGE_STATS_LEN);
+#endif
+#endif
+}
+
+#if MAVLINK_MSG_ID_MESSAGE_STATS_LEN <= MAVLINK_MAX_PAYLOAD_LEN
+/*
+  This varient of _send() can be used to save stack space by re-using
+  memory from the receive buffer.  The caller provides a
+  mavlink_message_t which is the size of a full mavlink message. This
+  is usually the receive buffer for the channel, and allows a reply to an
+  incoming message with minimum stack space usage.
+ */
+static inline void mavlink_msg_message_stats_send_buf(mavlink_message_t *msgbuf, mavlink_channel_t chan,  uint32_t time_boot_ms, uint8_t msgid, uint8_t index, uint8_t count, uint32_t rx_count, uint32_t rx_bytes, uint32_t gs_tx_count, uint32_t gs_tx_bytes, uint32_t dl_tx_count, uint32_t dl_tx_bytes, uint32_t gs_tx_dropped, uint32_t dl_tx_dropped)
+{
+#if MAVLINK_NEED_BYTE_SWAP || !MAVLINK_ALIGNED_FIELDS
+	char *buf = (char *)msgbuf;
+	_mav_put_uint32_t(buf, 0, time_boot_ms);
+	_mav_put_uint32_t(buf, 4, rx_count);
+	_mav_put_uint32_t(buf, 8, rx_bytes);
+	_mav_put_uint32_t(buf, 12, gs_tx_count);
+	_mav_put_uint32_t(buf, 16, gs_tx_bytes);
+	_mav_put_uint32_t(buf, 20, dl_tx_count);
+	_mav_put_uint32_t(buf, 24, dl_tx_bytes);
+	_mav_put_uint32_t(buf, 28, gs_tx_dropped);
+	_mav_put_uint32_t(buf, 32, dl_tx_dropped);
+	_mav_put_uint8_t(buf, 36, msgid);
+	_mav_put_uint8_t(buf, 37, index);
+	_mav_put_uint8_t(buf, 38, count);
+
+#if MAVLINK_CRC_EXTRA
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_MESSAGE_STATS, buf, MAVLINK_MSG_ID_MESSAGE_STATS_LEN, MAVLINK_MSG_ID_MESSAGE_STATS_CRC);
+#else
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_MESSAGE_STATS, buf, MAVLINK_MSG_ID_MESSAGE_STATS_LEN);
+#endif
+#else
+	mavlink_message_stats_t *packet = (mavlink_message_stats_t *)msgbuf;
+	packet->time_boot_ms = time_boot_ms;
+	packet->rx_count = rx_count;
+	packet->rx_bytes = rx_bytes;
+	packet->gs_tx_count = gs_tx_count;
+	packet->gs_tx_bytes = gs_tx_bytes;
+	packet->dl_tx_count = dl_tx_count;
+	packet->dl_tx_bytes = dl_tx_bytes;
+	packet->gs_tx_dropped = gs_tx_dropped;
+	packet->dl_tx_dropped = dl_tx_dropped;
+	packet->msgid = msgid;
+	packet->index = index;
+	packet->count = count;
+
+#if MAVLINK_CRC_EXTRA
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_MESSAGE_STATS, (const char *)packet, MAVLINK_MSG_ID_MESSAGE_STATS_LEN, MAVLINK_MSG_ID_MESSAGE_STATS_CRC);
+#else
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_MESSAGE_STATS, (const char *)packet, MAVLINK_MSG_ID_MESSAGE_STATS_LEN);
+#endif
+#endif
+}
+#endif
+
+#endif
+
+// MESSAGE MESSAGE_STATS UNPACKING
+
+
+/**
+ * @brief Get field time_boot_ms from message_stats message
+ *
+ * @return Timestamp (milliseconds since system boot)
+ */
+static inline uint32_t mavlink_msg_message_stats_get_time_boot_ms(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint32_t(msg,  0);
+}
+
+/**
+ * @brief Get field msgid from message_stats message
+ *
+ * @return The message ID these statistics are for.
+ */
+static inline uint8_t mavlink_msg_message_stats_get_msgid(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint8_t(msg,  36);
+}
+
+/**
+ * @brief Get field index from message_stats message
+ *
+ * @return Index of this entry in the statistics table.
+ */
+static inline uint8_t mavlink_msg_message_stats_get_index(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint8_t(msg,  37);
+}
+
+/**
+ * @brief Get field count from message_stats message
+ *
+ * @return Total number of entries in the statistics table.
+ */
+static inline uint8_t mavlink_msg_message_stats_get_count(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint8_t(msg,  38);
+}
+
+/**
+ * @brief Get field rx_count from message_stats message
+ *
+ * @return Number of these messages received.
+ */
+static inline uint32_t mavlink_msg_message_stats_get_rx_count(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint32_t(msg,  4);
+}
+
+/**
+ * @brief Get field rx_bytes from message_stats message
+ *
+ * @return Number of bytes received in these messages, including the header and checksum.
+ */
+static inline uint32_t mavlink_msg_message_stats_get_rx_bytes(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint32_t(msg,  8);
+}
+
+/**
+ * @brief Get field gs_tx_count from message_stats message
+ *
+ * @return Number of these messages transmitted to the groundstation.
+ */
+static inline uint32_t mavlink_msg_message_stats_get_gs_tx_count(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint32_t(msg,  12);
+}
+
+/**
+ * @brief Get field gs_tx_bytes from message_stats message
+ *
+ * @return Number of bytes transmitted to the groundstation in these messages, including the header and checksum.
+ */
+static inline uint32_t mavlink_msg_message_stats_get_gs_tx_bytes(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint32_t(msg,  16);
+}
+
+/**
+ * @brief Get field dl_tx_count from message_stats message
+ *
+ * @return Number of these messages transmitted to the datalogger.
+ */
+static inline uint32_t mavlink_msg_message_stats_get_dl_tx_count(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint32_t(msg,  20);
+}
+
+/**
+ * @brief Get field dl_tx_bytes from message_stats message
+ *
+ * @return Number of bytes transmitted to the datalogger in these messages, including the header and checksum.
+ */
+static inline uint32_t mavlink_msg_message_stats_get_dl_tx_bytes(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint32_t(msg,  24);
+}
+
+/**
+ * @brief Get field gs_tx_dropped from message_stats message
+ *
+ * @return Number of these messages dropped instead of transmitted to the groundstation because its queue was full.
+ */
+static inline uint32_t mavlink_msg_message_stats_get_gs_tx_dropped(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint32_t(msg,  28);
+}
+
+/**
+ * @brief Get field dl_tx_dropped from message_stats message
+ *
+ * @return Number of these messages dropped instead of transmitted to the datalogger because its queue was full.
+ */
+static inline uint32_t mavlink_msg_message_stats_get_dl_tx_dropped(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint32_t(msg,  32);
+}
+
+/**
+ * @brief Decode a message_stats message into a struct
+ *
+ * @param msg The message to decode
+ * @param message_stats C-struct to decode the message contents into
+ */
+static inline void mavlink_msg_message_stats_decode(const mavlink_message_t* msg, mavlink_message_stats_t* message_stats)
+{
+#if MAVLINK_NEED_BYTE_SWAP
+	message_stats->time_boot_ms = mavlink_msg_message_stats_get_time_boot_ms(msg);
+	message_stats->rx_count = mavlink_msg_message_stats_get_rx_count(msg);
+	message_stats->rx_bytes = mavlink_msg_message_stats_get_rx_bytes(msg);
+	message_stats->gs_tx_count = mavlink_msg_message_stats_get_gs_tx_count(msg);
+	message_stats->gs_tx_bytes = mavlink_msg_message_stats_get_gs_tx_bytes(msg);
+	message_stats->dl_tx_count = mavlink_msg_message_stats_get_dl_tx_count(msg);
+	message_stats->dl_tx_bytes = mavlink_msg_message_stats_get_dl_tx_bytes(msg);
+	message_stats->gs_tx_dropped = mavlink_msg_message_stats_get_gs_tx_dropped(msg);
+	message_stats->dl_tx_dropped = mavlink_msg_message_stats_get_dl_tx_dropped(msg);
+	message_stats->msgid = mavlink_msg_message_stats_get_msgid(msg);
+	message_stats->index = mavlink_msg_message_stats_get_index(msg);
+	message_stats->count = mavlink_msg_message_stats_get_count(msg);
+#else
+	memcpy(message_stats, _MAV_PAYLOAD(msg), MAVLINK_MSG_ID_MESSAGE_STATS_LEN);
+#endif
+}
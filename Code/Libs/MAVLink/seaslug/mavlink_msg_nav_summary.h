@@ -0,0 +1,689 @@
+// MESSAGE NAV_SUMMARY PACKING
+
+#define MAVLINK_MSG_ID_NAV_SUMMARY 187
+
+typedef struct __mavlink_nav_summary_t
+{
+ uint32_t time_boot_ms; ///< Timestamp (milliseconds since system boot)
+ int32_t lat; ///< GPS latitude (WGS84), in degrees * 1E7
+ int32_t lon; ///< GPS longitude (WGS84), in degrees * 1E7
+ int16_t north; ///< Estimated position north of the local origin (decimeters)
+ int16_t east; ///< Estimated position east of the local origin (decimeters)
+ int16_t vel_north; ///< Estimated velocity north (cm/s)
+ int16_t vel_east; ///< Estimated velocity east (cm/s)
+ int16_t roll; ///< Roll angle. Units are 2e-13 rad.
+ int16_t pitch; ///< Pitch angle. Units are 2e-13 rad.
+ int16_t yaw; ///< Yaw angle, clockwise from north. Units are 2e-13 rad.
+ int16_t yaw_rate; ///< Yaw rate. Units are 2e-12 rad/s.
+ uint16_t sog; ///< GPS speed over ground (cm/s)
+ uint16_t cog; ///< GPS course over ground, 0.0..359.99 degrees. Units are cdeg.
+ uint16_t water_speed; ///< Speed through the water (cm/s)
+ int16_t rudder_angle; ///< The measured rudder angle. Units are 1e-4 rad.
+ int16_t throttle; ///< The throttle command in use. Units are 1/1023 of full throttle, positive forward.
+ uint16_t status; ///< The status bitfield of the primary node, as in the upper 16 bits of the HEARTBEAT custom_mode.
+ uint16_t errors; ///< The errors bitfield of the primary node, as in the lower 16 bits of the HEARTBEAT custom_mode.
+ uint8_t waypoint; ///< The index of the current waypoint in the mission, 255 if there's no mission.
+ uint8_t fix_type; ///< GPS fix type, as in GPS_RAW_INT: 0-1: no fix, 2: 2D fix, 3: 3D fix.
+ uint8_t satellites_visible; ///< Number of satellites visible. If unknown, set to 255
+} mavlink_nav_summary_t;
+
+#define MAVLINK_MSG_ID_NAV_SUMMARY_LEN 45
+#define MAVLINK_MSG_ID_187_LEN 45
+
+#define MAVLINK_MSG_ID_NAV_SUMMARY_CRC 162
+#define MAVLINK_MSG_ID_187_CRC 162
+
+
+
+#define MAVLINK_MESSAGE_INFO_NAV_SUMMARY { \
+	"NAV_SUMMARY", \
+	21, \
+	{  { "time_boot_ms", NULL, MAVLINK_TYPE_UINT32_T, 0, 0, offsetof(mavlink_nav_summary_t, time_boot_ms) }, \
+         { "lat", NULL, MAVLINK_TYPE_INT32_T, 0, 4, offsetof(mavlink_nav_summary_t, lat) }, \
+         { "lon", NULL, MAVLINK_TYPE_INT32_T, 0, 8, offsetof(mavlink_nav_summary_t, lon) }, \
+         { "north", NULL, MAVLINK_TYPE_INT16_T, 0, 12, offsetof(mavlink_nav_summary_t, north) }, \
+         { "east", NULL, MAVLINK_TYPE_INT16_T, 0, 14, offsetof(mavlink_nav_summary_t, east) }, \
+         { "vel_north", NULL, MAVLINK_TYPE_INT16_T, 0, 16, offsetof(mavlink_nav_summary_t, vel_north) }, \
+         { "vel_east", NULL, MAVLINK_TYPE_INT16_T, 0, 18, offsetof(mavlink_nav_summary_t, vel_east) }, \
+         { "roll", NULL, MAVLINK_TYPE_INT16_T, 0, 20, offsetof(mavlink_nav_summary_t, roll) }, \
+         { "pitch", NULL, MAVLINK_TYPE_INT16_T, 0, 22, offsetof(mavlink_nav_summary_t, pitch) }, \
+         { "yaw", NULL, MAVLINK_TYPE_INT16_T, 0, 24, offsetof(mavlink_nav_summary_t, yaw) }, \
+         { "yaw_rate", NULL, MAVLINK_TYPE_INT16_T, 0, 26, offsetof(mavlink_nav_summary_t, yaw_rate) }, \
+         { "sog", NULL, MAVLINK_TYPE_UINT16_T, 0, 28, offsetof(mavlink_nav_summary_t, sog) }, \
+         { "cog", NULL, MAVLINK_TYPE_UINT16_T, 0, 30, offsetof(mavlink_nav_summary_t, cog) }, \
+         { "water_speed", NULL, MAVLINK_TYPE_UINT16_T, 0, 32, offsetof(mavlink_nav_summary_t, water_speed) }, \
+         { "rudder_angle", NULL, MAVLINK_TYPE_INT16_T, 0, 34, offsetof(mavlink_nav_summary_t, rudder_angle) }, \
+         { "throttle", NULL, MAVLINK_TYPE_INT16_T, 0, 36, offsetof(mavlink_nav_summary_t, throttle) }, \
+         { "status", NULL, MAVLINK_TYPE_UINT16_T, 0, 38, offsetof(mavlink_nav_summary_t, status) }, \
+         { "errors", NULL, MAVLINK_TYPE_UINT16_T, 0, 40, offsetof(mavlink_nav_summary_t, errors) }, \
+         { "waypoint", NULL, MAVLINK_TYPE_UINT8_T, 0, 42, offsetof(mavlink_nav_summary_t, waypoint) }, \
+         { "fix_type", NULL, MAVLINK_TYPE_UINT8_T, 0, 43, offsetof(mavlink_nav_summary_t, fix_type) }, \
+         { "satellites_visible", NULL, MAVLINK_TYPE_UINT8_T, 0, 44, offsetof(mavlink_nav_summary_t, satellites_visible) }, \
+         } \
+}
+
+
+/**
+ * @brief Pack a nav_summary message
+ * @param system_id ID of this system
+ * @param component_id ID of this component (e.g. 200 for IMU)
+ * @param msg The MAVLink message to compress the data into
+ *
+ * @param time_boot_ms Timestamp (milliseconds since system boot)
+ * @param lat GPS latitude (WGS84), in degrees * 1E7
+ * @param lon GPS longitude (WGS84), in degrees * 1E7
+ * @param north Estimated position north of the local origin (decimeters)
+ * @param east Estimated position east of the local origin (decimeters)
+ * @param vel_north Estimated velocity north (cm/s)
+ * @param vel_east Estimated velocity east (cm/s)
+ * @param roll Roll angle. Units are 2e-13 rad.
+ * @param pitch Pitch angle. Units are 2e-13 rad.
+ * @param yaw Yaw angle, clockwise from north. Units are 2e-13 rad.
+ * @param yaw_rate Yaw rate. Units are 2e-12 rad/s.
+ * @param sog GPS speed over ground (cm/s)
+ * @param cog GPS course over ground, 0.0..359.99 degrees. Units are cdeg.
+ * @param water_speed Speed through the water (cm/s)
+ * @param rudder_angle The measured rudder angle. Units are 1e-4 rad.
+ * @param throttle The throttle command in use. Units are 1/1023 of full throttle, positive forward.
+ * @param status The status bitfield of the primary node, as in the upper 16 bits of the HEARTBEAT custom_mode.
+ * @param errors The errors bitfield of the primary node, as in the lower 16 bits of the HEARTBEAT custom_mode.
+ * @param waypoint The index of the current waypoint in the mission, 255 if there's no mission.
+ * @param fix_type GPS fix type, as in GPS_RAW_INT: 0-1: no fix, 2: 2D fix, 3: 3D fix.
+ * @param satellites_visible Number of satellites visible. If unknown, set to 255
+ * @return length of the message in bytes (excluding serial stream start sign)
+ */
+static inline uint16_t mavlink_msg_nav_summary_pack(uint8_t system_id, uint8_t component_id, mavlink_message_t* msg,
+						       uint32_t time_boot_ms, int32_t lat, int32_t lon, int16_t north, int16_t east, int16_t vel_north, int16_t vel_east, int16_t roll, int16_t pitch, int16_t yaw, int16_t yaw_rate, uint16_t sog, uint16_t cog, uint16_t water_speed, int16_t rudder_angle, int16_t throttle, uint16_t status, uint16_t errors, uint8_t waypoint, uint8_t fix_type, uint8_t satellites_visible)
+{
+#if MAVLINK_NEED_BYTE_SWAP || !MAVLINK_ALIGNED_FIELDS
+	char buf[MAVLINK_MSG_ID_NAV_SUMMARY_LEN];
+	_mav_put_uint32_t(buf, 0, time_boot_ms);
+	_mav_put_int32_t(buf, 4, lat);
+	_mav_put_int32_t(buf, 8, lon);
+	_mav_put_int16_t(buf, 12, north);
+	_mav_put_int16_t(buf, 14, east);
+	_mav_put_int16_t(buf, 16, vel_north);
+	_mav_put_int16_t(buf, 18, vel_east);
+	_mav_put_int16_t(buf, 20, roll);
+	_mav_put_int16_t(buf, 22, pitch);
+	_mav_put_int16_t(buf, 24, yaw);
+	_mav_put_int16_t(buf, 26, yaw_rate);
+	_mav_put_uint16_t(buf, 28, sog);
+	_mav_put_uint16_t(buf, 30, cog);
+	_mav_put_uint16_t(buf, 32, water_speed);
+	_mav_put_int16_t(buf, 34, rudder_angle);
+	_mav_put_int16_t(buf, 36, throttle);
+	_mav_put_uint16_t(buf, 38, status);
+	_mav_put_uint16_t(buf, 40, errors);
+	_mav_put_uint8_t(buf, 42, waypoint);
+	_mav_put_uint8_t(buf, 43, fix_type);
+	_mav_put_uint8_t(buf, 44, satellites_visible);
+
+        memcpy(_MAV_PAYLOAD_NON_CONST(msg), buf, MAVLINK_MSG_ID_NAV_SUMMARY_LEN);
+#else
+	mavlink_nav_summary_t packet;
+	packet.time_boot_ms = time_boot_ms;
+	packet.lat = lat;
+	packet.lon = lon;
+	packet.north = north;
+	packet.east = east;
+	packet.vel_north = vel_north;
+	packet.vel_east = vel_east;
+	packet.roll = roll;
+	packet.pitch = pitch;
+	packet.yaw = yaw;
+	packet.yaw_rate = yaw_rate;
+	packet.sog = sog;
+	packet.cog = cog;
+	packet.water_speed = water_speed;
+	packet.rudder_angle = rudder_angle;
+	packet.throttle = throttle;
+	packet.status = status;
+	packet.errors = errors;
+	packet.waypoint = waypoint;
+	packet.fix_type = fix_type;
+	packet.satellites_visible = satellites_visible;
+
+        memcpy(_MAV_PAYLOAD_NON_CONST(msg), &packet, MAVLINK_MSG_ID_NAV_SUMMARY_LEN);
+#endif
+
+	msg->msgid = MAVLINK_MSG_ID_NAV_SUMMARY;
+#if MAVLINK_CRC_EXTRA
+    return mavlink_finalize_message(msg, system_id, component_id, MAVLINK_MSG_ID_NAV_SUMMARY_LEN, MAVLINK_MSG_ID_NAV_SUMMARY_CRC);
+#else
+    return mavlink_finalize_message(msg, system_id, component_id, MAVLINK_MSG_ID_NAV_SUMMARY_LEN);
+#endif
+}
+
+/**
+ * @brief Pack a nav_summary message on a channel
+ * @param system_id ID of this system
+ * @param component_id ID of this component (e.g. 200 for IMU)
+ * @param chan The MAVLink channel this message will be sent over
+ * @param msg The MAVLink message to compress the data into
+ * @param time_boot_ms Timestamp (milliseconds since system boot)
+ * @param lat GPS latitude (WGS84), in degrees * 1E7
+ * @param lon GPS longitude (WGS84), in degrees * 1E7
+ * @param north Estimated position north of the local origin (decimeters)
+ * @param east Estimated position east of the local origin (decimeters)
+ * @param vel_north Estimated velocity north (cm/s)
+ * @param vel_east Estimated velocity east (cm/s)
+ * @param roll Roll angle. Units are 2e-13 rad.
+ * @param pitch Pitch angle. Units are 2e-13 rad.
+ * @param yaw Yaw angle, clockwise from north. Units are 2e-13 rad.
+ * @param yaw_rate Yaw rate. Units are 2e-12 rad/s.
+ * @param sog GPS speed over ground (cm/s)
+ * @param cog GPS course over ground, 0.0..359.99 degrees. Units are cdeg.
+ * @param water_speed Speed through the water (cm/s)
+ * @param rudder_angle The measured rudder angle. Units are 1e-4 rad.
+ * @param throttle The throttle command in use. Units are 1/1023 of full throttle, positive forward.
+ * @param status The status bitfield of the primary node, as in the upper 16 bits of the HEARTBEAT custom_mode.
+ * @param errors The errors bitfield of the primary node, as in the lower 16 bits of the HEARTBEAT custom_mode.
+ * @param waypoint The index of the current waypoint in the mission, 255 if there's no mission.
+ * @param fix_type GPS fix type, as in GPS_RAW_INT: 0-1: no fix, 2: 2D fix, 3: 3D fix.
+ * @param satellites_visible Number of satellites visible. If unknown, set to 255
+ * @return length of the message in bytes (excluding serial stream start sign)
+ */
+static inline uint16_t mavlink_msg_nav_summary_pack_chan(uint8_t system_id, uint8_t component_id, uint8_t chan,
+							   mavlink_message_t* msg,
+						           uint32_t time_boot_ms,int32_t lat,int32_t lon,int16_t north,int16_t east,int16_t vel_north,int16_t vel_east,int16_t roll,int16_t pitch,int16_t yaw,int16_t yaw_rate,uint16_t sog,uint16_t cog,uint16_t water_speed,int16_t rudder_angle,int16_t throttle,uint16_t status,uint16_t errors,uint8_t waypoint,uint8_t fix_type,uint8_t satellites_visible)
+{
+#if MAVLINK_NEED_BYTE_SWAP || !MAVLINK_ALIGNED_FIELDS
+	char buf[MAVLINK_MSG_ID_NAV_SUMMARY_LEN];
+	_mav_put_uint32_t(buf, 0, time_boot_ms);
+	_mav_put_int32_t(buf, 4, lat);
+	_mav_put_int32_t(buf, 8, lon);
+	_mav_put_int16_t(buf, 12, north);
+	_mav_put_int16_t(buf, 14, east);
+	_mav_put_int16_t(buf, 16, vel_north);
+	_mav_put_int16_t(buf, 18, vel_east);
+	_mav_put_int16_t(buf, 20, roll);
+	_mav_put_int16_t(buf, 22, pitch);
+	_mav_put_int16_t(buf, 24, yaw);
+	_mav_put_int16_t(buf, 26, yaw_rate);
+	_mav_put_uint16_t(buf, 28, sog);
+	_mav_put_uint16_t(buf, 30, cog);
+	_mav_put_uint16_t(buf, 32, water_speed);
+	_mav_put_int16_t(buf, 34, rudder_angle);
+	_mav_put_int16_t(buf, 36, throttle);
+	_mav_put_uint16_t(buf, 38, status);
+	_mav_put_uint16_t(buf, 40, errors);
+	_mav_put_uint8_t(buf, 42, waypoint);
+	_mav_put_uint8_t(buf, 43, fix_type);
+	_mav_put_uint8_t(buf, 44, satellites_visible);
+
+        memcpy(_MAV_PAYLOAD_NON_CONST(msg), buf, MAVLINK_MSG_ID_NAV_SUMMARY_LEN);
+#else
+	mavlink_nav_summary_t packet;
+	packet.time_boot_ms = time_boot_ms;
+	packet.lat = lat;
+	packet.lon = lon;
+	packet.north = north;
+	packet.east = east;
+	packet.vel_north = vel_north;
+	packet.vel_east = vel_east;
+	packet.roll = roll;
+	packet.pitch = pitch;
+	packet.yaw = yaw;
+	packet.yaw_rate = yaw_rate;
+	packet.sog = sog;
+	packet.cog = cog;
+	packet.water_speed = water_speed;
+	packet.rudder_angle = rudder_angle;
+	packet.throttle = throttle;
+	packet.status = status;
+	packet.errors = errors;
+	packet.waypoint = waypoint;
+	packet.fix_type = fix_type;
+	packet.satellites_visible = satellites_visible;
+
+        memcpy(_MAV_PAYLOAD_NON_CONST(msg), &packet, MAVLINK_MSG_ID_NAV_SUMMARY_LEN);
+#endif
+
+	msg->msgid = MAVLINK_MSG_ID_NAV_SUMMARY;
+#if MAVLINK_CRC_EXTRA
+    return mavlink_finalize_message_chan(msg, system_id, component_id, chan, MAVLINK_MSG_ID_NAV_SUMMARY_LEN, MAVLINK_MSG_ID_NAV_SUMMARY_CRC);
+#else
+    return mavlink_finalize_message_chan(msg, system_id, component_id, chan, MAVLINK_MSG_ID_NAV_SUMMARY_LEN);
+#endif
+}
+
+/**
+ * @brief Encode a nav_summary struct
+ *
+ * @param system_id ID of this system
+ * @param component_id ID of this component (e.g. 200 for IMU)
+ * @param msg The MAVLink message to compress the data into
+ * @param nav_summary C-struct to read the message contents from
+ */
+static inline uint16_t mavlink_msg_nav_summary_encode(uint8_t system_id, uint8_t component_id, mavlink_message_t* msg, const mavlink_nav_summary_t* nav_summary)
+{
+	return mavlink_msg_nav_summary_pack(system_id, component_id, msg, nav_summary->time_boot_ms, nav_summary->lat, nav_summary->lon, nav_summary->north, nav_summary->east, nav_summary->vel_north, nav_summary->vel_east, nav_summary->roll, nav_summary->pitch, nav_summary->yaw, nav_summary->yaw_rate, nav_summary->sog, nav_summary->cog, nav_summary->water_speed, nav_summary->rudder_angle, nav_summary->throttle, nav_summary->status, nav_summary->errors, nav_summary->waypoint, nav_summary->fix_type, nav_summary->satellites_visible);
+}
+
+/**
+ * @brief Encode a nav_summary struct on a channel
+ *
+ * @param system_id ID of this system
+ * @param component_id ID of this component (e.g. 200 for IMU)
+ * @param chan The MAVLink channel this message will be sent over
+ * @param msg The MAVLink message to compress the data into
+ * @param nav_summary C-struct to read the message contents from
+ */
+static inline uint16_t mavlink_msg_nav_summary_encode_chan(uint8_t system_id, uint8_t component_id, uint8_t chan, mavlink_message_t* msg, const mavlink_nav_summary_t* nav_summary)
+{
+	return mavlink_msg_nav_summary_pack_chan(system_id, component_id, chan, msg, nav_summary->time_boot_ms, nav_summary->lat, nav_summary->lon, nav_summary->north, nav_summary->east, nav_summary->vel_north, nav_summary->vel_east, nav_summary->roll, nav_summary->pitch, nav_summary->yaw, nav_summary->yaw_rate, nav_summary->sog, nav_summary->cog, nav_summary->water_speed, nav_summary->rudder_angle, nav_summary->throttle, nav_summary->status, nav_summary->errors, nav_summary->waypoint, nav_summary->fix_type, nav_summary->satellites_visible);
+}
+
+/**
+ * @brief Send a nav_summary message
+ * @param chan MAVLink channel to send the message
+ *
+ * @param time_boot_ms Timestamp (milliseconds since system boot)
+ * @param lat GPS latitude (WGS84), in degrees * 1E7
+ * @param lon GPS longitude (WGS84), in degrees * 1E7
+ * @param north Estimated position north of the local origin (decimeters)
+ * @param east Estimated position east of the local origin (decimeters)
+ * @param vel_north Estimated velocity north (cm/s)
+ * @param vel_east Estimated velocity east (cm/s)
+ * @param roll Roll angle. Units are 2e-13 rad.
+ * @param pitch Pitch angle. Units are 2e-13 rad.
+ * @param yaw Yaw angle, clockwise from north. Units are 2e-13 rad.
+ * @param yaw_rate Yaw rate. Units are 2e-12 rad/s.
+ * @param sog GPS speed over ground (cm/s)
+ * @param cog GPS course over ground, 0.0..359.99 degrees. Units are cdeg.
+ * @param water_speed Speed through the water (cm/s)
+ * @param rudder_angle The measured rudder angle. Units are 1e-4 rad.
+ * @param throttle The throttle command in use. Units are 1/1023 of full throttle, positive forward.
+ * @param status The status bitfield of the primary node, as in the upper 16 bits of the HEARTBEAT custom_mode.
+ * @param errors The errors bitfield of the primary node, as in the lower 16 bits of the HEARTBEAT custom_mode.
+ * @param waypoint The index of the current waypoint in the mission, 255 if there's no mission.
+ * @param fix_type GPS fix type, as in GPS_RAW_INT: 0-1: no fix, 2: 2D fix, 3: 3D fix.
+ * @param satellites_visible Number of satellites visible. If unknown, set to 255
+ */
+#ifdef MAVLINK_USE_CONVENIENCE_FUNCTIONS
+
+static inline void mavlink_msg_nav_summary_send(mavlink_channel_t chan, uint32_t time_boot_ms, int32_t lat, int32_t lon, int16_t north, int16_t east, int16_t vel_north, int16_t vel_east, int16_t roll, int16_t pitch, int16_t yaw, int16_t yaw_rate, uint16_t sog, uint16_t cog, uint16_t water_speed, int16_t rudder_angle, int16_t throttle, uint16_t status, uint16_t errors, uint8_t waypoint, uint8_t fix_type, uint8_t satellites_visible)
+{
+#if MAVLINK_NEED_BYTE_SWAP || !MAVLINK_ALIGNED_FIELDS
+	char buf[MAVLINK_MSG_ID_NAV_SUMMARY_LEN];
+	_mav_put_uint32_t(buf, 0, time_boot_ms);
+	_mav_put_int32_t(buf, 4, lat);
+	_mav_put_int32_t(buf, 8, lon);
+	_mav_put_int16_t(buf, 12, north);
+	_mav_put_int16_t(buf, 14, east);
+	_mav_put_int16_t(buf, 16, vel_north);
+	_mav_put_int16_t(buf, 18, vel_east);
+	_mav_put_int16_t(buf, 20, roll);
+	_mav_put_int16_t(buf, 22, pitch);
+	_mav_put_int16_t(buf, 24, yaw);
+	_mav_put_int16_t(buf, 26, yaw_rate);
+	_mav_put_uint16_t(buf, 28, sog);
+	_mav_put_uint16_t(buf, 30, cog);
+	_mav_put_uint16_t(buf, 32, water_speed);
+	_mav_put_int16_t(buf, 34, rudder_angle);
+	_mav_put_int16_t(buf, 36, throttle);
+	_mav_put_uint16_t(buf, 38, status);
+	_mav_put_uint16_t(buf, 40, errors);
+	_mav_put_uint8_t(buf, 42, waypoint);
+	_mav_put_uint8_t(buf, 43, fix_type);
+	_mav_put_uint8_t(buf, 44, satellites_visible);
+
+#if MAVLINK_CRC_EXTRA
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_NAV_SUMMARY, buf, MAVLINK_MSG_ID_NAV_SUMMARY_LEN, MAVLINK_MSG_ID_NAV_SUMMARY_CRC);
+#else
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_NAV_SUMMARY, buf, MAVLINK_MSG_ID_NAV_SUMMARY_LEN);
+#endif
+#else
+	mavlink_nav_summary_t packet;
+	packet.time_boot_ms = time_boot_ms;
+	packet.lat = lat;
+	packet.lon = lon;
+	packet.north = north;
+	packet.east = east;
+	packet.vel_north = vel_north;
+	packet.vel_east = vel_east;
+	packet.roll = roll;
+	packet.pitch = pitch;
+	packet.yaw = yaw;
+	packet.yaw_rate = yaw_rate;
+	packet.sog = sog;
+	packet.cog = cog;
+	packet.water_speed = water_speed;
+	packet.rudder_angle = rudder_angle;
+	packet.throttle = throttle;
+	packet.status = status;
+	packet.errors = errors;
+	packet.waypoint = waypoint;
+	packet.fix_type = fix_type;
+	packet.satellites_visible = satellites_visible;
+
+#if MAVLINK_CRC_EXTRA
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_NAV_SUMMARY, (const char *)&packet, MAVLINK_MSG_ID_NAV_SUMMARY_LEN, MAVLINK_MSG_ID_NAV_SUMMARY_CRC);
+#else
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_NAV_SUMMARY, (const char *)&packet, MAVLINK_MSG_ID_NAV_SUMMARY_LEN);
+#endif
+#endif
+}
+
+#if MAVLINK_MSG_ID_NAV_SUMMARY_LEN <= MAVLINK_MAX_PAYLOAD_LEN
+/*
+  This varient of _send() can be used to save stack space by re-using
+  memory from the receive buffer.  The caller provides a
+  mavlink_message_t which is the size of a full mavlink message. This
+  is usually the receive buffer for the channel, and allows a reply to an
+  incoming message with minimum stack space usage.
+ */
+static inline void mavlink_msg_nav_summary_send_buf(mavlink_message_t *msgbuf, mavlink_channel_t chan,  uint32_t time_boot_ms, int32_t lat, int32_t lon, int16_t north, int16_t east, int16_t vel_north, int16_t vel_east, int16_t roll, int16_t pitch, int16_t yaw, int16_t yaw_rate, uint16_t sog, uint16_t cog, uint16_t water_speed, int16_t rudder_angle, int16_t throttle, uint16_t status, uint16_t errors, uint8_t waypoint, uint8_t fix_type, uint8_t satellites_visible)
+{
+#if MAVLINK_NEED_BYTE_SWAP || !MAVLINK_ALIGNED_FIELDS
+	char *buf = (char *)msgbuf;
+	_mav_put_uint32_t(buf, 0, time_boot_ms);
+	_mav_put_int32_t(buf, 4, lat);
+	_mav_put_int32_t(buf, 8, lon);
+	_mav_put_int16_t(buf, 12, north);
+	_mav_put_int16_t(buf, 14, east);
+	_mav_put_int16_t(buf, 16, vel_north);
+	_mav_put_int16_t(buf, 18, vel_east);
+	_mav_put_int16_t(buf, 20, roll);
+	_mav_put_int16_t(buf, 22, pitch);
+	_mav_put_int16_t(buf, 24, yaw);
+	_mav_put_int16_t(buf, 26, yaw_rate);
+	_mav_put_uint16_t(buf, 28, sog);
+	_mav_put_uint16_t(buf, 30, cog);
+	_mav_put_uint16_t(buf, 32, water_speed);
+	_mav_put_int16_t(buf, 34, rudder_angle);
+	_mav_put_int16_t(buf, 36, throttle);
+	_mav_put_uint16_t(buf, 38, status);
+	_mav_put_uint16_t(buf, 40, errors);
+	_mav_put_uint8_t(buf, 42, waypoint);
+	_mav_put_uint8_t(buf, 43, fix_type);
+	_mav_put_uint8_t(buf, 44, satellites_visible);
+
+#if MAVLINK_CRC_EXTRA
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_NAV_SUMMARY, buf, MAVLINK_MSG_ID_NAV_SUMMARY_LEN, MAVLINK_MSG_ID_NAV_SUMMARY_CRC);
+#else
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_NAV_SUMMARY, buf, MAVLINK_MSG_ID_NAV_SUMMARY_LEN);
+#endif
+#else
+	mavlink_nav_summary_t *packet = (mavlink_nav_summary_t *)msgbuf;
+	packet->time_boot_ms = time_boot_ms;
+	packet->lat = lat;
+	packet->lon = lon;
+	packet->north = north;
+	packet->east = east;
+	packet->vel_north = vel_north;
+	packet->vel_east = vel_east;
+	packet->roll = roll;
+	packet->pitch = pitch;
+	packet->yaw = yaw;
+	packet->yaw_rate = yaw_rate;
+	packet->sog = sog;
+	packet->cog = cog;
+	packet->water_speed = water_speed;
+	packet->rudder_angle = rudder_angle;
+	packet->throttle = throttle;
+	packet->status = status;
+	packet->errors = errors;
+	packet->waypoint = waypoint;
+	packet->fix_type = fix_type;
+	packet->satellites_visible = satellites_visible;
+
+#if MAVLINK_CRC_EXTRA
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_NAV_SUMMARY, (const char *)packet, MAVLINK_MSG_ID_NAV_SUMMARY_LEN, MAVLINK_MSG_ID_NAV_SUMMARY_CRC);
+#else
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_NAV_SUMMARY, (const char *)packet, MAVLINK_MSG_ID_NAV_SUMMARY_LEN);
+#endif
+#endif
+}
+#endif
+
+#endif
+
+// MESSAGE NAV_SUMMARY UNPACKING
+
+
+/**
+ * @brief Get field time_boot_ms from nav_summary message
+ *
+ * @return Timestamp (milliseconds since system boot)
+ */
+static inline uint32_t mavlink_msg_nav_summary_get_time_boot_ms(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint32_t(msg,  0);
+}
+
+/**
+ * @brief Get field lat from nav_summary message
+ *
+ * @return GPS latitude (WGS84), in degrees * 1E7
+ */
+static inline int32_t mavlink_msg_nav_summary_get_lat(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_int32_t(msg,  4);
+}
+
+/**
+ * @brief Get field lon from nav_summary message
+ *
+ * @return GPS longitude (WGS84), in degrees * 1E7
+ */
+static inline int32_t mavlink_msg_nav_summary_get_lon(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_int32_t(msg,  8);
+}
+
+/**
+ * @brief Get field north from nav_summary message
+ *
+ * @return Estimated position north of the local origin (decimeters)
+ */
+static inline int16_t mavlink_msg_nav_summary_get_north(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_int16_t(msg,  12);
+}
+
+/**
+ * @brief Get field east from nav_summary message
+ *
+ * @return Estimated position east of the local origin (decimeters)
+ */
+static inline int16_t mavlink_msg_nav_summary_get_east(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_int16_t(msg,  14);
+}
+
+/**
+ * @brief Get field vel_north from nav_summary message
+ *
+ * @return Estimated velocity north (cm/s)
+ */
+static inline int16_t mavlink_msg_nav_summary_get_vel_north(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_int16_t(msg,  16);
+}
+
+/**
+ * @brief Get field vel_east from nav_summary message
+ *
+ * @return Estimated velocity east (cm/s)
+ */
+static inline int16_t mavlink_msg_nav_summary_get_vel_east(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_int16_t(msg,  18);
+}
+
+/**
+ * @brief Get field roll from nav_summary message
+ *
+ * @return Roll angle. Units are 2e-13 rad.
+ */
+static inline int16_t mavlink_msg_nav_summary_get_roll(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_int16_t(msg,  20);
+}
+
+/**
+ * @brief Get field pitch from nav_summary message
+ *
+ * @return Pitch angle. Units are 2e-13 rad.
+ */
+static inline int16_t mavlink_msg_nav_summary_get_pitch(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_int16_t(msg,  22);
+}
+
+/**
+ * @brief Get field yaw from nav_summary message
+ *
+ * @return Yaw angle, clockwise from north. Units are 2e-13 rad.
+ */
+static inline int16_t mavlink_msg_nav_summary_get_yaw(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_int16_t(msg,  24);
+}
+
+/**
+ * @brief Get field yaw_rate from nav_summary message
+ *
+ * @return Yaw rate. Units are 2e-12 rad/s.
+ */
+static inline int16_t mavlink_msg_nav_summary_get_yaw_rate(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_int16_t(msg,  26);
+}
+
+/**
+ * @brief Get field sog from nav_summary message
+ *
+ * @return GPS speed over ground (cm/s)
+ */
+static inline uint16_t mavlink_msg_nav_summary_get_sog(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint16_t(msg,  28);
+}
+
+/**
+ * @brief Get field cog from nav_summary message
+ *
+ * @return GPS course over ground, 0.0..359.99 degrees. Units are cdeg.
+ */
+static inline uint16_t mavlink_msg_nav_summary_get_cog(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint16_t(msg,  30);
+}
+
+/**
+ * @brief Get field water_speed from nav_summary message
+ *
+ * @return Speed through the water (cm/s)
+ */
+static inline uint16_t mavlink_msg_nav_summary_get_water_speed(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint16_t(msg,  32);
+}
+
+/**
+ * @brief Get field rudder_angle from nav_summary message
+ *
+ * @return The measured rudder angle. Units are 1e-4 rad.
+ */
+static inline int16_t mavlink_msg_nav_summary_get_rudder_angle(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_int16_t(msg,  34);
+}
+
+/**
+ * @brief Get field throttle from nav_summary message
+ *
+ * @return The throttle command in use. Units are 1/1023 of full throttle, positive forward.
+ */
+static inline int16_t mavlink_msg_nav_summary_get_throttle(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_int16_t(msg,  36);
+}
+
+/**
+ * @brief Get field status from nav_summary message
+ *
+ * @return The status bitfield of the primary node, as in the upper 16 bits of the HEARTBEAT custom_mode.
+ */
+static inline uint16_t mavlink_msg_nav_summary_get_status(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint16_t(msg,  38);
+}
+
+/**
+ * @brief Get field errors from nav_summary message
+ *
+ * @return The errors bitfield of the primary node, as in the lower 16 bits of the HEARTBEAT custom_mode.
+ */
+static inline uint16_t mavlink_msg_nav_summary_get_errors(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint16_t(msg,  40);
+}
+
+/**
+ * @brief Get field waypoint from nav_summary message
+ *
+ * @return The index of the current waypoint in the mission, 255 if there's no mission.
+ */
+static inline uint8_t mavlink_msg_nav_summary_get_waypoint(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint8_t(msg,  42);
+}
+
+/**
+ * @brief Get field fix_type from nav_summary message
+ *
+ * @return GPS fix type, as in GPS_RAW_INT: 0-1: no fix, 2: 2D fix, 3: 3D fix.
+ */
+static inline uint8_t mavlink_msg_nav_summary_get_fix_type(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint8_t(msg,  43);
+}
+
+/**
+ * @brief Get field satellites_visible from nav_summary message
+ *
+ * @return Number of satellites visible. If unknown, set to 255
+ */
+static inline uint8_t mavlink_msg_nav_summary_get_satellites_visible(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint8_t(msg,  44);
+}
+
+/**
+ * @brief Decode a nav_summary message into a struct
+ *
+ * @param msg The message to decode
+ * @param nav_summary C-struct to decode the message contents into
+ */
+static inline void mavlink_msg_nav_summary_decode(const mavlink_message_t* msg, mavlink_nav_summary_t* nav_summary)
+{
+#if MAVLINK_NEED_BYTE_SWAP
+	nav_summary->time_boot_ms = mavlink_msg_nav_summary_get_time_boot_ms(msg);
+	nav_summary->lat = mavlink_msg_nav_summary_get_lat(msg);
+	nav_summary->lon = mavlink_msg_nav_summary_get_lon(msg);
+	nav_summary->north = mavlink_msg_nav_summary_get_north(msg);
+	nav_summary->east = mavlink_msg_nav_summary_get_east(msg);
+	nav_summary->vel_north = mavlink_msg_nav_summary_get_vel_north(msg);
+	nav_summary->vel_east = mavlink_msg_nav_summary_get_vel_east(msg);
+	nav_summary->roll = mavlink_msg_nav_summary_get_roll(msg);
+	nav_summary->pitch = mavlink_msg_nav_summary_get_pitch(msg);
+	nav_summary->yaw = mavlink_msg_nav_summary_get_yaw(msg);
+	nav_summary->yaw_rate = mavlink_msg_nav_summary_get_yaw_rate(msg);
+	nav_summary->sog = mavlink_msg_nav_summary_get_sog(msg);
+	nav_summary->cog = mavlink_msg_nav_summary_get_cog(msg);
+	nav_summary->water_speed = mavlink_msg_nav_summary_get_water_speed(msg);
+	nav_summary->rudder_angle = mavlink_msg_nav_summary_get_rudder_angle(msg);
+	nav_summary->throttle = mavlink_msg_nav_summary_get_throttle(msg);
+	nav_summary->status = mavlink_msg_nav_summary_get_status(msg);
+	nav_summary->errors = mavlink_msg_nav_summary_get_errors(msg);
+	nav_summary->waypoint = mavlink_msg_nav_summary_get_waypoint(msg);
+	nav_summary->fix_type = mavlink_msg_nav_summary_get_fix_type(msg);
+	nav_summary->satellites_visible = mavlink_msg_nav_summary_get_satellites_visible(msg);
+#else
+	memcpy(nav_summary, _MAV_PAYLOAD(msg), MAVLINK_MSG_ID_NAV_SUMMARY_LEN);
+#endif
+}
@@ -0,0 +1,441 @@
+// MESSAGE SENSOR_STATS PACKING
+
+#define MAVLINK_MSG_ID_SENSOR_STATS 188
+
+typedef struct __mavlink_sensor_stats_t
+{
+ uint32_t time_boot_ms; ///< Timestamp (milliseconds since system boot)
+ uint32_t interval_mean; ///< Mean interval between messages over about the last 16 intervals, excluding dropouts (microseconds).
+ uint32_t interval_max; ///< Longest interval between messages since boot or the last reset (microseconds).
+ uint32_t jitter; ///< Mean absolute difference between each interval and the mean interval, averaged like the mean (microseconds).
+ uint32_t since_last; ///< Time since the last message (milliseconds). UINT32_MAX if none has been received.
+ uint32_t samples; ///< Number of messages received since boot or the last reset.
+ uint16_t dropouts; ///< Number of intervals longer than twice the mean interval, where at least one message was missed, since boot or the last reset.
+ uint8_t sensor; ///< The sensor these statistics are for. 0: GPS, 1: IMU, 2: WSO100, 3: DST800, 4: power node, 5: ACS300, 6: rudder, 7: RC node, 8: gyro.
+ uint8_t count; ///< Total number of sensors.
+ uint8_t status; ///< 1 if the sensor is enabled, 3 if it's also active, 0 otherwise.
+ char name[8]; ///< Name of the sensor, terminated by NULL if the length is less than 8 chars.
+} mavlink_sensor_stats_t;
+
+#define MAVLINK_MSG_ID_SENSOR_STATS_LEN 37
+#define MAVLINK_MSG_ID_188_LEN 37
+
+#define MAVLINK_MSG_ID_SENSOR_STATS_CRC 2
+#define MAVLINK_MSG_ID_188_CRC 2
+
+#define MAVLINK_MSG_SENSOR_STATS_FIELD_NAME_LEN 8
+
+#define MAVLINK_MESSAGE_INFO_SENSOR_STATS { \
+	"SENSOR_STATS", \
+	11, \
+	{  { "time_boot_ms", NULL, MAVLINK_TYPE_UINT32_T, 0, 0, offsetof(mavlink_sensor_stats_t, time_boot_ms) }, \
+         { "interval_mean", NULL, MAVLINK_TYPE_UINT32_T, 0, 4, offsetof(mavlink_sensor_stats_t, interval_mean) }, \
+         { "interval_max", NULL, MAVLINK_TYPE_UINT32_T, 0, 8, offsetof(mavlink_sensor_stats_t, interval_max) }, \
+         { "jitter", NULL, MAVLINK_TYPE_UINT32_T, 0, 12, offsetof(mavlink_sensor_stats_t, jitter) }, \
+         { "since_last", NULL, MAVLINK_TYPE_UINT32_T, 0, 16, offsetof(mavlink_sensor_stats_t, since_last) }, \
+         { "samples", NULL, MAVLINK_TYPE_UINT32_T, 0, 20, offsetof(mavlink_sensor_stats_t, samples) }, \
+         { "dropouts", NULL, MAVLINK_TYPE_UINT16_T, 0, 24, offsetof(mavlink_sensor_stats_t, dropouts) }, \
+         { "sensor", NULL, MAVLINK_TYPE_UINT8_T, 0, 26, offsetof(mavlink_sensor_stats_t, sensor) }, \
+         { "count", NULL, MAVLINK_TYPE_UINT8_T, 0, 27, offsetof(mavlink_sensor_stats_t, count) }, \
+         { "status", NULL, MAVLINK_TYPE_UINT8_T, 0, 28, offsetof(mavlink_sensor_stats_t, status) }, \
+         { "name", NULL, MAVLINK_TYPE_CHAR, 8, 29, offsetof(mavlink_sensor_stats_t, name) }, \
+         } \
+}
+
+
+/**
+ * @brief Pack a sensor_stats message
+ * @param system_id ID of this system
+ * @param component_id ID of this component (e.g. 200 for IMU)
+ * @param msg The MAVLink message to compress the data into
+ *
+ * @param time_boot_ms Timestamp (milliseconds since system boot)
+ * @param interval_mean Mean interval between messages over about the last 16 intervals, excluding dropouts (microseconds).
+ * @param interval_max Longest interval between messages since boot or the last reset (microseconds).
+ * @param jitter Mean absolute difference between each interval and the mean interval, averaged like the mean (microseconds).
+ * @param since_last Time since the last message (milliseconds). UINT32_MAX if none has been received.
+ * @param samples Number of messages received since boot or the last reset.
+ * @param dropouts Number of intervals longer than twice the mean interval, where at least one message was missed, since boot or the last reset.
+ * @param sensor The sensor these statistics are for. 0: GPS, 1: IMU, 2: WSO100, 3: DST800, 4: power node, 5: ACS300, 6: rudder, 7: RC node, 8: gyro.
+ * @param count Total number of sensors.
+ * @param status 1 if the sensor is enabled, 3 if it's also active, 0 otherwise.
+ * @param name Name of the sensor, terminated by NULL if the length is less than 8 chars.
+ * @return length of the message in bytes (excluding serial stream start sign)
+ */
+static inline uint16_t mavlink_msg_sensor_stats_pack(uint8_t system_id, uint8_t component_id, mavlink_message_t* msg,
+						       uint32_t time_boot_ms, uint32_t interval_mean, uint32_t interval_max, uint32_t jitter, uint32_t since_last, uint32_t samples, uint16_t dropouts, uint8_t sensor, uint8_t count, uint8_t status, const char *name)
+{
+#if MAVLINK_NEED_BYTE_SWAP || !MAVLINK_ALIGNED_FIELDS
+	char buf[MAVLINK_MSG_ID_SENSOR_STATS_LEN];
+	_mav_put_uint32_t(buf, 0, time_boot_ms);
+	_mav_put_uint32_t(buf, 4, interval_mean);
+	_mav_put_uint32_t(buf, 8, interval_max);
+	_mav_put_uint32_t(buf, 12, jitter);
+	_mav_put_uint32_t(buf, 16, since_last);
+	_mav_put_uint32_t(buf, 20, samples);
+	_mav_put_uint16_t(buf, 24, dropouts);
+	_mav_put_uint8_t(buf, 26, sensor);
+	_mav_put_uint8_t(buf, 27, count);
+	_mav_put_uint8_t(buf, 28, status);
+	_mav_put_char_array(buf, 29, name, 8);
+        memcpy(_MAV_PAYLOAD_NON_CONST(msg), buf, MAVLINK_MSG_ID_SENSOR_STATS_LEN);
+#else
+	mavlink_sensor_stats_t packet;
+	packet.time_boot_ms = time_boot_ms;
+	packet.interval_mean = interval_mean;
+	packet.interval_max = interval_max;
+	packet.jitter = jitter;
+	packet.since_last = since_last;
+	packet.samples = samples;
+	packet.dropouts = dropouts;
+	packet.sensor = sensor;
+	packet.count = count;
+	packet.status = status;
+	mav_array_memcpy(packet.name, name, sizeof(char)*8);
+        memcpy(_MAV_PAYLOAD_NON_CONST(msg), &packet, MAVLINK_MSG_ID_SENSOR_STATS_LEN);
+#endif
+
+	msg->msgid = MAVLINK_MSG_ID_SENSOR_STATS;
+#if MAVLINK_CRC_EXTRA
+    return mavlink_finalize_message(msg, system_id, component_id, MAVLINK_MSG_ID_SENSOR_STATS_LEN, MAVLINK_MSG_ID_SENSOR_STATS_CRC);
+#else
+    return mavlink_finalize_message(msg, system_id, component_id, MAVLINK_MSG_ID_SENSOR_STATS_LEN);
+#endif
+}
+
+/**
+ * @brief Pack a sensor_stats message on a channel
+ * @param system_id ID of this system
+ * @param component_id ID of this component (e.g. 200 for IMU)
+ * @param chan The MAVLink channel this message will be sent over
+ * @param msg The MAVLink message to compress the data into
+ * @param time_boot_ms Timestamp (milliseconds since system boot)
+ * @param interval_mean Mean interval between messages over about the last 16 intervals, excluding dropouts (microseconds).
+ * @param interval_max Longest interval between messages since boot or the last reset (microseconds).
+ * @param jitter Mean absolute difference between each interval and the mean interval, averaged like the mean (microseconds).
+ * @param since_last Time since the last message (milliseconds). UINT32_MAX if none has been received.
+ * @param samples Number of messages received since boot or the last reset.
+ * @param dropouts Number of intervals longer than twice the mean interval, where at least one message was missed, since boot or the last reset.
+ * @param sensor The sensor these statistics are for. 0: GPS, 1: IMU, 2: WSO100, 3: DST800, 4: power node, 5: ACS300, 6: rudder, 7: RC node, 8: gyro.
+ * @param count Total number of sensors.
+ * @param status 1 if the sensor is enabled, 3 if it's also active, 0 otherwise.
+ * @param name Name of the sensor, terminated by NULL if the length is less than 8 chars.
+ * @return length of the message in bytes (excluding serial stream start sign)
+ */
+static inline uint16_t mavlink_msg_sensor_stats_pack_chan(uint8_t system_id, uint8_t component_id, uint8_t chan,
+							   mavlink_message_t* msg,
+						           uint32_t time_boot_ms,uint32_t interval_mean,uint32_t interval_max,uint32_t jitter,uint32_t since_last,uint32_t samples,uint16_t dropouts,uint8_t sensor,uint8_t count,uint8_t status,const char *name)
+{
+#if MAVLINK_NEED_BYTE_SWAP || !MAVLINK_ALIGNED_FIELDS
+	char buf[MAVLINK_MSG_ID_SENSOR_STATS_LEN];
+	_mav_put_uint32_t(buf, 0, time_boot_ms);
+	_mav_put_uint32_t(buf, 4, interval_mean);
+	_mav_put_uint32_t(buf, 8, interval_max);
+	_mav_put_uint32_t(buf, 12, jitter);
+	_mav_put_uint32_t(buf, 16, since_last);
+	_mav_put_uint32_t(buf, 20, samples);
+	_mav_put_uint16_t(buf, 24, dropouts);
+	_mav_put_uint8_t(buf, 26, sensor);
+	_mav_put_uint8_t(buf, 27, count);
+	_mav_put_uint8_t(buf, 28, status);
+	_mav_put_char_array(buf, 29, name, 8);
+        memcpy(_MAV_PAYLOAD_NON_CONST(msg), buf, MAVLINK_MSG_ID_SENSOR_STATS_LEN);
+#else
+	mavlink_sensor_stats_t packet;
+	packet.time_boot_ms = time_boot_ms;
+	packet.interval_mean = interval_mean;
+	packet.interval_max = interval_max;
+	packet.jitter = jitter;
+	packet.since_last = since_last;
+	packet.samples = samples;
+	packet.dropouts = dropouts;
+	packet.sensor = sensor;
+	packet.count = count;
+	packet.status = status;
+	mav_array_memcpy(packet.name, name, sizeof(char)*8);
+        memcpy(_MAV_PAYLOAD_NON_CONST(msg), &packet, MAVLINK_MSG_ID_SENSOR_STATS_LEN);
+#endif
+
+	msg->msgid = MAVLINK_MSG_ID_SENSOR_STATS;
+#if MAVLINK_CRC_EXTRA
+    return mavlink_finalize_message_chan(msg, system_id, component_id, chan, MAVLINK_MSG_ID_SENSOR_STATS_LEN, MAVLINK_MSG_ID_SENSOR_STATS_CRC);
+#else
+    return mavlink_finalize_message_chan(msg, system_id, component_id, chan, MAVLINK_MSG_ID_SENSOR_STATS_LEN);
+#endif
+}
+
+/**
+ * @brief Encode a sensor_stats struct
+ *
+ * @param system_id ID of this system
+ * @param component_id ID of this component (e.g. 200 for IMU)
+ * @param msg The MAVLink message to compress the data into
+ * @param sensor_stats C-struct to read the message contents from
+ */
+static inline uint16_t mavlink_msg_sensor_stats_encode(uint8_t system_id, uint8_t component_id, mavlink_message_t* msg, const mavlink_sensor_stats_t* sensor_stats)
+{
+	return mavlink_msg_sensor_stats_pack(system_id, component_id, msg, sensor_stats->time_boot_ms, sensor_stats->interval_mean, sensor_stats->interval_max, sensor_stats->jitter, sensor_stats->since_last, sensor_stats->samples, sensor_stats->dropouts, sensor_stats->sensor, sensor_stats->count, sensor_stats->status, sensor_stats->name);
+}
+
+/**
+ * @brief Encode a sensor_stats struct on a channel
+ *
+ * @param system_id ID of this system
+ * @param component_id ID of this component (e.g. 200 for IMU)
+ * @param chan The MAVLink channel this message will be sent over
+ * @param msg The MAVLink message to compress the data into
+ * @param sensor_stats C-struct to read the message contents from
+ */
+static inline uint16_t mavlink_msg_sensor_stats_encode_chan(uint8_t system_id, uint8_t component_id, uint8_t chan, mavlink_message_t* msg, const mavlink_sensor_stats_t* sensor_stats)
+{
+	return mavlink_msg_sensor_stats_pack_chan(system_id, component_id, chan, msg, sensor_stats->time_boot_ms, sensor_stats->interval_mean, sensor_stats->interval_max, sensor_stats->jitter, sensor_stats->since_last, sensor_stats->samples, sensor_stats->dropouts, sensor_stats->sensor, sensor_stats->count, sensor_stats->status, sensor_stats->name);
+}
+
+/**
+ * @brief Send a sensor_stats message
+ * @param chan MAVLink channel to send the message
+ *
+ * @param time_boot_ms Timestamp (milliseconds since system boot)
+ * @param interval_mean Mean interval between messages over about the last 16 intervals, excluding dropouts (microseconds).
+ * @param interval_max Longest interval between messages since boot or the last reset (microseconds).
+ * @param jitter Mean absolute difference between each interval and the mean interval, averaged like the mean (microseconds).
+ * @param since_last Time since the last message (milliseconds). UINT32_MAX if none has been received.
+ * @param samples Number of messages received since boot or the last reset.
+ * @param dropouts Number of intervals longer than twice the mean interval, where at least one message was missed, since boot or the last reset.
+ * @param sensor The sensor these statistics are for. 0: GPS, 1: IMU, 2: WSO100, 3: DST800, 4: power node, 5: ACS300, 6: rudder, 7: RC node, 8: gyro.
+ * @param count Total number of sensors.
+ * @param status 1 if the sensor is enabled, 3 if it's also active, 0 otherwise.
+ * @param name Name of the sensor, terminated by NULL if the length is less than 8 chars.
+ */
+#ifdef MAVLINK_USE_CONVENIENCE_FUNCTIONS
+
+static inline void mavlink_msg_sensor_stats_send(mavlink_channel_t chan, uint32_t time_boot_ms, uint32_t interval_mean, uint32_t interval_max, uint32_t jitter, uint32_t since_last, uint32_t samples, uint16_t dropouts, uint8_t sensor, uint8_t count, uint8_t status, const char *name)
+{
+#if MAVLINK_NEED_BYTE_SWAP || !MAVLINK_ALIGNED_FIELDS
+	char buf[MAVLINK_MSG_ID_SENSOR_STATS_LEN];
+	_mav_put_uint32_t(buf, 0, time_boot_ms);
+	_mav_put_uint32_t(buf, 4, interval_mean);
+	_mav_put_uint32_t(buf, 8, interval_max);
+	_mav_put_uint32_t(buf, 12, jitter);
+	_mav_put_uint32_t(buf, 16, since_last);
+	_mav_put_uint32_t(buf, 20, samples);
+	_mav_put_uint16_t(buf, 24, dropouts);
+	_mav_put_uint8_t(buf, 26, sensor);
+	_mav_put_uint8_t(buf, 27, count);
+	_mav_put_uint8_t(buf, 28, status);
+	_mav_put_char_array(buf, 29, name, 8);
+#if MAVLINK_CRC_EXTRA
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_SENSOR_STATS, buf, MAVLINK_MSG_ID_SENSOR_STATS_LEN, MAVLINK_MSG_ID_SENSOR_STATS_CRC);
+#else
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_SENSOR_STATS, buf, MAVLINK_MSG_ID_SENSOR_STATS_LEN);
+#endif
+#else
+	mavlink_sensor_stats_t packet;
+	packet.time_boot_ms = time_boot_ms;
+	packet.interval_mean = interval_mean;
+	packet.interval_max = interval_max;
+	packet.jitter = jitter;
+	packet.since_last = since_last;
+	packet.samples = samples;
+	packet.dropouts = dropouts;
+	packet.sensor = sensor;
+	packet.count = count;
+	packet.status = status;
+	mav_array_memcpy(packet.name, name, sizeof(char)*8);
+#if MAVLINK_CRC_EXTRA
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_SENSOR_STATS, (const char *)&packet, MAVLINK_MSG_ID_SENSOR_STATS_LEN, MAVLINK_MSG_ID_SENSOR_STATS_CRC);
+#else
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_SENSOR_STATS, (const char *)&packet, MAVLINK_MSG_ID_SENSOR_STATS_LEN);
+#endif
+#endif
+}
+
+#if MAVLINK_MSG_ID_SENSOR_STATS_LEN <= MAVLINK_MAX_PAYLOAD_LEN
+/*
+  This varient of _send() can be used to save stack space by re-using
+  memory from the receive buffer.  The caller provides a
+  mavlink_message_t which is the size of a full mavlink message. This
+  is usually the receive buffer for the channel, and allows a reply to an
+  incoming message with minimum stack space usage.
+ */
+static inline void mavlink_msg_sensor_stats_send_buf(mavlink_message_t *msgbuf, mavlink_channel_t chan,  uint32_t time_boot_ms, uint32_t interval_mean, uint32_t interval_max, uint32_t jitter, uint32_t since_last, uint32_t samples, uint16_t dropouts, uint8_t sensor, uint8_t count, uint8_t status, const char *name)
+{
+#if MAVLINK_NEED_BYTE_SWAP || !MAVLINK_ALIGNED_FIELDS
+	char *buf = (char *)msgbuf;
+	_mav_put_uint32_t(buf, 0, time_boot_ms);
+	_mav_put_uint32_t(buf, 4, interval_mean);
+	_mav_put_uint32_t(buf, 8, interval_max);
+	_mav_put_uint32_t(buf, 12, jitter);
+	_mav_put_uint32_t(buf, 16, since_last);
+	_mav_put_uint32_t(buf, 20, samples);
+	_mav_put_uint16_t(buf, 24, dropouts);
+	_mav_put_uint8_t(buf, 26, sensor);
+	_mav_put_uint8_t(buf, 27, count);
+	_mav_put_uint8_t(buf, 28, status);
+	_mav_put_char_array(buf, 29, name, 8);
+#if MAVLINK_CRC_EXTRA
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_SENSOR_STATS, buf, MAVLINK_MSG_ID_SENSOR_STATS_LEN, MAVLINK_MSG_ID_SENSOR_STATS_CRC);
+#else
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_SENSOR_STATS, buf, MAVLINK_MSG_ID_SENSOR_STATS_LEN);
+#endif
+#else
+	mavlink_sensor_stats_t *packet = (mavlink_sensor_stats_t *)msgbuf;
+	packet->time_boot_ms = time_boot_ms;
+	packet->interval_mean = interval_mean;
+	packet->interval_max = interval_max;
+	packet->jitter = jitter;
+	packet->since_last = since_last;
+	packet->samples = samples;
+	packet->dropouts = dropouts;
+	packet->sensor = sensor;
+	packet->count = count;
+	packet->status = status;
+	mav_array_memcpy(packet->name, name, sizeof(char)*8);
+#if MAVLINK_CRC_EXTRA
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_SENSOR_STATS, (const char *)packet, MAVLINK_MSG_ID_SENSOR_STATS_LEN, MAVLINK_MSG_ID_SENSOR_STATS_CRC);
+#else
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_SENSOR_STATS, (const char *)packet, MAVLINK_MSG_ID_SENSOR_STATS_LEN);
+#endif
+#endif
+}
+#endif
+
+#endif
+
+// MESSAGE SENSOR_STATS UNPACKING
+
+
+/**
+ * @brief Get field time_boot_ms from sensor_stats message
+ *
+ * @return Timestamp (milliseconds since system boot)
+ */
+static inline uint32_t mavlink_msg_sensor_stats_get_time_boot_ms(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint32_t(msg,  0);
+}
+
+/**
+ * @brief Get field interval_mean from sensor_stats message
+ *
+ * @return Mean interval between messages over about the last 16 intervals, excluding dropouts (microseconds).
+ */
+static inline uint32_t mavlink_msg_sensor_stats_get_interval_mean(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint32_t(msg,  4);
+}
+
+/**
+ * @brief Get field interval_max from sensor_stats message
+ *
+ * @return Longest interval between messages since boot or the last reset (microseconds).
+ */
+static inline uint32_t mavlink_msg_sensor_stats_get_interval_max(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint32_t(msg,  8);
+}
+
+/**
+ * @brief Get field jitter from sensor_stats message
+ *
+ * @return Mean absolute difference between each interval and the mean interval, averaged like the mean (microseconds).
+ */
+static inline uint32_t mavlink_msg_sensor_stats_get_jitter(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint32_t(msg,  12);
+}
+
+/**
+ * @brief Get field since_last from sensor_stats message
+ *
+ * @return Time since the last message (milliseconds). UINT32_MAX if none has been received.
+ */
+static inline uint32_t mavlink_msg_sensor_stats_get_since_last(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint32_t(msg,  16);
+}
+
+/**
+ * @brief Get field samples from sensor_stats message
+ *
+ * @return Number of messages received since boot or the last reset.
+ */
+static inline uint32_t mavlink_msg_sensor_stats_get_samples(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint32_t(msg,  20);
+}
+
+/**
+ * @brief Get field dropouts from sensor_stats message
+ *
+ * @return Number of intervals longer than twice the mean interval, where at least one message was missed, since boot or the last reset.
+ */
+static inline uint16_t mavlink_msg_sensor_stats_get_dropouts(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint16_t(msg,  24);
+}
+
+/**
+ * @brief Get field sensor from sensor_stats message
+ *
+ * @return The sensor these statistics are for. 0: GPS, 1: IMU, 2: WSO100, 3: DST800, 4: power node, 5: ACS300, 6: rudder, 7: RC node, 8: gyro.
+ */
+static inline uint8_t mavlink_msg_sensor_stats_get_sensor(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint8_t(msg,  26);
+}
+
+/**
+ * @brief Get field count from sensor_stats message
+ *
+ * @return Total number of sensors.
+ */
+static inline uint8_t mavlink_msg_sensor_stats_get_count(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint8_t(msg,  27);
+}
+
+/**
+ * @brief Get field status from sensor_stats message
+ *
+ * @return 1 if the sensor is enabled, 3 if it's also active, 0 otherwise.
+ */
+static inline uint8_t mavlink_msg_sensor_stats_get_status(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint8_t(msg,  28);
+}
+
+/**
+ * @brief Get field name from sensor_stats message
+ *
+ * @return Name of the sensor, terminated by NULL if the length is less than 8 chars.
+ */
+static inline uint16_t mavlink_msg_sensor_stats_get_name(const mavlink_message_t* msg, char *name)
+{
+	return _MAV_RETURN_char_array(msg, name, 8,  29);
+}
+
+/**
+ * @brief Decode a sensor_stats message into a struct
+ *
+ * @param msg The message to decode
+ * @param sensor_stats C-struct to decode the message contents into
+ */
+static inline void mavlink_msg_sensor_stats_decode(const mavlink_message_t* msg, mavlink_sensor_stats_t* sensor_stats)
+{
+#if MAVLINK_NEED_BYTE_SWAP
+	sensor_stats->time_boot_ms = mavlink_msg_sensor_stats_get_time_boot_ms(msg);
+	sensor_stats->interval_mean = mavlink_msg_sensor_stats_get_interval_mean(msg);
+	sensor_stats->interval_max = mavlink_msg_sensor_stats_get_interval_max(msg);
+	sensor_stats->jitter = mavlink_msg_sensor_stats_get_jitter(msg);
+	sensor_stats->since_last = mavlink_msg_sensor_stats_get_since_last(msg);
+	sensor_stats->samples = mavlink_msg_sensor_stats_get_samples(msg);
+	sensor_stats->dropouts = mavlink_msg_sensor_stats_get_dropouts(msg);
+	sensor_stats->sensor = mavlink_msg_sensor_stats_get_sensor(msg);
+	sensor_stats->count = mavlink_msg_sensor_stats_get_count(msg);
+	sensor_stats->status = mavlink_msg_sensor_stats_get_status(msg);
+	mavlink_msg_sensor_stats_get_name(msg, sensor_stats->name);
+#else
+	memcpy(sensor_stats, _MAV_PAYLOAD(msg), MAVLINK_MSG_ID_SENSOR_STATS_LEN);
+#endif
+}
@@ -0,0 +1,401 @@
+// MESSAGE TIMESYNC_STATUS PACKING
+
+#define MAVLINK_MSG_ID_TIMESYNC_STATUS 186
+
+typedef struct __mavlink_timesync_status_t
+{
+ uint64_t time_usec; ///< Timestamp (microseconds since system boot)
+ int64_t offset_ns; ///< Estimated remote clock minus the local clock at time_usec (nanoseconds).
+ uint64_t remote_usec; ///< Estimated remote clock at time_usec (microseconds), 0 if the estimate hasn't converged. For the datalogger this is its own time to line up the vehicle's messages with, as SYSTEM_TIME always carries GPS time.
+ float skew; ///< Estimated rate the offset changes at (parts per million).
+ uint32_t rtt; ///< Smoothed round trip time (microseconds).
+ uint32_t rejected; ///< Number of round trips rejected for being too slow since boot.
+ uint16_t samples; ///< Number of round trips used since the estimate was last reset.
+ uint8_t link; ///< The link these statistics are for. 0: groundstation, 1: datalogger.
+ uint8_t valid; ///< 1 if the estimate has converged, 0 otherwise.
+} mavlink_timesync_status_t;
+
+#define MAVLINK_MSG_ID_TIMESYNC_STATUS_LEN 40
+#define MAVLINK_MSG_ID_186_LEN 40
+
+#define MAVLINK_MSG_ID_TIMESYNC_STATUS_CRC 16
+#define MAVLINK_MSG_ID_186_CRC 16
+
+
+
+#define MAVLINK_MESSAGE_INFO_TIMESYNC_STATUS { \
+	"TIMESYNC_STATUS", \
+	9, \
+	{  { "time_usec", NULL, MAVLINK_TYPE_UINT64_T, 0, 0, offsetof(mavlink_timesync_status_t, time_usec) }, \
+         { "offset_ns", NULL, MAVLINK_TYPE_INT64_T, 0, 8, offsetof(mavlink_timesync_status_t, offset_ns) }, \
+         { "remote_usec", NULL, MAVLINK_TYPE_UINT64_T, 0, 16, offsetof(mavlink_timesync_status_t, remote_usec) }, \
+         { "skew", NULL, MAVLINK_TYPE_FLOAT, 0, 24, offsetof(mavlink_timesync_status_t, skew) }, \
+         { "rtt", NULL, MAVLINK_TYPE_UINT32_T, 0, 28, offsetof(mavlink_timesync_status_t, rtt) }, \
+         { "rejected", NULL, MAVLINK_TYPE_UINT32_T, 0, 32, offsetof(mavlink_timesync_status_t, rejected) }, \
+         { "samples", NULL, MAVLINK_TYPE_UINT16_T, 0, 36, offsetof(mavlink_timesync_status_t, samples) }, \
+         { "link", NULL, MAVLINK_TYPE_UINT8_T, 0, 38, offsetof(mavlink_timesync_status_t, link) }, \
+         { "valid", NULL, MAVLINK_TYPE_UINT8_T, 0, 39, offsetof(mavlink_timesync_status_t, valid) }, \
+         } \
+}
+
+
+/**
+ * @brief Pack a timesync_status message
+ * @param system_id ID of this system
+ * @param component_id ID of this component (e.g. 200 for IMU)
+ * @param msg The MAVLink message to compress the data into
+ *
+ * @param time_usec Timestamp (microseconds since system boot)
+ * @param offset_ns Estimated remote clock minus the local clock at time_usec (nanoseconds).
+ * @param remote_usec Estimated remote clock at time_usec (microseconds), 0 if the estimate hasn't converged. For the datalogger this is its own time to line up the vehicle's messages with, as SYSTEM_TIME always carries GPS time.
+ * @param skew Estimated rate the offset changes at (parts per million).
+ * @param rtt Smoothed round trip time (microseconds).
+ * @param rejected Number of round trips rejected for being too slow since boot.
+ * @param samples Number of round trips used since the estimate was last reset.
+ * @param link The link these statistics are for. 0: groundstation, 1: datalogger.
+ * @param valid 1 if the estimate has converged, 0 otherwise.
+ * @return length of the message in bytes (excluding serial stream start sign)
+ */
+static inline uint16_t mavlink_msg_timesync_status_pack(uint8_t system_id, uint8_t component_id, mavlink_message_t* msg,
+						       uint64_t time_usec, int64_t offset_ns, uint64_t remote_usec, float skew, uint32_t rtt, uint32_t rejected, uint16_t samples, uint8_t link, uint8_t valid)
+{
+#if MAVLINK_NEED_BYTE_SWAP || !MAVLINK_ALIGNED_FIELDS
+	char buf[MAVLINK_MSG_ID_TIMESYNC_STATUS_LEN];
+	_mav_put_uint64_t(buf, 0, time_usec);
+	_mav_put_int64_t(buf, 8, offset_ns);
+	_mav_put_uint64_t(buf, 16, remote_usec);
+	_mav_put_float(buf, 24, skew);
+	_mav_put_uint32_t(buf, 28, rtt);
+	_mav_put_uint32_t(buf, 32, rejected);
+	_mav_put_uint16_t(buf, 36, samples);
+	_mav_put_uint8_t(buf, 38, link);
+	_mav_put_uint8_t(buf, 39, valid);
+
+        memcpy(_MAV_PAYLOAD_NON_CONST(msg), buf, MAVLINK_MSG_ID_TIMESYNC_STATUS_LEN);
+#else
+	mavlink_timesync_status_t packet;
+	packet.time_usec = time_usec;
+	packet.offset_ns = offset_ns;
+	packet.remote_usec = remote_usec;
+	packet.skew = skew;
+	packet.rtt = rtt;
+	packet.rejected = rejected;
+	packet.samples = samples;
+	packet.link = link;
+	packet.valid = valid;
+
+        memcpy(_MAV_PAYLOAD_NON_CONST(msg), &packet, MAVLINK_MSG_ID_TIMESYNC_STATUS_LEN);
+#endif
+
+	msg->msgid = MAVLINK_MSG_ID_TIMESYNC_STATUS;
+#if MAVLINK_CRC_EXTRA
+    return mavlink_finalize_message(msg, system_id, component_id, MAVLINK_MSG_ID_TIMESYNC_STATUS_LEN, MAVLINK_MSG_ID_TIMESYNC_STATUS_CRC);
+#else
+    return mavlink_finalize_message(msg, system_id, component_id, MAVLINK_MSG_ID_TIMESYNC_STATUS_LEN);
+#endif
+}
+
+/**
+ * @brief Pack a timesync_status message on a channel
+ * @param system_id ID of this system
+ * @param component_id ID of this component (e.g. 200 for IMU)
+ * @param chan The MAVLink channel this message will be sent over
+ * @param msg The MAVLink message to compress the data into
+ * @param time_usec Timestamp (microseconds since system boot)
+ * @param offset_ns Estimated remote clock minus the local clock at time_usec (nanoseconds).
+ * @param remote_usec Estimated remote clock at time_usec (microseconds), 0 if the estimate hasn't converged. For the datalogger this is its own time to line up the vehicle's messages with, as SYSTEM_TIME always carries GPS time.
+ * @param skew Estimated rate the offset changes at (parts per million).
+ * @param rtt Smoothed round trip time (microseconds).
+ * @param rejected Number of round trips rejected for being too slow since boot.
+ * @param samples Number of round trips used since the estimate was last reset.
+ * @param link The link these statistics are for. 0: groundstation, 1: datalogger.
+ * @param valid 1 if the estimate has converged, 0 otherwise.
+ * @return length of the message in bytes (excluding serial stream start sign)
+ */
+static inline uint16_t mavlink_msg_timesync_status_pack_chan(uint8_t system_id, uint8_t component_id, uint8_t chan,
+							   mavlink_message_t* msg,
+						           uint64_t time_usec,int64_t offset_ns,uint64_t remote_usec,float skew,uint32_t rtt,uint32_t rejected,uint16_t samples,uint8_t link,uint8_t valid)
+{
+#if MAVLINK_NEED_BYTE_SWAP || !MAVLINK_ALIGNED_FIELDS
+	char buf[MAVLINK_MSG_ID_TIMESYNC_STATUS_LEN];
+	_mav_put_uint64_t(buf, 0, time_usec);
+	_mav_put_int64_t(buf, 8, offset_ns);
+	_mav_put_uint64_t(buf, 16, remote_usec);
+	_mav_put_float(buf, 24, skew);
+	_mav_put_uint32_t(buf, 28, rtt);
+	_mav_put_uint32_t(buf, 32, rejected);
+	_mav_put_uint16_t(buf, 36, samples);
+	_mav_put_uint8_t(buf, 38, link);
+	_mav_put_uint8_t(buf, 39, valid);
+
+        memcpy(_MAV_PAYLOAD_NON_CONST(msg), buf, MAVLINK_MSG_ID_TIMESYNC_STATUS_LEN);
+#else
+	mavlink_timesync_status_t packet;
+	packet.time_usec = time_usec;
+	packet.offset_ns = offset_ns;
+	packet.remote_usec = remote_usec;
+	packet.skew = skew;
+	packet.rtt = rtt;
+	packet.rejected = rejected;
+	packet.samples = samples;
+	packet.link = link;
+	packet.valid = valid;
+
+        memcpy(_MAV_PAYLOAD_NON_CONST(msg), &packet, MAVLINK_MSG_ID_TIMESYNC_STATUS_LEN);
+#endif
+
+	msg->msgid = MAVLINK_MSG_ID_TIMESYNC_STATUS;
+#if MAVLINK_CRC_EXTRA
+    return mavlink_finalize_message_chan(msg, system_id, component_id, chan, MAVLINK_MSG_ID_TIMESYNC_STATUS_LEN, MAVLINK_MSG_ID_TIMESYNC_STATUS_CRC);
+#else
+    return mavlink_finalize_message_chan(msg, system_id, component_id, chan, MAVLINK_MSG_ID_TIMESYNC_STATUS_LEN);
+#endif
+}
+
+/**
+ * @brief Encode a timesync_status struct
+ *
+ * @param system_id ID of this system
+ * @param component_id ID of this component (e.g. 200 for IMU)
+ * @param msg The MAVLink message to compress the data into
+ * @param timesync_status C-struct to read the message contents from
+ */
+static inline uint16_t mavlink_msg_timesync_status_encode(uint8_t system_id, uint8_t component_id, mavlink_message_t* msg, const mavlink_timesync_status_t* timesync_status)
+{
+	return mavlink_msg_timesync_status_pack(system_id, component_id, msg, timesync_status->time_usec, timesync_status->offset_ns, timesync_status->remote_usec, timesync_status->skew, timesync_status->rtt, timesync_status->rejected, timesync_status->samples, timesync_status->link, timesync_status->valid);
+}
+
+/**
+ * @brief Encode a timesync_status struct on a channel
+ *
+ * @param system_id ID of this system
+ * @param component_id ID of this component (e.g. 200 for IMU)
+ * @param chan The MAVLink channel this message will be sent over
+ * @param msg The MAVLink message to compress the data into
+ * @param timesync_status C-struct to read the message contents from
+ */
+static inline uint16_t mavlink_msg_timesync_status_encode_chan(uint8_t system_id, uint8_t component_id, uint8_t chan, mavlink_message_t* msg, const mavlink_timesync_status_t* timesync_status)
+{
+	return mavlink_msg_timesync_status_pack_chan(system_id, component_id, chan, msg, timesync_status->time_usec, timesync_status->offset_ns, timesync_status->remote_usec, timesync_status->skew, timesync_status->rtt, timesync_status->rejected, timesync_status->samples, timesync_status->link, timesync_status->valid);
+}
+
+/**
+ * @brief Send a timesync_status message
+ * @param chan MAVLink channel to send the message
+ *
+ * @param time_usec Timestamp (microseconds since system boot)
+ * @param offset_ns Estimated remote clock minus the local clock at time_usec (nanoseconds).
+ * @param remote_usec Estimated remote clock at time_usec (microseconds), 0 if the estimate hasn't converged. For the datalogger this is its own time to line up the vehicle's messages with, as SYSTEM_TIME always carries GPS time.
+ * @param skew Estimated rate the offset changes at (parts per million).
+ * @param rtt Smoothed round trip time (microseconds).
+ * @param rejected Number of round trips rejected for being too slow since boot.
+ * @param samples Number of round trips used since the estimate was last reset.
+ * @param link The link these statistics are for. 0: groundstation, 1: datalogger.
+ * @param valid 1 if the estimate has converged, 0 otherwise.
+ */
+#ifdef MAVLINK_USE_CONVENIENCE_FUNCTIONS
+
+static inline void mavlink_msg_timesync_status_send(mavlink_channel_t chan, uint64_t time_usec, int64_t offset_ns, uint64_t remote_usec, float skew, uint32_t rtt, uint32_t rejected, uint16_t samples, uint8_t link, uint8_t valid)
+{
+#if MAVLINK_NEED_BYTE_SWAP || !MAVLINK_ALIGNED_FIELDS
+	char buf[MAVLINK_MSG_ID_TIMESYNC_STATUS_LEN];
+	_mav_put_uint64_t(buf, 0, time_usec);
+	_mav_put_int64_t(buf, 8, offset_ns);
+	_mav_put_uint64_t(buf, 16, remote_usec);
+	_mav_put_float(buf, 24, skew);
+	_mav_put_uint32_t(buf, 28, rtt);
+	_mav_put_uint32_t(buf, 32, rejected);
+	_mav_put_uint16_t(buf, 36, samples);
+	_mav_put_uint8_t(buf, 38, link);
+	_mav_put_uint8_t(buf, 39, valid);
+
+#if MAVLINK_CRC_EXTRA
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_TIMESYNC_STATUS, buf, MAVLINK_MSG_ID_TIMESYNC_STATUS_LEN, MAVLINK_MSG_ID_TIMESYNC_STATUS_CRC);
+#else
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_TIMESYNC_STATUS, buf, MAVLINK_MSG_ID_TIMESYNC_STATUS_LEN);
+#endif
+#else
+	mavlink_timesync_status_t packet;
+	packet.time_usec = time_usec;
+	packet.offset_ns = offset_ns;
+	packet.remote_usec = remote_usec;
+	packet.skew = skew;
+	packet.rtt = rtt;
+	packet.rejected = rejected;
+	packet.samples = samples;
+	packet.link = link;
+	packet.valid = valid;
+
+#if MAVLINK_CRC_EXTRA
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_TIMESYNC_STATUS, (const char *)&packet, MAVLINK_MSG_ID_TIMESYNC_STATUS_LEN, MAVLINK_MSG_ID_TIMESYNC_STATUS_CRC);
+#else
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_TIMESYNC_STATUS, (const char *)&packet, MAVLINK_MSG_ID_TIMESYNC_STATUS_LEN);
+#endif
+#endif
+}
+
+#if MAVLINK_MSG_ID_TIMESYNC_STATUS_LEN <= MAVLINK_MAX_PAYLOAD_LEN
+/*
+  This varient of _send() can be used to save stack space by re-using
+  memory from the receive buffer.  The caller provides a
+  mavlink_message_t which is the size of a full mavlink message. This
+  is usually the receive buffer for the channel, and allows a reply to an
+  incoming message with minimum stack space usage.
+ */
+static inline void mavlink_msg_timesync_status_send_buf(mavlink_message_t *msgbuf, mavlink_channel_t chan,  uint64_t time_usec, int64_t offset_ns, uint64_t remote_usec, float skew, uint32_t rtt, uint32_t rejected, uint16_t samples, uint8_t link, uint8_t valid)
+{
+#if MAVLINK_NEED_BYTE_SWAP || !MAVLINK_ALIGNED_FIELDS
+	char *buf = (char *)msgbuf;
+	_mav_put_uint64_t(buf, 0, time_usec);
+	_mav_put_int64_t(buf, 8, offset_ns);
+	_mav_put_uint64_t(buf, 16, remote_usec);
+	_mav_put_float(buf, 24, skew);
+	_mav_put_uint32_t(buf, 28, rtt);
+	_mav_put_uint32_t(buf, 32, rejected);
+	_mav_put_uint16_t(buf, 36, samples);
+	_mav_put_uint8_t(buf, 38, link);
+	_mav_put_uint8_t(buf, 39, valid);
+
+#if MAVLINK_CRC_EXTRA
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_TIMESYNC_STATUS, buf, MAVLINK_MSG_ID_TIMESYNC_STATUS_LEN, MAVLINK_MSG_ID_TIMESYNC_STATUS_CRC);
+#else
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_TIMESYNC_STATUS, buf, MAVLINK_MSG_ID_TIMESYNC_STATUS_LEN);
+#endif
+#else
+	mavlink_timesync_status_t *packet = (mavlink_timesync_status_t *)msgbuf;
+	packet->time_usec = time_usec;
+	packet->offset_ns = offset_ns;
+	packet->remote_usec = remote_usec;
+	packet->skew = skew;
+	packet->rtt = rtt;
+	packet->rejected = rejected;
+	packet->samples = samples;
+	packet->link = link;
+	packet->valid = valid;
+
+#if MAVLINK_CRC_EXTRA
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_TIMESYNC_STATUS, (const char *)packet, MAVLINK_MSG_ID_TIMESYNC_STATUS_LEN, MAVLINK_MSG_ID_TIMESYNC_STATUS_CRC);
+#else
+    _mav_finalize_message_chan_send(chan, MAVLINK_MSG_ID_TIMESYNC_STATUS, (const char *)packet, MAVLINK_MSG_ID_TIMESYNC_STATUS_LEN);
+#endif
+#endif
+}
+#endif
+
+#endif
+
+// MESSAGE TIMESYNC_STATUS UNPACKING
+
+
+/**
+ * @brief Get field time_usec from timesync_status message
+ *
+ * @return Timestamp (microseconds since system boot)
+ */
+static inline uint64_t mavlink_msg_timesync_status_get_time_usec(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint64_t(msg,  0);
+}
+
+/**
+ * @brief Get field offset_ns from timesync_status message
+ *
+ * @return Estimated remote clock minus the local clock at time_usec (nanoseconds).
+ */
+static inline int64_t mavlink_msg_timesync_status_get_offset_ns(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_int64_t(msg,  8);
+}
+
+/**
+ * @brief Get field remote_usec from timesync_status message
+ *
+ * @return Estimated remote clock at time_usec (microseconds), 0 if the estimate hasn't converged. For the datalogger this is its own time to line up the vehicle's messages with, as SYSTEM_TIME always carries GPS time.
+ */
+static inline uint64_t mavlink_msg_timesync_status_get_remote_usec(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint64_t(msg,  16);
+}
+
+/**
+ * @brief Get field skew from timesync_status message
+ *
+ * @return Estimated rate the offset changes at (parts per million).
+ */
+static inline float mavlink_msg_timesync_status_get_skew(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_float(msg,  24);
+}
+
+/**
+ * @brief Get field rtt from timesync_status message
+ *
+ * @return Smoothed round trip time (microseconds).
+ */
+static inline uint32_t mavlink_msg_timesync_status_get_rtt(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint32_t(msg,  28);
+}
+
+/**
+ * @brief Get field rejected from timesync_status message
+ *
+ * @return Number of round trips rejected for being too slow since boot.
+ */
+static inline uint32_t mavlink_msg_timesync_status_get_rejected(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint32_t(msg,  32);
+}
+
+/**
+ * @brief Get field samples from timesync_status message
+ *
+ * @return Number of round trips used since the estimate was last reset.
+ */
+static inline uint16_t mavlink_msg_timesync_status_get_samples(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint16_t(msg,  36);
+}
+
+/**
+ * @brief Get field link from timesync_status message
+ *
+ * @return The link these statistics are for. 0: groundstation, 1: datalogger.
+ */
+static inline uint8_t mavlink_msg_timesync_status_get_link(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint8_t(msg,  38);
+}
+
+/**
+ * @brief Get field valid from timesync_status message
+ *
+ * @return 1 if the estimate has converged, 0 otherwise.
+ */
+static inline uint8_t mavlink_msg_timesync_status_get_valid(const mavlink_message_t* msg)
+{
+	return _MAV_RETURN_uint8_t(msg,  39);
+}
+
+/**
+ * @brief Decode a timesync_status message into a struct
+ *
+ * @param msg The message to decode
+ * @param timesync_status C-struct to decode the message contents into
+ */
+static inline void mavlink_msg_timesync_status_decode(const mavlink_message_t* msg, mavlink_timesync_status_t* timesync_status)
+{
+#if MAVLINK_NEED_BYTE_SWAP
+	timesync_status->time_usec = mavlink_msg_timesync_status_get_time_usec(msg);
+	timesync_status->offset_ns = mavlink_msg_timesync_status_get_offset_ns(msg);
+	timesync_status->remote_usec = mavlink_msg_timesync_status_get_remote_usec(msg);
+	timesync_status->skew = mavlink_msg_timesync_status_get_skew(msg);
+	timesync_status->rtt = mavlink_msg_timesync_status_get_rtt(msg);
+	timesync_status->rejected = mavlink_msg_timesync_status_get_rejected(msg);
+	timesync_status->samples = mavlink_msg_timesync_status_get_samples(msg);
+	timesync_status->link = mavlink_msg_timesync_status_get_link(msg);
+	timesync_status->valid = mavlink_msg_timesync_status_get_valid(msg);
+#else
+	memcpy(timesync_status, _MAV_PAYLOAD(msg), MAVLINK_MSG_ID_TIMESYNC_STATUS_LEN);
+#endif
+}
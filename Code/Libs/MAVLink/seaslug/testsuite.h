@@ -871,6 +871,328 @@ static void mavlink_test_param_value_with_time(uint8_t system_id, uint8_t compon
         MAVLINK_ASSERT(memcmp(&packet1, &packet2, sizeof(packet1)) == 0);
 }
 
+static void mavlink_test_message_stats(uint8_t system_id, uint8_t component_id, mavlink_message_t *last_msg)
+{
+	mavlink_message_t msg;
+        uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+        uint16_t i;
+	mavlink_message_stats_t packet_in = {
+		963497464,963497672,963497880,963498088,963498296,963498504,963498712,963498920,963499128,113,180,247
+    };
+	mavlink_message_stats_t packet1, packet2;
+        memset(&packet1, 0, sizeof(packet1));
+        	packet1.time_boot_ms = packet_in.time_boot_ms;
+        	packet1.rx_count = packet_in.rx_count;
+        	packet1.rx_bytes = packet_in.rx_bytes;
+        	packet1.gs_tx_count = packet_in.gs_tx_count;
+        	packet1.gs_tx_bytes = packet_in.gs_tx_bytes;
+        	packet1.dl_tx_count = packet_in.dl_tx_count;
+        	packet1.dl_tx_bytes = packet_in.dl_tx_bytes;
+        	packet1.gs_tx_dropped = packet_in.gs_tx_dropped;
+        	packet1.dl_tx_dropped = packet_in.dl_tx_dropped;
+        	packet1.msgid = packet_in.msgid;
+        	packet1.index = packet_in.index;
+        	packet1.count = packet_in.count;
+        
+        
+
+        memset(&packet2, 0, sizeof(packet2));
+	mavlink_msg_message_stats_encode(system_id, component_id, &msg, &packet1);
+	mavlink_msg_message_stats_decode(&msg, &packet2);
+        MAVLINK_ASSERT(memcmp(&packet1, &packet2, sizeof(packet1)) == 0);
+
+        memset(&packet2, 0, sizeof(packet2));
+	mavlink_msg_message_stats_pack(system_id, component_id, &msg , packet1.time_boot_ms , packet1.msgid , packet1.index , packet1.count , packet1.rx_count , packet1.rx_bytes , packet1.gs_tx_count , packet1.gs_tx_bytes , packet1.dl_tx_count , packet1.dl_tx_bytes , packet1.gs_tx_dropped , packet1.dl_tx_dropped );
+	mavlink_msg_message_stats_decode(&msg, &packet2);
+        MAVLINK_ASSERT(memcmp(&packet1, &packet2, sizeof(packet1)) == 0);
+
+        memset(&packet2, 0, sizeof(packet2));
+	mavlink_msg_message_stats_pack_chan(system_id, component_id, MAVLINK_COMM_0, &msg , packet1.time_boot_ms , packet1.msgid , packet1.index , packet1.count , packet1.rx_count , packet1.rx_bytes , packet1.gs_tx_count , packet1.gs_tx_bytes , packet1.dl_tx_count , packet1.dl_tx_bytes , packet1.gs_tx_dropped , packet1.dl_tx_dropped );
+	mavlink_msg_message_stats_decode(&msg, &packet2);
+        MAVLINK_ASSERT(memcmp(&packet1, &packet2, sizeof(packet1)) == 0);
+
+        memset(&packet2, 0, sizeof(packet2));
+        mavlink_msg_to_send_buffer(buffer, &msg);
+        for (i=0; i<mavlink_msg_get_send_buffer_length(&msg); i++) {
+        	comm_send_ch(MAVLINK_COMM_0, buffer[i]);
+        }
+	mavlink_msg_message_stats_decode(last_msg, &packet2);
+        MAVLINK_ASSERT(memcmp(&packet1, &packet2, sizeof(packet1)) == 0);
+        
+        memset(&packet2, 0, sizeof(packet2));
+	mavlink_msg_message_stats_send(MAVLINK_COMM_1 , packet1.time_boot_ms , packet1.msgid , packet1.index , packet1.count , packet1.rx_count , packet1.rx_bytes , packet1.gs_tx_count , packet1.gs_tx_bytes , packet1.dl_tx_count , packet1.dl_tx_bytes , packet1.gs_tx_dropped , packet1.dl_tx_dropped );
+	mavlink_msg_message_stats_decode(last_msg, &packet2);
+        MAVLINK_ASSERT(memcmp(&packet1, &packet2, sizeof(packet1)) == 0);
+}
+
+static void mavlink_test_link_stats(uint8_t system_id, uint8_t component_id, mavlink_message_t *last_msg)
+{
+	mavlink_message_t msg;
+        uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+        uint16_t i;
+	mavlink_link_stats_t packet_in = {
+		963497464,963497672,963497880,963498088,963498296,65,132,199,10
+    };
+	mavlink_link_stats_t packet1, packet2;
+        memset(&packet1, 0, sizeof(packet1));
+        	packet1.time_boot_ms = packet_in.time_boot_ms;
+        	packet1.received = packet_in.received;
+        	packet1.lost = packet_in.lost;
+        	packet1.parse_errors = packet_in.parse_errors;
+        	packet1.untracked = packet_in.untracked;
+        	packet1.channel = packet_in.channel;
+        	packet1.sysid = packet_in.sysid;
+        	packet1.index = packet_in.index;
+        	packet1.count = packet_in.count;
+        
+        
+
+        memset(&packet2, 0, sizeof(packet2));
+	mavlink_msg_link_stats_encode(system_id, component_id, &msg, &packet1);
+	mavlink_msg_link_stats_decode(&msg, &packet2);
+        MAVLINK_ASSERT(memcmp(&packet1, &packet2, sizeof(packet1)) == 0);
+
+        memset(&packet2, 0, sizeof(packet2));
+	mavlink_msg_link_stats_pack(system_id, component_id, &msg , packet1.time_boot_ms , packet1.channel , packet1.sysid , packet1.index , packet1.count , packet1.received , packet1.lost , packet1.parse_errors , packet1.untracked );
+	mavlink_msg_link_stats_decode(&msg, &packet2);
+        MAVLINK_ASSERT(memcmp(&packet1, &packet2, sizeof(packet1)) == 0);
+
+        memset(&packet2, 0, sizeof(packet2));
+	mavlink_msg_link_stats_pack_chan(system_id, component_id, MAVLINK_COMM_0, &msg , packet1.time_boot_ms , packet1.channel , packet1.sysid , packet1.index , packet1.count , packet1.received , packet1.lost , packet1.parse_errors , packet1.untracked );
+	mavlink_msg_link_stats_decode(&msg, &packet2);
+        MAVLINK_ASSERT(memcmp(&packet1, &packet2, sizeof(packet1)) == 0);
+
+        memset(&packet2, 0, sizeof(packet2));
+        mavlink_msg_to_send_buffer(buffer, &msg);
+        for (i=0; i<mavlink_msg_get_send_buffer_length(&msg); i++) {
+        	comm_send_ch(MAVLINK_COMM_0, buffer[i]);
+        }
+	mavlink_msg_link_stats_decode(last_msg, &packet2);
+        MAVLINK_ASSERT(memcmp(&packet1, &packet2, sizeof(packet1)) == 0);
+        
+        memset(&packet2, 0, sizeof(packet2));
+	mavlink_msg_link_stats_send(MAVLINK_COMM_1 , packet1.time_boot_ms , packet1.channel , packet1.sysid , packet1.index , packet1.count , packet1.received , packet1.lost , packet1.parse_errors , packet1.untracked );
+	mavlink_msg_link_stats_decode(last_msg, &packet2);
+        MAVLINK_ASSERT(memcmp(&packet1, &packet2, sizeof(packet1)) == 0);
+}
+
+static void mavlink_test_latency_stats(uint8_t system_id, uint8_t component_id, mavlink_message_t *last_msg)
+{
+	mavlink_message_t msg;
+        uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+        uint16_t i;
+	mavlink_latency_stats_t packet_in = {
+		963497464,963497672,963497880,963498088,963498296,963498504,77,144
+    };
+	mavlink_latency_stats_t packet1, packet2;
+        memset(&packet1, 0, sizeof(packet1));
+        	packet1.time_boot_ms = packet_in.time_boot_ms;
+        	packet1.p50 = packet_in.p50;
+        	packet1.p90 = packet_in.p90;
+        	packet1.p99 = packet_in.p99;
+        	packet1.max = packet_in.max;
+        	packet1.samples = packet_in.samples;
+        	packet1.stage = packet_in.stage;
+        	packet1.count = packet_in.count;
+        
+        
+
+        memset(&packet2, 0, sizeof(packet2));
+	mavlink_msg_latency_stats_encode(system_id, component_id, &msg, &packet1);
+	mavlink_msg_latency_stats_decode(&msg, &packet2);
+        MAVLINK_ASSERT(memcmp(&packet1, &packet2, sizeof(packet1)) == 0);
+
+        memset(&packet2, 0, sizeof(packet2));
+	mavlink_msg_latency_stats_pack(system_id, component_id, &msg , packet1.time_boot_ms , packet1.stage , packet1.count , packet1.p50 , packet1.p90 , packet1.p99 , packet1.max , packet1.samples );
+	mavlink_msg_latency_stats_decode(&msg, &packet2);
+        MAVLINK_ASSERT(memcmp(&packet1, &packet2, sizeof(packet1)) == 0);
+
+        memset(&packet2, 0, sizeof(packet2));
+	mavlink_msg_latency_stats_pack_chan(system_id, component_id, MAVLINK_COMM_0, &msg , packet1.time_boot_ms , packet1.stage , packet1.count , packet1.p50 , packet1.p90 , packet1.p99 , packet1.max , packet1.samples );
+	mavlink_msg_latency_stats_decode(&msg, &packet2);
+        MAVLINK_ASSERT(memcmp(&packet1, &packet2, sizeof(packet1)) == 0);
+
+        memset(&packet2, 0, sizeof(packet2));
+        mavlink_msg_to_send_buffer(buffer, &msg);
+        for (i=0; i<mavlink_msg_get_send_buffer_length(&msg); i++) {
+        	comm_send_ch(MAVLINK_COMM_0, buffer[i]);
+        }
+	mavlink_msg_latency_stats_decode(last_msg, &packet2);
+        MAVLINK_ASSERT(memcmp(&packet1, &packet2, sizeof(packet1)) == 0);
+        
+        memset(&packet2, 0, sizeof(packet2));
+	mavlink_msg_latency_stats_send(MAVLINK_COMM_1 , packet1.time_boot_ms , packet1.stage , packet1.count , packet1.p50 , packet1.p90 , packet1.p99 , packet1.max , packet1.samples );
+	mavlink_msg_latency_stats_decode(last_msg, &packet2);
+        MAVLINK_ASSERT(memcmp(&packet1, &packet2, sizeof(packet1)) == 0);
+}
+
+static void mavlink_test_timesync_status(uint8_t system_id, uint8_t component_id, mavlink_message_t *last_msg)
+{
+	mavlink_message_t msg;
+        uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+        uint16_t i;
+	mavlink_timesync_status_t packet_in = {
+		93372036854775807,93372036854776223,93372036854776639,185.0,963498920,963499128,19107,247,58
+    };
+	mavlink_timesync_status_t packet1, packet2;
+        memset(&packet1, 0, sizeof(packet1));
+        	packet1.time_usec = packet_in.time_usec;
+        	packet1.offset_ns = packet_in.offset_ns;
+        	packet1.remote_usec = packet_in.remote_usec;
+        	packet1.skew = packet_in.skew;
+        	packet1.rtt = packet_in.rtt;
+        	packet1.rejected = packet_in.rejected;
+        	packet1.samples = packet_in.samples;
+        	packet1.link = packet_in.link;
+        	packet1.valid = packet_in.valid;
+        
+        
+
+        memset(&packet2, 0, sizeof(packet2));
+	mavlink_msg_timesync_status_encode(system_id, component_id, &msg, &packet1);
+	mavlink_msg_timesync_status_decode(&msg, &packet2);
+        MAVLINK_ASSERT(memcmp(&packet1, &packet2, sizeof(packet1)) == 0);
+
+        memset(&packet2, 0, sizeof(packet2));
+	mavlink_msg_timesync_status_pack(system_id, component_id, &msg , packet1.time_usec , packet1.offset_ns , packet1.remote_usec , packet1.skew , packet1.rtt , packet1.rejected , packet1.samples , packet1.link , packet1.valid );
+	mavlink_msg_timesync_status_decode(&msg, &packet2);
+        MAVLINK_ASSERT(memcmp(&packet1, &packet2, sizeof(packet1)) == 0);
+
+        memset(&packet2, 0, sizeof(packet2));
+	mavlink_msg_timesync_status_pack_chan(system_id, component_id, MAVLINK_COMM_0, &msg , packet1.time_usec , packet1.offset_ns , packet1.remote_usec , packet1.skew , packet1.rtt , packet1.rejected , packet1.samples , packet1.link , packet1.valid );
+	mavlink_msg_timesync_status_decode(&msg, &packet2);
+        MAVLINK_ASSERT(memcmp(&packet1, &packet2, sizeof(packet1)) == 0);
+
+        memset(&packet2, 0, sizeof(packet2));
+        mavlink_msg_to_send_buffer(buffer, &msg);
+        for (i=0; i<mavlink_msg_get_send_buffer_length(&msg); i++) {
+        	comm_send_ch(MAVLINK_COMM_0, buffer[i]);
+        }
+	mavlink_msg_timesync_status_decode(last_msg, &packet2);
+        MAVLINK_ASSERT(memcmp(&packet1, &packet2, sizeof(packet1)) == 0);
+        
+        memset(&packet2, 0, sizeof(packet2));
+	mavlink_msg_timesync_status_send(MAVLINK_COMM_1 , packet1.time_usec , packet1.offset_ns , packet1.remote_usec , packet1.skew , packet1.rtt , packet1.rejected , packet1.samples , packet1.link , packet1.valid );
+	mavlink_msg_timesync_status_decode(last_msg, &packet2);
+        MAVLINK_ASSERT(memcmp(&packet1, &packet2, sizeof(packet1)) == 0);
+}
+
+static void mavlink_test_nav_summary(uint8_t system_id, uint8_t component_id, mavlink_message_t *last_msg)
+{
+	mavlink_message_t msg;
+        uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+        uint16_t i;
+	mavlink_nav_summary_t packet_in = {
+		963497464,963497672,963497880,17859,17963,18067,18171,18275,18379,18483,18587,18691,18795,18899,19003,19107,19211,19315,3,70,137
+    };
+	mavlink_nav_summary_t packet1, packet2;
+        memset(&packet1, 0, sizeof(packet1));
+        	packet1.time_boot_ms = packet_in.time_boot_ms;
+        	packet1.lat = packet_in.lat;
+        	packet1.lon = packet_in.lon;
+        	packet1.north = packet_in.north;
+        	packet1.east = packet_in.east;
+        	packet1.vel_north = packet_in.vel_north;
+        	packet1.vel_east = packet_in.vel_east;
+        	packet1.roll = packet_in.roll;
+        	packet1.pitch = packet_in.pitch;
+        	packet1.yaw = packet_in.yaw;
+        	packet1.yaw_rate = packet_in.yaw_rate;
+        	packet1.sog = packet_in.sog;
+        	packet1.cog = packet_in.cog;
+        	packet1.water_speed = packet_in.water_speed;
+        	packet1.rudder_angle = packet_in.rudder_angle;
+        	packet1.throttle = packet_in.throttle;
+        	packet1.status = packet_in.status;
+        	packet1.errors = packet_in.errors;
+        	packet1.waypoint = packet_in.waypoint;
+        	packet1.fix_type = packet_in.fix_type;
+        	packet1.satellites_visible = packet_in.satellites_visible;
+        
+        
+
+        memset(&packet2, 0, sizeof(packet2));
+	mavlink_msg_nav_summary_encode(system_id, component_id, &msg, &packet1);
+	mavlink_msg_nav_summary_decode(&msg, &packet2);
+        MAVLINK_ASSERT(memcmp(&packet1, &packet2, sizeof(packet1)) == 0);
+
+        memset(&packet2, 0, sizeof(packet2));
+	mavlink_msg_nav_summary_pack(system_id, component_id, &msg , packet1.time_boot_ms , packet1.lat , packet1.lon , packet1.north , packet1.east , packet1.vel_north , packet1.vel_east , packet1.roll , packet1.pitch , packet1.yaw , packet1.yaw_rate , packet1.sog , packet1.cog , packet1.water_speed , packet1.rudder_angle , packet1.throttle , packet1.status , packet1.errors , packet1.waypoint , packet1.fix_type , packet1.satellites_visible );
+	mavlink_msg_nav_summary_decode(&msg, &packet2);
+        MAVLINK_ASSERT(memcmp(&packet1, &packet2, sizeof(packet1)) == 0);
+
+        memset(&packet2, 0, sizeof(packet2));
+	mavlink_msg_nav_summary_pack_chan(system_id, component_id, MAVLINK_COMM_0, &msg , packet1.time_boot_ms , packet1.lat , packet1.lon , packet1.north , packet1.east , packet1.vel_north , packet1.vel_east , packet1.roll , packet1.pitch , packet1.yaw , packet1.yaw_rate , packet1.sog , packet1.cog , packet1.water_speed , packet1.rudder_angle , packet1.throttle , packet1.status , packet1.errors , packet1.waypoint , packet1.fix_type , packet1.satellites_visible );
+	mavlink_msg_nav_summary_decode(&msg, &packet2);
+        MAVLINK_ASSERT(memcmp(&packet1, &packet2, sizeof(packet1)) == 0);
+
+        memset(&packet2, 0, sizeof(packet2));
+        mavlink_msg_to_send_buffer(buffer, &msg);
+        for (i=0; i<mavlink_msg_get_send_buffer_length(&msg); i++) {
+        	comm_send_ch(MAVLINK_COMM_0, buffer[i]);
+        }
+	mavlink_msg_nav_summary_decode(last_msg, &packet2);
+        MAVLINK_ASSERT(memcmp(&packet1, &packet2, sizeof(packet1)) == 0);
+        
+        memset(&packet2, 0, sizeof(packet2));
+	mavlink_msg_nav_summary_send(MAVLINK_COMM_1 , packet1.time_boot_ms , packet1.lat , packet1.lon , packet1.north , packet1.east , packet1.vel_north , packet1.vel_east , packet1.roll , packet1.pitch , packet1.yaw , packet1.yaw_rate , packet1.sog , packet1.cog , packet1.water_speed , packet1.rudder_angle , packet1.throttle , packet1.status , packet1.errors , packet1.waypoint , packet1.fix_type , packet1.satellites_visible );
+	mavlink_msg_nav_summary_decode(last_msg, &packet2);
+        MAVLINK_ASSERT(memcmp(&packet1, &packet2, sizeof(packet1)) == 0);
+}
+
+static void mavlink_test_sensor_stats(uint8_t system_id, uint8_t component_id, mavlink_message_t *last_msg)
+{
+	mavlink_message_t msg;
+        uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+        uint16_t i;
+	mavlink_sensor_stats_t packet_in = {
+		963497464,963497672,963497880,963498088,963498296,963498504,18483,211,22,89,"DEFGHIJ"
+    };
+	mavlink_sensor_stats_t packet1, packet2;
+        memset(&packet1, 0, sizeof(packet1));
+        	packet1.time_boot_ms = packet_in.time_boot_ms;
+        	packet1.interval_mean = packet_in.interval_mean;
+        	packet1.interval_max = packet_in.interval_max;
+        	packet1.jitter = packet_in.jitter;
+        	packet1.since_last = packet_in.since_last;
+        	packet1.samples = packet_in.samples;
+        	packet1.dropouts = packet_in.dropouts;
+        	packet1.sensor = packet_in.sensor;
+        	packet1.count = packet_in.count;
+        	packet1.status = packet_in.status;
+        
+        	mav_array_memcpy(packet1.name, packet_in.name, sizeof(char)*8);
+        
+
+        memset(&packet2, 0, sizeof(packet2));
+	mavlink_msg_sensor_stats_encode(system_id, component_id, &msg, &packet1);
+	mavlink_msg_sensor_stats_decode(&msg, &packet2);
+        MAVLINK_ASSERT(memcmp(&packet1, &packet2, sizeof(packet1)) == 0);
+
+        memset(&packet2, 0, sizeof(packet2));
+	mavlink_msg_sensor_stats_pack(system_id, component_id, &msg , packet1.time_boot_ms , packet1.interval_mean , packet1.interval_max , packet1.jitter , packet1.since_last , packet1.samples , packet1.dropouts , packet1.sensor , packet1.count , packet1.status , packet1.name );
+	mavlink_msg_sensor_stats_decode(&msg, &packet2);
+        MAVLINK_ASSERT(memcmp(&packet1, &packet2, sizeof(packet1)) == 0);
+
+        memset(&packet2, 0, sizeof(packet2));
+	mavlink_msg_sensor_stats_pack_chan(system_id, component_id, MAVLINK_COMM_0, &msg , packet1.time_boot_ms , packet1.interval_mean , packet1.interval_max , packet1.jitter , packet1.since_last , packet1.samples , packet1.dropouts , packet1.sensor , packet1.count , packet1.status , packet1.name );
+	mavlink_msg_sensor_stats_decode(&msg, &packet2);
+        MAVLINK_ASSERT(memcmp(&packet1, &packet2, sizeof(packet1)) == 0);
+
+        memset(&packet2, 0, sizeof(packet2));
+        mavlink_msg_to_send_buffer(buffer, &msg);
+        for (i=0; i<mavlink_msg_get_send_buffer_length(&msg); i++) {
+        	comm_send_ch(MAVLINK_COMM_0, buffer[i]);
+        }
+	mavlink_msg_sensor_stats_decode(last_msg, &packet2);
+        MAVLINK_ASSERT(memcmp(&packet1, &packet2, sizeof(packet1)) == 0);
+        
+        memset(&packet2, 0, sizeof(packet2));
+	mavlink_msg_sensor_stats_send(MAVLINK_COMM_1 , packet1.time_boot_ms , packet1.interval_mean , packet1.interval_max , packet1.jitter , packet1.since_last , packet1.samples , packet1.dropouts , packet1.sensor , packet1.count , packet1.status , packet1.name );
+	mavlink_msg_sensor_stats_decode(last_msg, &packet2);
+        MAVLINK_ASSERT(memcmp(&packet1, &packet2, sizeof(packet1)) == 0);
+}
+
 static void mavlink_test_seaslug(uint8_t system_id, uint8_t component_id, mavlink_message_t *last_msg)
 {
 	mavlink_test_rudder_raw(system_id, component_id, last_msg);
@@ -889,6 +1211,12 @@ static void mavlink_test_seaslug(uint8_t system_id, uint8_t component_id, mavlin
 	mavlink_test_controller_data(system_id, component_id, last_msg);
 	mavlink_test_tokimec_with_time(system_id, component_id, last_msg);
 	mavlink_test_param_value_with_time(system_id, component_id, last_msg);
+	mavlink_test_message_stats(system_id, component_id, last_msg);
+	mavlink_test_link_stats(system_id, component_id, last_msg);
+	mavlink_test_latency_stats(system_id, component_id, last_msg);
+	mavlink_test_timesync_status(system_id, component_id, last_msg);
+	mavlink_test_nav_summary(system_id, component_id, last_msg);
+	mavlink_test_sensor_stats(system_id, component_id, last_msg);
 }
 
 #ifdef __cplusplus
@@ -9,49 +9,43 @@
 #include "Acs300.h"
 #include "Packing.h"
 #include "PrimaryNode.h"
+#include "Snapshot.h"
 
 #include <string.h>
 
+// For the SYS_STATUS sensor bits in sensorDescriptors.
+#include <mavlink.h>
+
 // Declare some macros for helping setting bit values
 #define ON  1
 #define OFF 0
 
 /**
- * Check the current values of the 'state' timeout counter for the given sensor and update the sensor's
- * state accordingly. This is merely a helper macro for SENSOR_STATE_UPDATE.
- * @param sensor Should be one of the available sensors in the sensor
- * @param state Should be either active or enabled.
+ * Restarts the timeout for the given sensor being active, as valid data was just received from it.
+ * @param sensor A SensorId.
  */
-#define SENSOR_STATE_UPDATE_STATE(sensor, state)                                                                   \
-    if (sensorAvailability.sensor.state) {\
-        if (sensorAvailability.sensor.state ## _counter < SENSOR_TIMEOUT) {        \
-            ++sensorAvailability.sensor.state ## _counter;\
-        } else {\
-            sensorAvailability.sensor.state = false;                                                                   \
-        }\
-    } else if (sensorAvailability.sensor.state ## _counter < SENSOR_TIMEOUT) { \
-        sensorAvailability.sensor.state = true;                                                                    \
-    }
+#define SENSOR_STATE_CLEAR_ACTIVE_COUNTER(sensor)                                      \
+    do {                                                                               \
+        sensorAvailability[sensor].active_counter = sensorDescriptors[sensor].timeout; \
+        sensorAvailability[sensor].last_active = nodeSystemTime;                       \
+    } while (0)
 
 /**
- * This macro update both the 'enabled' and 'active' state for a sensor
+ * Restarts the timeout for the given sensor being enabled, as a message was just received from it.
+ * @param sensor A SensorId.
  */
-#define SENSOR_STATE_UPDATE(sensor)                 \
-    do {                                            \
-        SENSOR_STATE_UPDATE_STATE(sensor, enabled); \
-        SENSOR_STATE_UPDATE_STATE(sensor, active);  \
-    } while (0)
-
-#define SENSOR_STATE_CLEAR_ACTIVE_COUNTER(sensor)               \
-    do {                                                        \
-        sensorAvailability.sensor.active_counter = 0;           \
-        sensorAvailability.sensor.last_active = nodeSystemTime; \
+#define SENSOR_STATE_CLEAR_ENABLED_COUNTER(sensor)                                      \
+    do {                                                                                \
+        sensorAvailability[sensor].enabled_counter = sensorDescriptors[sensor].timeout; \
     } while (0)
 
-#define SENSOR_STATE_CLEAR_ENABLED_COUNTER(sensor)     \
-    do {                                               \
-        sensorAvailability.sensor.enabled_counter = 0; \
-    } while (0)
+/**
+ * Records the arrival of the message used for the sensor's arrival statistics, which should be its
+ * most regular one. That's the one that marks the sensor as enabled, so it can be a heartbeat or a
+ * status message rather than one that marks it as active. Uses the CAN message `msg`.
+ * @param sensor A SensorId.
+ */
+#define SENSOR_STATE_ARRIVED(sensor) ArrivalStatsAdd(&sensorArrivals[sensor], msg.timestamp)
 
 struct PowerData powerDataStore = {0};
 SolarData solarDataStore = {UINT16_MAX, UINT16_MAX};
@@ -84,6 +78,8 @@ struct DateTimeData dateTimeDataStore = {// Initialize our system clock to clear
 };
 struct RevoGsData revoGsDataStore = {0};
 TokimecOutput tokimecDataStore = {};
+LatencyStamp tokimecLatency = {};
+LatencyStamp gpsLatency = {};
 struct NodeStatusData nodeStatusDataStore[NUM_NODES] = {
     {INT8_MAX, UINT8_MAX, UINT8_MAX, UINT16_MAX, UINT16_MAX},
     {INT8_MAX, UINT8_MAX, UINT8_MAX, UINT16_MAX, UINT16_MAX},
@@ -104,40 +100,112 @@ uint8_t nodeStatusTimeoutCounters[NUM_NODES] = {
 };
 struct GyroData gyroDataStore = {0};
 
-// At startup assume all sensors are disconnected.
-struct stc sensorAvailability = {
-    {1, SENSOR_TIMEOUT, 1, SENSOR_TIMEOUT, 0},
-    {1, SENSOR_TIMEOUT, 1, SENSOR_TIMEOUT, 0},
-    {1, SENSOR_TIMEOUT, 1, SENSOR_TIMEOUT, 0},
-    {1, SENSOR_TIMEOUT, 1, SENSOR_TIMEOUT, 0},
-    {1, SENSOR_TIMEOUT, 1, SENSOR_TIMEOUT, 0},
-    {1, SENSOR_TIMEOUT, 1, SENSOR_TIMEOUT, 0},
-    {1, SENSOR_TIMEOUT, 1, SENSOR_TIMEOUT, 0},
-    {1, SENSOR_TIMEOUT, 1, SENSOR_TIMEOUT, 0},
-    {1, SENSOR_TIMEOUT, 1, SENSOR_TIMEOUT, 0}
+// The yaw wraps around at 2pi radians. Pitch and roll are within +-pi/2 radians so they don't wrap.
+#define ATTITUDE_PERIOD 51472
+
+SensorHistory gpsHistory = SENSOR_HISTORY_INIT(2, 0, 0);
+SensorHistory attitudeHistory = SENSOR_HISTORY_INIT(3, ATTITUDE_PERIOD, 1);
+SensorHistory waterSpeedHistory = SENSOR_HISTORY_INIT(1, 0, 0);
+SensorHistory propSpeedHistory = SENSOR_HISTORY_INIT(1, 0, 0);
+
+// These flags are for use with the SYS_STATUS MAVLink message as a mapping from the Autoboat's
+// sensors to the sensors/controllers available in SYS_STATUS.
+enum ONBOARD_SENSORS {
+    ONBOARD_SENSORS_IMU = MAV_SYS_STATUS_SENSOR_3D_GYRO |
+                          MAV_SYS_STATUS_SENSOR_3D_ACCEL |
+                          MAV_SYS_STATUS_SENSOR_3D_MAG,
+    ONBOARD_SENSORS_WSO100 = MAV_SYS_STATUS_SENSOR_ABSOLUTE_PRESSURE,
+    ONBOARD_SENSORS_GPS = MAV_SYS_STATUS_SENSOR_GPS,
+    ONBOARD_CONTROL_RUDDER = MAV_SYS_STATUS_SENSOR_YAW_POSITION,
+    ONBOARD_CONTROL_MOTOR = MAV_SYS_STATUS_SENSOR_MOTOR_OUTPUTS | MAV_SYS_STATUS_SENSOR_XY_POSITION_CONTROL,
+    ONBOARD_CONTROL_RC = MAV_SYS_STATUS_SENSOR_RC_RECEIVER
+};
+
+// Describe every sensor, in the same order as SensorId. The DST800, power node, and gyro don't map
+// into the SYS_STATUS bitfields.
+const SensorDescriptor sensorDescriptors[SENSOR_COUNT] = {
+    {"GPS",     SENSOR_TIMEOUT, ONBOARD_SENSORS_GPS},
+    {"IMU",     SENSOR_TIMEOUT, ONBOARD_SENSORS_IMU},
+    {"WSO100",  SENSOR_TIMEOUT, ONBOARD_SENSORS_WSO100},
+    {"DST800",  SENSOR_TIMEOUT, 0},
+    {"Power",   SENSOR_TIMEOUT, 0},
+    {"Prop",    SENSOR_TIMEOUT, ONBOARD_CONTROL_MOTOR},
+    {"Rudder",  SENSOR_TIMEOUT, ONBOARD_CONTROL_RUDDER},
+    {"RC node", SENSOR_TIMEOUT, ONBOARD_CONTROL_RC},
+    {"Gyro",    SENSOR_TIMEOUT, 0}
 };
 
+// At startup assume all sensors are disconnected, which is all counters having run out.
+timeoutCounters sensorAvailability[SENSOR_COUNT];
+SensorStatus sensorStatus;
+ArrivalStats sensorArrivals[SENSOR_COUNT];
+
 uint8_t dcSourceStatusBytes[PGN_SIZE_DC_SOURCE_STATUS];
 Nmea2000FastPacket dsSourceStatusPacket = {0, 0, 0, 0, dcSourceStatusBytes, sizeof(dcSourceStatusBytes)};
 uint8_t gnssPositionDataBytes[PGN_SIZE_GNSS_POSITION_DATA];
 Nmea2000FastPacket gnssPositionDataPacket = {0, 0, 0, 0, gnssPositionDataBytes, sizeof(gnssPositionDataBytes)};
 
+// The data stores as last published for the controller, see PublishDataStores().
+static GpsData gpsSnapshotBuffers[2];
+static Snapshot gpsSnapshot = SNAPSHOT_INIT(gpsSnapshotBuffers);
+static TokimecOutput tokimecSnapshotBuffers[2];
+static Snapshot tokimecSnapshot = SNAPSHOT_INIT(tokimecSnapshotBuffers);
+static struct WaterData waterSnapshotBuffers[2];
+static Snapshot waterSnapshot = SNAPSHOT_INIT(waterSnapshotBuffers);
+static struct ThrottleData throttleSnapshotBuffers[2];
+static Snapshot throttleSnapshot = SNAPSHOT_INIT(throttleSnapshotBuffers);
+
+// The sequence number of the last GPS snapshot taken by GetGpsData(). Once the GPS data's been
+// taken, its newData flags are cleared for the next one.
+static volatile uint16_t gpsSnapshotTaken;
+
+/**
+ * Publishes the data stores the controller reads as whole records, so the controller never sees
+ * one that's half-updated by a CAN message.
+ */
+static void PublishDataStores(void)
+{
+    SnapshotPublish(&gpsSnapshot, &gpsDataStore);
+    SnapshotPublish(&tokimecSnapshot, &tokimecDataStore);
+    SnapshotPublish(&waterSnapshot, &waterDataStore);
+    SnapshotPublish(&throttleSnapshot, &throttleDataStore);
+}
+
 float GetWaterSpeed(void)
 {
-    waterDataStore.newData = false;
-    return waterDataStore.speed;
+    struct WaterData water;
+    SnapshotRead(&waterSnapshot, &water);
+    return water.speed;
 }
 
 float GetPropSpeed(void)
 {
-    throttleDataStore.newData = false;
-    return throttleDataStore.rpm;
+    struct ThrottleData throttle;
+    SnapshotRead(&throttleSnapshot, &throttle);
+    return throttle.rpm;
 }
 
 void GetGpsData(GpsData *data)
 {
-    *data = gpsDataStore;
-    gpsDataStore.newData = GPSDATA_NONE;
+    // The flags of a snapshot that was already taken have been reported.
+    const uint16_t sequence = SnapshotRead(&gpsSnapshot, data);
+    if (sequence == gpsSnapshotTaken) {
+        data->newData = GPSDATA_NONE;
+    }
+    gpsSnapshotTaken = sequence;
+}
+
+void GetTokimecData(TokimecOutput *data)
+{
+    SnapshotRead(&tokimecSnapshot, data);
+}
+
+void ResetSensorArrivals(void)
+{
+    int i;
+    for (i = 0; i < SENSOR_COUNT; ++i) {
+        ArrivalStatsInit(&sensorArrivals[i]);
+    }
 }
 
 void ClearGpsData(void)
@@ -148,10 +216,20 @@ void ClearGpsData(void)
     gpsDataStore.cog = 0;
     gpsDataStore.sog = 0;
     gpsDataStore.newData = 0;
+    SnapshotPublish(&gpsSnapshot, &gpsDataStore);
 }
 
 uint8_t ProcessAllEcanMessages(void)
 {
+    static bool published = false;
+
+    // Start collecting new GPS flags once the last ones have been taken by the controller. If it
+    // takes the GPS data while this is running, it may see the same flags twice, but never misses
+    // one.
+    if (gpsSnapshotTaken == SnapshotSequence(&gpsSnapshot)) {
+        gpsDataStore.newData = GPSDATA_NONE;
+    }
+
     uint8_t messagesLeft = 0;
     CanMessage msg;
     uint32_t pgn;
@@ -164,12 +242,15 @@ uint8_t ProcessAllEcanMessages(void)
             // Process non-NMEA2000 messages here. They're distinguished by having standard frames.
             if (msg.frame_type == CAN_FRAME_STD) {
                 if (msg.id == ACS300_CAN_ID_HRTBT) { // From the ACS300
-                    SENSOR_STATE_CLEAR_ENABLED_COUNTER(prop);
+                    SENSOR_STATE_CLEAR_ENABLED_COUNTER(SENSOR_PROP);
+                    SENSOR_STATE_ARRIVED(SENSOR_PROP);
                     if ((msg.payload[6] & 0x40) == 0) { // Checks the status bit to determine if the ACS300 is enabled.
-                        SENSOR_STATE_CLEAR_ACTIVE_COUNTER(prop);
+                        SENSOR_STATE_CLEAR_ACTIVE_COUNTER(SENSOR_PROP);
                     }
                     Acs300DecodeHeartbeat(msg.payload, (uint16_t*)&throttleDataStore.rpm, NULL, NULL, NULL);
                     throttleDataStore.newData = true;
+                    const int32_t rpm = throttleDataStore.rpm;
+                    SensorHistoryAdd(&propSpeedHistory, msg.timestamp, &rpm);
                 } else if (msg.id == ACS300_CAN_ID_WR_PARAM) {
                     // Track the current velocity from the secondary controller.
                     uint16_t address;
@@ -204,25 +285,27 @@ uint8_t ProcessAllEcanMessages(void)
                         // availability.
                         switch (node) {
                             case CAN_NODE_RC:
-                                SENSOR_STATE_CLEAR_ENABLED_COUNTER(rcNode);
+                                SENSOR_STATE_CLEAR_ENABLED_COUNTER(SENSOR_RC_NODE);
+                                SENSOR_STATE_ARRIVED(SENSOR_RC_NODE);
                                 // Only if the RC transmitter is connected and in override mode
                                 // should the RC node be considered active.
                                 if (status & 0x01) {
-                                    SENSOR_STATE_CLEAR_ACTIVE_COUNTER(rcNode);
+                                    SENSOR_STATE_CLEAR_ACTIVE_COUNTER(SENSOR_RC_NODE);
                                 }
                             break;
                             case CAN_NODE_RUDDER_CONTROLLER:
-                                SENSOR_STATE_CLEAR_ENABLED_COUNTER(rudder);
+                                SENSOR_STATE_CLEAR_ENABLED_COUNTER(SENSOR_RUDDER);
                                 // As long as the sensor is done calibrating and hasn't errored out,
                                 // it's active too.
                                 if ((status & 0x01) && !(status & 0x02) && !errors) {
-                                    SENSOR_STATE_CLEAR_ACTIVE_COUNTER(rudder);
+                                    SENSOR_STATE_CLEAR_ACTIVE_COUNTER(SENSOR_RUDDER);
                                 }
                             break;
                         }
                     }
                 } else if (msg.id == CAN_MSG_ID_RUDDER_DETAILS) {
-                    SENSOR_STATE_CLEAR_ENABLED_COUNTER(rudder);
+                    SENSOR_STATE_CLEAR_ENABLED_COUNTER(SENSOR_RUDDER);
+                    SENSOR_STATE_ARRIVED(SENSOR_RUDDER);
                     CanMessageDecodeRudderDetails(&msg,
                             &rudderSensorData.RudderPotValue,
                             &rudderSensorData.RudderPotLimitStarboard,
@@ -235,44 +318,50 @@ uint8_t ProcessAllEcanMessages(void)
                     if (rudderSensorData.Enabled &&
                             rudderSensorData.Calibrated &&
                             !rudderSensorData.Calibrating) {
-                        SENSOR_STATE_CLEAR_ACTIVE_COUNTER(rudder);
+                        SENSOR_STATE_CLEAR_ACTIVE_COUNTER(SENSOR_RUDDER);
                     }
                 } else if (msg.id == CAN_MSG_ID_IMU_DATA) {
-                    SENSOR_STATE_CLEAR_ENABLED_COUNTER(imu);
-                    SENSOR_STATE_CLEAR_ACTIVE_COUNTER(imu);
+                    SENSOR_STATE_CLEAR_ENABLED_COUNTER(SENSOR_IMU);
+                    SENSOR_STATE_ARRIVED(SENSOR_IMU);
+                    SENSOR_STATE_CLEAR_ACTIVE_COUNTER(SENSOR_IMU);
                     CanMessageDecodeImuData(&msg,
                             &tokimecDataStore.yaw,
                             &tokimecDataStore.pitch,
                             &tokimecDataStore.roll);
+                    LatencyDecoded(&tokimecLatency, msg.timestamp, PrimaryNodeGetTimestamp());
+                    const int32_t attitude[3] = {
+                        tokimecDataStore.yaw, tokimecDataStore.pitch, tokimecDataStore.roll
+                    };
+                    SensorHistoryAdd(&attitudeHistory, msg.timestamp, attitude);
                 } else if (msg.id == CAN_MSG_ID_ANG_VEL_DATA) {
-                    SENSOR_STATE_CLEAR_ENABLED_COUNTER(imu);
-                    SENSOR_STATE_CLEAR_ACTIVE_COUNTER(imu);
+                    SENSOR_STATE_CLEAR_ENABLED_COUNTER(SENSOR_IMU);
+                    SENSOR_STATE_CLEAR_ACTIVE_COUNTER(SENSOR_IMU);
                     CanMessageDecodeAngularVelocityData(&msg,
                             &tokimecDataStore.x_angle_vel,
                             &tokimecDataStore.y_angle_vel,
                             &tokimecDataStore.z_angle_vel);
                 } else if (msg.id == CAN_MSG_ID_ACCEL_DATA) {
-                    SENSOR_STATE_CLEAR_ENABLED_COUNTER(imu);
-                    SENSOR_STATE_CLEAR_ACTIVE_COUNTER(imu);
+                    SENSOR_STATE_CLEAR_ENABLED_COUNTER(SENSOR_IMU);
+                    SENSOR_STATE_CLEAR_ACTIVE_COUNTER(SENSOR_IMU);
                     CanMessageDecodeAccelerationData(&msg,
                             &tokimecDataStore.x_accel,
                             &tokimecDataStore.y_accel,
                             &tokimecDataStore.z_accel);
                 } else if (msg.id == CAN_MSG_ID_GPS_POS_DATA) {
-                    SENSOR_STATE_CLEAR_ENABLED_COUNTER(imu);
-                    SENSOR_STATE_CLEAR_ACTIVE_COUNTER(imu);
+                    SENSOR_STATE_CLEAR_ENABLED_COUNTER(SENSOR_IMU);
+                    SENSOR_STATE_CLEAR_ACTIVE_COUNTER(SENSOR_IMU);
                     CanMessageDecodeGpsPosData(&msg,
                             &tokimecDataStore.latitude,
                             &tokimecDataStore.longitude);
                 } else if (msg.id == CAN_MSG_ID_GPS_EST_POS_DATA) {
-                    SENSOR_STATE_CLEAR_ENABLED_COUNTER(imu);
-                    SENSOR_STATE_CLEAR_ACTIVE_COUNTER(imu);
+                    SENSOR_STATE_CLEAR_ENABLED_COUNTER(SENSOR_IMU);
+                    SENSOR_STATE_CLEAR_ACTIVE_COUNTER(SENSOR_IMU);
                     CanMessageDecodeGpsPosData(&msg,
                             &tokimecDataStore.est_latitude,
                             &tokimecDataStore.est_longitude);
                 } else if (msg.id == CAN_MSG_ID_GPS_VEL_DATA) {
-                    SENSOR_STATE_CLEAR_ENABLED_COUNTER(imu);
-                    SENSOR_STATE_CLEAR_ACTIVE_COUNTER(imu);
+                    SENSOR_STATE_CLEAR_ENABLED_COUNTER(SENSOR_IMU);
+                    SENSOR_STATE_CLEAR_ACTIVE_COUNTER(SENSOR_IMU);
                     CanMessageDecodeGpsVelData(&msg,
                             &tokimecDataStore.gpsDirection,
                             &tokimecDataStore.gpsSpeed,
@@ -284,11 +373,11 @@ uint8_t ProcessAllEcanMessages(void)
                 switch (pgn) {
                 case PGN_ID_SYSTEM_TIME:
                 { // From GPS
-                    SENSOR_STATE_CLEAR_ENABLED_COUNTER(gps);
+                    SENSOR_STATE_CLEAR_ENABLED_COUNTER(SENSOR_GPS);
                     uint8_t rv = ParsePgn126992(msg.payload, NULL, NULL, &dateTimeDataStore.year, &dateTimeDataStore.month, &dateTimeDataStore.day, &dateTimeDataStore.hour, &dateTimeDataStore.min, &dateTimeDataStore.sec, &dateTimeDataStore.usecSinceEpoch);
                     // Check if all 6 parts of the datetime were successfully decoded before triggering an update
                     if ((rv & 0xFC) == 0xFC) {
-                        SENSOR_STATE_CLEAR_ACTIVE_COUNTER(gps);
+                        SENSOR_STATE_CLEAR_ACTIVE_COUNTER(SENSOR_GPS);
                         dateTimeDataStore.newData = true;
                     }
                 }
@@ -303,34 +392,38 @@ uint8_t ProcessAllEcanMessages(void)
                                                 &rudderSensorData.RudderAngle);
                     // If a valid rudder angle was received, the rudder node is enabled.
                     if ((rv & 0x08)) {
-                        SENSOR_STATE_CLEAR_ENABLED_COUNTER(rudder);
+                        SENSOR_STATE_CLEAR_ENABLED_COUNTER(SENSOR_RUDDER);
                     }
                 }
                 break;
                 case PGN_ID_BATTERY_STATUS:
                 { // From the Power Node
-                    SENSOR_STATE_CLEAR_ENABLED_COUNTER(power);
+                    SENSOR_STATE_CLEAR_ENABLED_COUNTER(SENSOR_POWER);
+                    SENSOR_STATE_ARRIVED(SENSOR_POWER);
                     uint8_t rv = ParsePgn127508(msg.payload, NULL, NULL, &powerDataStore.voltage, &powerDataStore.current, &powerDataStore.temperature);
                     if ((rv & 0x0C) == 0xC) {
-                        SENSOR_STATE_CLEAR_ACTIVE_COUNTER(power);
+                        SENSOR_STATE_CLEAR_ACTIVE_COUNTER(SENSOR_POWER);
                         powerDataStore.newData = true;
                     }
                 }
                 break;
                 case PGN_ID_SPEED: // From the DST800
-                    SENSOR_STATE_CLEAR_ENABLED_COUNTER(dst800);
+                    SENSOR_STATE_CLEAR_ENABLED_COUNTER(SENSOR_DST800);
+                    SENSOR_STATE_ARRIVED(SENSOR_DST800);
                     if (ParsePgn128259(msg.payload, NULL, &waterDataStore.speed)) {
-                        SENSOR_STATE_CLEAR_ACTIVE_COUNTER(dst800);
+                        SENSOR_STATE_CLEAR_ACTIVE_COUNTER(SENSOR_DST800);
                         waterDataStore.newData = true;
+                        const int32_t speed = (int32_t)(waterDataStore.speed * 1000.0f);
+                        SensorHistoryAdd(&waterSpeedHistory, msg.timestamp, &speed);
                     }
                     break;
                 case PGN_ID_WATER_DEPTH:
                 { // From the DST800
-                    SENSOR_STATE_CLEAR_ENABLED_COUNTER(dst800);
+                    SENSOR_STATE_CLEAR_ENABLED_COUNTER(SENSOR_DST800);
                     // Only update the data in waterDataStore if an actual depth was returned.
                     uint8_t rv = ParsePgn128267(msg.payload, NULL, &waterDataStore.depth, NULL);
                     if ((rv & 0x02) == 0x02) {
-                        SENSOR_STATE_CLEAR_ACTIVE_COUNTER(dst800);
+                        SENSOR_STATE_CLEAR_ACTIVE_COUNTER(SENSOR_DST800);
                         waterDataStore.newData = true;
                     }
                 }
@@ -338,7 +431,8 @@ uint8_t ProcessAllEcanMessages(void)
                 case PGN_ID_POSITION_RAP_UPD:
                 { // From the GPS200
                     // Keep the GPS enabled
-                    SENSOR_STATE_CLEAR_ENABLED_COUNTER(gps);
+                    SENSOR_STATE_CLEAR_ENABLED_COUNTER(SENSOR_GPS);
+                    SENSOR_STATE_ARRIVED(SENSOR_GPS);
 
                     // Decode the position
                     int32_t lat, lon;
@@ -358,17 +452,20 @@ uint8_t ProcessAllEcanMessages(void)
                         gpsDataStore.newData |= GPSDATA_POSITION;
 
                         // Since we've received good data, keep the GPS active
-                        SENSOR_STATE_CLEAR_ACTIVE_COUNTER(gps);
+                        SENSOR_STATE_CLEAR_ACTIVE_COUNTER(SENSOR_GPS);
 
                         // Finally copy the new data into the GPS struct
                         gpsDataStore.latitude = lat;
                         gpsDataStore.longitude = lon;
+                        LatencyDecoded(&gpsLatency, msg.timestamp, PrimaryNodeGetTimestamp());
+                        const int32_t position[2] = {lat, lon};
+                        SensorHistoryAdd(&gpsHistory, msg.timestamp, position);
                     }
                 }
                 break;
                 case PGN_ID_COG_SOG_RAP_UPD:
                 { // From the GPS200
-                    SENSOR_STATE_CLEAR_ENABLED_COUNTER(gps);
+                    SENSOR_STATE_CLEAR_ENABLED_COUNTER(SENSOR_GPS);
                     uint16_t cog, sog;
                     uint8_t rv = ParsePgn129026(msg.payload, NULL, NULL, &cog, &sog);
 
@@ -380,7 +477,7 @@ uint8_t ProcessAllEcanMessages(void)
                         gpsDataStore.newData |= GPSDATA_VELOCITY;
 
                         // Since we've received good data, keep the GPS active
-                        SENSOR_STATE_CLEAR_ACTIVE_COUNTER(gps);
+                        SENSOR_STATE_CLEAR_ACTIVE_COUNTER(SENSOR_GPS);
 
                         // Finally copy the new data into the GPS struct
                         gpsDataStore.cog = cog;
@@ -390,7 +487,7 @@ uint8_t ProcessAllEcanMessages(void)
                 break;
                 case PGN_ID_GNSS_DOPS:
                 { // From the GPS200
-                    SENSOR_STATE_CLEAR_ENABLED_COUNTER(gps);
+                    SENSOR_STATE_CLEAR_ENABLED_COUNTER(SENSOR_GPS);
                     uint8_t rv = ParsePgn129539(msg.payload, NULL, NULL, &gpsDataStore.mode, &gpsDataStore.hdop, &gpsDataStore.vdop, NULL);
 
                     // If there was valid data in the mode and hdop/vdop fields,
@@ -399,28 +496,29 @@ uint8_t ProcessAllEcanMessages(void)
                         gpsDataStore.newData |= GPSDATA_DOP;
 
                         // Since we've received good data, keep the GPS active
-                        SENSOR_STATE_CLEAR_ACTIVE_COUNTER(gps);
+                        SENSOR_STATE_CLEAR_ACTIVE_COUNTER(SENSOR_GPS);
                     }
                 }
                 break;
                 case PGN_ID_WIND_DATA: // From the WSO100
-                    SENSOR_STATE_CLEAR_ENABLED_COUNTER(wso100);
+                    SENSOR_STATE_CLEAR_ENABLED_COUNTER(SENSOR_WSO100);
+                    SENSOR_STATE_ARRIVED(SENSOR_WSO100);
                     if (ParsePgn130306(msg.payload, NULL, &windDataStore.speed, &windDataStore.direction)) {
-                        SENSOR_STATE_CLEAR_ACTIVE_COUNTER(wso100);
+                        SENSOR_STATE_CLEAR_ACTIVE_COUNTER(SENSOR_WSO100);
                         windDataStore.newData = true;
                     }
                     break;
                 case PGN_ID_ENV_PARAMETERS: // From the DST800
-                    SENSOR_STATE_CLEAR_ENABLED_COUNTER(dst800);
+                    SENSOR_STATE_CLEAR_ENABLED_COUNTER(SENSOR_DST800);
                     if (ParsePgn130310(msg.payload, NULL, &waterDataStore.temp, NULL, NULL)) {
                         // The DST800 is only considered active when a water depth is received
                         waterDataStore.newData = true;
                     }
                     break;
                 case PGN_ID_ENV_PARAMETERS2: // From the WSO100
-                    SENSOR_STATE_CLEAR_ENABLED_COUNTER(wso100);
+                    SENSOR_STATE_CLEAR_ENABLED_COUNTER(SENSOR_WSO100);
                     if (ParsePgn130311(msg.payload, NULL, NULL, NULL, &airDataStore.temp, &airDataStore.humidity, &airDataStore.pressure)) {
-                        SENSOR_STATE_CLEAR_ACTIVE_COUNTER(wso100);
+                        SENSOR_STATE_CLEAR_ACTIVE_COUNTER(SENSOR_WSO100);
                         airDataStore.newData = true;
                     }
                     break;
@@ -457,6 +555,13 @@ uint8_t ProcessAllEcanMessages(void)
         }
     } while (messagesLeft > 0);
 
+    // Publish the data stores if anything changed, and always the first time so the controller
+    // starts with their initial values.
+    if (messagesHandled || !published) {
+        PublishDataStores();
+        published = true;
+    }
+
     return messagesHandled;
 }
 
@@ -489,16 +594,24 @@ void UpdateSensorsAvailability(void)
     }
 
     // Now update the '.enabled' or '.active' status for every sensor. We keep timeout counters that
-    // timeout a sensor after SENSOR_TIMEOUT amount of time, which depends on how often this function
-    // is called.
-    SENSOR_STATE_UPDATE(gps);
-    SENSOR_STATE_UPDATE(imu);
-    SENSOR_STATE_UPDATE(wso100);
-    SENSOR_STATE_UPDATE(dst800);
-    SENSOR_STATE_UPDATE(power);
-    SENSOR_STATE_UPDATE(prop);
-    SENSOR_STATE_UPDATE(rudder);
-    SENSOR_STATE_UPDATE(rcNode);
-    SENSOR_STATE_UPDATE(gyro);
-    SENSOR_STATE_UPDATE(gps);
+    // count down from the sensor's timeout, which depends on how often this function is called, and
+    // combine the results into the SYS_STATUS bitfields as we go.
+    SensorStatus status = {0, 0, 0};
+    for (i = 0; i < SENSOR_COUNT; ++i) {
+        timeoutCounters *s = &sensorAvailability[i];
+        if (s->enabled_counter > 0) {
+            --s->enabled_counter;
+        }
+        if (s->active_counter > 0) {
+            --s->active_counter;
+        }
+        s->enabled = s->enabled_counter > 0;
+        s->active = s->active_counter > 0;
+
+        const uint32_t bits = sensorDescriptors[i].statusBits;
+        status.present |= bits;
+        status.enabled |= s->enabled ? bits : 0;
+        status.active |= s->active ? bits : 0;
+    }
+    sensorStatus = status;
 }
@@ -7,6 +7,9 @@
 #include "Types.h"
 #include "Node.h"
 #include "Tokimec.h"
+#include "Latency.h"
+#include "SensorHistory.h"
+#include "ArrivalStats.h"
 
 // Store data from the Rudder Node.
 struct RudderCanData  {
@@ -76,6 +79,18 @@ extern struct RevoGsData revoGsDataStore;
 
 // Store data from the Tokimec VSAS-2GM
 extern TokimecOutput tokimecDataStore;
+// Track the latency of the attitude in tokimecDataStore.
+extern LatencyStamp tokimecLatency;
+
+/**
+ * The recent samples of the sensors the controller uses, timestamped with the time their CAN
+ * message was received by PrimaryNodeGetTimestamp()'s clock. Look values up at any time with
+ * SensorHistoryAt(), like to align them to the controller's timestep. See SensorHistory.h.
+ */
+extern SensorHistory gpsHistory;        // The latitude and longitude in 1e-7 degrees, for every new fix.
+extern SensorHistory attitudeHistory;   // The Tokimec's yaw, pitch, and roll in 1/8192 radians.
+extern SensorHistory waterSpeedHistory; // The DST800's water speed in mm/s.
+extern SensorHistory propSpeedHistory;  // The ACS300's prop speed in rpm.
 
 // Store data from the DSP-3000 z-axis gyro.
 struct GyroData {
@@ -137,6 +152,8 @@ typedef struct {
         uint8_t satellites; // Number of satellites used in solution.
 } GpsData;
 extern GpsData gpsDataStore;
+// Track the latency of the position in gpsDataStore.
+extern LatencyStamp gpsLatency;
 
 struct DateTimeData {
 	uint16_t year;
@@ -150,60 +167,121 @@ struct DateTimeData {
 };
 extern struct DateTimeData dateTimeDataStore;
 
+// Set the default timeout period for sensors (in units of the call rate of
+// `UpdateSensorsAvailability`). This is set to a littler longer than 1s to be more forgiving for
+// sensors that only transmit at 1Hz. Timeouts can be at most 127.
+#define SENSOR_TIMEOUT 125
+
+/**
+ * The sensors and actuators whose availability is tracked, indexing `sensorAvailability` and
+ * `sensorDescriptors`. Adding one only takes a new ID here and its row in `sensorDescriptors`.
+ */
+typedef enum {
+	SENSOR_GPS = 0, // GPS is enabled when any CAN messages have been received within the last second, active when enabled and the lat/lon are valid within the last second.
+	SENSOR_IMU,     // The IMU is enabled when any messages have been received within the last second, active whenever it's enabled.
+	SENSOR_WSO100,  // The WSO100 is enabled when any messages have been received within the last second, active whenever it's enabled.
+	SENSOR_DST800,  // The DST800 is enabled when any messages have been received within the last second, active whenever depth is valid within the last second (this should only be true when it's in the water)
+	SENSOR_POWER,   // The power node is enabled when a messages has been received within the last second and active at the same time.
+	SENSOR_PROP,    // The ACS300 outputs CAN messages quite frequently. It's enabled whenever one of these messages has been received within the last second and active when it's enabled and in run mode within the last second.
+	SENSOR_RUDDER,  // The rudder controller outputs messages quite frequently also. It's enabled whenever one of these messages has been received within the last second. It's active when it's enabled and calibrated and done calibrating.
+	SENSOR_RC_NODE, // The RC CAN node that provides override manual control.
+	SENSOR_GYRO,    // The gyro is enabled and active whenever messages are received
+	SENSOR_COUNT
+} SensorId;
+
+/**
+ * Describes a sensor. These are constant, the changing state is in `timeoutCounters`.
+ */
+typedef struct {
+	const char *name;    // A short name for messages, like "GPS".
+	uint8_t timeout;     // How long until the sensor times out, see SENSOR_TIMEOUT.
+	uint32_t statusBits; // The MAV_SYS_STATUS_SENSOR bits for the sensor in SYS_STATUS, 0 if it doesn't map into them.
+} SensorDescriptor;
+
+extern const SensorDescriptor sensorDescriptors[SENSOR_COUNT];
+
 typedef struct {
 	bool enabled            : 1; // If the sensor is enabled, i.e. it is online and transmitting messages.
-	uint8_t enabled_counter : 7; // The timeout counter for this sensor being enabled.
+	uint8_t enabled_counter : 7; // The timeout counter for this sensor being enabled, counting down to 0.
 	bool active             : 1; // If the sensor is active, i.e. receiving valid data.
-	uint8_t active_counter  : 7; // The timeout counter for this sensor being active.
+	uint8_t active_counter  : 7; // The timeout counter for this sensor being active, counting down to 0.
         uint32_t last_active;        // Track the last time the sensor was active in .01s. @see nodeSystemTime
 } timeoutCounters;
 
-extern struct stc {
-	timeoutCounters gps; // GPS is enabled when any CAN messages have been received within the last second, active when enabled and the lat/lon are valid within the last second.
-	timeoutCounters imu; // The IMU is enabled when any messages have been received within the last second, active whenever it's enabled.
-	timeoutCounters wso100; // The WSO100 is enabled when any messages have been received within the last second, active whenever it's enabled.
-	timeoutCounters dst800; // The DST800 is enabled when any messages have been received within the last second, active whenever depth is valid within the last second (this should only be true when it's in the water)
-	timeoutCounters power; // The power node is enabled when a messages has been received within the last second and active at the same time.
-	timeoutCounters prop; // The ACS300 outputs CAN messages quite frequently. It's enabled whenever one of these messages has been received within the last second and active when it's enabled and in run mode within the last second.
-	timeoutCounters rudder; // The rudder controller outputs messages quite frequently also. It's enabled whenever one of these messages has been received within the last second. It's active when it's enabled and calibrated and done calibrating.
-	timeoutCounters rcNode; // The RC CAN node that provides override manual control.
-        timeoutCounters gyro; // The gyro is enabled and active whenever messages are received
-} sensorAvailability;
-
-// Set the timeout period for sensors (in units of the call rate of `UpdateSensorsAvailability`)
-// This is set to a littler longer than 1s to be more forgiving for sensors that only transmit at
-// 1Hz.
-#define SENSOR_TIMEOUT 125
+/**
+ * The availability of every sensor, indexed by SensorId. At startup all sensors are assumed to be
+ * disconnected.
+ */
+extern timeoutCounters sensorAvailability[SENSOR_COUNT];
+
+/**
+ * The availability of all sensors combined into the SYS_STATUS bitfields, as of the last
+ * UpdateSensorsAvailability().
+ */
+typedef struct {
+	uint32_t present; // The bits for all sensors.
+	uint32_t enabled; // The bits for the enabled sensors.
+	uint32_t active;  // The bits for the active sensors.
+} SensorStatus;
+extern SensorStatus sensorStatus;
+
+/**
+ * The statistics of the time between messages from every sensor, indexed by SensorId. Every
+ * sensor's most regular message that marks it as enabled is timestamped on CAN reception, like the
+ * ACS300 heartbeat, the RC node status, or the WSO100 wind data, so a device that starts missing
+ * messages or a congested bus shows up as jitter and dropouts well before the sensor times out.
+ * These are sent whether or not the sensor is active. Sensors without a CAN message of their
+ * own, like the gyro, have no arrivals. See ArrivalStats.h.
+ */
+extern ArrivalStats sensorArrivals[SENSOR_COUNT];
 
 /**
- * Returns the water speed of the vessel in m/s. Also clears the newData member variable.
+ * Returns the water speed of the vessel in m/s, as last published by ProcessAllEcanMessages().
  */
 float GetWaterSpeed(void);
 
 /**
- * Returns the rotation speed of the prop in rpm. Also clears the newData member variable.
+ * Returns the rotation speed of the prop in rpm, as last published by ProcessAllEcanMessages().
  */
 float GetPropSpeed(void);
 
 /**
- * Returns the current GPS data. Also clears the newData member variable.
+ * Returns the GPS data as last published by ProcessAllEcanMessages(). The newData flags are set
+ * for data received since the GPS data was last taken, and clear when nothing was published since.
  * @param[out] data A struct to copy the data into
  */
 void GetGpsData(GpsData *data);
 
 /**
-  * Clears the GPS data struct.
+ * Returns the Tokimec data as last published by ProcessAllEcanMessages().
+ * @param[out] data A struct to copy the data into
+ */
+void GetTokimecData(TokimecOutput *data);
+
+/**
+ * Clears the arrival statistics of every sensor.
+ */
+void ResetSensorArrivals(void);
+
+/**
+  * Clears the GPS data struct. Must be called from the same context as ProcessAllEcanMessages().
   */
 void ClearGpsData(void);
 
 /**
  * This function should be called every timestep to process any received ECAN messages.
+ *
+ * The data stores above are updated field by field as messages are decoded, so they're only
+ * consistent for code running in the same context as this function, like the MAVLink telemetry.
+ * After processing, the GPS, Tokimec, water, and throttle data are published as whole records
+ * that the Get*() functions above copy out consistently from any context, even if this function is
+ * moved into an ISR. See Snapshot.h.
  */
 uint8_t ProcessAllEcanMessages(void);
 
 /**
  * This function updates the sensor availability. This all ends up being reflected in the
- * 'sensorAvailability' struct. It's used by ProcessAllEcanMessages(). Ideally this function should
+ * 'sensorAvailability' array and 'sensorStatus'. It's used by ProcessAllEcanMessages(). Ideally this function should
  * only be used where sensor data is received.
  */
 void UpdateSensorsAvailability(void);
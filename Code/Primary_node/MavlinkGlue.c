@@ -34,6 +34,10 @@
 #include "PrimaryNode.h"
 #include "Parameters.h"
 #include "DataStore.h"
+#include "FlashLog.h"
+#include "MavlinkStats.h"
+#include "TimeSync.h"
+#include "LinkUsage.h"
 
 // MATLAB-generated code is included here, really only required for the declaration of the
 // InternalVariables struct.
@@ -41,6 +45,7 @@
 
 // Declare our internal variable data store for some miscellaneous data output over MAVLink.
 InternalVariables controllerVars;
+LatencyStamp controllerGpsLatency;
 
 // Store a single txMessage copy here. This is shared by all of the Send*() functions in this file
 // to reduce stack usage. Note that since all Send*() functions use this shared memory, NONE of them
@@ -133,19 +138,6 @@ enum MISSION_EVENT {
 	MISSION_EVENT_ITEM_RECEIVED
 };
 
-// These flags are for use with the SYS_STATUS MAVLink message as a mapping from the Autoboat's
-// sensors to the sensors/controllers available in SYS_STATUS.
-enum ONBOARD_SENSORS {
-    ONBOARD_SENSORS_IMU = MAV_SYS_STATUS_SENSOR_3D_GYRO |
-                          MAV_SYS_STATUS_SENSOR_3D_ACCEL |
-                          MAV_SYS_STATUS_SENSOR_3D_MAG,
-    ONBOARD_SENSORS_WSO100 = MAV_SYS_STATUS_SENSOR_ABSOLUTE_PRESSURE,
-    ONBOARD_SENSORS_GPS = MAV_SYS_STATUS_SENSOR_GPS,
-    ONBOARD_CONTROL_RUDDER = MAV_SYS_STATUS_SENSOR_YAW_POSITION,
-    ONBOARD_CONTROL_MOTOR = MAV_SYS_STATUS_SENSOR_MOTOR_OUTPUTS | MAV_SYS_STATUS_SENSOR_XY_POSITION_CONTROL,
-    ONBOARD_CONTROL_RC = MAV_SYS_STATUS_SENSOR_RC_RECEIVER
-};
-
 typedef struct {
     uint8_t sysid;
     uint8_t compid;
@@ -203,12 +195,6 @@ static uint8_t missionTimeoutCounter = 0;
 // altitude (1e6 meters). 
 extern int32_t gpsOrigin[3];
 
-// Track how well MAVLink decoding is going.
-// WARN: Possible overflow over long-enough duration, but this is the size of these variables in
-// the MAVLink code.
-static uint16_t mavLinkMessagesReceived = 0;
-static uint16_t mavLinkMessagesFailedParsing = 0;
-
 // Store radio telemetry information from the 3DRs.
 static mavlink_radio_status_t radioStatus;
 
@@ -224,13 +210,30 @@ static struct {
 // the Node.h library.
 static uint32_t gcsLastTimeSeen = UINT32_MAX;
 
-// Store how saturated each channel is as a percentage [0..100].
-// Can be retrieved with the MavLinkGetChannelUsage(..) function.
+// Store how saturated each channel is scheduled to be as a percentage [0..100]. This is what
+// MavLinkGetChannelUsage(..) returns until the actual usage has been measured.
 static uint8_t dataloggerChanUsage = 0;
 static uint8_t groundstationChanUsage = 0;
 
+// The bytes/s each channel can carry. While we're connecting to the groundstation at 115200, we
+// expect the airspeed of the radios to be 64kbps. Additionally, ECC should be turned on, so that
+// halves that data rate. The datalogger gets all of 115200 baud.
+#define GROUNDSTATION_BYTES_PER_SECOND (64000 / 10 / 2)
+
+// The share of the groundstation link's bandwidth that the scheduled messages and log downloads
+// may use, in percent. The rest is left for transient messages like missions, parameters, or
+// waypoint/state changes.
+#define GROUNDSTATION_MAX_USAGE 80
+#define DATALOGGER_BYTES_PER_SECOND (115200 / 10)
+
+// The bytes/s both UARTs can transmit at 115200 baud.
+#define UART_BYTES_PER_SECOND (115200 / 10)
+
+// The measured throughput of both UARTs, sampled every time their messages are transmitted at 100Hz.
+static LinkUsage linkUsage[2];
+
 // Set up the message scheduler for MAVLink transmission to the groundstation
-#define GROUNDSTATION_SCHEDULE_NUM_MSGS 18
+#define GROUNDSTATION_SCHEDULE_NUM_MSGS 20
 static uint8_t groundstationMavlinkScheduleIds[GROUNDSTATION_SCHEDULE_NUM_MSGS] = {
 	MAVLINK_MSG_ID_HEARTBEAT,
 	MAVLINK_MSG_ID_SYS_STATUS,
@@ -249,7 +252,9 @@ static uint8_t groundstationMavlinkScheduleIds[GROUNDSTATION_SCHEDULE_NUM_MSGS]
 	MAVLINK_MSG_ID_TOKIMEC,
 	MAVLINK_MSG_ID_RADIO_STATUS,
 	MAVLINK_MSG_ID_VFR_HUD,
-	MAVLINK_MSG_ID_NAV_CONTROLLER_OUTPUT
+	MAVLINK_MSG_ID_NAV_CONTROLLER_OUTPUT,
+	MAVLINK_MSG_ID_TIMESYNC,
+	MAVLINK_MSG_ID_NAV_SUMMARY
 };
 static uint16_t groundstationMavlinkScheduleTSteps[GROUNDSTATION_SCHEDULE_NUM_MSGS][2][8] = {};
 static uint8_t  groundstationMavlinkScheduleSizes[GROUNDSTATION_SCHEDULE_NUM_MSGS];
@@ -261,11 +266,16 @@ static MessageSchedule groundstationMavlinkSchedule = {
 	groundstationMavlinkScheduleTSteps
 };
 
+// The groundstation messages are rescheduled whenever the mode changes, but only once MavLinkInit()
+// has set up the schedule.
+static uint8_t groundstationMode = MAVLINK_GCS_MODE_FULL;
+static bool groundstationScheduleReady = false;
+
 // Specify how many times each parameter should be transmit to the datalogger for reference.
 #define DATALOGGER_PARAM_TRANSMIT_COUNT 2
 
 // Set up the message scheduler for MAVLink transmission to the datalogger
-#define DATALOGGER_SCHEDULE_NUM_MSGS 9
+#define DATALOGGER_SCHEDULE_NUM_MSGS 15
 static uint8_t dataloggerMavlinkScheduleIds[DATALOGGER_SCHEDULE_NUM_MSGS] = {
 	MAVLINK_MSG_ID_HEARTBEAT,
 	MAVLINK_MSG_ID_SYS_STATUS,
@@ -275,7 +285,13 @@ static uint8_t dataloggerMavlinkScheduleIds[DATALOGGER_SCHEDULE_NUM_MSGS] = {
     MAVLINK_MSG_ID_PARAM_VALUE_WITH_TIME,
     MAVLINK_MSG_ID_SYSTEM_TIME,
     MAVLINK_MSG_ID_GPS_RAW_INT,
-    MAVLINK_MSG_ID_MAIN_POWER
+    MAVLINK_MSG_ID_MAIN_POWER,
+    MAVLINK_MSG_ID_MESSAGE_STATS,
+    MAVLINK_MSG_ID_LINK_STATS,
+    MAVLINK_MSG_ID_LATENCY_STATS,
+    MAVLINK_MSG_ID_TIMESYNC,
+    MAVLINK_MSG_ID_TIMESYNC_STATUS,
+    MAVLINK_MSG_ID_SENSOR_STATS
 };
 static uint16_t dataloggerMavlinkScheduleTSteps[DATALOGGER_SCHEDULE_NUM_MSGS][2][8] = {};
 static uint8_t  dataloggerMavlinkScheduleSizes[DATALOGGER_SCHEDULE_NUM_MSGS];
@@ -287,6 +303,69 @@ static MessageSchedule dataloggerMavlinkSchedule = {
 	dataloggerMavlinkScheduleTSteps
 };
 
+// The onboard flash log only holds a summary of the datalogger's stream: the messages below, each
+// stored at most once every period, in timesteps. Events like STATUSTEXT and parameter values are
+// stored every time. Together that's ~50B/s, so the log holds ~3 minutes of data on the 33F and
+// ~11 on the 33E, and a sector is erased every 20-40s. The full stream would fill the log within
+// seconds and wear it out within a day.
+#define FLASH_LOG_NUM_MSGS 8
+static const uint8_t flashLogMessageIds[FLASH_LOG_NUM_MSGS] = {
+    MAVLINK_MSG_ID_HEARTBEAT,
+    MAVLINK_MSG_ID_SYS_STATUS,
+    MAVLINK_MSG_ID_SYSTEM_TIME,
+    MAVLINK_MSG_ID_MAIN_POWER,
+    MAVLINK_MSG_ID_GPS_RAW_INT,
+    MAVLINK_MSG_ID_CONTROLLER_DATA,
+    MAVLINK_MSG_ID_STATUSTEXT,
+    MAVLINK_MSG_ID_PARAM_VALUE_WITH_TIME
+};
+static const uint16_t flashLogPeriods[FLASH_LOG_NUM_MSGS] = {1000, 1000, 1000, 1000, 500, 300, 0, 0};
+static uint32_t flashLogNextStore[FLASH_LOG_NUM_MSGS];
+
+// Track the state of the log download protocol (LOG_REQUEST_LIST/LOG_REQUEST_DATA). Only one
+// list or data transfer is active at a time, a new request replaces the current one.
+static struct {
+    bool listActive;
+    uint8_t listIndex;    // The next log to check for sending a LOG_ENTRY for.
+    uint16_t listStart;
+    uint16_t listEnd;
+
+    bool dataActive;
+    uint16_t dataId;
+    uint32_t dataOffset;  // The offset of the next LOG_DATA message.
+    uint32_t dataEnd;     // The offset to stop transmitting at.
+    uint8_t timestepCounter;
+} logTransfer;
+
+// A LOG_DATA message is sent every logDataPeriod timesteps, which is set by
+// MavLinkScheduleGroundstation() to use the bandwidth the schedule leaves within
+// GROUNDSTATION_MAX_USAGE.
+#define LOG_DATA_MESSAGE_SIZE (MAVLINK_NUM_NON_PAYLOAD_BYTES + MAVLINK_MSG_ID_LOG_DATA_LEN)
+static uint8_t logDataPeriod = UINT8_MAX;
+
+// Track the transmission of the MAVLink statistics to the groundstation, as requested with the
+// MAV_CMD_SEASLUG_MAVLINK_STATS command. All MESSAGE_STATS are sent followed by all LINK_STATS,
+// all LATENCY_STATS, and then all SENSOR_STATS.
+static struct {
+    bool active;
+    uint8_t messageIndex;
+    uint8_t systemIndex;
+    uint8_t latencyStage;
+    uint8_t sensorIndex;
+    uint8_t timestepCounter;
+} statsTransfer;
+
+// Track the clock synchronization with the system on the other end of each link, indexed by
+// SeaslugMavlinkChannel. A TIMESYNC request stamped with the local time is sent once a second on
+// each link, and only the response to the latest request is used.
+static TimeSyncEstimator timeSync[2];
+static int64_t timeSyncRequest[2];
+
+// Statistics are sent to the groundstation one message every STATS_TRANSFER_PERIOD timesteps.
+// This is ~800B/s, so the full table takes a few seconds to send without starving the scheduled
+// messages.
+#define STATS_TRANSFER_PERIOD 5
+
 void MavLinkSendMissionCount(void);
 void MavLinkSendMissionItem(uint8_t currentMissionIndex);
 void MavLinkSendMissionRequest(uint8_t currentMissionIndex);
@@ -301,9 +380,20 @@ void MavLinkSendBasicState2(void);
 void MavLinkSendAttitude(void);
 void MavLinkSendSystemTime(uint8_t channel);
 void MavLinkSendVfrHud(void);
-void MavLinkSendParamValue(uint16_t id);
+void MavLinkSendNavSummary(void);
+bool MavLinkSendParamValue(uint16_t id);
 int MavLinkAppendMission(const mavlink_mission_item_t *mission, const float refNED[3]);
 void MavLinkSendDataloggerParameters(bool reset);
+void MavLinkTransmitLogTransfer(void);
+void MavLinkSendMessageStats(uint8_t channel, uint8_t index);
+void MavLinkSendLinkStats(uint8_t channel, uint8_t index);
+void MavLinkSendLatencyStats(uint8_t channel, uint8_t stage);
+void MavLinkSendSensorStats(uint8_t channel, uint8_t sensor);
+void MavLinkTransmitStatsTransfer(void);
+void MavLinkSendTimesync(uint8_t channel, int64_t tc1, int64_t ts1);
+void MavLinkSendTimesyncRequest(uint8_t channel);
+void MavLinkSendTimesyncStatus(uint8_t link);
+void MavLinkReceiveTimesync(uint8_t channel, const mavlink_timesync_t *msg);
 
 /**
  * Inverse of MATLAB's lla2ltp.
@@ -317,6 +407,145 @@ void ltp2lla(const real32_T ltp[3], int32_T lla[3])
     lla[2] = (int32_t)(ltp[2] / lla_ltp_gain[2]) + gpsOrigin[2];
 }
 
+// The offset of the message ID within a serialized message.
+#define MAVLINK_FRAME_MSGID_OFFSET 5
+
+/**
+ * Picks the UART1 transmit lane for a message to the groundstation. Responses to the groundstation's
+ * requests go in the control lane, so they're sent ahead of any queued telemetry and aren't dropped
+ * when it fills up the bulk lane.
+ * @param msgid The ID of the message.
+ */
+static UartLane MavLinkGroundstationLane(uint8_t msgid)
+{
+    switch (msgid) {
+    case MAVLINK_MSG_ID_COMMAND_ACK:
+    case MAVLINK_MSG_ID_MISSION_ACK:
+    case MAVLINK_MSG_ID_MISSION_COUNT:
+    case MAVLINK_MSG_ID_MISSION_ITEM:
+    case MAVLINK_MSG_ID_MISSION_REQUEST:
+    case MAVLINK_MSG_ID_PARAM_VALUE:
+    case MAVLINK_MSG_ID_STATUSTEXT:
+        return UART_LANE_CONTROL;
+    default:
+        return UART_LANE_BULK;
+    }
+}
+
+/**
+ * Transmits a message to the groundstation.
+ * @param data The serialized message.
+ * @param size The size of the serialized message in bytes.
+ * @return True if the message was queued, false if its lane was full and it was dropped.
+ */
+static bool MavLinkWriteGroundstation(const uint8_t *data, uint16_t size)
+{
+    const uint8_t msgid = data[MAVLINK_FRAME_MSGID_OFFSET];
+    if (Uart1WriteLane(MavLinkGroundstationLane(msgid), data, size, NULL) != UART_WRITE_COMPLETE) {
+        MavlinkStatsRecordTxDropped(MAVLINK_CHAN_GROUNDSTATION, msgid);
+        return false;
+    }
+    MavlinkStatsRecordTx(MAVLINK_CHAN_GROUNDSTATION, msgid, size);
+    return true;
+}
+
+// The time to transmit a single byte to the groundstation at 115200 baud with 10 bits per byte, in
+// hundredths of a PrimaryNodeGetTimestamp() tick.
+#define GROUNDSTATION_CENTITICKS_PER_BYTE (PRIMARY_NODE_TIMESTAMP_HZ * 10 * 100 / 115200)
+
+/**
+ * Estimates when everything currently queued for the groundstation will have been transmitted.
+ * @return The timestamp that UART1 will be empty at, see PrimaryNodeGetTimestamp().
+ */
+static uint32_t MavLinkGroundstationDrainTime(void)
+{
+    const uint32_t queued = Uart1GetTxQueueLength();
+    return PrimaryNodeGetTimestamp() + (queued * GROUNDSTATION_CENTITICKS_PER_BYTE + 99) / 100;
+}
+
+/**
+ * Transmits a message to the datalogger, also storing it in the onboard flash log.
+ * @param data The serialized message.
+ * @param size The size of the serialized message in bytes.
+ */
+static void MavLinkWriteDatalogger(const uint8_t *data, uint16_t size)
+{
+    const uint8_t msgid = data[MAVLINK_FRAME_MSGID_OFFSET];
+
+    if (Uart2WriteData(data, size)) {
+        MavlinkStatsRecordTx(MAVLINK_CHAN_DATALOGGER, msgid, size);
+    } else {
+        MavlinkStatsRecordTxDropped(MAVLINK_CHAN_DATALOGGER, msgid);
+    }
+
+    // Only store the summary of the stream in the flash log.
+    int i;
+    for (i = 0; i < FLASH_LOG_NUM_MSGS; ++i) {
+        if (flashLogMessageIds[i] == msgid) {
+            if (nodeSystemTime >= flashLogNextStore[i] && FlashLogWrite(data, size)) {
+                flashLogNextStore[i] = nodeSystemTime + flashLogPeriods[i];
+            }
+            break;
+        }
+    }
+}
+
+/**
+ * Schedules the repeating groundstation messages for the current groundstation mode, replacing
+ * everything that was scheduled before, and updates the channel usage.
+ * @return False if a message couldn't be scheduled.
+ */
+static bool MavLinkScheduleGroundstation(void)
+{
+    // We only report things that the GUI needs at 2Hz because it only updates at 1 or 2Hz.
+    // We output the VFR_HUD message at a fast 5Hz because it has the throttle value and that's
+    // nice to have quick response to. TIMESYNC is only needed at 1Hz to track the clock offset.
+    static const uint8_t fullPeriodicities[GROUNDSTATION_SCHEDULE_NUM_MSGS] = {2, 2, 1, 5, 4, 4, 1, 1, 1, 1, 2, 0, 1, 1, 1, 0, 5, 2, 1, 0};
+
+    // The compact mode sends NAV_SUMMARY at the rate of the fastest messages it replaces, and keeps
+    // only what the protocol itself needs at 1Hz.
+    static const uint8_t compactPeriodicities[GROUNDSTATION_SCHEDULE_NUM_MSGS] = {1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 5};
+
+    const uint8_t *periodicities = (groundstationMode == MAVLINK_GCS_MODE_COMPACT) ? compactPeriodicities : fullPeriodicities;
+
+    ClearSchedule(&groundstationMavlinkSchedule);
+    int i;
+    for (i = 0; i < GROUNDSTATION_SCHEDULE_NUM_MSGS; ++i) {
+        if (periodicities[i] && !AddMessageRepeating(&groundstationMavlinkSchedule, groundstationMavlinkScheduleIds[i], periodicities[i])) {
+            return false;
+        }
+    }
+
+    uint32_t bps = GetBps(&groundstationMavlinkSchedule);
+    groundstationChanUsage = (uint8_t)(((float)bps / GROUNDSTATION_BYTES_PER_SECOND) * 100);
+
+    // Log downloads get whatever's left of the budget.
+    const uint32_t budget = (uint32_t)GROUNDSTATION_BYTES_PER_SECOND * GROUNDSTATION_MAX_USAGE / 100;
+    if (bps < budget) {
+        const uint32_t period = (LOG_DATA_MESSAGE_SIZE * 100 + (budget - bps) - 1) / (budget - bps);
+        logDataPeriod = (period < UINT8_MAX) ? (uint8_t)period : UINT8_MAX;
+    } else {
+        logDataPeriod = UINT8_MAX;
+    }
+    return true;
+}
+
+void MavLinkSetGroundstationMode(uint8_t mode)
+{
+    if (mode != MAVLINK_GCS_MODE_FULL && mode != MAVLINK_GCS_MODE_COMPACT) {
+        return;
+    }
+    groundstationMode = mode;
+    if (groundstationScheduleReady) {
+        MavLinkScheduleGroundstation();
+    }
+}
+
+uint8_t MavLinkGetGroundstationMode(void)
+{
+    return groundstationMode;
+}
+
 /**
  * Initialize MAVLink transmission. This just sets up the MAVLink scheduler with the basic
  * repeatedly-transmit messages.
@@ -325,6 +554,12 @@ void MavLinkInit(void)
 {
     const uint8_t const mavMessageSizes[] = MAVLINK_MESSAGE_LENGTHS;
 
+    MavlinkStatsInit();
+    LinkUsageInit(&linkUsage[MAVLINK_CHAN_GROUNDSTATION], UART_BYTES_PER_SECOND, 100);
+    LinkUsageInit(&linkUsage[MAVLINK_CHAN_DATALOGGER], UART_BYTES_PER_SECOND, 100);
+    TimeSyncInit(&timeSync[MAVLINK_CHAN_GROUNDSTATION]);
+    TimeSyncInit(&timeSync[MAVLINK_CHAN_DATALOGGER]);
+
     // First initialize the MessageSchedule struct with the proper sizes.
     {
         int i;
@@ -332,24 +567,9 @@ void MavLinkInit(void)
             groundstationMavlinkSchedule.MessageSizes[i] = mavMessageSizes[groundstationMavlinkScheduleIds[i]];
         }
 
-        // We only report things that the GUI needs at 2Hz because it only updates at 1 or 2Hz.
-        // We output the VFR_HUD message at a fast 5Hz because it has the throttle value and that's
-        // nice to have quick response to.
-        const uint8_t const periodicities[GROUNDSTATION_SCHEDULE_NUM_MSGS] = {2, 2, 1, 5, 4, 4, 1, 1, 1, 1, 2, 0, 1, 1, 1, 0, 5, 2};
-        for (i = 0; i < GROUNDSTATION_SCHEDULE_NUM_MSGS; ++i) {
-            if (periodicities[i] && !AddMessageRepeating(&groundstationMavlinkSchedule, groundstationMavlinkScheduleIds[i], periodicities[i])) {
-                FATAL_ERROR();
-            }
-        }
-
         // Make sure that we haven't exceeded the total number of bytes/s available on this connection.
-        // While we're connecting at 115200, we expect the airspeed of the radios to be 64kbps.
-        // Additionally, ECC should be turned on, so that halves that data rate. And I don't want to
-        // exceed 80% of that total bandwidth. This makes sure we have space for transient messages like
-        // missions, parameters, or waypoint/state changes.
-        uint32_t bps = GetBps(&groundstationMavlinkSchedule);
-        groundstationChanUsage = (uint8_t)(((float)bps / (64000.0f / 10.0f / 2.0f)) * 100);
-        if (groundstationChanUsage > 80) {
+        groundstationScheduleReady = true;
+        if (!MavLinkScheduleGroundstation() || groundstationChanUsage > GROUNDSTATION_MAX_USAGE) {
             FATAL_ERROR();
         }
     }
@@ -364,8 +584,9 @@ void MavLinkInit(void)
 
         // We want the HEARTBEAT/SYS_STATUS messages so this stream can be used with QGC. And then
         // for datalogging having the status of all nodes at 5Hz + the controller's input/output at
-        // 100Hz is awesome.
-        const uint8_t const periodicities[DATALOGGER_SCHEDULE_NUM_MSGS] = {2, 2, 5, 0, 100, 0, 1, 5, 10};
+        // 100Hz is awesome. The MAVLink, latency, and sensor statistics are cycled through slowly, as
+        // they change slowly. TIMESYNC_STATUS alternates between the two links.
+        const uint8_t const periodicities[DATALOGGER_SCHEDULE_NUM_MSGS] = {2, 2, 5, 0, 100, 0, 1, 5, 10, 2, 1, 2, 1, 2, 2};
         for (i = 0; i < DATALOGGER_SCHEDULE_NUM_MSGS; ++i) {
             if (periodicities[i] && !AddMessageRepeating(&dataloggerMavlinkSchedule, dataloggerMavlinkScheduleIds[i], periodicities[i])) {
                 FATAL_ERROR();
@@ -377,7 +598,7 @@ void MavLinkInit(void)
         // Every so often some SEASLUG_PARAMETER messages will be sent, so if we don't exceed 90%,
         // it'll be fine.
         uint32_t bps = GetBps(&dataloggerMavlinkSchedule);
-        dataloggerChanUsage = (uint8_t)(((float)bps / (115200.0f / 10.0f)) * 100);
+        dataloggerChanUsage = (uint8_t)(((float)bps / DATALOGGER_BYTES_PER_SECOND) * 100);
         if (dataloggerChanUsage > 90) {
             FATAL_ERROR();
         }
@@ -451,31 +672,43 @@ void MavLinkSendHeartbeat(uint8_t channel)
 
         // Send to the correct channel
         if (channel == MAVLINK_CHAN_DATALOGGER) {
-            Uart2WriteData(buf, (uint8_t)len);
+            MavLinkWriteDatalogger(buf, len);
         } else {
-            Uart1WriteData(buf, (uint8_t)len);
+            MavLinkWriteGroundstation(buf, len);
         }
 }
 
+/**
+ * Returns the time since boot in milliseconds for the time_boot_ms field of every message, from
+ * the same clock as PrimaryNodeGetTimeUs() so that all streams line up with SYSTEM_TIME.
+ */
+static uint32_t MavLinkTimeBootMs(void)
+{
+    return (uint32_t)(PrimaryNodeGetTimeUs() / 1000);
+}
+
 /**
  * This function transmits the system time. Looks like it's necessary for QGC to
  * record timestamps on data reliably. For some reason it doesn't just use the local
  * time of message reception. Hopefully this fixes that.
+ *
+ * The time since boot comes from the high-resolution clock, the same one used for TIMESYNC. The
+ * datalogger's own synchronized time is reported in TIMESYNC_STATUS instead.
  */
 void MavLinkSendSystemTime(uint8_t channel)
 {
     // Pack the message
     mavlink_msg_system_time_pack_chan(mavlink_system.sysid, mavlink_system.compid, channel,
-        &txMessage, dateTimeDataStore.usecSinceEpoch, nodeSystemTime*10);
+        &txMessage, dateTimeDataStore.usecSinceEpoch, MavLinkTimeBootMs());
 
     // Copy the message to the send buffer
     len = mavlink_msg_to_send_buffer(buf, &txMessage);
 
     // Send to the correct channel
     if (channel == MAVLINK_CHAN_DATALOGGER) {
-        Uart2WriteData(buf, (uint8_t)len);
+        MavLinkWriteDatalogger(buf, len);
     } else {
-        Uart1WriteData(buf, (uint8_t)len);
+        MavLinkWriteGroundstation(buf, len);
     }
 }
 
@@ -485,50 +718,29 @@ void MavLinkSendSystemTime(uint8_t channel)
  */
 void MavLinkSendStatus(uint8_t channel)
 {
-	// Declare that we have onboard sensors: 3D gyro, 3D accelerometer, 3D magnetometer, absolute pressure, GPS
-	// And that we have the following controllers: yaw position, x/y position control, motor outputs/control.
-    uint32_t systemsPresent = ONBOARD_SENSORS_IMU |
-                              ONBOARD_SENSORS_WSO100 |
-                              ONBOARD_SENSORS_GPS |
-                              ONBOARD_CONTROL_RUDDER |
-                              ONBOARD_CONTROL_MOTOR |
-                              ONBOARD_CONTROL_RC;
-
-        // These are systems which are connected.
-	uint32_t systemsEnabled = 0;
-	systemsEnabled |= sensorAvailability.rudder.enabled?ONBOARD_CONTROL_RUDDER:0;
-	systemsEnabled |= sensorAvailability.gps.enabled?ONBOARD_SENSORS_GPS:0;
-	systemsEnabled |= sensorAvailability.imu.enabled?ONBOARD_SENSORS_IMU:0;
-	systemsEnabled |= sensorAvailability.wso100.enabled?ONBOARD_SENSORS_WSO100:0;
-	// The DST800 doesn't map into this bitfield.
-	// The power node doesn't map into this bitfield.
-	systemsEnabled |= sensorAvailability.prop.enabled?ONBOARD_CONTROL_MOTOR:0;
-	systemsEnabled |= sensorAvailability.rcNode.enabled?ONBOARD_CONTROL_RC:0;
-
-        // And these are systems which are transmitting good data
-	uint32_t systemsActive = 0;
-	systemsActive |= sensorAvailability.rudder.active?ONBOARD_CONTROL_RUDDER:0;
-	systemsActive |= sensorAvailability.gps.active?ONBOARD_SENSORS_GPS:0;
-	systemsActive |= sensorAvailability.imu.active?ONBOARD_SENSORS_IMU:0;
-	systemsActive |= sensorAvailability.wso100.active?ONBOARD_SENSORS_WSO100:0;
-	// The DST800 doesn't map into this bitfield.
-	// The power node doesn't map into this bitfield.
-	systemsActive |= sensorAvailability.prop.active?ONBOARD_CONTROL_MOTOR:0;
-	systemsActive |= sensorAvailability.rcNode.active?ONBOARD_CONTROL_RC:0;
+    // These are all the systems onboard, those which are connected, and those which are
+    // transmitting good data, already combined over every sensor by UpdateSensorsAvailability().
+    const uint32_t systemsPresent = sensorStatus.present;
+    const uint32_t systemsEnabled = sensorStatus.enabled;
+    const uint32_t systemsActive = sensorStatus.active;
 
 	// Grab the globally-declared battery sensor data and map into the values necessary for transmission.
 	uint16_t voltage = (uint16_t)(GetPowerRailVoltage() * 1000);
 	int16_t amperage = (int16_t)(GetPowerRailCurrent() * 100);
 
-	// Calculate the drop rate
+	// Calculate the drop rate of the groundstation link. The error count is clamped to fit in the
+	// 16-bit field.
+	const uint32_t rxErrors = MavlinkStatsGetRxErrors(MAVLINK_CHAN_GROUNDSTATION);
 	uint16_t dropRate = 0;
-	if (mavLinkMessagesFailedParsing) {
-            dropRate = (uint16_t)(((float)mavLinkMessagesFailedParsing) * 10000.0f / ((float)(mavLinkMessagesReceived + mavLinkMessagesFailedParsing)));
+	if (rxErrors) {
+            dropRate = (uint16_t)(((float)rxErrors) * 10000.0f / ((float)MavlinkStatsGetRxTotal(MAVLINK_CHAN_GROUNDSTATION) + (float)rxErrors));
 	}
 
-        // Get the ECAN error count to transmit that as well:
+        // Get the ECAN error count to transmit that as well, along with the channel usages:
         //  * errors_count1 - ecan1 tx error count
         //  * errors_count2 - ecan1 rx error count
+        //  * errors_count3 - groundstation channel usage in percent
+        //  * errors_count4 - datalogger channel usage in percent
         uint8_t ecanTxErrorCount, ecanRxErrorCount;
         Ecan1GetErrorCounts(&ecanTxErrorCount, &ecanRxErrorCount);
 
@@ -537,14 +749,16 @@ void MavLinkSendStatus(uint8_t channel)
             systemsPresent, systemsEnabled, systemsActive,
             (uint16_t)(nodeCpuLoad)*10,
             voltage, amperage, -1,
-            dropRate, mavLinkMessagesFailedParsing,
-            ecanTxErrorCount, ecanRxErrorCount, 0, 0);
+            dropRate, (rxErrors > UINT16_MAX) ? UINT16_MAX : (uint16_t)rxErrors,
+            ecanTxErrorCount, ecanRxErrorCount,
+            MavLinkGetChannelUsage(MAVLINK_CHAN_GROUNDSTATION),
+            MavLinkGetChannelUsage(MAVLINK_CHAN_DATALOGGER));
 	len = mavlink_msg_to_send_buffer(buf, &txMessage);
 
         if (channel == MAVLINK_CHAN_DATALOGGER) {
-            Uart2WriteData(buf, (uint8_t)len);
+            MavLinkWriteDatalogger(buf, len);
         } else {
-            Uart1WriteData(buf, (uint8_t)len);
+            MavLinkWriteGroundstation(buf, len);
         }
 }
 
@@ -556,7 +770,7 @@ void MavLinkSendStatusText(enum MAV_SEVERITY severity, const char *text)
 
 	len = mavlink_msg_to_send_buffer(buf, &txMessage);
 
-	Uart1WriteData(buf, (uint8_t)len);
+	MavLinkWriteGroundstation(buf, len);
 }
 
 void MavLinkSendTokimec(void)
@@ -573,13 +787,13 @@ void MavLinkSendTokimec(void)
 
     len = mavlink_msg_to_send_buffer(buf, &txMessage);
 
-    Uart1WriteData(buf, (uint8_t)len);
+    MavLinkWriteGroundstation(buf, len);
 }
 
 void MavLinkSendTokimecWithTime(void)
 {
     mavlink_msg_tokimec_with_time_pack_chan(mavlink_system.sysid, mavlink_system.compid, MAVLINK_CHAN_DATALOGGER, &txMessage,
-        nodeSystemTime*10,
+        MavLinkTimeBootMs(),
         tokimecDataStore.yaw, tokimecDataStore.pitch, tokimecDataStore.roll,
         tokimecDataStore.x_angle_vel, tokimecDataStore.y_angle_vel, tokimecDataStore.z_angle_vel,
         tokimecDataStore.x_accel, tokimecDataStore.y_accel, tokimecDataStore.z_accel,
@@ -591,7 +805,7 @@ void MavLinkSendTokimecWithTime(void)
 
     len = mavlink_msg_to_send_buffer(buf, &txMessage);
 
-    Uart2WriteData(buf, (uint8_t)len);
+    MavLinkWriteDatalogger(buf, len);
 }
 
 /**
@@ -612,7 +826,7 @@ void MavLinkSendVfrHud(void)
 
     len = mavlink_msg_to_send_buffer(buf, &txMessage);
 
-    Uart1WriteData(buf, (uint8_t)len);
+    MavLinkWriteGroundstation(buf, len);
 }
 
 void MavLinkSendRadioStatus(void)
@@ -621,26 +835,33 @@ void MavLinkSendRadioStatus(void)
 
     len = mavlink_msg_to_send_buffer(buf, &txMessage);
 
-    Uart1WriteData(buf, (uint8_t)len);
+    MavLinkWriteGroundstation(buf, len);
 }
 
 /**
- * Pull the raw GPS sensor data from the gpsDataStore struct within the GPS module and
- * transmit it via MAVLink over UART1.
+ * Converts the mode of the fix in gpsDataStore into a GPS_RAW_INT fix type.
  */
-void MavLinkSendRawGps(uint8_t channel)
+static uint8_t MavLinkGpsFixType(void)
 {
-
 	// We need to made the mode received from NMEA2000 messages to NMEA0183 fix type.
 	// NMEA2000    | NMEA0183 | Meaning
 	// 0,3,4,5,6,7 |   0      | invalid/no fix
 	//    2        |   3      | 3D fix
 	//    1        |   2      | 2D fix
-	uint8_t mavlinkGpsMode = gpsDataStore.mode == 2?3:(gpsDataStore.mode == 1?2:0);
+	return gpsDataStore.mode == 2?3:(gpsDataStore.mode == 1?2:0);
+}
+
+/**
+ * Pull the raw GPS sensor data from the gpsDataStore struct within the GPS module and
+ * transmit it via MAVLink over UART1.
+ */
+void MavLinkSendRawGps(uint8_t channel)
+{
+	uint8_t mavlinkGpsMode = MavLinkGpsFixType();
 
 	mavlink_msg_gps_raw_int_pack_chan(mavlink_system.sysid, mavlink_system.compid, channel,
         &txMessage,
-        ((uint64_t)nodeSystemTime)*10000,
+        PrimaryNodeGetTimeUs(),
 		mavlinkGpsMode, gpsDataStore.latitude, gpsDataStore.longitude,
         gpsDataStore.altitude, // FIXME: Convert this value to AMSL.
 		gpsDataStore.hdop, gpsDataStore.vdop,
@@ -650,9 +871,9 @@ void MavLinkSendRawGps(uint8_t channel)
 	len = mavlink_msg_to_send_buffer(buf, &txMessage);
 
     if (channel == MAVLINK_CHAN_DATALOGGER) {
-        Uart2WriteData(buf, (uint8_t)len);
+        MavLinkWriteDatalogger(buf, len);
     } else {
-        Uart1WriteData(buf, (uint8_t)len);
+        MavLinkWriteGroundstation(buf, len);
     }
 }
 
@@ -670,9 +891,9 @@ void MavLinkSendMainPower(uint8_t channel)
     len = mavlink_msg_to_send_buffer(buf, &txMessage);
 
     if (channel == MAVLINK_CHAN_DATALOGGER) {
-        Uart2WriteData(buf, (uint8_t)len);
+        MavLinkWriteDatalogger(buf, len);
     } else {
-        Uart1WriteData(buf, (uint8_t)len);
+        MavLinkWriteGroundstation(buf, len);
     }
 }
 
@@ -698,7 +919,7 @@ void MavLinkSendBasicState2(void)
 
     len = mavlink_msg_to_send_buffer(buf, &txMessage);
 
-    Uart1WriteData(buf, (uint8_t)len);
+    MavLinkWriteGroundstation(buf, len);
 }
 
 /**
@@ -711,16 +932,16 @@ void MavLinkSendDsp3000(void)
 
 	len = mavlink_msg_to_send_buffer(buf, &txMessage);
 
-	Uart1WriteData(buf, (uint8_t)len);
+	MavLinkWriteGroundstation(buf, len);
 }
 
 /**
- * Transmits the vehicle attitude pulled from the Revolution GS 3-axis compass. This functions e
- * xpects nodeSystemTime to be in centiseconds which are then converted to ms for transmission.
+ * Transmits the vehicle attitude pulled from the Revolution GS 3-axis compass.
  * Yaw should be in radians where positive is eastward from north.
  */
 void MavLinkSendAttitude(void)
 {
+	const uint32_t packed = PrimaryNodeGetTimestamp();
 	float roll = (float)tokimecDataStore.roll / 8192.0;
 	float pitch = (float)tokimecDataStore.pitch / 8192.0;
 	float yaw = (float)tokimecDataStore.yaw / 8192.0;
@@ -728,13 +949,15 @@ void MavLinkSendAttitude(void)
         float pitchRate = (float)tokimecDataStore.y_angle_vel / 4096.0;
         float yawRate = (float)tokimecDataStore.z_angle_vel / 4096.0;
 	mavlink_msg_attitude_pack(mavlink_system.sysid, mavlink_system.compid, &txMessage,
-	                          nodeSystemTime*10,
+	                          MavLinkTimeBootMs(),
                                   roll, pitch, yaw,
                                   rollRate, pitchRate, yawRate);
 
 	len = mavlink_msg_to_send_buffer(buf, &txMessage);
 
-	Uart1WriteData(buf, (uint8_t)len);
+	if (MavLinkWriteGroundstation(buf, len)) {
+		LatencySent(&tokimecLatency, LATENCY_STAGE_ATTITUDE_TOTAL, packed, MavLinkGroundstationDrainTime());
+	}
 }
 
 /**
@@ -743,14 +966,85 @@ void MavLinkSendAttitude(void)
  */
 void MavLinkSendLocalPosition(void)
 {
+	const uint32_t packed = PrimaryNodeGetTimestamp();
 	mavlink_msg_local_position_ned_pack(mavlink_system.sysid, mavlink_system.compid, &txMessage,
-	                                    nodeSystemTime*10,
+	                                    MavLinkTimeBootMs(),
 	                                    controllerVars.LocalPosition[0], controllerVars.LocalPosition[1], NAN,
 	                                    controllerVars.Velocity[0], controllerVars.Velocity[1], NAN);
 
 	len = mavlink_msg_to_send_buffer(buf, &txMessage);
 
-	Uart1WriteData(buf, (uint8_t)len);
+	if (MavLinkWriteGroundstation(buf, len)) {
+		LatencySent(&controllerGpsLatency, LATENCY_STAGE_POSITION_TOTAL, packed, MavLinkGroundstationDrainTime());
+	}
+}
+
+/**
+ * Quantizes a value into an int16_t, saturating at its limits. NaNs become 0.
+ */
+static int16_t SaturateInt16(float x)
+{
+	if (x != x) {
+		return 0;
+	} else if (x >= INT16_MAX) {
+		return INT16_MAX;
+	} else if (x <= INT16_MIN) {
+		return INT16_MIN;
+	}
+	return (int16_t)x;
+}
+
+/**
+ * Quantizes a value into a uint16_t, saturating at its limits. NaNs become 0.
+ */
+static uint16_t SaturateUint16(float x)
+{
+	if (x != x || x <= 0) {
+		return 0;
+	} else if (x >= UINT16_MAX) {
+		return UINT16_MAX;
+	}
+	return (uint16_t)x;
+}
+
+/**
+ * Transmits the NAV_SUMMARY message that replaces the ATTITUDE, LOCAL_POSITION_NED, GPS_RAW_INT,
+ * VFR_HUD, and SeaSlug sensor messages in the compact groundstation mode. The Tokimec angles and
+ * GPS data are sent at their native resolution, everything else is quantized as described in
+ * seaslug.xml.
+ */
+void MavLinkSendNavSummary(void)
+{
+	const uint32_t packed = PrimaryNodeGetTimestamp();
+
+	float actRudderAngleCommand;
+	int16_t actThrottleCommand;
+	GetCurrentActuatorCommands(&actRudderAngleCommand, &actThrottleCommand);
+
+	int8_t missionIndex;
+	GetCurrentMission(&missionIndex);
+
+	mavlink_msg_nav_summary_pack_chan(mavlink_system.sysid, mavlink_system.compid, MAVLINK_CHAN_GROUNDSTATION, &txMessage,
+	    MavLinkTimeBootMs(),
+	    gpsDataStore.latitude, gpsDataStore.longitude,
+	    SaturateInt16(controllerVars.LocalPosition[0] * 10), SaturateInt16(controllerVars.LocalPosition[1] * 10),
+	    SaturateInt16(controllerVars.Velocity[0] * 100), SaturateInt16(controllerVars.Velocity[1] * 100),
+	    tokimecDataStore.roll, tokimecDataStore.pitch, tokimecDataStore.yaw,
+	    tokimecDataStore.z_angle_vel,
+	    gpsDataStore.sog, (uint16_t)(((float)gpsDataStore.cog) * 180 / M_PI / 100),
+	    SaturateUint16(waterDataStore.speed * 100),
+	    SaturateInt16(rudderSensorData.RudderAngle * 1e4),
+	    actThrottleCommand,
+	    nodeStatus, nodeErrors,
+	    (missionIndex < 0) ? UINT8_MAX : (uint8_t)missionIndex,
+	    MavLinkGpsFixType(), gpsDataStore.satellites);
+	len = mavlink_msg_to_send_buffer(buf, &txMessage);
+	// This carries the attitude and position in place of ATTITUDE and LOCAL_POSITION_NED.
+	if (MavLinkWriteGroundstation(buf, len)) {
+		const uint32_t drained = MavLinkGroundstationDrainTime();
+		LatencySent(&tokimecLatency, LATENCY_STAGE_ATTITUDE_TOTAL, packed, drained);
+		LatencySent(&controllerGpsLatency, LATENCY_STAGE_POSITION_TOTAL, packed, drained);
+	}
 }
 
 /**
@@ -764,7 +1058,7 @@ void MavLinkSendGpsGlobalOrigin(void)
 
 	len = mavlink_msg_to_send_buffer(buf, &txMessage);
 
-	Uart1WriteData(buf, (uint8_t)len);
+	MavLinkWriteGroundstation(buf, len);
 }
 
 /**
@@ -776,7 +1070,7 @@ void MavLinkSendCurrentMission(int8_t missionIndex)
     if (missionIndex != -1) {
         mavlink_msg_mission_current_pack(mavlink_system.sysid, mavlink_system.compid, &txMessage, (uint16_t)missionIndex);
         len = mavlink_msg_to_send_buffer(buf, &txMessage);
-        Uart1WriteData(buf, (uint8_t)len);
+        MavLinkWriteGroundstation(buf, len);
     }
 }
 
@@ -790,7 +1084,7 @@ void MavLinkSendMissionItemReached(int8_t missionIndex)
         mavlink_msg_mission_item_reached_pack(mavlink_system.sysid, mavlink_system.compid,
                                               &txMessage, (uint16_t)(missionIndex));
         len = mavlink_msg_to_send_buffer(buf, &txMessage);
-        Uart1WriteData(buf, (uint8_t)len);
+        MavLinkWriteGroundstation(buf, len);
     }
 }
 
@@ -803,7 +1097,7 @@ void MavLinkSendMissionAck(uint8_t type)
 	mavlink_msg_mission_ack_pack(mavlink_system.sysid, mavlink_system.compid, &txMessage,
 	                             groundStationSystemId, groundStationComponentId, type);
 	len = mavlink_msg_to_send_buffer(buf, &txMessage);
-	Uart1WriteData(buf, (uint8_t)len);
+	MavLinkWriteGroundstation(buf, len);
 }
 
 /**
@@ -815,7 +1109,7 @@ void MavLinkSendCommandAck(uint8_t command, uint8_t result)
 	mavlink_msg_command_ack_pack(mavlink_system.sysid, mavlink_system.compid, &txMessage,
 	                             command, result);
 	len = mavlink_msg_to_send_buffer(buf, &txMessage);
-	Uart1WriteData(buf, (uint8_t)len);
+	MavLinkWriteGroundstation(buf, len);
 }
 
 /**
@@ -850,7 +1144,7 @@ void MavLinkSendControllerData(const ImuData *imu, const GpsData *gps, float wat
         waterSpeed * 1e4,
         gps->newData, gps->latitude, gps->longitude, gps->sog, gps->cog, gps->hdop,
         reset,
-        nodeSystemTime*10,
+        MavLinkTimeBootMs(),
         controllerVars.LocalPosition[0] * 1e3, controllerVars.LocalPosition[1] * 1e3,
         controllerVars.Velocity[0] * 1e3, controllerVars.Velocity[1] * 1e3,
         clampedACmd,
@@ -865,7 +1159,7 @@ void MavLinkSendControllerData(const ImuData *imu, const GpsData *gps, float wat
 
     len = mavlink_msg_to_send_buffer(buf, &txMessage);
 
-    Uart2WriteData(buf, (uint8_t)len);
+    MavLinkWriteDatalogger(buf, len);
 }
 
 void MavLinkSendMissionCount(void)
@@ -875,7 +1169,7 @@ void MavLinkSendMissionCount(void)
 	mavlink_msg_mission_count_pack(mavlink_system.sysid, mavlink_system.compid, &txMessage,
 	                               groundStationSystemId, groundStationComponentId, missionCount);
 	len = mavlink_msg_to_send_buffer(buf, &txMessage);
-	Uart1WriteData(buf, (uint8_t)len);
+	MavLinkWriteGroundstation(buf, len);
 }
 
 /**
@@ -915,7 +1209,7 @@ void MavLinkSendMissionItem(uint8_t currentMissionIndex)
         }
 
 		len = mavlink_msg_to_send_buffer(buf, &txMessage);
-		Uart1WriteData(buf, (uint8_t)len);
+		MavLinkWriteGroundstation(buf, len);
 	}
 }
 
@@ -924,14 +1218,15 @@ void MavLinkSendMissionRequest(uint8_t currentMissionIndex)
 	mavlink_msg_mission_request_pack(mavlink_system.sysid, mavlink_system.compid, &txMessage,
 	                                 groundStationSystemId, groundStationComponentId, currentMissionIndex);
 	len = mavlink_msg_to_send_buffer(buf, &txMessage);
-	Uart1WriteData(buf, (uint8_t)len);
+	MavLinkWriteGroundstation(buf, len);
 }
 
 /**
  * The following functions are helper functions for reading the various parameters aboard the boat.
  * @param id The ID of this parameter.
+ * @return False if the parameter should be sent again later as there was no room to queue it.
  */
-void MavLinkSendParamValue(uint16_t id)
+bool MavLinkSendParamValue(uint16_t id)
 {
     if (id < PARAMETERS_TOTAL) {
         // Then use the helper functions from Parameters.h to get the current value. If there was an
@@ -944,8 +1239,9 @@ void MavLinkSendParamValue(uint16_t id)
             onboardParameters[id].name, param_value, onboardParameters[id].dataType,
             PARAMETERS_TOTAL, id);
         len = mavlink_msg_to_send_buffer(buf, &txMessage);
-        Uart1WriteData(buf, (uint8_t)len);
+        return MavLinkWriteGroundstation(buf, len);
     }
+    return true;
 }
 
 void MavLinkTransmitAllParameters(void)
@@ -965,7 +1261,7 @@ void MavLinkSendRudderRaw(void)
 
 	len = mavlink_msg_to_send_buffer(buf, &txMessage);
 
-	Uart1WriteData(buf, (uint8_t)len);
+	MavLinkWriteGroundstation(buf, len);
 }
 
 void MavLinkSendWindAirData(void)
@@ -974,7 +1270,7 @@ void MavLinkSendWindAirData(void)
 		windDataStore.speed, windDataStore.direction,
 		airDataStore.temp, airDataStore.pressure, airDataStore.humidity);
 	len = mavlink_msg_to_send_buffer(buf, &txMessage);
-	Uart1WriteData(buf, (uint8_t)len);
+	MavLinkWriteGroundstation(buf, len);
 }
 
 void MavLinkSendDst800Data(void)
@@ -982,7 +1278,7 @@ void MavLinkSendDst800Data(void)
 	mavlink_msg_dst800_pack(mavlink_system.sysid, mavlink_system.compid, &txMessage,
 	                        waterDataStore.speed, waterDataStore.temp, waterDataStore.depth);
 	len = mavlink_msg_to_send_buffer(buf, &txMessage);
-	Uart1WriteData(buf, (uint8_t)len);
+	MavLinkWriteGroundstation(buf, len);
 }
 
 void MavLinkSendRevoGsData(void)
@@ -993,7 +1289,7 @@ void MavLinkSendRevoGsData(void)
 		revoGsDataStore.roll, revoGsDataStore.rollStatus,
 		revoGsDataStore.dip, revoGsDataStore.magneticMagnitude);
 	len = mavlink_msg_to_send_buffer(buf, &txMessage);
-	Uart1WriteData(buf, (uint8_t)len);
+	MavLinkWriteGroundstation(buf, len);
 }
 
 void MavLinkSendGps200Data(void)
@@ -1001,7 +1297,7 @@ void MavLinkSendGps200Data(void)
 	mavlink_msg_gps200_pack(mavlink_system.sysid, mavlink_system.compid, &txMessage,
 	                        gpsDataStore.variation);
 	len = mavlink_msg_to_send_buffer(buf, &txMessage);
-	Uart1WriteData(buf, (uint8_t)len);
+	MavLinkWriteGroundstation(buf, len);
 }
 
 void MavLinkSendNavControllerOutput(void)
@@ -1014,7 +1310,7 @@ void MavLinkSendNavControllerOutput(void)
             CrossTrackError()
     );
     len = mavlink_msg_to_send_buffer(buf, &txMessage);
-    Uart1WriteData(buf, (uint8_t)len);
+    MavLinkWriteGroundstation(buf, len);
 }
 
 void MavLinkSendNodeStatus(uint8_t channel)
@@ -1055,9 +1351,9 @@ void MavLinkSendNodeStatus(uint8_t channel)
 
     // Send to the correct channel
     if (channel == MAVLINK_CHAN_DATALOGGER) {
-        Uart2WriteData(buf, (uint8_t)len);
+        MavLinkWriteDatalogger(buf, len);
     } else {
-        Uart1WriteData(buf, (uint8_t)len);
+        MavLinkWriteGroundstation(buf, len);
     }
 }
 
@@ -1070,7 +1366,7 @@ void MavLinkSendWaypointStatusData(void)
 	                                 NAN, NAN, controllerVars.wp0[0], controllerVars.wp0[1],
 									 NAN, NAN, controllerVars.wp1[0], controllerVars.wp1[1]);
 	len = mavlink_msg_to_send_buffer(buf, &txMessage);
-	Uart1WriteData(buf, (uint8_t)len);
+	MavLinkWriteGroundstation(buf, len);
 }
 
 void MavLinkReceiveCommandLong(const mavlink_command_long_t *msg)
@@ -1081,7 +1377,8 @@ void MavLinkReceiveCommandLong(const mavlink_command_long_t *msg)
         {
             uint8_t result = MAV_RESULT_FAILED;
             if (msg->param1) {
-                if (DataStoreSaveParameters()) {
+                // Only the parameters changed since they were last stored need writing.
+                if (DataStoreFlush()) {
                     result = MAV_RESULT_ACCEPTED;
                 }
             } else {
@@ -1092,6 +1389,21 @@ void MavLinkReceiveCommandLong(const mavlink_command_long_t *msg)
             MavLinkSendCommandAck(msg->command, result);
         }
             break;
+        case MAV_CMD_SEASLUG_MAVLINK_STATS:
+            if (msg->param1) {
+                MavlinkStatsInit();
+                LatencyInit();
+                ResetSensorArrivals();
+                statsTransfer.active = false;
+            } else {
+                statsTransfer.active = true;
+                statsTransfer.messageIndex = 0;
+                statsTransfer.systemIndex = 0;
+                statsTransfer.latencyStage = 0;
+                statsTransfer.sensorIndex = 0;
+            }
+            MavLinkSendCommandAck(msg->command, MAV_RESULT_ACCEPTED);
+            break;
         default:
             MavLinkSendCommandAck(msg->command, MAV_RESULT_UNSUPPORTED);
             break;
@@ -1210,17 +1522,15 @@ void MavLinkEvaluateParameterState(enum PARAM_EVENT event, const void *data)
 			}
 		break;
 
+		// If the parameter couldn't be queued, these states try again on the next event.
 		case PARAM_STATE_SINGLETON_SEND_VALUE: {
-			if (event == PARAM_EVENT_NONE) {
-				MavLinkSendParamValue(currentParameter);
+			if (event == PARAM_EVENT_NONE && MavLinkSendParamValue(currentParameter)) {
 				nextState = PARAM_STATE_INACTIVE;
 			}
 		} break;
 
 		case PARAM_STATE_STREAM_SEND_VALUE: {
-			if (event == PARAM_EVENT_NONE) {
-				MavLinkSendParamValue(currentParameter);
-
+			if (event == PARAM_EVENT_NONE && MavLinkSendParamValue(currentParameter)) {
 				// And increment the current parameter index for the next iteration and
 				// we finish if we've hit the limit of parameters.
 				if (++currentParameter == PARAMETERS_TOTAL) {
@@ -1832,6 +2142,54 @@ int MavLinkAppendMission(const mavlink_mission_item_t *mission, const float refN
 	return missionAddStatus;
 }
 
+/**
+ * Start transmitting LOG_ENTRY messages for all logs with IDs in the requested range. This cancels
+ * any active log transfer.
+ */
+void MavLinkReceiveLogRequestList(const mavlink_log_request_list_t *request)
+{
+    logTransfer.listActive = true;
+    logTransfer.listIndex = 0;
+    logTransfer.listStart = request->start;
+    logTransfer.listEnd = request->end;
+    logTransfer.dataActive = false;
+}
+
+/**
+ * Start transmitting LOG_DATA messages for the requested range of a log. The range is clamped to
+ * the size of the log. This cancels any active log transfer.
+ */
+void MavLinkReceiveLogRequestData(const mavlink_log_request_data_t *request)
+{
+    logTransfer.listActive = false;
+    logTransfer.dataActive = false;
+
+    // Find the size of the requested log, ignoring requests for logs that don't exist.
+    const uint8_t logCount = FlashLogGetLogCount();
+    uint8_t i;
+    for (i = 0; i < logCount; ++i) {
+        uint16_t id;
+        uint32_t size;
+        FlashLogGetLogInfo(i, &id, &size);
+        if (id == request->id) {
+            logTransfer.dataActive = true;
+            logTransfer.dataId = id;
+            logTransfer.dataOffset = request->ofs;
+            if (request->ofs > size || request->count > size - request->ofs) {
+                logTransfer.dataEnd = size;
+            } else {
+                logTransfer.dataEnd = request->ofs + request->count;
+            }
+            // Start transmitting on the next timestep.
+            logTransfer.timestepCounter = logDataPeriod;
+            break;
+        }
+    }
+
+    // Don't let logging erase any sector while it's being read.
+    FlashLogSetPaused(logTransfer.dataActive);
+}
+
 /**
 * @brief Receive communication packets and handle them. Should be called at the system sample rate.
 *
@@ -1853,136 +2211,192 @@ void MavLinkReceive(void)
 	// timestep such that its internal state machine works properly.
 	bool processedParameterMessage = false;
 
-        uint8_t c;
-	while (Uart1ReadByte(&c)) {
-		// Parse another byte and if there's a message found process it.
-		if (mavlink_parse_char(MAVLINK_COMM_0, c, &rxMessage, &status)) {
-
-			// Latch the groundstation system and component ID if we haven't yet. We exclude the
-			// combination of systemid:3/compid:D, because that's the combo used by the 3DR radios.
-			if (!groundStationSystemId && !groundStationComponentId &&
-			    (rxMessage.sysid != '3' && rxMessage.compid != 'D')) {
-				groundStationSystemId = rxMessage.sysid;
-				groundStationComponentId = rxMessage.compid;
+	// Received data is parsed a whole span at a time, which avoids disabling the UART interrupts
+	// for every byte.
+	const uint8_t *span;
+	uint16_t length;
+	uint16_t i;
+	while ((length = Uart1ReadSpan(&span))) {
+		for (i = 0; i < length; ++i) {
+			// Parse another byte and if there's a message found process it.
+			if (mavlink_parse_char(MAVLINK_COMM_0, span[i], &rxMessage, &status)) {
+
+				MavlinkStatsRecordRx(MAVLINK_CHAN_GROUNDSTATION, rxMessage.sysid, rxMessage.msgid,
+				                     rxMessage.seq, rxMessage.len + MAVLINK_NUM_NON_PAYLOAD_BYTES);
+
+				// Latch the groundstation system and component ID if we haven't yet. We exclude the
+				// combination of systemid:3/compid:D, because that's the combo used by the 3DR radios.
+				if (!groundStationSystemId && !groundStationComponentId &&
+				    (rxMessage.sysid != '3' && rxMessage.compid != 'D')) {
+					groundStationSystemId = rxMessage.sysid;
+					groundStationComponentId = rxMessage.compid;
+				}
+
+	                        // If the message is from the groundstation, update the received time
+	                        if (rxMessage.sysid == groundStationSystemId &&
+	                            rxMessage.compid == groundStationComponentId) {
+	                            gcsLastTimeSeen = nodeSystemTime;
+	                        }
+
+				switch(rxMessage.msgid) {
+
+					// Check for commands like write data to EEPROM
+					case MAVLINK_MSG_ID_COMMAND_LONG: {
+						mavlink_command_long_t mavCommand;
+						mavlink_msg_command_long_decode(&rxMessage, &mavCommand);
+						MavLinkReceiveCommandLong(&mavCommand);
+					} break;
+
+					case MAVLINK_MSG_ID_SET_MODE: {
+	                                        mavlink_set_mode_t modeMessage;
+	                                        mavlink_msg_set_mode_decode(&rxMessage, &modeMessage);
+	                                        MavLinkReceiveSetMode(&modeMessage);
+					} break;
+
+					// Check for manual commands via Joystick from QGC.
+					case MAVLINK_MSG_ID_MANUAL_CONTROL: {
+						mavlink_manual_control_t manualControl;
+						mavlink_msg_manual_control_decode(&rxMessage, &manualControl);
+						MavLinkReceiveManualControl(&manualControl);
+					} break;
+
+					// If we are not doing any mission protocol operations, record the size of the incoming mission
+					// list and transition into the write missions state machine loop.
+					case MAVLINK_MSG_ID_MISSION_COUNT: {
+						uint8_t mavlinkNewMissionListSize = mavlink_msg_mission_count_get_count(&rxMessage);
+						MavLinkEvaluateMissionState(MISSION_EVENT_COUNT_RECEIVED, &mavlinkNewMissionListSize);
+						processedMissionMessage = true;
+					} break;
+
+					// Handle receiving a mission.
+					case MAVLINK_MSG_ID_MISSION_ITEM: {
+						mavlink_mission_item_t currentMission;
+						mavlink_msg_mission_item_decode(&rxMessage, &currentMission);
+						MavLinkEvaluateMissionState(MISSION_EVENT_ITEM_RECEIVED, &currentMission);
+						processedMissionMessage = true;
+					} break;
+
+					// Responding to a mission request entails moving into the first active state and scheduling a MISSION_COUNT message.
+					// Will also schedule a transmission of a GPS_ORIGIN message. This is used for translating global to local coordinates
+					// in QGC.
+					case MAVLINK_MSG_ID_MISSION_REQUEST_LIST: {
+						MavLinkSendGpsGlobalOrigin();
+						MavLinkEvaluateMissionState(MISSION_EVENT_REQUEST_LIST_RECEIVED, NULL);
+						processedMissionMessage = true;
+					} break;
+
+					// When a mission request message is received, respond with that mission information from the MissionManager
+					case MAVLINK_MSG_ID_MISSION_REQUEST: {
+						uint8_t receivedMissionIndex = mavlink_msg_mission_request_get_seq(&rxMessage);
+						MavLinkEvaluateMissionState(MISSION_EVENT_REQUEST_RECEIVED, &receivedMissionIndex);
+						processedMissionMessage = true;
+					} break;
+
+					// Allow for clearing waypoints. Here we respond simply with an ACK message if we successfully
+					// cleared the mission list.
+					case MAVLINK_MSG_ID_MISSION_CLEAR_ALL:
+						MavLinkEvaluateMissionState(MISSION_EVENT_CLEAR_ALL_RECEIVED, NULL);
+						processedMissionMessage = true;
+					break;
+
+					// Allow for the groundstation to set the current mission. This requires a WAYPOINT_CURRENT response message agreeing with the received current message index.
+					case MAVLINK_MSG_ID_MISSION_SET_CURRENT: {
+						uint8_t newCurrentMission = mavlink_msg_mission_set_current_get_seq(&rxMessage);
+						MavLinkEvaluateMissionState(MISSION_EVENT_SET_CURRENT_RECEIVED, &newCurrentMission);
+						processedMissionMessage = true;
+					} break;
+
+					case MAVLINK_MSG_ID_MISSION_ACK: {
+						uint8_t type = mavlink_msg_mission_ack_get_type(&rxMessage);
+						MavLinkEvaluateMissionState(MISSION_EVENT_ACK_RECEIVED, &type);
+						processedMissionMessage = true;
+					} break;
+
+					// If they're requesting a list of all parameters, call a separate function that'll track the state and transmit the necessary messages.
+					// This reason that this is an external function is so that it can be run separately at 20Hz.
+					case MAVLINK_MSG_ID_PARAM_REQUEST_LIST: {
+						MavLinkEvaluateParameterState(PARAM_EVENT_REQUEST_LIST_RECEIVED, NULL);
+						processedParameterMessage = true;
+					} break;
+
+					// If a request comes for a single parameter then set that to be the current parameter and move into the proper state.
+					case MAVLINK_MSG_ID_PARAM_REQUEST_READ: {
+						uint16_t currentParameter = mavlink_msg_param_request_read_get_param_index(&rxMessage);
+						MavLinkEvaluateParameterState(PARAM_EVENT_REQUEST_READ_RECEIVED, &currentParameter);
+						processedParameterMessage = true;
+					} break;
+
+					case MAVLINK_MSG_ID_PARAM_SET: {
+						mavlink_param_set_t p;
+						mavlink_msg_param_set_decode(&rxMessage, &p);
+						MavLinkEvaluateParameterState(PARAM_EVENT_SET_RECEIVED, &p);
+						processedParameterMessage = true;
+					} break;
+
+					// Handle the log download protocol for retrieving the onboard flash logs.
+					case MAVLINK_MSG_ID_LOG_REQUEST_LIST: {
+						mavlink_log_request_list_t request;
+						mavlink_msg_log_request_list_decode(&rxMessage, &request);
+						MavLinkReceiveLogRequestList(&request);
+					} break;
+
+					case MAVLINK_MSG_ID_LOG_REQUEST_DATA: {
+						mavlink_log_request_data_t request;
+						mavlink_msg_log_request_data_decode(&rxMessage, &request);
+						MavLinkReceiveLogRequestData(&request);
+					} break;
+
+					case MAVLINK_MSG_ID_LOG_REQUEST_END:
+						logTransfer.listActive = false;
+						logTransfer.dataActive = false;
+					break;
+
+					case MAVLINK_MSG_ID_LOG_ERASE:
+						logTransfer.listActive = false;
+						logTransfer.dataActive = false;
+						FlashLogEraseAll();
+					break;
+
+					case MAVLINK_MSG_ID_RADIO_STATUS:
+						mavlink_msg_radio_status_decode(&rxMessage, &radioStatus);
+					break;
+
+					case MAVLINK_MSG_ID_TIMESYNC: {
+						mavlink_timesync_t timesync;
+						mavlink_msg_timesync_decode(&rxMessage, &timesync);
+						MavLinkReceiveTimesync(MAVLINK_CHAN_GROUNDSTATION, &timesync);
+					} break;
+
+	                                default:
+	                                    break;
+				}
 			}
 
-                        // If the message is from the groundstation, update the received time
-                        if (rxMessage.sysid == groundStationSystemId &&
-                            rxMessage.compid == groundStationComponentId) {
-                            gcsLastTimeSeen = nodeSystemTime;
-                        }
+	                // Update our count of message failures. The `packet_rx_drop_count` is a local value
+	                // and will be 0 or 1 depending on if the character decoded successfully.
+	                MavlinkStatsRecordRxErrors(MAVLINK_CHAN_GROUNDSTATION, status.packet_rx_drop_count);
+		}
+		Uart1ReleaseSpan(length);
+	}
 
-			switch(rxMessage.msgid) {
-
-				// Check for commands like write data to EEPROM
-				case MAVLINK_MSG_ID_COMMAND_LONG: {
-					mavlink_command_long_t mavCommand;
-					mavlink_msg_command_long_decode(&rxMessage, &mavCommand);
-					MavLinkReceiveCommandLong(&mavCommand);
-				} break;
-
-				case MAVLINK_MSG_ID_SET_MODE: {
-                                        mavlink_set_mode_t modeMessage;
-                                        mavlink_msg_set_mode_decode(&rxMessage, &modeMessage);
-                                        MavLinkReceiveSetMode(&modeMessage);
-				} break;
-
-				// Check for manual commands via Joystick from QGC.
-				case MAVLINK_MSG_ID_MANUAL_CONTROL: {
-					mavlink_manual_control_t manualControl;
-					mavlink_msg_manual_control_decode(&rxMessage, &manualControl);
-					MavLinkReceiveManualControl(&manualControl);
-				} break;
-
-				// If we are not doing any mission protocol operations, record the size of the incoming mission
-				// list and transition into the write missions state machine loop.
-				case MAVLINK_MSG_ID_MISSION_COUNT: {
-					uint8_t mavlinkNewMissionListSize = mavlink_msg_mission_count_get_count(&rxMessage);
-					MavLinkEvaluateMissionState(MISSION_EVENT_COUNT_RECEIVED, &mavlinkNewMissionListSize);
-					processedMissionMessage = true;
-				} break;
-
-				// Handle receiving a mission.
-				case MAVLINK_MSG_ID_MISSION_ITEM: {
-					mavlink_mission_item_t currentMission;
-					mavlink_msg_mission_item_decode(&rxMessage, &currentMission);
-					MavLinkEvaluateMissionState(MISSION_EVENT_ITEM_RECEIVED, &currentMission);
-					processedMissionMessage = true;
-				} break;
-
-				// Responding to a mission request entails moving into the first active state and scheduling a MISSION_COUNT message.
-				// Will also schedule a transmission of a GPS_ORIGIN message. This is used for translating global to local coordinates
-				// in QGC.
-				case MAVLINK_MSG_ID_MISSION_REQUEST_LIST: {
-					MavLinkSendGpsGlobalOrigin();
-					MavLinkEvaluateMissionState(MISSION_EVENT_REQUEST_LIST_RECEIVED, NULL);
-					processedMissionMessage = true;
-				} break;
-
-				// When a mission request message is received, respond with that mission information from the MissionManager
-				case MAVLINK_MSG_ID_MISSION_REQUEST: {
-					uint8_t receivedMissionIndex = mavlink_msg_mission_request_get_seq(&rxMessage);
-					MavLinkEvaluateMissionState(MISSION_EVENT_REQUEST_RECEIVED, &receivedMissionIndex);
-					processedMissionMessage = true;
-				} break;
-
-				// Allow for clearing waypoints. Here we respond simply with an ACK message if we successfully
-				// cleared the mission list.
-				case MAVLINK_MSG_ID_MISSION_CLEAR_ALL:
-					MavLinkEvaluateMissionState(MISSION_EVENT_CLEAR_ALL_RECEIVED, NULL);
-					processedMissionMessage = true;
-				break;
-
-				// Allow for the groundstation to set the current mission. This requires a WAYPOINT_CURRENT response message agreeing with the received current message index.
-				case MAVLINK_MSG_ID_MISSION_SET_CURRENT: {
-					uint8_t newCurrentMission = mavlink_msg_mission_set_current_get_seq(&rxMessage);
-					MavLinkEvaluateMissionState(MISSION_EVENT_SET_CURRENT_RECEIVED, &newCurrentMission);
-					processedMissionMessage = true;
-				} break;
-
-				case MAVLINK_MSG_ID_MISSION_ACK: {
-					uint8_t type = mavlink_msg_mission_ack_get_type(&rxMessage);
-					MavLinkEvaluateMissionState(MISSION_EVENT_ACK_RECEIVED, &type);
-					processedMissionMessage = true;
-				} break;
-
-				// If they're requesting a list of all parameters, call a separate function that'll track the state and transmit the necessary messages.
-				// This reason that this is an external function is so that it can be run separately at 20Hz.
-				case MAVLINK_MSG_ID_PARAM_REQUEST_LIST: {
-					MavLinkEvaluateParameterState(PARAM_EVENT_REQUEST_LIST_RECEIVED, NULL);
-					processedParameterMessage = true;
-				} break;
-
-				// If a request comes for a single parameter then set that to be the current parameter and move into the proper state.
-				case MAVLINK_MSG_ID_PARAM_REQUEST_READ: {
-					uint16_t currentParameter = mavlink_msg_param_request_read_get_param_index(&rxMessage);
-					MavLinkEvaluateParameterState(PARAM_EVENT_REQUEST_READ_RECEIVED, &currentParameter);
-					processedParameterMessage = true;
-				} break;
-
-				case MAVLINK_MSG_ID_PARAM_SET: {
-					mavlink_param_set_t p;
-					mavlink_msg_param_set_decode(&rxMessage, &p);
-					MavLinkEvaluateParameterState(PARAM_EVENT_SET_RECEIVED, &p);
-					processedParameterMessage = true;
-				} break;
-
-				case MAVLINK_MSG_ID_RADIO_STATUS:
-					mavlink_msg_radio_status_decode(&rxMessage, &radioStatus);
-				break;
-
-                                default:
-                                    break;
+	// The datalogger only takes part in time synchronization, so everything else it sends is
+	// ignored.
+	while ((length = Uart2ReadSpan(&span))) {
+		for (i = 0; i < length; ++i) {
+			if (mavlink_parse_char(MAVLINK_COMM_1, span[i], &rxMessage, &status)) {
+				MavlinkStatsRecordRx(MAVLINK_CHAN_DATALOGGER, rxMessage.sysid, rxMessage.msgid,
+				                     rxMessage.seq, rxMessage.len + MAVLINK_NUM_NON_PAYLOAD_BYTES);
+
+				if (rxMessage.msgid == MAVLINK_MSG_ID_TIMESYNC) {
+					mavlink_timesync_t timesync;
+					mavlink_msg_timesync_decode(&rxMessage, &timesync);
+					MavLinkReceiveTimesync(MAVLINK_CHAN_DATALOGGER, &timesync);
+				}
 			}
+			MavlinkStatsRecordRxErrors(MAVLINK_CHAN_DATALOGGER, status.packet_rx_drop_count);
 		}
-
-                // Update our stats of both messages received and number of message failures.
-                // The `packet_rx_success_count` is a global and persistent count of successfully-
-                // received messages, while `packet_rx_drop_count` is a local value and will be 0 or
-                // 1 depending on if the character decoded successfully.
-                mavLinkMessagesReceived = status.packet_rx_success_count;
-                mavLinkMessagesFailedParsing += status.packet_rx_drop_count;
-        }
+		Uart2ReleaseSpan(length);
+	}
 
 	// Now if no mission messages were received, trigger the Mission Manager anyways with a NONE
 	// event.
@@ -2087,11 +2501,319 @@ void MavLinkTransmitGroundstation(void)
 				MavLinkSendMainPower(MAVLINK_CHAN_GROUNDSTATION);
 			break;
 
+			case MAVLINK_MSG_ID_TIMESYNC:
+				MavLinkSendTimesyncRequest(MAVLINK_CHAN_GROUNDSTATION);
+			break;
+
+			case MAVLINK_MSG_ID_NAV_SUMMARY:
+				MavLinkSendNavSummary();
+			break;
+
 			default: {
 
 			} break;
 		}
 	}
+
+	// Also continue any active log download or statistics request.
+	MavLinkTransmitLogTransfer();
+	MavLinkTransmitStatsTransfer();
+
+	LinkUsageTick(&linkUsage[MAVLINK_CHAN_GROUNDSTATION], Uart1GetTxBytes(), Uart1GetRxBytes(),
+	              Uart1GetTxQueueLength());
+}
+
+/**
+ * Transmits the statistics for an entry in the MAVLink statistics message table.
+ * @param channel Which channel to transmit over, see SeaslugMavlinkChannel enum.
+ * @param index The index into the message table.
+ */
+void MavLinkSendMessageStats(uint8_t channel, uint8_t index)
+{
+    MavlinkMessageStats stats;
+    if (!MavlinkStatsGetMessage(index, &stats)) {
+        return;
+    }
+
+    mavlink_msg_message_stats_pack_chan(mavlink_system.sysid, mavlink_system.compid, channel,
+        &txMessage,
+        MavLinkTimeBootMs(),
+        stats.msgid, index, MavlinkStatsGetMessageCount(),
+        stats.rxCount, stats.rxBytes,
+        stats.txCount[MAVLINK_CHAN_GROUNDSTATION], stats.txBytes[MAVLINK_CHAN_GROUNDSTATION],
+        stats.txCount[MAVLINK_CHAN_DATALOGGER], stats.txBytes[MAVLINK_CHAN_DATALOGGER],
+        stats.txDropped[MAVLINK_CHAN_GROUNDSTATION], stats.txDropped[MAVLINK_CHAN_DATALOGGER]);
+    len = mavlink_msg_to_send_buffer(buf, &txMessage);
+
+    if (channel == MAVLINK_CHAN_DATALOGGER) {
+        MavLinkWriteDatalogger(buf, len);
+    } else {
+        MavLinkWriteGroundstation(buf, len);
+    }
+}
+
+/**
+ * Transmits the statistics for an entry in the MAVLink statistics system table.
+ * @param channel Which channel to transmit over, see SeaslugMavlinkChannel enum.
+ * @param index The index into the system table.
+ */
+void MavLinkSendLinkStats(uint8_t channel, uint8_t index)
+{
+    MavlinkSystemStats stats;
+    if (!MavlinkStatsGetSystem(index, &stats)) {
+        return;
+    }
+
+    mavlink_msg_link_stats_pack_chan(mavlink_system.sysid, mavlink_system.compid, channel,
+        &txMessage,
+        MavLinkTimeBootMs(),
+        stats.channel, stats.sysid, index, MavlinkStatsGetSystemCount(),
+        stats.received, stats.lost,
+        MavlinkStatsGetRxErrors(stats.channel), MavlinkStatsGetUntracked());
+    len = mavlink_msg_to_send_buffer(buf, &txMessage);
+
+    if (channel == MAVLINK_CHAN_DATALOGGER) {
+        MavLinkWriteDatalogger(buf, len);
+    } else {
+        MavLinkWriteGroundstation(buf, len);
+    }
+}
+
+/**
+ * Converts a time from PrimaryNodeGetTimestamp()'s clock into microseconds, saturating.
+ */
+static uint32_t TimestampToUs(uint32_t ticks)
+{
+    return (ticks < UINT32_MAX / 32 * 5) ? PRIMARY_NODE_TIMESTAMP_TO_US(ticks) : UINT32_MAX;
+}
+
+/**
+ * Transmits the latency statistics for a single stage of the sensor pipeline.
+ * @param channel Which channel to transmit over, see SeaslugMavlinkChannel enum.
+ * @param stage The stage, see LatencyStage.
+ */
+void MavLinkSendLatencyStats(uint8_t channel, uint8_t stage)
+{
+    LatencySummary summary;
+    LatencyGetSummary((LatencyStage)stage, &summary);
+
+    mavlink_msg_latency_stats_pack_chan(mavlink_system.sysid, mavlink_system.compid, channel,
+        &txMessage,
+        MavLinkTimeBootMs(),
+        stage, LATENCY_STAGE_COUNT,
+        TimestampToUs(summary.p50), TimestampToUs(summary.p90),
+        TimestampToUs(summary.p99), TimestampToUs(summary.max),
+        summary.samples);
+    len = mavlink_msg_to_send_buffer(buf, &txMessage);
+
+    if (channel == MAVLINK_CHAN_DATALOGGER) {
+        MavLinkWriteDatalogger(buf, len);
+    } else {
+        MavLinkWriteGroundstation(buf, len);
+    }
+}
+
+/**
+ * Transmits the arrival statistics for a single sensor.
+ * @param channel Which channel to transmit over, see SeaslugMavlinkChannel enum.
+ * @param sensor The sensor, see SensorId.
+ */
+void MavLinkSendSensorStats(uint8_t channel, uint8_t sensor)
+{
+    const ArrivalStats *stats = &sensorArrivals[sensor];
+
+    // The time since the last arrival is in ms, as it keeps growing while a sensor is silent.
+    uint32_t sinceLast = ArrivalStatsSinceLast(stats, PrimaryNodeGetTimestamp());
+    if (sinceLast != UINT32_MAX) {
+        sinceLast = (uint32_t)((uint64_t)sinceLast * 32 / 5000);
+    }
+
+    uint8_t status = 0;
+    if (sensorAvailability[sensor].enabled) {
+        status = sensorAvailability[sensor].active ? 3 : 1;
+    }
+
+    // The name field is copied whole, so pad the name out.
+    char name[MAVLINK_MSG_SENSOR_STATS_FIELD_NAME_LEN] = {0};
+    strncpy(name, sensorDescriptors[sensor].name, sizeof(name));
+
+    mavlink_msg_sensor_stats_pack_chan(mavlink_system.sysid, mavlink_system.compid, channel,
+        &txMessage,
+        MavLinkTimeBootMs(),
+        TimestampToUs(ArrivalStatsMean(stats)), TimestampToUs(stats->max),
+        TimestampToUs(ArrivalStatsJitter(stats)), sinceLast, stats->arrivals, stats->dropouts,
+        sensor, SENSOR_COUNT, status, name);
+    len = mavlink_msg_to_send_buffer(buf, &txMessage);
+
+    if (channel == MAVLINK_CHAN_DATALOGGER) {
+        MavLinkWriteDatalogger(buf, len);
+    } else {
+        MavLinkWriteGroundstation(buf, len);
+    }
+}
+
+/**
+ * Transmits a TIMESYNC message.
+ * @param channel Which channel to transmit over, see SeaslugMavlinkChannel enum.
+ * @param tc1 The time the request was received at in nanoseconds, or 0 if this is a request.
+ * @param ts1 The time the request was sent at in nanoseconds.
+ */
+void MavLinkSendTimesync(uint8_t channel, int64_t tc1, int64_t ts1)
+{
+    mavlink_msg_timesync_pack_chan(mavlink_system.sysid, mavlink_system.compid, channel,
+        &txMessage, tc1, ts1);
+    len = mavlink_msg_to_send_buffer(buf, &txMessage);
+
+    if (channel == MAVLINK_CHAN_DATALOGGER) {
+        MavLinkWriteDatalogger(buf, len);
+    } else {
+        MavLinkWriteGroundstation(buf, len);
+    }
+}
+
+/**
+ * Sends a TIMESYNC request stamped with the current time, replacing any outstanding request.
+ * @param channel Which channel to transmit over, see SeaslugMavlinkChannel enum.
+ */
+void MavLinkSendTimesyncRequest(uint8_t channel)
+{
+    timeSyncRequest[channel] = (int64_t)PrimaryNodeGetTimeUs() * 1000;
+    MavLinkSendTimesync(channel, 0, timeSyncRequest[channel]);
+}
+
+/**
+ * Transmits the state of the clock synchronization for a link to the datalogger.
+ * @param link The link to report on, see SeaslugMavlinkChannel enum.
+ */
+void MavLinkSendTimesyncStatus(uint8_t link)
+{
+    const TimeSyncEstimator *ts = &timeSync[link];
+    const uint64_t now = PrimaryNodeGetTimeUs();
+    const int64_t remote = TimeSyncToRemote(ts, (int64_t)now * 1000);
+    const int64_t offset = remote - (int64_t)now * 1000;
+
+    mavlink_msg_timesync_status_pack_chan(mavlink_system.sysid, mavlink_system.compid, MAVLINK_CHAN_DATALOGGER,
+        &txMessage,
+        now, offset, TimeSyncIsValid(ts) ? (uint64_t)(remote / 1000) : 0, ts->skew * 1e6f, (uint32_t)(ts->rtt / 1000), ts->rejected, ts->samples,
+        link, TimeSyncIsValid(ts));
+    len = mavlink_msg_to_send_buffer(buf, &txMessage);
+    MavLinkWriteDatalogger(buf, len);
+}
+
+/**
+ * Handles a TIMESYNC message. Requests are answered immediately with the current time, while
+ * responses to our last request update the estimate for that link.
+ * @param channel The channel the message was received on, see SeaslugMavlinkChannel enum.
+ * @param msg The received message.
+ */
+void MavLinkReceiveTimesync(uint8_t channel, const mavlink_timesync_t *msg)
+{
+    const int64_t now = (int64_t)PrimaryNodeGetTimeUs() * 1000;
+
+    if (msg->tc1 == 0) {
+        MavLinkSendTimesync(channel, now, msg->ts1);
+    } else if (timeSyncRequest[channel] && msg->ts1 == timeSyncRequest[channel]) {
+        TimeSyncUpdate(&timeSync[channel], msg->ts1, msg->tc1, now);
+        // Only the first response is used, in case there are several systems on the link.
+        timeSyncRequest[channel] = 0;
+    }
+}
+
+/**
+ * Continues sending the MAVLink statistics to the groundstation if they were requested, one
+ * message every STATS_TRANSFER_PERIOD calls. Should be called every timestep.
+ */
+void MavLinkTransmitStatsTransfer(void)
+{
+    if (!statsTransfer.active || ++statsTransfer.timestepCounter < STATS_TRANSFER_PERIOD) {
+        return;
+    }
+    statsTransfer.timestepCounter = 0;
+
+    if (statsTransfer.messageIndex < MavlinkStatsGetMessageCount()) {
+        MavLinkSendMessageStats(MAVLINK_CHAN_GROUNDSTATION, statsTransfer.messageIndex++);
+    } else if (statsTransfer.systemIndex < MavlinkStatsGetSystemCount()) {
+        MavLinkSendLinkStats(MAVLINK_CHAN_GROUNDSTATION, statsTransfer.systemIndex++);
+    } else if (statsTransfer.latencyStage < LATENCY_STAGE_COUNT) {
+        MavLinkSendLatencyStats(MAVLINK_CHAN_GROUNDSTATION, statsTransfer.latencyStage++);
+    } else if (statsTransfer.sensorIndex < SENSOR_COUNT) {
+        MavLinkSendSensorStats(MAVLINK_CHAN_GROUNDSTATION, statsTransfer.sensorIndex++);
+    } else {
+        statsTransfer.active = false;
+    }
+}
+
+/**
+ * Continues any active log download. LOG_ENTRY messages are sent one per call, while a LOG_DATA
+ * message is sent every logDataPeriod calls. A message that can't be queued is sent again on the
+ * next call, so the download never has holes. Logging to flash is paused while LOG_DATA is being
+ * sent. Should be called every timestep.
+ */
+void MavLinkTransmitLogTransfer(void)
+{
+    if (logTransfer.listActive) {
+        const uint8_t logCount = FlashLogGetLogCount();
+        uint16_t lastId = 0;
+        if (logCount > 0) {
+            FlashLogGetLogInfo(logCount - 1, &lastId, NULL);
+        }
+
+        // Find the next log in the requested range and send its LOG_ENTRY.
+        while (logTransfer.listIndex < logCount) {
+            uint16_t id;
+            uint32_t size;
+            FlashLogGetLogInfo(logTransfer.listIndex, &id, &size);
+            if (id >= logTransfer.listStart && id <= logTransfer.listEnd) {
+                mavlink_msg_log_entry_pack(mavlink_system.sysid, mavlink_system.compid, &txMessage,
+                                           id, logCount, lastId, 0, size);
+                len = mavlink_msg_to_send_buffer(buf, &txMessage);
+                if (MavLinkWriteGroundstation(buf, len)) {
+                    ++logTransfer.listIndex;
+                }
+                return;
+            }
+            ++logTransfer.listIndex;
+        }
+
+        // If there are no logs, the protocol expects a single empty LOG_ENTRY.
+        if (logCount == 0) {
+            mavlink_msg_log_entry_pack(mavlink_system.sysid, mavlink_system.compid, &txMessage,
+                                       0, 0, 0, 0, 0);
+            len = mavlink_msg_to_send_buffer(buf, &txMessage);
+            if (!MavLinkWriteGroundstation(buf, len)) {
+                return;
+            }
+        }
+        logTransfer.listActive = false;
+    }
+
+    if (logTransfer.dataActive && ++logTransfer.timestepCounter >= logDataPeriod) {
+        uint8_t data[MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN] = {};
+        uint32_t count = logTransfer.dataEnd - logTransfer.dataOffset;
+        if (count > MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN) {
+            count = MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
+        }
+        count = FlashLogRead(logTransfer.dataId, logTransfer.dataOffset, data, (uint16_t)count);
+
+        // A LOG_DATA with a count less than the maximum (including 0) marks the end of the log.
+        mavlink_msg_log_data_pack(mavlink_system.sysid, mavlink_system.compid, &txMessage,
+                                  logTransfer.dataId, logTransfer.dataOffset, (uint8_t)count, data);
+        len = mavlink_msg_to_send_buffer(buf, &txMessage);
+
+        // If the bulk lane is full, try the same chunk again on the next call.
+        if (!MavLinkWriteGroundstation(buf, len)) {
+            logTransfer.timestepCounter = logDataPeriod - 1;
+            return;
+        }
+        logTransfer.timestepCounter = 0;
+        logTransfer.dataOffset += count;
+        if (count < MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN || logTransfer.dataOffset >= logTransfer.dataEnd) {
+            logTransfer.dataActive = false;
+        }
+    }
+
+    // Resume logging once LOG_DATA is done, however it ended.
+    FlashLogSetPaused(logTransfer.dataActive);
 }
 
 /**
@@ -2100,6 +2822,12 @@ void MavLinkTransmitGroundstation(void)
  */
 void MavLinkTransmitDatalogger(void)
 {
+    static uint8_t dataloggerMessageStatsIndex = 0;
+    static uint8_t dataloggerLinkStatsIndex = 0;
+    static uint8_t dataloggerLatencyStage = 0;
+    static uint8_t dataloggerSensorIndex = 0;
+    static uint8_t dataloggerTimesyncLink = MAVLINK_CHAN_GROUNDSTATION;
+
     uint8_t msgs[DATALOGGER_SCHEDULE_NUM_MSGS];
     uint8_t count = GetMessagesForTimestep(&dataloggerMavlinkSchedule, msgs);
     int i;
@@ -2129,6 +2857,38 @@ void MavLinkTransmitDatalogger(void)
             case MAVLINK_MSG_ID_MAIN_POWER:
                 MavLinkSendMainPower(MAVLINK_CHAN_DATALOGGER);
 			break;
+            case MAVLINK_MSG_ID_MESSAGE_STATS:
+                // Cycle through the whole table, one entry at a time.
+                if (dataloggerMessageStatsIndex >= MavlinkStatsGetMessageCount()) {
+                    dataloggerMessageStatsIndex = 0;
+                }
+                MavLinkSendMessageStats(MAVLINK_CHAN_DATALOGGER, dataloggerMessageStatsIndex++);
+                break;
+            case MAVLINK_MSG_ID_LINK_STATS:
+                if (dataloggerLinkStatsIndex >= MavlinkStatsGetSystemCount()) {
+                    dataloggerLinkStatsIndex = 0;
+                }
+                MavLinkSendLinkStats(MAVLINK_CHAN_DATALOGGER, dataloggerLinkStatsIndex++);
+                break;
+            case MAVLINK_MSG_ID_LATENCY_STATS:
+                if (dataloggerLatencyStage >= LATENCY_STAGE_COUNT) {
+                    dataloggerLatencyStage = 0;
+                }
+                MavLinkSendLatencyStats(MAVLINK_CHAN_DATALOGGER, dataloggerLatencyStage++);
+                break;
+            case MAVLINK_MSG_ID_SENSOR_STATS:
+                if (dataloggerSensorIndex >= SENSOR_COUNT) {
+                    dataloggerSensorIndex = 0;
+                }
+                MavLinkSendSensorStats(MAVLINK_CHAN_DATALOGGER, dataloggerSensorIndex++);
+                break;
+            case MAVLINK_MSG_ID_TIMESYNC:
+                MavLinkSendTimesyncRequest(MAVLINK_CHAN_DATALOGGER);
+                break;
+            case MAVLINK_MSG_ID_TIMESYNC_STATUS:
+                MavLinkSendTimesyncStatus(dataloggerTimesyncLink);
+                dataloggerTimesyncLink = !dataloggerTimesyncLink;
+                break;
             default:
             break;
          }
@@ -2136,6 +2896,9 @@ void MavLinkTransmitDatalogger(void)
 
     // Always attempt to send the datalogger parameters. This simplifies the logic somewhat.
     MavLinkSendDataloggerParameters(false);
+
+    LinkUsageTick(&linkUsage[MAVLINK_CHAN_DATALOGGER], Uart2GetTxBytes(), Uart2GetRxBytes(),
+                  Uart2GetTxQueueLength());
 }
 
 /**
@@ -2158,11 +2921,11 @@ void MavLinkSendDataloggerParameters(bool reset)
         mavlink_msg_param_value_with_time_pack_chan(
             mavlink_system.sysid, mavlink_system.compid, MAVLINK_CHAN_DATALOGGER,
             &txMessage,
-            nodeSystemTime * 10,
+            MavLinkTimeBootMs(),
             onboardParameters[pid].name, param_value, onboardParameters[pid].dataType,
             PARAMETERS_TOTAL, pid);
         len = mavlink_msg_to_send_buffer(buf, &txMessage);
-        Uart2WriteData(buf, (uint8_t)len);
+        MavLinkWriteDatalogger(buf, len);
 
         // Track how many times this message had been sent.
         ++count;
@@ -2178,11 +2941,26 @@ void MavLinkSendDataloggerParameters(bool reset)
 
 uint8_t MavLinkGetChannelUsage(uint8_t channel)
 {
+    uint16_t capacity;
     if (channel == MAVLINK_CHAN_DATALOGGER) {
-        return dataloggerChanUsage;
+        if (!LinkUsageValid(&linkUsage[channel])) {
+            return dataloggerChanUsage;
+        }
+        capacity = DATALOGGER_BYTES_PER_SECOND;
     } else if (channel == MAVLINK_CHAN_GROUNDSTATION) {
-        return groundstationChanUsage;
+        if (!LinkUsageValid(&linkUsage[channel])) {
+            return groundstationChanUsage;
+        }
+        capacity = GROUNDSTATION_BYTES_PER_SECOND;
     } else {
         return 0;
     }
+
+    const uint32_t usage = (uint32_t)LinkUsageTxRate(&linkUsage[channel]) * 100 / capacity;
+    return (usage < UINT8_MAX) ? (uint8_t)usage : UINT8_MAX;
+}
+
+const LinkUsage *MavLinkGetLinkUsage(uint8_t channel)
+{
+    return (channel <= MAVLINK_CHAN_DATALOGGER) ? &linkUsage[channel] : NULL;
 }
\ No newline at end of file
@@ -32,12 +32,23 @@
 #include "controller.h"
 extern InternalVariables controllerVars; // Track a bunch of internal variables from the controller.
 
+#include "Latency.h"
+extern LatencyStamp controllerGpsLatency; // The latency of the GPS data used to calculate controllerVars.
+
+#include "LinkUsage.h"
+
 // Set separate MAVLink channels for the groundstation and the datalogger
 enum SeaslugMavlinkChannel {
     MAVLINK_CHAN_GROUNDSTATION = 0,
     MAVLINK_CHAN_DATALOGGER
 };
 
+// The sets of messages that can be scheduled for the groundstation, see MavLinkSetGroundstationMode().
+typedef enum {
+    MAVLINK_GCS_MODE_FULL = 0, // All of the standard and SeaSlug messages.
+    MAVLINK_GCS_MODE_COMPACT   // A 5Hz NAV_SUMMARY in place of the others, for low-bandwidth links.
+} MavlinkGroundstationMode;
+
 /**
  * Initialize MAVLink transmission. This just sets up the MAVLink scheduler with the basic
  * repeatedly-transmit messages.
@@ -45,11 +56,33 @@ enum SeaslugMavlinkChannel {
 void MavLinkInit(void);
 
 /**
- * Returns the percent usage of the given channel.
+ * Switches which messages are scheduled for the groundstation. In the compact mode only HEARTBEAT,
+ * SYS_STATUS, and TIMESYNC are sent at 1Hz alongside a 5Hz NAV_SUMMARY, which the mavlink_router
+ * can expand back into the standard messages for QGC. This can be called before MavLinkInit(), such
+ * as when the parameters are loaded, and takes effect once it's called.
+ * @param mode The new mode, see MavlinkGroundstationMode. Unknown modes are ignored.
+ */
+void MavLinkSetGroundstationMode(uint8_t mode);
+
+/**
+ * @return The current groundstation mode, see MavlinkGroundstationMode.
+ */
+uint8_t MavLinkGetGroundstationMode(void);
+
+/**
+ * Returns the percent usage of the given channel. This is the measured transmit throughput as a
+ * percentage of what the channel can carry, or the scheduled usage until it's been measured.
  * @param channel The channel selected, see enum SeaslugMavlinkChannel
  */
 uint8_t MavLinkGetChannelUsage(uint8_t channel);
 
+/**
+ * Returns the measured throughput of the given channel's UART.
+ * @param channel The channel selected, see enum SeaslugMavlinkChannel
+ * @return The measurements, or NULL for an unknown channel.
+ */
+const LinkUsage *MavLinkGetLinkUsage(uint8_t channel);
+
 /**
  * This function creates a MAVLink heartbeat message with some basic parameters and
  * caches that message (along with its size) in the module-level variables declared
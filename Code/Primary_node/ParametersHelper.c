@@ -23,7 +23,8 @@ static const Parameter params[] = {
     {"L2+_TanInter", &tanIntercept, NULL, NULL, PARAMETERS_DATATYPE_REAL32},
     {"L2+_SwitchDist", &switchDistance, NULL, NULL, PARAMETERS_DATATYPE_REAL32},
     {"L2+_KPsiDot", &KPsiDot, NULL, NULL, PARAMETERS_DATATYPE_REAL32},
-    {"L2+_OffsetFix", &GpsOffsetCorrectionEnable, NULL, NULL, PARAMETERS_DATATYPE_UINT8}
+    {"L2+_OffsetFix", &GpsOffsetCorrectionEnable, NULL, NULL, PARAMETERS_DATATYPE_UINT8},
+    {"GcsCompact", NULL, (void(*)())MavLinkSetGroundstationMode, (void(*)())MavLinkGetGroundstationMode, PARAMETERS_DATATYPE_UINT8}
 };
 
 // Expose both the list of parameters and the total to the Parameters library.
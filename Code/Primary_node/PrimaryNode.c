@@ -1,6 +1,7 @@
 // C standard library includes
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 // Microchip standard library includes
 #include <xc.h>
@@ -19,11 +20,13 @@
 #include "Ecan1.h"
 #include "PrimaryNode.h"
 #include "DataStore.h"
+#include "FlashLog.h"
 #include "EcanSensors.h"
 #include "Rudder.h"
 #include "Actuators.h"
 #include "MissionManager.h"
 #include "Conversions.h"
+#include "Latency.h"
 
 // MATLAB-generate code includes
 #include "controller.h"
@@ -71,6 +74,9 @@ static struct {
 #define SAY_STATUS_COUNTER_LIMIT 3000
 uint16_t sayStatusCounter = 0;
 
+// How often the measured channel usage is reported to the groundstation, in units of 0.01s.
+#define CHANNEL_USAGE_COUNTER_LIMIT 6000
+
 // This is used to store sensor availability from the last sample time in order to trigger on
 // sensor availability changes.
 
@@ -98,6 +104,11 @@ static struct {
 // Store actuator commmands here. Used by the MAVLink code.
 ActuatorCommands currentCommands;
 
+// The number of Timer2 ticks counted before its last reset. Together with TMR2 this forms the
+// clock returned by PrimaryNodeGetTimestamp() and PrimaryNodeGetTimeUs(). This is 64-bits so that
+// it never wraps.
+static volatile uint64_t timer2Ticks = 0;
+
 // Set up DMA memory for the ADC. But with the scatter- gather mode enabled on the ADC, we reserve
 // an array for all 16 possible inputs, so we align to 32-byte boundaries instead.
 #ifdef __dsPIC33FJ128MC802__
@@ -120,6 +131,9 @@ int16_t ProcessManualThrottleCommand(int16_t tc);
 void ClearStateWhenErrors(void);
 void SendAudioStatusUpdate(void);
 void TransmitChannelUsage(void);
+uint32_t GetUartInterruptTicks(void);
+void CountBusyTime(uint32_t start, uint32_t startUartTicks);
+void UpdateCpuLoad(void);
 
 // Set processor configuration settings
 #ifdef __dsPIC33FJ128MC802__
@@ -167,7 +181,7 @@ int main(void)
     // Set the ID for the primary node.
     nodeId = CAN_NODE_PRIMARY_CONTROLLER;
 
-    // We aren't calculating CPU load for the primary controller
+    // The CPU load is unknown until it's first measured by UpdateCpuLoad().
     nodeCpuLoad = UINT8_MAX;
 
     // Initialize UART1 to 115200 for groundstation communications.
@@ -176,6 +190,10 @@ int main(void)
     // Initialize UART2 to 115200 for datalogger recording.
     Uart2Init(BAUD115200_BRG_REG);
 
+    // Time the UART interrupts for the CPU load.
+    Uart1SetTimestampSource(PrimaryNodeGetTimestamp);
+    Uart2SetTimestampSource(PrimaryNodeGetTimestamp);
+
     // Initialize the EEPROM for non-volatile data storage. DataStoreInit() also takes care of
     // initializing the onboard data store to the current parameter values so all subsequent calls
     // to DataStoreLoadAllParameters() should work.
@@ -183,8 +201,13 @@ int main(void)
         FATAL_ERROR();
     }
 
-    // Initialize ECAN1
+    // Rebuild the index of the logs stored in flash and start a new one for this boot.
+    FlashLogInit();
+
+    // Initialize ECAN1, timestamping all received messages for tracking the latency of sensor data.
     Ecan1Init(F_OSC, NODE_CAN_BAUD);
+    LatencyInit();
+    Ecan1SetTimestampSource(PrimaryNodeGetTimestamp);
 
     // Set up the ADC
     Adc1Init();
@@ -283,44 +306,44 @@ int main(void)
         }
 
         // Turn on the GPS indicator LED depending on the GPS status.
-        if (lastSensorAvailability.gpsEnabled && !sensorAvailability.gps.enabled) {
+        if (lastSensorAvailability.gpsEnabled && !sensorAvailability[SENSOR_GPS].enabled) {
             lastSensorAvailability.gpsEnabled = false;
-        } else if (!lastSensorAvailability.gpsEnabled && sensorAvailability.gps.enabled) {
+        } else if (!lastSensorAvailability.gpsEnabled && sensorAvailability[SENSOR_GPS].enabled) {
             lastSensorAvailability.gpsEnabled = true;
         }
 
         // Set the GPS invalid status bit when it's no longer active
-        if (lastSensorAvailability.gpsActive && !sensorAvailability.gps.active) {
+        if (lastSensorAvailability.gpsActive && !sensorAvailability[SENSOR_GPS].active) {
             nodeErrors |= PRIMARY_NODE_STATUS_GPS_INVALID;
             lastSensorAvailability.gpsActive = false;
-        } else if (!lastSensorAvailability.gpsActive && sensorAvailability.gps.active) {
+        } else if (!lastSensorAvailability.gpsActive && sensorAvailability[SENSOR_GPS].active) {
             nodeErrors &= ~PRIMARY_NODE_STATUS_GPS_INVALID;
             lastSensorAvailability.gpsActive = true;
         }
 
         // Set the GPS disconnected error bit when the GPS has been inactive for too long.
         if (nodeErrors & PRIMARY_NODE_RESET_GPS_DISCONNECTED) {
-            if (sensorAvailability.gps.active) {
+            if (sensorAvailability[SENSOR_GPS].active) {
                 nodeErrors &= ~PRIMARY_NODE_RESET_GPS_DISCONNECTED;
             }
         } else {
-            if (nodeSystemTime - sensorAvailability.gps.last_active >= GPS_DISCONNECTION_TIME) {
+            if (nodeSystemTime - sensorAvailability[SENSOR_GPS].last_active >= GPS_DISCONNECTION_TIME) {
                 nodeErrors |= PRIMARY_NODE_RESET_GPS_DISCONNECTED;
             }
         }
-        if (lastSensorAvailability.gpsActive && !sensorAvailability.gps.active) {
+        if (lastSensorAvailability.gpsActive && !sensorAvailability[SENSOR_GPS].active) {
             nodeErrors |= PRIMARY_NODE_STATUS_GPS_INVALID;
             lastSensorAvailability.gpsActive = false;
-        } else if (!lastSensorAvailability.gpsActive && sensorAvailability.gps.active) {
+        } else if (!lastSensorAvailability.gpsActive && sensorAvailability[SENSOR_GPS].active) {
             nodeErrors &= ~PRIMARY_NODE_STATUS_GPS_INVALID;
             lastSensorAvailability.gpsActive = true;
         }
 
         // If we ever lose contact with the ACS300, assume it's an e-stop condition.
-        if (lastSensorAvailability.propEnabled && !sensorAvailability.prop.enabled) {
+        if (lastSensorAvailability.propEnabled && !sensorAvailability[SENSOR_PROP].enabled) {
             nodeErrors |= PRIMARY_NODE_RESET_ESTOP_OR_ACS300_DISCON;
             lastSensorAvailability.propEnabled = false;
-        } else if (!lastSensorAvailability.propEnabled && sensorAvailability.prop.enabled) {
+        } else if (!lastSensorAvailability.propEnabled && sensorAvailability[SENSOR_PROP].enabled) {
             nodeErrors &= ~PRIMARY_NODE_RESET_ESTOP_OR_ACS300_DISCON;
             lastSensorAvailability.propEnabled = true;
         }
@@ -328,10 +351,10 @@ int main(void)
         // And if the rudder node disconnects, set the uncalibrated reset line. There's no need to perform
         // the inverse check when it becomes active again, because that will be done when the CAN message
         // is received.
-        if (lastSensorAvailability.rudderEnabled && !sensorAvailability.rudder.enabled) {
+        if (lastSensorAvailability.rudderEnabled && !sensorAvailability[SENSOR_RUDDER].enabled) {
             nodeErrors |= PRIMARY_NODE_RESET_RUDDER_DISCONNECTED;
             lastSensorAvailability.rudderEnabled = false;
-        } else if (!lastSensorAvailability.rudderEnabled && sensorAvailability.rudder.enabled) {
+        } else if (!lastSensorAvailability.rudderEnabled && sensorAvailability[SENSOR_RUDDER].enabled) {
             nodeErrors &= ~PRIMARY_NODE_RESET_RUDDER_DISCONNECTED;
             lastSensorAvailability.rudderEnabled = true;
         }
@@ -340,10 +363,10 @@ int main(void)
         // The RC node is considered enabled if it's broadcasting on the CAN bus. If the RC node
         // ever becomes disabled, we note it. This isn't worthy of a system error or triggering RTB,
         // but it should be noted in the logs.
-        if (lastSensorAvailability.rcNodeEnabled && !sensorAvailability.rcNode.enabled) {
+        if (lastSensorAvailability.rcNodeEnabled && !sensorAvailability[SENSOR_RC_NODE].enabled) {
             nodeStatus |= PRIMARY_NODE_STATUS_RC_NODE_DISCONNECTED;
             lastSensorAvailability.rcNodeEnabled = false;
-        } else if (!lastSensorAvailability.rcNodeEnabled && sensorAvailability.rcNode.enabled) {
+        } else if (!lastSensorAvailability.rcNodeEnabled && sensorAvailability[SENSOR_RC_NODE].enabled) {
             nodeStatus &= ~PRIMARY_NODE_STATUS_RC_NODE_DISCONNECTED;
             lastSensorAvailability.rcNodeEnabled = true;
         }
@@ -351,20 +374,20 @@ int main(void)
         /// DST800:
         // This is required for the water speed reading, so if it's disconnected, we enter a reset
         // state.
-        if (lastSensorAvailability.dst800Enabled && !sensorAvailability.dst800.enabled) {
+        if (lastSensorAvailability.dst800Enabled && !sensorAvailability[SENSOR_DST800].enabled) {
             nodeErrors |= PRIMARY_NODE_RESET_DST800_DISCONNECTED;
             lastSensorAvailability.dst800Enabled = false;
-        } else if (!lastSensorAvailability.dst800Enabled && sensorAvailability.dst800.enabled) {
+        } else if (!lastSensorAvailability.dst800Enabled && sensorAvailability[SENSOR_DST800].enabled) {
             nodeErrors &= ~PRIMARY_NODE_RESET_DST800_DISCONNECTED;
             lastSensorAvailability.dst800Enabled = true;
         }
 
         /// IMU:
         // This is required for heading & turn rate, so if it's disconnected, we enter a reset state.
-        if (lastSensorAvailability.imuEnabled && !sensorAvailability.imu.enabled) {
+        if (lastSensorAvailability.imuEnabled && !sensorAvailability[SENSOR_IMU].enabled) {
             nodeErrors |= PRIMARY_NODE_RESET_IMU_DISCONNECTED;
             lastSensorAvailability.imuEnabled = false;
-        } else if (!lastSensorAvailability.imuEnabled && sensorAvailability.imu.enabled) {
+        } else if (!lastSensorAvailability.imuEnabled && sensorAvailability[SENSOR_IMU].enabled) {
             nodeErrors &= ~PRIMARY_NODE_RESET_IMU_DISCONNECTED;
             lastSensorAvailability.imuEnabled = true;
         }
@@ -373,7 +396,7 @@ int main(void)
         // enforced, so we clear that status and re-transmit the latest autonomous control commands.
         // Otherwise if the RC node becomes active while it's also enabled, then we have manual
         // override.
-        if (lastSensorAvailability.rcNodeActive && !sensorAvailability.rcNode.active) {
+        if (lastSensorAvailability.rcNodeActive && !sensorAvailability[SENSOR_RC_NODE].active) {
             nodeErrors &= ~PRIMARY_NODE_RESET_MANUAL_OVERRIDE;
 
             // Output the command messages for this timestep even if they haven't changed,
@@ -384,8 +407,8 @@ int main(void)
                                                       currentCommands.autonomousThrottleCommand,
                                                       true);
             lastSensorAvailability.rcNodeActive = false;
-        } else if (sensorAvailability.rcNode.enabled &&
-                   !lastSensorAvailability.rcNodeActive && sensorAvailability.rcNode.active) {
+        } else if (sensorAvailability[SENSOR_RC_NODE].enabled &&
+                   !lastSensorAvailability.rcNodeActive && sensorAvailability[SENSOR_RC_NODE].active) {
             nodeErrors |= PRIMARY_NODE_RESET_MANUAL_OVERRIDE;
             lastSensorAvailability.rcNodeActive = true;
         }
@@ -394,11 +417,11 @@ int main(void)
         // undergoing calibration. Calibration can only be done while in manual mode, so triggering
         // a reset state here won't affect manual control but will trigger RTB in autonomous mode,
         // which is what's desired.
-        if (lastSensorAvailability.rudderActive && !sensorAvailability.rudder.active) {
+        if (lastSensorAvailability.rudderActive && !sensorAvailability[SENSOR_RUDDER].active) {
             nodeErrors |= PRIMARY_NODE_RESET_RUDDER_ERRORS;
             lastSensorAvailability.rudderActive = false;
-        } else if (sensorAvailability.rudder.enabled &&
-                   !lastSensorAvailability.rudderActive && sensorAvailability.rudder.active) {
+        } else if (sensorAvailability[SENSOR_RUDDER].enabled &&
+                   !lastSensorAvailability.rudderActive && sensorAvailability[SENSOR_RUDDER].active) {
             nodeErrors &= ~PRIMARY_NODE_RESET_RUDDER_ERRORS;
             lastSensorAvailability.rudderActive = true;
         }
@@ -438,8 +461,12 @@ int main(void)
         // Check for new MAVLink messages. We may get multiple of the
         // same message between our 100Hz primary controller ticks, so data may be overridden,
         // but that doesn't really matter, as we were losing that data anyways when we were
-        // calling it at 100Hz.
+        // calling it at 100Hz. This also stores parameters when asked, which can stall to erase,
+        // so it's counted in the CPU load.
+        uint32_t workStart = PrimaryNodeGetTimestamp();
+        uint32_t workUartTicks = GetUartInterruptTicks();
         MavLinkReceive();
+        CountBusyTime(workStart, workUartTicks);
 
         // At this point we check to see if we're in an error state. If this error state is
         // different than what we were in before, and it's one of the error states that should
@@ -471,11 +498,83 @@ int main(void)
         }
 
         // Trigger the 100Hz loop when the timer counts past the 0.01s mark.
+        bool loopRan = false;
         if (TMR2 >= F_OSC / 2 / 256 / 100) {
+            // Interrupts are disabled while the ticks counted so far are moved into timer2Ticks, so
+            // PrimaryNodeGetTimestamp() never sees them counted twice or not at all.
+            unsigned int savedSR;
+            SET_AND_SAVE_CPU_IPL(savedSR, 7);
+            timer2Ticks += TMR2;
             TMR2 = 0; // We need to reset the timer counter BEFORE doing anything in here or it
                       // throws off our calculations.
+            RESTORE_CPU_IPL(savedSR);
+            workStart = PrimaryNodeGetTimestamp();
+            workUartTicks = GetUartInterruptTicks();
             PrimaryNode100HzLoop();
+            CountBusyTime(workStart, workUartTicks);
+            UpdateCpuLoad();
+            loopRan = true;
         }
+
+        // Program the flash log a few words at a time. Erasing a sector stalls the CPU for ~20ms
+        // with every interrupt held off, which skips two 100Hz iterations and overruns the UART
+        // receive FIFOs, so it's only allowed right after the 100Hz loop in manual mode. In
+        // autonomous mode the log uses the sector erased ahead of time and then stops.
+        workStart = PrimaryNodeGetTimestamp();
+        workUartTicks = GetUartInterruptTicks();
+        FlashLogTask(loopRan && !IS_AUTONOMOUS());
+        CountBusyTime(workStart, workUartTicks);
+    }
+}
+
+// The time spent in the main loop's work since nodeCpuLoad was last updated, in
+// PrimaryNodeGetTimestamp() ticks and without the UART interrupts.
+static uint32_t busyTicks = 0;
+
+/**
+ * Returns the total time spent in the UART interrupts, in PrimaryNodeGetTimestamp() ticks.
+ */
+uint32_t GetUartInterruptTicks(void)
+{
+    return Uart1GetInterruptTicks() + Uart2GetInterruptTicks();
+}
+
+/**
+ * Counts the time since some main loop work started towards the CPU load. The UART interrupts that
+ * ran meanwhile are left out, as they're counted on their own.
+ * @param start PrimaryNodeGetTimestamp() when the work started.
+ * @param startUartTicks GetUartInterruptTicks() when the work started.
+ */
+void CountBusyTime(uint32_t start, uint32_t startUartTicks)
+{
+    const uint32_t ticks = PrimaryNodeGetTimestamp() - start;
+    const uint32_t uartTicks = GetUartInterruptTicks() - startUartTicks;
+    if (ticks > uartTicks) {
+        busyTicks += ticks - uartTicks;
+    }
+}
+
+/**
+ * Updates nodeCpuLoad every second with the percentage of time spent in the main loop's work and in
+ * the UART interrupts. The work is the 100Hz loop, MAVLink reception including storing parameters,
+ * and the flash log with its erases. Polling them when there's nothing to do is counted too, which
+ * adds a small floor to the load. Only the cheap status checks around them are left out, as the
+ * main loop never idles.
+ */
+void UpdateCpuLoad(void)
+{
+    static uint32_t lastUartTicks = 0;
+    static uint32_t lastUpdate = 0;
+
+    const uint32_t now = PrimaryNodeGetTimestamp();
+    if (now - lastUpdate >= PRIMARY_NODE_TIMESTAMP_HZ) {
+        const uint32_t uartTicks = GetUartInterruptTicks();
+        const uint32_t load = (busyTicks + uartTicks - lastUartTicks) * 100 / (now - lastUpdate);
+        nodeCpuLoad = (load < 100) ? (uint8_t)load : 100;
+
+        busyTicks = 0;
+        lastUartTicks = uartTicks;
+        lastUpdate = now;
     }
 }
 
@@ -529,21 +628,30 @@ void PrimaryNode100HzLoop(void)
     // And make sure the primary LED is blinking indicating that the node is operational
     SetStatusModeLed();
 
+    // Copy all inputs to the controller here. This makes sure that what we transmit in the
+    // CONTROLLER_DATA message is **exactly** what was computed on this timestep. Also we make sure
+    // to set their input data to false here.
+    // The sensor data is copied from the snapshots published by ProcessAllEcanMessages(), so each
+    // record is consistent even if CAN processing interrupts this loop.
+    TokimecOutput tokimec;
+    GetTokimecData(&tokimec);
     ImuData imu = {
         true,
-        {(float)tokimecDataStore.yaw / 8192.0, (float)tokimecDataStore.pitch / 8192.0, (float)tokimecDataStore.roll / 8192.0},
-        {(float)tokimecDataStore.x_angle_vel / 4096.0, (float)tokimecDataStore.y_angle_vel / 4096.0, (float)tokimecDataStore.z_angle_vel / 4096.0},
-        {(float)tokimecDataStore.x_accel / 256.0, (float)tokimecDataStore.y_accel / 256.0, (float)tokimecDataStore.z_accel / 256.0}
+        {(float)tokimec.yaw / 8192.0, (float)tokimec.pitch / 8192.0, (float)tokimec.roll / 8192.0},
+        {(float)tokimec.x_angle_vel / 4096.0, (float)tokimec.y_angle_vel / 4096.0, (float)tokimec.z_angle_vel / 4096.0},
+        {(float)tokimec.x_accel / 256.0, (float)tokimec.y_accel / 256.0, (float)tokimec.z_accel / 256.0}
     };
 
-    // Copy all inputs to the controller here. This makes sure that what we transmit in the
-    // CONTROLLER_DATA message is **exactly** what was computed on this timestep. Also we make sure
-    // to set their input data to false here.
-    // Note that this is actually unnecessary since the data can only change OUTSIDE of this 100Hz
-    // event loop.
     bool reset = (nodeErrors != 0);
     GpsData controllerGpsIn;
     GetGpsData(&controllerGpsIn);
+
+    // Track how long the sensor data waited for the controller. The GPS stamp is also kept for the
+    // LOCAL_POSITION_NED message, which is derived from this GPS data.
+    const uint32_t controllerTimestamp = PrimaryNodeGetTimestamp();
+    LatencyConsumed(&tokimecLatency, controllerTimestamp);
+    LatencyConsumed(&gpsLatency, controllerTimestamp);
+    controllerGpsLatency = gpsLatency;
     float waterSpeed = GetWaterSpeed();
     float rudderAngle = rudderSensorData.RudderAngle;
     int16_t propSpeed = GetPropSpeed();
@@ -594,6 +702,13 @@ void PrimaryNode100HzLoop(void)
         }
     }
 
+    // Report how busy the MAVLink channels are every so often.
+    static uint16_t channelUsageCounter = 0;
+    if (++channelUsageCounter >= CHANNEL_USAGE_COUNTER_LIMIT) {
+        TransmitChannelUsage();
+        channelUsageCounter = 0;
+    }
+
     // Update the onboard system time counter. We make sure we don't overflow here as we can
     // run into issues with startup code being executed again.
     if (nodeSystemTime < UINT32_MAX) {
@@ -701,12 +816,12 @@ void SetGpsLed(void)
     static uint8_t gpsBlinkCounter = 0;
 
     // If the GPS is on and receiving good data, set the LED solid.
-    if (sensorAvailability.gps.active) {
+    if (sensorAvailability[SENSOR_GPS].active) {
         _LATB15 = ON;
         gpsBlinkCounter = 0;
     }
     // But if the GPS isn't spitting out good data, but is still transmitting, blink the LED.
-    else if (sensorAvailability.gps.enabled) {
+    else if (sensorAvailability[SENSOR_GPS].enabled) {
         if (gpsBlinkCounter == 0) {
             _LATB15 = ON;
             gpsBlinkCounter = 1;
@@ -793,6 +908,25 @@ PrimaryNodeMode GetAutoMode(void)
     }
 }
 
+uint32_t PrimaryNodeGetTimestamp(void)
+{
+    // timer2Ticks is only modified by the main loop with interrupts disabled, so this is consistent
+    // whether it's called from the main loop or from an interrupt.
+    const uint32_t timestamp = (uint32_t)timer2Ticks + TMR2;
+    return timestamp ? timestamp : 1;
+}
+
+uint64_t PrimaryNodeGetTimeUs(void)
+{
+    // Interrupts are disabled so that a 64-bit read can't be torn by the main loop updating
+    // timer2Ticks, in case this is called from an interrupt.
+    unsigned int savedSR;
+    SET_AND_SAVE_CPU_IPL(savedSR, 7);
+    const uint64_t ticks = timer2Ticks + TMR2;
+    RESTORE_CPU_IPL(savedSR);
+    return ticks * 32 / 5;
+}
+
 void SendAudioStatusUpdate(void)
 {
     const int crosstrackErrorOffset = 12;
@@ -1091,37 +1225,44 @@ float CrossTrackError(void)
     }
 }
 
-void TransmitChannelUsage(void)
+/**
+ * Appends a number and a suffix to a string.
+ */
+static void AppendNumber(char *s, uint16_t n, const char *suffix)
 {
-    // Get the percentage utilization of the groundstation channel
-    uint8_t gsChannelUsage = MavLinkGetChannelUsage(MAVLINK_CHAN_GROUNDSTATION);
-
-    // Stringify it
-    char gsUsageString[] = "Groundstation channel usage at   0%";
-    if (gsChannelUsage >= 100) {
-        gsUsageString[31] = int2hexchar(gsChannelUsage / 100);
-        gsChannelUsage %= 100;
-    }
-    gsUsageString[32] = int2hexchar(gsChannelUsage / 10);
-    gsChannelUsage %= 10;
-    gsUsageString[33] = int2hexchar(gsChannelUsage);
-
-    // And transmit!
-    MavLinkSendStatusText(MAV_SEVERITY_INFO, gsUsageString);
-
-    // Get the percentage utilization of the groundstation channel
-    uint8_t dlChannelUsage = MavLinkGetChannelUsage(MAVLINK_CHAN_DATALOGGER);
+    char digits[6];
+    utoa(digits, n, 10);
+    strcat(s, digits);
+    strcat(s, suffix);
+}
 
-    // Stringify it
-    char dlUsageString[] = "Datalogger channel usage at   0%";
-    if (dlChannelUsage >= 100) {
-        dlUsageString[28] = int2hexchar(dlChannelUsage / 100);
-        dlChannelUsage %= 100;
+void TransmitChannelUsage(void)
+{
+    static const char *const names[] = {"Groundstation", "Datalogger"};
+    static const char *const shortNames[] = {"GS", "DL"};
+
+    uint8_t channel;
+    for (channel = MAVLINK_CHAN_GROUNDSTATION; channel <= MAVLINK_CHAN_DATALOGGER; ++channel) {
+        // Get the percentage utilization of the channel, which is only the scheduled usage until
+        // it's been measured, and stringify it.
+        char text[64];
+        strcpy(text, names[channel]);
+        strcat(text, " channel usage at ");
+        AppendNumber(text, MavLinkGetChannelUsage(channel), "%");
+
+        // And transmit!
+        MavLinkSendStatusText(MAV_SEVERITY_INFO, text);
+
+        // Along with the rest of the measurements.
+        const LinkUsage *usage = MavLinkGetLinkUsage(channel);
+        if (LinkUsageValid(usage)) {
+            strcpy(text, shortNames[channel]);
+            strcat(text, " TX ");
+            AppendNumber(text, LinkUsageTxRate(usage), "B/s ");
+            AppendNumber(text, LinkUsageTxIdle(usage), "% idle, RX ");
+            AppendNumber(text, LinkUsageRxRate(usage), "B/s, wait ");
+            AppendNumber(text, LinkUsageQueueWait(usage), "ms");
+            MavLinkSendStatusText(MAV_SEVERITY_INFO, text);
+        }
     }
-    dlUsageString[29] = int2hexchar(dlChannelUsage / 10);
-    dlChannelUsage %= 10;
-    dlUsageString[30] = int2hexchar(dlChannelUsage);
-
-    // And transmit!
-    MavLinkSendStatusText(MAV_SEVERITY_INFO, dlUsageString);
 }
@@ -1,6 +1,11 @@
 #ifndef PRIMARY_NODE_H
 #define PRIMARY_NODE_H
 
+// The latency and arrival statistics need the timestamps of received CAN messages, see README.md.
+#ifndef ECAN1_TIMESTAMPS
+    #error ECAN1_TIMESTAMPS must be defined for the primary node
+#endif
+
 /**
  * This enum declares the bitflags used for the nodeStatus variable in Node.h.
  */
@@ -76,6 +81,32 @@ PrimaryNodeMode GetAutoMode(void);
  */
 #define IS_AUTONOMOUS() (GetAutoMode() == PRIMARY_MODE_AUTONOMOUS)
 
+/**
+ * The rate of the clock returned by PrimaryNodeGetTimestamp(), which is Timer2 at F_OSC / 2 / 256.
+ */
+#define PRIMARY_NODE_TIMESTAMP_HZ 156250UL
+
+/**
+ * Converts a difference between two timestamps into microseconds. Each tick is 6.4us.
+ */
+#define PRIMARY_NODE_TIMESTAMP_TO_US(ticks) ((uint32_t)(((uint64_t)(ticks) * 32) / 5))
+
+/**
+ * Returns a high-resolution timestamp from a free-running clock at PRIMARY_NODE_TIMESTAMP_HZ. It
+ * wraps around about every 7.6 hours, so only differences between timestamps are meaningful. This
+ * is safe to call from interrupts.
+ * @return The current timestamp. This is never 0, so 0 can be used to mark unset timestamps.
+ */
+uint32_t PrimaryNodeGetTimestamp(void);
+
+/**
+ * Returns the time since startup from the same clock as PrimaryNodeGetTimestamp(). This never wraps
+ * around and is monotonic, unlike nodeSystemTime which only has 10ms resolution. This is used as
+ * the local clock for MAVLink time synchronization.
+ * @return The time since startup in microseconds, with a resolution of 6.4us.
+ */
+uint64_t PrimaryNodeGetTimeUs(void);
+
 /**
  * Returns the sensed power rail voltage. Accuracy should be about 1%.
  * @return The measured power rail voltage in volts.
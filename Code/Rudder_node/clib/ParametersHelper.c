@@ -4,8 +4,8 @@
 #include <stddef.h>
 
 static const Parameter params[] = {
-    {"Limit_Port", &rudderCalData.PortLimitValue, NULL, NULL, PARAMETERS_DATATYPE_UINT16},
-    {"Limit_SB", &rudderCalData.StarLimitValue, NULL, NULL, PARAMETERS_DATATYPE_UINT16}
+    {"Limit_Port", &rudderCalData.PortLimitValue, NULL, NULL, PARAMETERS_DATATYPE_UINT16, RudderLimitsChanged},
+    {"Limit_SB", &rudderCalData.StarLimitValue, NULL, NULL, PARAMETERS_DATATYPE_UINT16, RudderLimitsChanged}
 };
 
 // Expose both the list of parameters and the total to the Parameters library.
@@ -10,6 +10,8 @@
 #include "CanMessages.h"
 #include "Types.h"
 #include "DataStore.h"
+#include "Parameters.h"
+#include "DEE.h"
 
 // Stores all status data from a CANode.
 // Invalid values for every field is the maximum positive value for that datatype.
@@ -77,6 +79,12 @@ enum {
 // Instantiate a struct to store calibration data.
 struct RudderCalibrationData rudderCalData = {};
 
+// The reciprocal of the potentiometer range between the rudder limits. Converting the potentiometer
+// reading needs it every tick, so it's only recomputed when the limits change.
+static float potInverseRange = INFINITY;
+
+static float PotToRadsScaled(uint16_t input, uint16_t lowSide, float inverseRange);
+
 // Keep a running average of the rudder angle. This is module-level so it can be reset if the system
 // begins calibration.
 static float rudderAngleAverage = NAN;
@@ -135,6 +143,9 @@ void RudderNodeInit(void)
 		FATAL_ERROR();
 	}
 
+	// Saving a new calibration shouldn't stall the rudder, so write it out over later ticks.
+	DataStoreSetAsync(true);
+
 	// Transmit the rudder angle at 10Hz
 	if (!AddMessageRepeating(&sched, SCHED_ID_RUDDER_ANGLE, 10)) {
 		while (1);
@@ -162,8 +173,9 @@ void RudderCalibrate(void)
 		rudderCalData.Calibrated = false;
 		rudderCalData.Calibrating = true;
 		rudderCalData.CommandedRun = true;
-		rudderCalData.PortLimitValue = 0;
-		rudderCalData.StarLimitValue = 0;
+		const uint16_t noLimit = 0;
+		ParameterSetValueByName("Limit_Port", &noLimit);
+		ParameterSetValueByName("Limit_SB", &noLimit);
 		if (rudderSensorData.StarLimit) {
 			rudderCalData.CalibrationState = RUDDER_CAL_STATE_FIRST_TO_PORT;
 			rudderCalData.CommandedDirection = TO_PORT;
@@ -173,20 +185,20 @@ void RudderCalibrate(void)
 		}
 	} else if (rudderCalData.CalibrationState == RUDDER_CAL_STATE_FIRST_TO_PORT) {
 		if (rudderSensorData.PortLimit) {
-			rudderCalData.PortLimitValue = rudderSensorData.PotValue;
+			ParameterSetValueByName("Limit_Port", &rudderSensorData.PotValue);
 			rudderCalData.CalibrationState = RUDDER_CAL_STATE_SECOND_TO_STARBOARD;
 			rudderCalData.CommandedDirection = TO_STARBOARD;
 		}
 	} else if (rudderCalData.CalibrationState == RUDDER_CAL_STATE_FIRST_TO_STARBOARD) {
 		if (rudderSensorData.StarLimit) {
-			rudderCalData.StarLimitValue = rudderSensorData.PotValue;
+			ParameterSetValueByName("Limit_SB", &rudderSensorData.PotValue);
 			rudderCalData.CalibrationState = RUDDER_CAL_STATE_SECOND_TO_PORT;
 			rudderCalData.CommandedDirection = TO_PORT;
 		}
 	} else if (rudderCalData.CalibrationState == RUDDER_CAL_STATE_SECOND_TO_PORT) {
 		if (rudderSensorData.PortLimit) {
-			rudderCalData.PortLimitValue = rudderSensorData.PotValue;
-			DataStoreSaveParameters();
+			ParameterSetValueByName("Limit_Port", &rudderSensorData.PotValue);
+			DataStoreFlush();
 			rudderCalData.CalibrationState = RUDDER_CAL_STATE_RECENTER;
 			rudderCalData.CommandedDirection = TO_STARBOARD;
 			rudderCalData.Calibrated = true;
@@ -194,8 +206,8 @@ void RudderCalibrate(void)
 		}
 	} else if (rudderCalData.CalibrationState == RUDDER_CAL_STATE_SECOND_TO_STARBOARD) {
 		if (rudderSensorData.StarLimit) {
-			rudderCalData.StarLimitValue = rudderSensorData.PotValue;
-			DataStoreSaveParameters();
+			ParameterSetValueByName("Limit_SB", &rudderSensorData.PotValue);
+			DataStoreFlush();
 			rudderCalData.CalibrationState = RUDDER_CAL_STATE_RECENTER;
 			rudderCalData.CommandedDirection = TO_PORT;
 			rudderCalData.Calibrated = true;
@@ -268,6 +280,14 @@ void SendAndReceiveEcan(void)
     // First update the sensor status
     UpdateSensorsAvailability();
 
+    // Program any queued parameter writes. Erasing a flash page stalls for longer than a tick, so
+    // only allow it when not calibrating. If saving the calibration couldn't queue everything
+    // without an erase, finish saving it once the erase is done.
+    if (DataEETask(!rudderCalData.Calibrating) == DATA_EE_IDLE && !rudderCalData.Calibrating &&
+        ParameterAnyDirty()) {
+        DataStoreFlush();
+    }
+
     uint8_t messagesLeft = 0;
     CanMessage msg;
     uint32_t pgn;
@@ -480,8 +500,8 @@ void CalculateRudderAngle(void)
     const float alpha = sensorSampleTime / (rudderAverageTimeConstant + sensorSampleTime);
 
     // Get the new rudder angle.
-    const float newValue = PotToRads(rudderSensorData.PotValue, rudderCalData.StarLimitValue,
-                                     rudderCalData.PortLimitValue);
+    const float newValue = PotToRadsScaled(rudderSensorData.PotValue, rudderCalData.PortLimitValue,
+                                           potInverseRange);
     rudderSensorData.RudderPositionAngle = newValue;
     return; // FIXME: Remove this from debugging
 
@@ -496,7 +516,10 @@ void CalculateRudderAngle(void)
     rudderSensorData.RudderPositionAngle = rudderAngleAverage;
 }
 
-float PotToRads(uint16_t input, uint16_t highSide, uint16_t lowSide)
+/**
+ * Converts a potentiometer reading to radians, given the reciprocal of the range between the limits.
+ */
+static float PotToRadsScaled(uint16_t input, uint16_t lowSide, float inverseRange)
 {
     // This function converts the potentiometer reading from the boat's rudder sensors
     // to a value in degrees. It relies on each limit being hit to set the bounds on
@@ -507,11 +530,10 @@ float PotToRads(uint16_t input, uint16_t highSide, uint16_t lowSide)
     // Prepare our input. Here we subtract the baseline 'lowSide' value off of
     // the input so we start with a range from [0..highSide-lowSide] and map it
     // into the output range of 45 degrees.
-    int32_t in_max = highSide - lowSide;
     float val = (float)((int32_t)input - (int32_t)lowSide);
 
     // Do the actual conversion reversing the range and mapping it into [.7854:-0.7854]
-    float rads = (0.5 - val/((float)in_max))*2*0.7854;
+    float rads = (0.5 - val*inverseRange)*2*0.7854;
 
     // Finally cap the value to +- our range to prevent odd errors later.
     if (rads > 0.7854) {
@@ -522,6 +544,19 @@ float PotToRads(uint16_t input, uint16_t highSide, uint16_t lowSide)
 	return rads;
 }
 
+float PotToRads(uint16_t input, uint16_t highSide, uint16_t lowSide)
+{
+    int32_t in_max = highSide - lowSide;
+    return PotToRadsScaled(input, lowSide, 1.0f / (float)in_max);
+}
+
+void RudderLimitsChanged(uint16_t id)
+{
+    (void)id;
+    int32_t in_max = rudderCalData.StarLimitValue - rudderCalData.PortLimitValue;
+    potInverseRange = 1.0f / (float)in_max;
+}
+
 /**
  * This function should be called at a constant rate (same units as NODE_TIMEOUT) and updates the
  * availability of any sensors and onboard nodes. This function is separated from the
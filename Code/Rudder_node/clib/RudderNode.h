@@ -105,4 +105,10 @@ float GetNewAngle(void);
  */
 float PotToRads(uint16_t input, uint16_t highSide, uint16_t lowSide);
 
+/**
+ * Observer for the limit parameters, recomputing the scaling of the potentiometer readings.
+ * @param id The ID of the parameter that changed.
+ */
+void RudderLimitsChanged(uint16_t id);
+
 #endif // RUDDER_NODE_H
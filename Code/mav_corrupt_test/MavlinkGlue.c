@@ -313,7 +313,7 @@ void MavLinkSendMainPower(void)
 	mavlink_message_t msg;
 
 	mavlink_msg_main_power_pack(mavlink_system.sysid, mavlink_system.compid, &msg,
-		(uint16_t)(0 * 100.0f),(uint16_t)(0 * 10.0f));
+		(uint16_t)(0 * 100.0f),(uint16_t)(0 * 10.0f), 0, 0, 0, 0);
 
 	len = mavlink_msg_to_send_buffer(buf, &msg);
 
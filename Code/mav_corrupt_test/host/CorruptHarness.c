@@ -0,0 +1,717 @@
+/**
+ * @file
+ * @brief Runs mav_corrupt_test's MavlinkGlue.c on a PC against a model of the UART1 peripheral,
+ * with a scripted groundstation refreshing the mission list over and over, until the MAVLink
+ * output is corrupted.
+ *
+ * The firmware side is the same code as on the dsPIC: MavlinkGlue.c, Uart1.c, TxQueue.c,
+ * CircularBuffer.c, and MessageScheduler.c, built against the stand-in xc.h and uart.h in this
+ * directory. main() replaces MavCorruptNode.c's main loop, calling MavLinkReceive() continuously and
+ * MavLinkTransmit() at 100Hz.
+ *
+ * Interrupts are modeled with POSIX signals. An interrupt thread sends SIGUSR1 to the firmware
+ * thread at random intervals, and the signal handler plays the UART hardware and the interrupt
+ * controller: it shifts bytes in and out at the baud rate, sets the status and interrupt flags, and
+ * runs _U1RXInterrupt()/_U1TXInterrupt() when they're flagged and enabled. As the handler runs on
+ * the firmware thread it preempts it at an arbitrary instruction and runs to completion, just like
+ * an interrupt on a single-core CPU, so every race between the ISRs and main-line code is fair game.
+ * Most of those land in the idle polling loop though, so the model also interrupts at random at
+ * main-line accesses to IEC0bits and U1TXREG, which is right where the interesting races are.
+ *
+ * The groundstation thread acts like QGC: it sends a HEARTBEAT every second and requests the full
+ * mission list, retrying on timeouts. Everything the firmware transmits is decoded as it comes off
+ * the wire, and the first frame that fails its CRC or any bytes between frames stop the run with a
+ * dump of the surrounding bytes. Frames that were never queued, because the TX buffer was full, show
+ * up as sequence gaps and are only counted.
+ *
+ * Time is virtual: the baud rate, the 100Hz loop, and the groundstation's timeouts all run on a
+ * clock that's sped up by the -x factor, so many refreshes can be run in a short time.
+ *
+ * With gcc, from mav_corrupt_test: `gcc -O2 -std=gnu99 -pthread -Ihost -I. -I../Libs/C -I../Libs/MAVLink/seaslug host/CorruptHarness.c MavlinkGlue.c ../Libs/C/Uart1.c ../Libs/C/TxQueue.c ../Libs/C/CircularBuffer.c ../Libs/C/MessageScheduler.c -lm -o corrupt_harness`
+ *
+ * Usage: `corrupt_harness [-t seconds] [-x speedup] [-g min:max] [-p chance] [-s seed]`
+ *  * -t: How long to run for in real seconds, 0 runs until corruption is found. Defaults to 60.
+ *  * -x: How much faster than real-time the virtual clock runs. Defaults to 4.
+ *  * -g: The range of real time between interrupts in us. Defaults to 2:20.
+ *  * -p: The chance of interrupting at each register access, from 0 to 1. Defaults to 0.05.
+ *  * -s: The seed for the interrupt timing, defaults to the current time.
+ * Returns 0 if no corruption was found, 1 if it was, and 2 on errors.
+ */
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sched.h>
+
+#include "xc.h"
+#include "uart.h"
+#include "Uart1.h"
+#include "MavlinkGlue.h"
+#include "MavCorruptNode.h"
+
+// The UART timing, 10 bits per byte at 115200 baud.
+#define BYTE_TIME_US (10.0 * 1e6 / 115200.0)
+
+// The depth of the hardware FIFOs on the dsPIC33.
+#define HW_FIFO_DEPTH 4
+
+// Marks a transmit FIFO slot that's been claimed but not written to yet.
+#define SLOT_EMPTY 0xFFFF
+
+// The groundstation's system and component IDs.
+#define GCS_SYSID 255
+#define GCS_COMPID 190
+
+// How long the groundstation waits for a reply before retrying, in virtual us, and how many times.
+#define GCS_TIMEOUT 1500000
+#define GCS_RETRIES 5
+
+// How many of the last bytes off the wire are kept for the corruption dump.
+#define HISTORY_SIZE 256
+
+/*
+ * A single-producer single-consumer byte pipe that's safe between threads and the signal handler.
+ */
+#define PIPE_SIZE (1 << 16)
+typedef struct {
+    uint8_t data[PIPE_SIZE];
+    uint32_t head; // Written by the producer.
+    uint32_t tail; // Written by the consumer.
+} Pipe;
+
+static bool PipePut(Pipe *p, uint8_t c)
+{
+    const uint32_t head = __atomic_load_n(&p->head, __ATOMIC_RELAXED);
+    if (head - __atomic_load_n(&p->tail, __ATOMIC_ACQUIRE) == PIPE_SIZE) {
+        return false;
+    }
+    p->data[head % PIPE_SIZE] = c;
+    __atomic_store_n(&p->head, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+static bool PipeGet(Pipe *p, uint8_t *c)
+{
+    const uint32_t tail = __atomic_load_n(&p->tail, __ATOMIC_RELAXED);
+    if (tail == __atomic_load_n(&p->head, __ATOMIC_ACQUIRE)) {
+        return false;
+    }
+    *c = p->data[tail % PIPE_SIZE];
+    __atomic_store_n(&p->tail, tail + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+// Bytes from the groundstation to the boat, and from the boat to the groundstation.
+static Pipe uplink;
+static Pipe downlink;
+
+/*
+ * The virtual clock.
+ */
+static struct timespec startTime;
+static double speedup = 4.0;
+
+static double NowUs(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - startTime.tv_sec) * 1e6 + (now.tv_nsec - startTime.tv_nsec) / 1e3;
+}
+
+static double SimTimeUs(void)
+{
+    return NowUs() * speedup;
+}
+
+/*
+ * The UART1 model. Everything here is only touched from the signal handler, except through the
+ * Sim*() functions, which set modelBusy so the handler skips that interrupt.
+ */
+volatile U1STABITS U1STAbits;
+volatile U1MODEBITS U1MODEbits;
+volatile IFS0BITS IFS0bits;
+volatile uint16_t U1BRG;
+
+static volatile IEC0BITS iec0;
+
+static volatile sig_atomic_t modelBusy;
+static volatile sig_atomic_t inHandler;
+
+// The chance of interrupting at every main-line access to the UART registers, out of RAND_MAX.
+static double accessPreemptChance = 0.05;
+static unsigned accessPreemptState;
+
+static uint8_t rxFifo[HW_FIFO_DEPTH];
+static uint8_t rxHead, rxCount;
+static double nextRxTime;
+
+static volatile uint16_t txFifo[HW_FIFO_DEPTH];
+static uint8_t txHead, txCount;
+static bool txShifting;
+static uint8_t txShiftRegister;
+static double nextTxTime;
+static volatile uint16_t txDiscard;
+
+// Statistics, all only written in the handler or by the model.
+static volatile uint64_t interruptsRequested;
+static volatile uint64_t interruptsDeferred;
+static volatile uint64_t accessPreemptions;
+static volatile uint64_t rxInterrupts;
+static volatile uint64_t txInterrupts;
+static volatile uint64_t rxOverruns;
+static volatile uint64_t txOverflows;
+static volatile uint64_t bytesDown;
+static volatile uint64_t bytesUp;
+
+static void UpdateTxStatus(void)
+{
+    U1STAbits.UTXBF = (txCount == HW_FIFO_DEPTH);
+    U1STAbits.TRMT = (txCount == 0 && !txShifting);
+}
+
+void SimUart1Open(uint16_t brg)
+{
+    modelBusy = 1;
+    U1BRG = brg;
+    rxHead = rxCount = 0;
+    txHead = txCount = 0;
+    txShifting = false;
+    nextRxTime = nextTxTime = SimTimeUs();
+    U1STAbits.URXDA = 0;
+    U1STAbits.OERR = 0;
+    UpdateTxStatus();
+    U1STAbits.UTXEN = 1;
+    U1MODEbits.UARTEN = 1;
+    modelBusy = 0;
+}
+
+void SimUart1Close(void)
+{
+    modelBusy = 1;
+    U1MODEbits.UARTEN = 0;
+    iec0.U1RXIE = 0;
+    iec0.U1TXIE = 0;
+    modelBusy = 0;
+}
+
+void SimUart1ConfigInt(uint16_t config)
+{
+    iec0.U1RXIE = (config & 1) ? 1 : 0;
+    iec0.U1TXIE = (config & 2) ? 1 : 0;
+}
+
+static void MaybeInterrupt(void);
+
+volatile IEC0BITS *SimIec0(void)
+{
+    MaybeInterrupt();
+    return &iec0;
+}
+
+uint16_t SimUart1ReadRx(void)
+{
+    if (!inHandler) {
+        modelBusy = 1;
+    }
+    uint16_t c = 0;
+    if (rxCount) {
+        c = rxFifo[rxHead];
+        rxHead = (rxHead + 1) % HW_FIFO_DEPTH;
+        --rxCount;
+    }
+    U1STAbits.URXDA = (rxCount > 0);
+    if (!inHandler) {
+        modelBusy = 0;
+    }
+    return c;
+}
+
+volatile uint16_t *SimUart1TxSlot(void)
+{
+    MaybeInterrupt();
+    if (!inHandler) {
+        modelBusy = 1;
+    }
+    volatile uint16_t *slot;
+    if (txCount == HW_FIFO_DEPTH) {
+        // The real UART ignores writes while its FIFO is full.
+        ++txOverflows;
+        slot = &txDiscard;
+    } else {
+        slot = &txFifo[(txHead + txCount) % HW_FIFO_DEPTH];
+        *slot = SLOT_EMPTY;
+        ++txCount;
+    }
+    UpdateTxStatus();
+    U1STAbits.TRMT = 0;
+    if (!inHandler) {
+        modelBusy = 0;
+    }
+    return slot;
+}
+
+/**
+ * Advances the UART hardware by at most one received and one transmitted byte, if they're due.
+ * @return True if anything happened.
+ */
+static bool StepUart(double now)
+{
+    if (!U1MODEbits.UARTEN) {
+        nextRxTime = nextTxTime = now;
+        return false;
+    }
+
+    bool progressed = false;
+
+    // Receive a byte every byte time while the groundstation is sending.
+    uint8_t c;
+    if (nextRxTime > now) {
+        // Not due yet.
+    } else if (!PipeGet(&uplink, &c)) {
+        nextRxTime = now;
+    } else {
+        nextRxTime += BYTE_TIME_US;
+        ++bytesUp;
+        progressed = true;
+
+        // Reception stops while there's an overrun, until OERR is cleared.
+        if (U1STAbits.OERR) {
+            // Dropped.
+        } else if (rxCount == HW_FIFO_DEPTH) {
+            U1STAbits.OERR = 1;
+            ++rxOverruns;
+        } else {
+            rxFifo[(rxHead + rxCount) % HW_FIFO_DEPTH] = c;
+            ++rxCount;
+            U1STAbits.URXDA = 1;
+            IFS0bits.U1RXIF = 1;
+        }
+    }
+
+    // And send one every byte time while there's data, moving the next byte from the FIFO into the
+    // shift register as each one finishes.
+    if (nextTxTime <= now) {
+        if (txShifting) {
+            PipePut(&downlink, txShiftRegister);
+            ++bytesDown;
+            txShifting = false;
+            progressed = true;
+        }
+        if (txCount && txFifo[txHead] != SLOT_EMPTY) {
+            txShiftRegister = (uint8_t)txFifo[txHead];
+            txHead = (txHead + 1) % HW_FIFO_DEPTH;
+            --txCount;
+            txShifting = true;
+            nextTxTime += BYTE_TIME_US;
+            progressed = true;
+        } else {
+            // Interrupt once the last character has been shifted out.
+            if (!txShifting && !txCount && !U1STAbits.TRMT) {
+                IFS0bits.U1TXIF = 1;
+            }
+            nextTxTime = now;
+        }
+        UpdateTxStatus();
+    }
+
+    return progressed;
+}
+
+extern void _U1RXInterrupt(void);
+extern void _U1TXInterrupt(void);
+
+/**
+ * The interrupt: updates the hardware and runs any flagged and enabled ISRs.
+ */
+static void Interrupt(void)
+{
+    // Catch the hardware up a byte at a time, running the ISRs after every step like they would
+    // have been. While main-line code has an interrupt disabled only one step is taken, as it's
+    // likely only been disabled for a moment, and catching up fully would cause overruns that
+    // couldn't happen on the real hardware.
+    inHandler = 1;
+    const double now = SimTimeUs();
+    bool progressed;
+    do {
+        progressed = StepUart(now);
+        if (iec0.U1RXIE && IFS0bits.U1RXIF) {
+            ++rxInterrupts;
+            _U1RXInterrupt();
+        }
+        if (iec0.U1TXIE && IFS0bits.U1TXIF && U1STAbits.TRMT) {
+            ++txInterrupts;
+            _U1TXInterrupt();
+        }
+    } while (progressed && iec0.U1RXIE && iec0.U1TXIE);
+    inHandler = 0;
+}
+
+/**
+ * Interrupts from the interrupt thread arrive as signals.
+ */
+static void InterruptHandler(int sig)
+{
+    (void)sig;
+
+    ++interruptsRequested;
+    if (modelBusy || inHandler) {
+        ++interruptsDeferred;
+        return;
+    }
+    Interrupt();
+}
+
+/**
+ * Randomly interrupts at a main-line register access.
+ */
+static void MaybeInterrupt(void)
+{
+    if (inHandler || modelBusy) {
+        return;
+    }
+    if (rand_r(&accessPreemptState) < accessPreemptChance * RAND_MAX) {
+        ++accessPreemptions;
+        Interrupt();
+    }
+}
+
+/*
+ * The interrupt thread.
+ */
+static pthread_t firmwareThread;
+static volatile bool running = true;
+static unsigned minGapUs = 2, maxGapUs = 20;
+static unsigned seed;
+
+static void *InterruptThread(void *arg)
+{
+    (void)arg;
+    unsigned state = seed;
+    while (running) {
+        // Wait for the last interrupt to be handled, so two never arrive back-to-back.
+        const uint64_t requested = interruptsRequested;
+        pthread_kill(firmwareThread, SIGUSR1);
+        while (interruptsRequested == requested && running) {
+            sched_yield();
+        }
+
+        // Then wait for a random time. Sleeping is far too coarse so this spins, yielding so that
+        // it still works with a single CPU, though with much longer gaps.
+        const double gap = minGapUs + (rand_r(&state) % (maxGapUs - minGapUs + 1));
+        const double until = NowUs() + gap;
+        while (NowUs() < until) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+/*
+ * The groundstation.
+ */
+enum {
+    GCS_IDLE,
+    GCS_WAIT_COUNT,
+    GCS_WAIT_ITEM
+};
+
+static volatile bool corrupted = false;
+static volatile uint64_t refreshes;
+static volatile uint64_t failedRefreshes;
+static volatile uint64_t framesReceived;
+static volatile uint64_t framesLost;
+
+static void GcsSend(const mavlink_message_t *msg)
+{
+    uint8_t frame[MAVLINK_MAX_PACKET_LEN];
+    const uint16_t size = mavlink_msg_to_send_buffer(frame, msg);
+    uint16_t i;
+    for (i = 0; i < size; ++i) {
+        PipePut(&uplink, frame[i]);
+    }
+}
+
+/**
+ * Prints the bytes around where corruption was found.
+ */
+static void DumpCorruption(const char *what, const uint8_t *history, uint32_t historyCount, const mavlink_message_t *msg)
+{
+    printf("\nCORRUPTION: %s at %.3fs virtual time, after %llu refreshes and %llu frames.\n", what,
+           SimTimeUs() / 1e6, (unsigned long long)refreshes, (unsigned long long)framesReceived);
+    printf("Frame header: len %u, seq %u, sysid %u, compid %u, msgid %u.\n",
+           msg->len, msg->seq, msg->sysid, msg->compid, msg->msgid);
+    printf("Last %u bytes off the wire, oldest first:\n", historyCount < HISTORY_SIZE ? historyCount : HISTORY_SIZE);
+    uint32_t i = (historyCount < HISTORY_SIZE) ? 0 : historyCount - HISTORY_SIZE;
+    int column = 0;
+    for (; i < historyCount; ++i) {
+        printf("%s%02X", (history[i % HISTORY_SIZE] == MAVLINK_STX) ? "|" : " ", history[i % HISTORY_SIZE]);
+        if (++column == 32) {
+            printf("\n");
+            column = 0;
+        }
+    }
+    printf("\n");
+}
+
+static void *GroundstationThread(void *arg)
+{
+    (void)arg;
+
+    int state = GCS_IDLE;
+    uint16_t count = 0;
+    uint16_t index = 0;
+    int retries = 0;
+    double deadline = 0;
+    double nextHeartbeat = 0;
+    double nextRefresh = SimTimeUs() + 500000; // Let the boat start up first.
+
+    mavlink_message_t msg;
+    mavlink_status_t status;
+    bool haveSeq = false;
+    uint8_t lastSeq = 0;
+
+    uint8_t history[HISTORY_SIZE];
+    uint32_t historyCount = 0;
+
+    while (running) {
+        const double now = SimTimeUs();
+
+        // Decode everything that's come down the wire.
+        uint8_t c;
+        bool idle = true;
+        while (PipeGet(&downlink, &c)) {
+            idle = false;
+            history[historyCount++ % HISTORY_SIZE] = c;
+            const uint8_t result = mavlink_frame_char(MAVLINK_COMM_2, c, &msg, &status);
+            if (status.packet_rx_drop_count) {
+                DumpCorruption("bytes outside of any frame", history, historyCount, &msg);
+                corrupted = true;
+                running = false;
+                return NULL;
+            }
+            if (result == MAVLINK_FRAMING_BAD_CRC) {
+                DumpCorruption("bad CRC", history, historyCount, &msg);
+                corrupted = true;
+                running = false;
+                return NULL;
+            }
+            if (result != MAVLINK_FRAMING_OK) {
+                continue;
+            }
+
+            ++framesReceived;
+            if (haveSeq) {
+                framesLost += (uint8_t)(msg.seq - lastSeq - 1);
+            }
+            lastSeq = msg.seq;
+            haveSeq = true;
+
+            if (state == GCS_WAIT_COUNT && msg.msgid == MAVLINK_MSG_ID_MISSION_COUNT) {
+                count = mavlink_msg_mission_count_get_count(&msg);
+                index = 0;
+                retries = 0;
+                mavlink_message_t request;
+                mavlink_msg_mission_request_pack(GCS_SYSID, GCS_COMPID, &request, msg.sysid, msg.compid, index);
+                GcsSend(&request);
+                state = GCS_WAIT_ITEM;
+                deadline = now + GCS_TIMEOUT;
+            } else if (state == GCS_WAIT_ITEM && msg.msgid == MAVLINK_MSG_ID_MISSION_ITEM &&
+                       mavlink_msg_mission_item_get_seq(&msg) == index) {
+                retries = 0;
+                mavlink_message_t reply;
+                if (++index == count) {
+                    mavlink_msg_mission_ack_pack(GCS_SYSID, GCS_COMPID, &reply, msg.sysid, msg.compid, MAV_MISSION_ACCEPTED);
+                    ++refreshes;
+                    state = GCS_IDLE;
+                    nextRefresh = now + 20000 + rand() % 100000;
+                } else {
+                    mavlink_msg_mission_request_pack(GCS_SYSID, GCS_COMPID, &reply, msg.sysid, msg.compid, index);
+                    deadline = now + GCS_TIMEOUT;
+                }
+                GcsSend(&reply);
+            }
+        }
+
+        if (now >= nextHeartbeat) {
+            mavlink_message_t heartbeat;
+            mavlink_msg_heartbeat_pack(GCS_SYSID, GCS_COMPID, &heartbeat, MAV_TYPE_GCS, MAV_AUTOPILOT_INVALID, 0, 0, MAV_STATE_ACTIVE);
+            GcsSend(&heartbeat);
+            nextHeartbeat = now + 1000000;
+        }
+
+        // Retry timed out requests, starting over completely once too many have failed.
+        if (state != GCS_IDLE && now >= deadline) {
+            mavlink_message_t request;
+            if (++retries > GCS_RETRIES) {
+                ++failedRefreshes;
+                state = GCS_IDLE;
+                nextRefresh = now;
+            } else {
+                if (state == GCS_WAIT_COUNT) {
+                    mavlink_msg_mission_request_list_pack(GCS_SYSID, GCS_COMPID, &request, 20, MAV_COMP_ID_ALL);
+                } else {
+                    mavlink_msg_mission_request_pack(GCS_SYSID, GCS_COMPID, &request, 20, MAV_COMP_ID_ALL, index);
+                }
+                GcsSend(&request);
+                deadline = now + GCS_TIMEOUT;
+            }
+        }
+
+        if (state == GCS_IDLE && now >= nextRefresh) {
+            mavlink_message_t request;
+            mavlink_msg_mission_request_list_pack(GCS_SYSID, GCS_COMPID, &request, 20, MAV_COMP_ID_ALL);
+            GcsSend(&request);
+            state = GCS_WAIT_COUNT;
+            retries = 0;
+            deadline = now + GCS_TIMEOUT;
+        }
+
+        if (idle) {
+            usleep(100);
+        }
+    }
+    return NULL;
+}
+
+static void PrintStats(void)
+{
+    printf("%8.1fs: %llu refreshes (%llu failed), %llu frames (%llu lost), %llu/%llu bytes up/down, "
+           "%llu RX/%llu TX ISRs, %llu interrupts (%llu deferred) + %llu at accesses, %llu RX overruns, %llu TX FIFO overflows\n",
+           SimTimeUs() / 1e6, (unsigned long long)refreshes, (unsigned long long)failedRefreshes,
+           (unsigned long long)framesReceived, (unsigned long long)framesLost,
+           (unsigned long long)bytesUp, (unsigned long long)bytesDown,
+           (unsigned long long)rxInterrupts, (unsigned long long)txInterrupts,
+           (unsigned long long)interruptsRequested, (unsigned long long)interruptsDeferred,
+           (unsigned long long)accessPreemptions,
+           (unsigned long long)rxOverruns, (unsigned long long)txOverflows);
+    fflush(stdout);
+}
+
+// Not used by anything the harness exercises, but referenced by MavlinkGlue.c.
+void lla2ltp(const int32_t x[3], float y[3])
+{
+    (void)x;
+    y[0] = y[1] = y[2] = 0;
+}
+
+int main(int argc, char *argv[])
+{
+    double duration = 60;
+    seed = (unsigned)time(NULL);
+
+    int opt;
+    while ((opt = getopt(argc, argv, "t:x:g:p:s:")) != -1) {
+        switch (opt) {
+        case 't':
+            duration = atof(optarg);
+            break;
+        case 'x':
+            speedup = atof(optarg);
+            break;
+        case 'g':
+            if (sscanf(optarg, "%u:%u", &minGapUs, &maxGapUs) != 2 || minGapUs > maxGapUs) {
+                fprintf(stderr, "Invalid interrupt gap '%s'\n", optarg);
+                return 2;
+            }
+            break;
+        case 'p':
+            accessPreemptChance = atof(optarg);
+            break;
+        case 's':
+            seed = (unsigned)strtoul(optarg, NULL, 0);
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-t seconds] [-x speedup] [-g min:max] [-p chance] [-s seed]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (speedup <= 0) {
+        fprintf(stderr, "The speedup must be positive\n");
+        return 2;
+    }
+    srand(seed);
+    accessPreemptState = seed + 1;
+    printf("Running for %gs at %gx with interrupts every %u-%uus and at %g of accesses, seed %u.\n",
+           duration, speedup, minGapUs, maxGapUs, accessPreemptChance, seed);
+
+    clock_gettime(CLOCK_MONOTONIC, &startTime);
+
+    struct sigaction action = {0};
+    action.sa_handler = InterruptHandler;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGUSR1, &action, NULL);
+
+    // Only the firmware thread takes interrupts, so block them in the others.
+    sigset_t interruptSet;
+    sigemptyset(&interruptSet);
+    sigaddset(&interruptSet, SIGUSR1);
+    pthread_sigmask(SIG_BLOCK, &interruptSet, NULL);
+
+    // Start up the firmware like MavCorruptNode.c does.
+    firmwareThread = pthread_self();
+    Uart1Init(BAUD115200_BRG_REG);
+    MavLinkInit();
+    int i;
+    for (i = 0; i < 15; ++i) {
+        mList[i].x = i;
+        mList[i].y = 100.0;
+        mList[i].z = i;
+        mList[i].param1 = 1;
+        mList[i].param2 = 2;
+        mList[i].param3 = 3;
+        mList[i].param4 = 4;
+        mList[i].command = MAV_CMD_NAV_WAYPOINT;
+        mList[i].frame = MAV_FRAME_LOCAL_NED;
+        mList[i].autocontinue = true;
+    }
+
+    pthread_t interruptThread, groundstationThread;
+    pthread_create(&interruptThread, NULL, InterruptThread, NULL);
+    pthread_create(&groundstationThread, NULL, GroundstationThread, NULL);
+    pthread_sigmask(SIG_UNBLOCK, &interruptSet, NULL);
+
+    MavLinkSendStatusText(MAV_SEVERITY_INFO, "Finished initialization for MAV_CORRUPT_NODE");
+
+    double next100Hz = SimTimeUs();
+    double nextStats = NowUs() + 5e6;
+    while (running) {
+        MavLinkReceive();
+
+        const double now = SimTimeUs();
+        if (now >= next100Hz) {
+            IncrementMissionCounter();
+            if (nodeSystemTime < UINT32_MAX) {
+                ++nodeSystemTime;
+            }
+            MavLinkTransmit();
+            next100Hz += 10000;
+        }
+
+        const double real = NowUs();
+        if (real >= nextStats) {
+            PrintStats();
+            nextStats += 5e6;
+        }
+        if (duration > 0 && real >= duration * 1e6) {
+            running = false;
+        }
+    }
+
+    pthread_sigmask(SIG_BLOCK, &interruptSet, NULL);
+    pthread_join(interruptThread, NULL);
+    pthread_join(groundstationThread, NULL);
+    PrintStats();
+
+    if (corrupted) {
+        printf("Seed %u.\n", seed);
+        return 1;
+    }
+    printf("No corruption found.\n");
+    return 0;
+}
@@ -0,0 +1,142 @@
+/**
+ * @file
+ * @brief Runs the MAV_CORRUPT_NODE firmware on a PC against a real groundstation.
+ *
+ * The firmware side is the same MavlinkGlue.c as in CorruptHarness.c, but with UartHost.c in
+ * place of Uart1.c, so UART1 is a pty or TCP socket that QGroundControl, MAVProxy, or
+ * mavlink_router can connect to. The link can be paced at the real 115200 baud and run through
+ * a model of the radio link, to try the mission protocol against the groundstation over a slow or
+ * lossy link.
+ *
+ * With gcc, from mav_corrupt_test: `gcc -O2 -std=gnu99 -I. -I../Libs/C -I../Libs/MAVLink/seaslug host/SilNode.c MavlinkGlue.c ../Libs/C/UartHost.c ../Libs/C/TxQueue.c ../Libs/C/CircularBuffer.c ../Libs/C/MessageScheduler.c -lm -o sil_node`
+ *
+ * Usage: `sil_node [-e endpoint] [-b] [-l ms] [-w bytes/s] [-d chance] [-f bytes]`
+ *  * -e: The UART1 endpoint, see UartHost.h. Defaults to `tcp:5760`, which QGC can connect to.
+ *  * -b: Paces the link at the baud rate.
+ *  * -l: The radio link's latency in milliseconds.
+ *  * -w: The radio link's bandwidth in bytes/s.
+ *  * -d: The chance each radio frame is dropped.
+ *  * -f: The radio frame size in bytes.
+ */
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "Uart1.h"
+#include "UartHost.h"
+#include "MessageScheduler.h"
+#include "MavlinkGlue.h"
+#include "MavCorruptNode.h"
+
+static volatile sig_atomic_t running = 1;
+
+static void Stop(int signal)
+{
+    (void)signal;
+    running = 0;
+}
+
+/**
+ * @return The time from a monotonic clock in microseconds.
+ */
+static uint64_t NowUs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
+// Not used by anything the groundstation can trigger, but referenced by MavlinkGlue.c.
+void lla2ltp(const int32_t x[3], float y[3])
+{
+    (void)x;
+    y[0] = y[1] = y[2] = 0;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *endpoint = "tcp:5760";
+    bool pace = false;
+    UartHostRadio radio = {0};
+
+    int opt;
+    while ((opt = getopt(argc, argv, "e:bl:w:d:f:")) != -1) {
+        switch (opt) {
+        case 'e':
+            endpoint = optarg;
+            break;
+        case 'b':
+            pace = true;
+            break;
+        case 'l':
+            radio.latencyUs = (uint32_t)(atof(optarg) * 1000);
+            break;
+        case 'w':
+            radio.bandwidth = (uint32_t)strtoul(optarg, NULL, 10);
+            break;
+        case 'd':
+            radio.lossChance = (float)atof(optarg);
+            break;
+        case 'f':
+            radio.frameSize = (uint16_t)strtoul(optarg, NULL, 10);
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-e endpoint] [-b] [-l ms] [-w bytes/s] [-d chance] [-f bytes]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    signal(SIGINT, Stop);
+    signal(SIGTERM, Stop);
+
+    // Start up the firmware like MavCorruptNode.c does.
+    Uart1Init(BAUD115200_BRG_REG);
+    if (!UartHostOpen(UART_HOST_UART1, endpoint)) {
+        return 1;
+    }
+    UartHostSetPacing(UART_HOST_UART1, pace);
+    UartHostSetRadio(UART_HOST_UART1, &radio);
+    MavLinkInit();
+    int i;
+    for (i = 0; i < 15; ++i) {
+        mList[i].x = i;
+        mList[i].y = 100.0;
+        mList[i].z = i;
+        mList[i].param1 = 1;
+        mList[i].param2 = 2;
+        mList[i].param3 = 3;
+        mList[i].param4 = 4;
+        mList[i].command = MAV_CMD_NAV_WAYPOINT;
+        mList[i].frame = MAV_FRAME_LOCAL_NED;
+        mList[i].autocontinue = true;
+    }
+
+    MavLinkSendStatusText(MAV_SEVERITY_INFO, "Finished initialization for MAV_CORRUPT_NODE");
+
+    uint64_t next100Hz = NowUs();
+    while (running) {
+        UartHostPoll(1);
+        MavLinkReceive();
+
+        if (NowUs() >= next100Hz) {
+            IncrementMissionCounter();
+            if (nodeSystemTime < UINT32_MAX) {
+                ++nodeSystemTime;
+            }
+            MavLinkTransmit();
+            next100Hz += 10000;
+        }
+    }
+
+    const UartHostStats *s = &uartHostStats[UART_HOST_UART1];
+    printf("%llu bytes sent (%llu lost, %llu discarded), %llu received (%llu lost, %llu overruns).\n",
+           (unsigned long long)s->txBytes, (unsigned long long)s->txLost,
+           (unsigned long long)s->txDiscarded, (unsigned long long)s->rxBytes,
+           (unsigned long long)s->rxLost, (unsigned long long)s->rxOverruns);
+    UartHostClose(UART_HOST_UART1);
+    return 0;
+}
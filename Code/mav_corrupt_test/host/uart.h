@@ -0,0 +1,51 @@
+#ifndef HOST_UART_H
+#define HOST_UART_H
+
+/**
+ * @file
+ * @brief Stands in for the Microchip peripheral library's uart.h when building mav_corrupt_test on a
+ * PC. Only the UART1 functions that Uart1.c uses are provided.
+ *
+ * The configuration values are AND-ed together like the real ones. Apart from the interrupt
+ * enables all settings are ignored, the model always runs at 115200 baud, 8N1.
+ */
+
+#include <stdint.h>
+
+#define UART_EN                  0xFFFF
+#define UART_IDLE_CON            0xFFFF
+#define UART_IrDA_DISABLE        0xFFFF
+#define UART_MODE_FLOW           0xFFFF
+#define UART_UEN_00              0xFFFF
+#define UART_EN_WAKE             0xFFFF
+#define UART_DIS_LOOPBACK        0xFFFF
+#define UART_DIS_ABAUD           0xFFFF
+#define UART_NO_PAR_8BIT         0xFFFF
+#define UART_UXRX_IDLE_ONE       0xFFFF
+#define UART_BRGH_SIXTEEN        0xFFFF
+#define UART_1STOPBIT            0xFFFF
+#define UART_INT_TX_LAST_CH      0xFFFF
+#define UART_IrDA_POL_INV_ZERO   0xFFFF
+#define UART_SYNC_BREAK_DISABLED 0xFFFF
+#define UART_TX_ENABLE           0xFFFF
+#define UART_INT_RX_CHAR         0xFFFF
+#define UART_INT_RX_3_4_FUL      0xFFFF
+#define UART_ADR_DETECT_DIS      0xFFFF
+#define UART_RX_OVERRUN_CLEAR    0xFFFF
+
+#define UART_RX_INT_EN  0xFFFF
+#define UART_RX_INT_DIS 0xFFFE
+#define UART_TX_INT_EN  0xFFFF
+#define UART_TX_INT_DIS 0xFFFD
+#define UART_RX_INT_PR6 0xFFFF
+#define UART_TX_INT_PR6 0xFFFF
+
+void SimUart1Open(uint16_t brg);
+void SimUart1Close(void);
+void SimUart1ConfigInt(uint16_t config);
+
+#define OpenUART1(mode, sta, brg) SimUart1Open(brg)
+#define CloseUART1() SimUart1Close()
+#define ConfigIntUART1(config) SimUart1ConfigInt(config)
+
+#endif // HOST_UART_H
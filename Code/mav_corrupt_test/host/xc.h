@@ -0,0 +1,82 @@
+#ifndef HOST_XC_H
+#define HOST_XC_H
+
+/**
+ * @file
+ * @brief Stands in for the XC16 device header when building mav_corrupt_test on a PC.
+ *
+ * Only the UART1 registers and interrupt bits that Uart1.c uses are provided. They're backed by the
+ * UART model in CorruptHarness.c, which plays the part of the peripheral and the interrupt
+ * controller. Status bits are only ever written by the model and the ISRs, so main-line code only
+ * reads them, like on the real chip.
+ */
+
+#include <stdint.h>
+
+typedef struct {
+    unsigned URXDA:1;
+    unsigned OERR:1;
+    unsigned FERR:1;
+    unsigned PERR:1;
+    unsigned RIDLE:1;
+    unsigned ADDEN:1;
+    unsigned URXISEL:2;
+    unsigned TRMT:1;
+    unsigned UTXBF:1;
+    unsigned UTXEN:1;
+    unsigned UTXBRK:1;
+    unsigned :1;
+    unsigned UTXISEL0:1;
+    unsigned UTXINV:1;
+    unsigned UTXISEL1:1;
+} U1STABITS;
+
+typedef struct {
+    unsigned :15;
+    unsigned UARTEN:1;
+} U1MODEBITS;
+
+typedef struct {
+    unsigned :11;
+    unsigned U1RXIE:1;
+    unsigned U1TXIE:1;
+    unsigned :3;
+} IEC0BITS;
+
+typedef struct {
+    unsigned :11;
+    unsigned U1RXIF:1;
+    unsigned U1TXIF:1;
+    unsigned :3;
+} IFS0BITS;
+
+extern volatile U1STABITS U1STAbits;
+extern volatile U1MODEBITS U1MODEbits;
+extern volatile IFS0BITS IFS0bits;
+extern volatile uint16_t U1BRG;
+
+/**
+ * Every main-line access to IEC0bits is a point where the model may interrupt, as the races with the
+ * ISRs are around where interrupts are enabled and disabled.
+ */
+volatile IEC0BITS *SimIec0(void);
+#define IEC0bits (*SimIec0())
+
+/**
+ * Reading U1RXREG pops the next byte out of the receive FIFO.
+ */
+uint16_t SimUart1ReadRx(void);
+#define U1RXREG SimUart1ReadRx()
+
+/**
+ * Writing U1TXREG stores into the next free slot of the transmit FIFO. The slot is claimed before
+ * the value is stored, so the model waits for the store before shifting it out. This is also a
+ * point where the model may interrupt.
+ */
+volatile uint16_t *SimUart1TxSlot(void);
+#define U1TXREG (*SimUart1TxSlot())
+
+// Interrupts are dispatched by the UART model, so ISRs are just regular functions.
+#define _ISR
+
+#endif // HOST_XC_H
@@ -12,8 +12,12 @@
 // Include user headers
 #include "mavlink.h"
 #include "Timer2.h"
+#include "StreamAnalytics.h"
 
 void MavlinkObserverTime4Hz(void);
+static void PutString(const char *s);
+static void SendSummaryByte(void);
+static uint32_t GetTimeUs(void);
 
 static const char startupString[] = "[%lu]: STARTUP - Monitoring UART1 for valid MAVLink data.\n";
 static const char errorString[] = "[%lu]: ERROR - MAVLink corruption found in remote system; resetting it. (remote system time %lu)\n";
@@ -61,6 +65,14 @@ static uint32_t remoteSystemTime = 0; // Seconds since the remote (watched) syst
 static bool sendUpdate = false; // Event flag for triggering a UART transmission update.
 static int state = GOOD;
 
+// Stream analytics are summarized once a second and sent out a byte at a time from the main loop,
+// so that sending them doesn't block reading the watched stream.
+static volatile bool sendSummary = false; // Event flag for starting a new stream summary.
+static volatile uint32_t quarterSeconds = 0; // Timer2 periods since the system powered on.
+static uint8_t summary[STREAM_SUMMARY_MAX_SIZE];
+static uint16_t summarySize = 0;
+static uint16_t summarySent = 0;
+
 int main()
 {
 	/// First step is to move over to the FRC w/ PLL clock from the default FRC clock.
@@ -123,7 +135,9 @@ int main()
 	// Let the user know we're running. Do this every hour as well
 	char outString[100];
 	snprintf(outString, sizeof(outString), startupString, systemTime);
-	putsUART1((unsigned int*)outString);
+	PutString(outString);
+
+	StreamAnalyticsInit();
 
 	// Track if this is the first SYSTEM_TIME mesage received, as we only want to print the message
 	// that we received a message when we receive the first one.
@@ -143,7 +157,13 @@ int main()
 
 		if (U1STAbits.URXDA) {
 			uint8_t c = (uint8_t)U1RXREG;
-			if (mavlink_parse_char(MAVLINK_COMM_0, c, &msg, &status)) {
+			StreamAnalyticsRecordBytes(1);
+			uint8_t result = mavlink_frame_char(MAVLINK_COMM_0, c, &msg, &status);
+			if (result == MAVLINK_FRAMING_BAD_CRC) {
+				StreamAnalyticsRecordCrcFailure(msg.msgid, msg.len + MAVLINK_NUM_NON_PAYLOAD_BYTES);
+			}
+			if (result == MAVLINK_FRAMING_OK) {
+				StreamAnalyticsRecordMessage(msg.sysid, msg.compid, msg.msgid, msg.seq, msg.len + MAVLINK_NUM_NON_PAYLOAD_BYTES, GetTimeUs());
 
 				// If it's a system time message, log the remote system time
 				if (msg.msgid == MAVLINK_MSG_ID_SYSTEM_TIME) {
@@ -153,7 +173,7 @@ int main()
 					if (firstTimestamp) {
 						char outString[120];
 						snprintf(outString, sizeof(outString), timeString, systemTime, remoteSystemTime);
-						putsUART1((unsigned int*)outString);
+						PutString(outString);
 						firstTimestamp = false;
 					}
 				} else {
@@ -179,7 +199,7 @@ int main()
 					// Now we report the error by printing to UART1
 					char outString[150];
 					snprintf(outString, sizeof(outString), errorString, systemTime, remoteSystemTime);
-					putsUART1((unsigned int*)outString);
+					PutString(outString);
 
 					// Reset our watcher now.
 					remoteSystemTime = 0;
@@ -202,6 +222,20 @@ int main()
 			}
 		}
 
+		// Start sending a new stream summary every second, finishing the last one first if the UART
+		// has fallen behind.
+		if (sendSummary) {
+			while (summarySent < summarySize) {
+				SendSummaryByte();
+			}
+			summarySize = StreamAnalyticsEncodeSummary(systemTime, summary);
+			summarySent = 0;
+			sendSummary = false;
+		}
+		if (summarySent < summarySize && !U1STAbits.UTXBF) {
+			SendSummaryByte();
+		}
+
 		// Output a status message every 15m. Let's us know the system's still active.
 		if (sendUpdate) {
 			char outString[120];
@@ -210,14 +244,55 @@ int main()
 			} else {
 				snprintf(outString, sizeof(outString), goodUpdateString, systemTime, remoteSystemTime);
 			}
-			putsUART1((unsigned int*)outString);
+			PutString(outString);
 			sendUpdate = false;
 		}
 	}
 }
 
+/**
+ * Writes a string out of UART1. Any summary still being sent is finished first so the two don't
+ * interleave.
+ */
+static void PutString(const char *s)
+{
+	while (summarySent < summarySize) {
+		SendSummaryByte();
+	}
+	putsUART1((unsigned int*)s);
+}
+
+/**
+ * Writes the next byte of the current stream summary out of UART1, waiting for room if necessary.
+ */
+static void SendSummaryByte(void)
+{
+	while (U1STAbits.UTXBF);
+	U1TXREG = summary[summarySent++];
+}
+
+/**
+ * Returns the time since power on in microseconds, built from the Timer2 period count and its
+ * counter, which ticks every 6.4us.
+ */
+static uint32_t GetTimeUs(void)
+{
+	uint32_t periods;
+	uint16_t ticks;
+
+	// Re-read if Timer2 rolled over in between reading the two.
+	do {
+		periods = quarterSeconds;
+		ticks = TMR2;
+	} while (periods != quarterSeconds);
+
+	return periods * 250000UL + (uint32_t)ticks * 32 / 5;
+}
+
 void MavlinkObserverTime4Hz(void)
 {
+	++quarterSeconds;
+
     // Keep a variable here for scaling the 4Hz timer to a 1Hz timer.
 	static int timerCounter = 0;
 
@@ -228,6 +303,9 @@ void MavlinkObserverTime4Hz(void)
 		// Increment the system time.
 		++systemTime;
 
+		// And close out the stream analytics window.
+		sendSummary = true;
+
 		// Flag that an update message should be sent out if it's been 15 minutes.
 		if (systemTime % UPDATE_PERIOD == 0) {
 			sendUpdate = true;
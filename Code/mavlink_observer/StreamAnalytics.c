@@ -0,0 +1,509 @@
+/**
+ * @file
+ * @brief Implements the MAVLink stream analytics declared in StreamAnalytics.h.
+ *
+ * Unit testing has been completed on x86 by compiling with the UNIT_TEST_STREAM_ANALYTICS macro.
+ * With gcc: `gcc StreamAnalytics.c -DUNIT_TEST_STREAM_ANALYTICS -Wall -g`
+ */
+#include "StreamAnalytics.h"
+
+#include <stddef.h>
+#include <string.h>
+
+// Sequence gaps this large or larger are assumed to not be from lost messages.
+#define MAX_SEQUENCE_GAP 128
+
+// The running mean interval and jitter are smoothed over about this many messages.
+#define SMOOTHING 16
+
+typedef struct {
+    uint8_t msgid;
+
+    // Counts for the current window.
+    uint16_t messages;
+    uint16_t bytes;
+    uint8_t crcFailures;
+
+    // Inter-arrival statistics, kept across windows. All times are in us.
+    uint8_t arrivals;      // Saturates at 2, which is all that's needed to know what's valid.
+    uint32_t lastArrival;
+    uint32_t lastInterval;
+    uint32_t meanInterval;
+    uint32_t jitter;
+} MessageEntry;
+
+typedef struct {
+    uint8_t sysid;
+    uint8_t compid;
+    uint8_t lastSeq;
+
+    // Counts for the current window.
+    uint16_t received;
+    uint16_t lost;
+} SystemEntry;
+
+// Maps every message ID to its index in the message table plus 1, so that 0 marks an unused ID.
+static uint8_t messageSlots[256];
+static MessageEntry messages[STREAM_ANALYTICS_MAX_MESSAGES];
+static uint8_t messageCount;
+
+static SystemEntry systems[STREAM_ANALYTICS_MAX_SYSTEMS];
+static uint8_t systemCount;
+
+// Byte counts for the current window.
+static uint32_t windowBytes;
+static uint32_t windowParsedBytes;
+
+/**
+ * Adds to a 16-bit counter without overflowing.
+ */
+static uint16_t SaturatingAdd(uint16_t a, uint16_t b)
+{
+    return (a > UINT16_MAX - b) ? UINT16_MAX : a + b;
+}
+
+/**
+ * Calculates the MAVLink (X.25) CRC of a buffer.
+ */
+static uint16_t Crc(const uint8_t *data, uint16_t size)
+{
+    uint16_t crc = 0xFFFF;
+    uint16_t i;
+    for (i = 0; i < size; ++i) {
+        uint8_t tmp = data[i] ^ (uint8_t)(crc & 0xFF);
+        tmp ^= (tmp << 4);
+        crc = (crc >> 8) ^ ((uint16_t)tmp << 8) ^ ((uint16_t)tmp << 3) ^ (tmp >> 4);
+    }
+    return crc;
+}
+
+static void Put16(uint8_t *p, uint16_t value)
+{
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+}
+
+static uint16_t Get16(const uint8_t *p)
+{
+    return p[0] | ((uint16_t)p[1] << 8);
+}
+
+void StreamAnalyticsInit(void)
+{
+    memset(messageSlots, 0, sizeof(messageSlots));
+    messageCount = 0;
+    systemCount = 0;
+    windowBytes = 0;
+    windowParsedBytes = 0;
+}
+
+void StreamAnalyticsRecordBytes(uint16_t count)
+{
+    windowBytes += count;
+}
+
+void StreamAnalyticsRecordMessage(uint8_t sysid, uint8_t compid, uint8_t msgid, uint8_t seq, uint16_t size, uint32_t timeUs)
+{
+    windowParsedBytes += size;
+
+    // Find or add the entry for this message ID.
+    MessageEntry *m = NULL;
+    if (messageSlots[msgid]) {
+        m = &messages[messageSlots[msgid] - 1];
+    } else if (messageCount < STREAM_ANALYTICS_MAX_MESSAGES) {
+        m = &messages[messageCount++];
+        memset(m, 0, sizeof(*m));
+        m->msgid = msgid;
+        messageSlots[msgid] = messageCount;
+    }
+
+    if (m) {
+        m->messages = SaturatingAdd(m->messages, 1);
+        m->bytes = SaturatingAdd(m->bytes, size);
+
+        if (m->arrivals > 0) {
+            const uint32_t interval = timeUs - m->lastArrival;
+            if (m->arrivals == 1) {
+                m->meanInterval = interval;
+                m->arrivals = 2;
+            } else {
+                m->meanInterval += ((int32_t)(interval - m->meanInterval)) / SMOOTHING;
+                const uint32_t change = (interval > m->lastInterval) ? interval - m->lastInterval : m->lastInterval - interval;
+                m->jitter += ((int32_t)(change - m->jitter)) / SMOOTHING;
+            }
+            m->lastInterval = interval;
+        } else {
+            m->arrivals = 1;
+        }
+        m->lastArrival = timeUs;
+    }
+
+    // There are only ever a few senders, so a linear search is fine.
+    uint8_t i;
+    for (i = 0; i < systemCount; ++i) {
+        SystemEntry *s = &systems[i];
+        if (s->sysid == sysid && s->compid == compid) {
+            const uint8_t gap = (uint8_t)(seq - s->lastSeq - 1);
+            if (gap < MAX_SEQUENCE_GAP) {
+                s->lost = SaturatingAdd(s->lost, gap);
+            }
+            s->lastSeq = seq;
+            s->received = SaturatingAdd(s->received, 1);
+            return;
+        }
+    }
+    if (systemCount < STREAM_ANALYTICS_MAX_SYSTEMS) {
+        SystemEntry *s = &systems[systemCount++];
+        s->sysid = sysid;
+        s->compid = compid;
+        s->lastSeq = seq;
+        s->received = 1;
+        s->lost = 0;
+    }
+}
+
+void StreamAnalyticsRecordCrcFailure(uint8_t msgid, uint16_t size)
+{
+    // A corrupted message ID would fill the table with junk entries, so failures are only counted
+    // against message IDs that have been seen intact. Anything else is counted as unparsed.
+    if (messageSlots[msgid]) {
+        MessageEntry *m = &messages[messageSlots[msgid] - 1];
+        if (m->crcFailures < UINT8_MAX) {
+            ++m->crcFailures;
+        }
+        windowParsedBytes += size;
+    }
+}
+
+uint16_t StreamAnalyticsEncodeSummary(uint32_t time, uint8_t *buffer)
+{
+    uint8_t *p = buffer + STREAM_SUMMARY_HEADER_SIZE;
+
+    uint8_t includedMessages = 0;
+    uint8_t i;
+    for (i = 0; i < messageCount; ++i) {
+        MessageEntry *m = &messages[i];
+        if (m->messages || m->crcFailures) {
+            const uint32_t interval = m->meanInterval / 100;
+            p[0] = m->msgid;
+            Put16(&p[1], m->messages);
+            Put16(&p[3], m->bytes);
+            p[5] = m->crcFailures;
+            Put16(&p[6], (interval > UINT16_MAX) ? UINT16_MAX : (uint16_t)interval);
+            Put16(&p[8], (m->jitter > UINT16_MAX) ? UINT16_MAX : (uint16_t)m->jitter);
+            p += STREAM_SUMMARY_MESSAGE_SIZE;
+            ++includedMessages;
+        }
+        m->messages = 0;
+        m->bytes = 0;
+        m->crcFailures = 0;
+    }
+
+    uint8_t includedSystems = 0;
+    for (i = 0; i < systemCount; ++i) {
+        SystemEntry *s = &systems[i];
+        if (s->received) {
+            p[0] = s->sysid;
+            p[1] = s->compid;
+            Put16(&p[2], s->received);
+            Put16(&p[4], s->lost);
+            p += STREAM_SUMMARY_SYSTEM_SIZE;
+            ++includedSystems;
+        }
+        s->received = 0;
+        s->lost = 0;
+    }
+
+    // A message can straddle two windows, so its bytes may have been counted in the last one.
+    const uint32_t unparsed = (windowBytes > windowParsedBytes) ? windowBytes - windowParsedBytes : 0;
+
+    buffer[0] = STREAM_SUMMARY_SYNC0;
+    buffer[1] = STREAM_SUMMARY_SYNC1;
+    buffer[2] = STREAM_SUMMARY_VERSION;
+    buffer[3] = includedMessages;
+    buffer[4] = includedSystems;
+    Put16(&buffer[5], (uint16_t)time);
+    Put16(&buffer[7], (uint16_t)(time >> 16));
+    Put16(&buffer[9], (windowBytes > UINT16_MAX) ? UINT16_MAX : (uint16_t)windowBytes);
+    Put16(&buffer[11], (unparsed > UINT16_MAX) ? UINT16_MAX : (uint16_t)unparsed);
+    windowBytes = 0;
+    windowParsedBytes = 0;
+
+    Put16(p, Crc(buffer + 2, (uint16_t)(p - buffer - 2)));
+    p += 2;
+
+    return (uint16_t)(p - buffer);
+}
+
+uint16_t StreamAnalyticsDecodeSummary(const uint8_t *buffer, uint16_t size, StreamSummary *summary)
+{
+    if (size < STREAM_SUMMARY_HEADER_SIZE + 2 ||
+        buffer[0] != STREAM_SUMMARY_SYNC0 || buffer[1] != STREAM_SUMMARY_SYNC1 ||
+        buffer[2] != STREAM_SUMMARY_VERSION ||
+        buffer[3] > STREAM_ANALYTICS_MAX_MESSAGES || buffer[4] > STREAM_ANALYTICS_MAX_SYSTEMS) {
+        return 0;
+    }
+
+    const uint16_t length = STREAM_SUMMARY_HEADER_SIZE + buffer[3] * STREAM_SUMMARY_MESSAGE_SIZE +
+                            buffer[4] * STREAM_SUMMARY_SYSTEM_SIZE;
+    if (size < length + 2 || Crc(buffer + 2, length - 2) != Get16(&buffer[length])) {
+        return 0;
+    }
+
+    summary->messageCount = buffer[3];
+    summary->systemCount = buffer[4];
+    summary->time = Get16(&buffer[5]) | ((uint32_t)Get16(&buffer[7]) << 16);
+    summary->bytes = Get16(&buffer[9]);
+    summary->unparsedBytes = Get16(&buffer[11]);
+
+    const uint8_t *p = buffer + STREAM_SUMMARY_HEADER_SIZE;
+    uint8_t i;
+    for (i = 0; i < summary->messageCount; ++i) {
+        StreamMessageSummary *m = &summary->messages[i];
+        m->msgid = p[0];
+        m->messages = Get16(&p[1]);
+        m->bytes = Get16(&p[3]);
+        m->crcFailures = p[5];
+        m->interval = Get16(&p[6]);
+        m->jitter = Get16(&p[8]);
+        p += STREAM_SUMMARY_MESSAGE_SIZE;
+    }
+    for (i = 0; i < summary->systemCount; ++i) {
+        StreamSystemSummary *s = &summary->systems[i];
+        s->sysid = p[0];
+        s->compid = p[1];
+        s->received = Get16(&p[2]);
+        s->lost = Get16(&p[4]);
+        p += STREAM_SUMMARY_SYSTEM_SIZE;
+    }
+
+    return length + 2;
+}
+
+#ifdef UNIT_TEST_STREAM_ANALYTICS
+
+#include <stdio.h>
+#include <assert.h>
+
+int main()
+{
+    printf("Testing StreamAnalytics.c. All errors will be reported as failed assertions.\n");
+
+    uint8_t buffer[STREAM_SUMMARY_MAX_SIZE];
+    StreamSummary summary;
+    uint16_t size;
+
+    // An empty window is just a header and CRC.
+    StreamAnalyticsInit();
+    size = StreamAnalyticsEncodeSummary(1, buffer);
+    assert(size == STREAM_SUMMARY_HEADER_SIZE + 2);
+    assert(StreamAnalyticsDecodeSummary(buffer, size, &summary) == size);
+    assert(summary.time == 1 && summary.messageCount == 0 && summary.systemCount == 0);
+
+    // A 10Hz message with 1ms of alternating jitter and a 1Hz message, with one lost message and
+    // 20 bytes of garbage.
+    uint32_t t = 0;
+    uint8_t seq = 0;
+    int i;
+    for (i = 0; i < 10; ++i) {
+        StreamAnalyticsRecordBytes(36);
+        StreamAnalyticsRecordMessage(1, 2, 30, seq++, 36, t);
+        t += (i & 1) ? 99000 : 101000;
+        if (i == 5) {
+            ++seq;
+        }
+    }
+    StreamAnalyticsRecordBytes(17);
+    StreamAnalyticsRecordMessage(1, 2, 0, seq++, 17, t);
+    StreamAnalyticsRecordBytes(20);
+    StreamAnalyticsRecordBytes(36);
+    StreamAnalyticsRecordCrcFailure(30, 36);
+
+    // A message from another component is tracked separately.
+    StreamAnalyticsRecordBytes(17);
+    StreamAnalyticsRecordMessage(255, 190, 0, 7, 17, t);
+
+    size = StreamAnalyticsEncodeSummary(0x12345678, buffer);
+    assert(size == STREAM_SUMMARY_HEADER_SIZE + 2 * STREAM_SUMMARY_MESSAGE_SIZE + 2 * STREAM_SUMMARY_SYSTEM_SIZE + 2);
+    assert(StreamAnalyticsDecodeSummary(buffer, size, &summary) == size);
+    assert(summary.time == 0x12345678);
+    assert(summary.bytes == 10 * 36 + 17 + 20 + 36 + 17);
+    assert(summary.unparsedBytes == 20);
+    assert(summary.messageCount == 2);
+    assert(summary.messages[0].msgid == 30);
+    assert(summary.messages[0].messages == 10);
+    assert(summary.messages[0].bytes == 360);
+    assert(summary.messages[0].crcFailures == 1);
+    assert(summary.messages[0].interval >= 990 && summary.messages[0].interval <= 1010);
+    assert(summary.messages[0].jitter > 0 && summary.messages[0].jitter <= 2000);
+    assert(summary.messages[1].msgid == 0);
+    assert(summary.messages[1].messages == 2);
+    assert(summary.systemCount == 2);
+    assert(summary.systems[0].sysid == 1 && summary.systems[0].compid == 2);
+    assert(summary.systems[0].received == 11 && summary.systems[0].lost == 1);
+    assert(summary.systems[1].sysid == 255 && summary.systems[1].compid == 190);
+    assert(summary.systems[1].received == 1 && summary.systems[1].lost == 0);
+
+    // A perfectly periodic message has no jitter.
+    StreamAnalyticsInit();
+    for (i = 0; i < 100; ++i) {
+        StreamAnalyticsRecordMessage(1, 1, 74, (uint8_t)i, 28, i * 200000u);
+    }
+    size = StreamAnalyticsEncodeSummary(2, buffer);
+    assert(StreamAnalyticsDecodeSummary(buffer, size, &summary) == size);
+    assert(summary.messages[0].interval == 2000);
+    assert(summary.messages[0].jitter == 0);
+
+    // The window counts are reset but the interval statistics carry over, including across the
+    // clock wrapping around.
+    StreamAnalyticsRecordMessage(1, 1, 74, 100, 28, 100 * 200000u);
+    StreamAnalyticsInit();
+    t = UINT32_MAX - 100000;
+    for (i = 0; i < 4; ++i) {
+        StreamAnalyticsRecordMessage(1, 1, 74, (uint8_t)i, 28, t);
+        t += 200000;
+    }
+    size = StreamAnalyticsEncodeSummary(3, buffer);
+    assert(StreamAnalyticsDecodeSummary(buffer, size, &summary) == size);
+    assert(summary.messages[0].messages == 4);
+    assert(summary.messages[0].interval == 2000);
+    size = StreamAnalyticsEncodeSummary(4, buffer);
+    assert(StreamAnalyticsDecodeSummary(buffer, size, &summary) == size);
+    assert(summary.messageCount == 0 && summary.systemCount == 0);
+
+    // CRC failures for unseen message IDs don't create entries.
+    StreamAnalyticsRecordCrcFailure(99, 20);
+    StreamAnalyticsRecordBytes(20);
+    size = StreamAnalyticsEncodeSummary(5, buffer);
+    assert(StreamAnalyticsDecodeSummary(buffer, size, &summary) == size);
+    assert(summary.messageCount == 0 && summary.unparsedBytes == 20);
+
+    // Fill every table to make sure the largest summary fits.
+    StreamAnalyticsInit();
+    for (i = 0; i < 256; ++i) {
+        StreamAnalyticsRecordMessage((uint8_t)i, 0, (uint8_t)i, 0, 8, 0);
+    }
+    size = StreamAnalyticsEncodeSummary(6, buffer);
+    assert(size == STREAM_SUMMARY_MAX_SIZE);
+    assert(StreamAnalyticsDecodeSummary(buffer, size, &summary) == size);
+    assert(summary.messageCount == STREAM_ANALYTICS_MAX_MESSAGES);
+    assert(summary.systemCount == STREAM_ANALYTICS_MAX_SYSTEMS);
+
+    // Corrupted or truncated summaries are rejected.
+    assert(!StreamAnalyticsDecodeSummary(buffer, size - 1, &summary));
+    buffer[20] ^= 1;
+    assert(!StreamAnalyticsDecodeSummary(buffer, size, &summary));
+    buffer[20] ^= 1;
+    buffer[0] = 0;
+    assert(!StreamAnalyticsDecodeSummary(buffer, size, &summary));
+
+    printf("All tests passed.\n");
+
+    return 0;
+}
+
+#endif // UNIT_TEST_STREAM_ANALYTICS
+
+#ifdef STREAM_ANALYTICS_TLOG
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "mavlink.h"
+
+/**
+ * Prints a summary as a table.
+ */
+static void PrintSummary(const StreamSummary *summary)
+{
+    static const mavlink_message_info_t info[256] = MAVLINK_MESSAGE_INFO;
+
+    printf("t=%lus bytes=%u unparsed=%u\n", (unsigned long)summary->time, summary->bytes, summary->unparsedBytes);
+    printf("  %3s %-24s %6s %6s %6s %9s %9s\n", "id", "message", "msgs/s", "B/s", "crc%", "interval", "jitter");
+    uint8_t i;
+    for (i = 0; i < summary->messageCount; ++i) {
+        const StreamMessageSummary *m = &summary->messages[i];
+        const unsigned total = m->messages + m->crcFailures;
+        printf("  %3u %-24s %6u %6u %5.1f%% %7.1fms %7.2fms\n", m->msgid, info[m->msgid].name,
+               m->messages, m->bytes, total ? 100.0 * m->crcFailures / total : 0.0,
+               m->interval / 10.0, m->jitter / 1000.0);
+    }
+    for (i = 0; i < summary->systemCount; ++i) {
+        const StreamSystemSummary *s = &summary->systems[i];
+        printf("  system %u/%u: received %u, lost %u\n", s->sysid, s->compid, s->received, s->lost);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s file.tlog [summaries.bin]\n", argv[0]);
+        return 1;
+    }
+
+    FILE *in = fopen(argv[1], "rb");
+    if (!in) {
+        perror(argv[1]);
+        return 1;
+    }
+    FILE *out = NULL;
+    if (argc > 2) {
+        out = fopen(argv[2], "wb");
+        if (!out) {
+            perror(argv[2]);
+            return 1;
+        }
+    }
+
+    StreamAnalyticsInit();
+
+    // Each tlog record is a big-endian timestamp in microseconds followed by a single message.
+    uint64_t windowStart = 0;
+    uint8_t record[8 + MAVLINK_MAX_PACKET_LEN];
+    while (fread(record, 1, 10, in) == 10) {
+        uint64_t usec = 0;
+        int i;
+        for (i = 0; i < 8; ++i) {
+            usec = (usec << 8) | record[i];
+        }
+        const uint16_t frameSize = record[9] + MAVLINK_NUM_NON_PAYLOAD_BYTES;
+        if (fread(record + 10, 1, frameSize - 2, in) != (size_t)(frameSize - 2)) {
+            break;
+        }
+
+        if (!windowStart) {
+            windowStart = usec;
+        }
+        while (usec - windowStart >= 1000000) {
+            uint8_t buffer[STREAM_SUMMARY_MAX_SIZE];
+            StreamSummary summary;
+            windowStart += 1000000;
+            const uint16_t size = StreamAnalyticsEncodeSummary((uint32_t)(windowStart / 1000000), buffer);
+            StreamAnalyticsDecodeSummary(buffer, size, &summary);
+            PrintSummary(&summary);
+            if (out) {
+                fwrite(buffer, 1, size, out);
+            }
+        }
+
+        StreamAnalyticsRecordBytes(frameSize);
+        mavlink_message_t msg;
+        mavlink_status_t status;
+        for (i = 0; i < frameSize; ++i) {
+            const uint8_t result = mavlink_frame_char(MAVLINK_COMM_0, record[8 + i], &msg, &status);
+            if (result == MAVLINK_FRAMING_OK) {
+                StreamAnalyticsRecordMessage(msg.sysid, msg.compid, msg.msgid, msg.seq, frameSize, (uint32_t)usec);
+            } else if (result == MAVLINK_FRAMING_BAD_CRC) {
+                StreamAnalyticsRecordCrcFailure(msg.msgid, frameSize);
+            }
+        }
+    }
+
+    fclose(in);
+    if (out) {
+        fclose(out);
+    }
+    return 0;
+}
+
+#endif // STREAM_ANALYTICS_TLOG
@@ -0,0 +1,165 @@
+#ifndef STREAM_ANALYTICS_H
+#define STREAM_ANALYTICS_H
+
+/**
+ * @file
+ * @brief Rolling analytics of a MAVLink stream, reported as a compact binary summary.
+ *
+ * # Dependencies
+ * This library has no prerequisites outside of the C standard library. It doesn't depend on the
+ * MAVLink headers or any hardware, the caller passes in the header fields of each message and the
+ * time it arrived at. This lets the same code run on the observer and on a PC against recorded
+ * tlogs.
+ *
+ * # Usage
+ * Call StreamAnalyticsRecordBytes() for every byte read from the stream, then either
+ * StreamAnalyticsRecordMessage() or StreamAnalyticsRecordCrcFailure() for every message the parser
+ * finds. Once a second call StreamAnalyticsEncodeSummary(), which closes the current window and
+ * encodes what was seen during it.
+ *
+ * For every message ID the window's message count, byte count, and CRC failures are kept, so
+ * those are also the per-second rates. The inter-arrival time of each message ID is tracked across
+ * windows as a running mean and jitter, where jitter is the smoothed change between consecutive
+ * intervals like in RFC 3550. Sequence gaps are tracked per system/component ID pair, with gaps of
+ * 128 or more assumed to be restarts rather than loss.
+ *
+ * # Summary format
+ * All multi-byte fields are little-endian.
+ *  * 2 bytes: STREAM_SUMMARY_SYNC0, STREAM_SUMMARY_SYNC1
+ *  * uint8: STREAM_SUMMARY_VERSION
+ *  * uint8: the number of message entries, M
+ *  * uint8: the number of system entries, S
+ *  * uint32: the time of the summary, in seconds
+ *  * uint16: the total bytes received during the window
+ *  * uint16: the bytes that weren't part of any message, valid or not
+ *  * M message entries of 10 bytes each: uint8 msgid, uint16 messages, uint16 bytes, uint8 CRC
+ *    failures (saturating), uint16 mean interval in 0.1ms units, uint16 jitter in us (saturating).
+ *  * S system entries of 6 bytes each: uint8 sysid, uint8 compid, uint16 messages received,
+ *    uint16 messages lost.
+ *  * uint16: the MAVLink (X.25) CRC of everything after the sync bytes.
+ * Only message IDs and systems that were seen during the window are included.
+ *
+ * # Tlog analysis
+ * Compiling with the STREAM_ANALYTICS_TLOG macro builds a host program that runs a recorded tlog
+ * through this library, using the tlog's timestamps, and prints a table for every second. The
+ * binary summaries can also be written to a file.
+ * With gcc: `gcc StreamAnalytics.c ../Libs/C/MavlinkHelpers.c -DSTREAM_ANALYTICS_TLOG -DMAVLINK_SEPARATE_HELPERS -I../Libs/C -I../Libs/MAVLink/seaslug -Wall -g`
+ *
+ * Unit testing has been completed on x86 by compiling with the UNIT_TEST_STREAM_ANALYTICS macro.
+ * With gcc: `gcc StreamAnalytics.c -DUNIT_TEST_STREAM_ANALYTICS -Wall -g`
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * The number of unique message IDs that can be tracked.
+ */
+#ifndef STREAM_ANALYTICS_MAX_MESSAGES
+#define STREAM_ANALYTICS_MAX_MESSAGES 24
+#endif
+
+/**
+ * The number of unique system/component ID pairs that can be tracked.
+ */
+#ifndef STREAM_ANALYTICS_MAX_SYSTEMS
+#define STREAM_ANALYTICS_MAX_SYSTEMS 8
+#endif
+
+#define STREAM_SUMMARY_SYNC0 0xA5
+#define STREAM_SUMMARY_SYNC1 0x5A
+#define STREAM_SUMMARY_VERSION 1
+
+#define STREAM_SUMMARY_HEADER_SIZE 13
+#define STREAM_SUMMARY_MESSAGE_SIZE 10
+#define STREAM_SUMMARY_SYSTEM_SIZE 6
+
+/**
+ * The largest a summary can be, in bytes.
+ */
+#define STREAM_SUMMARY_MAX_SIZE (STREAM_SUMMARY_HEADER_SIZE + \
+                                 STREAM_ANALYTICS_MAX_MESSAGES * STREAM_SUMMARY_MESSAGE_SIZE + \
+                                 STREAM_ANALYTICS_MAX_SYSTEMS * STREAM_SUMMARY_SYSTEM_SIZE + 2)
+
+/**
+ * The statistics for a single message ID over one window, as stored in a summary.
+ */
+typedef struct {
+    uint8_t msgid;
+    uint16_t messages;
+    uint16_t bytes;
+    uint8_t crcFailures;
+    uint16_t interval; // The mean time between messages, in 0.1ms units.
+    uint16_t jitter;   // In us.
+} StreamMessageSummary;
+
+/**
+ * The statistics for a single system/component over one window, as stored in a summary.
+ */
+typedef struct {
+    uint8_t sysid;
+    uint8_t compid;
+    uint16_t received;
+    uint16_t lost;
+} StreamSystemSummary;
+
+/**
+ * A decoded summary.
+ */
+typedef struct {
+    uint32_t time;
+    uint16_t bytes;
+    uint16_t unparsedBytes;
+    uint8_t messageCount;
+    uint8_t systemCount;
+    StreamMessageSummary messages[STREAM_ANALYTICS_MAX_MESSAGES];
+    StreamSystemSummary systems[STREAM_ANALYTICS_MAX_SYSTEMS];
+} StreamSummary;
+
+/**
+ * Clears all statistics.
+ */
+void StreamAnalyticsInit(void);
+
+/**
+ * Records raw bytes read from the stream.
+ * @param count The number of bytes.
+ */
+void StreamAnalyticsRecordBytes(uint16_t count);
+
+/**
+ * Records a successfully-parsed message.
+ * @param sysid The system ID of the sender.
+ * @param compid The component ID of the sender.
+ * @param msgid The ID of the message.
+ * @param seq The sequence number of the message.
+ * @param size The size of the message in bytes, including the header and checksum.
+ * @param timeUs The time the message arrived at, in microseconds from a free-running clock.
+ */
+void StreamAnalyticsRecordMessage(uint8_t sysid, uint8_t compid, uint8_t msgid, uint8_t seq, uint16_t size, uint32_t timeUs);
+
+/**
+ * Records a message that failed its CRC check.
+ * @param msgid The ID in the message's header. This may itself be corrupted.
+ * @param size The size of the message in bytes, including the header and checksum.
+ */
+void StreamAnalyticsRecordCrcFailure(uint8_t msgid, uint16_t size);
+
+/**
+ * Closes the current window, encodes a summary of it, and starts the next one.
+ * @param time The time of the summary in seconds.
+ * @param buffer Where to write the summary, at least STREAM_SUMMARY_MAX_SIZE bytes.
+ * @return The size of the summary in bytes.
+ */
+uint16_t StreamAnalyticsEncodeSummary(uint32_t time, uint8_t *buffer);
+
+/**
+ * Decodes a summary.
+ * @param buffer The summary, starting with the sync bytes.
+ * @param size The number of bytes available in the buffer.
+ * @param summary The decoded summary.
+ * @return The size of the summary in bytes, or 0 if it's invalid or incomplete.
+ */
+uint16_t StreamAnalyticsDecodeSummary(const uint8_t *buffer, uint16_t size, StreamSummary *summary);
+
+#endif // STREAM_ANALYTICS_H
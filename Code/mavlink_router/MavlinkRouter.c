@@ -0,0 +1,548 @@
+/**
+ * @file
+ * @brief A MAVLink router for sharing the boat's telemetry between several programs on a PC.
+ *
+ * This bridges a serial port (such as the 3DR radio, or a pty for testing) to any number of UDP
+ * endpoints, so QGC, a log recorder, and analysis scripts can all talk to the boat at the same
+ * time. Messages are routed by system/component ID and deduplicated, see Routing.h. Everything
+ * received can also be recorded to a .tlog file, which QGC can replay.
+ *
+ * All I/O is done from a single poll() loop, so the router sleeps until there's data to handle
+ * and uses almost no CPU even with a saturated 115200 baud link.
+ *
+ * Compile with gcc:
+ * `gcc -O2 -DMAVLINK_SEPARATE_HELPERS -I../Libs/C -I../Libs/MAVLink/seaslug MavlinkRouter.c Routing.c NavSummary.c ../Libs/C/MavlinkHelpers.c -lm -o mavlink_router`
+ *
+ * Usage: `mavlink_router [-e] [-l file.tlog] [-s seconds] [-d ms] endpoint endpoint...`
+ * where each endpoint is one of:
+ *  * `serial:/dev/ttyUSB0:57600` A serial port or pty at the given baud rate, 115200 by default.
+ *  * `udp:127.0.0.1:14550` Sends to a UDP address, and receives replies from it. QGC listens on
+ *    14550 by default.
+ *  * `udpin:14551` Listens on a UDP port, replying to whoever sent to it last.
+ * The options are:
+ *  * `-l` Records all messages to a .tlog file.
+ *  * `-s` Prints per-link statistics every this many seconds, 10 by default, 0 to disable.
+ *  * `-d` The deduplication window in milliseconds, 200 by default, 0 to disable.
+ *  * `-e` Expands the NAV_SUMMARY messages the boat sends in its compact groundstation mode into
+ *    the standard messages QGC displays, see NavSummary.h.
+ */
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <netdb.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/resource.h>
+
+#include "Routing.h"
+#include "NavSummary.h"
+
+// The size of the transmit buffer for serial links. Serial ports are written to without blocking,
+// so messages are buffered here while the port catches up.
+#define SERIAL_TX_BUFFER_SIZE 4096
+
+typedef enum {
+    LINK_SERIAL,
+    LINK_UDP,    // Sends to a fixed address.
+    LINK_UDP_IN  // Listens on a port, replying to the last sender.
+} LinkType;
+
+// Traffic counters for a single link. The byte counts are the raw bytes read and written, the
+// message counts are only for complete, valid messages.
+typedef struct {
+    uint64_t rxBytes;
+    uint64_t rxMessages;
+    uint64_t rxErrors;     // Messages that failed their checksum, or bytes that weren't in a message.
+    uint64_t duplicates;   // Messages dropped as duplicates.
+    uint64_t txBytes;
+    uint64_t txMessages;
+    uint64_t txDropped;    // Messages that couldn't be sent because the link was full or down.
+} LinkStats;
+
+typedef struct {
+    LinkType type;
+    const char *name;
+    int fd;
+
+    struct sockaddr_storage peer;
+    socklen_t peerLength;  // 0 if there's no one to send to yet.
+
+    uint8_t txBuffer[SERIAL_TX_BUFFER_SIZE];
+    uint16_t txLength;
+
+    LinkStats stats;
+    LinkStats lastStats;   // The stats at the last report, for calculating rates.
+} Link;
+
+static Link links[ROUTER_MAX_LINKS];
+static uint8_t linkCount;
+
+static FILE *tlog;
+
+// Whether NAV_SUMMARY messages are expanded into the standard messages, see NavSummary.h. The
+// expanded messages are numbered on their own MAVLink channel, after those used by the links.
+static bool expandSummaries;
+#define NAV_SUMMARY_CHAN ROUTER_MAX_LINKS
+
+static volatile sig_atomic_t running = 1;
+
+static void Stop(int signal)
+{
+    (void)signal;
+    running = 0;
+}
+
+/**
+ * @return The time from a monotonic clock in milliseconds.
+ */
+static uint32_t NowMs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+/**
+ * Converts a baud rate into its termios speed.
+ * @return The speed or 0 if it's not supported.
+ */
+static speed_t BaudToSpeed(long baud)
+{
+    switch (baud) {
+        case 9600: return B9600;
+        case 19200: return B19200;
+        case 38400: return B38400;
+        case 57600: return B57600;
+        case 115200: return B115200;
+        case 230400: return B230400;
+#ifdef B460800
+        case 460800: return B460800;
+#endif
+#ifdef B921600
+        case 921600: return B921600;
+#endif
+        default: return 0;
+    }
+}
+
+/**
+ * Opens a serial port in raw, non-blocking mode.
+ * @param spec The device and optional baud rate, like `/dev/ttyUSB0:57600`.
+ * @return The file descriptor or -1 on error.
+ */
+static int OpenSerial(const char *spec)
+{
+    char path[256];
+    long baud = 115200;
+    strncpy(path, spec, sizeof(path) - 1);
+    path[sizeof(path) - 1] = '\0';
+    char *colon = strrchr(path, ':');
+    if (colon) {
+        *colon = '\0';
+        baud = strtol(colon + 1, NULL, 10);
+    }
+
+    const speed_t speed = BaudToSpeed(baud);
+    if (!speed) {
+        fprintf(stderr, "Unsupported baud rate: %ld\n", baud);
+        return -1;
+    }
+
+    const int fd = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (fd < 0) {
+        perror(path);
+        return -1;
+    }
+
+    struct termios tio;
+    if (tcgetattr(fd, &tio) == 0) {
+        cfmakeraw(&tio);
+        tio.c_cflag |= CLOCAL | CREAD;
+        tio.c_cflag &= ~CRTSCTS;
+        cfsetispeed(&tio, speed);
+        cfsetospeed(&tio, speed);
+        if (tcsetattr(fd, TCSANOW, &tio) != 0) {
+            perror("tcsetattr");
+        }
+    }
+    return fd;
+}
+
+/**
+ * Opens a UDP socket.
+ * @param host The address to send to, or NULL to listen.
+ * @param port The port to send to or listen on.
+ * @param link The link to store the peer address in.
+ * @return The socket or -1 on error.
+ */
+static int OpenUdp(const char *host, const char *port, Link *link)
+{
+    struct addrinfo hints = {0};
+    struct addrinfo *result;
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    hints.ai_flags = host ? 0 : AI_PASSIVE;
+    const int error = getaddrinfo(host, port, &hints, &result);
+    if (error) {
+        fprintf(stderr, "%s:%s: %s\n", host ? host : "*", port, gai_strerror(error));
+        return -1;
+    }
+
+    const int fd = socket(result->ai_family, result->ai_socktype | SOCK_NONBLOCK, result->ai_protocol);
+    if (fd < 0) {
+        perror("socket");
+    } else if (host) {
+        memcpy(&link->peer, result->ai_addr, result->ai_addrlen);
+        link->peerLength = result->ai_addrlen;
+    } else if (bind(fd, result->ai_addr, result->ai_addrlen) != 0) {
+        perror("bind");
+        close(fd);
+        freeaddrinfo(result);
+        return -1;
+    }
+    freeaddrinfo(result);
+    return fd;
+}
+
+/**
+ * Opens an endpoint from its command-line description.
+ * @return True if it was opened.
+ */
+static bool OpenLink(Link *link, const char *spec)
+{
+    memset(link, 0, sizeof(*link));
+    link->name = spec;
+
+    if (strncmp(spec, "serial:", 7) == 0) {
+        link->type = LINK_SERIAL;
+        link->fd = OpenSerial(spec + 7);
+    } else if (strncmp(spec, "udp:", 4) == 0) {
+        char host[256];
+        strncpy(host, spec + 4, sizeof(host) - 1);
+        host[sizeof(host) - 1] = '\0';
+        char *port = strrchr(host, ':');
+        if (!port) {
+            fprintf(stderr, "Missing port: %s\n", spec);
+            return false;
+        }
+        *port++ = '\0';
+        link->type = LINK_UDP;
+        link->fd = OpenUdp(host, port, link);
+    } else if (strncmp(spec, "udpin:", 6) == 0) {
+        link->type = LINK_UDP_IN;
+        link->fd = OpenUdp(NULL, spec + 6, link);
+    } else {
+        fprintf(stderr, "Unknown endpoint: %s\n", spec);
+        return false;
+    }
+    return link->fd >= 0;
+}
+
+/**
+ * Writes as much of a serial link's transmit buffer as the port will take.
+ */
+static void FlushSerial(Link *link)
+{
+    if (!link->txLength) {
+        return;
+    }
+    const ssize_t written = write(link->fd, link->txBuffer, link->txLength);
+    if (written > 0) {
+        link->stats.txBytes += written;
+        link->txLength -= written;
+        memmove(link->txBuffer, link->txBuffer + written, link->txLength);
+    }
+}
+
+/**
+ * Sends a serialized message out over a link. Messages are dropped rather than blocking if the
+ * link can't keep up.
+ */
+static void SendToLink(Link *link, const uint8_t *data, uint16_t length)
+{
+    if (link->type == LINK_SERIAL) {
+        if (link->txLength + length > SERIAL_TX_BUFFER_SIZE) {
+            ++link->stats.txDropped;
+            return;
+        }
+        memcpy(link->txBuffer + link->txLength, data, length);
+        link->txLength += length;
+        ++link->stats.txMessages;
+        FlushSerial(link);
+    } else if (link->peerLength) {
+        if (sendto(link->fd, data, length, 0, (struct sockaddr *)&link->peer, link->peerLength) == length) {
+            link->stats.txBytes += length;
+            ++link->stats.txMessages;
+        } else {
+            ++link->stats.txDropped;
+        }
+    }
+}
+
+/**
+ * Appends a message to the tlog. Each one is prefixed with the time in microseconds since the Unix
+ * epoch as a big-endian 64-bit integer.
+ */
+static void WriteTlog(const uint8_t *data, uint16_t length)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    const uint64_t usec = (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+
+    uint8_t stamp[8];
+    int i;
+    for (i = 0; i < 8; ++i) {
+        stamp[i] = (uint8_t)(usec >> (56 - 8 * i));
+    }
+    fwrite(stamp, 1, sizeof(stamp), tlog);
+    fwrite(data, 1, length, tlog);
+}
+
+/**
+ * Routes a message received on a link, recording it and sending it to every destination.
+ * @return False if it was a duplicate and was dropped.
+ */
+static bool Forward(uint8_t index, const mavlink_message_t *msg, uint32_t now)
+{
+    uint16_t destinations;
+    if (!RouterRoute(index, msg, now, &destinations)) {
+        return false;
+    }
+
+    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+    const uint16_t size = mavlink_msg_to_send_buffer(buffer, msg);
+    if (tlog) {
+        WriteTlog(buffer, size);
+    }
+    uint8_t j;
+    for (j = 0; j < linkCount; ++j) {
+        if (destinations & (1 << j)) {
+            SendToLink(&links[j], buffer, size);
+        }
+    }
+    return true;
+}
+
+/**
+ * Parses bytes received on a link and forwards any complete messages.
+ */
+static void HandleReceived(uint8_t index, const uint8_t *data, ssize_t length)
+{
+    Link *link = &links[index];
+    link->stats.rxBytes += length;
+
+    const uint32_t now = NowMs();
+    ssize_t i;
+    for (i = 0; i < length; ++i) {
+        mavlink_message_t msg;
+        mavlink_status_t status;
+        const uint8_t result = mavlink_frame_char(index, data[i], &msg, &status);
+        link->stats.rxErrors += status.packet_rx_drop_count;
+        if (result == MAVLINK_FRAMING_BAD_CRC) {
+            ++link->stats.rxErrors;
+            continue;
+        } else if (result != MAVLINK_FRAMING_OK) {
+            continue;
+        }
+        ++link->stats.rxMessages;
+
+        if (!Forward(index, &msg, now)) {
+            ++link->stats.duplicates;
+            continue;
+        }
+
+        // Regenerate the standard messages for groundstations that don't know NAV_SUMMARY, as if
+        // they had arrived over the same link.
+        if (expandSummaries && msg.msgid == MAVLINK_MSG_ID_NAV_SUMMARY) {
+            mavlink_message_t expanded[NAV_SUMMARY_EXPANDED_MAX];
+            const uint8_t count = NavSummaryExpand(&msg, NAV_SUMMARY_CHAN, expanded);
+            uint8_t j;
+            for (j = 0; j < count; ++j) {
+                Forward(index, &expanded[j], now);
+            }
+        }
+    }
+}
+
+/**
+ * Reads everything available from a link.
+ */
+static void ReadLink(uint8_t index)
+{
+    Link *link = &links[index];
+    uint8_t data[4096];
+
+    while (true) {
+        ssize_t length;
+        if (link->type == LINK_SERIAL) {
+            length = read(link->fd, data, sizeof(data));
+        } else {
+            struct sockaddr_storage from;
+            socklen_t fromLength = sizeof(from);
+            length = recvfrom(link->fd, data, sizeof(data), 0, (struct sockaddr *)&from, &fromLength);
+            // Listening links reply to whoever sent to them last.
+            if (length > 0 && link->type == LINK_UDP_IN) {
+                link->peer = from;
+                link->peerLength = fromLength;
+            }
+        }
+
+        if (length > 0) {
+            HandleReceived(index, data, length);
+        } else {
+            // If the serial port went away, or the other end of a pty was closed, it will keep
+            // polling as readable. Keep the link in case it comes back, but don't spin on it.
+            if (link->type == LINK_SERIAL && (length == 0 || (errno != EAGAIN && errno != EWOULDBLOCK))) {
+                usleep(100000);
+            }
+            break;
+        }
+    }
+}
+
+/**
+ * Prints the traffic on every link since the last report, along with the CPU used.
+ * @param seconds The time since the last report.
+ */
+static void PrintStats(double seconds)
+{
+    static double lastCpu = 0;
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    const double cpu = usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 +
+                       usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+
+    fprintf(stderr, "%-28s %9s %9s %9s %9s %7s %7s %7s\n",
+            "link", "rx B/s", "tx B/s", "rx msgs", "tx msgs", "errors", "dups", "drops");
+    uint8_t i;
+    for (i = 0; i < linkCount; ++i) {
+        Link *link = &links[i];
+        const LinkStats *s = &link->stats;
+        fprintf(stderr, "%-28s %9.0f %9.0f %9llu %9llu %7llu %7llu %7llu\n",
+                link->name,
+                (s->rxBytes - link->lastStats.rxBytes) / seconds,
+                (s->txBytes - link->lastStats.txBytes) / seconds,
+                (unsigned long long)s->rxMessages, (unsigned long long)s->txMessages,
+                (unsigned long long)s->rxErrors, (unsigned long long)s->duplicates,
+                (unsigned long long)s->txDropped);
+        link->lastStats = *s;
+    }
+    fprintf(stderr, "routes: %u, CPU: %.2f%%\n\n", RouterGetRouteCount(), 100.0 * (cpu - lastCpu) / seconds);
+    lastCpu = cpu;
+}
+
+static void Usage(const char *program)
+{
+    fprintf(stderr, "Usage: %s [-e] [-l file.tlog] [-s seconds] [-d ms] endpoint endpoint...\n"
+                    "Endpoints: serial:/dev/ttyUSB0[:baud], udp:host:port, udpin:port\n", program);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *tlogPath = NULL;
+    int statsPeriod = 10;
+    long dedupWindow = 200;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "el:s:d:h")) != -1) {
+        switch (opt) {
+            case 'l': tlogPath = optarg; break;
+            case 's': statsPeriod = atoi(optarg); break;
+            case 'd': dedupWindow = atol(optarg); break;
+            case 'e': expandSummaries = true; break;
+            default: Usage(argv[0]); return 1;
+        }
+    }
+
+    if (argc - optind < 2 || argc - optind > ROUTER_MAX_LINKS) {
+        Usage(argv[0]);
+        fprintf(stderr, "Between 2 and %d endpoints are required.\n", ROUTER_MAX_LINKS);
+        return 1;
+    }
+
+    for (; optind < argc; ++optind) {
+        if (!OpenLink(&links[linkCount], argv[optind])) {
+            return 1;
+        }
+        ++linkCount;
+    }
+
+    if (tlogPath) {
+        tlog = fopen(tlogPath, "wb");
+        if (!tlog) {
+            perror(tlogPath);
+            return 1;
+        }
+    }
+
+    RouterInit(linkCount, (uint32_t)dedupWindow);
+
+    signal(SIGINT, Stop);
+    signal(SIGTERM, Stop);
+
+    struct pollfd fds[ROUTER_MAX_LINKS];
+    uint32_t lastReport = NowMs();
+    uint32_t lastFlush = lastReport;
+    while (running) {
+        uint8_t i;
+        for (i = 0; i < linkCount; ++i) {
+            fds[i].fd = links[i].fd;
+            fds[i].events = POLLIN;
+            if (links[i].txLength) {
+                fds[i].events |= POLLOUT;
+            }
+        }
+
+        // Wake up at least once a second for the statistics and to flush the tlog.
+        if (poll(fds, linkCount, 1000) < 0) {
+            if (errno != EINTR) {
+                perror("poll");
+            }
+            continue;
+        }
+
+        for (i = 0; i < linkCount; ++i) {
+            if (fds[i].revents & POLLOUT) {
+                FlushSerial(&links[i]);
+            }
+            if (fds[i].revents & (POLLIN | POLLHUP)) {
+                ReadLink(i);
+            }
+        }
+
+        const uint32_t now = NowMs();
+        if (tlog && now - lastFlush >= 1000) {
+            fflush(tlog);
+            lastFlush = now;
+        }
+        if (statsPeriod > 0 && now - lastReport >= (uint32_t)statsPeriod * 1000) {
+            PrintStats((now - lastReport) / 1000.0);
+            lastReport = now;
+        }
+    }
+
+    if (statsPeriod > 0) {
+        const uint32_t now = NowMs();
+        PrintStats(now > lastReport ? (now - lastReport) / 1000.0 : 1.0);
+    }
+    if (tlog) {
+        fclose(tlog);
+    }
+    uint8_t i;
+    for (i = 0; i < linkCount; ++i) {
+        close(links[i].fd);
+    }
+
+    return 0;
+}
@@ -0,0 +1,175 @@
+/**
+ * @file
+ * @brief Implements the NAV_SUMMARY expansion declared in NavSummary.h.
+ */
+#include "NavSummary.h"
+
+#include <math.h>
+
+// The scale of the Tokimec angles and rates carried in NAV_SUMMARY, see its definition.
+#define ANGLE_SCALE 8192.0f
+#define RATE_SCALE 4096.0f
+
+/**
+ * Converts a yaw angle in radians into a heading in [0, 360) degrees.
+ */
+static float HeadingDegrees(float yaw)
+{
+    float heading = yaw * (float)(180.0 / M_PI);
+    heading = fmodf(heading, 360.0f);
+    if (heading < 0) {
+        heading += 360.0f;
+    }
+    return heading;
+}
+
+uint8_t NavSummaryExpand(const mavlink_message_t *summary, uint8_t chan, mavlink_message_t *out)
+{
+    if (summary->msgid != MAVLINK_MSG_ID_NAV_SUMMARY) {
+        return 0;
+    }
+
+    mavlink_nav_summary_t s;
+    mavlink_msg_nav_summary_decode(summary, &s);
+
+    const uint8_t sysid = summary->sysid;
+    const uint8_t compid = NAV_SUMMARY_EXPANDER_COMPID;
+    const float yaw = s.yaw / ANGLE_SCALE;
+    const float heading = HeadingDegrees(yaw);
+    uint8_t count = 0;
+
+    mavlink_msg_attitude_pack_chan(sysid, compid, chan, &out[count++],
+                                   s.time_boot_ms,
+                                   s.roll / ANGLE_SCALE, s.pitch / ANGLE_SCALE, yaw,
+                                   0, 0, s.yaw_rate / RATE_SCALE);
+
+    // The boat doesn't estimate its vertical position or velocity.
+    mavlink_msg_local_position_ned_pack_chan(sysid, compid, chan, &out[count++],
+                                             s.time_boot_ms,
+                                             s.north / 10.0f, s.east / 10.0f, NAN,
+                                             s.vel_north / 100.0f, s.vel_east / 100.0f, NAN);
+
+    mavlink_msg_gps_raw_int_pack_chan(sysid, compid, chan, &out[count++],
+                                      (uint64_t)s.time_boot_ms * 1000,
+                                      s.fix_type, s.lat, s.lon, 0,
+                                      UINT16_MAX, UINT16_MAX,
+                                      s.sog, s.cog, s.satellites_visible);
+
+    mavlink_msg_global_position_int_pack_chan(sysid, compid, chan, &out[count++],
+                                              s.time_boot_ms,
+                                              s.lat, s.lon, 0, 0,
+                                              s.vel_north, s.vel_east, 0,
+                                              (uint16_t)(heading * 100) % 36000);
+
+    mavlink_msg_vfr_hud_pack_chan(sysid, compid, chan, &out[count++],
+                                  s.water_speed / 100.0f, s.sog / 100.0f,
+                                  (int16_t)heading,
+                                  (uint16_t)(fabsf(s.throttle / 1023.0f) * 100),
+                                  0, 0);
+
+    if (s.waypoint != UINT8_MAX) {
+        mavlink_msg_mission_current_pack_chan(sysid, compid, chan, &out[count++], s.waypoint);
+    }
+
+    return count;
+}
+
+#ifdef UNIT_TEST_NAV_SUMMARY
+
+#include <stdio.h>
+#include <assert.h>
+
+static bool Near(float a, float b, float tolerance)
+{
+    return fabsf(a - b) <= tolerance;
+}
+
+int main()
+{
+    printf("Testing NavSummary.c. All errors will be reported as failed assertions.\n");
+
+    mavlink_message_t summary;
+    mavlink_message_t out[NAV_SUMMARY_EXPANDED_MAX];
+
+    // Only NAV_SUMMARY messages are expanded.
+    mavlink_msg_heartbeat_pack(20, 0, &summary, MAV_TYPE_SURFACE_BOAT, MAV_AUTOPILOT_GENERIC, 0, 0, MAV_STATE_ACTIVE);
+    assert(NavSummaryExpand(&summary, 1, out) == 0);
+
+    // A boat 12.3m north and 45.6m west of the origin, heading 270 degrees at 1.5m/s.
+    mavlink_msg_nav_summary_pack(20, 0, &summary,
+                                 123456,
+                                 367123456, -1220123456,
+                                 123, -456,
+                                 -5, -150,
+                                 819, -410, (int16_t)(-M_PI / 2 * 8192), 2048,
+                                 151, 27000, 140,
+                                 -3000, -512,
+                                 0x0102, 0x0304,
+                                 3, 3, 9);
+    assert(NavSummaryExpand(&summary, 1, out) == NAV_SUMMARY_EXPANDED_MAX);
+
+    uint8_t i;
+    for (i = 0; i < NAV_SUMMARY_EXPANDED_MAX; ++i) {
+        assert(out[i].sysid == 20);
+        assert(out[i].compid == NAV_SUMMARY_EXPANDER_COMPID);
+        assert(out[i].seq == i);
+    }
+
+    mavlink_attitude_t attitude;
+    assert(out[0].msgid == MAVLINK_MSG_ID_ATTITUDE);
+    mavlink_msg_attitude_decode(&out[0], &attitude);
+    assert(attitude.time_boot_ms == 123456);
+    assert(Near(attitude.roll, 0.1f, 0.001f));
+    assert(Near(attitude.pitch, -0.05f, 0.001f));
+    assert(Near(attitude.yaw, -M_PI / 2, 0.001f));
+    assert(Near(attitude.yawspeed, 0.5f, 0.001f));
+
+    mavlink_local_position_ned_t position;
+    assert(out[1].msgid == MAVLINK_MSG_ID_LOCAL_POSITION_NED);
+    mavlink_msg_local_position_ned_decode(&out[1], &position);
+    assert(Near(position.x, 12.3f, 0.001f));
+    assert(Near(position.y, -45.6f, 0.001f));
+    assert(isnan(position.z));
+    assert(Near(position.vx, -0.05f, 0.001f));
+    assert(Near(position.vy, -1.5f, 0.001f));
+
+    mavlink_gps_raw_int_t gps;
+    assert(out[2].msgid == MAVLINK_MSG_ID_GPS_RAW_INT);
+    mavlink_msg_gps_raw_int_decode(&out[2], &gps);
+    assert(gps.time_usec == 123456000);
+    assert(gps.lat == 367123456 && gps.lon == -1220123456);
+    assert(gps.fix_type == 3 && gps.satellites_visible == 9);
+    assert(gps.vel == 151 && gps.cog == 27000);
+    assert(gps.eph == UINT16_MAX);
+
+    mavlink_global_position_int_t global;
+    assert(out[3].msgid == MAVLINK_MSG_ID_GLOBAL_POSITION_INT);
+    mavlink_msg_global_position_int_decode(&out[3], &global);
+    assert(global.lat == 367123456 && global.lon == -1220123456);
+    assert(global.vx == -5 && global.vy == -150);
+    assert(global.hdg >= 26995 && global.hdg <= 27005);
+
+    mavlink_vfr_hud_t hud;
+    assert(out[4].msgid == MAVLINK_MSG_ID_VFR_HUD);
+    mavlink_msg_vfr_hud_decode(&out[4], &hud);
+    assert(Near(hud.airspeed, 1.4f, 0.001f));
+    assert(Near(hud.groundspeed, 1.51f, 0.001f));
+    assert(hud.heading == 269 || hud.heading == 270);
+    assert(hud.throttle == 50);
+
+    assert(out[5].msgid == MAVLINK_MSG_ID_MISSION_CURRENT);
+    assert(mavlink_msg_mission_current_get_seq(&out[5]) == 3);
+
+    // Without a mission there's no MISSION_CURRENT, and the sequence numbers carry on.
+    mavlink_msg_nav_summary_pack(20, 0, &summary, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, UINT8_MAX, 0, 0);
+    assert(NavSummaryExpand(&summary, 1, out) == NAV_SUMMARY_EXPANDED_MAX - 1);
+    assert(out[0].seq == NAV_SUMMARY_EXPANDED_MAX);
+    mavlink_msg_global_position_int_decode(&out[3], &global);
+    assert(global.hdg == 0);
+
+    printf("All tests passed.\n");
+
+    return 0;
+}
+
+#endif // UNIT_TEST_NAV_SUMMARY
@@ -0,0 +1,54 @@
+#ifndef NAV_SUMMARY_H
+#define NAV_SUMMARY_H
+
+/**
+ * @file
+ * @brief Expands the boat's NAV_SUMMARY message back into the standard messages QGC displays.
+ *
+ * # Dependencies
+ * This relies on the MAVLink headers for packing the messages.
+ *
+ * # Usage
+ * When the boat's groundstation link is in its compact mode it only sends HEARTBEAT, SYS_STATUS,
+ * and TIMESYNC alongside a 5Hz NAV_SUMMARY. Passing every NAV_SUMMARY to NavSummaryExpand()
+ * regenerates the ATTITUDE, LOCAL_POSITION_NED, GPS_RAW_INT, GLOBAL_POSITION_INT, VFR_HUD, and
+ * MISSION_CURRENT messages it replaces, at the resolution NAV_SUMMARY carries them in. Fields that
+ * NAV_SUMMARY doesn't have, like altitude, roll and pitch rates, and DOP, are sent as unknown or 0.
+ *
+ * The regenerated messages come from the boat's system ID but from NAV_SUMMARY_EXPANDER_COMPID,
+ * with sequence numbers of their own, so that they don't break the loss statistics groundstations
+ * keep for the boat's own component.
+ *
+ * Unit testing has been completed on x86 by compiling with the UNIT_TEST_NAV_SUMMARY macro.
+ * With gcc: `gcc NavSummary.c ../Libs/C/MavlinkHelpers.c -DUNIT_TEST_NAV_SUMMARY -DMAVLINK_SEPARATE_HELPERS -I../Libs/C -I../Libs/MAVLink/seaslug -Wall -g -lm`
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "mavlink.h"
+
+/**
+ * The most messages a single NAV_SUMMARY expands into.
+ */
+#define NAV_SUMMARY_EXPANDED_MAX 6
+
+/**
+ * The component ID the regenerated messages are sent from.
+ */
+#ifndef NAV_SUMMARY_EXPANDER_COMPID
+#define NAV_SUMMARY_EXPANDER_COMPID MAV_COMP_ID_SYSTEM_CONTROL
+#endif
+
+/**
+ * Regenerates the standard messages from a NAV_SUMMARY.
+ * @param summary The NAV_SUMMARY message.
+ * @param chan A MAVLink channel not used for anything else, whose sequence numbers are used for the
+ *             regenerated messages.
+ * @param out Where to store the regenerated messages, NAV_SUMMARY_EXPANDED_MAX of them.
+ * @return The number of messages regenerated, 0 if summary isn't a NAV_SUMMARY.
+ */
+uint8_t NavSummaryExpand(const mavlink_message_t *summary, uint8_t chan, mavlink_message_t *out);
+
+#endif // NAV_SUMMARY_H
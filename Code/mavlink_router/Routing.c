@@ -0,0 +1,306 @@
+/**
+ * @file
+ * @brief Implements the message routing declared in Routing.h.
+ *
+ * Unit testing has been completed on x86 by compiling with the UNIT_TEST_ROUTING macro.
+ * With gcc: `gcc Routing.c ../Libs/C/MavlinkHelpers.c -DUNIT_TEST_ROUTING -DMAVLINK_SEPARATE_HELPERS -I../Libs/C -I../Libs/MAVLink/seaslug -Wall -g`
+ */
+#include "Routing.h"
+
+#include <string.h>
+
+// Marks a message as not having a target field.
+#define NO_FIELD 0xFF
+
+// The payload offsets of the target_system and target_component fields of every message, looked up
+// once from the message info tables so routing each message is O(1).
+static uint8_t targetSystemOffset[256];
+static uint8_t targetComponentOffset[256];
+
+// A system/component that has been seen on a link.
+typedef struct {
+    uint8_t sysid;
+    uint8_t compid;
+    uint8_t link;
+    uint32_t lastSeen;
+} Route;
+
+static Route routes[ROUTER_MAX_ROUTES];
+static uint8_t routeCount;
+static uint8_t linkCount;
+
+// The recently seen messages as a ring buffer, see MessageKey().
+static struct {
+    uint64_t key;
+    uint32_t time;
+} recent[ROUTER_DEDUP_SIZE];
+static uint16_t recentNext;
+static uint32_t dedupWindow;
+
+/**
+ * Builds a key that identifies a single message from a single sender. It's very unlikely for two
+ * different messages to share a sequence number, message ID, and checksum.
+ */
+static uint64_t MessageKey(const mavlink_message_t *msg)
+{
+    return ((uint64_t)msg->sysid << 40) | ((uint64_t)msg->compid << 32) |
+           ((uint64_t)msg->seq << 24) | ((uint64_t)msg->msgid << 16) | msg->checksum;
+}
+
+void RouterInit(uint8_t links, uint32_t dedupWindowMs)
+{
+    static bool offsetsInitialized = false;
+    if (!offsetsInitialized) {
+        static const mavlink_message_info_t info[256] = MAVLINK_MESSAGE_INFO;
+        memset(targetSystemOffset, NO_FIELD, sizeof(targetSystemOffset));
+        memset(targetComponentOffset, NO_FIELD, sizeof(targetComponentOffset));
+        int i;
+        for (i = 0; i < 256; ++i) {
+            unsigned j;
+            for (j = 0; j < info[i].num_fields; ++j) {
+                const mavlink_field_info_t *field = &info[i].fields[j];
+                if (strcmp(field->name, "target_system") == 0) {
+                    targetSystemOffset[i] = (uint8_t)field->wire_offset;
+                } else if (strcmp(field->name, "target_component") == 0) {
+                    targetComponentOffset[i] = (uint8_t)field->wire_offset;
+                }
+            }
+        }
+        offsetsInitialized = true;
+    }
+
+    linkCount = (links > ROUTER_MAX_LINKS) ? ROUTER_MAX_LINKS : links;
+    routeCount = 0;
+    memset(recent, 0, sizeof(recent));
+    recentNext = 0;
+    dedupWindow = dedupWindowMs;
+}
+
+void RouterGetTarget(const mavlink_message_t *msg, uint8_t *sysid, uint8_t *compid)
+{
+    const uint8_t *payload = (const uint8_t *)_MAV_PAYLOAD(msg);
+    const uint8_t sysOffset = targetSystemOffset[msg->msgid];
+    const uint8_t compOffset = targetComponentOffset[msg->msgid];
+
+    // Check against the received length as well, so a malformed message can't read past its end.
+    *sysid = (sysOffset != NO_FIELD && sysOffset < msg->len) ? payload[sysOffset] : 0;
+    *compid = (compOffset != NO_FIELD && compOffset < msg->len) ? payload[compOffset] : 0;
+}
+
+uint8_t RouterGetRouteCount(void)
+{
+    return routeCount;
+}
+
+/**
+ * Checks if a message was seen recently, remembering it if it wasn't.
+ * @return True if the message is a duplicate.
+ */
+static bool IsDuplicate(const mavlink_message_t *msg, uint32_t nowMs)
+{
+    if (!dedupWindow) {
+        return false;
+    }
+
+    const uint64_t key = MessageKey(msg);
+    uint16_t i;
+    for (i = 0; i < ROUTER_DEDUP_SIZE; ++i) {
+        if (recent[i].key == key && nowMs - recent[i].time < dedupWindow) {
+            return true;
+        }
+    }
+
+    recent[recentNext].key = key;
+    recent[recentNext].time = nowMs;
+    recentNext = (recentNext + 1) % ROUTER_DEDUP_SIZE;
+    return false;
+}
+
+/**
+ * Records that a system/component was seen on a link.
+ */
+static void LearnRoute(uint8_t link, uint8_t sysid, uint8_t compid, uint32_t nowMs)
+{
+    uint8_t i;
+    uint8_t oldest = 0;
+    for (i = 0; i < routeCount; ++i) {
+        Route *r = &routes[i];
+        if (r->sysid == sysid && r->compid == compid && r->link == link) {
+            r->lastSeen = nowMs;
+            return;
+        }
+        if (nowMs - r->lastSeen > nowMs - routes[oldest].lastSeen) {
+            oldest = i;
+        }
+    }
+
+    // Add a new route, replacing the least recently seen one if the table is full.
+    Route *r = (routeCount < ROUTER_MAX_ROUTES) ? &routes[routeCount++] : &routes[oldest];
+    r->sysid = sysid;
+    r->compid = compid;
+    r->link = link;
+    r->lastSeen = nowMs;
+}
+
+bool RouterRoute(uint8_t link, const mavlink_message_t *msg, uint32_t nowMs, uint16_t *destinations)
+{
+    *destinations = 0;
+
+    if (IsDuplicate(msg, nowMs)) {
+        return false;
+    }
+
+    LearnRoute(link, msg->sysid, msg->compid, nowMs);
+
+    const uint16_t allOthers = ((1 << linkCount) - 1) & ~(1 << link);
+
+    uint8_t targetSystem, targetComponent;
+    RouterGetTarget(msg, &targetSystem, &targetComponent);
+    if (targetSystem == 0) {
+        *destinations = allOthers;
+        return true;
+    }
+
+    // Send to every link the target has been seen on. If the target component hasn't been seen on
+    // any, fall back to anywhere the target system has been seen, as it's likely to be reachable
+    // through the same link.
+    uint16_t systemLinks = 0;
+    uint16_t componentLinks = 0;
+    uint8_t i;
+    for (i = 0; i < routeCount; ++i) {
+        const Route *r = &routes[i];
+        if (r->sysid == targetSystem) {
+            systemLinks |= 1 << r->link;
+            if (targetComponent == 0 || r->compid == targetComponent) {
+                componentLinks |= 1 << r->link;
+            }
+        }
+    }
+
+    if (componentLinks) {
+        *destinations = componentLinks & allOthers;
+    } else if (systemLinks) {
+        *destinations = systemLinks & allOthers;
+    } else {
+        *destinations = allOthers;
+    }
+    return true;
+}
+
+#ifdef UNIT_TEST_ROUTING
+
+#include <stdio.h>
+#include <assert.h>
+
+/**
+ * Builds a HEARTBEAT, which is a broadcast message.
+ */
+static void Heartbeat(mavlink_message_t *msg, uint8_t sysid, uint8_t compid, uint8_t seq)
+{
+    mavlink_msg_heartbeat_pack(sysid, compid, msg, MAV_TYPE_SURFACE_BOAT, MAV_AUTOPILOT_GENERIC, 0, 0, MAV_STATE_ACTIVE);
+    msg->seq = seq;
+}
+
+/**
+ * Builds a PARAM_REQUEST_LIST, which is addressed to a system and component.
+ */
+static void ParamRequestList(mavlink_message_t *msg, uint8_t sysid, uint8_t compid, uint8_t targetSystem, uint8_t targetComponent)
+{
+    mavlink_msg_param_request_list_pack(sysid, compid, msg, targetSystem, targetComponent);
+}
+
+int main()
+{
+    printf("Testing Routing.c. All errors will be reported as failed assertions.\n");
+
+    // Links: 0 is the boat's radio, 1 is QGC, and 2 is a log recorder.
+    RouterInit(3, 200);
+
+    mavlink_message_t msg;
+    uint16_t dest;
+    uint8_t sys, comp;
+
+    // The target fields are found for addressed messages and are 0 for broadcast ones.
+    ParamRequestList(&msg, 255, 0, 1, 2);
+    RouterGetTarget(&msg, &sys, &comp);
+    assert(sys == 1 && comp == 2);
+    Heartbeat(&msg, 1, 2, 0);
+    RouterGetTarget(&msg, &sys, &comp);
+    assert(sys == 0 && comp == 0);
+
+    // A broadcast goes everywhere but where it came from.
+    Heartbeat(&msg, 1, 2, 0);
+    assert(RouterRoute(0, &msg, 0, &dest));
+    assert(dest == 0x6);
+    assert(RouterGetRouteCount() == 1);
+
+    // The same message again shortly after is a duplicate, even from another link.
+    assert(!RouterRoute(0, &msg, 10, &dest));
+    assert(dest == 0);
+    assert(!RouterRoute(1, &msg, 20, &dest));
+
+    // But not once the window has passed, or with a different sequence number.
+    assert(RouterRoute(0, &msg, 300, &dest));
+    Heartbeat(&msg, 1, 2, 1);
+    assert(RouterRoute(0, &msg, 310, &dest));
+    assert(RouterGetRouteCount() == 1);
+
+    // An addressed message only goes to where its target was seen.
+    ParamRequestList(&msg, 255, 190, 1, 2);
+    assert(RouterRoute(1, &msg, 320, &dest));
+    assert(dest == 0x1);
+    assert(RouterGetRouteCount() == 2);
+
+    // Or where its target system was seen, if the component is unknown.
+    msg.seq++;
+    ParamRequestList(&msg, 255, 190, 1, 5);
+    assert(RouterRoute(1, &msg, 330, &dest));
+    assert(dest == 0x1);
+
+    // An unknown target is broadcast.
+    ParamRequestList(&msg, 255, 190, 7, 1);
+    assert(RouterRoute(1, &msg, 340, &dest));
+    assert(dest == 0x5);
+
+    // Replies to QGC only go to QGC.
+    ParamRequestList(&msg, 1, 2, 255, 190);
+    assert(RouterRoute(0, &msg, 350, &dest));
+    assert(dest == 0x2);
+
+    // Never back out over the link the message came in on, even if the target is there too.
+    ParamRequestList(&msg, 255, 190, 1, 2);
+    msg.seq = 100;
+    assert(RouterRoute(0, &msg, 360, &dest));
+    assert(dest == 0x0);
+
+    // A malformed message that's too short for its target fields is treated as a broadcast.
+    ParamRequestList(&msg, 255, 190, 1, 2);
+    msg.len = 0;
+    msg.seq = 101;
+    RouterGetTarget(&msg, &sys, &comp);
+    assert(sys == 0 && comp == 0);
+
+    // The route table replaces the oldest route once it's full.
+    uint8_t i;
+    for (i = 0; i < ROUTER_MAX_ROUTES; ++i) {
+        Heartbeat(&msg, 10 + i, 1, 0);
+        assert(RouterRoute(2, &msg, 1000 + i, &dest));
+    }
+    assert(RouterGetRouteCount() == ROUTER_MAX_ROUTES);
+    ParamRequestList(&msg, 255, 190, 10 + ROUTER_MAX_ROUTES - 1, 1);
+    assert(RouterRoute(1, &msg, 2000, &dest));
+    assert(dest == 0x4);
+
+    // Deduplication can be disabled.
+    RouterInit(3, 0);
+    Heartbeat(&msg, 1, 2, 0);
+    assert(RouterRoute(0, &msg, 0, &dest));
+    assert(RouterRoute(1, &msg, 0, &dest));
+    assert(dest == 0x5);
+
+    printf("All tests passed.\n");
+
+    return 0;
+}
+
+#endif // UNIT_TEST_ROUTING
@@ -0,0 +1,84 @@
+#ifndef ROUTING_H
+#define ROUTING_H
+
+/**
+ * @file
+ * @brief Decides which links a MAVLink message should be forwarded to.
+ *
+ * # Dependencies
+ * This relies on the MAVLink headers for the message struct and the message info tables, which are
+ * used to find the target system and component of addressed messages.
+ *
+ * # Usage
+ * Every message received on any link is passed to RouterRoute(). This learns which link each
+ * system/component can be reached over and returns the set of links the message should be sent
+ * out over, following the usual MAVLink routing rules:
+ *  * Broadcast messages (with no target, or a target system of 0) go to every other link.
+ *  * Addressed messages only go to the links their target has been seen on. If the target hasn't
+ *    been seen yet, they're broadcast so that first contact still works.
+ *  * Messages are never sent back out over the link they came in on.
+ *
+ * The same message can arrive over several links, such as when two radios are listening to the
+ * boat or a groundstation echoes traffic back. Messages with the same system, component, sequence
+ * number, message ID, and checksum as one seen within the deduplication window are duplicates and
+ * are dropped.
+ *
+ * Unit testing has been completed on x86 by compiling with the UNIT_TEST_ROUTING macro.
+ * With gcc: `gcc Routing.c ../Libs/C/MavlinkHelpers.c -DUNIT_TEST_ROUTING -DMAVLINK_SEPARATE_HELPERS -I../Libs/C -I../Libs/MAVLink/seaslug -Wall -g`
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "mavlink.h"
+
+/**
+ * The maximum number of links that can be routed between.
+ */
+#define ROUTER_MAX_LINKS 8
+
+/**
+ * The maximum number of system/component/link routes that are remembered. Once full, the least
+ * recently seen route is replaced.
+ */
+#define ROUTER_MAX_ROUTES 32
+
+/**
+ * The number of recent messages remembered for deduplication. This needs to cover the deduplication
+ * window at the highest message rate, which is ~450 messages/s at 115200 baud.
+ */
+#define ROUTER_DEDUP_SIZE 256
+
+/**
+ * Resets all routes and the deduplication history.
+ * @param links The number of links being routed between, at most ROUTER_MAX_LINKS.
+ * @param dedupWindowMs How long a message is remembered for deduplication, in milliseconds. 0
+ *                      disables deduplication.
+ */
+void RouterInit(uint8_t links, uint32_t dedupWindowMs);
+
+/**
+ * Decides where to forward a message, learning a route to its sender along the way.
+ * @param link The link the message was received on.
+ * @param msg The message.
+ * @param nowMs The current time in milliseconds, from any monotonic clock.
+ * @param destinations A bitmask of the links to send the message out over.
+ * @return False if the message is a duplicate and should be dropped.
+ */
+bool RouterRoute(uint8_t link, const mavlink_message_t *msg, uint32_t nowMs, uint16_t *destinations);
+
+/**
+ * Finds the target of a message from its target_system and target_component fields.
+ * @param msg The message.
+ * @param sysid The target system, 0 if the message has no target_system field.
+ * @param compid The target component, 0 if the message has no target_component field.
+ */
+void RouterGetTarget(const mavlink_message_t *msg, uint8_t *sysid, uint8_t *compid);
+
+/**
+ * @return The number of routes currently known.
+ */
+uint8_t RouterGetRouteCount(void);
+
+#endif // ROUTING_H